@@ -0,0 +1,401 @@
+/**
+ * @file jayc_bench.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements reporting and baseline comparison of benchmarks.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for getline() */
+#define _POSIX_C_SOURCE 200809L
+
+#include "jayc_bench.h"
+#include <jayc/jinfo.h>
+#include <jayc/jutil_args.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+//==============================================================================
+// Define constants and structures.
+//
+
+/*
+ * Key, after which old values of a result start.
+ */
+#define JAYC_BENCH_KEY_BASELINE "\"baseline\""
+
+typedef struct __jayc_bench_data
+{
+  char **lines;
+  size_t line_number;
+  int loaded;
+
+  double threshold;
+  long duration;
+
+  size_t compared;
+  size_t regressions;
+} jayc_bench_data_t;
+
+static jayc_bench_data_t g_bench =
+{
+  NULL,
+  0,
+  false,
+  JAYC_BENCH_THRESHOLD_DEFAULT,
+  JAYC_BENCH_DURATION_DEFAULT,
+  0,
+  0
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Finds result of earlier run.
+ * 
+ * @param benchmark Name of benchmark.
+ * @param variant   Variant of benchmark.
+ * 
+ * @return          Line of result.
+ * @return          @c NULL , if not in baseline.
+ */
+static const char *jayc_bench_findLine(const char *benchmark, const char *variant);
+
+/**
+ * @brief Reads string value of key from result line.
+ * 
+ * @param line  Result line.
+ * @param key   Key to find.
+ * @param buf   Buffer for value.
+ * @param size  Size of buffer.
+ * 
+ * @return      @c true , if value was found.
+ * @return      @c false , if not.
+ */
+static int jayc_bench_getString(const char *line, const char *key, char *buf, size_t size);
+
+/**
+ * @brief Reads number value of key from result line.
+ * 
+ * Only looks at values of the run itself, not at
+ * values of its baseline.
+ * 
+ * @param line  Result line.
+ * @param key   Key to find.
+ * @param value Set to value.
+ * 
+ * @return      @c true , if value was found.
+ * @return      @c false , if not.
+ */
+static int jayc_bench_getNumber(const char *line, const char *key, double *value);
+
+/**
+ * @brief Finds start of value of key.
+ * 
+ * @param line  Result line.
+ * @param key   Key to find.
+ * @param end   Search stops here. @c NULL for end of line.
+ * 
+ * @return      First character after colon.
+ * @return      @c NULL , if key not found.
+ */
+static const char *jayc_bench_findValue(const char *line, const char *key, const char *end);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jayc_bench_loadBaseline(const char *filename)
+{
+  if(filename == NULL)
+  {
+    return false;
+  }
+
+  FILE *file = fopen(filename, "r");
+  if(file == NULL)
+  {
+    fprintf(stderr, "Could not open baseline [%s].\n", filename);
+    return false;
+  }
+
+  jayc_bench_free();
+
+  char *line = NULL;
+  size_t line_size = 0;
+  while(getline(&line, &line_size, file) >= 0)
+  {
+    if(strstr(line, "\"benchmark\"") == NULL || strstr(line, "\"variant\"") == NULL)
+    {
+      continue;
+    }
+
+    char **lines = (char **)realloc(g_bench.lines, (g_bench.line_number + 1) * sizeof(char *));
+    if(lines == NULL)
+    {
+      break;
+    }
+    g_bench.lines = lines;
+    g_bench.lines[g_bench.line_number] = line;
+    g_bench.line_number++;
+
+    line = NULL;
+    line_size = 0;
+  }
+  free(line);
+  fclose(file);
+
+  g_bench.loaded = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jayc_bench_setThreshold(double percent)
+{
+  g_bench.threshold = percent;
+}
+
+//------------------------------------------------------------------------------
+//
+long jayc_bench_getDuration(void)
+{
+  return g_bench.duration;
+}
+
+//------------------------------------------------------------------------------
+//
+void jayc_bench_printInfo(const char *program)
+{
+  printf("{\"benchmark\":\"info\",\"variant\":\"%s\",\"version\":\"%s\",\"compiler\":\"%s\",\"platform\":\"%s\",\"duration_ms\":%ld}\n",
+    program, jinfo_build_version(), jinfo_build_compiler(), jinfo_build_platform(), g_bench.duration);
+  fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+//
+void jayc_bench_report(const char *benchmark, const char *variant, const jayc_bench_metric_t *metrics, size_t count)
+{
+  printf("{\"benchmark\":\"%s\",\"variant\":\"%s\",\"version\":\"%s\"", benchmark, variant, jinfo_build_version());
+  for(size_t i = 0; i < count; i++)
+  {
+    printf(",\"%s\":%.3f", metrics[i].name, metrics[i].value);
+  }
+
+  const char *line = jayc_bench_findLine(benchmark, variant);
+  if(line)
+  {
+    int first = true;
+    printf(",%s:{", JAYC_BENCH_KEY_BASELINE);
+    for(size_t i = 0; i < count; i++)
+    {
+      double old_value;
+      if(metrics[i].compare == JAYC_BENCH_COMPARE_NONE || jayc_bench_getNumber(line, metrics[i].name, &old_value) == false || old_value == 0.0)
+      {
+        continue;
+      }
+
+      double change = (metrics[i].value - old_value) / old_value * 100.0;
+      int regressed = (metrics[i].compare == JAYC_BENCH_COMPARE_HIGHER ? change < -g_bench.threshold : change > g_bench.threshold);
+      g_bench.compared++;
+      if(regressed)
+      {
+        g_bench.regressions++;
+      }
+
+      printf("%s\"%s\":{\"value\":%.3f,\"change_pct\":%.1f,\"regressed\":%s}",
+        (first ? "" : ","), metrics[i].name, old_value, change, (regressed ? "true" : "false"));
+      first = false;
+    }
+    printf("}");
+  }
+
+  printf("}\n");
+  fflush(stdout);
+}
+
+//------------------------------------------------------------------------------
+//
+void jayc_bench_printSummary(const char *program)
+{
+  if(g_bench.loaded == false)
+  {
+    return;
+  }
+
+  printf("{\"benchmark\":\"summary\",\"variant\":\"%s\",\"threshold_pct\":%.1f,\"compared\":%zu,\"regressions\":%zu}\n",
+    program, g_bench.threshold, g_bench.compared, g_bench.regressions);
+  fflush(stdout);
+
+  if(g_bench.regressions > 0)
+  {
+    fprintf(stderr, "%s: [%zu] of [%zu] metrics regressed by more than [%.1f%%].\n",
+      program, g_bench.regressions, g_bench.compared, g_bench.threshold);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jayc_bench_free(void)
+{
+  for(size_t i = 0; i < g_bench.line_number; i++)
+  {
+    free(g_bench.lines[i]);
+  }
+  free(g_bench.lines);
+
+  g_bench.lines = NULL;
+  g_bench.line_number = 0;
+  g_bench.loaded = false;
+}
+
+//------------------------------------------------------------------------------
+//
+double jayc_bench_perSecond(unsigned long long operations, unsigned long long nanoseconds)
+{
+  if(nanoseconds == 0)
+  {
+    return 0.0;
+  }
+
+  return (double)operations * 1e9 / (double)nanoseconds;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jayc_bench_argHandler_duration(const char **data, size_t data_size)
+{
+  long duration = atol(data[0]);
+  if(duration <= 0)
+  {
+    return jutil_args_error("Invalid value for duration [%s].", data[0]);
+  }
+
+  g_bench.duration = duration;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jayc_bench_argHandler_baseline(const char **data, size_t data_size)
+{
+  if(jayc_bench_loadBaseline(data[0]) == false)
+  {
+    return jutil_args_error("Could not load baseline [%s].", data[0]);
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jayc_bench_argHandler_threshold(const char **data, size_t data_size)
+{
+  double threshold = atof(data[0]);
+  if(threshold <= 0.0)
+  {
+    return jutil_args_error("Invalid value for threshold [%s].", data[0]);
+  }
+
+  jayc_bench_setThreshold(threshold);
+  return NULL;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+const char *jayc_bench_findLine(const char *benchmark, const char *variant)
+{
+  char buf[128];
+
+  for(size_t i = 0; i < g_bench.line_number; i++)
+  {
+    if(jayc_bench_getString(g_bench.lines[i], "benchmark", buf, sizeof(buf)) == false || strcmp(buf, benchmark) != 0)
+    {
+      continue;
+    }
+    if(jayc_bench_getString(g_bench.lines[i], "variant", buf, sizeof(buf)) == false || strcmp(buf, variant) != 0)
+    {
+      continue;
+    }
+
+    return g_bench.lines[i];
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jayc_bench_getString(const char *line, const char *key, char *buf, size_t size)
+{
+  const char *value = jayc_bench_findValue(line, key, NULL);
+  if(value == NULL || *value != '"')
+  {
+    return false;
+  }
+  value++;
+
+  const char *end = strchr(value, '"');
+  if(end == NULL || (size_t)(end - value) >= size)
+  {
+    return false;
+  }
+
+  memcpy(buf, value, end - value);
+  buf[end - value] = '\0';
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jayc_bench_getNumber(const char *line, const char *key, double *value)
+{
+  const char *value_start = jayc_bench_findValue(line, key, strstr(line, JAYC_BENCH_KEY_BASELINE));
+  if(value_start == NULL)
+  {
+    return false;
+  }
+
+  char *value_end = NULL;
+  *value = strtod(value_start, &value_end);
+  return (value_end != value_start);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jayc_bench_findValue(const char *line, const char *key, const char *end)
+{
+  char pattern[128];
+  int length = snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+  if(length < 0 || (size_t)length >= sizeof(pattern))
+  {
+    return NULL;
+  }
+
+  const char *found = strstr(line, pattern);
+  if(found == NULL || (end && found >= end))
+  {
+    return NULL;
+  }
+
+  return found + length;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file jayc_bench.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Shared reporting for the benchmarks in bench/ .
+ * 
+ * Results are printed as one JSON object per line on
+ * @c stdout :
+ * 
+ * @code
+ * {"benchmark":"map_get","variant":"1k","version":"...","ops_per_sec":...}
+ * @endcode
+ * 
+ * With a baseline (output of an earlier run, see
+ * @c #jayc_bench_loadBaseline() ), every compared metric
+ * gets the old value and the change in percent, and
+ * changes for the worse beyond the threshold are
+ * counted as regressions.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JAYC_BENCH_H
+#define INCLUDE_JAYC_BENCH_H
+
+#include <jayc/jutil_args.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Metric is only printed.
+ */
+#define JAYC_BENCH_COMPARE_NONE   0
+
+/**
+ * @brief Higher values are better (f.ex. operations per second).
+ */
+#define JAYC_BENCH_COMPARE_HIGHER 1
+
+/**
+ * @brief Lower values are better (f.ex. latencies).
+ */
+#define JAYC_BENCH_COMPARE_LOWER  2
+
+/**
+ * @brief Default change in percent, that counts as regression.
+ */
+#define JAYC_BENCH_THRESHOLD_DEFAULT 10.0
+
+/**
+ * @brief Default milliseconds, every benchmark runs.
+ */
+#define JAYC_BENCH_DURATION_DEFAULT 1000
+
+/**
+ * @brief Options shared by all benchmark programs.
+ * 
+ * Put into the jutil_args option array of the program.
+ */
+#define JAYC_BENCH_OPTIONS \
+  { \
+    "Duration", \
+    "Time every benchmark runs.", \
+    "duration", \
+    'd', \
+    &jayc_bench_argHandler_duration, \
+    0, \
+    0, \
+    0, \
+    { \
+      { \
+        "milliseconds", \
+        "Duration of one benchmark in milliseconds." \
+      }, \
+      JUTIL_ARGS_OPTIONPARAM_END \
+    } \
+  }, \
+  { \
+    "Baseline", \
+    "Compares results with an earlier run.", \
+    "baseline", \
+    'b', \
+    &jayc_bench_argHandler_baseline, \
+    0, \
+    0, \
+    0, \
+    { \
+      { \
+        "file", \
+        "JSON lines printed by an earlier run." \
+      }, \
+      JUTIL_ARGS_OPTIONPARAM_END \
+    } \
+  }, \
+  { \
+    "Regression threshold", \
+    "Change for the worse, that counts as regression.", \
+    "threshold", \
+    0, \
+    &jayc_bench_argHandler_threshold, \
+    0, \
+    0, \
+    0, \
+    { \
+      { \
+        "percent", \
+        "Threshold in percent (default 10)." \
+      }, \
+      JUTIL_ARGS_OPTIONPARAM_END \
+    } \
+  }
+
+/**
+ * @brief One value of a result.
+ */
+typedef struct __jayc_bench_metric
+{
+  const char *name; /**< Key in JSON object. */
+  double value;     /**< Measured value. */
+  int compare;      /**< @c #JAYC_BENCH_COMPARE_NONE , @c #JAYC_BENCH_COMPARE_HIGHER
+                         or @c #JAYC_BENCH_COMPARE_LOWER . */
+} jayc_bench_metric_t;
+
+/**
+ * @brief Loads results of an earlier run to compare with.
+ * 
+ * Lines, that are no results, are ignored.
+ * 
+ * @param filename  File with JSON lines.
+ * 
+ * @return          @c true , if file was read.
+ * @return          @c false , if error occured.
+ */
+int jayc_bench_loadBaseline(const char *filename);
+
+/**
+ * @brief Sets change in percent, that counts as regression.
+ * 
+ * @param percent Threshold (default @c #JAYC_BENCH_THRESHOLD_DEFAULT ).
+ */
+void jayc_bench_setThreshold(double percent);
+
+/**
+ * @brief Returns milliseconds, every benchmark runs.
+ * 
+ * @return  Duration (option @c --duration ).
+ */
+long jayc_bench_getDuration(void);
+
+/**
+ * @brief Prints line with version and build of library.
+ * 
+ * @param program Name of benchmark program.
+ */
+void jayc_bench_printInfo(const char *program);
+
+/**
+ * @brief Prints result and compares it with the baseline.
+ * 
+ * @param benchmark Name of benchmark.
+ * @param variant   Variant of benchmark (f.ex. size or transport).
+ * @param metrics   Values of result.
+ * @param count     Number of values.
+ */
+void jayc_bench_report(const char *benchmark, const char *variant, const jayc_bench_metric_t *metrics, size_t count);
+
+/**
+ * @brief Prints number of compared metrics and regressions.
+ * 
+ * Only prints, if a baseline was loaded.
+ * 
+ * @param program Name of benchmark program.
+ */
+void jayc_bench_printSummary(const char *program);
+
+/**
+ * @brief Frees baseline.
+ */
+void jayc_bench_free(void);
+
+/**
+ * @brief Calculates rate of operations.
+ * 
+ * @param operations  Number of operations.
+ * @param nanoseconds Time, the operations took.
+ * 
+ * @return            Operations per second.
+ */
+double jayc_bench_perSecond(unsigned long long operations, unsigned long long nanoseconds);
+
+/**
+ * @brief jutil_args handler for option @c --duration .
+ * 
+ * @param data      Parameters of option (milliseconds).
+ * @param data_size Number of parameters.
+ * 
+ * @return          @c NULL , if duration was set.
+ * @return          Error string, if not.
+ */
+char *jayc_bench_argHandler_duration(const char **data, size_t data_size);
+
+/**
+ * @brief jutil_args handler for option @c --baseline .
+ * 
+ * @param data      Parameters of option (file name).
+ * @param data_size Number of parameters.
+ * 
+ * @return          @c NULL , if baseline was loaded.
+ * @return          Error string, if not.
+ */
+char *jayc_bench_argHandler_baseline(const char **data, size_t data_size);
+
+/**
+ * @brief jutil_args handler for option @c --threshold .
+ * 
+ * @param data      Parameters of option (percent).
+ * @param data_size Number of parameters.
+ * 
+ * @return          @c NULL , if threshold was set.
+ * @return          Error string, if not.
+ */
+char *jayc_bench_argHandler_threshold(const char **data, size_t data_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JAYC_BENCH_H */
@@ -0,0 +1,578 @@
+/**
+ * @file jcon_bench.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Throughput and latency benchmarks for jcon.
+ * 
+ * Runs a jcon_system in event loop mode for every transport
+ * (TCP, Unix socket, shared memory) and measures from a
+ * client in the same process:
+ * 
+ * - @c accept : connections per second, every connection
+ *   is confirmed with an echo of one byte.
+ * - @c echo_rtt : round trips of small messages, as
+ *   percentiles in microseconds.
+ * - @c throughput : sustained MB/s a client streams to
+ *   the server, until the server read everything.
+ * 
+ * Results are printed with jayc_bench.h , so they can be
+ * compared between releases. Errors go to @c stderr .
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include "jayc_bench.h"
+#include <jayc/jcon_system.h>
+#include <jayc/jcon_server_tcp.h>
+#include <jayc/jcon_client_tcp.h>
+#include <jayc/jcon_server_unix.h>
+#include <jayc/jcon_client_unix.h>
+#include <jayc/jcon_server_shm.h>
+#include <jayc/jcon_client_shm.h>
+#include <jayc/jcon_client.h>
+#include <jayc/jlog_stdio.h>
+#include <jayc/jutil_args.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jproc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+//==============================================================================
+// Define constants.
+//
+
+#define JCON_BENCH_DEFAULT_LOOPS    1
+#define JCON_BENCH_DEFAULT_PORT     24680
+
+/*
+ * Size of echoed messages and streamed chunks.
+ */
+#define JCON_BENCH_MESSAGE_SIZE 64
+#define JCON_BENCH_CHUNK_SIZE   (64 * 1024)
+
+/*
+ * Round trips before measuring, to fill caches and pools.
+ */
+#define JCON_BENCH_WARMUP 1000
+
+/*
+ * Milliseconds to wait for echoes and the end of streams.
+ */
+#define JCON_BENCH_TIMEOUT 10000
+
+/*
+ * What servers do with recieved data.
+ */
+#define JCON_BENCH_MODE_ECHO 0
+#define JCON_BENCH_MODE_SINK 1
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+typedef struct __jcon_bench_data
+{
+  size_t loops;
+  uint16_t port;
+
+  jlog_t *logger;
+} jcon_bench_t;
+
+typedef struct __jcon_bench_transport
+{
+  const char *name;
+  char path[108];
+
+  jcon_server_t *server;
+  jcon_system_t *system;
+
+  atomic_int mode;
+  atomic_ullong received;
+} jcon_bench_transport_t;
+
+static char *argHandler_loops(const char **data, size_t data_size);
+static char *argHandler_port(const char **data, size_t data_size);
+
+static jutil_args_progDesc_t prog_desc =
+{
+  "jcon_bench",
+
+  "Benchmarks jcon_system over TCP, Unix sockets and shared memory. " \
+  "Prints connections per second, echo round trip percentiles and " \
+  "throughput as JSON lines.",
+
+  "-BENCH-",
+  "Manuel Nadji (https://github.com/gnarrf95)",
+  "Copyright (c) 2026 by Manuel Nadji"
+};
+
+static jutil_args_option_t options[] =
+{
+  {
+    "Event loops",
+    "Number of event loops of the servers.",
+    "loops",
+    'l',
+    &argHandler_loops,
+    0,
+    0,
+    0,
+    {
+      {
+        "loop-number",
+        "Number of event loops (and threads)."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "TCP port",
+    "Port the TCP server binds to on 127.0.0.1.",
+    "port",
+    'p',
+    &argHandler_port,
+    0,
+    0,
+    0,
+    {
+      {
+        "server-port",
+        "Port for TCP server."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  JAYC_BENCH_OPTIONS
+};
+
+static jcon_bench_t g_data =
+{
+  JCON_BENCH_DEFAULT_LOOPS,
+  JCON_BENCH_DEFAULT_PORT,
+  NULL
+};
+
+static int jcon_bench_startServer(jcon_bench_transport_t *transport);
+
+static jcon_client_t *jcon_bench_createClient(jcon_bench_transport_t *transport);
+
+static int jcon_bench_recvAll(jcon_client_t *client, char *buf, size_t size);
+
+static void jcon_bench_dataHandler(void *ctx, jcon_client_t *client);
+
+static int jcon_bench_runAccept(jcon_bench_transport_t *transport);
+
+static int jcon_bench_runEcho(jcon_bench_transport_t *transport);
+
+static int jcon_bench_runThroughput(jcon_bench_transport_t *transport);
+
+static void jcon_bench_stopServer(jcon_bench_transport_t *transport);
+
+//------------------------------------------------------------------------------
+//
+int main(int argc, char *argv[])
+{
+  if(jutil_args_process
+    (
+      &prog_desc,
+      argc,
+      argv,
+      (jutil_args_option_t *)options,
+      sizeof(options)/sizeof(jutil_args_option_t)
+    ) == 0)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+
+  g_data.logger = jlog_stdio_session_init(JLOG_LOGTYPE_WARN);
+  if(g_data.logger == NULL)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+  jlog_global_session_set(g_data.logger);
+
+  jayc_bench_printInfo("jcon_bench");
+
+  jcon_bench_transport_t transports[] =
+  {
+    { .name = "tcp" },
+    { .name = "unix" },
+    { .name = "shm" }
+  };
+
+  int ret = EXIT_SUCCESS;
+  for(size_t i = 0; i < sizeof(transports)/sizeof(jcon_bench_transport_t); i++)
+  {
+    jcon_bench_transport_t *transport = &transports[i];
+    snprintf(transport->path, sizeof(transport->path), "/tmp/jcon_bench_%d_%s.sock", (int)getpid(), transport->name);
+
+    if(jcon_bench_startServer(transport) == false)
+    {
+      ret = EXIT_FAILURE;
+      continue;
+    }
+
+    if(jcon_bench_runAccept(transport) == false
+      || jcon_bench_runEcho(transport) == false
+      || jcon_bench_runThroughput(transport) == false)
+    {
+      ret = EXIT_FAILURE;
+    }
+
+    jcon_bench_stopServer(transport);
+  }
+
+  jayc_bench_printSummary("jcon_bench");
+  jayc_bench_free();
+  jproc_exit(ret);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_bench_startServer(jcon_bench_transport_t *transport)
+{
+  atomic_init(&transport->mode, JCON_BENCH_MODE_ECHO);
+  atomic_init(&transport->received, 0);
+
+  if(strcmp(transport->name, "tcp") == 0)
+  {
+    transport->server = jcon_server_tcp_session_init("127.0.0.1", g_data.port, g_data.logger);
+  }
+  else
+  {
+    unlink(transport->path);
+    if(strcmp(transport->name, "unix") == 0)
+    {
+      transport->server = jcon_server_unix_session_init(transport->path, g_data.logger);
+    }
+    else
+    {
+      transport->server = jcon_server_shm_session_init(transport->path, g_data.logger);
+    }
+  }
+
+  if(transport->server == NULL || jcon_server_reset(transport->server) == false)
+  {
+    fprintf(stderr, "Could not open %s server.\n", transport->name);
+    if(transport->server)
+    {
+      jcon_server_free(transport->server);
+      transport->server = NULL;
+    }
+    return false;
+  }
+
+  transport->system = jcon_system_eventLoop_init
+  (
+    transport->server,
+    g_data.loops,
+    jcon_bench_dataHandler,
+    NULL,
+    NULL,
+    g_data.logger,
+    (void *)transport
+  );
+  if(transport->system == NULL)
+  {
+    fprintf(stderr, "Could not start %s system.\n", transport->name);
+    jcon_server_free(transport->server);
+    transport->server = NULL;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_bench_createClient(jcon_bench_transport_t *transport)
+{
+  if(strcmp(transport->name, "tcp") == 0)
+  {
+    return jcon_client_tcp_session_init("127.0.0.1", g_data.port, g_data.logger);
+  }
+  if(strcmp(transport->name, "unix") == 0)
+  {
+    return jcon_client_unix_session_init(transport->path, g_data.logger);
+  }
+  return jcon_client_shm_session_init(transport->path, 0, g_data.logger);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_bench_recvAll(jcon_client_t *client, char *buf, size_t size)
+{
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, JCON_BENCH_TIMEOUT);
+
+  size_t done = 0;
+  while(done < size)
+  {
+    if(jcon_client_isConnected(client) == false || jutil_time_deadline_isExpired(&deadline))
+    {
+      return false;
+    }
+    if(jcon_client_newData(client))
+    {
+      done += jcon_client_recvData(client, buf + done, size - done);
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_bench_dataHandler(void *ctx, jcon_client_t *client)
+{
+  jcon_bench_transport_t *transport = (jcon_bench_transport_t *)ctx;
+  char buf[JCON_BENCH_CHUNK_SIZE];
+
+  size_t size = jcon_client_recvData(client, buf, sizeof(buf));
+  if(size == 0)
+  {
+    return;
+  }
+
+  if(atomic_load(&transport->mode) == JCON_BENCH_MODE_SINK)
+  {
+    atomic_fetch_add(&transport->received, size);
+  }
+  else
+  {
+    jcon_client_sendData(client, buf, size);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_bench_runAccept(jcon_bench_transport_t *transport)
+{
+  atomic_store(&transport->mode, JCON_BENCH_MODE_ECHO);
+
+  jcon_client_t *client = jcon_bench_createClient(transport);
+  if(client == NULL)
+  {
+    return false;
+  }
+
+  /* Reset closes the last connection and opens a new one. */
+  unsigned long long connections = 0;
+  unsigned long long start = jutil_time_getNanos();
+  unsigned long long end = start + (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+  unsigned long long now = start;
+  while(now < end)
+  {
+    char byte = 'c';
+    if(jcon_client_reset(client) == false
+      || jcon_client_sendData(client, &byte, 1) != 1
+      || jcon_bench_recvAll(client, &byte, 1) == false)
+    {
+      fprintf(stderr, "Connection [%llu] over %s failed.\n", connections, transport->name);
+      jcon_client_session_free(client);
+      return false;
+    }
+    connections++;
+    now = jutil_time_getNanos();
+  }
+  jcon_client_session_free(client);
+
+  double seconds = (double)(now - start) / 1e9;
+  jayc_bench_metric_t metrics[] =
+  {
+    { "connections", (double)connections, JAYC_BENCH_COMPARE_NONE },
+    { "seconds", seconds, JAYC_BENCH_COMPARE_NONE },
+    { "connections_per_sec", (double)connections / seconds, JAYC_BENCH_COMPARE_HIGHER }
+  };
+  jayc_bench_report("accept", transport->name, metrics, sizeof(metrics)/sizeof(jayc_bench_metric_t));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_bench_runEcho(jcon_bench_transport_t *transport)
+{
+  atomic_store(&transport->mode, JCON_BENCH_MODE_ECHO);
+
+  jcon_client_t *client = jcon_bench_createClient(transport);
+  jutil_time_histogram_t *histogram = jutil_time_histogram_init();
+  if(client == NULL || histogram == NULL || jcon_client_reset(client) == false)
+  {
+    fprintf(stderr, "Could not connect to %s server.\n", transport->name);
+    if(client)
+    {
+      jcon_client_session_free(client);
+    }
+    jutil_time_histogram_free(histogram);
+    return false;
+  }
+
+  char message[JCON_BENCH_MESSAGE_SIZE];
+  char answer[JCON_BENCH_MESSAGE_SIZE];
+  memset(message, 'e', sizeof(message));
+
+  int ret = true;
+  unsigned long long rounds = 0;
+  unsigned long long end = jutil_time_getNanos() + (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+  while(true)
+  {
+    unsigned long long start = jutil_time_getNanos();
+    if(rounds >= JCON_BENCH_WARMUP && start >= end)
+    {
+      break;
+    }
+
+    if(jcon_client_sendData(client, message, sizeof(message)) != sizeof(message)
+      || jcon_bench_recvAll(client, answer, sizeof(answer)) == false)
+    {
+      fprintf(stderr, "Echo over %s failed.\n", transport->name);
+      ret = false;
+      break;
+    }
+
+    if(rounds >= JCON_BENCH_WARMUP)
+    {
+      jutil_time_histogram_recordSince(histogram, start);
+    }
+    rounds++;
+  }
+
+  if(ret)
+  {
+    jayc_bench_metric_t metrics[] =
+    {
+      { "message_bytes", JCON_BENCH_MESSAGE_SIZE, JAYC_BENCH_COMPARE_NONE },
+      { "samples", (double)jutil_time_histogram_getCount(histogram), JAYC_BENCH_COMPARE_NONE },
+      { "p50_us", (double)jutil_time_histogram_getPercentile(histogram, 50.0) / 1e3, JAYC_BENCH_COMPARE_LOWER },
+      { "p99_us", (double)jutil_time_histogram_getPercentile(histogram, 99.0) / 1e3, JAYC_BENCH_COMPARE_LOWER },
+      { "p999_us", (double)jutil_time_histogram_getPercentile(histogram, 99.9) / 1e3, JAYC_BENCH_COMPARE_NONE },
+      { "max_us", (double)jutil_time_histogram_getMax(histogram) / 1e3, JAYC_BENCH_COMPARE_NONE }
+    };
+    jayc_bench_report("echo_rtt", transport->name, metrics, sizeof(metrics)/sizeof(jayc_bench_metric_t));
+  }
+
+  jutil_time_histogram_free(histogram);
+  jcon_client_session_free(client);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_bench_runThroughput(jcon_bench_transport_t *transport)
+{
+  atomic_store(&transport->mode, JCON_BENCH_MODE_SINK);
+  atomic_store(&transport->received, 0);
+
+  jcon_client_t *client = jcon_bench_createClient(transport);
+  if(client == NULL || jcon_client_reset(client) == false)
+  {
+    fprintf(stderr, "Could not connect to %s server.\n", transport->name);
+    if(client)
+    {
+      jcon_client_session_free(client);
+    }
+    return false;
+  }
+
+  char *chunk = (char *)malloc(JCON_BENCH_CHUNK_SIZE);
+  if(chunk == NULL)
+  {
+    jcon_client_session_free(client);
+    return false;
+  }
+  memset(chunk, 't', JCON_BENCH_CHUNK_SIZE);
+
+  unsigned long long sent = 0;
+  unsigned long long start = jutil_time_getNanos();
+  unsigned long long end = start + (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+  while(jutil_time_getNanos() < end)
+  {
+    size_t size = jcon_client_sendData(client, chunk, JCON_BENCH_CHUNK_SIZE);
+    if(size == 0)
+    {
+      break;
+    }
+    sent += size;
+  }
+  free(chunk);
+
+  /* Time counts until the server read the last byte. */
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, JCON_BENCH_TIMEOUT);
+  while(atomic_load(&transport->received) < sent && jutil_time_deadline_isExpired(&deadline) == false)
+  {
+    jutil_time_sleep(0, 100000, false);
+  }
+  unsigned long long now = jutil_time_getNanos();
+  unsigned long long received = atomic_load(&transport->received);
+  jcon_client_session_free(client);
+
+  if(received < sent)
+  {
+    fprintf(stderr, "Server over %s recieved [%llu] of [%llu] bytes.\n", transport->name, received, sent);
+    return false;
+  }
+
+  double seconds = (double)(now - start) / 1e9;
+  jayc_bench_metric_t metrics[] =
+  {
+    { "chunk_bytes", JCON_BENCH_CHUNK_SIZE, JAYC_BENCH_COMPARE_NONE },
+    { "bytes", (double)sent, JAYC_BENCH_COMPARE_NONE },
+    { "seconds", seconds, JAYC_BENCH_COMPARE_NONE },
+    { "mb_per_sec", (double)sent / 1e6 / seconds, JAYC_BENCH_COMPARE_HIGHER }
+  };
+  jayc_bench_report("throughput", transport->name, metrics, sizeof(metrics)/sizeof(jayc_bench_metric_t));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_bench_stopServer(jcon_bench_transport_t *transport)
+{
+  jcon_system_free(transport->system);
+  jcon_server_free(transport->server);
+  transport->system = NULL;
+  transport->server = NULL;
+
+  if(strcmp(transport->name, "tcp") != 0)
+  {
+    unlink(transport->path);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+char *argHandler_loops(const char **data, size_t data_size)
+{
+  int loops = atoi(data[0]);
+  if(loops <= 0)
+  {
+    return jutil_args_error("Invalid value for loop number [%s].", data[0]);
+  }
+
+  g_data.loops = (size_t)loops;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *argHandler_port(const char **data, size_t data_size)
+{
+  uint16_t port = atoi(data[0]);
+  if(port == 0)
+  {
+    return jutil_args_error("Invalid value for port [%s].", data[0]);
+  }
+
+  g_data.port = port;
+  return NULL;
+}
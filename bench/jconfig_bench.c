@@ -0,0 +1,246 @@
+/**
+ * @file jconfig_bench.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Microbenchmarks for jconfig.
+ * 
+ * - @c config_load : @c jconfig_raw_loadFromFile() of
+ *   generated files with 1k and 100k entries.
+ * - @c config_iterate : @c jconfig_iterate() over all
+ *   entries and with a prefix, that matches one of
+ *   100 sections.
+ * 
+ * Results are printed with jayc_bench.h .
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include "jayc_bench.h"
+#include <jayc/jconfig.h>
+#include <jayc/jutil_args.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jproc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/*
+ * Keys are spread over this many sections ("section<n>.").
+ */
+#define JCONFIG_BENCH_SECTIONS 100
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+typedef struct __jconfig_bench_size
+{
+  const char *variant;
+  size_t entries;
+} jconfig_bench_size_t;
+
+static jutil_args_progDesc_t prog_desc =
+{
+  "jconfig_bench",
+
+  "Microbenchmarks for loading and iterating jconfig tables. " \
+  "Prints results as JSON lines.",
+
+  "-BENCH-",
+  "Manuel Nadji (https://github.com/gnarrf95)",
+  "Copyright (c) 2026 by Manuel Nadji"
+};
+
+static jutil_args_option_t options[] =
+{
+  JAYC_BENCH_OPTIONS
+};
+
+static int jconfig_bench_createFile(const char *filename, size_t entries, off_t *file_size);
+
+static int jconfig_bench_runLoad(const jconfig_bench_size_t *size, const char *filename, off_t file_size);
+
+static int jconfig_bench_runIterate(const jconfig_bench_size_t *size, const char *filename);
+
+//------------------------------------------------------------------------------
+//
+int main(int argc, char *argv[])
+{
+  if(jutil_args_process
+    (
+      &prog_desc,
+      argc,
+      argv,
+      (jutil_args_option_t *)options,
+      sizeof(options)/sizeof(jutil_args_option_t)
+    ) == 0)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+
+  jayc_bench_printInfo("jconfig_bench");
+
+  const jconfig_bench_size_t sizes[] =
+  {
+    { "1k", 1000 },
+    { "100k", 100000 }
+  };
+
+  char filename[64];
+  snprintf(filename, sizeof(filename), "/tmp/jconfig_bench_%d.conf", (int)getpid());
+
+  int ret = EXIT_SUCCESS;
+  for(size_t i = 0; i < sizeof(sizes)/sizeof(jconfig_bench_size_t); i++)
+  {
+    off_t file_size;
+    if(jconfig_bench_createFile(filename, sizes[i].entries, &file_size) == false
+      || jconfig_bench_runLoad(&sizes[i], filename, file_size) == false
+      || jconfig_bench_runIterate(&sizes[i], filename) == false)
+    {
+      ret = EXIT_FAILURE;
+    }
+    unlink(filename);
+  }
+
+  jayc_bench_printSummary("jconfig_bench");
+  jayc_bench_free();
+  jproc_exit(ret);
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_bench_createFile(const char *filename, size_t entries, off_t *file_size)
+{
+  jconfig_t *table = jconfig_init();
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  char key[64];
+  char value[64];
+  for(size_t i = 0; i < entries; i++)
+  {
+    snprintf(key, sizeof(key), "section%zu.group%zu.key%zu", i % JCONFIG_BENCH_SECTIONS, (i / JCONFIG_BENCH_SECTIONS) % 10, i);
+    snprintf(value, sizeof(value), "value-%zu-0123456789abcdef", i * 2654435761UL);
+    if(jconfig_datapoint_set(table, key, value) == false)
+    {
+      jconfig_free(table);
+      return false;
+    }
+  }
+
+  int ret = jconfig_raw_saveToFile(table, filename);
+  jconfig_free(table);
+
+  struct stat file_stat;
+  if(ret == false || stat(filename, &file_stat) < 0)
+  {
+    fprintf(stderr, "Could not create config file [%s].\n", filename);
+    return false;
+  }
+
+  *file_size = file_stat.st_size;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_bench_runLoad(const jconfig_bench_size_t *size, const char *filename, off_t file_size)
+{
+  jconfig_t *table = jconfig_init();
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  /* Every load replaces the content of the table. */
+  unsigned long long duration = (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+  unsigned long long loads = 0;
+  unsigned long long start = jutil_time_getNanos();
+  unsigned long long now = start;
+  while(now - start < duration)
+  {
+    if(jconfig_raw_loadFromFile(table, filename) == false)
+    {
+      fprintf(stderr, "jconfig_raw_loadFromFile() failed for [%zu] entries.\n", size->entries);
+      jconfig_free(table);
+      return false;
+    }
+    loads++;
+    now = jutil_time_getNanos();
+  }
+  jconfig_free(table);
+
+  double seconds = (double)(now - start) / 1e9;
+  jayc_bench_metric_t metrics[] =
+  {
+    { "file_bytes", (double)file_size, JAYC_BENCH_COMPARE_NONE },
+    { "loads", (double)loads, JAYC_BENCH_COMPARE_NONE },
+    { "ms_per_load", seconds * 1e3 / (double)loads, JAYC_BENCH_COMPARE_NONE },
+    { "entries_per_sec", (double)(loads * size->entries) / seconds, JAYC_BENCH_COMPARE_HIGHER },
+    { "mb_per_sec", (double)loads * (double)file_size / 1e6 / seconds, JAYC_BENCH_COMPARE_NONE }
+  };
+  jayc_bench_report("config_load", size->variant, metrics, sizeof(metrics)/sizeof(jayc_bench_metric_t));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_bench_runIterate(const jconfig_bench_size_t *size, const char *filename)
+{
+  jconfig_t *table = jconfig_init();
+  if(table == NULL || jconfig_raw_loadFromFile(table, filename) == false)
+  {
+    jconfig_free(table);
+    return false;
+  }
+
+  const char *prefixes[] = { "", "section42." };
+  const char *names[] = { "all", "prefix" };
+
+  unsigned long long duration = (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+  for(size_t p = 0; p < sizeof(prefixes)/sizeof(char *); p++)
+  {
+    unsigned long long passes = 0;
+    unsigned long long visited = 0;
+    unsigned long long start = jutil_time_getNanos();
+    unsigned long long now = start;
+    while(now - start < duration)
+    {
+      jconfig_iterator_t *itr = NULL;
+      while((itr = jconfig_iterate(table, prefixes[p], itr)) != NULL)
+      {
+        visited += (jconfig_itr_getKey(itr) != NULL);
+      }
+      passes++;
+      now = jutil_time_getNanos();
+    }
+
+    char variant[32];
+    snprintf(variant, sizeof(variant), "%s_%s", size->variant, names[p]);
+
+    double seconds = (double)(now - start) / 1e9;
+    jayc_bench_metric_t metrics[] =
+    {
+      { "entries_per_pass", (double)visited / (double)passes, JAYC_BENCH_COMPARE_NONE },
+      { "passes_per_sec", (double)passes / seconds, JAYC_BENCH_COMPARE_HIGHER },
+      { "entries_per_sec", (double)visited / seconds, JAYC_BENCH_COMPARE_NONE }
+    };
+    jayc_bench_report("config_iterate", variant, metrics, sizeof(metrics)/sizeof(jayc_bench_metric_t));
+  }
+
+  jconfig_free(table);
+  return true;
+}
@@ -0,0 +1,371 @@
+/**
+ * @file jlog_bench.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Microbenchmarks for jlog backends.
+ * 
+ * Measures messages per second for every backend with an
+ * enabled level ( @c INFO messages at level @c INFO ) and a
+ * disabled level ( @c DEBUG messages at level @c INFO ).
+ * Calls are guarded by @c jlog_isEnabled() , as the log
+ * macros of the library do.
+ * 
+ * - @c stdio : @c stdout is redirected to @c /dev/null .
+ * - @c file and @c binary : files in @c /tmp .
+ * - @c async : jlog_async over a file session, that blocks,
+ *   when its queue is full. Includes the final flush.
+ * - @c syslog : jlog_syslog socket session, that sends to
+ *   a socket of the benchmark instead of @c /dev/log ,
+ *   so the system log is not flooded.
+ * 
+ * Results are printed with jayc_bench.h .
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for dup(), poll() and struct sockaddr_un */
+#define _POSIX_C_SOURCE 200809L
+
+#include "jayc_bench.h"
+#include <jayc/jlog.h>
+#include <jayc/jlog_stdio.h>
+#include <jayc/jlog_file.h>
+#include <jayc/jlog_binary.h>
+#include <jayc/jlog_async.h>
+#include <jayc/jlog_syslog.h>
+#include <jayc/jutil_args.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jproc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <syslog.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/*
+ * Number of messages between two checks of the clock.
+ */
+#define JLOG_BENCH_BATCH 256
+
+/*
+ * Queue of jlog_async session.
+ */
+#define JLOG_BENCH_ASYNC_CAPACITY 4096
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+typedef struct __jlog_bench_data
+{
+  char file_path[64];
+  char binary_path[64];
+  char syslog_path[108];
+
+  int syslog_fd;
+  atomic_ullong syslog_received;
+  jutil_thread_t *syslog_thread;
+} jlog_bench_t;
+
+static jutil_args_progDesc_t prog_desc =
+{
+  "jlog_bench",
+
+  "Microbenchmarks for jlog backends at enabled and disabled levels. " \
+  "Prints messages per second as JSON lines.",
+
+  "-BENCH-",
+  "Manuel Nadji (https://github.com/gnarrf95)",
+  "Copyright (c) 2026 by Manuel Nadji"
+};
+
+static jutil_args_option_t options[] =
+{
+  JAYC_BENCH_OPTIONS
+};
+
+static jlog_bench_t g_data;
+
+static jlog_t *jlog_bench_createSession(const char *backend);
+
+static int jlog_bench_run(const char *backend, int enabled);
+
+static int jlog_bench_openSyslog(void);
+
+static void jlog_bench_closeSyslog(void);
+
+static int jlog_bench_drainSyslog(void *ctx, jutil_thread_t *thread_session);
+
+//------------------------------------------------------------------------------
+//
+int main(int argc, char *argv[])
+{
+  if(jutil_args_process
+    (
+      &prog_desc,
+      argc,
+      argv,
+      (jutil_args_option_t *)options,
+      sizeof(options)/sizeof(jutil_args_option_t)
+    ) == 0)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+
+  jayc_bench_printInfo("jlog_bench");
+
+  snprintf(g_data.file_path, sizeof(g_data.file_path), "/tmp/jlog_bench_%d.log", (int)getpid());
+  snprintf(g_data.binary_path, sizeof(g_data.binary_path), "/tmp/jlog_bench_%d.jlb", (int)getpid());
+  snprintf(g_data.syslog_path, sizeof(g_data.syslog_path), "/tmp/jlog_bench_%d.syslog", (int)getpid());
+  g_data.syslog_fd = -1;
+
+  const char *backends[] = { "stdio", "file", "binary", "async", "syslog" };
+
+  int ret = EXIT_SUCCESS;
+  for(size_t i = 0; i < sizeof(backends)/sizeof(char *); i++)
+  {
+    if(jlog_bench_run(backends[i], true) == false || jlog_bench_run(backends[i], false) == false)
+    {
+      ret = EXIT_FAILURE;
+    }
+  }
+
+  unlink(g_data.file_path);
+  unlink(g_data.binary_path);
+
+  jayc_bench_printSummary("jlog_bench");
+  jayc_bench_free();
+  jproc_exit(ret);
+}
+
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_bench_createSession(const char *backend)
+{
+  if(strcmp(backend, "stdio") == 0)
+  {
+    return jlog_stdio_session_init(JLOG_LOGTYPE_INFO);
+  }
+  if(strcmp(backend, "file") == 0)
+  {
+    unlink(g_data.file_path);
+    return jlog_file_session_init(JLOG_LOGTYPE_INFO, g_data.file_path);
+  }
+  if(strcmp(backend, "binary") == 0)
+  {
+    return jlog_binary_session_init(JLOG_LOGTYPE_INFO, g_data.binary_path);
+  }
+  if(strcmp(backend, "async") == 0)
+  {
+    unlink(g_data.file_path);
+    jlog_t *file = jlog_file_session_init(JLOG_LOGTYPE_INFO, g_data.file_path);
+    if(file == NULL)
+    {
+      return NULL;
+    }
+
+    jlog_t *session = jlog_async_session_init(file, JLOG_BENCH_ASYNC_CAPACITY, JLOG_ASYNC_OVERFLOW_BLOCK);
+    if(session == NULL)
+    {
+      jlog_session_free(file);
+    }
+    return session;
+  }
+
+  if(jlog_bench_openSyslog() == false)
+  {
+    return NULL;
+  }
+  return jlog_syslog_socket_session_init(JLOG_LOGTYPE_INFO, "jlog_bench", LOG_USER, g_data.syslog_path);
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_bench_run(const char *backend, int enabled)
+{
+  /* stdio writes to stdout, where results are printed. */
+  int stdout_copy = -1;
+  if(strcmp(backend, "stdio") == 0)
+  {
+    fflush(stdout);
+    stdout_copy = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if(stdout_copy < 0 || null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0)
+    {
+      fprintf(stderr, "Could not redirect stdout.\n");
+      if(null_fd >= 0)
+      {
+        close(null_fd);
+      }
+      if(stdout_copy >= 0)
+      {
+        close(stdout_copy);
+      }
+      return false;
+    }
+    close(null_fd);
+  }
+
+  jlog_t *session = jlog_bench_createSession(backend);
+  if(session == NULL)
+  {
+    fprintf(stderr, "Could not create %s session.\n", backend);
+  }
+
+  int log_type = (enabled ? JLOG_LOGTYPE_INFO : JLOG_LOGTYPE_DEBUG);
+  unsigned long long duration = (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+  unsigned long long messages = 0;
+  unsigned long long start = jutil_time_getNanos();
+  unsigned long long now = start;
+  atomic_store(&g_data.syslog_received, 0);
+
+  while(session && now - start < duration)
+  {
+    for(int i = 0; i < JLOG_BENCH_BATCH; i++)
+    {
+      if(jlog_isEnabled(session, log_type))
+      {
+        jlog_log_message_m(session, log_type, __FILE__, __func__, __LINE__, "Benchmark message [%llu] with argument [%s].", messages, backend);
+      }
+      messages++;
+    }
+    now = jutil_time_getNanos();
+  }
+
+  /* Messages count, when the backend has written them. */
+  if(session && strcmp(backend, "async") == 0)
+  {
+    jlog_async_flush(session);
+    now = jutil_time_getNanos();
+  }
+
+  if(session)
+  {
+    jlog_session_free(session);
+  }
+
+  if(stdout_copy >= 0)
+  {
+    fflush(stdout);
+    dup2(stdout_copy, STDOUT_FILENO);
+    close(stdout_copy);
+  }
+
+  if(strcmp(backend, "syslog") == 0)
+  {
+    jlog_bench_closeSyslog();
+  }
+
+  if(session == NULL)
+  {
+    return false;
+  }
+
+  /* Syslog sessions drop messages, when the socket is full. */
+  double seconds = (double)(now - start) / 1e9;
+  jayc_bench_metric_t metrics[] =
+  {
+    { "messages", (double)messages, JAYC_BENCH_COMPARE_NONE },
+    { "messages_per_sec", (double)messages / seconds, JAYC_BENCH_COMPARE_HIGHER },
+    { "ns_per_message", (double)(now - start) / (double)messages, JAYC_BENCH_COMPARE_NONE },
+    { "delivered", (double)atomic_load(&g_data.syslog_received), JAYC_BENCH_COMPARE_NONE }
+  };
+  size_t metric_number = sizeof(metrics)/sizeof(jayc_bench_metric_t);
+  if(strcmp(backend, "syslog") != 0)
+  {
+    metric_number--;
+  }
+
+  char variant[32];
+  snprintf(variant, sizeof(variant), "%s_%s", backend, (enabled ? "enabled" : "disabled"));
+  jayc_bench_report("log", variant, metrics, metric_number);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_bench_openSyslog(void)
+{
+  unlink(g_data.syslog_path);
+
+  g_data.syslog_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  if(g_data.syslog_fd < 0)
+  {
+    return false;
+  }
+
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", g_data.syslog_path);
+  if(bind(g_data.syslog_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    fprintf(stderr, "Could not bind syslog socket [%s].\n", g_data.syslog_path);
+    close(g_data.syslog_fd);
+    g_data.syslog_fd = -1;
+    return false;
+  }
+
+  g_data.syslog_thread = jutil_thread_init(jlog_bench_drainSyslog, NULL, 0, 0, NULL);
+  if(g_data.syslog_thread == NULL || jutil_thread_start(g_data.syslog_thread) == false)
+  {
+    jlog_bench_closeSyslog();
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_bench_closeSyslog(void)
+{
+  if(g_data.syslog_thread)
+  {
+    jutil_thread_free(g_data.syslog_thread);
+    g_data.syslog_thread = NULL;
+  }
+
+  if(g_data.syslog_fd >= 0)
+  {
+    close(g_data.syslog_fd);
+    g_data.syslog_fd = -1;
+  }
+  unlink(g_data.syslog_path);
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_bench_drainSyslog(void *ctx, jutil_thread_t *thread_session)
+{
+  struct pollfd pfd;
+  pfd.fd = g_data.syslog_fd;
+  pfd.events = POLLIN;
+  if(poll(&pfd, 1, 10) <= 0)
+  {
+    return true;
+  }
+
+  char buf[2048];
+  while(recv(g_data.syslog_fd, buf, sizeof(buf), MSG_DONTWAIT) > 0)
+  {
+    atomic_fetch_add(&g_data.syslog_received, 1);
+  }
+
+  return true;
+}
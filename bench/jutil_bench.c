@@ -0,0 +1,311 @@
+/**
+ * @file jutil_bench.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Microbenchmarks for jutil containers.
+ * 
+ * - @c map_add , @c map_get , @c map_set : operations on
+ *   jutil_map with 10, 1k and 100k entries.
+ * - @c list_push , @c list_append , @c list_pop : jutil_linkedlist
+ *   filled with 1k and 100k nodes and emptied again.
+ * 
+ * Results are printed with jayc_bench.h .
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include "jayc_bench.h"
+#include <jayc/jutil_map.h>
+#include <jayc/jutil_linkedlist.h>
+#include <jayc/jutil_args.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jproc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/*
+ * Size of one generated key.
+ */
+#define JUTIL_BENCH_KEY_SIZE 32
+
+/*
+ * Number of operations between two checks of the clock.
+ */
+#define JUTIL_BENCH_BATCH 1024
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+typedef struct __jutil_bench_size
+{
+  const char *variant;
+  size_t entries;
+} jutil_bench_size_t;
+
+static jutil_args_progDesc_t prog_desc =
+{
+  "jutil_bench",
+
+  "Microbenchmarks for jutil_map and jutil_linkedlist. " \
+  "Prints operations per second as JSON lines.",
+
+  "-BENCH-",
+  "Manuel Nadji (https://github.com/gnarrf95)",
+  "Copyright (c) 2026 by Manuel Nadji"
+};
+
+static jutil_args_option_t options[] =
+{
+  JAYC_BENCH_OPTIONS
+};
+
+static int jutil_bench_runMap(const jutil_bench_size_t *size);
+
+static int jutil_bench_runList(const jutil_bench_size_t *size);
+
+static void jutil_bench_reportRate(const char *benchmark, const char *variant, unsigned long long operations, unsigned long long nanoseconds);
+
+//------------------------------------------------------------------------------
+//
+int main(int argc, char *argv[])
+{
+  if(jutil_args_process
+    (
+      &prog_desc,
+      argc,
+      argv,
+      (jutil_args_option_t *)options,
+      sizeof(options)/sizeof(jutil_args_option_t)
+    ) == 0)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+
+  jayc_bench_printInfo("jutil_bench");
+
+  const jutil_bench_size_t map_sizes[] =
+  {
+    { "10", 10 },
+    { "1k", 1000 },
+    { "100k", 100000 }
+  };
+  const jutil_bench_size_t list_sizes[] =
+  {
+    { "1k", 1000 },
+    { "100k", 100000 }
+  };
+
+  int ret = EXIT_SUCCESS;
+  for(size_t i = 0; i < sizeof(map_sizes)/sizeof(jutil_bench_size_t); i++)
+  {
+    if(jutil_bench_runMap(&map_sizes[i]) == false)
+    {
+      ret = EXIT_FAILURE;
+    }
+  }
+  for(size_t i = 0; i < sizeof(list_sizes)/sizeof(jutil_bench_size_t); i++)
+  {
+    if(jutil_bench_runList(&list_sizes[i]) == false)
+    {
+      ret = EXIT_FAILURE;
+    }
+  }
+
+  jayc_bench_printSummary("jutil_bench");
+  jayc_bench_free();
+  jproc_exit(ret);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_bench_runMap(const jutil_bench_size_t *size)
+{
+  char (*keys)[JUTIL_BENCH_KEY_SIZE] = malloc(size->entries * JUTIL_BENCH_KEY_SIZE);
+  if(keys == NULL)
+  {
+    return false;
+  }
+  for(size_t i = 0; i < size->entries; i++)
+  {
+    snprintf(keys[i], JUTIL_BENCH_KEY_SIZE, "bench.key.%zu", i);
+  }
+
+  unsigned long long duration = (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+
+  /* Add: fill new maps until the time is used up, freeing is not counted. */
+  unsigned long long operations = 0;
+  unsigned long long elapsed = 0;
+  while(elapsed < duration)
+  {
+    jutil_map_t *map = jutil_map_init();
+    if(map == NULL)
+    {
+      free(keys);
+      return false;
+    }
+
+    unsigned long long start = jutil_time_getNanos();
+    for(size_t i = 0; i < size->entries; i++)
+    {
+      jutil_map_add(map, keys[i], keys[i]);
+    }
+    elapsed += jutil_time_getNanos() - start;
+    operations += size->entries;
+
+    jutil_map_free(map);
+  }
+  jutil_bench_reportRate("map_add", size->variant, operations, elapsed);
+
+  jutil_map_t *map = jutil_map_init();
+  if(map == NULL)
+  {
+    free(keys);
+    return false;
+  }
+  for(size_t i = 0; i < size->entries; i++)
+  {
+    jutil_map_add(map, keys[i], keys[i]);
+  }
+
+  /* Get: keys are looked up in a fixed stride, so small maps
+     are not always hit in the same order as they were added. */
+  size_t misses = 0;
+  size_t index = 0;
+  operations = 0;
+  unsigned long long start = jutil_time_getNanos();
+  unsigned long long now = start;
+  while(now - start < duration)
+  {
+    for(size_t i = 0; i < JUTIL_BENCH_BATCH; i++)
+    {
+      if(jutil_map_get(map, keys[index]) != keys[index])
+      {
+        misses++;
+      }
+      index = (index + 7919) % size->entries;
+    }
+    operations += JUTIL_BENCH_BATCH;
+    now = jutil_time_getNanos();
+  }
+  jutil_bench_reportRate("map_get", size->variant, operations, now - start);
+
+  /* Set: replace values of existing keys. */
+  index = 0;
+  operations = 0;
+  start = jutil_time_getNanos();
+  now = start;
+  while(now - start < duration)
+  {
+    for(size_t i = 0; i < JUTIL_BENCH_BATCH; i++)
+    {
+      jutil_map_set(map, keys[index], keys[(index + 1) % size->entries]);
+      index = (index + 7919) % size->entries;
+    }
+    operations += JUTIL_BENCH_BATCH;
+    now = jutil_time_getNanos();
+  }
+  jutil_bench_reportRate("map_set", size->variant, operations, now - start);
+
+  jutil_map_free(map);
+  free(keys);
+
+  if(misses > 0)
+  {
+    fprintf(stderr, "jutil_map_get() missed [%zu] keys with [%zu] entries.\n", misses, size->entries);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_bench_runList(const jutil_bench_size_t *size)
+{
+  unsigned long long duration = (unsigned long long)jayc_bench_getDuration() * 1000000ULL;
+
+  unsigned long long time_push = 0;
+  unsigned long long time_append = 0;
+  unsigned long long time_pop = 0;
+  unsigned long long operations = 0;
+  size_t lost = 0;
+
+  void *data = &operations;
+  while(time_push + time_append + time_pop < duration)
+  {
+    jutil_linkedlist_t *list = NULL;
+
+    unsigned long long start = jutil_time_getNanos();
+    for(size_t i = 0; i < size->entries; i++)
+    {
+      jutil_linkedlist_push(&list, data);
+    }
+    unsigned long long now = jutil_time_getNanos();
+    time_push += now - start;
+
+    start = now;
+    for(size_t i = 0; i < size->entries; i++)
+    {
+      if(jutil_linkedlist_pop(&list) == NULL)
+      {
+        lost++;
+      }
+    }
+    now = jutil_time_getNanos();
+    time_pop += now - start;
+
+    start = now;
+    for(size_t i = 0; i < size->entries; i++)
+    {
+      jutil_linkedlist_append(&list, data);
+    }
+    time_append += jutil_time_getNanos() - start;
+
+    /* Second pop is counted too, it takes from the front again. */
+    start = jutil_time_getNanos();
+    for(size_t i = 0; i < size->entries; i++)
+    {
+      if(jutil_linkedlist_pop(&list) == NULL)
+      {
+        lost++;
+      }
+    }
+    time_pop += jutil_time_getNanos() - start;
+
+    jutil_linkedlist_free(&list);
+    operations += size->entries;
+  }
+
+  jutil_bench_reportRate("list_push", size->variant, operations, time_push);
+  jutil_bench_reportRate("list_append", size->variant, operations, time_append);
+  jutil_bench_reportRate("list_pop", size->variant, operations * 2, time_pop);
+
+  if(lost > 0)
+  {
+    fprintf(stderr, "jutil_linkedlist_pop() lost [%zu] nodes with [%zu] entries.\n", lost, size->entries);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_bench_reportRate(const char *benchmark, const char *variant, unsigned long long operations, unsigned long long nanoseconds)
+{
+  jayc_bench_metric_t metrics[] =
+  {
+    { "operations", (double)operations, JAYC_BENCH_COMPARE_NONE },
+    { "ops_per_sec", jayc_bench_perSecond(operations, nanoseconds), JAYC_BENCH_COMPARE_HIGHER },
+    { "ns_per_op", (operations ? (double)nanoseconds / (double)operations : 0.0), JAYC_BENCH_COMPARE_NONE }
+  };
+  jayc_bench_report(benchmark, variant, metrics, sizeof(metrics)/sizeof(jayc_bench_metric_t));
+}
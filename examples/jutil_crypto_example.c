@@ -1,11 +1,18 @@
 #include <jayc/jlog_stdio.h>
 #include <jayc/jproc.h>
 #include <jayc/jutil_crypto.h>
+#include <jayc/jutil_time.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define EXITVALUE_SUCCESS 0
 #define EXITVALUE_FAILURE 1
 
+/* Bytes hashed per input size in benchmark. */
+#define BENCHMARK_BYTES (256UL * 1024UL * 1024UL)
+
+static void benchmark(void);
+
 int main()
 {
   jlog_t *logger = jlog_stdio_session_init(JLOG_LOGTYPE_DEBUG);
@@ -69,5 +76,56 @@ int main()
   }
   JLOG_INFO("SHA512 : [%s] -> [%s].", before, sha512_str);
 
+  benchmark();
+
   jproc_exit(EXITVALUE_SUCCESS);
+}
+
+/* Measures throughput of one-shot hashes for small and large inputs. */
+static void benchmark(void)
+{
+  static const size_t sizes[] = { 64, 4096, 1024 * 1024 };
+  unsigned char hash[JUTIL_CRYPTO_SIZE_HASH_MAX];
+
+  char *input = (char *)malloc(sizes[2]);
+  if(input == NULL)
+  {
+    JLOG_ERROR("malloc() failed.");
+    return;
+  }
+  memset(input, 'x', sizes[2]);
+
+  for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    size_t rounds = BENCHMARK_BYTES / sizes[i];
+
+    unsigned long long start = jutil_time_getNanos();
+    for(size_t round = 0; round < rounds; round++)
+    {
+      jutil_crypto_md5_raw(input, sizes[i], hash);
+    }
+    unsigned long long md5_ns = jutil_time_getNanos() - start;
+
+    start = jutil_time_getNanos();
+    for(size_t round = 0; round < rounds; round++)
+    {
+      jutil_crypto_sha256_raw(input, sizes[i], hash);
+    }
+    unsigned long long sha256_ns = jutil_time_getNanos() - start;
+
+    start = jutil_time_getNanos();
+    for(size_t round = 0; round < rounds; round++)
+    {
+      jutil_crypto_sha512_raw(input, sizes[i], hash);
+    }
+    unsigned long long sha512_ns = jutil_time_getNanos() - start;
+
+    /* Bytes per nanosecond are GB/s. */
+    JLOG_INFO("%7zu B : MD5 %.2f GB/s, SHA256 %.2f GB/s, SHA512 %.2f GB/s.", sizes[i],
+      (double)BENCHMARK_BYTES / (double)md5_ns,
+      (double)BENCHMARK_BYTES / (double)sha256_ns,
+      (double)BENCHMARK_BYTES / (double)sha512_ns);
+  }
+
+  free(input);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <jayc/jutil_time.h>
 #include <jayc/jlog_stdio.h>
 #include <jayc/jproc.h>
+#include <poll.h>
 
 #define EXITVALUE_SUCCESS 0
 #define EXITVALUE_FAILURE 1
@@ -77,11 +78,18 @@ int main()
   }
   jutil_time_stopWatch_reset(g_stop_watch);
 
-  /* Wait until signal is caught. */
+  /* Wait for timer until signal is caught. */
+  struct pollfd timer_poll;
+  timer_poll.fd = jutil_time_timer_getFD(g_timer);
+  timer_poll.events = POLLIN;
+
   while(g_run)
   {
-    /* Sleep for every second. */
-    jutil_time_sleep(1, 0, 0);
+    /* Wakes up every second to check g_run. */
+    if(poll(&timer_poll, 1, 1000) > 0)
+    {
+      jutil_time_timer_process(g_timer);
+    }
   }
 
   /* After signal free everything. */
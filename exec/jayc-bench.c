@@ -0,0 +1,1262 @@
+/**
+ * @file jayc-bench.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Load generator for jcon servers.
+ * 
+ * Opens concurrent jcon_client connections over TCP or Unix
+ * sockets and sends messages to an echo server at a fixed
+ * rate. The rate is open-loop: messages are scheduled at
+ * fixed intervals, and latency is measured from the time a
+ * message was scheduled, not from the time it could be sent.
+ * A slow server therefore shows up in the latency instead of
+ * lowering the rate (coordinated omission).
+ * 
+ * Messages are sent raw (the server echoes the same bytes)
+ * or as length prefixed jcon_frame frames.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for poll() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <jayc/jcon_client.h>
+#include <jayc/jcon_client_tcp.h>
+#include <jayc/jcon_client_unix.h>
+#include <jayc/jcon_frame.h>
+#include <jayc/jlog_stdio.h>
+#include <jayc/jutil_args.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jinfo.h>
+#include <jayc/jproc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <poll.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/*
+ * Exit values for jproc_exit().
+ */
+#define JAYCBENCH_EXIT_SUCCESS 0
+#define JAYCBENCH_EXIT_FAILURE 1
+
+/*
+ * Transports to connect with.
+ */
+#define JAYCBENCH_TRANSPORT_NONE 0
+#define JAYCBENCH_TRANSPORT_TCP  1
+#define JAYCBENCH_TRANSPORT_UNIX 2
+
+/*
+ * Default values of options.
+ */
+#define JAYCBENCH_DEFAULT_CONNECTIONS 1
+#define JAYCBENCH_DEFAULT_SIZE        64
+#define JAYCBENCH_DEFAULT_RATE        1000.0
+#define JAYCBENCH_DEFAULT_DURATION    10
+#define JAYCBENCH_DEFAULT_TIMEOUT     2000
+
+/*
+ * Largest message, that fits a length prefix of 4 bytes
+ * and still makes sense for a load test.
+ */
+#define JAYCBENCH_SIZE_MAX (16 * 1024 * 1024)
+
+/*
+ * Initial number of scheduled times, a connection can
+ * wait for. Grows, if the server falls behind.
+ */
+#define JAYCBENCH_PENDING_INITIAL 64
+
+/*
+ * Size of buffer for raw answers.
+ */
+#define JAYCBENCH_RECV_BUFFER (64 * 1024)
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+typedef struct __jaycBench_connection
+{
+  jcon_client_t *client;
+  jcon_frame_t *frame;
+
+  unsigned long long *pending;  /**< Scheduled times of messages without answer. */
+  size_t pending_size;          /**< Capacity of ring buffer. */
+  size_t pending_head;          /**< Index of oldest scheduled time. */
+  size_t pending_number;        /**< Number of scheduled times in buffer. */
+
+  size_t partial;               /**< Bytes of an incomplete raw answer. */
+} jaycBench_connection_t;
+
+typedef struct __jaycBench_data
+{
+  int transport;
+  char address[108];
+  uint16_t port;
+
+  size_t connection_number;
+  size_t message_size;
+  double rate;
+  long duration;
+  long timeout;
+  size_t prefix_size;
+  int json;
+  int log_level;
+
+  jlog_t *logger;
+  jaycBench_connection_t *connections;
+  struct pollfd *poll_fds;
+  char *message;
+  jutil_time_histogram_t *histogram;
+
+  unsigned long long sent;
+  unsigned long long received;
+  unsigned long long errors;
+  unsigned long long lost;
+
+  volatile sig_atomic_t run;
+} jaycBench_data_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Frees global data.
+ * 
+ * Used in @c #jaycBench_exitHandler .
+ */
+static void jaycBench_freeData();
+
+/**
+ * @brief Manages freeing memory and cleaning up, when program exits.
+ * 
+ * @param exit_value  Exit value for @c exit() .
+ * @param ctx         Context pointer provided by user.
+ */
+static void jaycBench_exitHandler(int exit_value, void *ctx);
+
+/**
+ * @brief Handles SIGINT signal.
+ * 
+ * Stops sending, the results so far are still reported.
+ * 
+ * @param signal_number Signal caught (should be SIGINT).
+ * @param ctx           Context pointer provided by user.
+ */
+static void jaycBench_signalHandler(int signal_number, void *ctx);
+
+/**
+ * @brief Handles TCP argument.
+ * 
+ * @param data      Address and port in string array.
+ * @param data_size Size of array (should be 2).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argTcp(const char **data, size_t data_size);
+
+/**
+ * @brief Handles Unix socket argument.
+ * 
+ * @param data      Socket path in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argUnix(const char **data, size_t data_size);
+
+/**
+ * @brief Handles number of connections argument.
+ * 
+ * @param data      Number in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argConnections(const char **data, size_t data_size);
+
+/**
+ * @brief Handles message size argument.
+ * 
+ * @param data      Size in bytes in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argSize(const char **data, size_t data_size);
+
+/**
+ * @brief Handles rate argument.
+ * 
+ * @param data      Messages per second in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argRate(const char **data, size_t data_size);
+
+/**
+ * @brief Handles duration argument.
+ * 
+ * @param data      Seconds in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argDuration(const char **data, size_t data_size);
+
+/**
+ * @brief Handles timeout argument.
+ * 
+ * @param data      Milliseconds in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argTimeout(const char **data, size_t data_size);
+
+/**
+ * @brief Handles frame argument.
+ * 
+ * @param data      Size of length prefix in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argFrame(const char **data, size_t data_size);
+
+/**
+ * @brief Handles JSON argument.
+ * 
+ * @param data      Empty array.
+ * @param data_size Size of array (should be 0).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argJson(const char **data, size_t data_size);
+
+/**
+ * @brief Handles debug argument.
+ * 
+ * @param data      Empty array.
+ * @param data_size Size of array (should be 0).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycBench_argDebug(const char **data, size_t data_size);
+
+/**
+ * @brief Checks combination of options.
+ * 
+ * @return  @c true , if options can be used.
+ * @return  @c false , if not.
+ */
+static int jaycBench_checkOptions();
+
+/**
+ * @brief Opens all connections.
+ * 
+ * @return  @c true , if all clients are connected.
+ * @return  @c false , if error occured.
+ */
+static int jaycBench_connect();
+
+/**
+ * @brief Sends messages at scheduled times and handles answers.
+ * 
+ * Sending stops after the duration, afterwards answers are
+ * awaited until the timeout.
+ * 
+ * @return  Nanoseconds from first scheduled message until
+ *          sending stopped.
+ */
+static unsigned long long jaycBench_run();
+
+/**
+ * @brief Sends one message through connection.
+ * 
+ * @param index     Index of connection.
+ * @param scheduled Time the message was scheduled at.
+ */
+static void jaycBench_send(size_t index, unsigned long long scheduled);
+
+/**
+ * @brief Reads answers from connection.
+ * 
+ * @param index Index of connection.
+ */
+static void jaycBench_recieve(size_t index);
+
+/**
+ * @brief Records latency of oldest message of connection.
+ * 
+ * @param connection Connection, that got an answer.
+ */
+static void jaycBench_answer(jaycBench_connection_t *connection);
+
+/**
+ * @brief Handles frames, if option @c --frame is used.
+ * 
+ * @param ctx         Connection of frame.
+ * @param client      Client, the frame was recieved from.
+ * @param frame_ptr   Frame data.
+ * @param frame_size  Size of frame data.
+ */
+static void jaycBench_frameHandler(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size);
+
+/**
+ * @brief Closes connection and counts its messages as lost.
+ * 
+ * @param index Index of connection.
+ */
+static void jaycBench_disconnect(size_t index);
+
+/**
+ * @brief Returns number of messages waiting for an answer.
+ * 
+ * @return  Number of messages.
+ */
+static unsigned long long jaycBench_getOutstanding();
+
+/**
+ * @brief Prints results as text.
+ * 
+ * @param nanoseconds Time messages were sent.
+ */
+static void jaycBench_printResults(unsigned long long nanoseconds);
+
+/**
+ * @brief Prints results as JSON line.
+ * 
+ * @param nanoseconds Time messages were sent.
+ */
+static void jaycBench_printJson(unsigned long long nanoseconds);
+
+
+
+//==============================================================================
+// Define global data.
+//
+
+/**
+ * @brief Program description for --help function.
+ */
+static jutil_args_progDesc_t prog_desc =
+{
+  "jayc-bench",
+
+  "Load generator for jcon echo servers. Sends messages over " \
+  "concurrent TCP or Unix socket connections at a fixed rate " \
+  "and reports latency percentiles and throughput.",
+
+  "v1.0-alpha",
+  "Manuel Nadji (https://github.com/gnarrf95)",
+  "Copyright (c) 2026 by Manuel Nadji"
+};
+
+/**
+ * @brief Option structures for defining CLI options for jutil_args.
+ */
+static jutil_args_option_t jaycBench_argOptions[] =
+{
+  {
+    "TCP server",
+    "Connect to server over TCP.",
+    "tcp",
+    't',
+    &jaycBench_argTcp,
+    0,
+    0,
+    0,
+    {
+      {
+        "address",
+        "IP address or DNS name of server."
+      },
+      {
+        "port",
+        "Port of server."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Unix server",
+    "Connect to server over Unix socket.",
+    "unix",
+    'u',
+    &jaycBench_argUnix,
+    0,
+    0,
+    0,
+    {
+      {
+        "path",
+        "Path of socket file."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Connections",
+    "Number of concurrent connections (default 1).",
+    "connections",
+    'c',
+    &jaycBench_argConnections,
+    0,
+    0,
+    0,
+    {
+      {
+        "number",
+        "Number of connections."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Message size",
+    "Size of every message (default 64).",
+    "size",
+    's',
+    &jaycBench_argSize,
+    0,
+    0,
+    0,
+    {
+      {
+        "bytes",
+        "Payload size in bytes."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Rate",
+    "Messages per second over all connections (default 1000).",
+    "rate",
+    'r',
+    &jaycBench_argRate,
+    0,
+    0,
+    0,
+    {
+      {
+        "messages",
+        "Target rate in messages per second."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Duration",
+    "Time messages are sent (default 10).",
+    "duration",
+    'd',
+    &jaycBench_argDuration,
+    0,
+    0,
+    0,
+    {
+      {
+        "seconds",
+        "Duration in seconds."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Timeout",
+    "Time to wait for answers after sending stopped (default 2000).",
+    "timeout",
+    0,
+    &jaycBench_argTimeout,
+    0,
+    0,
+    0,
+    {
+      {
+        "milliseconds",
+        "Timeout in milliseconds."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Framing",
+    "Send messages as length prefixed jcon_frame frames.",
+    "frame",
+    'f',
+    &jaycBench_argFrame,
+    0,
+    0,
+    0,
+    {
+      {
+        "prefix-size",
+        "Size of length prefix in bytes (1, 2 or 4)."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "JSON output",
+    "Print results as one JSON line.",
+    "json",
+    0,
+    &jaycBench_argJson,
+    0,
+    0,
+    0,
+    JUTIL_ARGS_OPTIONPARAM_EMPTY
+  },
+  {
+    "Debug output",
+    "Enable debug output.",
+    "debug",
+    0,
+    &jaycBench_argDebug,
+    0,
+    0,
+    0,
+    JUTIL_ARGS_OPTIONPARAM_EMPTY
+  }
+};
+
+/**
+ * @brief Global data.
+ */
+static jaycBench_data_t g_data =
+{
+  JAYCBENCH_TRANSPORT_NONE,
+  { 0 },
+  0,
+
+  JAYCBENCH_DEFAULT_CONNECTIONS,
+  JAYCBENCH_DEFAULT_SIZE,
+  JAYCBENCH_DEFAULT_RATE,
+  JAYCBENCH_DEFAULT_DURATION,
+  JAYCBENCH_DEFAULT_TIMEOUT,
+  0,
+  false,
+  JLOG_LOGTYPE_WARN,
+
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+
+  0,
+  0,
+  0,
+  0,
+
+  true
+};
+
+
+
+//==============================================================================
+// Implement main function.
+//
+
+int main(int argc, char *argv[])
+{
+  jproc_exit_setHandler(jaycBench_exitHandler, NULL);
+  jproc_signal_setHandler(SIGINT, jaycBench_signalHandler, NULL);
+
+  if(jutil_args_process
+    (
+      &prog_desc,
+      argc,
+      argv,
+      jaycBench_argOptions,
+      sizeof(jaycBench_argOptions)/sizeof(jutil_args_option_t)
+    ) == false)
+  {
+    jproc_exit(JAYCBENCH_EXIT_FAILURE);
+  }
+
+  if(jaycBench_checkOptions() == false)
+  {
+    jproc_exit(JAYCBENCH_EXIT_FAILURE);
+  }
+
+  g_data.logger = jlog_stdio_session_init(g_data.log_level);
+  if(g_data.logger == NULL)
+  {
+    jproc_exit(JAYCBENCH_EXIT_FAILURE);
+  }
+
+  g_data.message = (char *)malloc(g_data.message_size);
+  g_data.histogram = jutil_time_histogram_init();
+  if(g_data.message == NULL || g_data.histogram == NULL)
+  {
+    fprintf(stderr, "Could not allocate memory.\n");
+    jproc_exit(JAYCBENCH_EXIT_FAILURE);
+  }
+  for(size_t i = 0; i < g_data.message_size; i++)
+  {
+    g_data.message[i] = (char)('a' + (i % 26));
+  }
+
+  if(jaycBench_connect() == false)
+  {
+    jproc_exit(JAYCBENCH_EXIT_FAILURE);
+  }
+
+  unsigned long long nanoseconds = jaycBench_run();
+  if(g_data.json)
+  {
+    jaycBench_printJson(nanoseconds);
+  }
+  else
+  {
+    jaycBench_printResults(nanoseconds);
+  }
+
+  jproc_exit((g_data.errors || g_data.lost) ? JAYCBENCH_EXIT_FAILURE : JAYCBENCH_EXIT_SUCCESS);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_freeData()
+{
+  if(g_data.connections)
+  {
+    for(size_t i = 0; i < g_data.connection_number; i++)
+    {
+      if(g_data.connections[i].frame)
+      {
+        jcon_frame_free(g_data.connections[i].frame);
+      }
+      if(g_data.connections[i].client)
+      {
+        jcon_client_session_free(g_data.connections[i].client);
+      }
+      free(g_data.connections[i].pending);
+    }
+    free(g_data.connections);
+    g_data.connections = NULL;
+  }
+
+  free(g_data.poll_fds);
+  g_data.poll_fds = NULL;
+  free(g_data.message);
+  g_data.message = NULL;
+  jutil_time_histogram_free(g_data.histogram);
+  g_data.histogram = NULL;
+
+  if(g_data.logger)
+  {
+    jlog_session_free(g_data.logger);
+    g_data.logger = NULL;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_exitHandler(int exit_value, void *ctx)
+{
+  jaycBench_freeData();
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_signalHandler(int signal_number, void *ctx)
+{
+  g_data.run = false;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argTcp(const char **data, size_t data_size)
+{
+  if(data_size != 2 || data == NULL || data[0] == NULL || data[1] == NULL)
+  {
+    return jutil_args_error("[-t/--tcp] Address and port required.");
+  }
+  if(strlen(data[0]) >= sizeof(g_data.address))
+  {
+    return jutil_args_error("[-t/--tcp] Address too long.");
+  }
+
+  long port = atol(data[1]);
+  if(port <= 0 || port > UINT16_MAX)
+  {
+    return jutil_args_error("[-t/--tcp] Invalid port [%s].", data[1]);
+  }
+
+  snprintf(g_data.address, sizeof(g_data.address), "%s", data[0]);
+  g_data.port = (uint16_t)port;
+  g_data.transport = JAYCBENCH_TRANSPORT_TCP;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argUnix(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[-u/--unix] Socket path required.");
+  }
+  if(strlen(data[0]) >= sizeof(g_data.address))
+  {
+    return jutil_args_error("[-u/--unix] Socket path too long.");
+  }
+
+  snprintf(g_data.address, sizeof(g_data.address), "%s", data[0]);
+  g_data.transport = JAYCBENCH_TRANSPORT_UNIX;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argConnections(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[-c/--connections] Number required.");
+  }
+
+  long number = atol(data[0]);
+  if(number <= 0)
+  {
+    return jutil_args_error("[-c/--connections] Invalid number [%s].", data[0]);
+  }
+
+  g_data.connection_number = (size_t)number;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argSize(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[-s/--size] Size required.");
+  }
+
+  long size = atol(data[0]);
+  if(size <= 0 || size > JAYCBENCH_SIZE_MAX)
+  {
+    return jutil_args_error("[-s/--size] Invalid size [%s] (1 - %d).", data[0], JAYCBENCH_SIZE_MAX);
+  }
+
+  g_data.message_size = (size_t)size;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argRate(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[-r/--rate] Rate required.");
+  }
+
+  double rate = atof(data[0]);
+  if(rate <= 0.0)
+  {
+    return jutil_args_error("[-r/--rate] Invalid rate [%s].", data[0]);
+  }
+
+  g_data.rate = rate;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argDuration(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[-d/--duration] Duration required.");
+  }
+
+  long duration = atol(data[0]);
+  if(duration <= 0)
+  {
+    return jutil_args_error("[-d/--duration] Invalid duration [%s].", data[0]);
+  }
+
+  g_data.duration = duration;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argTimeout(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[--timeout] Timeout required.");
+  }
+
+  long timeout = atol(data[0]);
+  if(timeout < 0)
+  {
+    return jutil_args_error("[--timeout] Invalid timeout [%s].", data[0]);
+  }
+
+  g_data.timeout = timeout;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argFrame(const char **data, size_t data_size)
+{
+  if(data_size != 1 || data == NULL || data[0] == NULL)
+  {
+    return jutil_args_error("[-f/--frame] Prefix size required.");
+  }
+
+  long prefix_size = atol(data[0]);
+  if(prefix_size != 1 && prefix_size != 2 && prefix_size != 4)
+  {
+    return jutil_args_error("[-f/--frame] Invalid prefix size [%s] (1, 2 or 4).", data[0]);
+  }
+
+  g_data.prefix_size = (size_t)prefix_size;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argJson(const char **data, size_t data_size)
+{
+  if(data_size != 0)
+  {
+    return jutil_args_error("[--json] Should have no arguments.");
+  }
+
+  g_data.json = true;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jaycBench_argDebug(const char **data, size_t data_size)
+{
+  if(data_size != 0)
+  {
+    return jutil_args_error("[--debug] Should have no arguments.");
+  }
+
+  g_data.log_level = JLOG_LOGTYPE_DEBUG;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jaycBench_checkOptions()
+{
+  if(g_data.transport == JAYCBENCH_TRANSPORT_NONE)
+  {
+    fprintf(stderr, "No server given (use --tcp or --unix, see --help).\n");
+    return false;
+  }
+
+  if(g_data.prefix_size > 0 && g_data.prefix_size < sizeof(uint32_t)
+    && g_data.message_size >= (1UL << (g_data.prefix_size * 8)))
+  {
+    fprintf(stderr, "Message size [%zu] does not fit length prefix of [%zu] bytes.\n", g_data.message_size, g_data.prefix_size);
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jaycBench_connect()
+{
+  g_data.connections = (jaycBench_connection_t *)calloc(g_data.connection_number, sizeof(jaycBench_connection_t));
+  g_data.poll_fds = (struct pollfd *)calloc(g_data.connection_number, sizeof(struct pollfd));
+  if(g_data.connections == NULL || g_data.poll_fds == NULL)
+  {
+    fprintf(stderr, "Could not allocate memory for [%zu] connections.\n", g_data.connection_number);
+    return false;
+  }
+
+  for(size_t i = 0; i < g_data.connection_number; i++)
+  {
+    jaycBench_connection_t *connection = &g_data.connections[i];
+
+    if(g_data.transport == JAYCBENCH_TRANSPORT_TCP)
+    {
+      connection->client = jcon_client_tcp_session_init(g_data.address, g_data.port, g_data.logger);
+    }
+    else
+    {
+      connection->client = jcon_client_unix_session_init(g_data.address, g_data.logger);
+    }
+
+    if(connection->client == NULL || jcon_client_reset(connection->client) == false)
+    {
+      fprintf(stderr, "Could not open connection [%zu] to [%s].\n", i, g_data.address);
+      return false;
+    }
+
+    if(g_data.prefix_size > 0)
+    {
+      connection->frame = jcon_frame_lengthPrefix_init(connection->client, g_data.prefix_size, g_data.message_size, jaycBench_frameHandler, g_data.logger, connection);
+      if(connection->frame == NULL)
+      {
+        return false;
+      }
+    }
+
+    connection->pending = (unsigned long long *)malloc(JAYCBENCH_PENDING_INITIAL * sizeof(unsigned long long));
+    if(connection->pending == NULL)
+    {
+      return false;
+    }
+    connection->pending_size = JAYCBENCH_PENDING_INITIAL;
+
+    g_data.poll_fds[i].fd = jcon_client_getFileDescriptor(connection->client);
+    g_data.poll_fds[i].events = POLLIN;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jaycBench_run()
+{
+  double interval = 1e9 / g_data.rate;
+  unsigned long long start = jutil_time_getNanos();
+  unsigned long long end = start + (unsigned long long)g_data.duration * 1000000000ULL;
+  unsigned long long drain_end = 0;
+  unsigned long long scheduled_number = 0;
+  unsigned long long stopped = 0;
+
+  while(true)
+  {
+    unsigned long long now = jutil_time_getNanos();
+    int timeout;
+
+    if(g_data.run && now < end)
+    {
+      /* Everything due is sent, even if the loop fell behind. */
+      unsigned long long scheduled = start + (unsigned long long)(scheduled_number * interval);
+      while(g_data.run && scheduled <= now && scheduled < end)
+      {
+        jaycBench_send(scheduled_number % g_data.connection_number, scheduled);
+        scheduled_number++;
+        scheduled = start + (unsigned long long)(scheduled_number * interval);
+      }
+
+      /* poll() waits in milliseconds, below that it spins. */
+      now = jutil_time_getNanos();
+      timeout = (scheduled > now ? (int)((scheduled - now) / 1000000ULL) : 0);
+    }
+    else
+    {
+      if(stopped == 0)
+      {
+        stopped = (now < end ? now : end);
+        drain_end = now + (unsigned long long)g_data.timeout * 1000000ULL;
+      }
+      if(jaycBench_getOutstanding() == 0 || now >= drain_end)
+      {
+        break;
+      }
+      timeout = (int)((drain_end - now) / 1000000ULL) + 1;
+    }
+
+    int ret_poll = poll(g_data.poll_fds, g_data.connection_number, timeout);
+    if(ret_poll <= 0)
+    {
+      continue;
+    }
+
+    for(size_t i = 0; i < g_data.connection_number; i++)
+    {
+      if(g_data.poll_fds[i].revents)
+      {
+        jaycBench_recieve(i);
+      }
+    }
+  }
+
+  g_data.lost += jaycBench_getOutstanding();
+  return stopped - start;
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_send(size_t index, unsigned long long scheduled)
+{
+  jaycBench_connection_t *connection = &g_data.connections[index];
+  if(g_data.poll_fds[index].fd < 0)
+  {
+    g_data.errors++;
+    return;
+  }
+
+  if(connection->pending_number == connection->pending_size)
+  {
+    size_t new_size = connection->pending_size * 2;
+    unsigned long long *pending = (unsigned long long *)malloc(new_size * sizeof(unsigned long long));
+    if(pending == NULL)
+    {
+      g_data.errors++;
+      return;
+    }
+    for(size_t i = 0; i < connection->pending_number; i++)
+    {
+      pending[i] = connection->pending[(connection->pending_head + i) % connection->pending_size];
+    }
+    free(connection->pending);
+    connection->pending = pending;
+    connection->pending_size = new_size;
+    connection->pending_head = 0;
+  }
+
+  /* Answers can arrive while sending, so the time is queued first. */
+  connection->pending[(connection->pending_head + connection->pending_number) % connection->pending_size] = scheduled;
+  connection->pending_number++;
+
+  int sent;
+  if(connection->frame)
+  {
+    sent = jcon_frame_send(connection->frame, g_data.message, g_data.message_size);
+  }
+  else
+  {
+    sent = (jcon_client_sendData(connection->client, g_data.message, g_data.message_size) == g_data.message_size);
+  }
+
+  if(sent == false)
+  {
+    connection->pending_number--;
+    g_data.errors++;
+    if(jcon_client_isConnected(connection->client) == false)
+    {
+      jaycBench_disconnect(index);
+    }
+    return;
+  }
+
+  g_data.sent++;
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_recieve(size_t index)
+{
+  jaycBench_connection_t *connection = &g_data.connections[index];
+
+  if(connection->frame)
+  {
+    if(jcon_frame_process(connection->frame) < 0)
+    {
+      g_data.errors++;
+    }
+  }
+  else
+  {
+    static char buf[JAYCBENCH_RECV_BUFFER];
+    size_t size = jcon_client_recvData(connection->client, buf, sizeof(buf));
+
+    connection->partial += size;
+    while(connection->partial >= g_data.message_size && connection->pending_number > 0)
+    {
+      connection->partial -= g_data.message_size;
+      jaycBench_answer(connection);
+    }
+  }
+
+  if(jcon_client_isConnected(connection->client) == false)
+  {
+    jaycBench_disconnect(index);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_answer(jaycBench_connection_t *connection)
+{
+  if(connection->pending_number == 0)
+  {
+    g_data.errors++;
+    return;
+  }
+
+  jutil_time_histogram_recordSince(g_data.histogram, connection->pending[connection->pending_head]);
+  connection->pending_head = (connection->pending_head + 1) % connection->pending_size;
+  connection->pending_number--;
+  g_data.received++;
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_frameHandler(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size)
+{
+  jaycBench_connection_t *connection = (jaycBench_connection_t *)ctx;
+  if(frame_size != g_data.message_size)
+  {
+    g_data.errors++;
+  }
+  jaycBench_answer(connection);
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_disconnect(size_t index)
+{
+  jaycBench_connection_t *connection = &g_data.connections[index];
+  if(g_data.poll_fds[index].fd < 0)
+  {
+    return;
+  }
+
+  fprintf(stderr, "Connection [%zu] closed by server.\n", index);
+  g_data.poll_fds[index].fd = -1;
+  g_data.lost += connection->pending_number;
+  connection->pending_number = 0;
+  jcon_client_close(connection->client);
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jaycBench_getOutstanding()
+{
+  unsigned long long outstanding = 0;
+  for(size_t i = 0; i < g_data.connection_number; i++)
+  {
+    outstanding += g_data.connections[i].pending_number;
+  }
+  return outstanding;
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_printResults(unsigned long long nanoseconds)
+{
+  double seconds = (double)nanoseconds / 1e9;
+  if(seconds <= 0.0)
+  {
+    seconds = 1e-9;
+  }
+
+  printf("%s\n", jinfo_build_version());
+  printf("%zu connections over %s to [%s", g_data.connection_number,
+    (g_data.transport == JAYCBENCH_TRANSPORT_TCP ? "tcp" : "unix"), g_data.address);
+  if(g_data.transport == JAYCBENCH_TRANSPORT_TCP)
+  {
+    printf(":%u", g_data.port);
+  }
+  printf("], %zu byte messages", g_data.message_size);
+  if(g_data.prefix_size > 0)
+  {
+    printf(" (%zu byte length prefix)", g_data.prefix_size);
+  }
+  printf(", target %.1f msg/s for %.2f s.\n\n", g_data.rate, seconds);
+
+  printf("  Sent      %llu (%.1f msg/s)\n", g_data.sent, (double)g_data.sent / seconds);
+  printf("  Received  %llu (%.1f msg/s, %.2f MB/s)\n", g_data.received, (double)g_data.received / seconds,
+    (double)g_data.received * (double)g_data.message_size / 1e6 / seconds);
+  printf("  Errors    %llu\n", g_data.errors);
+  printf("  Lost      %llu\n\n", g_data.lost);
+
+  if(jutil_time_histogram_getCount(g_data.histogram) == 0)
+  {
+    printf("  No answers recieved.\n");
+    return;
+  }
+
+  printf("  Latency (us, from scheduled send time)\n");
+  printf("    min   %12.1f\n", (double)jutil_time_histogram_getMin(g_data.histogram) / 1e3);
+  printf("    mean  %12.1f\n", jutil_time_histogram_getMean(g_data.histogram) / 1e3);
+  printf("    max   %12.1f\n\n", (double)jutil_time_histogram_getMax(g_data.histogram) / 1e3);
+
+  /* Percentile spectrum, halving the distance to 100% each step. */
+  printf("  %12s  %12s  %12s\n", "Value(us)", "Percentile", "TotalCount");
+  unsigned long long count = jutil_time_histogram_getCount(g_data.histogram);
+  double remaining = 50.0;
+  double percentile = 50.0;
+  while(true)
+  {
+    unsigned long long value = jutil_time_histogram_getPercentile(g_data.histogram, percentile);
+    printf("  %12.1f  %12.6f  %12llu\n", (double)value / 1e3, percentile / 100.0,
+      (unsigned long long)((double)count * percentile / 100.0));
+
+    if(percentile >= 100.0 || (double)count * (100.0 - percentile) / 100.0 < 1.0)
+    {
+      break;
+    }
+    remaining /= 2.0;
+    percentile = 100.0 - remaining;
+  }
+  printf("  %12.1f  %12.6f  %12llu\n", (double)jutil_time_histogram_getMax(g_data.histogram) / 1e3, 1.0, count);
+}
+
+//------------------------------------------------------------------------------
+//
+void jaycBench_printJson(unsigned long long nanoseconds)
+{
+  double seconds = (double)nanoseconds / 1e9;
+  if(seconds <= 0.0)
+  {
+    seconds = 1e-9;
+  }
+
+  printf("{\"tool\":\"jayc-bench\",\"version\":\"%s\",\"transport\":\"%s\",\"connections\":%zu,\"message_bytes\":%zu,\"prefix_bytes\":%zu",
+    jinfo_build_version(), (g_data.transport == JAYCBENCH_TRANSPORT_TCP ? "tcp" : "unix"),
+    g_data.connection_number, g_data.message_size, g_data.prefix_size);
+  printf(",\"target_rate\":%.3f,\"seconds\":%.3f,\"sent\":%llu,\"received\":%llu,\"errors\":%llu,\"lost\":%llu",
+    g_data.rate, seconds, g_data.sent, g_data.received, g_data.errors, g_data.lost);
+  printf(",\"rate\":%.3f,\"mb_per_sec\":%.3f", (double)g_data.received / seconds,
+    (double)g_data.received * (double)g_data.message_size / 1e6 / seconds);
+
+  const double percentiles[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+  const char *names[] = { "p50", "p90", "p99", "p999", "p9999" };
+  printf(",\"latency_us\":{\"min\":%.3f,\"mean\":%.3f",
+    (double)jutil_time_histogram_getMin(g_data.histogram) / 1e3, jutil_time_histogram_getMean(g_data.histogram) / 1e3);
+  for(size_t i = 0; i < sizeof(percentiles)/sizeof(double); i++)
+  {
+    printf(",\"%s\":%.3f", names[i], (double)jutil_time_histogram_getPercentile(g_data.histogram, percentiles[i]) / 1e3);
+  }
+  printf(",\"max\":%.3f}}\n", (double)jutil_time_histogram_getMax(g_data.histogram) / 1e3);
+}
@@ -15,6 +15,7 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include <jayc/jconfig.h>
+#include <jayc/jconfig_binary.h>
 #include <jayc/jproc.h>
 #include <jayc/jlog_stdio.h>
 #include <jayc/jutil_args.h>
@@ -24,6 +25,8 @@
 #include <string.h>
 #include <stdbool.h>
 #include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 //==============================================================================
 // Define constants.
@@ -39,13 +42,16 @@
 /*
  * File formats to read config.
  */
-#define JAYCCONF_FORMAT_RAW 0
+#define JAYCCONF_FORMAT_RAW    0
+#define JAYCCONF_FORMAT_BINARY 1
 
 /*
  * CLI commands to edit config.
  */
 #define JAYCCONF_CMD_LOAD   "lod"
 #define JAYCCONF_CMD_SAVE   "sav"
+#define JAYCCONF_CMD_IMPORT "imp"
+#define JAYCCONF_CMD_EXPORT "exp"
 #define JAYCCONF_CMD_SET    "set"
 #define JAYCCONF_CMD_GET    "get"
 #define JAYCCONF_CMD_DELETE "del"
@@ -70,6 +76,7 @@ typedef struct __jaycConf_data
 {
   char filename[128];
   int file_format;
+  char script[128];
 
   jconfig_t *config_data;
   jutil_cli_t *cli;
@@ -152,6 +159,30 @@ static char *jaycConf_argFile(const char **data, size_t data_size);
  */
 static char *jaycConf_argDebug(const char **data, size_t data_size);
 
+/**
+ * @brief Handles script argument.
+ * 
+ * Commands are read from script instead of
+ * interactive input. "-" reads from stdin.
+ * 
+ * @param data      Filename in string array.
+ * @param data_size Size of array (should be 1).
+ * 
+ * @return          @c NULL , if everything worked.
+ * @return          Error message if something went wrong.
+ */
+static char *jaycConf_argScript(const char **data, size_t data_size);
+
+/**
+ * @brief Runs commands of script.
+ * 
+ * @param file  Script path, "-" for stdin.
+ * 
+ * @return      @c true , if successful.
+ * @return      @c false , if error occured.
+ */
+static int jaycConf_runScript(const char *file);
+
 /**
  * @brief Loads config data from file.
  * 
@@ -245,7 +276,24 @@ static jutil_args_option_t jaycConf_argOptions[] =
       },
       {
         "file-format",
-        "Format which to parse."
+        "Format which to parse (0: raw, 1: binary)."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
+  },
+  {
+    "Script",
+    "Run commands from file (\"-\" for stdin) and exit.",
+    "script",
+    's',
+    &jaycConf_argScript,
+    0,
+    0,
+    0,
+    {
+      {
+        "filename",
+        "File to read commands from."
       },
       JUTIL_ARGS_OPTIONPARAM_END
     }
@@ -270,6 +318,7 @@ static jaycConf_data_t g_data =
 {
   { 0 },
   JAYCCONF_FORMAT_RAW,
+  { 0 },
   NULL,
   NULL,
   JLOG_LOGTYPE_INFO,
@@ -314,6 +363,16 @@ int main(int argc, char *argv[])
   }
 
   g_data.cli = jutil_cli_init(&jaycConf_cliHandler, NULL, NULL);
+  if(strcmp(g_data.script, ""))
+  {
+    if(jaycConf_runScript(g_data.script) == false)
+    {
+      ERROR("jaycConf_runScript() failed.");
+      jproc_exit(JAYCCONF_EXIT_FAILURE);
+    }
+    jproc_exit(JAYCCONF_EXIT_SUCCESS);
+  }
+
   while(g_data.run)
   {
     jutil_cli_run(g_data.cli);
@@ -336,6 +395,7 @@ void jaycConf_initData()
   jproc_signal_setHandler(SIGINT, jaycConf_signalHandler, NULL);
 
   memset(g_data.filename, 0, sizeof(g_data.filename));
+  memset(g_data.script, 0, sizeof(g_data.script));
 
   g_data.config_data = jconfig_init();
 
@@ -411,6 +471,65 @@ char *jaycConf_argDebug(const char **data, size_t data_size)
   return NULL;
 }
 
+//------------------------------------------------------------------------------
+//
+char *jaycConf_argScript(const char **data, size_t data_size)
+{
+  if(data_size != 1)
+  {
+    return jutil_args_error("[-s/--script] Invalid argument size [%lu].", data_size);
+  }
+  if(data == NULL)
+  {
+    return jutil_args_error("[-s/--script] Data array is NULL.");
+  }
+  if(data[0] == NULL)
+  {
+    return jutil_args_error("[-s/--script] Argument string missing.");
+  }
+  if(strlen(data[0]) >= sizeof(g_data.script))
+  {
+    return jutil_args_error("[-s/--script] Filename too long.");
+  }
+
+  memcpy(g_data.script, data[0], strlen(data[0]));
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jaycConf_runScript(const char *file)
+{
+  int fd = STDIN_FILENO;
+  if(strcmp(file, "-"))
+  {
+    fd = open(file, O_RDONLY);
+    if(fd < 0)
+    {
+      ERROR("Could not open script [%s].", file);
+      return false;
+    }
+  }
+
+  jconfig_batch_begin(g_data.config_data, 0);
+  long commands = jutil_cli_runBatch(g_data.cli, fd);
+  jconfig_batch_commit(g_data.config_data);
+
+  if(fd != STDIN_FILENO)
+  {
+    close(fd);
+  }
+
+  if(commands < 0)
+  {
+    return false;
+  }
+
+  DEBUG("Ran [%ld] commands of script [%s].", commands, file);
+  return true;
+}
+
 //------------------------------------------------------------------------------
 //
 int jaycConf_loadConfig(const char *file, int format)
@@ -427,6 +546,11 @@ int jaycConf_loadConfig(const char *file, int format)
       return jconfig_raw_loadFromFile(g_data.config_data, file);
     }
 
+    case JAYCCONF_FORMAT_BINARY:
+    {
+      return jconfig_binary_loadFromFile(g_data.config_data, file);
+    }
+
     default:
     {
       return false;
@@ -450,6 +574,11 @@ int jaycConf_saveConfig(const char *file, int format)
       return jconfig_raw_saveToFile(g_data.config_data, file);
     }
 
+    case JAYCCONF_FORMAT_BINARY:
+    {
+      return jconfig_binary_saveToFile(g_data.config_data, file);
+    }
+
     default:
     {
       return false;
@@ -479,6 +608,8 @@ int jaycConf_cliHandler(const char **args, size_t arg_size, void *ctx)
    * Commands:
    * - lod <file> <format>  (Loads config from file)
    * - sav <file> <format>  (Saves config to file)
+   * - imp <file>           (Merges raw file into config)
+   * - exp <file>           (Saves config as raw file)
    * - set <key> <value>    (Sets value)
    * - get <key>            (Print key)
    * - del <key>            (Deletes key)
@@ -527,6 +658,41 @@ int jaycConf_cliHandler(const char **args, size_t arg_size, void *ctx)
     printf("Could not load config.");
     return 0;
   }
+  else if(strcmp(args[0], JAYCCONF_CMD_IMPORT) == 0)
+  {
+    if(arg_size != 2)
+    {
+      INFO("Invalid number of arguments for command [%s].", args[0]);
+      return 0;
+    }
+
+    long added = jconfig_raw_importFromFile(g_data.config_data, args[1]);
+    if(added >= 0)
+    {
+      printf("OK [%ld new keys]\n\n", added);
+      return 0;
+    }
+
+    printf("Could not import config.");
+    return 0;
+  }
+  else if(strcmp(args[0], JAYCCONF_CMD_EXPORT) == 0)
+  {
+    if(arg_size != 2)
+    {
+      INFO("Invalid number of arguments for command [%s].", args[0]);
+      return 0;
+    }
+
+    if(jconfig_raw_saveToFile(g_data.config_data, args[1]))
+    {
+      printf("OK\n\n");
+      return 0;
+    }
+
+    printf("Could not export config.");
+    return 0;
+  }
   else if(strcmp(args[0], JAYCCONF_CMD_SET) == 0)
   {
     if(arg_size != 3)
@@ -535,7 +701,9 @@ int jaycConf_cliHandler(const char **args, size_t arg_size, void *ctx)
       return 0;
     }
 
-    if(jconfig_datapoint_set(g_data.config_data, args[1], args[2]))
+    /* Scripts run as one batch. */
+    int ret_set = (g_data.script[0] ? jconfig_batch_set(g_data.config_data, args[1], args[2]) : jconfig_datapoint_set(g_data.config_data, args[1], args[2]));
+    if(ret_set)
     {
       printf("OK\n\n");
       return 0;
@@ -605,6 +773,7 @@ int jaycConf_cliHandler(const char **args, size_t arg_size, void *ctx)
     }
 
     g_data.run = false;
+    jutil_cli_stop(g_data.cli);
     return 0;
   }
   else if(strcmp(args[0], JAYCCONF_CMD_HELP) == 0)
@@ -633,6 +802,8 @@ void jaycConf_cli_printHelp()
    * Commands:
    * - lod <file> <format>  (Loads config from file)
    * - sav <file> <format>  (Saves config to file)
+   * - imp <file>           (Merges raw file into config)
+   * - exp <file>           (Saves config as raw file)
    * - set <key> <value>    (Sets value)
    * - get <key>            (Print key)
    * - del <key>            (Deletes key)
@@ -646,13 +817,23 @@ void jaycConf_cli_printHelp()
   printf("# lod <file> <format>\n");
   printf("  Load configuration from file.\n");
   printf("  - file : File to read.\n");
-  printf("  - format : File format to parse.\n");
+  printf("  - format : File format to parse (0: raw, 1: binary).\n");
   printf("\n");
 
   printf("# sav <file> <format>\n");
   printf("  Save configuration to file.\n");
   printf("  - file : File to write to.\n");
-  printf("  - format : File format to parse.\n");
+  printf("  - format : File format to parse (0: raw, 1: binary).\n");
+  printf("\n");
+
+  printf("# imp <file>\n");
+  printf("  Merge raw file into configuration.\n");
+  printf("  - file : File to read.\n");
+  printf("\n");
+
+  printf("# exp <file>\n");
+  printf("  Save configuration as raw file.\n");
+  printf("  - file : File to write to.\n");
   printf("\n");
 
   printf("# set <key> <value>\n");
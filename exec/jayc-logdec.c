@@ -0,0 +1,36 @@
+/**
+ * @file jayc-logdec.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Tool to render binary log files as text.
+ * 
+ * Binary log files are written by jlog_binary sessions.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jlog_binary.h>
+#include <jayc/jproc.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+//------------------------------------------------------------------------------
+//
+int main(int argc, char *argv[])
+{
+  if(argc != 2)
+  {
+    fprintf(stderr, "Usage: %s <binary log file>\n", argv[0]);
+    jproc_exit(1);
+  }
+
+  if(jlog_binary_decodeFile(argv[1], stdout) == false)
+  {
+    fprintf(stderr, "Could not render file [%s] completely.\n", argv[1]);
+    jproc_exit(1);
+  }
+
+  jproc_exit(0);
+}
@@ -36,6 +36,8 @@
 #define JSYS_DEFAULT_IP       "127.0.0.1"
 #define JSYS_DEFAULT_PORT     1234
 #define JSYS_DEFAULT_HASHCODE 1
+#define JSYS_DEFAULT_WORKERS  0
+#define JSYS_QUEUE_DEPTH      256
 
 #define JSYS_HASHCODE_NONE    0
 #define JSYS_HASHCODE_MD5     1
@@ -47,6 +49,7 @@ typedef struct __jsys_data
   char address[64];
   uint16_t port;
   int hash_code; // 0->none, 1->md5, 2->sha256, 3->sha512
+  size_t workers; // 0->thread per connection
 
   jcon_system_t *system;
   jcon_server_t *server;
@@ -59,6 +62,7 @@ static char *argHandler_syslog(const char **data, size_t data_size);
 static char *argHandler_ip(const char **data, size_t data_size);
 static char *argHandler_port(const char **data, size_t data_size);
 static char *argHandler_hashcode(const char **data, size_t data_size);
+static char *argHandler_workers(const char **data, size_t data_size);
 
 static jutil_args_progDesc_t prog_desc =
 {
@@ -142,6 +146,23 @@ static jutil_args_option_t options[] =
       },
       JUTIL_ARGS_OPTIONPARAM_END
     }
+  },
+  {
+    "Worker threads",
+    "Multiplexes connections on an event loop and hashes on a worker pool.",
+    "workers",
+    'w',
+    &argHandler_workers,
+    0,
+    0,
+    0,
+    {
+      {
+        "worker-number",
+        "Number of worker threads (0->thread per connection)."
+      },
+      JUTIL_ARGS_OPTIONPARAM_END
+    }
   }
 };
 
@@ -150,6 +171,7 @@ static jsys_t g_data =
   JSYS_DEFAULT_IP,
   JSYS_DEFAULT_PORT,
   JSYS_DEFAULT_HASHCODE,
+  JSYS_DEFAULT_WORKERS,
   NULL,
   NULL,
   NULL,
@@ -202,15 +224,33 @@ int main(int argc, char *argv[])
     jproc_exit(EXIT_FAILURE);
   }
 
-  g_data.system = jcon_system_init
-  (
-    g_data.server,
-    jsys_dataHandler,
-    jsys_createHandler,
-    jsys_closeHandler,
-    g_data.logger,
-    (void *)&g_data
-  );
+  if(g_data.workers > 0)
+  {
+    g_data.system = jcon_system_workerPool_init
+    (
+      g_data.server,
+      1,
+      g_data.workers,
+      JSYS_QUEUE_DEPTH,
+      jsys_dataHandler,
+      jsys_createHandler,
+      jsys_closeHandler,
+      g_data.logger,
+      (void *)&g_data
+    );
+  }
+  else
+  {
+    g_data.system = jcon_system_init
+    (
+      g_data.server,
+      jsys_dataHandler,
+      jsys_createHandler,
+      jsys_closeHandler,
+      g_data.logger,
+      (void *)&g_data
+    );
+  }
   if(g_data.system == NULL)
   {
     jproc_exit(EXIT_FAILURE);
@@ -389,4 +429,18 @@ char *argHandler_hashcode(const char **data, size_t data_size)
 
   g_data.hash_code = hashcode;
   return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+char *argHandler_workers(const char **data, size_t data_size)
+{
+  int workers = atoi(data[0]);
+  if(workers < 0)
+  {
+    return jutil_args_error("Invalid value for worker number [%d].", workers);
+  }
+
+  g_data.workers = workers;
+  return NULL;
 }
\ No newline at end of file
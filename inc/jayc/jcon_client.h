@@ -17,7 +17,10 @@
 #ifndef INCLUDE_JCON_CLIENT_H
 #define INCLUDE_JCON_CLIENT_H
 
+#include <jayc/jutil_buffer.h>
 #include <stddef.h>
+#include <sys/uio.h>
+#include <sys/types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,14 +33,14 @@ typedef struct __jcon_client_session jcon_client_t;
 
 /**
  * @brief Frees session memory.
- *
+ * 
  * @param session Session object to destroy.
  */
 void jcon_client_session_free(jcon_client_t *session);
 
 /**
  * @brief Reset connection of session.
- *
+ * 
  * @param  session  Session to reset.
  * 
  * @return          @c true , if reset was successful.
@@ -47,14 +50,14 @@ int jcon_client_reset(jcon_client_t *session);
 
 /**
  * @brief Close connection of session.
- *
+ * 
  * @param session Session to close.
  */
 void jcon_client_close(jcon_client_t *session);
 
 /**
  * @brief Get type of connection.
- *
+ * 
  * @param session Session to check.
  * 
  * @return        String representing type of connection.
@@ -64,7 +67,7 @@ const char *jcon_client_getConnectionType(jcon_client_t *session);
 
 /**
  * @brief Get string that shows information about client connection.
- *
+ * 
  * @param session Session to check.
  * 
  * @return        String with client connection info.
@@ -74,7 +77,7 @@ const char *jcon_client_getReferenceString(jcon_client_t *session);
 
 /**
  * @brief Check if session is connected.
- *
+ * 
  * @param session Session to check.
  * 
  * @return        @c true , if session is connected.
@@ -84,7 +87,7 @@ int jcon_client_isConnected(jcon_client_t *session);
 
 /**
  * @brief Check if there is new data available to read.
- *
+ * 
  * @param session Session to check.
  * 
  * @return        @c true , if new data is available.
@@ -94,7 +97,7 @@ int jcon_client_newData(jcon_client_t *session);
 
 /**
  * @brief Recieve data from session.
- *
+ * 
  * @param session   Session to recieve data from.
  * @param data_ptr  Pointer, in which data is stored.
  *                  If NULL, bytes will still be read (number given by
@@ -111,7 +114,7 @@ size_t jcon_client_recvData(jcon_client_t *session, void *data_ptr, size_t data_
  * 
  * If return is not equal to @c data_size, something went wrong
  * in the transmittion and not all the data was sent.
- *
+ * 
  * @param session   Session to send data through.
  * @param data_ptr  Pointer to data to be sent.
  *                  If NULL, nothing will happen.
@@ -122,6 +125,138 @@ size_t jcon_client_recvData(jcon_client_t *session, void *data_ptr, size_t data_
  */
 size_t jcon_client_sendData(jcon_client_t *session, void *data_ptr, size_t data_size);
 
+/**
+ * @brief Send data from multiple buffers through session.
+ * 
+ * Buffers are sent in order with one system call,
+ * for example header, body and trailer of a reply.
+ * If return is not equal to the summed buffer sizes,
+ * not all the data was sent.
+ * 
+ * @param session   Session to send data through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended over all buffers.
+ * @return          @c 0 , if no data written or error occured.
+ */
+size_t jcon_client_sendDataV(jcon_client_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Send data from multiple buffers without blocking.
+ * 
+ * Works like @c #jcon_client_sendDataV() , but returns
+ * instead of waiting, when the send buffer is full.
+ * Then @c 0 is returned and @c errno is set to @c EAGAIN .
+ * Used to drain send queues from event loops.
+ * 
+ * @param session   Session to send data through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended over all buffers.
+ * @return          @c 0 , if send buffer is full, implementation
+ *                  does not support it or error occured.
+ */
+size_t jcon_client_trySendDataV(jcon_client_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Recieve data into buffer.
+ * 
+ * Data is written behind the last segment of the buffer
+ * ( @c #jutil_buffer_reserve() ), so it can be sliced
+ * without copy.
+ * 
+ * @param session Session to recieve data from.
+ * @param buffer  Buffer to append data to. Must not be shared.
+ * @param size    Maximum number of bytes to read.
+ * 
+ * @return        Size of data recieved.
+ * @return        @c 0 , if no data recieved, or error occured.
+ */
+size_t jcon_client_recvBuffer(jcon_client_t *session, jutil_buffer_t *buffer, size_t size);
+
+/**
+ * @brief Send data of buffer through session.
+ * 
+ * Segments of the buffer are sent with
+ * @c #jcon_client_sendDataV() without copy.
+ * If return is not equal to size of buffer,
+ * not all the data was sent.
+ * 
+ * @param session Session to send data through.
+ * @param buffer  Buffer to send.
+ * 
+ * @return        Size of data sended.
+ * @return        @c 0 , if no data written or error occured.
+ */
+size_t jcon_client_sendBuffer(jcon_client_t *session, jutil_buffer_t *buffer);
+
+/**
+ * @brief Send data of a file or pipe through session.
+ * 
+ * Implementations based on sockets let the kernel copy the
+ * data ( @c sendfile() or @c splice() ), so it never gets
+ * read into user space. For pipes @c offset is ignored.
+ * If return is not equal to size, not all the data was
+ * sent (for example end of file was reached).
+ * 
+ * @param session         Session to send data through.
+ * @param file_descriptor Descriptor to read data from.
+ * @param offset          Position in file to start reading.
+ * @param size            Number of bytes to send.
+ * 
+ * @return                Size of data sended.
+ * @return                @c 0 , if no data written, implementation
+ *                        does not support it or error occured.
+ */
+size_t jcon_client_sendFile(jcon_client_t *session, int file_descriptor, off_t offset, size_t size);
+
+/**
+ * @brief Cork or flush sends of session.
+ * 
+ * While corked, data of following sends is held back
+ * and sent in full segments. Disabling cork flushes
+ * the held back data.
+ * 
+ * @param session   Session to configure.
+ * @param enable    @c true to cork, @c false to flush.
+ * 
+ * @return          @c true , if successful.
+ * @return          @c false , if implementation does not
+ *                  support corking or error occured.
+ */
+int jcon_client_setCork(jcon_client_t *session, int enable);
+
+/**
+ * @brief Get file descriptor of connection.
+ * 
+ * Allows registering the client with event loops
+ * (see @c #jcon_eventLoop_add() ). The descriptor stays
+ * owned by the session and must not be closed manually.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        File descriptor of connection.
+ * @return        @c -1 , if implementation has no descriptor,
+ *                client is not connected or error occured.
+ */
+int jcon_client_getFileDescriptor(jcon_client_t *session);
+
+/**
+ * @brief Set how long @c #jcon_client_newData() waits for data.
+ * 
+ * @param session Session to configure.
+ * @param timeout Time to wait in milliseconds.
+ *                @c 0 returns immediately,
+ *                @c -1 waits until data arrives.
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if implementation does not support
+ *                timeouts or error occured.
+ */
+int jcon_client_setPollTimeout(jcon_client_t *session, int timeout);
+
 #ifdef __cplusplus
 }
 #endif
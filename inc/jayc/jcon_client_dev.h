@@ -20,7 +20,7 @@ extern "C" {
 
 /**
  * @brief Function to handle session reset calls.
- *
+ * 
  * @param ctx Context pointer for session data.
  * 
  * @return    @c true , if reset was successful.
@@ -30,7 +30,7 @@ typedef int(*jcon_client_reset_function_t)(void *ctx);
 
 /**
  * @brief Function to handle session close calls.
- *
+ * 
  * @param ctx Context pointer for session data.
  */
 typedef void(*jcon_client_close_function_t)(void *ctx);
@@ -47,7 +47,7 @@ typedef const char* (*jcon_client_getReferenceString_function_t)(void *ctx);
 
 /**
  * @brief Function to handle request for connection state.
- *
+ * 
  * @param ctx Context pointer for session data.
  * 
  * @return    @c true , if connected.
@@ -57,7 +57,7 @@ typedef int(*jcon_client_isConnected_function_t)(void *ctx);
 
 /**
  * @brief Function to handle requests if new data is available.
- *
+ * 
  * @param ctx Context pointer for session data.
  * 
  * @return    @c true , if new data is available.
@@ -67,7 +67,7 @@ typedef int(*jcon_client_newData_function_t)(void *ctx);
 
 /**
  * @brief Function to handle calls for data recieving.
- *
+ * 
  * @param ctx       Context pointer for session data.
  * @param data_ptr  Pointer, in which data is stored.
  *                  If NULL, bytes will still be read (number given by
@@ -81,7 +81,7 @@ typedef size_t(*jcon_client_recvData_function_t)(void *ctx, void *data_ptr, size
 
 /**
  * @brief Function to handle calls for data sending.
- *
+ * 
  * @param ctx       Context pointer for session data.
  * @param data_ptr  Pointer to data to be sent.
  *                  If NULL, nothing will happen.
@@ -92,10 +92,96 @@ typedef size_t(*jcon_client_recvData_function_t)(void *ctx, void *data_ptr, size
  */
 typedef size_t(*jcon_client_sendData_function_t)(void *ctx, void *data_ptr, size_t data_size);
 
+/**
+ * @brief Function to handle calls for sending multiple buffers.
+ * 
+ * @param ctx       Context pointer for session data.
+ * @param iov       Array of buffers to send in order.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended over all buffers.
+ * @return          @c 0 , if no data written or error occured.
+ */
+typedef size_t(*jcon_client_sendDataV_function_t)(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Function to handle calls for sending multiple buffers
+ *        without blocking.
+ * 
+ * Optional. Implementations, that can not send without
+ * blocking, set this to @c NULL .
+ * 
+ * @param ctx       Context pointer for session data.
+ * @param iov       Array of buffers to send in order.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended over all buffers.
+ * @return          @c 0 , if send buffer is full or error occured.
+ */
+typedef size_t(*jcon_client_trySendDataV_function_t)(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Function to handle calls for sending data of a file descriptor.
+ * 
+ * Optional. Implementations, that can not send from
+ * descriptors, set this to @c NULL .
+ * 
+ * @param ctx             Context pointer for session data.
+ * @param file_descriptor Descriptor to read data from.
+ * @param offset          Position in file to start reading.
+ * @param size            Number of bytes to send.
+ * 
+ * @return                Size of data sended.
+ * @return                @c 0 , if no data written or error occured.
+ */
+typedef size_t(*jcon_client_sendFile_function_t)(void *ctx, int file_descriptor, off_t offset, size_t size);
+
+/**
+ * @brief Function to handle requests for the file descriptor.
+ * 
+ * Optional. Implementations, that are not based on
+ * a pollable descriptor, set this to @c NULL .
+ * 
+ * @param ctx Context pointer for session data.
+ * 
+ * @return    File descriptor of connection.
+ * @return    @c -1 , if not available or error occured.
+ */
+typedef int(*jcon_client_getFileDescriptor_function_t)(void *ctx);
+
+/**
+ * @brief Function to handle changes of the poll timeout.
+ * 
+ * Optional. Implementations, that do not wait in
+ * @c newData , set this to @c NULL .
+ * 
+ * @param ctx     Context pointer for session data.
+ * @param timeout Time to wait for new data in milliseconds.
+ *                @c -1 waits until data arrives.
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if error occured.
+ */
+typedef int(*jcon_client_setPollTimeout_function_t)(void *ctx, int timeout);
+
+/**
+ * @brief Function to handle cork and flush calls.
+ * 
+ * Optional. Implementations, that can not hold back
+ * partial frames, set this to @c NULL .
+ * 
+ * @param ctx     Context pointer for session data.
+ * @param enable  @c true to cork, @c false to flush.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+typedef int(*jcon_client_setCork_function_t)(void *ctx, int enable);
+
 
 /**
  * @brief Handler to destroy session. Session carries its own function to free the context memory.
- *
+ * 
  * @param ctx Session context to free.
  */
 typedef void(*jcon_client_session_free_handler_t)(void *ctx);
@@ -113,6 +199,12 @@ struct __jcon_client_session
   jcon_client_newData_function_t function_newData;                        /**< Pointer to function, to check wether new data is available to read. */
   jcon_client_recvData_function_t function_recvData;                      /**< Pointer to function, with which to recieve data. */
   jcon_client_sendData_function_t function_sendData;                      /**< Pointer to function, with which to send data. */
+  jcon_client_sendDataV_function_t function_sendDataV;                    /**< Pointer to function, with which to send multiple buffers. */
+  jcon_client_trySendDataV_function_t function_trySendDataV;              /**< Pointer to function, with which to send multiple buffers without blocking. */
+  jcon_client_sendFile_function_t function_sendFile;                      /**< Pointer to function, with which to send data of a file descriptor. */
+  jcon_client_getFileDescriptor_function_t function_getFileDescriptor;    /**< Pointer to function, to get file descriptor for event loops. */
+  jcon_client_setPollTimeout_function_t function_setPollTimeout;          /**< Pointer to function, to set how long newData waits. */
+  jcon_client_setCork_function_t function_setCork;                        /**< Pointer to function, to cork and flush sends. */
 
   jcon_client_session_free_handler_t session_free_handler;                /**< Pointer to function, with which to free context memory. */
 
@@ -0,0 +1,119 @@
+/**
+ * @file jcon_client_shm.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Shared memory connector for clients on the same host,
+ *        implemented using jcon_client.
+ * 
+ * The client connects to a jcon_server_shm over a Unix socket
+ * and passes a shared memory file ( @c memfd_create() ) with two
+ * byte rings, one for every direction. Data is copied into the
+ * ring of the peer, without crossing the kernel.
+ * 
+ * The Unix connection stays open and tells the peer, when a
+ * process exits. Waiting peers are woken with an @c eventfd ,
+ * that is only written, when the reader is not already looking
+ * at the ring. A reader, that is waiting in @c #jcon_client_newData() ,
+ * spins on the ring for a short time first
+ * ( @c #jcon_client_shm_setSpinTime() ), so messages of a
+ * busy connection are passed without system calls.
+ * 
+ * @c #jcon_client_getFileDescriptor() returns an @c epoll
+ * descriptor, that becomes readable for new data and hangups,
+ * so connections can be used in event loops. It never reports
+ * write events: if the ring of the peer was full, the peer
+ * makes the descriptor readable, once it read from the ring,
+ * and jcon_system sends queued data on that event.
+ * Blocking sends wait for space.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jcon_client.h
+ * @see jcon_server_shm.h
+ */
+
+#ifndef INCLUDE_JCON_CLIENT_SHM_H
+#define INCLUDE_JCON_CLIENT_SHM_H
+
+#include <jayc/jcon_client.h>
+#include <jayc/jcon_socket.h>
+#include <jayc/jlog.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default size of one ring in bytes.
+ */
+#define JCON_CLIENT_SHM_RING_SIZE_DEFAULT (1024 * 1024)
+
+/**
+ * @brief Smallest size of one ring in bytes.
+ */
+#define JCON_CLIENT_SHM_RING_SIZE_MIN 4096
+
+/**
+ * @brief Largest size of one ring in bytes.
+ */
+#define JCON_CLIENT_SHM_RING_SIZE_MAX (1024 * 1024 * 1024)
+
+/**
+ * @brief Default nanoseconds, a waiting reader spins on the ring.
+ */
+#define JCON_CLIENT_SHM_SPIN_DEFAULT 20000
+
+/**
+ * @brief Initialize client with uds file path of server.
+ * 
+ * Shared memory is created at @c #jcon_client_reset() .
+ * 
+ * @param filepath  Path to uds file of jcon_server_shm.
+ * @param ring_size Size of every ring in bytes. Power of two between
+ *                  @c #JCON_CLIENT_SHM_RING_SIZE_MIN and
+ *                  @c #JCON_CLIENT_SHM_RING_SIZE_MAX .
+ *                  @c 0 uses @c #JCON_CLIENT_SHM_RING_SIZE_DEFAULT .
+ * @param logger    jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return          jcon_client session object.
+ * @return          @c NULL , if an error occured.
+ */
+jcon_client_t *jcon_client_shm_session_init(char *filepath, size_t ring_size, jlog_t *logger);
+
+/**
+ * @brief Initialize client from connection accepted by server.
+ * 
+ * Used by jcon_server_shm. Waits for the shared memory
+ * of the client and maps it.
+ * 
+ * @param unix_session  Accepted jcon_socketUnix session.
+ *                      Owned by new session, if successful.
+ * @param logger        Logger to use.
+ * 
+ * @return              jcon_client session for new connection.
+ * @return              @c NULL , if client did not send valid
+ *                      shared memory in time or error occured.
+ */
+jcon_client_t *jcon_client_shm_session_accept(jcon_socket_t *unix_session, jlog_t *logger);
+
+/**
+ * @brief Sets time, a waiting reader spins on the ring.
+ * 
+ * Spinning saves the wakeup, when the peer answers quickly,
+ * but keeps the CPU busy.
+ * 
+ * @param session     Shared memory client session.
+ * @param nanoseconds Spin time. @c 0 waits on the descriptor right away.
+ * 
+ * @return            @c true , if spin time was set.
+ * @return            @c false , if session is not of type SHM or error occured.
+ */
+int jcon_client_shm_setSpinTime(jcon_client_t *session, long nanoseconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_CLIENT_SHM_H */
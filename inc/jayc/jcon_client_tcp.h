@@ -36,6 +36,37 @@ extern "C" {
  */
 jcon_client_t *jcon_client_tcp_session_init(char *address, uint16_t port, jlog_t *logger);
 
+/**
+ * @brief Initialize client with socket options.
+ * 
+ * Options are kept for reconnects.
+ * 
+ * @param address IP address or DNS name of target server.
+ * @param port    Port, to which to connect.
+ * @param options Options for socket. @c NULL uses defaults.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_client session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_client_t *jcon_client_tcp_options_init(char *address, uint16_t port, const jcon_socketTCP_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Initialize client, that recieves and sends
+ *        through io_uring.
+ * 
+ * Uses jcon_socketUring. Connect timeouts and background
+ * reconnects are not supported by this socket.
+ * 
+ * @param address IP address or DNS name of target server.
+ * @param port    Port, to which to connect.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_client session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_client_t *jcon_client_tcp_uring_init(char *address, uint16_t port, jlog_t *logger);
+
 /**
  * @brief Initialize client from existing jcon_tcp client session.
  * 
@@ -51,6 +82,50 @@ jcon_client_t *jcon_client_tcp_session_init(char *address, uint16_t port, jlog_t
  */
 jcon_client_t *jcon_client_tcp_session_tcpClone(jcon_socket_t *tcp_session, jlog_t *logger);
 
+/**
+ * @brief Sets timeout for connecting to server.
+ * 
+ * Used by @c #jcon_client_reset() and background reconnects.
+ * 
+ * @param session TCP client to configure.
+ * @param timeout Timeout in milliseconds.
+ *                @c -1 blocks until the kernel gives up (default).
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if session is not TCP or error occured.
+ */
+int jcon_client_tcp_setConnectTimeout(jcon_client_t *session, int timeout);
+
+/**
+ * @brief Enables background reconnects with exponential backoff.
+ * 
+ * A thread reconnects the client, whenever it is disconnected.
+ * The first attempt is made immediately, then the wait between
+ * attempts doubles from backoff_min up to backoff_max.
+ * 
+ * While disconnected, sending and recieving return immediately
+ * without data, so callers do not block on an unreachable server.
+ * @c #jcon_client_close() pauses reconnects until the next
+ * @c #jcon_client_reset() .
+ * 
+ * Attempts connect without holding the client state lock, so
+ * @c #jcon_client_close() and @c #jcon_client_reset() do not
+ * wait for them. A connect timeout should still be set
+ * ( @c #jcon_client_tcp_setConnectTimeout() ), otherwise
+ * freeing the client can wait for a pending attempt.
+ * 
+ * Not available for cloned sessions and io_uring clients.
+ * 
+ * @param session     TCP client to configure.
+ * @param backoff_min Minimum wait between attempts in milliseconds.
+ *                    @c 0 disables reconnects.
+ * @param backoff_max Maximum wait between attempts in milliseconds.
+ * 
+ * @return            @c true , if policy was set.
+ * @return            @c false , if error occured.
+ */
+int jcon_client_tcp_setReconnect(jcon_client_t *session, long backoff_min, long backoff_max);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,142 @@
+/**
+ * @file jcon_client_tls.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief TLS connector over TCP, implemented using jcon_client
+ *        and OpenSSL.
+ * 
+ * Handshakes are done by @c #jcon_client_reset() for clients
+ * and at accept for server connections.
+ * Clients keep the session (or ticket) of their last connection
+ * and offer it at reconnects, so the full handshake is skipped,
+ * if the server still accepts it.
+ * 
+ * When the kernel supports TLS offload (kTLS), records are
+ * encrypted by the kernel after the handshake and
+ * @c #jcon_client_sendFile() stays zero-copy. Otherwise
+ * file data is read and encrypted in user space.
+ * 
+ * OpenSSL buffers decrypted data. Handlers, that are called
+ * by an event loop, should read until @c #jcon_client_newData()
+ * returns @c false , because buffered data does not
+ * wake up the loop again.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jcon_client.h
+ */
+
+#ifndef INCLUDE_JCON_CLIENT_TLS_H
+#define INCLUDE_JCON_CLIENT_TLS_H
+
+#include <jayc/jcon_client.h>
+#include <jayc/jcon_socketTCP.h>
+#include <jayc/jlog.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief OpenSSL context. Declared here, so the header
+ *        does not depend on OpenSSL headers.
+ */
+struct ssl_ctx_st;
+
+/**
+ * @brief Options for TLS clients and servers.
+ * 
+ * Members set to @c 0 or @c NULL keep the defaults,
+ * so a zeroed struct verifies the peer with the
+ * certificates of the system and enables kTLS and tickets.
+ */
+typedef struct __jcon_client_tls_options
+{
+  const char *ca_file;      /**< CA certificates (PEM) to verify peer. Client: @c NULL uses system defaults.
+                                 Server: if set, clients have to show a certificate. */
+  const char *cert_file;    /**< Certificate chain (PEM). Required for servers, optional for clients. */
+  const char *key_file;     /**< Private key (PEM) of @c cert_file . */
+  const char *server_name;  /**< Client: name for SNI and certificate check. @c NULL uses address. */
+  int skip_verify;          /**< Client: does not verify server certificate. Only for testing. */
+  int disable_ktls;         /**< Does not enable kernel TLS offload. */
+  int disable_tickets;      /**< Server: does not issue session tickets. Sessions are still cached. */
+  int handshake_timeout;    /**< Time for handshake in milliseconds. @c 0 uses default, @c -1 waits forever. */
+  jcon_socketTCP_options_t tcp; /**< Options for TCP socket. */
+} jcon_client_tls_options_t;
+
+/**
+ * @brief Initialize client with IP and port.
+ * 
+ * Verifies the server with the certificates of the system.
+ * 
+ * @param address IP address or DNS name of target server.
+ * @param port    Port, to which to connect.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_client session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_client_t *jcon_client_tls_session_init(char *address, uint16_t port, jlog_t *logger);
+
+/**
+ * @brief Initialize client with TLS options.
+ * 
+ * Options are kept for reconnects. Files are loaded
+ * at initialization.
+ * 
+ * @param address IP address or DNS name of target server.
+ * @param port    Port, to which to connect.
+ * @param options Options for TLS and socket. @c NULL uses defaults.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_client session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_client_t *jcon_client_tls_options_init(char *address, uint16_t port, const jcon_client_tls_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Initialize client from accepted TCP connection.
+ * 
+ * Used by jcon_server_tls. Does the server side
+ * handshake, before the session is returned.
+ * 
+ * @param tcp_session       Accepted connection. Freed with the session.
+ *                          If @c NULL is returned, caller still owns it.
+ * @param ssl_ctx           OpenSSL context ( @c SSL_CTX ) of server.
+ * @param handshake_timeout Time for handshake in milliseconds. @c -1 waits forever.
+ * @param logger            Logger to use.
+ * 
+ * @return                  jcon_client session for new connection.
+ * @return                  @c NULL , if error occured.
+ */
+jcon_client_t *jcon_client_tls_session_tlsClone(jcon_socket_t *tcp_session, struct ssl_ctx_st *ssl_ctx, int handshake_timeout, jlog_t *logger);
+
+/**
+ * @brief Checks, if the last handshake resumed a session.
+ * 
+ * @param session TLS client to check.
+ * 
+ * @return        @c true , if session was resumed.
+ * @return        @c false , if full handshake was done,
+ *                client is not connected or error occured.
+ */
+int jcon_client_tls_isResumed(jcon_client_t *session);
+
+/**
+ * @brief Checks, if records are sent by the kernel (kTLS).
+ * 
+ * @param session TLS client to check.
+ * 
+ * @return        @c true , if kernel sends records.
+ * @return        @c false , if records are sent by OpenSSL,
+ *                client is not connected or error occured.
+ */
+int jcon_client_tls_isKernelOffloaded(jcon_client_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_CLIENT_TLS_H */
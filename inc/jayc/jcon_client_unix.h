@@ -17,6 +17,8 @@
 #include <jayc/jcon_client.h>
 #include <jayc/jcon_socketUnix.h>
 #include <jayc/jlog.h>
+#include <stddef.h>
+#include <sys/types.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,6 +52,60 @@ jcon_client_t *jcon_client_unix_session_init(char *filepath, jlog_t *logger);
  */
 jcon_client_t *jcon_client_unix_session_unixClone(jcon_socket_t *unix_session, jlog_t *logger);
 
+/**
+ * @brief Sends data together with descriptors.
+ * 
+ * Local services can pass large payloads as f.ex.
+ * @c memfd_create() descriptors instead of copying them.
+ * See @c #jcon_socketUnix_sendFds() .
+ * 
+ * @param session   Connected UNIX client session.
+ * @param data_ptr  Data to send, at least one byte.
+ * @param data_size Size of data.
+ * @param fds       Descriptors to pass. Stay open.
+ * @param count     Number of descriptors
+ *                  (at most @c #JCON_SOCKETUNIX_FDS_MAX ).
+ * 
+ * @return          Number of bytes sent.
+ * @return          @c 0 , if session is not of type UNIX or error occured.
+ */
+size_t jcon_client_unix_sendFds(jcon_client_t *session, void *data_ptr, size_t data_size, const int fds[], size_t count);
+
+/**
+ * @brief Recieves data and passed descriptors.
+ * 
+ * See @c #jcon_socketUnix_recvFds() . Descriptors are owned
+ * by the caller.
+ * 
+ * @param session   Connected UNIX client session.
+ * @param data_ptr  Buffer for data.
+ * @param data_size Size of buffer.
+ * @param fds       Buffer for descriptors.
+ * @param max       Size of @c fds .
+ * @param count     Set to number of recieved descriptors.
+ * 
+ * @return          Number of bytes recieved.
+ * @return          @c 0 , if no data, session is not of type UNIX
+ *                  or error occured.
+ */
+size_t jcon_client_unix_recvFds(jcon_client_t *session, void *data_ptr, size_t data_size, int fds[], size_t max, size_t *count);
+
+/**
+ * @brief Returns credentials of peer process.
+ * 
+ * Taken by the kernel at @c connect() ( @c SO_PEERCRED ),
+ * so servers can authorize clients without a handshake.
+ * 
+ * @param session Connected UNIX client session.
+ * @param pid     Set to process id of peer, if not @c NULL .
+ * @param uid     Set to user id of peer, if not @c NULL .
+ * @param gid     Set to group id of peer, if not @c NULL .
+ * 
+ * @return        @c true , if credentials were read.
+ * @return        @c false , if session is not of type UNIX or error occured.
+ */
+int jcon_client_unix_getPeerCredentials(jcon_client_t *session, pid_t *pid, uid_t *uid, gid_t *gid);
+
 #ifdef __cplusplus
 }
 #endif
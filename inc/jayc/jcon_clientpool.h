@@ -0,0 +1,353 @@
+/**
+ * @file jcon_clientpool.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Pool of connections to upstream servers.
+ * 
+ * Services, that call other services, lease a connected
+ * client of an endpoint, use it and return it, instead of
+ * connecting per request or sharing one client under a lock.
+ * 
+ * @code
+ * jcon_clientpool_t *pool = jcon_clientpool_init(NULL, NULL);
+ * int backend = jcon_clientpool_addTcpEndpoint(pool, "10.0.0.2", 8080);
+ * 
+ * jcon_clientpool_lease_t *lease = jcon_clientpool_lease(pool, backend);
+ * jcon_client_t *client = jcon_clientpool_getClient(lease);
+ * int ok = (jcon_client_sendData(client, request, size) == size);
+ * jcon_clientpool_release(lease, ok);
+ * @endcode
+ * 
+ * Every thread has a shard with a few idle connections per
+ * endpoint. Lease and release in the same thread take no lock.
+ * Other idle connections are kept in a list per endpoint,
+ * that a background thread probes. It reconnects broken
+ * connections, closes connections idle for too long and
+ * opens connections, until the minimum is idle.
+ * Connections in shards are probed, when they are leased
+ * after the probe interval.
+ * 
+ * Endpoints can be grouped, f.ex. all addresses of a DNS name.
+ * @c #jcon_clientpool_leaseGroup() chooses an endpoint by
+ * power of two choices or least outstanding requests and
+ * fails over to other endpoints, if connecting fails.
+ * Endpoints with repeated failures are ejected for some time.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_CLIENTPOOL_H
+#define INCLUDE_JCON_CLIENTPOOL_H
+
+#include <jayc/jcon_client.h>
+#include <jayc/jlog.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of endpoints in pool.
+ */
+#define JCON_CLIENTPOOL_ENDPOINT_MAX 32
+
+/**
+ * @brief Maximum number of groups in pool.
+ */
+#define JCON_CLIENTPOOL_GROUP_MAX 8
+
+/**
+ * @brief Chooses better of two random endpoints (default).
+ */
+#define JCON_CLIENTPOOL_BALANCE_P2C 0
+
+/**
+ * @brief Chooses endpoint with least outstanding leases.
+ */
+#define JCON_CLIENTPOOL_BALANCE_LEAST 1
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+typedef struct __jcon_clientpool_session jcon_clientpool_t;
+
+/**
+ * @brief Leased connection.
+ */
+typedef struct __jcon_clientpool_lease jcon_clientpool_lease_t;
+
+/**
+ * @brief Creates connected client for endpoint.
+ * 
+ * Called by leasing threads and the probe thread.
+ * 
+ * @param ctx Context pointer given with endpoint.
+ * 
+ * @return    Connected client.
+ * @return    @c NULL , if connection failed.
+ */
+typedef jcon_client_t *(*jcon_clientpool_connect_t)(void *ctx);
+
+/**
+ * @brief Checks idle connection (f.ex. by sending a ping).
+ * 
+ * Called after the pool checked, that the peer did not
+ * close the connection.
+ * 
+ * @param ctx     Context pointer given with options.
+ * @param client  Idle client to check.
+ * 
+ * @return        @c true , if connection is healthy.
+ * @return        @c false , if connection has to be reconnected.
+ */
+typedef int(*jcon_clientpool_probe_t)(void *ctx, jcon_client_t *client);
+
+/**
+ * @brief Limits and timing of pool.
+ * 
+ * Members set to @c 0 use the defaults, so a zeroed
+ * struct behaves like passing @c NULL .
+ */
+typedef struct __jcon_clientpool_options
+{
+  size_t min_idle;                /**< Idle connections opened ahead per endpoint (default @c 0 ). */
+  size_t max_idle;                /**< Idle connections kept in shared list per endpoint (default @c 8 ). */
+  size_t max_total;               /**< Connections per endpoint, leased or idle (default unlimited). */
+  size_t shard_idle;              /**< Idle connections kept per thread and endpoint (default @c 2 ). */
+  long probe_interval;            /**< Time between probes in milliseconds (default @c 1000 ). */
+  long idle_timeout;              /**< Time in milliseconds, after which idle connections
+                                       above @c min_idle are closed (default never). */
+  jcon_clientpool_probe_t probe;  /**< Additional check of idle connections. Can be @c NULL . */
+  void *probe_ctx;                /**< Context pointer passed to @c probe . */
+  int balance;                    /**< @c #JCON_CLIENTPOOL_BALANCE_P2C or @c #JCON_CLIENTPOOL_BALANCE_LEAST . */
+  size_t eject_failures;          /**< Failures in a row, after which endpoint is ejected (default @c 5 ). */
+  long eject_time;                /**< Time in milliseconds, endpoint stays ejected (default @c 10000 ). */
+  long resolve_interval;          /**< Time between DNS resolutions of groups in milliseconds (default @c 30000 ). */
+} jcon_clientpool_options_t;
+
+/**
+ * @brief Creates pool and starts probe thread.
+ * 
+ * @param options Limits of pool. Copied into session.
+ *                @c NULL for defaults.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_clientpool_t *jcon_clientpool_init(const jcon_clientpool_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Stops probe thread, closes and frees all idle connections.
+ * 
+ * Threads must not use the pool anymore and all
+ * leases have to be released before.
+ * 
+ * @param session Session to free.
+ */
+void jcon_clientpool_free(jcon_clientpool_t *session);
+
+/**
+ * @brief Adds endpoint with connect function.
+ * 
+ * Thread safe, endpoints can be added while the
+ * pool is used.
+ * 
+ * @param session Pool to add to.
+ * @param name    Name to find endpoint with. Is copied.
+ * @param connect Function to create connected client.
+ * @param ctx     Context pointer passed to @c connect .
+ *                Has to stay valid, while pool exists.
+ * 
+ * @return        Index of endpoint.
+ * @return        @c -1 , if name exists, pool is full or error occured.
+ */
+int jcon_clientpool_addEndpoint(jcon_clientpool_t *session, const char *name, jcon_clientpool_connect_t connect, void *ctx);
+
+/**
+ * @brief Adds TCP server as endpoint.
+ * 
+ * Name of endpoint is @c "<address>:<port>" .
+ * 
+ * @param session Pool to add to.
+ * @param address IP address or DNS name of server.
+ * @param port    Port of server.
+ * 
+ * @return        Index of endpoint.
+ * @return        @c -1 , if name exists, pool is full or error occured.
+ */
+int jcon_clientpool_addTcpEndpoint(jcon_clientpool_t *session, const char *address, uint16_t port);
+
+/**
+ * @brief Adds Unix socket server as endpoint.
+ * 
+ * Name of endpoint is the path.
+ * 
+ * @param session Pool to add to.
+ * @param path    Path of socket file.
+ * 
+ * @return        Index of endpoint.
+ * @return        @c -1 , if name exists, pool is full or error occured.
+ */
+int jcon_clientpool_addUnixEndpoint(jcon_clientpool_t *session, const char *path);
+
+/**
+ * @brief Finds endpoint by name.
+ * 
+ * @param session Pool to search.
+ * @param name    Name of endpoint.
+ * 
+ * @return        Index of endpoint.
+ * @return        @c -1 , if not found.
+ */
+int jcon_clientpool_findEndpoint(jcon_clientpool_t *session, const char *name);
+
+/**
+ * @brief Adds group of endpoints.
+ * 
+ * @param session   Pool to add to.
+ * @param name      Name to find group with. Is copied.
+ * @param endpoints Indices of endpoints in group.
+ * @param count     Number of endpoints.
+ * 
+ * @return          Index of group.
+ * @return          @c -1 , if name exists, pool is full or error occured.
+ */
+int jcon_clientpool_addGroup(jcon_clientpool_t *session, const char *name, const int *endpoints, size_t count);
+
+/**
+ * @brief Adds group of all IPv4 addresses of DNS name.
+ * 
+ * Name of group is @c "<host>:<port>" . Addresses are added
+ * as TCP endpoints. The probe thread resolves the name again
+ * every @c resolve_interval and replaces the members of the
+ * group. Endpoints of removed addresses are not chosen anymore.
+ * 
+ * @param session Pool to add to.
+ * @param host    DNS name of servers.
+ * @param port    Port of servers.
+ * 
+ * @return        Index of group.
+ * @return        @c -1 , if name exists, pool is full or error occured.
+ */
+int jcon_clientpool_addDnsGroup(jcon_clientpool_t *session, const char *host, uint16_t port);
+
+/**
+ * @brief Finds group by name.
+ * 
+ * @param session Pool to search.
+ * @param name    Name of group.
+ * 
+ * @return        Index of group.
+ * @return        @c -1 , if not found.
+ */
+int jcon_clientpool_findGroup(jcon_clientpool_t *session, const char *name);
+
+/**
+ * @brief Leases connected client of an endpoint in group.
+ * 
+ * Chooses between endpoints, that are not ejected (between all
+ * endpoints, if all are ejected). If no client can be leased
+ * from the chosen endpoint, the other endpoints are tried.
+ * 
+ * @param session Pool to lease from.
+ * @param group   Index of group.
+ * 
+ * @return        Lease of client.
+ * @return        @c NULL , if no endpoint could be leased from
+ *                or error occured.
+ */
+jcon_clientpool_lease_t *jcon_clientpool_leaseGroup(jcon_clientpool_t *session, int group);
+
+/**
+ * @brief Leases connected client of endpoint.
+ * 
+ * Takes idle connection of thread, then of shared list.
+ * Connects new client, if none is idle.
+ * 
+ * @param session   Pool to lease from.
+ * @param endpoint  Index of endpoint.
+ * 
+ * @return          Lease of client.
+ * @return          @c NULL , if @c max_total connections exist,
+ *                  connection failed or error occured.
+ */
+jcon_clientpool_lease_t *jcon_clientpool_lease(jcon_clientpool_t *session, int endpoint);
+
+/**
+ * @brief Returns client of lease.
+ * 
+ * Client must not be freed or kept after release.
+ * 
+ * @param lease Lease object.
+ * 
+ * @return      Client of lease.
+ */
+jcon_client_t *jcon_clientpool_getClient(jcon_clientpool_lease_t *lease);
+
+/**
+ * @brief Returns index of endpoint of lease.
+ * 
+ * @param lease Lease object.
+ * 
+ * @return      Index of endpoint.
+ * @return      @c -1 , if lease is @c NULL .
+ */
+int jcon_clientpool_getEndpoint(jcon_clientpool_lease_t *lease);
+
+/**
+ * @brief Returns leased client to pool.
+ * 
+ * Can be called from any thread. The client is kept in
+ * the shard of the calling thread, if it has space.
+ * 
+ * Releasing without reuse counts as failure of the endpoint,
+ * releasing with reuse clears the failures.
+ * 
+ * @param lease Lease to release.
+ * @param reuse @c false , if request failed or timed out or client
+ *              is in unknown state (f.ex. a reply was not read
+ *              completely). Client is closed.
+ */
+void jcon_clientpool_release(jcon_clientpool_lease_t *lease, int reuse);
+
+/**
+ * @brief Returns number of connections of endpoint.
+ * 
+ * @param session   Pool to check.
+ * @param endpoint  Index of endpoint.
+ * 
+ * @return          Number of leased and idle connections.
+ */
+size_t jcon_clientpool_getConnections(jcon_clientpool_t *session, int endpoint);
+
+/**
+ * @brief Returns number of leased connections of endpoint.
+ * 
+ * @param session   Pool to check.
+ * @param endpoint  Index of endpoint.
+ * 
+ * @return          Number of outstanding leases.
+ */
+size_t jcon_clientpool_getOutstanding(jcon_clientpool_t *session, int endpoint);
+
+/**
+ * @brief Checks, if endpoint is ejected after failures.
+ * 
+ * @param session   Pool to check.
+ * @param endpoint  Index of endpoint.
+ * 
+ * @return          @c true , if endpoint is ejected.
+ * @return          @c false , if endpoint is chosen by groups.
+ */
+int jcon_clientpool_isEjected(jcon_clientpool_t *session, int endpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_CLIENTPOOL_H */
@@ -0,0 +1,175 @@
+/**
+ * @file jcon_configSync.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Replicates jconfig tables from a primary to replicas.
+ * 
+ * Instead of every node loading the same file, one primary
+ * serves its table and replicas subscribe to it. The primary
+ * publishes every new version of the table as delta (the keys,
+ * that changed since the previous version). Deltas are kept
+ * for a while, so replicas, that reconnect, only get the
+ * deltas since their last version. Replicas, that are new or
+ * too far behind, get the whole table once.
+ * 
+ * @code
+ * // Primary.
+ * jcon_server_t *server = jcon_server_tcp_session_init("0.0.0.0", 7000, logger);
+ * jcon_configSync_t *primary = jcon_configSync_primary_init(server, config, NULL, logger);
+ * jconfig_raw_reloadFromFile(config, "app.conf");
+ * jcon_configSync_publish(primary);
+ * 
+ * // Replica.
+ * jcon_client_t *client = jcon_client_tcp_session_init("10.0.0.1", 7000, logger);
+ * jcon_configSync_t *replica = jcon_configSync_replica_init(client, config, NULL, logger);
+ * @endcode
+ * 
+ * The primary reads its table through snapshots (see
+ * jconfig_snapshot.h), so the table can be changed by
+ * the application while deltas are sent.
+ * 
+ * The table of a replica is changed by the thread of the
+ * session. Watchers of the table are called from there.
+ * Other threads read the table through snapshots, that
+ * have to be enabled before the session is created.
+ * 
+ * Messages are frames with a 4 byte length prefix
+ * (see jcon_frame.h). Every message starts with its
+ * type and the epoch of the primary, a random number,
+ * that changes, when the primary restarts.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jconfig_snapshot.h
+ * 
+ */
+
+#ifndef INCLUDE_JCON_CONFIGSYNC_H
+#define INCLUDE_JCON_CONFIGSYNC_H
+
+#include <jayc/jcon_server.h>
+#include <jayc/jcon_client.h>
+#include <jayc/jconfig.h>
+#include <jayc/jlog.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+typedef struct __jcon_configSync_session jcon_configSync_t;
+
+/**
+ * @brief Settings of primary and replicas.
+ * 
+ * Members set to @c 0 use the defaults, so a zeroed
+ * struct behaves like passing @c NULL .
+ */
+typedef struct __jcon_configSync_options
+{
+  size_t history;           /**< Deltas kept by primary for reconnecting replicas (default @c 256 ). */
+  long publish_interval;    /**< Time in milliseconds between checks of primary for
+                                 new versions (default @c 1000 ). */
+  size_t frame_max;         /**< Maximum size of a message in bytes (default 64 MiB). */
+  long reconnect_min;       /**< First wait of replica between connection attempts
+                                 in milliseconds (default @c 100 ). */
+  long reconnect_max;       /**< Maximum wait of replica between connection attempts
+                                 in milliseconds (default @c 10000 ). */
+} jcon_configSync_options_t;
+
+/**
+ * @brief Starts primary, that serves table.
+ * 
+ * Enables snapshots of the table, so it has to be called
+ * by the thread, that changes the table. Connections are
+ * handled by an event loop (see @c #jcon_system_eventLoop_init() ),
+ * a thread publishes new versions every @c publish_interval .
+ * 
+ * Replicas are told apart by the reference strings of their
+ * connections, so the server has to provide unique ones (TCP).
+ * 
+ * @param server  Server to accept replicas on. Is not freed with session.
+ * @param table   Config table to serve.
+ * @param options Settings of session. Copied into session.
+ *                @c NULL for defaults.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_configSync_t *jcon_configSync_primary_init(jcon_server_t *server, jconfig_t *table, const jcon_configSync_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Starts replica, that follows primary.
+ * 
+ * A thread connects the client, subscribes with the last
+ * version of the session and applies the messages of
+ * the primary to the table. Lost connections are reset
+ * with exponential backoff.
+ * 
+ * @param client  Client to connect to primary. Is not freed with session.
+ * @param table   Config table to write to.
+ * @param options Settings of session. Copied into session.
+ *                @c NULL for defaults.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_configSync_t *jcon_configSync_replica_init(jcon_client_t *client, jconfig_t *table, const jcon_configSync_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Stops threads and frees memory.
+ * 
+ * Server or client and table are not freed.
+ * 
+ * @param session Session to free.
+ */
+void jcon_configSync_free(jcon_configSync_t *session);
+
+/**
+ * @brief Publishes latest version of table to replicas.
+ * 
+ * Only for primaries. Sends the delta like the thread of
+ * the session does, but without waiting for the next check.
+ * Can be called from any thread.
+ * 
+ * @param session Primary session.
+ * 
+ * @return        Number of changed keys.
+ * @return        @c 0 , if table did not change or error occured.
+ */
+size_t jcon_configSync_publish(jcon_configSync_t *session);
+
+/**
+ * @brief Returns version of table, the session is at.
+ * 
+ * Primaries return the last published version, replicas
+ * the last version recieved from the primary.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Version number.
+ * @return        @c 0 , if replica did not recieve the table yet.
+ */
+uint64_t jcon_configSync_getVersion(jcon_configSync_t *session);
+
+/**
+ * @brief Returns number of subscribed replicas.
+ * 
+ * @param session Primary session.
+ * 
+ * @return        Number of replicas.
+ */
+size_t jcon_configSync_getReplicas(jcon_configSync_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_CONFIGSYNC_H */
@@ -0,0 +1,192 @@
+/**
+ * @file jcon_eventLoop.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Event loop for multiplexing file descriptors.
+ * 
+ * Wraps @c epoll() . Descriptors get registered with a
+ * @c #jcon_eventLoop_watcher_t , which is owned by the caller
+ * and holds the handler to call, when the descriptor
+ * becomes ready.
+ * 
+ * Watchers can be added and modified from any thread.
+ * Removing and dispatching has to be done by the thread,
+ * that runs @c #jcon_eventLoop_run() .
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_EVENTLOOP_H
+#define INCLUDE_JCON_EVENTLOOP_H
+
+#include <jayc/jlog.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Descriptor is readable.
+ */
+#define JCON_EVENTLOOP_EVENT_READ 0x01
+
+/**
+ * @brief Descriptor is writable.
+ */
+#define JCON_EVENTLOOP_EVENT_WRITE 0x02
+
+/**
+ * @brief Peer closed the connection.
+ * 
+ * Always reported, does not need to be requested.
+ */
+#define JCON_EVENTLOOP_EVENT_HANGUP 0x04
+
+/**
+ * @brief Error occured on descriptor.
+ * 
+ * Always reported, does not need to be requested.
+ */
+#define JCON_EVENTLOOP_EVENT_ERROR 0x08
+
+/**
+ * @brief Only one of the event loops, that registered
+ *        the descriptor, gets woken up.
+ * 
+ * Used for listening sockets shared by multiple loops.
+ * Can not be changed with @c #jcon_eventLoop_modify() .
+ */
+#define JCON_EVENTLOOP_EVENT_EXCLUSIVE 0x10
+
+/**
+ * @brief Watcher gets disabled after one event.
+ * 
+ * Has to be rearmed with @c #jcon_eventLoop_modify() .
+ * Allows handing descriptors to other threads, without
+ * the loop reporting them again in the meantime.
+ */
+#define JCON_EVENTLOOP_EVENT_ONESHOT 0x20
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+typedef struct __jcon_eventLoop_session jcon_eventLoop_t;
+
+/**
+ * @brief Registration of a descriptor.
+ */
+typedef struct __jcon_eventLoop_watcher jcon_eventLoop_watcher_t;
+
+/**
+ * @brief Function gets called, when descriptor is ready.
+ * 
+ * @param loop    Event loop, that dispatches the event.
+ * @param watcher Watcher of descriptor.
+ * @param events  Flags of ready events
+ *                ( @c #JCON_EVENTLOOP_EVENT_READ , ... ).
+ */
+typedef void(*jcon_eventLoop_handler_t)(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events);
+
+/**
+ * @brief Registration of a descriptor.
+ * 
+ * Memory is owned by the caller and has to stay valid,
+ * until the watcher is removed from the loop.
+ * Usually embedded in a connection structure.
+ */
+struct __jcon_eventLoop_watcher
+{
+  int file_descriptor;              /**< Descriptor to watch. */
+  int events;                       /**< Requested events. */
+  jcon_eventLoop_handler_t handler; /**< Handler to call, when descriptor is ready. */
+  void *ctx;                        /**< Context pointer for handler. */
+};
+
+/**
+ * @brief Creates event loop.
+ * 
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Event loop session.
+ * @return        @c NULL , if error occured.
+ */
+jcon_eventLoop_t *jcon_eventLoop_init(jlog_t *logger);
+
+/**
+ * @brief Closes event loop and frees memory.
+ * 
+ * Registered watchers are not freed.
+ * 
+ * @param session Session to free.
+ */
+void jcon_eventLoop_free(jcon_eventLoop_t *session);
+
+/**
+ * @brief Registers descriptor with event loop.
+ * 
+ * @param session Event loop to add to.
+ * @param watcher Initialized watcher for descriptor.
+ * 
+ * @return        @c true , if watcher was added.
+ * @return        @c false , if error occured.
+ */
+int jcon_eventLoop_add(jcon_eventLoop_t *session, jcon_eventLoop_watcher_t *watcher);
+
+/**
+ * @brief Changes requested events of watcher.
+ * 
+ * @param session Event loop of watcher.
+ * @param watcher Watcher to modify.
+ * @param events  New events to watch for.
+ * 
+ * @return        @c true , if watcher was modified.
+ * @return        @c false , if error occured.
+ */
+int jcon_eventLoop_modify(jcon_eventLoop_t *session, jcon_eventLoop_watcher_t *watcher, int events);
+
+/**
+ * @brief Removes watcher from event loop.
+ * 
+ * Pending events of the watcher, that have not been
+ * dispatched yet, are discarded. After this call the
+ * watcher memory can be freed.
+ * 
+ * Should be called, before the descriptor is closed.
+ * If the descriptor was already closed, set
+ * @c jcon_eventLoop_watcher_t#file_descriptor to @c -1
+ * before calling. Then only the pending events are discarded,
+ * so a reused descriptor number is not removed by accident.
+ * 
+ * @param session Event loop of watcher.
+ * @param watcher Watcher to remove.
+ */
+void jcon_eventLoop_remove(jcon_eventLoop_t *session, jcon_eventLoop_watcher_t *watcher);
+
+/**
+ * @brief Waits for events and dispatches them.
+ * 
+ * @param session Event loop to run.
+ * @param timeout Maximum time to wait in milliseconds.
+ *                @c -1 waits until events arrive.
+ * 
+ * @return        Number of events dispatched.
+ * @return        @c -1 , if error occured.
+ */
+int jcon_eventLoop_run(jcon_eventLoop_t *session, int timeout);
+
+/**
+ * @brief Wakes up loop, that is waiting in @c #jcon_eventLoop_run() .
+ * 
+ * Can be called from any thread.
+ * 
+ * @param session Event loop to wake up.
+ */
+void jcon_eventLoop_wakeup(jcon_eventLoop_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_EVENTLOOP_H */
@@ -0,0 +1,302 @@
+/**
+ * @file jcon_frame.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Message framing on top of jcon_client.
+ * 
+ * A jcon_frame session reads data of a client into its own
+ * receive buffer and splits it into frames. Frames are either
+ * prefixed by their length (in network byte order) or
+ * terminated by a delimiter.
+ * 
+ * For every complete frame a @c #jcon_frame_handler_t gets
+ * called with a view into the receive buffer, so the data
+ * is not copied into user buffers. Incomplete frames stay
+ * in the buffer until the rest arrives. The buffer grows
+ * up to the maximum frame size.
+ * 
+ * The receive buffer is a @c #jutil_buffer_t . With
+ * @c #jcon_frame_setBufferHandler() frames are passed as
+ * slices of it, that can be kept or passed on (f.ex. to
+ * @c #jcon_system_broadcastBuffer() ) without copy.
+ * 
+ * One session is needed per connection. It does not take
+ * ownership of the client.
+ * 
+ * Length prefixed frames can be compressed
+ * (see @c #jcon_frame_setCompression() ). Both peers enable
+ * it after connecting and offer their codecs, each side then
+ * compresses with a codec, that both support. Frames below a
+ * threshold or frames, that do not get smaller, are sent as
+ * they are. Compression contexts and buffers are kept in the
+ * session, so frames are compressed without allocations.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_FRAME_H
+#define INCLUDE_JCON_FRAME_H
+
+#include <jayc/jcon_client.h>
+#include <jayc/jlog.h>
+#include <jayc/jutil_arena.h>
+#include <jayc/jutil_buffer.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Frames are sent uncompressed.
+ */
+#define JCON_FRAME_COMPRESS_NONE 0
+
+/**
+ * @brief Frames are compressed in the LZ4 block format (see jutil_lz4.h ).
+ */
+#define JCON_FRAME_COMPRESS_LZ4 1
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+typedef struct __jcon_frame_session jcon_frame_t;
+
+/**
+ * @brief Settings of compression.
+ * 
+ * Members set to @c 0 use the defaults.
+ */
+typedef struct __jcon_frame_compression
+{
+  unsigned int codecs;  /**< Codecs offered to peer as bit mask ( @c 1 << JCON_FRAME_COMPRESS_* ).
+                             Default are all supported codecs. */
+  size_t threshold;     /**< Frames with less bytes are sent uncompressed (default @c 256 ). */
+} jcon_frame_compression_t;
+
+/**
+ * @brief Gets called for every complete frame.
+ * 
+ * The frame data is only valid until the handler returns.
+ * 
+ * @param ctx         Context pointer provided at initialization.
+ * @param client      Client, the frame was recieved from.
+ * @param frame_ptr   Frame data, without prefix or delimiter.
+ * @param frame_size  Size of frame in bytes.
+ */
+typedef void(*jcon_frame_handler_t)(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size);
+
+/**
+ * @brief Gets called for every complete frame with slice
+ *        of the receive buffer.
+ * 
+ * The slice is released after the handler returns.
+ * To keep it, the handler takes a reference with
+ * @c #jutil_buffer_ref() .
+ * 
+ * @param ctx     Context pointer provided at initialization.
+ * @param client  Client, the frame was recieved from.
+ * @param frame   Frame data, without prefix or delimiter.
+ */
+typedef void(*jcon_frame_bufferHandler_t)(void *ctx, jcon_client_t *client, jutil_buffer_t *frame);
+
+/**
+ * @brief Creates session for length prefixed frames.
+ * 
+ * The prefix holds the size of the frame data (without prefix)
+ * as unsigned integer in network byte order.
+ * 
+ * @param client      Client to read frames from.
+ * @param prefix_size Size of length prefix in bytes ( @c 1 , @c 2 or @c 4 ).
+ * @param frame_max   Maximum size of frame data in bytes.
+ * @param handler     Handler to call for every frame.
+ * @param logger      Logger for debug and error messages.
+ * @param ctx         Context pointer passed to handler.
+ * 
+ * @return            Session object.
+ * @return            @c NULL , if error occured.
+ */
+jcon_frame_t *jcon_frame_lengthPrefix_init(jcon_client_t *client, size_t prefix_size, size_t frame_max, jcon_frame_handler_t handler, jlog_t *logger, void *ctx);
+
+/**
+ * @brief Creates session for delimiter terminated frames.
+ * 
+ * @param client          Client to read frames from.
+ * @param delimiter       Delimiter bytes (for example @c "\r\n" ).
+ * @param delimiter_size  Size of delimiter in bytes.
+ * @param frame_max       Maximum size of frame data in bytes.
+ * @param handler         Handler to call for every frame.
+ * @param logger          Logger for debug and error messages.
+ * @param ctx             Context pointer passed to handler.
+ * 
+ * @return                Session object.
+ * @return                @c NULL , if error occured.
+ */
+jcon_frame_t *jcon_frame_delimiter_init(jcon_client_t *client, const void *delimiter, size_t delimiter_size, size_t frame_max, jcon_frame_handler_t handler, jlog_t *logger, void *ctx);
+
+/**
+ * @brief Frees session memory.
+ * 
+ * Client is not freed.
+ * 
+ * @param session Session to free.
+ */
+void jcon_frame_free(jcon_frame_t *session);
+
+/**
+ * @brief Reads available data and handles complete frames.
+ * 
+ * Reads once from the client, so it should be called,
+ * when new data is available (for example from a
+ * @c #jcon_thread_data_handler_t ).
+ * 
+ * If a frame exceeds the maximum size, the buffered data
+ * is discarded and the client gets closed, because the
+ * frame boundaries are lost.
+ * 
+ * @param session Session to process.
+ * 
+ * @return        Number of frames handled.
+ * @return        @c -1 , if error occured.
+ */
+int jcon_frame_process(jcon_frame_t *session);
+
+/**
+ * @brief Sends data as one frame.
+ * 
+ * Adds length prefix or delimiter and sends
+ * everything with one system call.
+ * 
+ * @param session     Session to send through.
+ * @param frame_ptr   Frame data to send.
+ * @param frame_size  Size of frame data in bytes.
+ * 
+ * @return            @c true , if frame was sent completely.
+ * @return            @c false , if error occured.
+ */
+int jcon_frame_send(jcon_frame_t *session, const void *frame_ptr, size_t frame_size);
+
+/**
+ * @brief Sends data of multiple buffers as one frame.
+ * 
+ * Works like @c #jcon_frame_send() , f.ex. to send a
+ * header and a body without copying them together.
+ * 
+ * @param session   Session to send through.
+ * @param iov       Array of buffers, that form the frame data.
+ * @param iov_count Number of buffers in iov (at most @c 64 ).
+ * 
+ * @return          @c true , if frame was sent completely.
+ * @return          @c false , if error occured.
+ */
+int jcon_frame_sendV(jcon_frame_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends buffer as one frame.
+ * 
+ * Segments of the buffer are sent without copy
+ * together with prefix or delimiter.
+ * 
+ * @param session Session to send through.
+ * @param frame   Frame data to send.
+ * 
+ * @return        @c true , if frame was sent completely.
+ * @return        @c false , if error occured.
+ */
+int jcon_frame_sendBuffer(jcon_frame_t *session, jutil_buffer_t *frame);
+
+/**
+ * @brief Sets handler, that gets frames as slices.
+ * 
+ * Is called instead of the handler given at
+ * initialization.
+ * 
+ * @param session Session to configure.
+ * @param handler Handler to call. @c NULL calls handler
+ *                of initialization again.
+ */
+void jcon_frame_setBufferHandler(jcon_frame_t *session, jcon_frame_bufferHandler_t handler);
+
+/**
+ * @brief Sets arena, that is reset after every frame.
+ * 
+ * Handlers can allocate everything, that is only needed
+ * for one frame, from the arena (f.ex. passed in the
+ * context pointer). One arena can be shared by all
+ * sessions of a thread. The arena is not freed with
+ * the session.
+ * 
+ * @param session Session to configure.
+ * @param arena   Arena to reset. @c NULL disables resets.
+ */
+void jcon_frame_setArena(jcon_frame_t *session, jutil_arena_t *arena);
+
+/**
+ * @brief Enables compression of frames.
+ * 
+ * Only for length prefixed frames. Sends the offered codecs
+ * to the peer, so it is called right after connecting, on
+ * both sides, before other frames are sent. Every frame
+ * then starts with a header, so peers without compression
+ * can not read them.
+ * 
+ * Frames are sent uncompressed, until the offer of the
+ * peer was handled by @c #jcon_frame_process() . The
+ * maximum frame size applies to uncompressed frames.
+ * 
+ * Compressed frames are decompressed into a buffer of the
+ * session. Buffer handlers get a copy of them.
+ * 
+ * @param session Session to configure.
+ * @param options Settings. @c NULL for defaults.
+ * 
+ * @return        @c true , if offer was sent.
+ * @return        @c false , if error occured.
+ */
+int jcon_frame_setCompression(jcon_frame_t *session, const jcon_frame_compression_t *options);
+
+/**
+ * @brief Returns codec, that is used to send frames.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        @c JCON_FRAME_COMPRESS_* constant.
+ * @return        @c #JCON_FRAME_COMPRESS_NONE , if compression is
+ *                not enabled or peer did not offer a common codec.
+ */
+int jcon_frame_getCompression(jcon_frame_t *session);
+
+/**
+ * @brief Releases buffers of session, while connection is idle.
+ * 
+ * Frees the receive buffer, compression context and buffers of
+ * compressed frames. They are allocated again with the next
+ * frame. Can be called from the idle handler of jcon_system
+ * (see @c #jcon_system_setIdleTimeout() ).
+ * 
+ * The receive buffer is kept, while it holds part of a frame.
+ * 
+ * @param session Session to trim.
+ * 
+ * @return        @c true , if all buffers were released.
+ * @return        @c false , if data is pending or error occured.
+ */
+int jcon_frame_trim(jcon_frame_t *session);
+
+/**
+ * @brief Returns number of buffered bytes, that do not
+ *        form a complete frame yet.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of pending bytes.
+ */
+size_t jcon_frame_getPending(jcon_frame_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_FRAME_H */
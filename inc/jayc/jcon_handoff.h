@@ -0,0 +1,169 @@
+/**
+ * @file jcon_handoff.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Passes listening sockets between processes.
+ * 
+ * Lets a new process take over the listeners of a running one,
+ * so restarts do not refuse connections. The kernel keeps
+ * queueing connections on the socket, while both processes
+ * hold it, and the new process accepts them from the same backlog.
+ * 
+ * Descriptors are passed in two ways:
+ * - Over a connected Unix socket with @c SCM_RIGHTS
+ *   ( @c #jcon_handoff_sendServers() and @c #jcon_handoff_recv() ).
+ * - Inherited at @c exec() , with the environment of systemd
+ *   socket activation ( @c LISTEN_FDS , @c LISTEN_PID )
+ *   ( @c #jcon_handoff_exportInherited() and
+ *   @c #jcon_handoff_getInherited() ).
+ * 
+ * Received descriptors become servers with
+ * @c #jcon_handoff_adoptServer() :
+ * 
+ * @code
+ * int fds[JCON_HANDOFF_LISTENERS_MAX];
+ * int count = jcon_handoff_getInherited(fds, JCON_HANDOFF_LISTENERS_MAX);
+ * for(int i = 0; i < count; i++)
+ * {
+ *   jcon_server_t *server = jcon_handoff_adoptServer(fds[i], logger);
+ *   ...
+ * }
+ * @endcode
+ * 
+ * The old process stops accepting (f.ex. @c #jcon_system_stopAccepting() )
+ * after handing off. Closing its copy of the descriptors does not
+ * close the socket of the new process.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jcon_server_tcp.h
+ * @see jcon_server_unix.h
+ * 
+ */
+
+#ifndef INCLUDE_JCON_HANDOFF_H
+#define INCLUDE_JCON_HANDOFF_H
+
+#include <jayc/jcon_server.h>
+#include <jayc/jlog.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of descriptors passed at once.
+ */
+#define JCON_HANDOFF_LISTENERS_MAX 64
+
+/**
+ * @brief First inherited descriptor (as @c SD_LISTEN_FDS_START of systemd).
+ */
+#define JCON_HANDOFF_LISTEN_FDS_START 3
+
+/**
+ * @brief Sends descriptors over Unix socket.
+ * 
+ * Descriptors stay open in the calling process.
+ * 
+ * @param channel Connected Unix stream socket to the other process.
+ * @param fds     Descriptors to send.
+ * @param count   Number of descriptors
+ *                (at most @c #JCON_HANDOFF_LISTENERS_MAX ).
+ * 
+ * @return        @c true , if descriptors were sent.
+ * @return        @c false , if error occured.
+ */
+int jcon_handoff_send(int channel, const int fds[], size_t count);
+
+/**
+ * @brief Sends listening sockets of servers over Unix socket.
+ * 
+ * Servers stay open and keep accepting, until they are closed.
+ * 
+ * @param channel Connected Unix stream socket to the other process.
+ * @param servers Open servers with descriptors
+ *                (see @c #jcon_server_getFileDescriptor() ).
+ * @param count   Number of servers.
+ * 
+ * @return        @c true , if descriptors were sent.
+ * @return        @c false , if a server has no descriptor or error occured.
+ */
+int jcon_handoff_sendServers(int channel, jcon_server_t *const servers[], size_t count);
+
+/**
+ * @brief Recieves descriptors from Unix socket.
+ * 
+ * Recieved descriptors are close-on-exec and owned by the caller.
+ * 
+ * @param channel Connected Unix stream socket to the other process.
+ * @param fds     Array for recieved descriptors.
+ * @param max     Size of @c fds .
+ * @param timeout Time to wait in milliseconds, @c -1 waits forever.
+ * 
+ * @return        Number of recieved descriptors.
+ * @return        @c -1 , if timed out, more than @c max descriptors
+ *                were sent or error occured.
+ */
+int jcon_handoff_recv(int channel, int fds[], size_t max, int timeout);
+
+/**
+ * @brief Returns descriptors inherited from parent process.
+ * 
+ * Reads @c LISTEN_FDS and @c LISTEN_PID (set by systemd or
+ * @c #jcon_handoff_exportInherited() ). Descriptors start
+ * at @c #JCON_HANDOFF_LISTEN_FDS_START and are set close-on-exec.
+ * The variables are removed from the environment,
+ * so child processes do not inherit them again.
+ * 
+ * @param fds Array for inherited descriptors.
+ * @param max Size of @c fds .
+ * 
+ * @return    Number of inherited descriptors.
+ * @return    @c 0 , if nothing was inherited by this process.
+ * @return    @c -1 , if variables are invalid or error occured.
+ */
+int jcon_handoff_getInherited(int fds[], size_t max);
+
+/**
+ * @brief Prepares descriptors to be inherited by @c exec() .
+ * 
+ * Has to be called in the child after @c fork() , right
+ * before @c exec() . Moves descriptors to
+ * @c #JCON_HANDOFF_LISTEN_FDS_START and following,
+ * clears close-on-exec and sets @c LISTEN_FDS and @c LISTEN_PID ,
+ * so the new program finds them with @c #jcon_handoff_getInherited() .
+ * Descriptors already at these numbers are replaced.
+ * 
+ * @param fds   Descriptors to pass.
+ * @param count Number of descriptors
+ *              (at most @c #JCON_HANDOFF_LISTENERS_MAX ).
+ * 
+ * @return      @c true , if descriptors are ready for @c exec() .
+ * @return      @c false , if error occured.
+ */
+int jcon_handoff_exportInherited(const int fds[], size_t count);
+
+/**
+ * @brief Creates server from recieved listening socket.
+ * 
+ * Uses @c #jcon_server_tcp_adopt_init() or
+ * @c #jcon_server_unix_adopt_init() , depending on the
+ * address family of the socket.
+ * 
+ * @param fd      Listening socket. Owned by the session afterwards,
+ *                closed if an error occured.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        Open server session.
+ * @return        @c NULL , if family is not supported or error occured.
+ */
+jcon_server_t *jcon_handoff_adoptServer(int fd, jlog_t *logger);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_HANDOFF_H */
@@ -0,0 +1,96 @@
+/**
+ * @file jcon_metrics.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Serves jutil_metrics over HTTP for Prometheus.
+ * 
+ * Opens a TCP server and answers every HTTP @c GET request with
+ * the text of @c #jutil_metrics_format() . Connections are handled
+ * one after another by a thread of the session, the connection
+ * is closed after the response (HTTP/1.0).
+ * 
+ * @code
+ * jcon_metrics_t *metrics = jcon_metrics_init("0.0.0.0", 9100, logger);
+ * ...
+ * jcon_metrics_free(metrics);
+ * @endcode
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jutil_metrics.h
+ * 
+ */
+
+#ifndef INCLUDE_JCON_METRICS_H
+#define INCLUDE_JCON_METRICS_H
+
+#include <jayc/jlog.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Session object of metrics endpoint.
+ */
+typedef struct __jcon_metrics_session jcon_metrics_t;
+
+/**
+ * @brief Handler, that formats the metrics to serve.
+ * 
+ * Called by the thread of the session for every request.
+ * 
+ * @param ctx     Context pointer of session.
+ * @param length  Set to length of text.
+ * 
+ * @return        Text in Prometheus format, freed with @c free() .
+ * @return        @c NULL , if error occured.
+ */
+typedef char *(*jcon_metrics_format_handler_t)(void *ctx, size_t *length);
+
+/**
+ * @brief Opens server and starts thread, that answers requests.
+ * 
+ * @param address Address to listen on.
+ * @param port    Port to listen on.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_metrics_t *jcon_metrics_init(char *address, uint16_t port, jlog_t *logger);
+
+/**
+ * @brief Opens server, that answers with text of handler.
+ * 
+ * Serves other metrics than the ones of this process,
+ * f.ex. metrics collected from worker processes
+ * (see @c #jcon_preFork_formatMetrics() ).
+ * 
+ * @param address Address to listen on.
+ * @param port    Port to listen on.
+ * @param handler Handler to format metrics.
+ *                @c NULL uses @c #jutil_metrics_format() .
+ * @param ctx     Context pointer passed to handler.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_metrics_t *jcon_metrics_handler_init(char *address, uint16_t port, jcon_metrics_format_handler_t handler, void *ctx, jlog_t *logger);
+
+/**
+ * @brief Stops thread, closes server and frees memory.
+ * 
+ * @param session Session to free.
+ */
+void jcon_metrics_free(jcon_metrics_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_METRICS_H */
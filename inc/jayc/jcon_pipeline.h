@@ -0,0 +1,257 @@
+/**
+ * @file jcon_pipeline.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Pipelined requests on top of jcon_frame.
+ * 
+ * A jcon_pipeline session sends requests without waiting
+ * for the reply of the previous one, so one connection is
+ * not limited to one request per round trip. Every request
+ * gets a correlation id, the server sends it back with the
+ * reply. Replies can arrive in any order and complete their
+ * request by calling its completion handler.
+ * 
+ * Requests and replies are length prefixed frames, that
+ * start with the correlation id ( @c #JCON_PIPELINE_ID_SIZE
+ * bytes, network byte order). Servers parse requests with
+ * @c #jcon_pipeline_parseRequest() and reply with
+ * @c #jcon_pipeline_reply() .
+ * 
+ * The number of requests in flight is bounded by a window.
+ * When the window is full, @c #jcon_pipeline_request() reads
+ * replies, until a request completed.
+ * 
+ * @code
+ * jcon_pipeline_t *pipeline = jcon_pipeline_init(client, 4, 65536, 64, NULL);
+ * for(size_t i = 0; i < count; i++)
+ * {
+ *   jcon_pipeline_request(pipeline, requests[i], sizes[i], &on_reply, &results[i]);
+ * }
+ * jcon_pipeline_wait(pipeline, 0);
+ * @endcode
+ * 
+ * Sessions are used by one thread. The client is not freed
+ * with the session.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_PIPELINE_H
+#define INCLUDE_JCON_PIPELINE_H
+
+#include <jayc/jcon_client.h>
+#include <jayc/jcon_frame.h>
+#include <jayc/jlog.h>
+#include <jayc/jutil_buffer.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Size of correlation id in front of frame data.
+ */
+#define JCON_PIPELINE_ID_SIZE 4
+
+/**
+ * @brief Reply was recieved.
+ */
+#define JCON_PIPELINE_STATUS_OK 0
+
+/**
+ * @brief Connection was closed or session freed before reply.
+ */
+#define JCON_PIPELINE_STATUS_CLOSED 1
+
+/**
+ * @brief No reply in time (see @c #jcon_pipeline_setTimeout() ).
+ */
+#define JCON_PIPELINE_STATUS_TIMEOUT 2
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+typedef struct __jcon_pipeline_session jcon_pipeline_t;
+
+/**
+ * @brief Gets called once for every request.
+ * 
+ * Reply data is only valid until the handler returns.
+ * New requests can be sent from the handler, but they
+ * do not wait for a free slot.
+ * 
+ * @param ctx         Context pointer given with request.
+ * @param status      @c #JCON_PIPELINE_STATUS_OK ,
+ *                    @c #JCON_PIPELINE_STATUS_CLOSED or
+ *                    @c #JCON_PIPELINE_STATUS_TIMEOUT .
+ * @param reply_ptr   Reply data, without correlation id.
+ *                    @c NULL , if status is not OK.
+ * @param reply_size  Size of reply in bytes.
+ */
+typedef void(*jcon_pipeline_completion_t)(void *ctx, int status, const void *reply_ptr, size_t reply_size);
+
+/**
+ * @brief Creates session on connected client.
+ * 
+ * @param client      Client to send requests through.
+ * @param prefix_size Size of length prefix in bytes ( @c 1 , @c 2 or @c 4 ).
+ * @param frame_max   Maximum size of request and reply data in bytes.
+ * @param window      Maximum number of requests in flight.
+ * @param logger      Logger for debug and error messages.
+ * 
+ * @return            Session object.
+ * @return            @c NULL , if error occured.
+ */
+jcon_pipeline_t *jcon_pipeline_init(jcon_client_t *client, size_t prefix_size, size_t frame_max, size_t window, jlog_t *logger);
+
+/**
+ * @brief Frees session memory.
+ * 
+ * Requests in flight complete with
+ * @c #JCON_PIPELINE_STATUS_CLOSED . Client is not freed.
+ * 
+ * @param session Session to free.
+ */
+void jcon_pipeline_free(jcon_pipeline_t *session);
+
+/**
+ * @brief Sends request.
+ * 
+ * If the window is full, replies are read, until
+ * a request completed.
+ * 
+ * @param session     Session to send through.
+ * @param data_ptr    Request data.
+ * @param data_size   Size of request in bytes.
+ * @param completion  Handler to call with reply.
+ * @param ctx         Context pointer passed to handler.
+ * 
+ * @return            @c true , if request was sent.
+ * @return            @c false , if connection was closed or
+ *                    error occured (handler is not called).
+ */
+int jcon_pipeline_request(jcon_pipeline_t *session, const void *data_ptr, size_t data_size, jcon_pipeline_completion_t completion, void *ctx);
+
+/**
+ * @brief Sends request of buffer without copy.
+ * 
+ * Works like @c #jcon_pipeline_request() .
+ * 
+ * @param session     Session to send through.
+ * @param request     Request data.
+ * @param completion  Handler to call with reply.
+ * @param ctx         Context pointer passed to handler.
+ * 
+ * @return            @c true , if request was sent.
+ * @return            @c false , if connection was closed or
+ *                    error occured (handler is not called).
+ */
+int jcon_pipeline_requestBuffer(jcon_pipeline_t *session, jutil_buffer_t *request, jcon_pipeline_completion_t completion, void *ctx);
+
+/**
+ * @brief Sends request, if window is not full.
+ * 
+ * Works like @c #jcon_pipeline_request() , but returns
+ * instead of waiting. Used from event loops, that call
+ * @c #jcon_pipeline_process() , when data is available.
+ * 
+ * @param session     Session to send through.
+ * @param data_ptr    Request data.
+ * @param data_size   Size of request in bytes.
+ * @param completion  Handler to call with reply.
+ * @param ctx         Context pointer passed to handler.
+ * 
+ * @return            @c true , if request was sent.
+ * @return            @c false , if window is full, connection was
+ *                    closed or error occured (handler is not called).
+ */
+int jcon_pipeline_tryRequest(jcon_pipeline_t *session, const void *data_ptr, size_t data_size, jcon_pipeline_completion_t completion, void *ctx);
+
+/**
+ * @brief Reads available data and completes requests.
+ * 
+ * Reads once from the client, like @c #jcon_frame_process() .
+ * Also completes expired requests.
+ * 
+ * @param session Session to process.
+ * 
+ * @return        Number of replies handled.
+ * @return        @c -1 , if connection was closed or error occured
+ *                (requests in flight are completed as closed).
+ */
+int jcon_pipeline_process(jcon_pipeline_t *session);
+
+/**
+ * @brief Reads replies, until few enough requests are in flight.
+ * 
+ * Uses poll timeout of client to wait for data
+ * ( @c #jcon_client_setPollTimeout() ).
+ * 
+ * @param session   Session to wait on.
+ * @param in_flight Number of requests, that may stay in flight.
+ *                  @c 0 waits for all replies.
+ * 
+ * @return          @c true , if not more than @c in_flight
+ *                  requests are in flight.
+ * @return          @c false , if connection was closed or error occured.
+ */
+int jcon_pipeline_wait(jcon_pipeline_t *session, size_t in_flight);
+
+/**
+ * @brief Sets time after which requests complete as expired.
+ * 
+ * Late replies of expired requests are discarded.
+ * Checked by @c #jcon_pipeline_process() .
+ * 
+ * @param session Session to configure.
+ * @param timeout Timeout in milliseconds. @c 0 disables timeouts.
+ */
+void jcon_pipeline_setTimeout(jcon_pipeline_t *session, unsigned long long timeout);
+
+/**
+ * @brief Returns number of requests, that wait for reply.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of requests in flight.
+ */
+size_t jcon_pipeline_getInFlight(jcon_pipeline_t *session);
+
+/**
+ * @brief Splits request frame of server into id and data.
+ * 
+ * Used in @c #jcon_frame_handler_t of server sessions.
+ * 
+ * @param frame_ptr   Frame data given to handler.
+ * @param frame_size  Size of frame in bytes.
+ * @param id          Set to correlation id.
+ * @param data_ptr    Set to request data.
+ * @param data_size   Set to size of request data.
+ * 
+ * @return            @c true , if frame holds a request.
+ * @return            @c false , if frame is too short.
+ */
+int jcon_pipeline_parseRequest(const void *frame_ptr, size_t frame_size, uint32_t *id, const void **data_ptr, size_t *data_size);
+
+/**
+ * @brief Sends reply to request from server.
+ * 
+ * @param frame       Length prefixed session of server connection.
+ * @param id          Correlation id of request.
+ * @param reply_ptr   Reply data.
+ * @param reply_size  Size of reply in bytes.
+ * 
+ * @return            @c true , if reply was sent completely.
+ * @return            @c false , if error occured.
+ */
+int jcon_pipeline_reply(jcon_frame_t *frame, uint32_t id, const void *reply_ptr, size_t reply_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_PIPELINE_H */
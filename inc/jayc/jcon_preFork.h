@@ -0,0 +1,267 @@
+/**
+ * @file jcon_preFork.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Runs jcon_system in pre-forked worker processes.
+ * 
+ * The server is bound once by the supervisor, then worker
+ * processes are forked, that share the listening socket.
+ * Every worker runs its own jcon_system in event loop mode
+ * (see @c #jcon_system_eventLoop_init() ), so handlers do not
+ * need to be thread-safe between workers and a crash only
+ * takes down the connections of one worker.
+ * 
+ * A thread of the supervisor restarts workers, that died.
+ * Connections waiting in the backlog are accepted by the
+ * other workers in the meantime. The supervisor talks to
+ * every worker over a Unix socket, to stop it and to collect
+ * its metrics ( @c #jcon_preFork_formatMetrics() ).
+ * 
+ * @code
+ * jcon_server_t *server = jcon_server_tcp_session_init("0.0.0.0", 8080, logger);
+ * jcon_preFork_t *workers = jcon_preFork_init(server, 4, 1, handler, NULL, NULL, logger, NULL);
+ * jcon_preFork_start(workers);
+ * jcon_preFork_serveMetrics(workers, "127.0.0.1", 9100);
+ * ...
+ * jcon_preFork_free(workers);
+ * @endcode
+ * 
+ * @c fork() only copies the calling thread. Loggers with
+ * threads of their own (jlog_async) do not write in workers,
+ * and locks, that other threads of the supervisor hold while
+ * a worker is forked, stay locked in the worker.
+ * Workers should be started, before such threads are.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jcon_system.h
+ * 
+ */
+
+#ifndef INCLUDE_JCON_PREFORK_H
+#define INCLUDE_JCON_PREFORK_H
+
+#include <jayc/jcon_system.h>
+#include <jayc/jcon_server.h>
+#include <jayc/jlog.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of worker processes.
+ */
+#define JCON_PREFORK_PROCESSES_MAX 256
+
+/**
+ * @brief Milliseconds between two starts of the same worker,
+ *        so crashing workers are not restarted in a loop.
+ */
+#define JCON_PREFORK_RESTART_DELAY 1000
+
+/**
+ * @brief Default milliseconds, workers may drain their
+ *        connections, when they are stopped.
+ */
+#define JCON_PREFORK_STOP_TIMEOUT_DEFAULT 5000
+
+/**
+ * @brief Session object of supervisor.
+ */
+typedef struct __jcon_preFork_session jcon_preFork_t;
+
+/**
+ * @brief Handler, that is called in a new worker process.
+ * 
+ * Called after @c fork() , before the jcon_system of the
+ * worker is created. Can f.ex. reopen files or seed
+ * random generators.
+ * 
+ * @param ctx     Context pointer of session.
+ * @param worker  Index of worker (0 to process_number - 1).
+ */
+typedef void(*jcon_preFork_worker_handler_t)(void *ctx, size_t worker);
+
+/**
+ * @brief Initializes supervisor.
+ * 
+ * Binds the server, if it is not open yet. No workers
+ * are forked until @c #jcon_preFork_start() , so the
+ * session can be configured first.
+ * 
+ * @param server          jcon_server session to share.
+ *                        Has to provide a file descriptor.
+ * @param process_number  Number of worker processes.
+ * @param loop_number     Number of event loops in every worker.
+ * @param data_handler    Handler to manage new data.
+ * @param create_handler  Handler gets called, when connection is created.
+ * @param close_handler   Handler gets called, when connection is closed.
+ * @param logger          Logger to print debug and error messages.
+ * @param ctx             Context pointer passed to handlers.
+ * 
+ * @return                Session object.
+ * @return                @c NULL , if error occured.
+ */
+jcon_preFork_t *jcon_preFork_init
+(
+  jcon_server_t *server,
+  size_t process_number,
+  size_t loop_number,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+);
+
+/**
+ * @brief Stops workers and supervisor and frees memory.
+ * 
+ * Workers get the stop timeout (see
+ * @c #jcon_preFork_setStopTimeout() ) to drain their
+ * connections. Server not freed, has to be handled manually.
+ * 
+ * @param session Session to free.
+ */
+void jcon_preFork_free(jcon_preFork_t *session);
+
+/**
+ * @brief Sets handler, that is called in new workers.
+ * 
+ * @param session Session to configure.
+ * @param handler Handler to call. @c NULL to disable.
+ * 
+ * @return        @c true , if handler was set.
+ * @return        @c false , if error occured.
+ */
+int jcon_preFork_setWorkerHandler(jcon_preFork_t *session, jcon_preFork_worker_handler_t handler);
+
+/**
+ * @brief Sets time, workers may drain connections at stop.
+ * 
+ * Workers still running afterwards are killed.
+ * 
+ * @param session Session to configure.
+ * @param timeout Timeout in milliseconds
+ *                (default @c #JCON_PREFORK_STOP_TIMEOUT_DEFAULT ).
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if error occured.
+ */
+int jcon_preFork_setStopTimeout(jcon_preFork_t *session, long timeout);
+
+/**
+ * @brief Forks workers and starts supervisor thread.
+ * 
+ * @param session Session to start.
+ * 
+ * @return        @c true , if all workers were started.
+ * @return        @c false , if error occured. Workers, that
+ *                could not be forked, are restarted later.
+ */
+int jcon_preFork_start(jcon_preFork_t *session);
+
+/**
+ * @brief Stops all workers.
+ * 
+ * Workers stop accepting, drain their connections for
+ * at most @c timeout milliseconds and exit. Workers are
+ * not restarted, until @c #jcon_preFork_start() is called again.
+ * 
+ * @param session Session to stop.
+ * @param timeout Time for workers to drain in milliseconds.
+ * 
+ * @return        @c true , if all workers exited by themselves.
+ * @return        @c false , if workers had to be killed or error occured.
+ */
+int jcon_preFork_stop(jcon_preFork_t *session, long timeout);
+
+/**
+ * @brief Returns number of running workers.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of running workers.
+ * @return        @c 0 , if error occured.
+ */
+size_t jcon_preFork_getRunning(jcon_preFork_t *session);
+
+/**
+ * @brief Returns number of restarted workers.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of restarts, since session was created.
+ */
+size_t jcon_preFork_getRestarts(jcon_preFork_t *session);
+
+/**
+ * @brief Returns index of the worker, that calls it.
+ * 
+ * Allows handlers to tell workers apart.
+ * 
+ * @return        Index of worker.
+ * @return        @c -1 , if called outside of a worker.
+ */
+long jcon_preFork_getWorker(void);
+
+/**
+ * @brief Collects metrics of all workers.
+ * 
+ * Asks every worker for its @c #jutil_metrics_format() and
+ * merges the samples: counters, gauges, sums and counts are
+ * added up, quantiles of summaries are the maximum over all
+ * workers. Adds @c jcon_prefork_workers and
+ * @c jcon_prefork_restarts_total of the supervisor.
+ * Workers, that do not answer in time, are left out.
+ * 
+ * Workers start with a copy of the metrics of the supervisor,
+ * so values from before the fork are counted once per worker.
+ * 
+ * @param session Session to collect from.
+ * @param length  Set to length of text, if not @c NULL .
+ * 
+ * @return        Text in Prometheus format, freed with @c free() .
+ * @return        @c NULL , if error occured.
+ */
+char *jcon_preFork_formatMetrics(jcon_preFork_t *session, size_t *length);
+
+/**
+ * @brief Serves collected metrics of all workers over HTTP.
+ * 
+ * Uses jcon_metrics with @c #jcon_preFork_formatMetrics() .
+ * Server is closed with the session.
+ * 
+ * @param session Session to serve metrics of.
+ * @param address Address to listen on.
+ * @param port    Port to listen on.
+ * 
+ * @return        @c true , if server was opened.
+ * @return        @c false , if already serving or error occured.
+ */
+int jcon_preFork_serveMetrics(jcon_preFork_t *session, char *address, uint16_t port);
+
+/**
+ * @brief Registers session with shutdown phases of jproc_exit.
+ * 
+ * In phase @c #JPROC_EXIT_PHASE_ACCEPT workers are told to
+ * stop, in phase @c #JPROC_EXIT_PHASE_DRAIN the supervisor
+ * waits for them until the deadline and kills the rest.
+ * Handlers are removed by @c #jcon_preFork_free() .
+ * 
+ * @param session Session to register.
+ * 
+ * @return        @c true , if handlers were added.
+ * @return        @c false , if error occured.
+ */
+int jcon_preFork_addShutdownHandlers(jcon_preFork_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_PREFORK_H */
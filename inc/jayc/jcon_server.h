@@ -99,10 +99,41 @@ int jcon_server_newConnection(jcon_server_t *session);
  * @param session Session, that accepts connection.
  * 
  * @return        jcon_client session, that is connected to new client.
- * @return        @c NULL in case of error.
+ * @return        @c NULL , if no connection is pending
+ *                ( @c errno is @c EAGAIN ) or in case of error.
  */
 jcon_client_t *jcon_server_acceptConnection(jcon_server_t *session);
 
+/**
+ * @brief Get file descriptor of listening socket.
+ * 
+ * Allows registering the server with event loops
+ * (see @c #jcon_eventLoop_add() ). The descriptor stays
+ * owned by the session and must not be closed manually.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        File descriptor of listening socket.
+ * @return        @c -1 , if implementation has no descriptor,
+ *                server is not open or error occured.
+ */
+int jcon_server_getFileDescriptor(jcon_server_t *session);
+
+/**
+ * @brief Opens another listener on the address of the server.
+ * 
+ * Connections are spread over all listeners by the kernel,
+ * so every event loop can accept on its own listener.
+ * The new session is open and has to be freed by the caller.
+ * 
+ * @param session Server to clone.
+ * 
+ * @return        New server session.
+ * @return        @c NULL , if implementation does not support
+ *                shared listeners or error occured.
+ */
+jcon_server_t *jcon_server_cloneListener(jcon_server_t *session);
+
 #ifdef __cplusplus
 }
 #endif
@@ -91,6 +91,32 @@ typedef int(*jcon_server_newConnection_handler_t)(void *ctx);
  */
 typedef jcon_client_t*(*jcon_server_acceptConnection_handler_t)(void *ctx);
 
+/**
+ * @brief Function to handle requests for the file descriptor.
+ * 
+ * Optional. Implementations, that are not based on
+ * a pollable descriptor, set this to @c NULL .
+ * 
+ * @param ctx Context pointer for session data.
+ * 
+ * @return    File descriptor of listening socket.
+ * @return    @c -1 , if not available or error occured.
+ */
+typedef int(*jcon_server_getFileDescriptor_handler_t)(void *ctx);
+
+/**
+ * @brief Function to open another listener on the same address.
+ * 
+ * Optional. Implementations, that can not share
+ * their address, set this to @c NULL .
+ * 
+ * @param ctx Context pointer for session data.
+ * 
+ * @return    New open server session.
+ * @return    @c NULL , if not supported or error occured.
+ */
+typedef jcon_server_t*(*jcon_server_cloneListener_handler_t)(void *ctx);
+
 /**
  * @brief jcon_server session object, holds data and functions for operation.
  */
@@ -106,6 +132,8 @@ struct __jcon_server_session
 
   jcon_server_newConnection_handler_t function_newConnection;           /**< Pointer to function, which checks if new connections are available. */
   jcon_server_acceptConnection_handler_t function_acceptConnection;     /**< Pointer to function, which accepts and returns new connection. */
+  jcon_server_getFileDescriptor_handler_t function_getFileDescriptor;   /**< Pointer to function, which returns descriptor for event loops. */
+  jcon_server_cloneListener_handler_t function_cloneListener;           /**< Pointer to function, which opens another listener on the same address. */
 
   const char *connection_type;                                          /**< String to show, which type of connection the session is holding. */
   void *session_context;                                                /**< Context pointer, holds data for implementation. */
@@ -0,0 +1,45 @@
+/**
+ * @file jcon_server_shm.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Shared memory implementation of jcon_server.
+ * 
+ * Listens on a Unix socket for jcon_client_shm clients.
+ * Accepted connections exchange data over shared memory
+ * of the client (see jcon_client_shm.h ). Accepting waits
+ * shortly for the client to pass its memory.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jcon_client_shm.h
+ */
+
+#ifndef INCLUDE_JCON_SERVER_SHM_H
+#define INCLUDE_JCON_SERVER_SHM_H
+
+#include <jayc/jcon_server.h>
+#include <jayc/jlog.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize server with uds file path.
+ * 
+ * Creates server socket.
+ * 
+ * @param filepath  File path, the server will be open to.
+ * @param logger    jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return          jcon_server session object.
+ * @return          @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_shm_session_init(char *filepath, jlog_t *logger);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_SERVER_SHM_H */
@@ -13,6 +13,7 @@
 #define INCLUDE_JCON_SERVER_TCP_H
 
 #include <jayc/jcon_server.h>
+#include <jayc/jcon_socketTCP.h>
 #include <jayc/jlog.h>
 #include <stdint.h>
 
@@ -34,6 +35,77 @@ extern "C" {
  */
 jcon_server_t *jcon_server_tcp_session_init(char *address, uint16_t port, jlog_t *logger);
 
+/**
+ * @brief Initialize server with socket options.
+ * 
+ * Options are also used for accepted connections
+ * and cloned listeners.
+ * 
+ * @param address IP address, the server will be open to.
+ * @param port    Port, the server will be open to.
+ * @param options Options for listening socket. @c NULL uses defaults.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_server session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_tcp_options_init(char *address, uint16_t port, const jcon_socketTCP_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Initialize server, that shares its address with
+ *        other listeners ( @c SO_REUSEPORT ).
+ * 
+ * Additional listeners can be opened with
+ * @c #jcon_server_cloneListener() . The kernel spreads
+ * incoming connections over all of them.
+ * 
+ * @param address IP address, the server will be open to.
+ * @param port    Port, the server will be open to.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_server session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_tcp_reusePort_init(char *address, uint16_t port, jlog_t *logger);
+
+/**
+ * @brief Initialize server, that accepts and serves
+ *        connections through io_uring.
+ * 
+ * Uses jcon_socketUring. Accepted clients recieve and send
+ * through io_uring as well. Should only be used, if
+ * @c #jcon_socketUring_isSupported() returns @c true .
+ * 
+ * @param address IP address, the server will be open to.
+ * @param port    Port, the server will be open to.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_server session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_tcp_uring_init(char *address, uint16_t port, jlog_t *logger);
+
+/**
+ * @brief Initialize server with a listening socket,
+ *        that was opened by another process.
+ * 
+ * The socket is not bound again, so connections in its
+ * backlog are kept and no connection gets refused during
+ * restarts (see jcon_handoff.h ). Cloned listeners and
+ * resets after @c #jcon_server_close() use the address
+ * of the socket.
+ * 
+ * @param fd      Descriptor of listening TCP socket.
+ *                Owned by the session afterwards,
+ *                closed if an error occured.
+ * @param options Options for accepted connections. @c NULL uses defaults.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        Open jcon_server session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_tcp_adopt_init(int fd, const jcon_socketTCP_options_t *options, jlog_t *logger);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,71 @@
+/**
+ * @file jcon_server_tls.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief TLS implementation of jcon_server, using OpenSSL.
+ * 
+ * Accepted connections are jcon_client_tls sessions.
+ * The handshake is done by @c #jcon_server_acceptConnection() ,
+ * which blocks for at most the handshake timeout.
+ * 
+ * Sessions are cached and, unless disabled, tickets are
+ * issued, so clients can resume them at reconnects.
+ * Cloned listeners share cache and ticket keys.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_SERVER_TLS_H
+#define INCLUDE_JCON_SERVER_TLS_H
+
+#include <jayc/jcon_server.h>
+#include <jayc/jcon_client_tls.h>
+#include <jayc/jlog.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize server with IP, port and certificate.
+ * 
+ * Clients are not asked for certificates.
+ * 
+ * @param address   IP address, the server will be open to.
+ * @param port      Port, the server will be open to.
+ * @param cert_file Certificate chain of server (PEM).
+ * @param key_file  Private key of certificate (PEM).
+ *                  @c NULL , if key is in @c cert_file .
+ * @param logger    jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return          jcon_server session object.
+ * @return          @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_tls_session_init(char *address, uint16_t port, const char *cert_file, const char *key_file, jlog_t *logger);
+
+/**
+ * @brief Initialize server with TLS options.
+ * 
+ * @c cert_file is required. Socket options are also used
+ * for accepted connections and cloned listeners.
+ * With @c tcp.reuse_port , more listeners can be opened
+ * with @c #jcon_server_cloneListener() .
+ * 
+ * @param address IP address, the server will be open to.
+ * @param port    Port, the server will be open to.
+ * @param options Options for TLS and listening socket.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        jcon_server session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_tls_options_init(char *address, uint16_t port, const jcon_client_tls_options_t *options, jlog_t *logger);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_SERVER_TLS_H */
@@ -33,6 +33,24 @@ extern "C" {
  */
 jcon_server_t *jcon_server_unix_session_init(char *filepath, jlog_t *logger);
 
+/**
+ * @brief Initialize server with a listening socket,
+ *        that was opened by another process.
+ * 
+ * The socket is not bound again, so the file is not
+ * replaced and clients can connect during restarts
+ * (see jcon_handoff.h ).
+ * 
+ * @param fd      Descriptor of listening Unix socket.
+ *                Owned by the session afterwards,
+ *                closed if an error occured.
+ * @param logger  jlog logger to use. If @c NULL , uses global logger.
+ * 
+ * @return        Open jcon_server session object.
+ * @return        @c NULL , if an error occured.
+ */
+jcon_server_t *jcon_server_unix_adopt_init(int fd, jlog_t *logger);
+
 #ifdef __cplusplus
 }
 #endif
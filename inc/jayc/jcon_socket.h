@@ -14,11 +14,40 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/uio.h>
+#include <sys/types.h>
+#include <sys/socket.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Maximum bytes discarded by one call of
+ *        @c #jcon_socket_recvData() without buffer.
+ */
+#define JCON_SOCKET_DISCARD_SIZE 4096
+
+/**
+ * @brief Maximum datagrams moved by one system call of
+ *        @c #jcon_socket_recvBatch() and @c #jcon_socket_sendBatch() .
+ */
+#define JCON_SOCKET_BATCH_MAX 64
+
+/**
+ * @brief One datagram for batch functions.
+ */
+typedef struct __jcon_socket_datagram
+{
+  void *data_ptr;                   /**< Buffer of datagram. */
+  size_t data_size;                 /**< Size of buffer for recieving, size of data for sending. */
+  size_t transferred;               /**< Bytes recieved or sent, set by batch functions. */
+  int truncated;                    /**< @c true , if recieved datagram did not fit into buffer. */
+  struct sockaddr_storage address;  /**< Source of recieved datagram. Destination for sending,
+                                         if address_size is not @c 0 . */
+  socklen_t address_size;           /**< Size of address. @c 0 sends to connected peer. */
+} jcon_socket_datagram_t;
+
 /**
  * @brief Session object.
  * 
@@ -56,6 +85,9 @@ int jcon_socket_connect(jcon_socket_t *session);
  * ( @c #jcon_socket_recvData() and @c #jcon_socket_sendData() )
  * can be called using this session.
  * 
+ * Datagram sockets (UDP, Unix @c SOCK_DGRAM ) stay clients,
+ * they recieve on the bound address with the client functions.
+ * 
  * @param session Session to bind.
  * 
  * @return        @c true , if socket was bound to address.
@@ -110,11 +142,15 @@ int jcon_socket_pollForInput(jcon_socket_t *session, int timeout);
  * If new connection is available, accepts the connection
  * and returns client connection as new session.
  * 
+ * Listening sockets do not block, so this can be called
+ * in a loop until no connection is pending.
+ * 
  * @param session Server session, to accept connection.
  * 
  * @return        Session object of client connection.
  * @return        @c NULL , if no new connection was
- *                available or error occured.
+ *                available ( @c errno is @c EAGAIN )
+ *                or error occured.
  */
 jcon_socket_t *jcon_socket_accept(jcon_socket_t *session);
 
@@ -126,15 +162,15 @@ jcon_socket_t *jcon_socket_accept(jcon_socket_t *session);
  * If new data is available (check using @c #jcon_tcp_pollForInput() ),
  * data can be read using this function.
  * 
- * Data is read from socket using buffer, and if data_ptr is not
- * @c NULL , is copied in data_ptr.
- * If size of data read exceeds the buffer size (data_size), it is
- * trimmed to fit in data_ptr. This is done to prevent buffer
+ * Data is read from socket directly into data_ptr.
+ * At most data_size bytes are read, so data_ptr can not
  * overflow.
  * 
  * If data_ptr is @c NULL , the data is still read, but it is
  * discarded afterwards.
  * This can be used to skip offsets in binary data.
+ * Discarding reads at most @c #JCON_SOCKET_DISCARD_SIZE bytes
+ * per call.
  * 
  * If EOF is recieved, the session is automatically closed.
  * 
@@ -147,6 +183,26 @@ jcon_socket_t *jcon_socket_accept(jcon_socket_t *session);
  */
 size_t jcon_socket_recvData(jcon_socket_t *session, void *data_ptr, size_t data_size);
 
+/**
+ * @brief Read data from socket into multiple buffers.
+ * 
+ * <b>Client function</b>
+ * 
+ * Works like @c #jcon_socket_recvData() , but fills the buffers
+ * of iov in order with one @c readv() call. Allows reading
+ * header and payload of framed protocols at once.
+ * 
+ * If EOF is recieved, the session is automatically closed.
+ * 
+ * @param session   Session to read from.
+ * @param iov       Array of buffers to fill.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data read over all buffers.
+ * @return          @c 0 , if no data read or error occured.
+ */
+size_t jcon_socket_recvDataV(jcon_socket_t *session, const struct iovec *iov, int iov_count);
+
 /**
  * @brief Send data via socket.
  * 
@@ -168,6 +224,123 @@ size_t jcon_socket_recvData(jcon_socket_t *session, void *data_ptr, size_t data_
  */
 size_t jcon_socket_sendData(jcon_socket_t *session, void *data_ptr, size_t data_size);
 
+/**
+ * @brief Send data from multiple buffers via socket.
+ * 
+ * <b>Client function</b>
+ * 
+ * Works like @c #jcon_socket_sendData() , but sends the buffers
+ * of iov in order with one @c sendmsg() call. Allows sending
+ * header, body and trailer of a reply at once.
+ * 
+ * @param session   Session to send to.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sent over all buffers.
+ * @return          @c 0 , if no data sent or error occured.
+ */
+size_t jcon_socket_sendDataV(jcon_socket_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Send data from multiple buffers without blocking.
+ * 
+ * <b>Client function</b>
+ * 
+ * Works like @c #jcon_socket_sendDataV() , but only sends as
+ * much data as fits into the socket send buffer. If the buffer
+ * is full, @c 0 is returned and @c errno is set to @c EAGAIN .
+ * 
+ * @param session   Session to send to.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sent over all buffers.
+ * @return          @c 0 , if send buffer is full or error occured.
+ */
+size_t jcon_socket_trySendDataV(jcon_socket_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Send data from file descriptor via socket.
+ * 
+ * <b>Client function</b>
+ * 
+ * Data is copied by the kernel with @c sendfile() , without
+ * passing through user space. If the descriptor does not
+ * support that (for example pipes), @c splice() is used.
+ * For pipes @c offset is ignored and data is read from
+ * the current position.
+ * 
+ * Waits until @c size bytes were sent or end of file is reached.
+ * 
+ * @param session         Session to send to.
+ * @param file_descriptor Descriptor to read data from.
+ * @param offset          Position in file to start reading.
+ * @param size            Number of bytes to send.
+ * 
+ * @return                Size of data sent.
+ * @return                @c 0 , if no data sent or error occured.
+ */
+size_t jcon_socket_sendFile(jcon_socket_t *session, int file_descriptor, off_t offset, size_t size);
+
+/**
+ * @brief Recieve multiple datagrams with one system call.
+ * 
+ * <b>Client function</b>
+ * 
+ * Uses @c recvmmsg() . Waits for the first datagram, then takes
+ * as many more, as are already queued (up to count or
+ * @c #JCON_SOCKET_BATCH_MAX ). Every datagram goes into its own
+ * buffer, so message boundaries are kept.
+ * 
+ * Works with datagram and sequential packet sockets. On
+ * connection oriented sockets an empty datagram means, that
+ * the peer closed the connection. The session is closed then.
+ * 
+ * @param session   Session to read from.
+ * @param datagrams Array of datagrams to fill.
+ * @param count     Number of datagrams in array.
+ * 
+ * @return          Number of datagrams recieved.
+ * @return          @c 0 , if nothing was recieved or error occured.
+ */
+size_t jcon_socket_recvBatch(jcon_socket_t *session, jcon_socket_datagram_t *datagrams, size_t count);
+
+/**
+ * @brief Send multiple datagrams with few system calls.
+ * 
+ * <b>Client function</b>
+ * 
+ * Uses @c sendmmsg() with up to @c #JCON_SOCKET_BATCH_MAX
+ * datagrams per call. Datagrams with address_size @c 0
+ * are sent to the connected peer.
+ * 
+ * @param session   Session to send through.
+ * @param datagrams Array of datagrams to send.
+ * @param count     Number of datagrams in array.
+ * 
+ * @return          Number of datagrams sent.
+ * @return          @c 0 , if nothing was sent or error occured.
+ */
+size_t jcon_socket_sendBatch(jcon_socket_t *session, jcon_socket_datagram_t *datagrams, size_t count);
+
+/**
+ * @brief Holds back partial frames of following sends.
+ * 
+ * <b>Client function</b>
+ * 
+ * While corked, sent data is collected and sent in full
+ * segments. Disabling cork flushes the collected data.
+ * 
+ * @param session Session to configure.
+ * @param enable  @c true to cork, @c false to flush.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if socket type does not support
+ *                corking or error occured.
+ */
+int jcon_socket_setCork(jcon_socket_t *session, int enable);
+
 /**
  * @brief Checks if the session is connected.
  * 
@@ -203,6 +376,22 @@ const char *jcon_socket_getSocketType(jcon_socket_t *session);
  */
 const char *jcon_socket_getReferenceString(jcon_socket_t *session);
 
+/**
+ * @brief Returns file descriptor of socket.
+ * 
+ * Used to register the socket with external
+ * event mechanisms (f.ex. @c epoll() ).
+ * The descriptor stays owned by the session
+ * and must not be closed by the caller.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        File descriptor of socket.
+ * @return        @c -1 , if session is not connected
+ *                or error occured.
+ */
+int jcon_socket_getFileDescriptor(jcon_socket_t *session);
+
 #ifdef __cplusplus
 }
 #endif
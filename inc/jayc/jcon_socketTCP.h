@@ -14,11 +14,41 @@
 
 #include <jayc/jcon_socket.h>
 #include <jayc/jlog.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Tuning options for TCP sockets.
+ * 
+ * Members set to @c 0 keep the defaults of the system,
+ * so a zeroed struct behaves like @c #jcon_socketTCP_simple_init() .
+ * 
+ * Options are set before connecting or binding. Accepted
+ * connections get the options of their listener.
+ */
+typedef struct __jcon_socketTCP_options
+{
+  int no_delay;           /**< Sets @c TCP_NODELAY (disables Nagle algorithm). */
+  int quick_ack;          /**< Sets @c TCP_QUICKACK after connecting. Kernel may fall back to delayed ACKs later. */
+  int send_buffer;        /**< Size for @c SO_SNDBUF in bytes. */
+  int recv_buffer;        /**< Size for @c SO_RCVBUF in bytes. */
+  int keepalive;          /**< Enables @c SO_KEEPALIVE . */
+  int keepalive_idle;     /**< Idle time before first probe in seconds ( @c TCP_KEEPIDLE ). */
+  int keepalive_interval; /**< Time between probes in seconds ( @c TCP_KEEPINTVL ). */
+  int keepalive_count;    /**< Unanswered probes before connection is dropped ( @c TCP_KEEPCNT ). */
+  int fast_open;          /**< Listener: queue length for @c TCP_FASTOPEN .
+                               Client: any value enables @c TCP_FASTOPEN_CONNECT . */
+  int busy_poll;          /**< Busy polling time in microseconds ( @c SO_BUSY_POLL ). */
+  int ipv6;               /**< Resolves address as IPv6. IPv4 addresses are mapped. */
+  int v6_only;            /**< With ipv6, listener only accepts IPv6 connections.
+                               Otherwise listener is dual-stack. */
+  int backlog;            /**< Size of listen backlog. @c 0 uses @c SOMAXCONN . */
+  int reuse_port;         /**< Sets @c SO_REUSEPORT on listener (see @c #jcon_socketTCP_setReusePort() ). */
+} jcon_socketTCP_options_t;
+
 /**
  * @brief Simple initializer. Only essential information needed.
  * 
@@ -36,6 +66,128 @@ extern "C" {
  */
 jcon_socket_t *jcon_socketTCP_simple_init(const char *address, uint16_t port, jlog_t *logger);
 
+/**
+ * @brief Initializer with tuning options.
+ * 
+ * @param address IP/DNS address of server to connect to.
+ * @param port    Port to connect to.
+ * @param options Options for socket. Copied into session.
+ *                @c NULL uses defaults.
+ * @param logger  Logger to use in session.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_socket_t *jcon_socketTCP_options_init(const char *address, uint16_t port, const jcon_socketTCP_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Sets timeout for connecting to server.
+ * 
+ * With a timeout, the socket connects non-blocking and
+ * waits at most timeout milliseconds for the connection,
+ * instead of the SYN timeout of the kernel.
+ * 
+ * @param session TCP session to configure.
+ * @param timeout Timeout in milliseconds.
+ *                @c -1 uses blocking @c connect() (default).
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if session is not TCP or error occured.
+ */
+int jcon_socketTCP_setConnectTimeout(jcon_socket_t *session, int timeout);
+
+/**
+ * @brief Allows multiple sockets to bind the same address.
+ * 
+ * Sets @c SO_REUSEPORT at the next @c #jcon_socket_bind() .
+ * The kernel then spreads incoming connections over all
+ * sockets bound to the address.
+ * 
+ * @param session TCP session to configure.
+ * @param enable  @c true to share address.
+ * 
+ * @return        @c true , if option was set.
+ * @return        @c false , if session is not TCP or error occured.
+ */
+int jcon_socketTCP_setReusePort(jcon_socket_t *session, int enable);
+
+/**
+ * @brief Creates server session from a listening socket.
+ * 
+ * For sockets inherited from another process
+ * (see jcon_handoff.h ). The socket is not bound again,
+ * address family and @c SO_REUSEPORT are taken from it.
+ * Descriptor is set non-blocking and close-on-exec and
+ * is owned by the session afterwards. If an error occurs,
+ * the descriptor stays open.
+ * 
+ * @param fd      Descriptor of bound and listening TCP socket.
+ * @param options Options for accepted connections. Copied into session.
+ *                @c NULL uses defaults.
+ * @param logger  Logger to use in session.
+ * 
+ * @return        Session object, that is open as server.
+ * @return        @c NULL , if descriptor is no listening
+ *                TCP socket or error occured.
+ */
+jcon_socket_t *jcon_socketTCP_adopt_init(int fd, const jcon_socketTCP_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Returns address of session.
+ * 
+ * For servers the address, the socket is bound to.
+ * 
+ * @param session TCP session to check.
+ * @param buf     Buffer for IP address
+ *                (at least @c INET6_ADDRSTRLEN bytes).
+ * @param size    Size of @c buf .
+ * @param port    Set to port, if not @c NULL .
+ * 
+ * @return        @c true , if address was written.
+ * @return        @c false , if session is not TCP or error occured.
+ */
+int jcon_socketTCP_getLocalAddress(jcon_socket_t *session, char *buf, size_t size, uint16_t *port);
+
+/**
+ * @brief Copies options of session.
+ * 
+ * @param session TCP session to check.
+ * @param options Set to options of session.
+ * 
+ * @return        @c true , if options were copied.
+ * @return        @c false , if session is not TCP or error occured.
+ */
+int jcon_socketTCP_getOptions(jcon_socket_t *session, jcon_socketTCP_options_t *options);
+
+/**
+ * @brief Connects a new socket to the address of a client session.
+ * 
+ * Uses options and connect timeout of the session, but does
+ * not change it. So callers can connect without holding locks,
+ * that protect the session, and set the descriptor afterwards
+ * with @c #jcon_socketTCP_setConnection() .
+ * 
+ * @param session TCP client session.
+ * 
+ * @return        Descriptor of connected socket.
+ * @return        @c -1 , if connection failed or session is not TCP.
+ */
+int jcon_socketTCP_openConnection(jcon_socket_t *session);
+
+/**
+ * @brief Sets connected socket of a disconnected client session.
+ * 
+ * Session owns the descriptor afterwards. If an error
+ * occurs, the descriptor stays open.
+ * 
+ * @param session TCP client session.
+ * @param fd      Descriptor from @c #jcon_socketTCP_openConnection() .
+ * 
+ * @return        @c true , if descriptor was set.
+ * @return        @c false , if session is connected, not TCP or error occured.
+ */
+int jcon_socketTCP_setConnection(jcon_socket_t *session, int fd);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,45 @@
+/**
+ * @file jcon_socketUDP.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief UDP variant of jcon_socket.
+ * 
+ * Connecting sets the default destination, binding opens
+ * the address for recieving. Bound sockets stay clients, so
+ * datagrams are read with the client functions. Use
+ * @c #jcon_socket_recvBatch() and @c #jcon_socket_sendBatch()
+ * to move many datagrams per system call.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_SOCKETUDP_H
+#define INCLUDE_JCON_SOCKETUDP_H
+
+#include <jayc/jcon_socket.h>
+#include <jayc/jlog.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Simple initializer. Only essential information needed.
+ * 
+ * @param address IP/DNS address to send to or bind to.
+ * @param port    Port to send to or bind to.
+ * @param logger  Logger to use in session.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_socket_t *jcon_socketUDP_simple_init(const char *address, uint16_t port, jlog_t *logger);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_SOCKETUDP_H */
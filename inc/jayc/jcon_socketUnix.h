@@ -14,11 +14,19 @@
 
 #include <jayc/jcon_socket.h>
 #include <jayc/jlog.h>
+#include <stddef.h>
+#include <sys/types.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Maximum number of descriptors in one message
+ *        (limit of the kernel).
+ */
+#define JCON_SOCKETUNIX_FDS_MAX 253
+
 /**
  * @brief Simple initializer. Only essential information needed.
  * 
@@ -35,6 +43,107 @@ extern "C" {
  */
 jcon_socket_t *jcon_socketUnix_simple_init(const char *filepath, jlog_t *logger);
 
+/**
+ * @brief Initializer for sockets, that keep message boundaries.
+ * 
+ * @c SOCK_SEQPACKET sockets listen and accept like stream sockets.
+ * @c SOCK_DGRAM sockets have no connections, bound sockets stay
+ * clients and recieve on the file.
+ * Datagrams can be moved in batches with
+ * @c #jcon_socket_recvBatch() and @c #jcon_socket_sendBatch() .
+ * 
+ * @param filepath  Path to UDS file.
+ * @param type      @c SOCK_DGRAM or @c SOCK_SEQPACKET .
+ * @param logger    Logger to use in session.
+ * 
+ * @return          Session object.
+ * @return          @c NULL , if error occured.
+ */
+jcon_socket_t *jcon_socketUnix_datagram_init(const char *filepath, int type, jlog_t *logger);
+
+/**
+ * @brief Creates session from a bound socket.
+ * 
+ * For sockets inherited from another process
+ * (see jcon_handoff.h ). The socket is not bound again,
+ * so the file is kept and clients stay connected to it.
+ * Type and path are taken from the socket.
+ * Descriptor is set close-on-exec (listeners also
+ * non-blocking) and is owned by the session afterwards.
+ * If an error occurs, the descriptor stays open.
+ * 
+ * @param fd      Descriptor of listening stream or seqpacket
+ *                socket, or bound datagram socket.
+ * @param logger  Logger to use in session.
+ * 
+ * @return        Session object, that is open.
+ * @return        @c NULL , if descriptor is no bound
+ *                Unix socket or error occured.
+ */
+jcon_socket_t *jcon_socketUnix_adopt_init(int fd, jlog_t *logger);
+
+/**
+ * @brief Sends data together with descriptors ( @c SCM_RIGHTS ).
+ * 
+ * The peer gets own descriptors for the same files, f.ex.
+ * a @c memfd_create() region, so large payloads do not
+ * have to be copied through the socket. Descriptors of
+ * the caller stay open.
+ * 
+ * On stream sockets the descriptors arrive with the first
+ * byte of the data. If not all data was sent, the rest can
+ * be sent with @c #jcon_socket_sendData() .
+ * 
+ * @param session   Connected Unix session.
+ * @param data_ptr  Data to send.
+ * @param data_size Size of data, at least one byte.
+ * @param fds       Descriptors to pass.
+ * @param count     Number of descriptors
+ *                  (at most @c #JCON_SOCKETUNIX_FDS_MAX ).
+ * 
+ * @return          Number of bytes sent.
+ * @return          @c 0 , if error occured. Descriptors were not sent.
+ */
+size_t jcon_socketUnix_sendFds(jcon_socket_t *session, void *data_ptr, size_t data_size, const int fds[], size_t count);
+
+/**
+ * @brief Recieves data and passed descriptors.
+ * 
+ * Recieved descriptors are close-on-exec and owned by the caller.
+ * Descriptors, that do not fit into @c fds , are closed.
+ * A stream socket does not read past the data, descriptors
+ * were sent with, so they are recieved together.
+ * 
+ * @param session   Connected Unix session.
+ * @param data_ptr  Buffer for data.
+ * @param data_size Size of buffer.
+ * @param fds       Buffer for descriptors.
+ * @param max       Size of @c fds (at most @c #JCON_SOCKETUNIX_FDS_MAX ).
+ * @param count     Set to number of recieved descriptors.
+ * 
+ * @return          Number of bytes recieved.
+ * @return          @c 0 , if no data available, connection closed
+ *                  or error occured.
+ */
+size_t jcon_socketUnix_recvFds(jcon_socket_t *session, void *data_ptr, size_t data_size, int fds[], size_t max, size_t *count);
+
+/**
+ * @brief Returns credentials of peer process ( @c SO_PEERCRED ).
+ * 
+ * The kernel stores them at @c connect() , so peers can be
+ * authorized without exchanging messages.
+ * 
+ * @param session Connected Unix session.
+ * @param pid     Set to process id of peer, if not @c NULL .
+ * @param uid     Set to user id of peer, if not @c NULL .
+ * @param gid     Set to group id of peer, if not @c NULL .
+ * 
+ * @return        @c true , if credentials were read.
+ * @return        @c false , if session is not a connected
+ *                Unix session or error occured.
+ */
+int jcon_socketUnix_getPeerCredentials(jcon_socket_t *session, pid_t *pid, uid_t *uid, gid_t *gid);
+
 #ifdef __cplusplus
 }
 #endif
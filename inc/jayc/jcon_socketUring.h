@@ -0,0 +1,64 @@
+/**
+ * @file jcon_socketUring.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief TCP socket implementation based on io_uring.
+ * 
+ * Works like jcon_socketTCP, but accepts, recieves and sends
+ * through io_uring. Listeners keep one multishot accept armed
+ * and connections one multishot recieve, that fills buffers of
+ * a registered buffer ring. So while data keeps arriving, no
+ * system call is needed to recieve it.
+ * 
+ * @c #jcon_socket_getFileDescriptor() returns the descriptor
+ * of the ring, that becomes readable with new input. It does
+ * not report, if the socket can be written without blocking.
+ * 
+ * Only one thread at a time may recieve or accept,
+ * sends can be done from any thread.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JCON_SOCKETURING_H
+#define INCLUDE_JCON_SOCKETURING_H
+
+#include <jayc/jcon_socket.h>
+#include <jayc/jlog.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates session object.
+ * 
+ * The rings are created, when the socket gets connected
+ * or bound.
+ * 
+ * @param address Address to connect or bind to.
+ * @param port    Port to connect or bind to.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+jcon_socket_t *jcon_socketUring_simple_init(const char *address, uint16_t port, jlog_t *logger);
+
+/**
+ * @brief Checks, if the kernel supports the io_uring
+ *        features used by this implementation.
+ * 
+ * @return  @c true , if io_uring sockets can be used.
+ * @return  @c false , if not.
+ */
+int jcon_socketUring_isSupported(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCON_SOCKETURING_H */
@@ -14,6 +14,8 @@
 
 #include <jayc/jcon_socket.h>
 #include <jayc/jlog.h>
+#include <sys/types.h>
+#include <sys/uio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +44,12 @@ extern "C" {
  */
 #define JCON_SOCKET_CONNECTIONTYPE_SERVER 2
 
+/**
+ * @brief Size of buffer for reference string,
+ *        including terminating null byte.
+ */
+#define JCON_SOCKET_REFERENCESTRING_SIZE 128
+
 /**
  * @brief Handler function to connect socket.
  * 
@@ -55,6 +63,10 @@ typedef int(*jcon_socket_connect_handler_t)(jcon_socket_t *session);
 /**
  * @brief Handler function to bind socket.
  * 
+ * Datagram sockets set @c connection_type to
+ * @c #JCON_SOCKET_CONNECTIONTYPE_CLIENT , otherwise
+ * the session becomes a server.
+ * 
  * @param session Session to bind.
  * 
  * @return        @c true , if successfully bound.
@@ -79,6 +91,94 @@ typedef void(*jcon_socket_close_handler_t)(jcon_socket_t *session);
  */
 typedef jcon_socket_t *(*jcon_socket_accept_handler_t)(jcon_socket_t *session);
 
+/**
+ * @brief Handler function to enable or disable corking.
+ * 
+ * Optional. Sockets without support leave this @c NULL .
+ * 
+ * @param session Session to configure.
+ * @param enable  @c true to hold back partial frames,
+ *                @c false to flush and send immediately.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+typedef int(*jcon_socket_setCork_handler_t)(jcon_socket_t *session, int enable);
+
+/**
+ * @brief Handler function to recieve data into buffers.
+ * 
+ * Optional. If @c NULL , data is read from the socket descriptor.
+ * 
+ * @param session   Session to read from.
+ * @param iov       Array of buffers to fill.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Number of bytes read.
+ * @return          @c 0 , if peer closed the connection.
+ * @return          @c -1 , if error occured ( @c errno is set).
+ */
+typedef ssize_t(*jcon_socket_recv_handler_t)(jcon_socket_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Handler function to send data from buffers.
+ * 
+ * Optional. If @c NULL , data is sent with @c sendmsg() .
+ * 
+ * @param session   Session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * @param flags     Flags as for @c sendmsg()
+ *                  ( @c MSG_NOSIGNAL , @c MSG_DONTWAIT ).
+ * 
+ * @return          Number of bytes sent.
+ * @return          @c -1 , if error occured ( @c errno is set).
+ */
+typedef ssize_t(*jcon_socket_send_handler_t)(jcon_socket_t *session, const struct iovec *iov, int iov_count, int flags);
+
+/**
+ * @brief Handler function to wait for input.
+ * 
+ * Optional. If @c NULL , the socket descriptor is polled.
+ * 
+ * @param session Session to wait on.
+ * @param timeout Time to wait in milliseconds, @c -1 waits forever.
+ * 
+ * @return        @c true , if input is available.
+ * @return        @c false , if timed out or error occured.
+ */
+typedef int(*jcon_socket_poll_handler_t)(jcon_socket_t *session, int timeout);
+
+/**
+ * @brief Handler function to get descriptor for event loops.
+ * 
+ * Optional. If @c NULL , the socket descriptor is returned.
+ * Needed by implementations, that do not read from the
+ * socket descriptor directly.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Descriptor, that becomes readable with input.
+ * @return        @c -1 , if error occured.
+ */
+typedef int(*jcon_socket_getFileDescriptor_handler_t)(jcon_socket_t *session);
+
+/**
+ * @brief Handler function to format reference string.
+ * 
+ * Called once, when the reference string is needed first.
+ * Must not log with the session, because logging
+ * needs the reference string.
+ * 
+ * @param session Session to describe.
+ * @param buf     Buffer to write reference string to.
+ * @param size    Size of @c buf .
+ * 
+ * @return        @c true , if reference string was formatted.
+ * @return        @c false , if error occured.
+ */
+typedef int(*jcon_socket_formatReferenceString_handler_t)(jcon_socket_t *session, char *buf, size_t size);
+
 /**
  * @brief Handler function to free session memory.
  * 
@@ -100,13 +200,20 @@ struct __jcon_socket_session
                                                          * @c #JCON_SOCKET_CONNECTIONTYPE_SERVER . */
                                                       
   char *socket_type;                                /**< Tells what kind of socket it is. */
-  char *referenceString;                            /**< Holds information about connection. */
+  char referenceString[JCON_SOCKET_REFERENCESTRING_SIZE]; /**< Holds information about connection. Formatted on first use. */
+  int referenceString_state;                        /**< Tells, if @c #referenceString is formatted. Has to be @c 0 at creation. */
   jlog_t *logger;                                   /**< Logger to use for debug and error output. */
 
   jcon_socket_connect_handler_t function_connect;   /**< Handler to be called by @c #jcon_socket_connect() . */
   jcon_socket_bind_handler_t function_bind;         /**< Handler to be called by @c #jcon_socket_bind() . */
   jcon_socket_close_handler_t function_close;       /**< Handler to be called by @c #jcon_socket_close() . */
   jcon_socket_accept_handler_t function_accept;     /**< Handler to be called by @c #jcon_socket_accept() . */
+  jcon_socket_setCork_handler_t function_setCork;   /**< Handler to be called by @c #jcon_socket_setCork() . */
+  jcon_socket_recv_handler_t function_recv;         /**< Handler to be called by @c #jcon_socket_recvData() and @c #jcon_socket_recvDataV() . */
+  jcon_socket_send_handler_t function_send;         /**< Handler to be called by send functions. */
+  jcon_socket_poll_handler_t function_poll;         /**< Handler to be called by @c #jcon_socket_pollForInput() . */
+  jcon_socket_getFileDescriptor_handler_t function_getFileDescriptor; /**< Handler to be called by @c #jcon_socket_getFileDescriptor() . */
+  jcon_socket_formatReferenceString_handler_t function_formatReferenceString; /**< Handler to be called by @c #jcon_socket_getReferenceString() . */
   jcon_socket_free_handler_t session_free_handler;  /**< Handler to be called by @c #jcon_socket_free() . */
 
   void *session_ctx;                                /**< Session context used for implementations. */
@@ -30,6 +30,10 @@ typedef struct __jcon_system_session jcon_system_t;
 /**
  * @brief Function that handles available data.
  * 
+ * In all modes @c ctx is the context pointer given at
+ * initialization. Older versions passed @c NULL to the data
+ * handler of threaded systems ( @c #jcon_system_init() ).
+ * 
  * @param ctx     Context pointer provided by user.
  * @param client  jcon_client session, that has data available
  */
@@ -51,9 +55,59 @@ typedef void(*jcon_system_threadCreate_handler_t)(void *ctx, const char *ref_str
  */
 typedef void(*jcon_system_threadClose_handler_t)(void *ctx, const char *ref_string);
 
+/**
+ * @brief Handler for @c #jcon_system_findConnection() .
+ * 
+ * @param ctx     Context pointer provided by user.
+ * @param client  Client of found connection.
+ */
+typedef void(*jcon_system_connection_handler_t)(void *ctx, jcon_client_t *client);
+
+/**
+ * @brief Filter for @c #jcon_system_broadcast() .
+ * 
+ * @param ctx               Context pointer provided by user.
+ * @param reference_string  Reference string of connection.
+ * 
+ * @return                  @c true , if connection should get the data.
+ * @return                  @c false , if connection should be skipped.
+ */
+typedef int(*jcon_system_broadcastFilter_t)(void *ctx, const char *reference_string);
+
+/**
+ * @brief Function that handles full and drained send queues.
+ * 
+ * Can be called with the connection registry locked,
+ * so it must not call functions of the session.
+ * 
+ * @param ctx               Context pointer provided by user.
+ * @param reference_string  Reference string of connection.
+ * @param over              @c true , if queue reached high watermark
+ *                          and refuses data, @c false , if queue
+ *                          dropped to low watermark and accepts data again.
+ */
+typedef void(*jcon_system_watermark_handler_t)(void *ctx, const char *reference_string, int over);
+
+/**
+ * @brief Function that handles connections going idle and waking up.
+ * 
+ * Called by the thread of the loop, that handles the connection,
+ * never at the same time as the data handler of that connection.
+ * 
+ * @param ctx     Context pointer provided by user.
+ * @param client  Client of connection.
+ * @param idle    @c true , if connection hibernates and should release
+ *                its memory, @c false , if it recieved data again
+ *                (called before the data handler).
+ */
+typedef void(*jcon_system_idle_handler_t)(void *ctx, jcon_client_t *client, int idle);
+
 /**
  * @brief Initializes system and starts control thread.
  * 
+ * Every connection gets a jcon_thread, that calls
+ * @c data_handler with @c ctx , like the other modes.
+ * 
  * @param server          jcon_server session to use.
  * @param data_handler    Handler to manage new data.
  * @param create_handler  Handler gets called, when connection is created.
@@ -74,6 +128,122 @@ jcon_system_t *jcon_system_init
   void *ctx
 );
 
+/**
+ * @brief Initializes system in event loop mode and starts loop threads.
+ * 
+ * Instead of a thread per connection, all client sockets
+ * are multiplexed on @c loop_number event loops
+ * (see jcon_eventLoop.h ), each running in its own thread.
+ * The first loop also accepts new connections, which are
+ * distributed over the loops in round robin order.
+ * 
+ * @c data_handler only gets called, when the client has
+ * data available. Handlers are called from the loop threads
+ * and block all other connections of that loop while running.
+ * 
+ * Server and clients have to provide a file descriptor
+ * (see @c #jcon_server_getFileDescriptor() ).
+ * 
+ * @param server          jcon_server session to use.
+ * @param loop_number     Number of event loops (and threads) to use.
+ * @param data_handler    Handler to manage new data.
+ * @param create_handler  Handler gets called, when connection is created.
+ * @param close_handler   Handler gets called, when connection is closed.
+ * @param logger          Logger to print debug and error messages.
+ * @param ctx             Context pointer passed to handlers.
+ * 
+ * @return                jcon_system session object.
+ * @return                @c NULL , if error occured.
+ */
+jcon_system_t *jcon_system_eventLoop_init
+(
+  jcon_server_t *server,
+  size_t loop_number,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+);
+
+/**
+ * @brief Initializes system in event loop mode, where
+ *        every loop accepts connections itself.
+ * 
+ * Works like @c #jcon_system_eventLoop_init() , but every
+ * loop gets its own listener on the address of @c server
+ * (see @c #jcon_server_cloneListener() ). The kernel
+ * spreads incoming connections over the listeners and
+ * every connection stays on the loop, that accepted it.
+ * So accepting does not bottleneck on the first loop.
+ * 
+ * @c server has to support shared listeners
+ * (see @c #jcon_server_tcp_reusePort_init() ).
+ * 
+ * @param server          jcon_server session to use.
+ * @param loop_number     Number of event loops (and listeners) to use.
+ * @param data_handler    Handler to manage new data.
+ * @param create_handler  Handler gets called, when connection is created.
+ * @param close_handler   Handler gets called, when connection is closed.
+ * @param logger          Logger to print debug and error messages.
+ * @param ctx             Context pointer passed to handlers.
+ * 
+ * @return                jcon_system session object.
+ * @return                @c NULL , if error occured.
+ */
+jcon_system_t *jcon_system_multiAcceptor_init
+(
+  jcon_server_t *server,
+  size_t loop_number,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+);
+
+/**
+ * @brief Initializes system in event loop mode with a worker pool.
+ * 
+ * Works like @c #jcon_system_eventLoop_init() , but
+ * @c data_handler does not run on the loop threads.
+ * Readable connections get queued and are handled
+ * by @c worker_number worker threads, each pinned to a core.
+ * 
+ * A connection is only queued once at a time and not
+ * watched by its loop until the handler returns,
+ * so messages of a single client are never handled
+ * concurrently and keep their order.
+ * 
+ * If @c queue_depth connections are waiting, the loops
+ * wait for free space, which slows down reading from clients.
+ * 
+ * @param server          jcon_server session to use.
+ * @param loop_number     Number of event loops (and threads) to use.
+ * @param worker_number   Number of worker threads running @c data_handler .
+ * @param queue_depth     Maximum number of queued connections.
+ * @param data_handler    Handler to manage new data.
+ * @param create_handler  Handler gets called, when connection is created.
+ * @param close_handler   Handler gets called, when connection is closed.
+ * @param logger          Logger to print debug and error messages.
+ * @param ctx             Context pointer passed to handlers.
+ * 
+ * @return                jcon_system session object.
+ * @return                @c NULL , if error occured.
+ */
+jcon_system_t *jcon_system_workerPool_init
+(
+  jcon_server_t *server,
+  size_t loop_number,
+  size_t worker_number,
+  size_t queue_depth,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+);
+
 /**
  * @brief Stops everything and frees memory.
  * 
@@ -131,6 +301,9 @@ int jcon_system_control_isRunning(jcon_system_t *session);
 /**
  * @brief Get number of connections to server
  * 
+ * Does not lock the connection registry, so it can be
+ * called as often as needed.
+ * 
  * @param session Session to check.
  * 
  * @return        Number of connections.
@@ -139,6 +312,304 @@ int jcon_system_control_isRunning(jcon_system_t *session);
  */
 size_t jcon_system_getConnectionNumber(jcon_system_t *session);
 
+/**
+ * @brief Finds connection by reference string of its client.
+ * 
+ * Lookup does not scan all connections. If found,
+ * @c handler gets called with the client, while the
+ * connection can not be removed. The handler runs in the
+ * thread of the caller and blocks accepting and removing
+ * connections, so it should return quickly.
+ * 
+ * @param session           Session to search.
+ * @param reference_string  Reference string of client
+ *                          (see @c #jcon_client_getReferenceString() ).
+ * @param handler           Handler to call with client. Can be @c NULL ,
+ *                          to only check existence.
+ * @param ctx               Context pointer passed to handler.
+ * 
+ * @return                  @c true , if connection was found.
+ * @return                  @c false , if not found or error occured.
+ */
+int jcon_system_findConnection(jcon_system_t *session, const char *reference_string, jcon_system_connection_handler_t handler, void *ctx);
+
+/**
+ * @brief Sends data to all connections.
+ * 
+ * The data is copied once into a @c #jutil_buffer_t ,
+ * that is shared by the send queues of all connections.
+ * The call does not wait for any client. Queues are sent
+ * without blocking, by the event loops when the socket
+ * is writable, or by the control thread in threaded mode.
+ * The buffer is freed, when the last connection sent it
+ * or closed. Connections, whose queue is over the high
+ * watermark (see @c #jcon_system_setSendLimits() ), are skipped.
+ * 
+ * Queued data is not ordered with data sent directly
+ * through the client, so a connection should either use
+ * broadcasts or direct sends for a message stream.
+ * Messages do not interleave with direct sends of the data
+ * handler. In threaded mode the control thread skips connections,
+ * whose thread runs the handler (see @c #jcon_system_send() ).
+ * 
+ * The filter is called with the connection registry locked,
+ * so it must not call other functions of the session.
+ * 
+ * @param session   Session to broadcast with.
+ * @param data_ptr  Data to send.
+ * @param data_size Size of data in bytes.
+ * @param filter    Filter to select connections.
+ *                  If @c NULL , all connections get the data.
+ * @param ctx       Context pointer passed to filter.
+ * 
+ * @return          Number of connections, the data was queued for.
+ * @return          @c 0 , if no connection matched or error occured.
+ */
+size_t jcon_system_broadcast(jcon_system_t *session, const void *data_ptr, size_t data_size, jcon_system_broadcastFilter_t filter, void *ctx);
+
+/**
+ * @brief Sends buffer to all connections without copy.
+ * 
+ * Works like @c #jcon_system_broadcast() , but the send
+ * queues reference the segments of the buffer. The
+ * buffer must not be changed afterwards and is released
+ * by the caller, the queues hold their own references.
+ * 
+ * @param session Session to broadcast with.
+ * @param buffer  Data to send.
+ * @param filter  Filter to select connections.
+ *                If @c NULL , all connections get the data.
+ * @param ctx     Context pointer passed to filter.
+ * 
+ * @return        Number of connections, the data was queued for.
+ * @return        @c 0 , if no connection matched or error occured.
+ */
+size_t jcon_system_broadcastBuffer(jcon_system_t *session, jutil_buffer_t *buffer, jcon_system_broadcastFilter_t filter, void *ctx);
+
+/**
+ * @brief Queues data for one connection.
+ * 
+ * Works like @c #jcon_system_broadcast() for a single
+ * connection. Unlike @c #jcon_client_sendData() , it never
+ * blocks and does not lose data on short writes.
+ * 
+ * In threaded mode the control thread sends the queue, but
+ * never while the thread of the connection runs the data
+ * handler. A partially sent entry is finished, before the
+ * handler is called. So data, that the handler sends directly,
+ * does not interleave with queued data.
+ * 
+ * @param session           Session to send with.
+ * @param reference_string  Reference string of connection.
+ * @param data_ptr          Data to send.
+ * @param data_size         Size of data in bytes.
+ * 
+ * @return                  @c true , if data was queued.
+ * @return                  @c false , if connection was not found,
+ *                          its queue is over high watermark
+ *                          or error occured.
+ */
+int jcon_system_send(jcon_system_t *session, const char *reference_string, const void *data_ptr, size_t data_size);
+
+/**
+ * @brief Queues buffer for one connection without copy.
+ * 
+ * Works like @c #jcon_system_broadcastBuffer() for a
+ * single connection.
+ * 
+ * @param session           Session to send with.
+ * @param reference_string  Reference string of connection.
+ * @param buffer            Data to send.
+ * 
+ * @return                  @c true , if data was queued.
+ * @return                  @c false , if connection was not found,
+ *                          its queue is over high watermark
+ *                          or error occured.
+ */
+int jcon_system_sendBuffer(jcon_system_t *session, const char *reference_string, jutil_buffer_t *buffer);
+
+/**
+ * @brief Sets bounds of send queues.
+ * 
+ * When a queue reaches @c high_watermark bytes, it refuses
+ * data and the watermark handler is called, so producers can
+ * back off. Once it was sent down to @c low_watermark bytes,
+ * it accepts data again and the handler is called again.
+ * 
+ * Connections, that stay over the high watermark for
+ * @c evict_timeout milliseconds, are closed. The check runs
+ * on every loop execution, so connections can stay longer
+ * by up to a loop timeout.
+ * 
+ * Defaults are 4 MiB and 1 MiB, without eviction.
+ * 
+ * @param session         Session to configure.
+ * @param high_watermark  Queue size in bytes, at which data is refused.
+ *                        @c 0 for unbounded queues.
+ * @param low_watermark   Queue size in bytes, at which data is accepted again.
+ * @param evict_timeout   Milliseconds a connection may stay over high watermark.
+ *                        @c 0 never closes slow connections.
+ * 
+ * @return                @c true , if limits were set.
+ * @return                @c false , if error occured.
+ */
+int jcon_system_setSendLimits(jcon_system_t *session, size_t high_watermark, size_t low_watermark, long evict_timeout);
+
+/**
+ * @brief Sets handler, that is called when a send queue
+ *        crosses a watermark.
+ * 
+ * Handler gets the context pointer of the session.
+ * 
+ * @param session Session to configure.
+ * @param handler Handler to call. @c NULL to disable.
+ * 
+ * @return        @c true , if handler was set.
+ * @return        @c false , if error occured.
+ */
+int jcon_system_setWatermarkHandler(jcon_system_t *session, jcon_system_watermark_handler_t handler);
+
+/**
+ * @brief Sets time, after which idle connections hibernate.
+ * 
+ * Connections, that did not recieve data for @c idle_timeout
+ * milliseconds and have nothing queued to send, hibernate.
+ * The handler is called, so buffers kept for the
+ * connection (for example by @c #jcon_frame_trim() ) can be
+ * released. The connection then only holds its descriptor
+ * in the event loop and its records. When data arrives,
+ * the handler is called again before the data handler.
+ * 
+ * Each loop checks its connections about once a second,
+ * so connections can hibernate up to a second late.
+ * 
+ * Only for event loop modes, in threaded mode every
+ * connection keeps its thread.
+ * 
+ * @param session       Session to configure.
+ * @param idle_timeout  Milliseconds without data, after which connections hibernate.
+ *                      @c 0 to disable.
+ * @param handler       Handler to call. @c NULL , if nothing has to be released.
+ * 
+ * @return              @c true , if timeout was set.
+ * @return              @c false , if error occured.
+ */
+int jcon_system_setIdleTimeout(jcon_system_t *session, long idle_timeout, jcon_system_idle_handler_t handler);
+
+/**
+ * @brief Get number of hibernated connections.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of connections.
+ * @return        @c 0 , if none hibernate or error occured.
+ */
+size_t jcon_system_getHibernatedNumber(jcon_system_t *session);
+
+/**
+ * @brief Sets maximum number of connections accepted per wakeup.
+ * 
+ * Pending connections are accepted until the backlog is
+ * empty or @c batch connections were accepted. The rest
+ * is accepted at the next wakeup.
+ * 
+ * @param session Session to configure.
+ * @param batch   Maximum number of connections per wakeup.
+ * 
+ * @return        @c true , if batch size was set.
+ * @return        @c false , if @c batch is @c 0 or error occured.
+ */
+int jcon_system_setAcceptBatch(jcon_system_t *session, size_t batch);
+
+/**
+ * @brief Sets number of connection records kept for reuse.
+ * 
+ * Records of closed connections are put into a pool
+ * instead of being freed, so accepting new connections
+ * does not need to allocate them. The pool is filled up
+ * to @c size records right away, so a burst of connections
+ * can be accepted without allocating. Surplus records are freed.
+ * 
+ * @param session Session to configure.
+ * @param size    Number of records to keep. @c 0 disables pooling.
+ * 
+ * @return        @c true , if pool size was set.
+ * @return        @c false , if error occured.
+ */
+int jcon_system_setPoolSize(jcon_system_t *session, size_t size);
+
+/**
+ * @brief Get number of connections accepted at the last
+ *        wakeup of the control thread (or an accepting loop).
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of accepted connections.
+ * @return        @c 0 , if none were accepted or error occured.
+ */
+size_t jcon_system_getAcceptedLast(jcon_system_t *session);
+
+/**
+ * @brief Get number of closed connections freed at the
+ *        last cleanup of the control thread.
+ * 
+ * Only used in threaded mode. Event loops free
+ * connections as soon as they close.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Number of freed connections.
+ * @return        @c 0 , if none were freed or error occured.
+ */
+size_t jcon_system_getCleanedLast(jcon_system_t *session);
+
+/**
+ * @brief Stops accepting new connections.
+ * 
+ * Listening sockets are closed, so new clients are refused
+ * and can connect to another instance. Open connections
+ * keep being handled. Server can be reopened with
+ * @c #jcon_server_reset() , but the system does not accept
+ * again.
+ * 
+ * @param session Session to stop.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+int jcon_system_stopAccepting(jcon_system_t *session);
+
+/**
+ * @brief Stops accepting and waits for connections to close.
+ * 
+ * Open connections keep being handled, until their peers
+ * disconnect. Connections, that are still open after
+ * @c timeout , are closed by @c #jcon_system_free() .
+ * 
+ * @param session Session to drain.
+ * @param timeout Maximum time to wait in milliseconds.
+ *                Negative to wait without limit.
+ * 
+ * @return        @c true , if all connections closed in time.
+ * @return        @c false , if connections are left or error occured.
+ */
+int jcon_system_drain(jcon_system_t *session, long timeout);
+
+/**
+ * @brief Registers session with shutdown of @c #jproc_exit() .
+ * 
+ * Session stops accepting in @c #JPROC_EXIT_PHASE_ACCEPT and
+ * drains its connections until the shutdown deadline in
+ * @c #JPROC_EXIT_PHASE_DRAIN . Handlers are removed by
+ * @c #jcon_system_free() .
+ * 
+ * @param session Session to register.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+int jcon_system_addShutdownHandlers(jcon_system_t *session);
+
 #ifdef __cplusplus
 }
 #endif
@@ -76,6 +76,40 @@ typedef struct __jcon_thread_session jcon_thread_t;
 
 
 
+/**
+ * @brief Thread sleeps between polls of the client.
+ * 
+ * Used by default, if the client does not support
+ * poll timeouts.
+ */
+#define JCON_THREAD_WAITMODE_SLEEP 0
+
+/**
+ * @brief Poll of the client is the only wait.
+ * 
+ * Thread blocks in @c #jcon_client_newData() for the poll
+ * timeout of the client (see @c #jcon_client_setPollTimeout() )
+ * and handles data as soon as it arrives.
+ */
+#define JCON_THREAD_WAITMODE_POLL 1
+
+/**
+ * @brief Thread adapts poll timeout of the client to traffic (default).
+ * 
+ * After data arrived, the thread polls without timeout for
+ * a short spin time. Then every empty poll doubles the timeout,
+ * from 1 ms up to a maximum (100 ms by default). Busy connections
+ * are handled without delay, idle ones wake up rarely.
+ * 
+ * The thread sets the poll timeout of the client. Leaving the
+ * mode sets it back to 10 ms.
+ * 
+ * @see @c #jcon_thread_setAdaptivePolling()
+ */
+#define JCON_THREAD_WAITMODE_ADAPTIVE 2
+
+
+
 //==============================================================================
 // Define handler types.
 //
@@ -162,6 +196,9 @@ void jcon_thread_free(jcon_thread_t *session);
 /**
  * @brief Checks if thread is still running.
  * 
+ * Joins the thread, if it stopped by itself
+ * (for example after client disconnect).
+ * 
  * @param session Session to check.
  * @return        @c true , if thread is running.
  * @return        @c false , if thread is not running.
@@ -188,6 +225,39 @@ const char *jcon_thread_getConnectionType(jcon_thread_t *session);
  */
 const char *jcon_thread_getReferenceString(jcon_thread_t *session);
 
+/**
+ * @brief Sets how thread waits for new data.
+ * 
+ * With @c #JCON_THREAD_WAITMODE_POLL stopping the thread
+ * takes up to one poll timeout of the client.
+ * 
+ * @param session Session to configure.
+ * @param mode    Wait mode ( @c #JCON_THREAD_WAITMODE_SLEEP ,
+ *                @c #JCON_THREAD_WAITMODE_POLL ,
+ *                @c #JCON_THREAD_WAITMODE_ADAPTIVE ).
+ * 
+ * @return        @c true , if mode was set.
+ * @return        @c false , if client does not support mode
+ *                or error occured.
+ */
+int jcon_thread_setWaitMode(jcon_thread_t *session, int mode);
+
+/**
+ * @brief Configures @c #JCON_THREAD_WAITMODE_ADAPTIVE .
+ * 
+ * Stopping the thread takes up to @c park_max .
+ * 
+ * @param session   Session to configure.
+ * @param spin_us   Time to poll without timeout after data
+ *                  in microseconds (default @c 50 ).
+ * @param park_max  Longest poll timeout in milliseconds
+ *                  (default @c 100 ).
+ * 
+ * @return          @c true , if values were set.
+ * @return          @c false , if values are invalid or error occured.
+ */
+int jcon_thread_setAdaptivePolling(jcon_thread_t *session, long spin_us, int park_max);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,6 +17,9 @@
 #ifndef INCLUDE_JCONFIG_H
 #define INCLUDE_JCONFIG_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,6 +34,37 @@ typedef struct __jconfig_table jconfig_t;
  */
 typedef void jconfig_iterator_t;
 
+/**
+ * @brief Key was added by reload.
+ */
+#define JCONFIG_CHANGE_ADDED   0
+
+/**
+ * @brief Value of key was changed by reload.
+ */
+#define JCONFIG_CHANGE_CHANGED 1
+
+/**
+ * @brief Key was removed by reload.
+ */
+#define JCONFIG_CHANGE_REMOVED 2
+
+/**
+ * @brief Handler, that is called for each key changed by reload.
+ * 
+ * Table already contains new content. Handler must not
+ * modify table.
+ * 
+ * @param ctx       Context pointer provided by user.
+ * @param table     Reloaded table.
+ * @param change    @c #JCONFIG_CHANGE_ADDED , @c #JCONFIG_CHANGE_CHANGED
+ *                  or @c #JCONFIG_CHANGE_REMOVED .
+ * @param key       Changed key.
+ * @param old_value Previous value ( @c NULL , if added).
+ * @param new_value New value ( @c NULL , if removed).
+ */
+typedef void(*jconfig_watcher_handler_t)(void *ctx, jconfig_t *table, int change, const char *key, const char *old_value, const char *new_value);
+
 /**
  * @brief Initializes config object.
  * 
@@ -68,6 +102,93 @@ int jconfig_datapoint_delete(jconfig_t *table, const char *key);
  */
 const char *jconfig_datapoint_get(jconfig_t *table, const char *key);
 
+/**
+ * @brief Returns data stored in key as integer.
+ * 
+ * Value has to be a decimal number. Parsed value
+ * is cached, until datapoint is set again.
+ * 
+ * @param table Table to get data from.
+ * @param key   Key to search for.
+ * @param value Returns integer.
+ * 
+ * @return      @c true , if value was returned.
+ * @return      @c false , if key not found, value is
+ *              no integer or error occured.
+ */
+int jconfig_datapoint_getInt64(jconfig_t *table, const char *key, int64_t *value);
+
+/**
+ * @brief Returns data stored in key as floating point number.
+ * 
+ * Parsed value is cached, until datapoint is set again.
+ * 
+ * @param table Table to get data from.
+ * @param key   Key to search for.
+ * @param value Returns number.
+ * 
+ * @return      @c true , if value was returned.
+ * @return      @c false , if key not found, value is
+ *              no number or error occured.
+ */
+int jconfig_datapoint_getDouble(jconfig_t *table, const char *key, double *value);
+
+/**
+ * @brief Returns data stored in key as boolean.
+ * 
+ * Accepts "true", "yes", "on", "1" and "false", "no",
+ * "off", "0" (case is ignored). Parsed value is cached,
+ * until datapoint is set again.
+ * 
+ * @param table Table to get data from.
+ * @param key   Key to search for.
+ * @param value Returns @c true or @c false .
+ * 
+ * @return      @c true , if value was returned.
+ * @return      @c false , if key not found, value is
+ *              no boolean or error occured.
+ */
+int jconfig_datapoint_getBool(jconfig_t *table, const char *key, int *value);
+
+/**
+ * @brief Returns data stored in key as duration.
+ * 
+ * Value is a non-negative number with optional unit
+ * "ns", "us", "ms", "s", "m", "h" or "d" (for example
+ * "1.5s" or "250 ms"). Without unit, seconds are used.
+ * Integers are exact, fractions are rounded to nanoseconds.
+ * Parsed value is cached, until datapoint is set again.
+ * 
+ * @param table       Table to get data from.
+ * @param key         Key to search for.
+ * @param nanoseconds Returns duration in nanoseconds.
+ * 
+ * @return            @c true , if value was returned.
+ * @return            @c false , if key not found, value is
+ *                    no duration or error occured.
+ */
+int jconfig_datapoint_getDuration(jconfig_t *table, const char *key, int64_t *nanoseconds);
+
+/**
+ * @brief Returns data stored in key as size.
+ * 
+ * Value is a non-negative number with optional unit
+ * "B", "k", "M", "G", "T" or "KiB", "MiB", "GiB", "TiB"
+ * for powers of 1024 and "kB", "MB", "GB", "TB" for powers
+ * of 1000 (case is ignored). Without unit, bytes are used.
+ * Integers are exact up to 2^64 - 1 bytes, fractions are rounded.
+ * Parsed value is cached, until datapoint is set again.
+ * 
+ * @param table Table to get data from.
+ * @param key   Key to search for.
+ * @param bytes Returns size in bytes.
+ * 
+ * @return      @c true , if value was returned.
+ * @return      @c false , if key not found, value is
+ *              no size or error occured.
+ */
+int jconfig_datapoint_getSize(jconfig_t *table, const char *key, uint64_t *bytes);
+
 /**
  * @brief Sets data at key in config table.
  * 
@@ -82,6 +203,47 @@ const char *jconfig_datapoint_get(jconfig_t *table, const char *key);
  */
 int jconfig_datapoint_set(jconfig_t *table, const char *key, const char *value);
 
+/**
+ * @brief Starts batch of mutations.
+ * 
+ * Makes room for @c expected new keys at once. Values set with
+ * @c #jconfig_batch_set() are stored in one block of memory of
+ * the table (like loaded files), instead of one allocation per
+ * value. Memory of overwritten batch values is only freed, when
+ * the table is cleared.
+ * 
+ * @param table     Config table object.
+ * @param expected  Expected number of new keys. Can be @c 0 .
+ * 
+ * @return          @c true , if batch started.
+ * @return          @c false , if batch is running or error occured.
+ */
+int jconfig_batch_begin(jconfig_t *table, size_t expected);
+
+/**
+ * @brief Sets data at key during batch.
+ * 
+ * Works like @c #jconfig_datapoint_set() . Other functions
+ * of the table can be used during batch.
+ * 
+ * @param table Config table object.
+ * @param key   Key to set.
+ * @param value Value to set key to.
+ * 
+ * @return      @c true , if key was set/created.
+ * @return      @c false , if no batch is running or error occured.
+ */
+int jconfig_batch_set(jconfig_t *table, const char *key, const char *value);
+
+/**
+ * @brief Ends batch of mutations.
+ * 
+ * @param table Config table object.
+ * 
+ * @return      Number of keys set in batch.
+ */
+size_t jconfig_batch_commit(jconfig_t *table);
+
 /**
  * @brief Clears content from config.
  * 
@@ -92,6 +254,9 @@ void jconfig_clear(jconfig_t *table);
 /**
  * @brief Iterates through all available datapoints.
  * 
+ * Datapoints are returned in byte order of their keys.
+ * With prefix, only matching datapoints are visited.
+ * 
  * @param table   Config table to iterate.
  * @param prefix  Only search for keys that start with prefix
  *                (used for hierachrcal keys).
@@ -124,6 +289,55 @@ const char *jconfig_itr_getKey(jconfig_iterator_t *itr);
  */
 const char *jconfig_itr_getData(jconfig_iterator_t *itr);
 
+/**
+ * @brief Registers handler, that is notified about reloads.
+ * 
+ * @param table   Config table to watch.
+ * @param prefix  Only keys starting with prefix are reported.
+ *                All keys, if @c NULL or @c "" .
+ * @param handler Handler to call for each changed key.
+ * @param ctx     Context pointer for handler.
+ * 
+ * @return        @c true , if handler was registered.
+ * @return        @c false , if error occured.
+ */
+int jconfig_watcher_add(jconfig_t *table, const char *prefix, jconfig_watcher_handler_t handler, void *ctx);
+
+/**
+ * @brief Removes handler registered with @c #jconfig_watcher_add() .
+ * 
+ * @param table   Config table.
+ * @param handler Registered handler.
+ * @param ctx     Context pointer, handler was registered with.
+ * 
+ * @return        @c true , if handler was removed.
+ * @return        @c false , if handler was not found or error occured.
+ */
+int jconfig_watcher_remove(jconfig_t *table, jconfig_watcher_handler_t handler, void *ctx);
+
+/**
+ * @brief Replaces content of table with content of another table.
+ * 
+ * Content is swapped in at once, table is never empty
+ * or partly loaded. Afterwards watchers are called for
+ * each added, changed and removed key, in key order.
+ * Iterators of table are invalid afterwards.
+ * 
+ * Used to reload config: New content is loaded into
+ * @c source first, if that fails, table is unchanged.
+ * 
+ * <b>Note:</b>
+ * Tables are not thread safe. Other threads can not
+ * use table during reload.
+ * 
+ * @param table   Config table to update.
+ * @param source  Table with new content. Is empty afterwards.
+ * 
+ * @return        @c true , if content was replaced.
+ * @return        @c false , if error occured.
+ */
+int jconfig_reload(jconfig_t *table, jconfig_t *source);
+
 /**
  * @brief Saves config as raw key-value pair.
  * 
@@ -154,6 +368,14 @@ int jconfig_raw_saveToFile(jconfig_t *table, const char *filename);
  * "server.address.ip=127.0.0.1\n"
  * "server.address.port=1234\n"
  * 
+ * Keys and values can have any length. Lines without
+ * @c '=' are stored with empty value, empty lines and
+ * lines without key are ignored. Content of table is
+ * replaced.
+ * 
+ * The file is mapped and parsed in one pass, values are
+ * kept in one block of memory.
+ * 
  * @param table     Config table to load.
  * @param filename  Path of file to load from.
  * 
@@ -162,6 +384,38 @@ int jconfig_raw_saveToFile(jconfig_t *table, const char *filename);
  */
 int jconfig_raw_loadFromFile(jconfig_t *table, const char *filename);
 
+/**
+ * @brief Merges raw file into config.
+ * 
+ * Works like @c #jconfig_raw_loadFromFile() , but keeps
+ * content of table. Keys of file overwrite existing keys.
+ * Runs as one batch (or as part of the running batch),
+ * room for all lines is made at once.
+ * 
+ * @param table     Config table to import into.
+ * @param filename  Path of file to import.
+ * 
+ * @return          Number of keys added to table.
+ * @return          @c -1 , if error occured.
+ */
+long jconfig_raw_importFromFile(jconfig_t *table, const char *filename);
+
+/**
+ * @brief Reloads config from raw file.
+ * 
+ * File is loaded into separate table and swapped in
+ * with @c #jconfig_reload() , so watchers are notified
+ * about changes. If file can not be loaded, table is
+ * unchanged.
+ * 
+ * @param table     Config table to reload.
+ * @param filename  Path of file to load from.
+ * 
+ * @return          @c true , if reloaded successfully.
+ * @return          @c false , if error occured.
+ */
+int jconfig_raw_reloadFromFile(jconfig_t *table, const char *filename);
+
 #ifdef __cplusplus
 }
 #endif
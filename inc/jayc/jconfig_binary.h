@@ -0,0 +1,148 @@
+/**
+ * @file jconfig_binary.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Binary file format for jconfig.
+ * 
+ * Binary files contain a header, an index of all keys
+ * sorted in byte order and a table of key and value
+ * strings. They are written by @c #jconfig_binary_saveToFile() .
+ * 
+ * A file can be loaded into a config table with
+ * @c #jconfig_binary_loadFromFile() , or opened with
+ * @c #jconfig_binary_open() . Opened files are mapped into
+ * memory and searched directly, without parsing all
+ * datapoints first.
+ * 
+ * Numbers are stored in byte order of the host. Files
+ * written on hosts with other byte order are rejected.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jconfig.h
+ * 
+ */
+
+#ifndef INCLUDE_JCONFIG_BINARY_H
+#define INCLUDE_JCONFIG_BINARY_H
+
+#include <jayc/jconfig.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of file format, written by this library.
+ */
+#define JCONFIG_BINARY_VERSION 1
+
+/**
+ * @brief Opened binary config file.
+ */
+typedef struct __jconfig_binary jconfig_binary_t;
+
+/**
+ * @brief Saves config as binary file.
+ * 
+ * File is written to a temporary file first and
+ * then renamed, so processes, that have the old
+ * file opened, are not affected.
+ * 
+ * @param table     Config table to save.
+ * @param filename  Path of file to save.
+ * 
+ * @return          @c true , if saved successfully.
+ * @return          @c false , if error occured.
+ */
+int jconfig_binary_saveToFile(jconfig_t *table, const char *filename);
+
+/**
+ * @brief Loads binary file into config table.
+ * 
+ * Checksum of file is verified. Content of
+ * table is replaced.
+ * 
+ * @param table     Config table to load.
+ * @param filename  Path of file to load from.
+ * 
+ * @return          @c true , if loaded successfully.
+ * @return          @c false , if file is invalid or error occured.
+ */
+int jconfig_binary_loadFromFile(jconfig_t *table, const char *filename);
+
+/**
+ * @brief Reloads config from binary file.
+ * 
+ * File is loaded into separate table and swapped in
+ * with @c #jconfig_reload() , so watchers are notified
+ * about changes. If file can not be loaded, table is
+ * unchanged.
+ * 
+ * @param table     Config table to reload.
+ * @param filename  Path of file to load from.
+ * 
+ * @return          @c true , if reloaded successfully.
+ * @return          @c false , if file is invalid or error occured.
+ */
+int jconfig_binary_reloadFromFile(jconfig_t *table, const char *filename);
+
+/**
+ * @brief Opens binary file for direct lookups.
+ * 
+ * Only header and size of file are checked, unless
+ * @c verify is set. Then the whole file is read once
+ * to check the checksum.
+ * 
+ * Lookups check every entry they use, so damaged files
+ * return wrong or no data, but are never read out of bounds.
+ * 
+ * @param filename  Path of file to open.
+ * @param verify    @c true , if checksum should be verified.
+ * 
+ * @return          Binary file object.
+ * @return          @c NULL , if file is invalid or error occured.
+ */
+jconfig_binary_t *jconfig_binary_open(const char *filename, int verify);
+
+/**
+ * @brief Closes binary file.
+ * 
+ * Strings returned by @c #jconfig_binary_get() are
+ * invalid afterwards.
+ * 
+ * @param binary File object to close.
+ */
+void jconfig_binary_close(jconfig_binary_t *binary);
+
+/**
+ * @brief Returns data stored in key.
+ * 
+ * Key is searched in sorted index with
+ * binary search.
+ * 
+ * @param binary  File object to search.
+ * @param key     Key to search for.
+ * 
+ * @return        Data string.
+ * @return        @c NULL , if key not found or error occured.
+ */
+const char *jconfig_binary_get(jconfig_binary_t *binary, const char *key);
+
+/**
+ * @brief Returns number of datapoints in file.
+ * 
+ * @param binary File object.
+ * 
+ * @return       Number of datapoints.
+ * @return       @c 0 , if file is empty or error occured.
+ */
+size_t jconfig_binary_size(jconfig_binary_t *binary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCONFIG_BINARY_H */
@@ -16,12 +16,72 @@
 #ifndef INCLUDE_JCONFIG_DEV_H
 #define INCLUDE_JCONFIG_DEV_H
 
+#include <jayc/jconfig.h>
 #include <jayc/jutil_map.h>
+#include <jayc/jutil_arena.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*
+ * Types, values of datapoints are parsed as.
+ */
+#define JCONFIG_TYPE_NONE     0
+#define JCONFIG_TYPE_INT64    1
+#define JCONFIG_TYPE_DOUBLE   2
+#define JCONFIG_TYPE_BOOL     3
+#define JCONFIG_TYPE_DURATION 4
+#define JCONFIG_TYPE_SIZE     5
+
+/**
+ * @brief Parsed value of datapoint.
+ */
+typedef union __jconfig_value
+{
+  int64_t integer;  /**< Integer, boolean or duration in nanoseconds. */
+  uint64_t size;    /**< Size in bytes. */
+  double real;      /**< Floating point number. */
+} jconfig_value_t;
+
+/**
+ * @brief Datapoint stored in config table.
+ * 
+ * Datapoints are linked in order of their keys.
+ * Iterators of @c #jconfig_iterate() point to datapoints.
+ */
+typedef struct __jconfig_datapoint
+{
+  struct __jconfig_datapoint *prev;   /**< Datapoint with previous key. */
+  struct __jconfig_datapoint *next;   /**< Datapoint with next key. */
+  char *data;                         /**< Value string. */
+  int data_allocated;                 /**< @c true , if @c data has to be freed. Else is stored in arena. */
+  int cache_type;                     /**< Type @c data was last parsed as. Reset, when data changes. */
+  int cache_valid;                    /**< @c true , if @c data could be parsed as @c cache_type . */
+  jconfig_value_t cache;              /**< Parsed value of @c data . */
+  size_t key_length;                  /**< Length of @c key . */
+  char key[];                         /**< Key string. */
+} jconfig_datapoint_t;
+
+/**
+ * @brief Registered reload handler.
+ */
+typedef struct __jconfig_watcher
+{
+  struct __jconfig_watcher *next;     /**< Next watcher of table. */
+  jconfig_watcher_handler_t handler;  /**< Handler to call. */
+  void *ctx;                          /**< Context pointer for handler. */
+  size_t prefix_length;               /**< Length of @c prefix . */
+  char prefix[];                      /**< Keys to report. */
+} jconfig_watcher_t;
+
+/**
+ * @brief Published versions of table (see jconfig_snapshot.h).
+ */
+typedef struct __jconfig_snapshot_state jconfig_snapshot_state_t;
+
 /**
  * @brief Config object.
  */
@@ -32,9 +92,113 @@ struct __jconfig_table
      nested data. This should make it compatible with most config file
      formats. */
   
-  jutil_map_t *map; /**< Config data table. */
+  jutil_map_t *map;             /**< Datapoints by key. */
+  void *index;                  /**< Prefix tree over keys, for ordered and prefix iteration. */
+  jconfig_datapoint_t *first;   /**< Datapoint with lowest key. */
+  jutil_arena_t *arena;         /**< Strings of loaded files. Reset, when table is cleared. */
+  jconfig_watcher_t *watchers;  /**< Handlers notified about reloads. */
+  int batch;                    /**< @c true , between @c #jconfig_batch_begin() and @c #jconfig_batch_commit() . */
+  size_t batch_count;           /**< Number of keys set in batch. */
+  jconfig_snapshot_state_t *snapshots; /**< @c NULL , if snapshots are not enabled. */
 };
 
+/**
+ * @brief Stores data for key.
+ * 
+ * Overwrites data of existing datapoint or creates new one.
+ * Used by file formats, to store values, that are kept
+ * in an arena of the table, without copying them.
+ * 
+ * @param table          Config table.
+ * @param key            Key string.
+ * @param key_length     Length of key.
+ * @param data           Value string. Owned by datapoint on success.
+ * @param data_allocated @c true , if data has to be freed with datapoint.
+ * 
+ * @return               @c true , if data was stored.
+ * @return               @c false , if error occured. Caller still owns data.
+ */
+int jconfig_datapoint_put(jconfig_t *table, const char *key, size_t key_length, char *data, int data_allocated);
+
+/**
+ * @brief Removes all datapoints.
+ * 
+ * Works like @c #jconfig_clear() , but does not publish
+ * a snapshot. Used by file formats, that replace the
+ * content of the table and publish, when done.
+ * 
+ * @param table Config table.
+ */
+void jconfig_datapoint_clear(jconfig_t *table);
+
+/**
+ * @brief Parses value string.
+ * 
+ * Whitespace around value is ignored.
+ * 
+ * @param data  Value string.
+ * @param type  @c JCONFIG_TYPE_* constant.
+ * @param value Returns parsed value.
+ * 
+ * @return      @c true , if data was parsed.
+ * @return      @c false , if data is invalid for type.
+ */
+int jconfig_value_parse(const char *data, int type, jconfig_value_t *value);
+
+/**
+ * @brief Calls watchers of table, whose prefix matches key.
+ * 
+ * Used by @c #jconfig_reload() and by code, that applies
+ * changes from other sources key by key.
+ * 
+ * @param table       Config table.
+ * @param change      @c JCONFIG_CHANGE_* constant.
+ * @param key         Changed key.
+ * @param key_length  Length of key.
+ * @param old_value   Previous value ( @c NULL , if added).
+ * @param new_value   New value ( @c NULL , if removed).
+ */
+void jconfig_watcher_notify(jconfig_t *table, int change, const char *key, size_t key_length, const char *old_value, const char *new_value);
+
+/**
+ * @brief Stores data for key in next snapshot.
+ * 
+ * Called for every change of a table with snapshots.
+ * Errors are remembered and the next snapshot is
+ * built from the whole table.
+ * 
+ * @param table       Config table.
+ * @param key         Key string.
+ * @param key_length  Length of key.
+ * @param data        Value string. Is copied.
+ */
+void jconfig_snapshot_put(jconfig_t *table, const char *key, size_t key_length, const char *data);
+
+/**
+ * @brief Removes key from next snapshot.
+ * 
+ * @param table       Config table.
+ * @param key         Key string.
+ * @param key_length  Length of key.
+ */
+void jconfig_snapshot_remove(jconfig_t *table, const char *key, size_t key_length);
+
+/**
+ * @brief Removes all keys from next snapshot.
+ * 
+ * @param table Config table.
+ */
+void jconfig_snapshot_clear(jconfig_t *table);
+
+/**
+ * @brief Publishes changes as new snapshot.
+ * 
+ * Does nothing, if nothing changed or a batch is running.
+ * 
+ * @param table Config table.
+ */
+void jconfig_snapshot_publish(jconfig_t *table);
+
 #ifdef __cplusplus
 }
 #endif
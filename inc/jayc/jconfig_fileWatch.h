@@ -0,0 +1,93 @@
+/**
+ * @file jconfig_fileWatch.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Detects changes of config files with inotify.
+ * 
+ * The directory of the file is watched, so files, that
+ * are replaced by rename (like @c #jconfig_binary_saveToFile()
+ * does), are detected as well as files written in place.
+ * 
+ * Use with reload functions:
+ * 
+ * @code
+ * jconfig_fileWatch_t *watch = jconfig_fileWatch_init("app.conf");
+ * while(run)
+ * {
+ *   if(jconfig_fileWatch_check(watch, 1000))
+ *   {
+ *     jconfig_raw_reloadFromFile(config, "app.conf");
+ *   }
+ * }
+ * @endcode
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jconfig.h
+ * 
+ */
+
+#ifndef INCLUDE_JCONFIG_FILEWATCH_H
+#define INCLUDE_JCONFIG_FILEWATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File watch object.
+ */
+typedef struct __jconfig_fileWatch jconfig_fileWatch_t;
+
+/**
+ * @brief Starts watching file.
+ * 
+ * File does not have to exist yet, but its directory.
+ * 
+ * @param filename  Path of file to watch.
+ * 
+ * @return          File watch object.
+ * @return          @c NULL , if error occured.
+ */
+jconfig_fileWatch_t *jconfig_fileWatch_init(const char *filename);
+
+/**
+ * @brief Stops watching and frees memory.
+ * 
+ * @param watch File watch object.
+ */
+void jconfig_fileWatch_free(jconfig_fileWatch_t *watch);
+
+/**
+ * @brief Checks, if file was changed since last check.
+ * 
+ * @param watch   File watch object.
+ * @param timeout Time to wait for change in milliseconds.
+ *                @c 0 returns immediately, @c -1 waits
+ *                without limit. Can return early, when
+ *                other files in directory changed.
+ * 
+ * @return        @c true , if file was written or replaced.
+ * @return        @c false , if no change, timeout or error occured.
+ */
+int jconfig_fileWatch_check(jconfig_fileWatch_t *watch, int timeout);
+
+/**
+ * @brief Returns file descriptor, that is readable on changes.
+ * 
+ * Can be added to own poll loop. When readable,
+ * call @c #jconfig_fileWatch_check() with timeout @c 0 .
+ * 
+ * @param watch File watch object.
+ * 
+ * @return      File descriptor.
+ * @return      @c -1 , if error occured.
+ */
+int jconfig_fileWatch_getFileDescriptor(jconfig_fileWatch_t *watch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCONFIG_FILEWATCH_H */
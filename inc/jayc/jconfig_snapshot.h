@@ -0,0 +1,295 @@
+/**
+ * @file jconfig_snapshot.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Immutable versions of config tables for other threads.
+ * 
+ * Config tables are not synchronized. When worker threads
+ * read config, that another thread changes, the writing
+ * thread enables snapshots, and readers take a snapshot
+ * instead of using the table:
+ * 
+ * @code
+ * // Writing thread, before readers start.
+ * jconfig_snapshot_enable(config);
+ * 
+ * // Reading thread.
+ * jconfig_snapshot_t *snapshot = jconfig_snapshot(config);
+ * const char *address = jconfig_snapshot_get(snapshot, "server.address");
+ * ...
+ * jconfig_snapshot_release(snapshot);
+ * @endcode
+ * 
+ * A snapshot never changes, so it can be read without locks
+ * by any number of threads, until it is released. Every
+ * function, that changes the table, publishes a new version,
+ * when it returns (batches publish on commit, loading a file
+ * publishes the whole file at once).
+ * 
+ * Versions are prefix trees, that share all unchanged parts
+ * with the previous version. Changing a key copies only the
+ * nodes on the path to it, so large configs are not copied
+ * per write.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jconfig.h
+ * 
+ */
+
+#ifndef INCLUDE_JCONFIG_SNAPSHOT_H
+#define INCLUDE_JCONFIG_SNAPSHOT_H
+
+#include <jayc/jconfig.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Immutable version of config table.
+ */
+typedef struct __jconfig_snapshot jconfig_snapshot_t;
+
+/**
+ * @brief Entry of snapshot, used to iterate.
+ */
+typedef struct __jconfig_snapshot_leaf jconfig_snapshot_entry_t;
+
+/**
+ * @brief Handler, that is called for each key, that differs between snapshots.
+ * 
+ * @param ctx       Context pointer provided by user.
+ * @param change    @c #JCONFIG_CHANGE_ADDED , @c #JCONFIG_CHANGE_CHANGED
+ *                  or @c #JCONFIG_CHANGE_REMOVED .
+ * @param key       Changed key.
+ * @param old_value Value in old snapshot ( @c NULL , if added).
+ * @param new_value Value in new snapshot ( @c NULL , if removed).
+ */
+typedef void(*jconfig_snapshot_diff_handler_t)(void *ctx, int change, const char *key, const char *old_value, const char *new_value);
+
+/**
+ * @brief Starts publishing versions of table.
+ * 
+ * Called by the thread, that changes the table, before
+ * other threads call @c #jconfig_snapshot() . Publishes
+ * the current content as first version.
+ * 
+ * @param table Config table.
+ * 
+ * @return      @c true , if snapshots are enabled.
+ * @return      @c false , if error occured.
+ */
+int jconfig_snapshot_enable(jconfig_t *table);
+
+/**
+ * @brief Stops publishing versions of table.
+ * 
+ * No thread may call @c #jconfig_snapshot() anymore.
+ * Snapshots, that are still held, stay valid until
+ * they are released. Called by @c #jconfig_free() .
+ * 
+ * @param table Config table.
+ */
+void jconfig_snapshot_disable(jconfig_t *table);
+
+/**
+ * @brief Returns latest version of table.
+ * 
+ * Can be called from any thread, while another thread
+ * changes the table. Does not lock.
+ * 
+ * @param table Config table with snapshots enabled.
+ * 
+ * @return      Snapshot, that has to be released.
+ * @return      @c NULL , if snapshots are not enabled.
+ */
+jconfig_snapshot_t *jconfig_snapshot(jconfig_t *table);
+
+/**
+ * @brief Releases snapshot.
+ * 
+ * Strings of snapshot must not be used anymore.
+ * 
+ * @param snapshot Snapshot to release.
+ */
+void jconfig_snapshot_release(jconfig_snapshot_t *snapshot);
+
+/**
+ * @brief Takes additional reference of snapshot.
+ * 
+ * F.ex. to pass snapshot to another thread.
+ * Each reference has to be released.
+ * 
+ * @param snapshot Snapshot to reference.
+ * 
+ * @return         @c snapshot .
+ */
+jconfig_snapshot_t *jconfig_snapshot_retain(jconfig_snapshot_t *snapshot);
+
+/**
+ * @brief Returns version number of snapshot.
+ * 
+ * Increases with every published version, so
+ * readers can check, if config changed.
+ * 
+ * @param snapshot Snapshot to check.
+ * 
+ * @return         Version number.
+ */
+uint64_t jconfig_snapshot_getVersion(jconfig_snapshot_t *snapshot);
+
+/**
+ * @brief Returns number of keys in snapshot.
+ * 
+ * @param snapshot Snapshot to check.
+ * 
+ * @return         Number of keys.
+ */
+size_t jconfig_snapshot_getCount(jconfig_snapshot_t *snapshot);
+
+/**
+ * @brief Returns data at key.
+ * 
+ * @param snapshot  Snapshot to search.
+ * @param key       Key to search.
+ * 
+ * @return          Data string, valid until snapshot is released.
+ * @return          @c NULL , if key does not exist.
+ */
+const char *jconfig_snapshot_get(jconfig_snapshot_t *snapshot, const char *key);
+
+/**
+ * @brief Parses data at key as integer.
+ * 
+ * Works like @c #jconfig_datapoint_getInt64() , but
+ * values are parsed on every call.
+ * 
+ * @param snapshot  Snapshot to search.
+ * @param key       Key to search.
+ * @param value     Returns parsed value.
+ * 
+ * @return          @c true , if value was parsed.
+ * @return          @c false , if key does not exist or value is invalid.
+ */
+int jconfig_snapshot_getInt64(jconfig_snapshot_t *snapshot, const char *key, int64_t *value);
+
+/**
+ * @brief Parses data at key as floating point number.
+ * 
+ * Works like @c #jconfig_datapoint_getDouble() .
+ * 
+ * @param snapshot  Snapshot to search.
+ * @param key       Key to search.
+ * @param value     Returns parsed value.
+ * 
+ * @return          @c true , if value was parsed.
+ * @return          @c false , if key does not exist or value is invalid.
+ */
+int jconfig_snapshot_getDouble(jconfig_snapshot_t *snapshot, const char *key, double *value);
+
+/**
+ * @brief Parses data at key as boolean.
+ * 
+ * Works like @c #jconfig_datapoint_getBool() .
+ * 
+ * @param snapshot  Snapshot to search.
+ * @param key       Key to search.
+ * @param value     Returns @c true or @c false .
+ * 
+ * @return          @c true , if value was parsed.
+ * @return          @c false , if key does not exist or value is invalid.
+ */
+int jconfig_snapshot_getBool(jconfig_snapshot_t *snapshot, const char *key, int *value);
+
+/**
+ * @brief Parses data at key as duration.
+ * 
+ * Works like @c #jconfig_datapoint_getDuration() .
+ * 
+ * @param snapshot    Snapshot to search.
+ * @param key         Key to search.
+ * @param nanoseconds Returns duration in nanoseconds.
+ * 
+ * @return            @c true , if value was parsed.
+ * @return            @c false , if key does not exist or value is invalid.
+ */
+int jconfig_snapshot_getDuration(jconfig_snapshot_t *snapshot, const char *key, int64_t *nanoseconds);
+
+/**
+ * @brief Parses data at key as size.
+ * 
+ * Works like @c #jconfig_datapoint_getSize() .
+ * 
+ * @param snapshot  Snapshot to search.
+ * @param key       Key to search.
+ * @param bytes     Returns size in bytes.
+ * 
+ * @return          @c true , if value was parsed.
+ * @return          @c false , if key does not exist or value is invalid.
+ */
+int jconfig_snapshot_getSize(jconfig_snapshot_t *snapshot, const char *key, uint64_t *bytes);
+
+/**
+ * @brief Iterates through entries of snapshot.
+ * 
+ * Works like @c #jconfig_iterate() . Entries are
+ * returned in byte order of their keys.
+ * 
+ * @param snapshot  Snapshot to iterate.
+ * @param prefix    Only visit keys, that start with prefix.
+ *                  Ignored if @c NULL or @c "" .
+ * @param itr       Previous entry. If @c NULL , starts over.
+ * 
+ * @return          Next entry.
+ * @return          @c NULL , if no more data.
+ */
+const jconfig_snapshot_entry_t *jconfig_snapshot_iterate(jconfig_snapshot_t *snapshot, const char *prefix, const jconfig_snapshot_entry_t *itr);
+
+/**
+ * @brief Returns key of entry.
+ * 
+ * @param itr Entry of snapshot.
+ * 
+ * @return    Key string.
+ * @return    @c NULL , if error occured.
+ */
+const char *jconfig_snapshot_itr_getKey(const jconfig_snapshot_entry_t *itr);
+
+/**
+ * @brief Returns data of entry.
+ * 
+ * @param itr Entry of snapshot.
+ * 
+ * @return    Data string.
+ * @return    @c NULL , if error occured.
+ */
+const char *jconfig_snapshot_itr_getData(const jconfig_snapshot_entry_t *itr);
+
+/**
+ * @brief Reports keys, that differ between two snapshots.
+ * 
+ * Keys are reported in byte order. Subtrees, that both
+ * versions share, are skipped without visiting them, so
+ * the cost depends on the number of changes, not on the
+ * size of the config.
+ * 
+ * @param old_snapshot  Older snapshot. @c NULL reports all keys
+ *                      of @c new_snapshot as added.
+ * @param new_snapshot  Newer snapshot. @c NULL reports all keys
+ *                      of @c old_snapshot as removed.
+ * @param handler       Handler to call for each changed key.
+ * @param ctx           Context pointer passed to handler.
+ * 
+ * @return              Number of changed keys.
+ */
+size_t jconfig_snapshot_diff(jconfig_snapshot_t *old_snapshot, jconfig_snapshot_t *new_snapshot, jconfig_snapshot_diff_handler_t handler, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JCONFIG_SNAPSHOT_H */
@@ -82,6 +82,34 @@ typedef struct __jlog_session jlog_t;
 
 
 
+//==============================================================================
+// Define compile time log level.
+//
+
+#ifndef JLOG_COMPILE_LEVEL
+/**
+ * @brief Lowest log type, that is compiled into the program.
+ * 
+ * Log macros of jlog and of the library modules below this
+ * level are removed at compile time, their arguments are never
+ * evaluated. Set with f.ex. @c -DJLOG_COMPILE_LEVEL=JLOG_LOGTYPE_WARN .
+ * Defaults to @c #JLOG_LOGTYPE_DEBUG (nothing is removed).
+ */
+#define JLOG_COMPILE_LEVEL JLOG_LOGTYPE_DEBUG
+#endif
+
+/**
+ * @brief Checks, if log type is compiled in.
+ * 
+ * Constant expression for constant log types, so compiler
+ * removes the log call. Fatal messages are never removed,
+ * because they exit the program.
+ * 
+ * @param log_type  Log type of message (debug, info, warning, error).
+ */
+#define JLOG_COMPILE_ENABLED(log_type) ((log_type) >= JLOG_COMPILE_LEVEL || (log_type) == JLOG_LOGTYPE_FATAL)
+
+
 //==============================================================================
 // Declare functions.
 //
@@ -142,6 +170,21 @@ void jlog_log_message(jlog_t *session, int log_type, const char *fmt, ...);
  */
 void jlog_log_message_m(jlog_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
 
+/**
+ * @brief Checks, if a message with log type would be logged.
+ * 
+ * Lets callers skip building messages, that would be
+ * discarded because of the log level.
+ * 
+ * @param session   Session to check. If @c NULL , the
+ *                  global session is checked.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * 
+ * @return          @c true , if message would be logged.
+ * @return          @c false , if message would be discarded.
+ */
+int jlog_isEnabled(jlog_t *session, int log_type);
+
 /**
  * @brief Set global session variable.
  * 
@@ -160,6 +203,20 @@ void jlog_global_session_set(jlog_t *session);
  */
 void jlog_global_session_free();
 
+/**
+ * @brief Checks, if a message with log type would be logged by global session.
+ * 
+ * Same as @c jlog_isEnabled() with @c NULL session.
+ * Used by global macros, so messages below the log
+ * level are not formatted.
+ * 
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * 
+ * @return          @c true , if message would be logged.
+ * @return          @c false , if message would be discarded.
+ */
+int jlog_global_isEnabled(int log_type);
+
 /**
  * @brief Log message via global session object.
  * 
@@ -196,60 +253,72 @@ void jlog_global_log_message_m(int log_type, const char *file, const char *funct
  * 
  * Calls @c jlog_global_log_message_m() with log type @c #JLOG_LOGTYPE_DEBUG
  * and filename, function name and line number from where it was called.
+ * Arguments are not evaluated, if log type is disabled or
+ * below @c #JLOG_COMPILE_LEVEL .
  *
  * @param fmt Format string used for stdarg.h .
  */
-#define JLOG_DEBUG(fmt, ...) jlog_global_log_message_m(JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define JLOG_DEBUG(fmt, ...) ((JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_DEBUG) && jlog_global_isEnabled(JLOG_LOGTYPE_DEBUG)) ? jlog_global_log_message_m(JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 
 /**
  * @brief Sends global info log with current code info.
  * 
  * Calls @c jlog_global_log_message_m() with log type @c #JLOG_LOGTYPE_INFO
  * and filename, function name and line number from where it was called.
+ * Arguments are not evaluated, if log type is disabled or
+ * below @c #JLOG_COMPILE_LEVEL .
  *
  * @param fmt Format string used for stdarg.h .
  */
-#define JLOG_INFO(fmt, ...) jlog_global_log_message_m(JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define JLOG_INFO(fmt, ...) ((JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_INFO) && jlog_global_isEnabled(JLOG_LOGTYPE_INFO)) ? jlog_global_log_message_m(JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 
 /**
  * @brief Sends global warning log with current code info.
  * 
  * Calls @c jlog_global_log_message_m() with log type @c #JLOG_LOGTYPE_WARN
  * and filename, function name and line number from where it was called.
+ * Arguments are not evaluated, if log type is disabled or
+ * below @c #JLOG_COMPILE_LEVEL .
  *
  * @param fmt Format string used for stdarg.h .
  */
-#define JLOG_WARN(fmt, ...) jlog_global_log_message_m(JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define JLOG_WARN(fmt, ...) ((JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) && jlog_global_isEnabled(JLOG_LOGTYPE_WARN)) ? jlog_global_log_message_m(JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 
 /**
  * @brief Sends global error log with current code info.
  * 
  * Calls @c jlog_global_log_message_m() with log type @c #JLOG_LOGTYPE_ERROR
  * and filename, function name and line number from where it was called.
+ * Arguments are not evaluated, if log type is disabled or
+ * below @c #JLOG_COMPILE_LEVEL .
  *
  * @param fmt Format string used for stdarg.h .
  */
-#define JLOG_ERROR(fmt, ...) jlog_global_log_message_m(JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define JLOG_ERROR(fmt, ...) ((JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) && jlog_global_isEnabled(JLOG_LOGTYPE_ERROR)) ? jlog_global_log_message_m(JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 
 /**
  * @brief Sends global critical log with current code info.
  * 
  * Calls @c jlog_global_log_message_m() with log type @c #JLOG_LOGTYPE_CRITICAL
  * and filename, function name and line number from where it was called.
+ * Arguments are not evaluated, if log type is disabled or
+ * below @c #JLOG_COMPILE_LEVEL .
  *
  * @param fmt Format string used for stdarg.h .
  */
-#define JLOG_CRITICAL(fmt, ...) jlog_global_log_message_m(JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define JLOG_CRITICAL(fmt, ...) ((JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) && jlog_global_isEnabled(JLOG_LOGTYPE_CRITICAL)) ? jlog_global_log_message_m(JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 
 /**
  * @brief Sends global fatal log with current code info.
  * 
  * Calls @c jlog_global_log_message_m() with log type @c #JLOG_LOGTYPE_FATAL
  * and filename, function name and line number from where it was called.
+ * Arguments are not evaluated, if log type is disabled.
+ * Never removed by @c #JLOG_COMPILE_LEVEL .
  *
  * @param fmt Format string used for stdarg.h .
  */
-#define JLOG_FATAL(fmt, ...) jlog_global_log_message_m(JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define JLOG_FATAL(fmt, ...) (jlog_global_isEnabled(JLOG_LOGTYPE_FATAL) ? jlog_global_log_message_m(JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 
 #ifdef __cplusplus
 }
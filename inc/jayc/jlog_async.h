@@ -0,0 +1,128 @@
+/**
+ * @file jlog_async.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jlog, that logs from a background thread.
+ * 
+ * Log calls copy the message into a ring buffer and return.
+ * One writer thread passes messages to another session
+ * (backend), for example a jlog_stdio session. So threads
+ * do not wait for output and do not serialize on locks of
+ * the backend.
+ * 
+ * Pointers to file and function names are stored, not copied.
+ * They have to stay valid (like @c __FILE__ and @c __func__ ).
+ * 
+ * Freeing the session writes all queued messages first. If
+ * the session is set as global session, this happens in
+ * @c #jproc_exit() . Fatal messages are written, before the
+ * log call returns.
+ * 
+ * @code
+ * jlog_t *backend = jlog_stdio_session_init(JLOG_LOGTYPE_INFO);
+ * jlog_t *logger = jlog_async_session_init(backend, 1024, JLOG_ASYNC_OVERFLOW_COUNT);
+ * jlog_global_session_set(logger);
+ * @endcode
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jlog.h
+ * 
+ */
+
+#ifndef INCLUDE_JLOG_ASYNC_H
+#define INCLUDE_JLOG_ASYNC_H
+
+#include <jayc/jlog.h>
+#include <jayc/jutil_buffer.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Messages are dropped, when buffer is full.
+ * 
+ * Number of dropped messages can be read with
+ * @c #jlog_async_getDropped() .
+ */
+#define JLOG_ASYNC_OVERFLOW_DROP  0
+
+/**
+ * @brief Log calls wait, until buffer has space.
+ */
+#define JLOG_ASYNC_OVERFLOW_BLOCK 1
+
+/**
+ * @brief Messages are dropped, when buffer is full.
+ * 
+ * Writer thread logs a warning with the number
+ * of dropped messages, when it catches up.
+ */
+#define JLOG_ASYNC_OVERFLOW_COUNT 2
+
+/**
+ * @brief Creates @c #jlog_t session, that logs from background thread.
+ * 
+ * Uses log level of backend. Backend is owned by
+ * session and freed with it.
+ * 
+ * Backend needs a plain or unformatted handler. Messages with
+ * source code info are logged without it, if backend has
+ * no handler for them.
+ * 
+ * @param backend         Session to pass messages to.
+ * @param capacity        Number of messages buffered. Rounded
+ *                        up to power of 2.
+ * @param overflow_policy @c #JLOG_ASYNC_OVERFLOW_DROP ,
+ *                        @c #JLOG_ASYNC_OVERFLOW_BLOCK or
+ *                        @c #JLOG_ASYNC_OVERFLOW_COUNT .
+ * 
+ * @return                Session pointer.
+ * @return                @c NULL , if failed or backend has no
+ *                        suitable handler (backend is not freed).
+ */
+jlog_t *jlog_async_session_init(jlog_t *backend, size_t capacity, int overflow_policy);
+
+/**
+ * @brief Waits, until all messages logged so far are written.
+ * 
+ * @param session Session created by @c #jlog_async_session_init() .
+ */
+void jlog_async_flush(jlog_t *session);
+
+/**
+ * @brief Logs buffer without copy in log call.
+ * 
+ * The ring references the buffer and the writer thread
+ * copies it into the message (truncated like other
+ * messages), so payloads, that are sent anyway
+ * (f.ex. with @c #jcon_system_broadcastBuffer() ),
+ * can be logged from hot paths. The buffer is not
+ * formatted and must not be changed afterwards.
+ * 
+ * Other sessions than jlog_async log a copy directly.
+ * 
+ * @param session  Session to log to.
+ * @param log_type Log type of message.
+ * @param message  Message text. Released by caller.
+ */
+void jlog_async_logBuffer(jlog_t *session, int log_type, jutil_buffer_t *message);
+
+/**
+ * @brief Returns number of messages dropped, because buffer was full.
+ * 
+ * @param session Session created by @c #jlog_async_session_init() .
+ * 
+ * @return        Number of dropped messages.
+ * @return        @c 0 , if none or error occured.
+ */
+size_t jlog_async_getDropped(jlog_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JLOG_ASYNC_H */
@@ -0,0 +1,98 @@
+/**
+ * @file jlog_binary.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jlog, that writes unformatted messages to binary file.
+ * 
+ * Log calls do not format messages. Each call site (format
+ * string, file, function and line) is written to the file once
+ * and gets an id. Messages only store id, time, thread and
+ * the raw arguments of the format string.
+ * 
+ * Messages are collected in a buffer per thread and written,
+ * when buffer is full, thread exits or session is freed.
+ * Messages of type error and above are written immediately.
+ * 
+ * Files are rendered as text with @c #jlog_binary_decodeFile() ,
+ * or with the tool @c jayc-logdec .
+ * 
+ * Works with all jlog functions and macros:
+ * 
+ * @code
+ * jlog_global_session_set(jlog_binary_session_init(JLOG_LOGTYPE_DEBUG, "trace.jlog"));
+ * JLOG_DEBUG("received %zu bytes from %s", size, address);
+ * @endcode
+ * 
+ * Limits:
+ * - Format strings have to stay valid and unchanged
+ *   (like string literals).
+ * - Strings are stored with max. 2048 bytes.
+ * - @c long @c double is stored as @c double .
+ * - @c %n and wide strings ( @c %ls ) print nothing.
+ * - Threads must not log, while session is freed.
+ * 
+ * Numbers are stored in byte order of the host.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jlog.h
+ * 
+ */
+
+#ifndef INCLUDE_JLOG_BINARY_H
+#define INCLUDE_JLOG_BINARY_H
+
+#include <jayc/jlog.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Version of file format, written by this library.
+ */
+#define JLOG_BINARY_VERSION 1
+
+/**
+ * @brief Creates @c #jlog_t session, that writes to binary file.
+ * 
+ * Existing file is replaced.
+ * 
+ * @param log_level Log level to use.
+ * @param filename  Path of file to write.
+ * 
+ * @return          Session pointer.
+ * @return          @c NULL , if failed.
+ */
+jlog_t *jlog_binary_session_init(int log_level, const char *filename);
+
+/**
+ * @brief Writes messages buffered by calling thread to file.
+ * 
+ * @param session Session created by @c #jlog_binary_session_init() .
+ */
+void jlog_binary_flush(jlog_t *session);
+
+/**
+ * @brief Renders binary log file as text.
+ * 
+ * Prints one line per message in order of file. Messages
+ * of different threads are written in blocks, so they can
+ * be out of order. Time and thread number are printed
+ * in front of each line.
+ * 
+ * @param filename  Path of binary log file.
+ * @param out       Stream to print to.
+ * 
+ * @return          @c true , if whole file was rendered.
+ * @return          @c false , if file is invalid or error occured.
+ */
+int jlog_binary_decodeFile(const char *filename, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JLOG_BINARY_H */
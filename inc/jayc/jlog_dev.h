@@ -13,6 +13,7 @@
 #define INCLUDE_JLOG_DEV_H
 
 #include <jayc/jlog.h>
+#include <stdarg.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +40,24 @@ typedef void(*jlog_message_handler_t)(void *ctx, int log_type, const char *msg);
  */
 typedef void(*jlog_message_handler_m_t)(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
 
+/**
+ * @brief Function to handle log calls, before message is formatted.
+ * 
+ * Lets loggers store format string and arguments, and
+ * format later or never. If set, session uses it instead
+ * of the other handlers.
+ *
+ * @param ctx       Context pointer for session data used by certain loggers.
+ * @param log_type  Type of log message (debug, info, warning, error).
+ * @param file      File name in which log was called. @c NULL , if log
+ *                  call has no source code info.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param args      Arguments for format string.
+ */
+typedef void(*jlog_message_handler_v_t)(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args);
+
 /**
  * @brief Handler to destroy session.
  * 
@@ -56,6 +75,7 @@ struct __jlog_session
 {
   jlog_message_handler_t log_function;              /**< Holds function pointer to log handler. */
   jlog_message_handler_m_t log_function_m;          /**< Holds function pointer to log data with source code info. */
+  jlog_message_handler_v_t log_function_v;          /**< Holds function pointer to log unformatted data. Optional. */
   jlog_session_free_handler_t session_free_handler; /**< Function to free session context memory. Called by @c jlog_session_free() . */
   int log_level;                                    /**< Only log messages with log type >= log level. */
   void *session_context;                            /**< Context pointer for session data used by certain loggers. */
@@ -0,0 +1,105 @@
+/**
+ * @file jlog_file.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jlog, that writes to log files.
+ * 
+ * Log calls format the line into a large buffer and return.
+ * A writer thread writes full buffers, or what was logged
+ * in the last 200 ms, with one @c write() call. Callers only
+ * wait, when buffer is full while the writer is still busy.
+ * 
+ * Files can be rotated by size and age. When rotated, the file
+ * is renamed to @c "<filename>.1" , older files are moved up
+ * ( @c ".1" to @c ".2" and so on) and a new file is started.
+ * Rotation is done by the writer thread.
+ * 
+ * Lines have the same format as timestamp sessions of
+ * jlog_stdio (without colors).
+ * 
+ * @code
+ * jlog_t *logger = jlog_file_session_init(JLOG_LOGTYPE_INFO, "/var/log/app.log");
+ * jlog_file_setRotation(logger, 64 * 1024 * 1024, 24 * 60 * 60, 7);
+ * jlog_global_session_set(logger);
+ * @endcode
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jlog.h
+ * 
+ */
+
+#ifndef INCLUDE_JLOG_FILE_H
+#define INCLUDE_JLOG_FILE_H
+
+#include <jayc/jlog.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates @c #jlog_t session, that writes to log file.
+ * 
+ * Lines are appended, if file exists.
+ * 
+ * @param log_level Log level to use.
+ * @param filename  Path of log file.
+ * 
+ * @return          Session pointer.
+ * @return          @c NULL , if failed.
+ */
+jlog_t *jlog_file_session_init(int log_level, const char *filename);
+
+/**
+ * @brief Sets when log file is rotated.
+ * 
+ * Rotation is disabled by default.
+ * 
+ * Files are rotated before a line would exceed @c max_size ,
+ * so lines are never split over two files. Only a single line
+ * longer than @c max_size gets a file of its own, that is larger.
+ * 
+ * @param session   Session created by @c #jlog_file_session_init() .
+ * @param max_size  Size in bytes, at which file is rotated.
+ *                  @c 0 for no limit.
+ * @param max_age   Age in seconds, at which file is rotated.
+ *                  @c 0 for no limit.
+ * @param max_files Number of rotated files to keep. Oldest
+ *                  file is deleted. @c 0 deletes file, when
+ *                  rotated.
+ * 
+ * @return          @c true , if rotation was set.
+ * @return          @c false , if error occured.
+ */
+int jlog_file_setRotation(jlog_t *session, size_t max_size, long max_age, int max_files);
+
+/**
+ * @brief Sets, if written data is synced to disk.
+ * 
+ * Calls @c fdatasync() once after each write of the writer
+ * thread, so many lines are synced together. Disabled
+ * by default.
+ * 
+ * @param session Session created by @c #jlog_file_session_init() .
+ * @param sync    @c true , if data should be synced.
+ * 
+ * @return        @c true , if option was set.
+ * @return        @c false , if error occured.
+ */
+int jlog_file_setSync(jlog_t *session, int sync);
+
+/**
+ * @brief Waits, until all lines logged so far are written.
+ * 
+ * @param session Session created by @c #jlog_file_session_init() .
+ */
+void jlog_file_flush(jlog_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JLOG_FILE_H */
@@ -0,0 +1,258 @@
+/**
+ * @file jlog_ratelimit.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Rate limiting and sampling of log messages per call site.
+ * 
+ * Each macro call gets its own static counter, so a message,
+ * that is logged thousands of times per second, does not flood
+ * the logger or hide other messages.
+ * 
+ * Rate limited macros log max. @c burst messages per interval.
+ * Further messages in the interval are suppressed and counted.
+ * The next message, that gets through, is preceded by a summary
+ * with the number of suppressed messages.
+ * 
+ * Sampled macros log every n-th call of the call site.
+ * 
+ * @code
+ * if(jcon_client_sendData(client, data, size) == false)
+ * {
+ *   JLOG_ERROR_RL("jcon_client_sendData() failed.");
+ * }
+ * 
+ * JLOG_DEBUG_SAMPLED(1000, "Received %zu bytes.", size);
+ * @endcode
+ * 
+ * Counters only use atomic operations, no locks.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jlog.h
+ * 
+ */
+
+#ifndef INCLUDE_JLOG_RATELIMIT_H
+#define INCLUDE_JLOG_RATELIMIT_H
+
+#include <jayc/jlog.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// Define constants and types.
+//
+
+#ifndef JLOG_RATELIMIT_INTERVAL
+/**
+ * @brief Default interval of rate limited macros in milliseconds.
+ */
+#define JLOG_RATELIMIT_INTERVAL 1000
+#endif
+
+#ifndef JLOG_RATELIMIT_BURST
+/**
+ * @brief Default number of messages per interval of rate limited macros.
+ */
+#define JLOG_RATELIMIT_BURST 10
+#endif
+
+/**
+ * @brief Counters of one call site.
+ * 
+ * Has to be zero initialized (static variables are).
+ */
+typedef struct __jlog_ratelimit
+{
+  atomic_ullong state;      /**< Rate limit: Window number (upper 32 bit) and messages in window (lower 32 bit). Sampling: Number of calls. */
+  atomic_ulong suppressed;  /**< Messages suppressed since last summary. */
+} jlog_ratelimit_t;
+
+
+
+//==============================================================================
+// Declare functions.
+//
+
+/**
+ * @brief Checks, if message of call site may be logged.
+ * 
+ * Allows @c burst messages per interval. Suppressed messages
+ * are counted.
+ * 
+ * @param site        Counters of call site.
+ * @param interval_ms Length of interval in milliseconds.
+ * @param burst       Messages allowed per interval.
+ * 
+ * @return            @c true , if message may be logged.
+ * @return            @c false , if message is suppressed.
+ */
+int jlog_ratelimit_check(jlog_ratelimit_t *site, unsigned long interval_ms, unsigned long burst);
+
+/**
+ * @brief Checks, if message of call site is sampled.
+ * 
+ * First call and every @c rate -th call after that are
+ * sampled. Other calls are counted as suppressed.
+ * 
+ * @param site  Counters of call site.
+ * @param rate  Every @c rate -th call is sampled. @c 0 and
+ *              @c 1 sample every call.
+ * 
+ * @return      @c true , if message should be logged.
+ * @return      @c false , if message is skipped.
+ */
+int jlog_ratelimit_sample(jlog_ratelimit_t *site, unsigned long rate);
+
+/**
+ * @brief Returns number of suppressed messages and resets it.
+ * 
+ * @param site  Counters of call site.
+ * 
+ * @return      Messages suppressed since last call.
+ */
+unsigned long jlog_ratelimit_takeSuppressed(jlog_ratelimit_t *site);
+
+/**
+ * @brief Logs summary of suppressed messages, if there are any.
+ * 
+ * @param session   Session to use. If @c NULL , the global
+ *                  session is used.
+ * @param site      Counters of call site.
+ * @param log_type  Log type of summary (debug, info, warning, error).
+ * @param file      File name of call site.
+ * @param function  Function name of call site.
+ * @param line      Line number of call site.
+ */
+void jlog_ratelimit_report(jlog_t *session, jlog_ratelimit_t *site, int log_type, const char *file, const char *function, int line);
+
+
+
+//==============================================================================
+// Define global macros.
+//
+
+/**
+ * @brief Sends rate limited global log with current code info.
+ * 
+ * Logs max. @c burst messages per @c interval_ms milliseconds
+ * from this call site. Arguments are not evaluated, if log type
+ * is disabled, below @c #JLOG_COMPILE_LEVEL or message is
+ * suppressed.
+ * 
+ * @param log_type    Log type of message (debug, info, warning, error).
+ * @param interval_ms Length of interval in milliseconds.
+ * @param burst       Messages allowed per interval.
+ * @param fmt         Format string used for stdarg.h .
+ */
+#define JLOG_RATELIMITED(log_type, interval_ms, burst, fmt, ...) \
+  do \
+  { \
+    static jlog_ratelimit_t jlog_ratelimit_site; \
+    if(JLOG_COMPILE_ENABLED(log_type) && jlog_global_isEnabled(log_type) && jlog_ratelimit_check(&jlog_ratelimit_site, interval_ms, burst)) \
+    { \
+      jlog_ratelimit_report(NULL, &jlog_ratelimit_site, log_type, __FILE__, __func__, __LINE__); \
+      jlog_global_log_message_m(log_type, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__); \
+    } \
+  } while(0)
+
+/**
+ * @brief Sends sampled global log with current code info.
+ * 
+ * Logs every @c rate -th message from this call site.
+ * Arguments are not evaluated, if log type is disabled or
+ * message is skipped.
+ * 
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param rate      Every @c rate -th call is logged.
+ * @param fmt       Format string used for stdarg.h .
+ */
+#define JLOG_SAMPLED(log_type, rate, fmt, ...) \
+  do \
+  { \
+    static jlog_ratelimit_t jlog_ratelimit_site; \
+    if(JLOG_COMPILE_ENABLED(log_type) && jlog_global_isEnabled(log_type) && jlog_ratelimit_sample(&jlog_ratelimit_site, rate)) \
+    { \
+      jlog_global_log_message_m(log_type, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__); \
+    } \
+  } while(0)
+
+/**
+ * @brief Sends rate limited global debug log.
+ * 
+ * Same as @c #JLOG_DEBUG , limited to @c #JLOG_RATELIMIT_BURST
+ * messages per @c #JLOG_RATELIMIT_INTERVAL .
+ * 
+ * @param fmt Format string used for stdarg.h .
+ */
+#define JLOG_DEBUG_RL(fmt, ...) JLOG_RATELIMITED(JLOG_LOGTYPE_DEBUG, JLOG_RATELIMIT_INTERVAL, JLOG_RATELIMIT_BURST, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Sends rate limited global info log.
+ * 
+ * Same as @c #JLOG_INFO , limited to @c #JLOG_RATELIMIT_BURST
+ * messages per @c #JLOG_RATELIMIT_INTERVAL .
+ * 
+ * @param fmt Format string used for stdarg.h .
+ */
+#define JLOG_INFO_RL(fmt, ...) JLOG_RATELIMITED(JLOG_LOGTYPE_INFO, JLOG_RATELIMIT_INTERVAL, JLOG_RATELIMIT_BURST, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Sends rate limited global warning log.
+ * 
+ * Same as @c #JLOG_WARN , limited to @c #JLOG_RATELIMIT_BURST
+ * messages per @c #JLOG_RATELIMIT_INTERVAL .
+ * 
+ * @param fmt Format string used for stdarg.h .
+ */
+#define JLOG_WARN_RL(fmt, ...) JLOG_RATELIMITED(JLOG_LOGTYPE_WARN, JLOG_RATELIMIT_INTERVAL, JLOG_RATELIMIT_BURST, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Sends rate limited global error log.
+ * 
+ * Same as @c #JLOG_ERROR , limited to @c #JLOG_RATELIMIT_BURST
+ * messages per @c #JLOG_RATELIMIT_INTERVAL .
+ * 
+ * @param fmt Format string used for stdarg.h .
+ */
+#define JLOG_ERROR_RL(fmt, ...) JLOG_RATELIMITED(JLOG_LOGTYPE_ERROR, JLOG_RATELIMIT_INTERVAL, JLOG_RATELIMIT_BURST, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Sends rate limited global critical log.
+ * 
+ * Same as @c #JLOG_CRITICAL , limited to @c #JLOG_RATELIMIT_BURST
+ * messages per @c #JLOG_RATELIMIT_INTERVAL .
+ * 
+ * @param fmt Format string used for stdarg.h .
+ */
+#define JLOG_CRITICAL_RL(fmt, ...) JLOG_RATELIMITED(JLOG_LOGTYPE_CRITICAL, JLOG_RATELIMIT_INTERVAL, JLOG_RATELIMIT_BURST, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Sends sampled global debug log.
+ * 
+ * Same as @c #JLOG_DEBUG , but only every @c rate -th call is logged.
+ * 
+ * @param rate  Every @c rate -th call is logged.
+ * @param fmt   Format string used for stdarg.h .
+ */
+#define JLOG_DEBUG_SAMPLED(rate, fmt, ...) JLOG_SAMPLED(JLOG_LOGTYPE_DEBUG, rate, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Sends sampled global info log.
+ * 
+ * Same as @c #JLOG_INFO , but only every @c rate -th call is logged.
+ * 
+ * @param rate  Every @c rate -th call is logged.
+ * @param fmt   Format string used for stdarg.h .
+ */
+#define JLOG_INFO_SAMPLED(rate, fmt, ...) JLOG_SAMPLED(JLOG_LOGTYPE_INFO, rate, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JLOG_RATELIMIT_H */
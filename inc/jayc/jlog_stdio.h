@@ -2,9 +2,9 @@
  * @file jlog_stdio.h
  * @author Manuel Nadji (https://github.com/gnarrf95)
  * 
- * @brief Implementation of jlog, that uses fprintf for output.
+ * @brief Implementation of jlog, that uses stdio for output.
  * 
- * This jlog implementation logs to console using @c fprintf() .
+ * This jlog implementation logs to console using @c fwrite() .
  * Debug, info and warning logs get printed to @c stdout and
  * error, critical and fatal logs get printed to @c stderr .
  * 
@@ -21,6 +21,13 @@
  * The session gets used with the normal jlog functions, and freed using
  * the normal @c #jlog_session_free() function.
  * 
+ * Sessions created with @c #jlog_stdio_timestamp_session_init()
+ * print date and time in front of each line.
+ * 
+ * Each line is formatted in a buffer of the calling thread and
+ * written with one @c fwrite() call, so lines of threads are
+ * not mixed.
+ * 
  * @date 2020-09-21
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
@@ -54,7 +61,7 @@ void *jlog_stdio_color_context_init(const char *debug_color,
                                     const char *error_color);
 
 /**
- * @brief Creates @c #jlog_t session, that logs using @c fprintf .
+ * @brief Creates @c #jlog_t session, that logs using stdio .
  *
  * @param log_level Log level to use.
  *
@@ -64,7 +71,7 @@ void *jlog_stdio_color_context_init(const char *debug_color,
 jlog_t *jlog_stdio_session_init(int log_level);
 
 /**
- * @brief Creates @c #jlog_t session that logs colored outputs using @c fprintf .
+ * @brief Creates @c #jlog_t session that logs colored outputs using stdio .
  *
  * @param log_level Log level to use.
  * @param ctx       Color context.
@@ -75,6 +82,20 @@ jlog_t *jlog_stdio_session_init(int log_level);
  */
 jlog_t *jlog_stdio_color_session_init(int log_level, void *ctx);
 
+/**
+ * @brief Creates @c #jlog_t session that prints timestamp in front of each line.
+ * 
+ * Timestamp has format @c "YYYY-MM-DD HH:MM:SS" in local time.
+ * It is formatted once per second and thread.
+ *
+ * @param log_level Log level to use.
+ * @param ctx       Color context or @c NULL for output without color.
+ *
+ * @return          Session pointer.
+ * @return          @c NULL , if failed.
+ */
+jlog_t *jlog_stdio_timestamp_session_init(int log_level, void *ctx);
+
 #ifdef __cpluslpus
 }
 #endif
@@ -16,6 +16,18 @@
  * As ID the program name is recommended. The facility should be stated
  * to represent the use of the program.
  * 
+ * @c #jlog_syslog_socket_session_init() does not use @c syslog() .
+ * It sends RFC 5424 messages directly to the socket of the syslog
+ * daemon without blocking. When the socket is busy, messages are
+ * dropped and their number is logged as warning later. These
+ * sessions are no singletons. Combined with jlog_async, formatting
+ * and sending is moved off the calling threads:
+ * 
+ * @code
+ * jlog_t *socket_session = jlog_syslog_socket_session_init(JLOG_LOGTYPE_INFO, "app", LOG_DAEMON, NULL);
+ * jlog_global_session_set(jlog_async_session_init(socket_session, 4096, JLOG_ASYNC_OVERFLOW_COUNT));
+ * @endcode
+ * 
  * @date 2020-09-21
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
@@ -47,6 +59,26 @@ extern "C" {
  */
 jlog_t *jlog_syslog_session_init(int log_level, const char *id, int facility);
 
+/**
+ * @brief Creates jlog_syslog session, that writes to syslog socket.
+ * 
+ * Messages are sent as RFC 5424 datagrams over a non-blocking
+ * Unix socket. If the socket buffer is full, messages are
+ * dropped instead of blocking the caller. Number of dropped
+ * messages is sent with the next message, that gets through.
+ * 
+ * Sessions can be created multiple times.
+ * 
+ * @param log_level Log level to use.
+ * @param id        Program name (max. 48 characters are used).
+ * @param facility  Type of program (see <tt>$ man syslog</tt>).
+ * @param path      Path of syslog socket. @c NULL for @c "/dev/log" .
+ * 
+ * @return          jlog session object.
+ * @return          @c NULL , if socket could not be connected.
+ */
+jlog_t *jlog_syslog_socket_session_init(int log_level, const char *id, int facility, const char *path);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,62 @@
+/**
+ * @file jlog_tee.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jlog, that passes messages to multiple sessions.
+ * 
+ * Message is formatted once and the same buffer is passed to
+ * all child sessions, that log the message type. Every child
+ * keeps its own log level. Children, that format messages
+ * themselves (f.ex. jlog_binary), get format string and
+ * arguments instead.
+ * 
+ * @code
+ * jlog_t *sessions[] =
+ * {
+ *   jlog_async_session_init(jlog_file_session_init(JLOG_LOGTYPE_DEBUG, "/var/log/app.log"), 4096, JLOG_ASYNC_OVERFLOW_COUNT),
+ *   jlog_syslog_socket_session_init(JLOG_LOGTYPE_WARN, "app", LOG_DAEMON, NULL)
+ * };
+ * jlog_global_session_set(jlog_tee_session_init(sessions, 2));
+ * @endcode
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jlog.h
+ * 
+ */
+
+#ifndef INCLUDE_JLOG_TEE_H
+#define INCLUDE_JLOG_TEE_H
+
+#include <jayc/jlog.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates @c #jlog_t session, that logs to multiple sessions.
+ * 
+ * Tee session takes ownership of child sessions and frees
+ * them, when it is freed. Its log level is the lowest log
+ * level of its children. Fatal messages (and critical or
+ * error, if configured) exit the program after all children
+ * logged them.
+ * 
+ * @param sessions  Array of child sessions. @c NULL entries are
+ *                  skipped. Array itself is copied.
+ * @param count     Number of entries in array.
+ * 
+ * @return          Session pointer.
+ * @return          @c NULL , if failed. Child sessions are not
+ *                  freed in that case.
+ */
+jlog_t *jlog_tee_session_init(jlog_t **sessions, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JLOG_TEE_H */
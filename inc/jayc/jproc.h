@@ -16,10 +16,59 @@
 #ifndef INCLUDE_JPROC_H
 #define INCLUDE_JPROC_H
 
+#include <jayc/jutil_time.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Shutdown phase to stop accepting new work
+ *        (f.ex. @c #jcon_system_stopAccepting() ).
+ */
+#define JPROC_EXIT_PHASE_ACCEPT 0
+
+/**
+ * @brief Shutdown phase to finish work in progress
+ *        (f.ex. @c #jcon_system_drain() ).
+ */
+#define JPROC_EXIT_PHASE_DRAIN 1
+
+/**
+ * @brief Shutdown phase to write out buffers
+ *        (f.ex. @c #jlog_async_flush() ).
+ */
+#define JPROC_EXIT_PHASE_FLUSH 2
+
+/**
+ * @brief Shutdown phase to free resources.
+ */
+#define JPROC_EXIT_PHASE_FREE 3
+
+/**
+ * @brief Number of shutdown phases.
+ */
+#define JPROC_EXIT_PHASE_NUMBER 4
+
+/**
+ * @brief Default time for all shutdown phases in milliseconds.
+ */
+#define JPROC_EXIT_TIMEOUT_DEFAULT 10000
+
+/**
+ * @brief Time every phase gets in milliseconds, even if
+ *        earlier phases used up the shutdown time.
+ * 
+ * So buffers are still flushed, after draining timed out.
+ */
+#define JPROC_EXIT_TIMEOUT_PHASE_MIN 250
+
+
+
 //==============================================================================
 // Define handler types.
 //
@@ -38,12 +87,31 @@ extern "C" {
  */
 typedef void(*jproc_exit_handler_t)(int exit_value, void *ctx);
 
+/**
+ * @brief Handles one shutdown phase of @c #jproc_exit() .
+ * 
+ * Handlers of the same phase run in parallel, each in its
+ * own thread. They should return before the deadline,
+ * otherwise the next phase starts without them.
+ * 
+ * @param exit_value  Value to be passed to @c exit() .
+ * @param deadline    End of phase
+ *                    (see @c #jutil_time_deadline_getRemaining() ).
+ * @param ctx         Context pointer provided by user.
+ */
+typedef void(*jproc_shutdown_handler_t)(int exit_value, const jutil_time_deadline_t *deadline, void *ctx);
+
 /**
  * @brief Handler for catching signals.
  * 
  * When the process recieves a signal
  * (SIGINT, etc.) this handler will be called.
  * 
+ * By default it is called in signal context, so it
+ * should only set flags. In file descriptor mode
+ * ( @c #jproc_signal_useFileDescriptor() ) it is called by
+ * @c #jproc_signal_dispatch() and can log or take locks.
+ * 
  * @param signal_number Value of the signal recieved.
  * @param ctx           Context pointer provided by user.
  */
@@ -58,8 +126,15 @@ typedef void(*jproc_signal_handler_t)(int signal_number, void *ctx);
 /**
  * @brief Exits the program.
  * 
- * Before exiting, if available, calls handler
- * provided by user.
+ * Before exiting, shuts down in order: runs the handlers of
+ * every shutdown phase ( @c #JPROC_EXIT_PHASE_ACCEPT to
+ * @c #JPROC_EXIT_PHASE_FREE ), then the handler of
+ * @c #jproc_exit_setHandler() and frees the global logger.
+ * All phases share one deadline ( @c #jproc_exit_setTimeout() ),
+ * every phase gets at least @c #JPROC_EXIT_TIMEOUT_PHASE_MIN .
+ * 
+ * If called again during shutdown (f.ex. by a second
+ * interrupt), the process ends immediately with @c _exit() .
  * 
  * @param exit_value  Value to pass to @c exit() . 
  */
@@ -76,9 +151,47 @@ void jproc_exit(int exit_value);
  */
 int jproc_exit_setHandler(jproc_exit_handler_t handler, void *ctx);
 
+/**
+ * @brief Adds handler to shutdown phase of @c #jproc_exit() .
+ * 
+ * @param phase   Phase to run in (f.ex. @c #JPROC_EXIT_PHASE_DRAIN ).
+ * @param handler Handler function.
+ * @param ctx     Context pointer to pass to handler.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if phase is invalid or error occured.
+ */
+int jproc_exit_addShutdownHandler(int phase, jproc_shutdown_handler_t handler, void *ctx);
+
+/**
+ * @brief Removes handler added by @c #jproc_exit_addShutdownHandler() .
+ * 
+ * @param phase   Phase of handler.
+ * @param handler Handler function.
+ * @param ctx     Context pointer of handler.
+ * 
+ * @return        @c true , if handler was removed.
+ * @return        @c false , if handler was not found.
+ */
+int jproc_exit_removeShutdownHandler(int phase, jproc_shutdown_handler_t handler, void *ctx);
+
+/**
+ * @brief Sets time, all shutdown phases may take together.
+ * 
+ * @param timeout Time in milliseconds. Negative to wait for
+ *                all handlers without limit.
+ *                Default is @c #JPROC_EXIT_TIMEOUT_DEFAULT .
+ */
+void jproc_exit_setTimeout(long timeout);
+
 /**
  * @brief Adds handler to be called when signal is recieved.
  * 
+ * Installed with @c sigaction() and @c SA_RESTART , so
+ * interrupted system calls are restarted. In file descriptor
+ * mode the signal is blocked in the calling thread and added
+ * to the descriptor instead.
+ * 
  * @param signal_number Signal to call handler.
  * @param handler       Handler function.
  * @param ctx           Context pointer to pass to handler.
@@ -88,6 +201,55 @@ int jproc_exit_setHandler(jproc_exit_handler_t handler, void *ctx);
  */
 int jproc_signal_setHandler(int signal_number, jproc_signal_handler_t handler, void *ctx);
 
+/**
+ * @brief Delivers signals through a file descriptor.
+ * 
+ * Signals with handlers are blocked and queued on a
+ * @c signalfd() , that can be polled or added to an event loop.
+ * Handlers are called by @c #jproc_signal_dispatch() .
+ * 
+ * Signal mask is set for the calling thread and inherited by
+ * threads it creates, so it should be called by the main
+ * thread before other threads are started. Threads of the
+ * library block signals anyway.
+ * 
+ * @code
+ * jproc_signal_useFileDescriptor();
+ * jproc_signal_setHandler(SIGINT, &on_interrupt, NULL);
+ * 
+ * watcher.file_descriptor = jproc_signal_getFileDescriptor();
+ * watcher.events = JCON_EVENTLOOP_EVENT_READ;
+ * watcher.handler = &on_signal; // calls jproc_signal_dispatch()
+ * jcon_eventLoop_add(loop, &watcher);
+ * @endcode
+ * 
+ * @return  @c true , if successful.
+ * @return  @c false , if error occured.
+ */
+int jproc_signal_useFileDescriptor(void);
+
+/**
+ * @brief Returns descriptor of file descriptor mode.
+ * 
+ * Descriptor is non-blocking and becomes readable,
+ * when a signal is pending.
+ * 
+ * @return  File descriptor.
+ * @return  @c -1 , if file descriptor mode is not used.
+ */
+int jproc_signal_getFileDescriptor(void);
+
+/**
+ * @brief Calls handlers of pending signals.
+ * 
+ * Does not block, returns when no signal is pending.
+ * 
+ * @return  Number of handlers called.
+ * @return  @c -1 , if file descriptor mode is not used
+ *          or error occured.
+ */
+int jproc_signal_dispatch(void);
+
 #ifdef __cplusplus
 }
 #endif
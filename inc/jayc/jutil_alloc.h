@@ -0,0 +1,282 @@
+/**
+ * @file jutil_alloc.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Pluggable allocator for libjayc.
+ * 
+ * All modules of the library allocate through
+ * jutil_alloc, so an allocator like jemalloc, mimalloc or
+ * a pool can replace @c malloc() for the whole library:
+ * 
+ * @code
+ * static void *pool_malloc(void *ctx, size_t size);
+ * static void *pool_realloc(void *ctx, void *ptr, size_t size);
+ * static void pool_free(void *ctx, void *ptr);
+ * 
+ * jutil_alloc_allocator_t allocator = { &pool_malloc, &pool_realloc, &pool_free, pool };
+ * jutil_alloc_setAllocator(&allocator);
+ * @endcode
+ * 
+ * Memory has to be freed by the allocator, that allocated it,
+ * so the global allocator is set at start of the program,
+ * before objects of the library are created.
+ * 
+ * Some objects (f.ex. @c #jutil_map_allocator_init() ) take an
+ * allocator on initialization, that is used for the object
+ * and its entries instead of the global allocator.
+ * 
+ * Statistics count allocations, frees and requested bytes per
+ * module as counters of jutil_metrics, f.ex.
+ * @c jutil_alloc_bytes_total{module="jutil_map"} . They are
+ * disabled by default ( @c #jutil_alloc_setStatistics() ).
+ * The registry of jutil_metrics and strings returned by
+ * @c #jutil_metrics_format() use @c malloc() , so statistics
+ * can be recorded without recursion.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_ALLOC_H
+#define INCLUDE_JUTIL_ALLOC_H
+
+#include <jayc/jutil_metrics.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Functions of allocator.
+ * 
+ * All functions have to be thread safe, if the library
+ * is used by more than one thread.
+ */
+typedef struct __jutil_alloc_allocator
+{
+  void *(*alloc)(void *ctx, size_t size);              /**< Returns memory of @c size bytes. */
+  void *(*realloc)(void *ctx, void *ptr, size_t size); /**< Resizes memory returned by @c alloc , like @c realloc() . */
+  void (*free)(void *ctx, void *ptr);                  /**< Releases memory returned by @c alloc . */
+  void *ctx;                                           /**< Context passed to functions. */
+} jutil_alloc_allocator_t;
+
+/**
+ * @brief Statistics of module.
+ * 
+ * Defined once per source file with
+ * @c #JUTIL_ALLOC_MODULE() . Counters are registered at
+ * first allocation with statistics enabled.
+ */
+typedef struct __jutil_alloc_module
+{
+  const char *name_allocations;                        /**< Metric name of allocations. */
+  const char *name_frees;                              /**< Metric name of frees. */
+  const char *name_bytes;                              /**< Metric name of requested bytes. */
+  _Atomic(jutil_metrics_counter_t *) allocations;      /**< Counter of allocations. */
+  _Atomic(jutil_metrics_counter_t *) frees;            /**< Counter of frees. */
+  _Atomic(jutil_metrics_counter_t *) bytes;            /**< Counter of requested bytes. */
+} jutil_alloc_module_t;
+
+/**
+ * @brief Sets global allocator.
+ * 
+ * By default memory is taken from @c malloc() .
+ * 
+ * Not thread safe. Has to be set, before the library
+ * allocates memory, because memory is released with
+ * the allocator, that is set at release.
+ * 
+ * @param allocator Functions to use. Are copied.
+ *                  @c NULL restores default.
+ * 
+ * @return          @c true , if allocator was set.
+ * @return          @c false , if functions are missing.
+ */
+int jutil_alloc_setAllocator(const jutil_alloc_allocator_t *allocator);
+
+/**
+ * @brief Enables or disables statistics.
+ * 
+ * Without jutil_metrics ( @c JUTIL_NO_METRICS ) nothing
+ * is counted.
+ * 
+ * @param enable @c true to count allocations.
+ */
+void jutil_alloc_setStatistics(int enable);
+
+/**
+ * @brief Allocates memory.
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param size      Size in bytes.
+ * 
+ * @return          Pointer to memory.
+ * @return          @c NULL , if error occured.
+ */
+void *jutil_alloc_malloc(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, size_t size);
+
+/**
+ * @brief Allocates array and sets it to @c 0 .
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param number    Number of elements.
+ * @param size      Size of element in bytes.
+ * 
+ * @return          Pointer to memory.
+ * @return          @c NULL , if error occured or size overflows.
+ */
+void *jutil_alloc_calloc(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, size_t number, size_t size);
+
+/**
+ * @brief Resizes memory.
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param ptr       Memory to resize, or @c NULL .
+ * @param size      New size in bytes.
+ * 
+ * @return          Pointer to memory.
+ * @return          @c NULL , if error occured ( @c ptr stays valid).
+ */
+void *jutil_alloc_realloc(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, void *ptr, size_t size);
+
+/**
+ * @brief Frees memory.
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param ptr       Memory to free, or @c NULL .
+ */
+void jutil_alloc_free(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, void *ptr);
+
+/**
+ * @brief Allocates aligned memory.
+ * 
+ * Has to be freed with @c #jutil_alloc_freeAligned() .
+ * Without allocator @c aligned_alloc() is used, allocators
+ * get a larger block, that is aligned inside.
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param alignment Power of 2 (f.ex. @c 64 for cache lines).
+ * @param size      Size in bytes.
+ * 
+ * @return          Pointer to memory.
+ * @return          @c NULL , if error occured.
+ */
+void *jutil_alloc_mallocAligned(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, size_t alignment, size_t size);
+
+/**
+ * @brief Frees memory of @c #jutil_alloc_mallocAligned() .
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param ptr       Memory to free, or @c NULL .
+ */
+void jutil_alloc_freeAligned(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, void *ptr);
+
+/**
+ * @brief Copies string.
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param string    String to copy.
+ * 
+ * @return          Copy of string.
+ * @return          @c NULL , if error occured.
+ */
+char *jutil_alloc_strdup(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, const char *string);
+
+/**
+ * @brief Copies part of string.
+ * 
+ * Copies at most @c length bytes and terminates copy.
+ * 
+ * @param allocator Allocator of object, or @c NULL for
+ *                  global allocator.
+ * @param module    Statistics of module, or @c NULL .
+ * @param string    String to copy.
+ * @param length    Maximum number of bytes to copy.
+ * 
+ * @return          Copy of string.
+ * @return          @c NULL , if error occured.
+ */
+char *jutil_alloc_strndup(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, const char *string, size_t length);
+
+
+
+//==============================================================================
+// Define macros.
+//
+
+/**
+ * @brief Defines statistics of module for macros of source file.
+ * 
+ * @param name Name of module (string literal).
+ */
+#define JUTIL_ALLOC_MODULE(name) \
+  static jutil_alloc_module_t jutil_alloc_module = \
+  { \
+    "jutil_alloc_allocations_total{module=\"" name "\"}", \
+    "jutil_alloc_frees_total{module=\"" name "\"}", \
+    "jutil_alloc_bytes_total{module=\"" name "\"}", \
+    NULL, NULL, NULL \
+  }
+
+/**
+ * @brief @c malloc() with global allocator.
+ */
+#define JUTIL_ALLOC_MALLOC(size) jutil_alloc_malloc(NULL, &jutil_alloc_module, size)
+
+/**
+ * @brief @c calloc() with global allocator.
+ */
+#define JUTIL_ALLOC_CALLOC(number, size) jutil_alloc_calloc(NULL, &jutil_alloc_module, number, size)
+
+/**
+ * @brief @c realloc() with global allocator.
+ */
+#define JUTIL_ALLOC_REALLOC(ptr, size) jutil_alloc_realloc(NULL, &jutil_alloc_module, ptr, size)
+
+/**
+ * @brief @c free() with global allocator.
+ */
+#define JUTIL_ALLOC_FREE(ptr) jutil_alloc_free(NULL, &jutil_alloc_module, ptr)
+
+/**
+ * @brief @c aligned_alloc() with global allocator.
+ */
+#define JUTIL_ALLOC_MALLOC_ALIGNED(alignment, size) jutil_alloc_mallocAligned(NULL, &jutil_alloc_module, alignment, size)
+
+/**
+ * @brief Frees memory of @c #JUTIL_ALLOC_MALLOC_ALIGNED() .
+ */
+#define JUTIL_ALLOC_FREE_ALIGNED(ptr) jutil_alloc_freeAligned(NULL, &jutil_alloc_module, ptr)
+
+/**
+ * @brief @c strdup() with global allocator.
+ */
+#define JUTIL_ALLOC_STRDUP(string) jutil_alloc_strdup(NULL, &jutil_alloc_module, string)
+
+/**
+ * @brief @c strndup() with global allocator.
+ */
+#define JUTIL_ALLOC_STRNDUP(string, length) jutil_alloc_strndup(NULL, &jutil_alloc_module, string, length)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_ALLOC_H */
@@ -0,0 +1,242 @@
+/**
+ * @file jutil_arena.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Arena allocator for objects with the same lifetime.
+ * 
+ * Allocations move a pointer forward in a block of memory,
+ * new blocks are added, when a block is full. Single objects
+ * are never freed, everything is released at once with
+ * @c #jutil_arena_reset() , f.ex. after a request was handled:
+ * 
+ * @code
+ * void handle_request(jutil_arena_t *arena, const char *line)
+ * {
+ *   char *copy = jutil_arena_strdup(arena, line);
+ *   request_t *request = jutil_arena_alloc(arena, sizeof(request_t));
+ *   // parse and handle request
+ *   jutil_arena_reset(arena);
+ * }
+ * @endcode
+ * 
+ * Marks ( @c #jutil_arena_getMark() and @c #jutil_arena_rewind() )
+ * release only what was allocated after the mark, so nested
+ * regions can share one arena.
+ * 
+ * Blocks are kept after a reset and reused, so an arena,
+ * that is reset per request, stops allocating memory,
+ * once it reached the size of the largest request.
+ * Allocations larger than a block get their own block,
+ * which is freed at reset.
+ * 
+ * An arena is not thread safe. It should be used by one
+ * thread (f.ex. one per event loop).
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_ARENA_H
+#define INCLUDE_JUTIL_ARENA_H
+
+#include <jayc/jutil_alloc.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Size of blocks, if @c 0 is given at initialization.
+ */
+#define JUTIL_ARENA_BLOCKSIZE_DEFAULT (64 * 1024)
+
+/**
+ * @brief Alignment of @c #jutil_arena_alloc() .
+ * 
+ * Enough for every standard type.
+ */
+#define JUTIL_ARENA_ALIGNMENT_DEFAULT (_Alignof(max_align_t))
+
+/**
+ * @brief Back blocks with huge pages.
+ * 
+ * Blocks are rounded up to 2 MiB and mapped with
+ * @c MAP_HUGETLB . If no huge pages are reserved,
+ * transparent huge pages are requested with @c madvise() .
+ */
+#define JUTIL_ARENA_FLAG_HUGEPAGES 0x01
+
+/**
+ * @brief Object pointer.
+ */
+typedef struct __jutil_arena jutil_arena_t;
+
+/**
+ * @brief Position in arena, to release later allocations.
+ * 
+ * Only valid until the arena is reset or rewound to
+ * an earlier mark.
+ */
+typedef struct __jutil_arena_mark
+{
+  void *block;  /**< Current block at time of mark. */
+  size_t used;  /**< Used bytes of block. */
+} jutil_arena_mark_t;
+
+/**
+ * @brief Initializes empty arena.
+ * 
+ * First block is allocated with first allocation.
+ * 
+ * @param block_size Size of blocks in bytes. @c 0 for
+ *                   @c #JUTIL_ARENA_BLOCKSIZE_DEFAULT .
+ * @param flags      @c 0 or @c #JUTIL_ARENA_FLAG_HUGEPAGES .
+ * 
+ * @return           Arena object.
+ * @return           @c NULL , if error occured.
+ */
+jutil_arena_t *jutil_arena_init(size_t block_size, int flags);
+
+/**
+ * @brief Initializes empty arena with own allocator.
+ * 
+ * Arena and its blocks are allocated with @c allocator
+ * instead of the global allocator of jutil_alloc.
+ * Blocks of huge pages are always mapped.
+ * 
+ * @param block_size Size of blocks in bytes. @c 0 for
+ *                   @c #JUTIL_ARENA_BLOCKSIZE_DEFAULT .
+ * @param flags      @c 0 or @c #JUTIL_ARENA_FLAG_HUGEPAGES .
+ * @param allocator  Functions to use. Are copied.
+ *                   @c NULL for global allocator.
+ * 
+ * @return           Arena object.
+ * @return           @c NULL , if error occured.
+ */
+jutil_arena_t *jutil_arena_allocator_init(size_t block_size, int flags, const jutil_alloc_allocator_t *allocator);
+
+/**
+ * @brief Frees arena and all its blocks.
+ * 
+ * @param arena Arena to free.
+ */
+void jutil_arena_free(jutil_arena_t *arena);
+
+/**
+ * @brief Allocates memory with default alignment.
+ * 
+ * @param arena Arena object.
+ * @param size  Size in bytes.
+ * 
+ * @return      Pointer to memory. Valid until reset.
+ * @return      @c NULL , if error occured.
+ */
+void *jutil_arena_alloc(jutil_arena_t *arena, size_t size);
+
+/**
+ * @brief Allocates memory with alignment.
+ * 
+ * @param arena     Arena object.
+ * @param size      Size in bytes.
+ * @param alignment Power of 2 (f.ex. @c 64 for cache lines).
+ * 
+ * @return          Pointer to memory. Valid until reset.
+ * @return          @c NULL , if error occured.
+ */
+void *jutil_arena_allocAligned(jutil_arena_t *arena, size_t size, size_t alignment);
+
+/**
+ * @brief Allocates array and sets it to @c 0 .
+ * 
+ * @param arena  Arena object.
+ * @param number Number of elements.
+ * @param size   Size of element in bytes.
+ * 
+ * @return       Pointer to memory. Valid until reset.
+ * @return       @c NULL , if error occured or size overflows.
+ */
+void *jutil_arena_calloc(jutil_arena_t *arena, size_t number, size_t size);
+
+/**
+ * @brief Copies string into arena.
+ * 
+ * @param arena  Arena object.
+ * @param string String to copy.
+ * 
+ * @return       Copy of string. Valid until reset.
+ * @return       @c NULL , if error occured.
+ */
+char *jutil_arena_strdup(jutil_arena_t *arena, const char *string);
+
+/**
+ * @brief Copies part of string into arena.
+ * 
+ * Copies at most @c length bytes and terminates copy.
+ * 
+ * @param arena  Arena object.
+ * @param string String to copy.
+ * @param length Maximum number of bytes to copy.
+ * 
+ * @return       Copy of string. Valid until reset.
+ * @return       @c NULL , if error occured.
+ */
+char *jutil_arena_strndup(jutil_arena_t *arena, const char *string, size_t length);
+
+/**
+ * @brief Releases all allocations.
+ * 
+ * Blocks of default size are kept for reuse,
+ * larger blocks are freed.
+ * 
+ * @param arena Arena object.
+ */
+void jutil_arena_reset(jutil_arena_t *arena);
+
+/**
+ * @brief Returns current position.
+ * 
+ * @param arena Arena object.
+ * 
+ * @return      Mark for @c #jutil_arena_rewind() .
+ */
+jutil_arena_mark_t jutil_arena_getMark(jutil_arena_t *arena);
+
+/**
+ * @brief Releases all allocations after mark.
+ * 
+ * Allocations before the mark stay valid.
+ * 
+ * @param arena Arena object.
+ * @param mark  Mark of same arena.
+ */
+void jutil_arena_rewind(jutil_arena_t *arena, jutil_arena_mark_t mark);
+
+/**
+ * @brief Returns allocated bytes since last reset.
+ * 
+ * Includes padding for alignment.
+ * 
+ * @param arena Arena object.
+ * 
+ * @return      Number of bytes.
+ */
+size_t jutil_arena_getUsed(jutil_arena_t *arena);
+
+/**
+ * @brief Returns size of all blocks of arena.
+ * 
+ * Includes blocks kept for reuse.
+ * 
+ * @param arena Arena object.
+ * 
+ * @return      Number of bytes.
+ */
+size_t jutil_arena_getCapacity(jutil_arena_t *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_ARENA_H */
@@ -0,0 +1,263 @@
+/**
+ * @file jutil_buffer.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Reference counted buffer of memory segments.
+ * 
+ * A buffer is a chain of segments, every segment is a part
+ * of a reference counted block of memory. Slices and appended
+ * buffers reference the same blocks, so a payload is copied
+ * once and shared by every layer, that passes it on:
+ * 
+ * @code
+ * jutil_buffer_t *payload = jutil_buffer_copy_init(data, size);
+ * jcon_system_broadcastBuffer(system, payload, NULL, NULL);
+ * jlog_async_logBuffer(logger, JLOG_LOGTYPE_DEBUG, payload);
+ * jutil_buffer_free(payload);
+ * @endcode
+ * 
+ * Every holder owns one reference ( @c #jutil_buffer_ref() ),
+ * that is released with @c #jutil_buffer_free() . Blocks are
+ * freed with the last buffer, that references them.
+ * 
+ * Buffers are changed only by their creator, before they are
+ * shared. Functions, that change a buffer, fail, if it has
+ * more than one reference. Shared buffers can be read by
+ * multiple threads.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_BUFFER_H
+#define INCLUDE_JUTIL_BUFFER_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Minimum size of blocks allocated by buffers.
+ */
+#define JUTIL_BUFFER_BLOCKSIZE_DEFAULT 4096
+
+/**
+ * @brief Object pointer.
+ */
+typedef struct __jutil_buffer jutil_buffer_t;
+
+/**
+ * @brief Releases memory given to @c #jutil_buffer_wrap_init() .
+ * 
+ * Called, when last reference to memory is released.
+ * Can be called from any thread, that holds a reference.
+ * 
+ * @param ctx  Context pointer given at initialization.
+ * @param data Wrapped memory.
+ */
+typedef void(*jutil_buffer_freeFunction_t)(void *ctx, void *data);
+
+/**
+ * @brief Initializes empty buffer.
+ * 
+ * @param capacity Bytes to allocate for first block.
+ *                 @c 0 allocates at first write.
+ * 
+ * @return         Buffer with one reference.
+ * @return         @c NULL , if error occured.
+ */
+jutil_buffer_t *jutil_buffer_init(size_t capacity);
+
+/**
+ * @brief Initializes buffer with copy of data.
+ * 
+ * @param data Data to copy.
+ * @param size Size of data in bytes.
+ * 
+ * @return     Buffer with one reference.
+ * @return     @c NULL , if error occured.
+ */
+jutil_buffer_t *jutil_buffer_copy_init(const void *data, size_t size);
+
+/**
+ * @brief Initializes buffer, that references memory without copy.
+ * 
+ * Memory is read only for the buffer and has to stay valid,
+ * until @c function_free is called.
+ * 
+ * @param data          Memory to reference.
+ * @param size          Size of memory in bytes.
+ * @param function_free Function to release memory with last
+ *                      reference. @c NULL , if memory is not
+ *                      released by buffer.
+ * @param ctx           Context pointer passed to @c function_free .
+ * 
+ * @return              Buffer with one reference.
+ * @return              @c NULL , if error occured ( @c function_free
+ *                      is not called).
+ */
+jutil_buffer_t *jutil_buffer_wrap_init(void *data, size_t size, jutil_buffer_freeFunction_t function_free, void *ctx);
+
+/**
+ * @brief Adds reference to buffer.
+ * 
+ * @param buffer Buffer to reference.
+ * 
+ * @return       @c buffer .
+ */
+jutil_buffer_t *jutil_buffer_ref(jutil_buffer_t *buffer);
+
+/**
+ * @brief Releases reference to buffer.
+ * 
+ * Buffer is freed with last reference.
+ * 
+ * @param buffer Buffer to release.
+ */
+void jutil_buffer_free(jutil_buffer_t *buffer);
+
+/**
+ * @brief Creates buffer, that references part of buffer.
+ * 
+ * No data is copied.
+ * 
+ * @param buffer Buffer to slice.
+ * @param offset Start of slice in bytes.
+ * @param length Size of slice in bytes.
+ * 
+ * @return       New buffer with one reference.
+ * @return       @c NULL , if range exceeds buffer or error occured.
+ */
+jutil_buffer_t *jutil_buffer_slice(jutil_buffer_t *buffer, size_t offset, size_t length);
+
+/**
+ * @brief Copies data to end of buffer.
+ * 
+ * Data is written behind the last segment, if its
+ * block has space, else a new block is added.
+ * 
+ * @param buffer Buffer to append to.
+ * @param data   Data to copy.
+ * @param size   Size of data in bytes.
+ * 
+ * @return       @c true , if data was appended.
+ * @return       @c false , if buffer is shared or error occured.
+ */
+int jutil_buffer_append(jutil_buffer_t *buffer, const void *data, size_t size);
+
+/**
+ * @brief Appends segments of other buffer without copy.
+ * 
+ * @param buffer Buffer to append to.
+ * @param source Buffer, whose segments are referenced.
+ *               Stays valid and has to be freed by caller.
+ * 
+ * @return       @c true , if segments were appended.
+ * @return       @c false , if buffer is shared or error occured.
+ */
+int jutil_buffer_appendBuffer(jutil_buffer_t *buffer, jutil_buffer_t *source);
+
+/**
+ * @brief Returns space to write to behind last segment.
+ * 
+ * Data of the last segment stays contiguous with
+ * the space, so it is moved to the start of its block
+ * or to a new block, if the block is full.
+ * Written bytes are added with @c #jutil_buffer_commit() ,
+ * f.ex. after @c recv() wrote into the space.
+ * 
+ * @param buffer    Buffer to write to.
+ * @param size      Minimum number of bytes.
+ * @param available Set to number of bytes, that can be written.
+ *                  Can be @c NULL .
+ * 
+ * @return          Pointer to space.
+ * @return          @c NULL , if buffer is shared or error occured.
+ */
+void *jutil_buffer_reserve(jutil_buffer_t *buffer, size_t size, size_t *available);
+
+/**
+ * @brief Adds bytes written to space of @c #jutil_buffer_reserve() .
+ * 
+ * @param buffer Buffer written to.
+ * @param size   Number of written bytes.
+ */
+void jutil_buffer_commit(jutil_buffer_t *buffer, size_t size);
+
+/**
+ * @brief Removes bytes from start of buffer.
+ * 
+ * Blocks are released, when no segment uses them anymore.
+ * 
+ * @param buffer Buffer to remove from.
+ * @param size   Number of bytes.
+ */
+void jutil_buffer_consume(jutil_buffer_t *buffer, size_t size);
+
+/**
+ * @brief Returns size of data in buffer.
+ * 
+ * @param buffer Buffer object.
+ * 
+ * @return       Number of bytes over all segments.
+ */
+size_t jutil_buffer_getSize(jutil_buffer_t *buffer);
+
+/**
+ * @brief Returns data of first segment.
+ * 
+ * @param buffer Buffer object.
+ * @param size   Set to size of segment. Can be @c NULL .
+ * 
+ * @return       Pointer to data.
+ * @return       @c NULL , if buffer is empty.
+ */
+const void *jutil_buffer_getData(jutil_buffer_t *buffer, size_t *size);
+
+/**
+ * @brief Fills array of buffers with segments, f.ex. for @c writev() .
+ * 
+ * @param buffer  Buffer object.
+ * @param offset  Bytes to skip at start of buffer.
+ * @param iov     Array to fill.
+ * @param iov_max Number of elements in @c iov .
+ * 
+ * @return        Number of elements filled.
+ */
+int jutil_buffer_getIovec(jutil_buffer_t *buffer, size_t offset, struct iovec *iov, int iov_max);
+
+/**
+ * @brief Copies data of buffer into memory.
+ * 
+ * @param buffer Buffer object.
+ * @param offset Bytes to skip at start of buffer.
+ * @param dest   Memory to copy to.
+ * @param size   Maximum number of bytes to copy.
+ * 
+ * @return       Number of bytes copied.
+ */
+size_t jutil_buffer_copyOut(jutil_buffer_t *buffer, size_t offset, void *dest, size_t size);
+
+/**
+ * @brief Returns data of buffer as one segment.
+ * 
+ * Segments are copied into a new block, if there
+ * is more than one.
+ * 
+ * @param buffer Buffer object.
+ * 
+ * @return       Pointer to data. Valid until buffer is changed.
+ * @return       @c NULL , if buffer is empty, shared with more
+ *               than one segment, or error occured.
+ */
+const void *jutil_buffer_flatten(jutil_buffer_t *buffer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_BUFFER_H */
@@ -4,6 +4,11 @@
  * 
  * @brief Interface for managing CLI input.
  * 
+ * Lines are split into arguments at spaces and tabs. Single
+ * and double quotes group arguments with spaces, a backslash
+ * escapes the next character (also inside double quotes).
+ * Arguments are terminated in place, not copied.
+ * 
  * @date 2020-10-07
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
@@ -12,6 +17,7 @@
 #ifndef INCLUDE_JUTIL_CLI_H
 #define INCLUDE_JUTIL_CLI_H
 
+#include <jayc/jutil_arena.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -36,8 +42,9 @@ typedef int(*jutil_cli_cmdHandler_t)(const char **args, size_t arg_size, void *c
  * must return string without newline character.
  * 
  * @c *buf_ptr should be set to @c NULL before call.
- * Function should allocate buffer for string and
- * set @c *buf_size accordingly.
+ * Function should allocate buffer for string with
+ * @c malloc() and set @c *buf_size accordingly.
+ * Buffer is freed with @c free() .
  * 
  * @param ctx       Context pointer passed by @c #jutil_cli_run() .
  * @param buf_ptr   Pointer to empty buffer, allocated and set by function.
@@ -83,6 +90,55 @@ void jutil_cli_free(jutil_cli_t *session);
  */
 int jutil_cli_run(jutil_cli_t *session);
 
+/**
+ * @brief Runs commands of script, until end of file.
+ * 
+ * Reads with a large buffer and calls handler once per
+ * line. Empty lines and lines starting with @c '#' are
+ * skipped. Input function of session is not used.
+ * 
+ * @param session         Session object.
+ * @param file_descriptor File to read (f.ex. @c STDIN_FILENO ).
+ * 
+ * @return                Number of commands run.
+ * @return                @c -1 , if error occured.
+ */
+long jutil_cli_runBatch(jutil_cli_t *session, int file_descriptor);
+
+/**
+ * @brief Stops @c #jutil_cli_runBatch() after current command.
+ * 
+ * Called from handler (f.ex. for an exit command).
+ * 
+ * @param session Session object.
+ */
+void jutil_cli_stop(jutil_cli_t *session);
+
+/**
+ * @brief Splits line into arguments in place.
+ * 
+ * @param line      Line to split. Is modified, arguments point into it.
+ * @param args      Array for arguments.
+ * @param args_max  Size of array. Further arguments are ignored.
+ * @param arg_size  Set to number of arguments.
+ * 
+ * @return          @c true , if successful.
+ * @return          @c false , if quote is not closed or error occured.
+ */
+int jutil_cli_tokenize(char *line, const char **args, size_t args_max, size_t *arg_size);
+
+/**
+ * @brief Returns arena of session.
+ * Arguments passed to the handler are stored in it.
+ * It is reset after the handler returns, so handlers
+ * can allocate temporary data for a command from it
+ * (f.ex. by passing the session in the context pointer).
+ * @param session Session object.
+ * @return        Arena of session.
+ * @return        @c NULL , if session is @c NULL .
+ */
+jutil_arena_t *jutil_cli_getArena(jutil_cli_t *session);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,192 @@
+/**
+ * @file jutil_cmap.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief String indexed map for concurrent readers.
+ * 
+ * Lookups take no lock and write no shared memory, so
+ * they scale with the number of reading threads.
+ * Modifications are serialized by a mutex and wait
+ * for running lookups, before memory is released.
+ * Meant for data, that is read a lot and changed rarely.
+ * 
+ * Data returned by @c #jutil_cmap_get() is only protected
+ * by the map during a read section
+ * ( @c #jutil_cmap_readBegin() to @c #jutil_cmap_readEnd() ).
+ * Data returned by @c #jutil_cmap_remove() or replaced by
+ * @c #jutil_cmap_set() is not used by any read section
+ * anymore and can be freed.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_CMAP_H
+#define INCLUDE_JUTIL_CMAP_H
+
+#include <jayc/jutil_map.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Object pointer.
+ */
+typedef struct __jutil_cmap jutil_cmap_t;
+
+/**
+ * @brief Initializes map object.
+ * 
+ * @return  Map object pointer.
+ * @return  @c NULL , if error occured.
+ */
+jutil_cmap_t *jutil_cmap_init();
+
+/**
+ * @brief Clears map and frees memory.
+ * 
+ * No other thread may use the map anymore.
+ * 
+ * @param map Map object to free.
+ */
+void jutil_cmap_free(jutil_cmap_t *map);
+
+/**
+ * @brief Starts read section for calling thread.
+ * 
+ * Until @c #jutil_cmap_readEnd() , data and pairs returned
+ * by the map are not released by other threads.
+ * Sections can be nested. Threads should not block
+ * inside a section, because writers wait for it.
+ * 
+ * @return  @c true , if section was started.
+ * @return  @c false , if error occured.
+ */
+int jutil_cmap_readBegin();
+
+/**
+ * @brief Ends read section of calling thread.
+ */
+void jutil_cmap_readEnd();
+
+/**
+ * @brief Add data to map at @c index .
+ * 
+ * @param map   Map object.
+ * @param index Index for new data.
+ * @param data  Data to store.
+ * 
+ * @return      @c true , if successfully stored.
+ * @return      @c false , if index exists or error occured.
+ */
+int jutil_cmap_add(jutil_cmap_t *map, const char *index, void *data);
+
+/**
+ * @brief Removes data from map.
+ * 
+ * Waits for read sections, that could still see the data.
+ * Must not be called inside a read section.
+ * 
+ * @param map   Map object.
+ * @param index Index of data to remove.
+ * 
+ * @return      Data pointer.
+ * @return      @c NULL , if error occured.
+ */
+void *jutil_cmap_remove(jutil_cmap_t *map, const char *index);
+
+/**
+ * @brief Checks if index is in map.
+ * 
+ * Takes no lock.
+ * 
+ * @param map   Map object to check.
+ * @param index Index to check.
+ * 
+ * @return      @c true , if index is in map.
+ * @return      @c false , if index is not in map or error occured.
+ */
+int jutil_cmap_contains(jutil_cmap_t *map, const char *index);
+
+/**
+ * @brief Get data with index.
+ * 
+ * Takes no lock.
+ * 
+ * @param map   Map to search.
+ * @param index Index to search for.
+ * 
+ * @return      Data stored with @c index.
+ * @return      @c NULL , if @c index is not in map
+ *              or error occured.
+ */
+void *jutil_cmap_get(jutil_cmap_t *map, const char *index);
+
+/**
+ * @brief Change data stored at index.
+ * 
+ * If index is not contained in map,
+ * new entry is created.
+ * 
+ * If data was replaced, waits for read sections,
+ * that could still see the old data.
+ * Must not be called inside a read section.
+ * 
+ * @param map      Map object.
+ * @param index    Index for data.
+ * @param data     New data to store.
+ * @param old_data Returns replaced data ( @c NULL , if index was new).
+ *                 Can be @c NULL .
+ * 
+ * @return         @c true , if data was stored.
+ * @return         @c false , if error occured.
+ */
+int jutil_cmap_set(jutil_cmap_t *map, const char *index, void *data, void **old_data);
+
+/**
+ * @brief Check number of items in map.
+ * 
+ * @param map Map to check.
+ * 
+ * @return    Number of elements.
+ * @return    @c 0 , if map empty or error occured.
+ */
+size_t jutil_cmap_size(jutil_cmap_t *map);
+
+/**
+ * @brief Remove all items from map.
+ * 
+ * Waits for running read sections.
+ * Must not be called inside a read section.
+ * 
+ * <b>Note:</b>
+ * Does not free memory of data.
+ * 
+ * @param map Map object to clear.
+ */
+void jutil_cmap_clear(jutil_cmap_t *map);
+
+/**
+ * @brief Iterates through map and returns data pairs.
+ * 
+ * Has to be called inside a read section. Pairs added
+ * or removed during iteration may or may not be returned.
+ * 
+ * @param map Map to search.
+ * @param itr Iterator reference, function will
+ *            return next data pair.
+ *            If @c NULL , gets first data pair.
+ * 
+ * @return    Next pair in map.
+ * @return    @c NULL , if no new data or error occured.
+ */
+const jutil_map_data_t *jutil_cmap_iterate(jutil_cmap_t *map, const jutil_map_data_t *itr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_CMAP_H */
@@ -12,6 +12,7 @@
 #ifndef INCLUDE_JUTIL_CRYPTO_H
 #define INCLUDE_JUTIL_CRYPTO_H
 
+#include <jayc/jutil_threadpool.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -96,6 +97,206 @@ int jutil_crypto_sha512_raw(const char *input, size_t size_input, unsigned char
  */
 int jutil_crypto_sha512_str(const char *input, size_t size_input, char *output);
 
+
+
+//==============================================================================
+// Streaming hashes.
+//
+
+/**
+ * @brief md5 hash (16 bytes).
+ */
+#define JUTIL_CRYPTO_HASH_MD5 0
+
+/**
+ * @brief 256bit sha hash (32 bytes).
+ */
+#define JUTIL_CRYPTO_HASH_SHA256 1
+
+/**
+ * @brief 512bit sha hash (64 bytes).
+ */
+#define JUTIL_CRYPTO_HASH_SHA512 2
+
+/**
+ * @brief Size of largest hash in bytes.
+ */
+#define JUTIL_CRYPTO_SIZE_HASH_MAX 64
+
+/**
+ * @brief Hash, that is computed over data given in parts.
+ * 
+ * Uses the EVP interface of OpenSSL, so the fastest
+ * implementation for the CPU is used.
+ */
+typedef struct __jutil_crypto_hash jutil_crypto_hash_t;
+
+/**
+ * @brief Returns size of hash type.
+ * 
+ * @param type  Hash type (f.ex. @c #JUTIL_CRYPTO_HASH_SHA256 ).
+ * 
+ * @return      Size of hash in bytes.
+ * @return      @c 0 , if type is unknown.
+ */
+size_t jutil_crypto_hash_getSize(int type);
+
+/**
+ * @brief Creates hash context.
+ * 
+ * @param type  Hash type (f.ex. @c #JUTIL_CRYPTO_HASH_SHA256 ).
+ * 
+ * @return      Hash context.
+ * @return      @c NULL , if type is unknown or error occured.
+ */
+jutil_crypto_hash_t *jutil_crypto_hash_init(int type);
+
+/**
+ * @brief Adds data to hash.
+ * 
+ * @param session Hash context.
+ * @param data    Data to add.
+ * @param size    Size of data.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+int jutil_crypto_hash_update(jutil_crypto_hash_t *session, const void *data, size_t size);
+
+/**
+ * @brief Writes hash of all added data and starts new hash.
+ * 
+ * Context can be used for the next hash afterwards.
+ * 
+ * @param session Hash context.
+ * @param output  Buffer to save output. Must be at least
+ *                size of hash ( @c #JUTIL_CRYPTO_SIZE_HASH_MAX ).
+ * 
+ * @return        Size of hash in bytes.
+ * @return        @c 0 , if error occured.
+ */
+size_t jutil_crypto_hash_final(jutil_crypto_hash_t *session, unsigned char *output);
+
+/**
+ * @brief Frees hash context.
+ * 
+ * @param session Context to free.
+ */
+void jutil_crypto_hash_free(jutil_crypto_hash_t *session);
+
+/**
+ * @brief Generates hash of file.
+ * 
+ * Regular files are hashed completely through @c mmap() ,
+ * independent of the file offset. Other descriptors (pipes,
+ * sockets) are read in large blocks until end of file.
+ * 
+ * @param type            Hash type (f.ex. @c #JUTIL_CRYPTO_HASH_SHA256 ).
+ * @param file_descriptor File to hash.
+ * @param output          Buffer to save output. Must be at least
+ *                        size of hash ( @c #JUTIL_CRYPTO_SIZE_HASH_MAX ).
+ * 
+ * @return                Size of hash in bytes.
+ * @return                @c 0 , if error occured.
+ */
+size_t jutil_crypto_hashFile(int type, int file_descriptor, unsigned char *output);
+
+/**
+ * @brief Generates hashes of many independent messages.
+ * 
+ * Messages are hashed one after another with the digest context
+ * of the hashing thread, so there is no allocation per message.
+ * Large batches are split between workers of pool and
+ * calling thread.
+ * 
+ * @param type    Hash type (f.ex. @c #JUTIL_CRYPTO_HASH_SHA256 ).
+ * @param inputs  Messages.
+ * @param sizes   Size of each message.
+ * @param outputs Buffer for hash of each message. Must be at
+ *                least size of hash ( @c #JUTIL_CRYPTO_SIZE_HASH_MAX ).
+ * @param count   Number of messages.
+ * @param pool    Pool for large batches. If @c NULL , all messages
+ *                are hashed by calling thread.
+ * 
+ * @return        @c true , if all hashes were generated.
+ * @return        @c false , if error occured.
+ */
+int jutil_crypto_hashBatch(int type, const void *const inputs[], const size_t sizes[], unsigned char *const outputs[], size_t count, jutil_threadpool_t *pool);
+
+/**
+ * @brief Generates 256bit sha hashes of many independent messages.
+ * 
+ * @param inputs  Messages.
+ * @param sizes   Size of each message.
+ * @param outputs Buffer for hash of each message.
+ *                Must be at least size <tt>char buf[32]</tt>.
+ * @param count   Number of messages.
+ * @param pool    Pool for large batches, can be @c NULL .
+ * 
+ * @return        @c true , if all hashes were generated.
+ * @return        @c false , if error occured.
+ * 
+ * @see jutil_crypto_hashBatch()
+ */
+int jutil_crypto_sha256_batch(const void *const inputs[], const size_t sizes[], unsigned char *const outputs[], size_t count, jutil_threadpool_t *pool);
+
+
+
+//==============================================================================
+// Encodings.
+//
+
+/**
+ * @brief Size of buffer for base64 text of data,
+ *        including terminating null.
+ */
+#define JUTIL_CRYPTO_SIZE_BASE64(size) ((((size) + 2) / 3) * 4 + 1)
+
+/**
+ * @brief Maximum size of data decoded from base64 text.
+ */
+#define JUTIL_CRYPTO_SIZE_BASE64_DECODED(length) (((length) / 4) * 3)
+
+/**
+ * @brief Writes data as lowercase hexstring.
+ * 
+ * @param data    Data to encode.
+ * @param size    Size of data.
+ * @param output  Buffer to save output.
+ *                Must be at least size <tt>char buf[size*2+1]</tt>.
+ * 
+ * @return        Length of hexstring (without terminating null).
+ */
+size_t jutil_crypto_toHex(const void *data, size_t size, char *output);
+
+/**
+ * @brief Writes data as base64 text (RFC 4648, with padding).
+ * 
+ * @param data    Data to encode.
+ * @param size    Size of data.
+ * @param output  Buffer to save output. Must be at least
+ *                size @c #JUTIL_CRYPTO_SIZE_BASE64(size) .
+ * 
+ * @return        Length of text (without terminating null).
+ */
+size_t jutil_crypto_base64_encode(const void *data, size_t size, char *output);
+
+/**
+ * @brief Decodes base64 text (RFC 4648, with padding).
+ * 
+ * Text must not contain whitespace or line breaks.
+ * 
+ * @param input       Base64 text.
+ * @param length      Length of text, must be a multiple of 4.
+ * @param output      Buffer to save output. Must be at least size
+ *                    @c #JUTIL_CRYPTO_SIZE_BASE64_DECODED(length) .
+ * @param size_output Set to size of decoded data, if not @c NULL .
+ * 
+ * @return            @c true , if successful.
+ * @return            @c false , if text is invalid.
+ */
+int jutil_crypto_base64_decode(const char *input, size_t length, unsigned char *output, size_t *size_output);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,71 @@
+/**
+ * @file jutil_hash.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Fast non-cryptographic hash for hash tables and sharding.
+ * 
+ * @c #jutil_hash64() follows the design of wyhash: input is read
+ * in 8 byte words, mixed with 64x64 to 128 bit multiplications,
+ * and long inputs are processed in three independent lanes, so
+ * the CPU can run the multiplications in parallel.
+ * 
+ * Hashes depend on the seed. Tables, that store keys from the
+ * network, should use @c #jutil_hash_getRandomSeed() , so an
+ * attacker can not precompute keys, that collide.
+ * 
+ * Hashes are not stable between versions of the library and
+ * must not be stored. Use jutil_crypto for checksums.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jutil_crypto.h
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_HASH_H
+#define INCLUDE_JUTIL_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Calculates 64bit hash of data.
+ * 
+ * @param data    Data to hash. Can be @c NULL , if @c length is @c 0 .
+ * @param length  Size of data.
+ * @param seed    Seed, different seeds give unrelated hashes.
+ * 
+ * @return        Hash value.
+ */
+uint64_t jutil_hash64(const void *data, size_t length, uint64_t seed);
+
+/**
+ * @brief Calculates 64bit hash of null terminated string.
+ * 
+ * @param str   String to hash.
+ * @param seed  Seed, different seeds give unrelated hashes.
+ * 
+ * @return      Hash value.
+ */
+uint64_t jutil_hash64_str(const char *str, uint64_t seed);
+
+/**
+ * @brief Returns random seed of process.
+ * 
+ * Seed is read from the kernel at first call and stays
+ * the same, until the process exits.
+ * 
+ * @return  Random seed.
+ */
+uint64_t jutil_hash_getRandomSeed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_HASH_H */
@@ -9,6 +9,10 @@
  * to find elements, is to iterate through the list
  * and analyse each node.
  * 
+ * Adding and removing at both ends takes constant time.
+ * @c #jutil_linkedlist_head_t also keeps the number of
+ * nodes and removes nodes without searching them.
+ * 
  * @date 2020-09-23
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
@@ -33,6 +37,48 @@ extern "C" {
  */
 typedef struct __jutil_linkedlist jutil_linkedlist_t;
 
+/**
+ * @brief Allocator for list nodes.
+ * 
+ * Lets users take nodes from own memory pools.
+ * Both functions have to be thread safe, if lists
+ * are used by more than one thread.
+ */
+typedef struct __jutil_linkedlist_allocator
+{
+  void *(*alloc)(void *ctx, size_t size); /**< Returns memory for one node of @c size bytes. */
+  void (*free)(void *ctx, void *node);    /**< Releases node returned by @c alloc . */
+  void *ctx;                              /**< Context passed to functions. */
+} jutil_linkedlist_allocator_t;
+
+/**
+ * @brief Sets allocator for all list nodes.
+ * 
+ * By default nodes are taken from the global allocator
+ * of jutil_alloc and freed nodes are cached by each
+ * thread for reuse.
+ * 
+ * Has to be set, before any list has nodes,
+ * because nodes are released with the allocator,
+ * that is set at release.
+ * 
+ * @param allocator Functions to use. Are copied.
+ *                  @c NULL restores default.
+ * 
+ * @return          @c true , if allocator was set.
+ * @return          @c false , if functions are missing.
+ */
+int jutil_linkedlist_setAllocator(const jutil_linkedlist_allocator_t *allocator);
+
+/**
+ * @brief Returns size of a list node.
+ * 
+ * Allows allocators to prepare pools.
+ * 
+ * @return  Size of node in bytes.
+ */
+size_t jutil_linkedlist_nodeSize();
+
 /**
  * @brief Frees all nodes from list.
  * 
@@ -122,6 +168,107 @@ int jutil_linkedlist_append(jutil_linkedlist_t **list, void *data);
  */
 void *jutil_linkedlist_remove(jutil_linkedlist_t **list);
 
+/**
+ * @brief List object, that keeps number of nodes.
+ * 
+ * Nodes are the same as for other lists, so
+ * @c #jutil_linkedlist_iterate() and
+ * @c #jutil_linkedlist_getData() can be used.
+ */
+typedef struct __jutil_linkedlist_head jutil_linkedlist_head_t;
+
+/**
+ * @brief Creates empty list object.
+ * 
+ * @return  List object.
+ * @return  @c NULL , if error occured.
+ */
+jutil_linkedlist_head_t *jutil_linkedlist_head_init();
+
+/**
+ * @brief Frees list object and all nodes.
+ * 
+ * Does not free data.
+ * 
+ * @param head List object to free.
+ */
+void jutil_linkedlist_head_free(jutil_linkedlist_head_t *head);
+
+/**
+ * @brief Returns first node to iterate list.
+ * 
+ * @param head List object.
+ * 
+ * @return     First node.
+ * @return     @c NULL , if list is empty or error occured.
+ */
+jutil_linkedlist_t *jutil_linkedlist_head_first(jutil_linkedlist_head_t *head);
+
+/**
+ * @brief Returns number of nodes.
+ * 
+ * @param head List object.
+ * 
+ * @return     Number of nodes in list.
+ */
+size_t jutil_linkedlist_head_size(jutil_linkedlist_head_t *head);
+
+/**
+ * @brief Put new node at first position of list.
+ * 
+ * @param head List object.
+ * @param data Data pointer for new node.
+ * 
+ * @return     @c true , if successful.
+ * @return     @c false in case of error.
+ */
+int jutil_linkedlist_head_push(jutil_linkedlist_head_t *head, void *data);
+
+/**
+ * @brief Remove first node of list.
+ * 
+ * @param head List object.
+ * 
+ * @return     Data stored in first node.
+ * @return     @c NULL , if list is empty or error occured.
+ */
+void *jutil_linkedlist_head_pop(jutil_linkedlist_head_t *head);
+
+/**
+ * @brief Removes node from list.
+ * 
+ * Does not search the node, so it has to
+ * be part of the list.
+ * 
+ * @param head List object.
+ * @param node Node of list to remove.
+ * 
+ * @return     Data of removed node.
+ * @return     @c NULL , if error occured.
+ */
+void *jutil_linkedlist_head_removeNode(jutil_linkedlist_head_t *head, jutil_linkedlist_t *node);
+
+/**
+ * @brief Add node at end of list.
+ * 
+ * @param head List object.
+ * @param data Data for new node.
+ * 
+ * @return     @c true , if successful.
+ * @return     @c false in case of error.
+ */
+int jutil_linkedlist_head_append(jutil_linkedlist_head_t *head, void *data);
+
+/**
+ * @brief Remove last node of list.
+ * 
+ * @param head List object.
+ * 
+ * @return     Data of last node.
+ * @return     @c NULL , if list is empty or error occured.
+ */
+void *jutil_linkedlist_head_remove(jutil_linkedlist_head_t *head);
+
 
 #ifdef __cplusplus
 }
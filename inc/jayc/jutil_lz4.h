@@ -0,0 +1,103 @@
+/**
+ * @file jutil_lz4.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Fast compression in the LZ4 block format.
+ * 
+ * Output is compatible with the block format of the LZ4
+ * library ( @c LZ4_decompress_safe() reads it and blocks of
+ * @c LZ4_compress_default() are read here), so peers can use
+ * either one. Only single blocks are supported, there is no
+ * frame format with checksums.
+ * 
+ * The compressor is a greedy matcher over a hash table of
+ * 4 byte sequences. The table is kept in a session, so
+ * compressing does not allocate. Every block is independent.
+ * 
+ * Decompression checks all offsets and lengths, so it is
+ * safe for data recieved from the network.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_LZ4_H
+#define INCLUDE_JUTIL_LZ4_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Compression context. Holds hash table of matcher.
+ */
+typedef struct __jutil_lz4_session jutil_lz4_t;
+
+/**
+ * @brief Creates compression context.
+ * 
+ * One context is used by one thread at a time.
+ * 
+ * @return  Context object.
+ * @return  @c NULL , if error occured.
+ */
+jutil_lz4_t *jutil_lz4_init(void);
+
+/**
+ * @brief Frees compression context.
+ * 
+ * @param session Context to free.
+ */
+void jutil_lz4_free(jutil_lz4_t *session);
+
+/**
+ * @brief Returns maximum size of compressed data.
+ * 
+ * Incompressible data grows slightly. Destinations of
+ * this size always fit the compressed block.
+ * 
+ * @param size  Size of uncompressed data.
+ * 
+ * @return      Maximum size of block.
+ */
+size_t jutil_lz4_getBound(size_t size);
+
+/**
+ * @brief Compresses data into one block.
+ * 
+ * Stops, if the block does not fit into @c dest_size .
+ * Passing the size of the source as @c dest_size only
+ * compresses data, that gets smaller.
+ * 
+ * @param session   Compression context.
+ * @param src       Data to compress.
+ * @param src_size  Size of data.
+ * @param dest      Destination of block.
+ * @param dest_size Size of destination.
+ * 
+ * @return          Size of block.
+ * @return          @c 0 , if block does not fit or error occured.
+ */
+size_t jutil_lz4_compress(jutil_lz4_t *session, const void *src, size_t src_size, void *dest, size_t dest_size);
+
+/**
+ * @brief Decompresses one block.
+ * 
+ * @param src       Block to decompress.
+ * @param src_size  Size of block.
+ * @param dest      Destination of data.
+ * @param dest_size Size of destination.
+ * 
+ * @return          Size of decompressed data.
+ * @return          @c 0 , if block is invalid or does not fit.
+ */
+size_t jutil_lz4_decompress(const void *src, size_t src_size, void *dest, size_t dest_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_LZ4_H */
@@ -4,9 +4,14 @@
  * 
  * @brief Simple string indexed map.
  * 
- * This is not a very efficient way to implement
- * a map, but it was easy to implement and is fairly
- * easy to use.
+ * Implemented as hash table, so lookups, inserts and
+ * removes take constant time. The table grows
+ * incrementally, no insert has to move all entries.
+ * 
+ * Indices can have any length and are copied into the map.
+ * 
+ * Iteration starts with the newest entry. Returned
+ * pairs stay valid, until they are removed.
  * 
  * @date 2020-10-02
  * @copyright Copyright (c) 2020 by Manuel Nadji
@@ -16,24 +21,20 @@
 #ifndef INCLUDE_JUTIL_MAP_H
 #define INCLUDE_JUTIL_MAP_H
 
+#include <jayc/jutil_alloc.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-/**
- * @brief The maximum size that an index can have.
- */
-#define JUTIL_MAP_SIZE_INDEX 128
-
 /**
  * @brief Key-value pair stored in map.
  */
 typedef struct __jutil_map_data
 {
-  char index[JUTIL_MAP_SIZE_INDEX]; /**< Index string for node. */
-  void *data;                       /**< Node data. */
+  const char *index;  /**< Index string for node. Stored by map. */
+  void *data;         /**< Node data. */
 } jutil_map_data_t;
 
 /**
@@ -49,6 +50,20 @@ typedef struct __jutil_map jutil_map_t;
  */
 jutil_map_t *jutil_map_init();
 
+/**
+ * @brief Initializes map object with own allocator.
+ * 
+ * Map, table and entries are allocated with @c allocator
+ * instead of the global allocator of jutil_alloc.
+ * 
+ * @param allocator Functions to use. Are copied.
+ *                  @c NULL for global allocator.
+ * 
+ * @return          Map object pointer.
+ * @return          @c NULL , if error occured.
+ */
+jutil_map_t *jutil_map_allocator_init(const jutil_alloc_allocator_t *allocator);
+
 /**
  * @brief Clears map and frees memory.
  * 
@@ -117,6 +132,36 @@ void *jutil_map_get(jutil_map_t *map, const char *index);
  */
 int jutil_map_set(jutil_map_t *map, const char *index, void *data);
 
+/**
+ * @brief Returns data of index, adds entry if needed.
+ * 
+ * Finds or creates the entry with one lookup.
+ * New entries have data @c NULL .
+ * 
+ * @param map   Map object.
+ * @param index Index for data.
+ * @param added Set to @c true , if entry was created. Can be @c NULL .
+ * 
+ * @return      Pointer to data of entry. Valid, until
+ *              entry is removed.
+ * @return      @c NULL , if error occured.
+ */
+void **jutil_map_emplace(jutil_map_t *map, const char *index, int *added);
+
+/**
+ * @brief Makes room for number of entries.
+ * 
+ * Moves all entries into a table of the needed
+ * size at once, so adding them does not grow the map.
+ * 
+ * @param map   Map object.
+ * @param size  Expected number of entries.
+ * 
+ * @return      @c true , if map has room.
+ * @return      @c false , if error occured.
+ */
+int jutil_map_resize(jutil_map_t *map, size_t size);
+
 /**
  * @brief Check number of items in map.
  * 
@@ -0,0 +1,282 @@
+/**
+ * @file jutil_metrics.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Registry of runtime metrics (counters, gauges, histograms).
+ * 
+ * Metrics are registered by name in a global registry and live,
+ * until the program exits. Counters and histograms are split in
+ * shards, every thread writes to its own shard, so threads do not
+ * compete for cache lines. Shards are summed up, when metrics are
+ * read.
+ * 
+ * Names follow the Prometheus conventions and may have a label
+ * set (f.ex. @c jlog_messages_total{level="error"} ). Histograms
+ * record nanoseconds and are exported in seconds as summary with
+ * quantiles.
+ * 
+ * The macros cache the registered metric per call site, so
+ * instrumented code does not need to keep metric pointers:
+ * 
+ * @code
+ * JUTIL_METRICS_COUNTER_ADD("app_requests_total", "Handled requests.", 1);
+ * 
+ * unsigned long long start = JUTIL_METRICS_NOW();
+ * handle_request();
+ * JUTIL_METRICS_HISTOGRAM_SINCE("app_request_seconds", "Request latency.", start);
+ * @endcode
+ * 
+ * Library is instrumented with these macros. If it is built with
+ * @c JUTIL_NO_METRICS , the macros do nothing.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jutil_time.h
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_METRICS_H
+#define INCLUDE_JUTIL_METRICS_H
+
+#include <jayc/jutil_time.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// Define constants and types.
+//
+
+/**
+ * @brief Number of shards of counters and histograms.
+ */
+#define JUTIL_METRICS_SHARDS 16
+
+/**
+ * @brief Maximum length of metric name, including label set.
+ */
+#define JUTIL_METRICS_SIZE_NAME 128
+
+/**
+ * @brief Counter, that only increases.
+ */
+typedef struct __jutil_metrics_counter jutil_metrics_counter_t;
+
+/**
+ * @brief Value, that can increase and decrease.
+ */
+typedef struct __jutil_metrics_gauge jutil_metrics_gauge_t;
+
+/**
+ * @brief Distribution of durations.
+ */
+typedef struct __jutil_metrics_histogram jutil_metrics_histogram_t;
+
+
+
+//==============================================================================
+// Declare functions.
+//
+
+/**
+ * @brief Returns counter with name, registers it if needed.
+ * 
+ * Does not log, so it can be used by loggers.
+ * 
+ * @param name  Metric name with optional label set.
+ * @param help  Description of metric.
+ * 
+ * @return      Counter.
+ * @return      @c NULL , if name is invalid, used by metric
+ *              of other type, or memory could not be allocated.
+ */
+jutil_metrics_counter_t *jutil_metrics_counter(const char *name, const char *help);
+
+/**
+ * @brief Returns gauge with name, registers it if needed.
+ * 
+ * @param name  Metric name with optional label set.
+ * @param help  Description of metric.
+ * 
+ * @return      Gauge.
+ * @return      @c NULL , if name is invalid, used by metric
+ *              of other type, or memory could not be allocated.
+ */
+jutil_metrics_gauge_t *jutil_metrics_gauge(const char *name, const char *help);
+
+/**
+ * @brief Returns histogram with name, registers it if needed.
+ * 
+ * @param name  Metric name with optional label set.
+ * @param help  Description of metric.
+ * 
+ * @return      Histogram.
+ * @return      @c NULL , if name is invalid, used by metric
+ *              of other type, or memory could not be allocated.
+ */
+jutil_metrics_histogram_t *jutil_metrics_histogram(const char *name, const char *help);
+
+/**
+ * @brief Adds to counter.
+ * 
+ * @param counter Counter. Nothing happens, if @c NULL .
+ * @param value   Value to add.
+ */
+void jutil_metrics_counter_add(jutil_metrics_counter_t *counter, unsigned long long value);
+
+/**
+ * @brief Returns sum of all shards of counter.
+ * 
+ * @param counter Counter.
+ * 
+ * @return        Value of counter.
+ */
+unsigned long long jutil_metrics_counter_get(jutil_metrics_counter_t *counter);
+
+/**
+ * @brief Sets gauge.
+ * 
+ * @param gauge Gauge. Nothing happens, if @c NULL .
+ * @param value New value.
+ */
+void jutil_metrics_gauge_set(jutil_metrics_gauge_t *gauge, long long value);
+
+/**
+ * @brief Adds to gauge.
+ * 
+ * @param gauge Gauge. Nothing happens, if @c NULL .
+ * @param value Value to add (negative to decrease).
+ */
+void jutil_metrics_gauge_add(jutil_metrics_gauge_t *gauge, long long value);
+
+/**
+ * @brief Returns value of gauge.
+ * 
+ * @param gauge Gauge.
+ * 
+ * @return      Value of gauge.
+ */
+long long jutil_metrics_gauge_get(jutil_metrics_gauge_t *gauge);
+
+/**
+ * @brief Records duration in histogram.
+ * 
+ * @param histogram Histogram. Nothing happens, if @c NULL .
+ * @param value     Duration in nanoseconds.
+ */
+void jutil_metrics_histogram_record(jutil_metrics_histogram_t *histogram, unsigned long long value);
+
+/**
+ * @brief Adds all shards of histogram to other histogram.
+ * 
+ * @param histogram Histogram metric.
+ * @param dest      Histogram to add values to.
+ * 
+ * @return          @c true , if successful.
+ * @return          @c false , if error occured.
+ */
+int jutil_metrics_histogram_merge(jutil_metrics_histogram_t *histogram, jutil_time_histogram_t *dest);
+
+/**
+ * @brief Formats all metrics in Prometheus text format.
+ * 
+ * @param length  Set to length of text, if not @c NULL .
+ * 
+ * @return        Text, has to be freed with @c free() .
+ * @return        @c NULL , if memory could not be allocated.
+ */
+char *jutil_metrics_format(size_t *length);
+
+
+
+//==============================================================================
+// Define macros.
+//
+
+#ifndef JUTIL_NO_METRICS
+
+/**
+ * @brief Returns timestamp for @c #JUTIL_METRICS_HISTOGRAM_SINCE() .
+ */
+#define JUTIL_METRICS_NOW() jutil_time_getNanos()
+
+/**
+ * @brief Adds to counter, that is registered at first call.
+ * 
+ * @param name  Metric name (string literal).
+ * @param help  Description of metric.
+ * @param value Value to add.
+ */
+#define JUTIL_METRICS_COUNTER_ADD(name, help, value) \
+  do \
+  { \
+    static _Atomic(jutil_metrics_counter_t *) jutil_metrics_site; \
+    jutil_metrics_counter_t *jutil_metrics_metric = atomic_load_explicit(&jutil_metrics_site, memory_order_acquire); \
+    if(jutil_metrics_metric == NULL) \
+    { \
+      jutil_metrics_metric = jutil_metrics_counter(name, help); \
+      atomic_store_explicit(&jutil_metrics_site, jutil_metrics_metric, memory_order_release); \
+    } \
+    jutil_metrics_counter_add(jutil_metrics_metric, value); \
+  } while(0)
+
+/**
+ * @brief Adds to gauge, that is registered at first call.
+ * 
+ * @param name  Metric name (string literal).
+ * @param help  Description of metric.
+ * @param value Value to add (negative to decrease).
+ */
+#define JUTIL_METRICS_GAUGE_ADD(name, help, value) \
+  do \
+  { \
+    static _Atomic(jutil_metrics_gauge_t *) jutil_metrics_site; \
+    jutil_metrics_gauge_t *jutil_metrics_metric = atomic_load_explicit(&jutil_metrics_site, memory_order_acquire); \
+    if(jutil_metrics_metric == NULL) \
+    { \
+      jutil_metrics_metric = jutil_metrics_gauge(name, help); \
+      atomic_store_explicit(&jutil_metrics_site, jutil_metrics_metric, memory_order_release); \
+    } \
+    jutil_metrics_gauge_add(jutil_metrics_metric, value); \
+  } while(0)
+
+/**
+ * @brief Records time since timestamp in histogram, that is
+ *        registered at first call.
+ * 
+ * @param name  Metric name (string literal).
+ * @param help  Description of metric.
+ * @param start Timestamp from @c #JUTIL_METRICS_NOW() .
+ */
+#define JUTIL_METRICS_HISTOGRAM_SINCE(name, help, start) \
+  do \
+  { \
+    static _Atomic(jutil_metrics_histogram_t *) jutil_metrics_site; \
+    jutil_metrics_histogram_t *jutil_metrics_metric = atomic_load_explicit(&jutil_metrics_site, memory_order_acquire); \
+    if(jutil_metrics_metric == NULL) \
+    { \
+      jutil_metrics_metric = jutil_metrics_histogram(name, help); \
+      atomic_store_explicit(&jutil_metrics_site, jutil_metrics_metric, memory_order_release); \
+    } \
+    unsigned long long jutil_metrics_now = jutil_time_getNanos(); \
+    jutil_metrics_histogram_record(jutil_metrics_metric, (jutil_metrics_now > (start) ? jutil_metrics_now - (start) : 0)); \
+  } while(0)
+
+#else
+
+#define JUTIL_METRICS_NOW() 0ULL
+#define JUTIL_METRICS_COUNTER_ADD(name, help, value) ((void)(value))
+#define JUTIL_METRICS_GAUGE_ADD(name, help, value) ((void)(value))
+#define JUTIL_METRICS_HISTOGRAM_SINCE(name, help, start) ((void)(start))
+
+#endif /* JUTIL_NO_METRICS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_METRICS_H */
@@ -0,0 +1,171 @@
+/**
+ * @file jutil_queue.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Bounded queues to pass pointers between threads.
+ * 
+ * Queues are ring buffers with fixed capacity and do not
+ * use locks. Single producer queues (SPSC) may only be
+ * filled by one thread, multi producer queues (MPSC)
+ * by any number of threads. Both are emptied by one
+ * consumer thread.
+ * 
+ * If a jutil_thread is set as consumer, producers notify
+ * it after pushing, when it announced to wait with
+ * @c #jutil_queue_prepareWait() . The consumer thread should
+ * use wait policy @c #JUTIL_THREAD_WAIT_NOTIFY :
+ * 
+ * @code
+ * int consumer_loop(void *ctx, jutil_thread_t *thread)
+ * {
+ *   void *items[32];
+ *   size_t number = jutil_queue_popBatch(queue, items, 32);
+ *   // handle items
+ *   jutil_queue_prepareWait(queue);
+ *   return true;
+ * }
+ * @endcode
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_QUEUE_H
+#define INCLUDE_JUTIL_QUEUE_H
+
+#include <jayc/jutil_thread.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Queue with one producer and one consumer thread.
+ */
+#define JUTIL_QUEUE_TYPE_SPSC 0
+
+/**
+ * @brief Queue with many producer threads and one consumer thread.
+ */
+#define JUTIL_QUEUE_TYPE_MPSC 1
+
+/**
+ * @brief Object pointer.
+ */
+typedef struct __jutil_queue jutil_queue_t;
+
+/**
+ * @brief Initializes queue.
+ * 
+ * @param type     @c #JUTIL_QUEUE_TYPE_SPSC or @c #JUTIL_QUEUE_TYPE_MPSC .
+ * @param capacity Maximum number of items. Rounded
+ *                 up to power of 2.
+ * 
+ * @return         Queue object.
+ * @return         @c NULL , if error occured.
+ */
+jutil_queue_t *jutil_queue_init(int type, size_t capacity);
+
+/**
+ * @brief Frees queue. Does not free items.
+ * 
+ * @param queue Queue to free.
+ */
+void jutil_queue_free(jutil_queue_t *queue);
+
+/**
+ * @brief Sets thread, that is notified about new items.
+ * 
+ * Has to be set, before producers use the queue.
+ * 
+ * @param queue  Queue object.
+ * @param thread Consumer thread. @c NULL disables notifications.
+ */
+void jutil_queue_setConsumer(jutil_queue_t *queue, jutil_thread_t *thread);
+
+/**
+ * @brief Adds item to queue.
+ * 
+ * Does not block.
+ * 
+ * @param queue Queue object.
+ * @param item  Item to add. Must not be @c NULL .
+ * 
+ * @return      @c true , if item was added.
+ * @return      @c false , if queue is full or error occured.
+ */
+int jutil_queue_push(jutil_queue_t *queue, void *item);
+
+/**
+ * @brief Adds items to queue.
+ * 
+ * Adds as many items as fit. Items are added
+ * in order and consumer gets them in order.
+ * Does not block.
+ * 
+ * @param queue  Queue object.
+ * @param items  Items to add. Must not be @c NULL .
+ * @param number Number of items.
+ * 
+ * @return       Number of added items.
+ */
+size_t jutil_queue_pushBatch(jutil_queue_t *queue, void **items, size_t number);
+
+/**
+ * @brief Takes oldest item from queue.
+ * 
+ * Only called by consumer thread. Does not block.
+ * 
+ * @param queue Queue object.
+ * 
+ * @return      Oldest item.
+ * @return      @c NULL , if queue is empty or error occured.
+ */
+void *jutil_queue_pop(jutil_queue_t *queue);
+
+/**
+ * @brief Takes oldest items from queue.
+ * 
+ * Only called by consumer thread. Does not block.
+ * 
+ * @param queue  Queue object.
+ * @param items  Buffer for items.
+ * @param number Maximum number of items to take.
+ * 
+ * @return       Number of items taken.
+ */
+size_t jutil_queue_popBatch(jutil_queue_t *queue, void **items, size_t number);
+
+/**
+ * @brief Announces, that consumer will wait for items.
+ * 
+ * Called by consumer thread at end of loop function.
+ * The next push notifies the consumer. If items are
+ * already queued, the consumer is notified right away,
+ * so its wait ends immediately.
+ * 
+ * @param queue Queue object.
+ * 
+ * @return      @c true , if queue was empty.
+ * @return      @c false , if items are queued or error occured.
+ */
+int jutil_queue_prepareWait(jutil_queue_t *queue);
+
+/**
+ * @brief Returns number of queued items.
+ * 
+ * Can be outdated, when other threads use the queue.
+ * 
+ * @param queue Queue object.
+ * 
+ * @return      Number of items.
+ */
+size_t jutil_queue_size(jutil_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_QUEUE_H */
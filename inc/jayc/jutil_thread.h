@@ -12,6 +12,21 @@
  * Provides simple function callback interface and
  * mutex handling.
  * 
+ * Run and state flags are atomic, so starting, stopping,
+ * notifying and checking a thread do not take the user
+ * mutex. Mutex and reader-writer lock are only used for
+ * data shared between loop function and other threads.
+ * 
+ * Between loop executions the thread waits according to
+ * its wait policy. By default it blocks until
+ * @c #jutil_thread_notify() is called or the sleep time
+ * has passed. Busy polling and fixed sleeping can be
+ * selected with @c #jutil_thread_setWaitPolicy() .
+ * 
+ * Threads of the library block asynchronous signals, so
+ * signals are handled by threads of the program and system
+ * calls of library threads are not interrupted.
+ * 
  * @date 2020-09-25
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
@@ -21,12 +36,74 @@
 #define INCLUDE_JUTIL_THREAD_H
 
 #include <pthread.h>
+#include <stddef.h>
 #include <jayc/jlog.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Thread sleeps the full sleep time between loop executions.
+ * 
+ * Notifications do not interrupt the sleep.
+ */
+#define JUTIL_THREAD_WAIT_SLEEP 0
+
+/**
+ * @brief Thread runs loop function again immediately.
+ * 
+ * Used, when loop function blocks by itself.
+ * Default, if sleep time is zero.
+ */
+#define JUTIL_THREAD_WAIT_BUSYPOLL 1
+
+/**
+ * @brief Thread waits until notified.
+ * 
+ * Sleep time is used as maximum wait time. If sleep time
+ * is zero, thread waits until @c #jutil_thread_notify()
+ * or @c #jutil_thread_stop() is called.
+ * Default, if sleep time is not zero.
+ */
+#define JUTIL_THREAD_WAIT_NOTIFY 2
+
+/**
+ * @brief Thread uses normal time sharing scheduling ( @c SCHED_OTHER ).
+ */
+#define JUTIL_THREAD_SCHED_OTHER 0
+
+/**
+ * @brief Thread uses real time first in first out scheduling ( @c SCHED_FIFO ).
+ */
+#define JUTIL_THREAD_SCHED_FIFO 1
+
+/**
+ * @brief Thread uses real time round robin scheduling ( @c SCHED_RR ).
+ */
+#define JUTIL_THREAD_SCHED_RR 2
+
+/**
+ * @brief Attributes of thread.
+ * 
+ * Members set to @c 0 keep the defaults of the system,
+ * so a zeroed struct behaves like @c #jutil_thread_init() .
+ * 
+ * Attributes are applied every time the thread is started.
+ * Real time scheduling usually needs @c CAP_SYS_NICE ,
+ * otherwise starting the thread fails.
+ */
+typedef struct __jutil_thread_options
+{
+  size_t stack_size;  /**< Stack size in bytes. Raised to @c PTHREAD_STACK_MIN , if smaller. */
+  const int *cpus;    /**< CPUs, the thread may run on. */
+  size_t cpu_count;   /**< Number of entries in @c cpus . */
+  int policy;         /**< @c #JUTIL_THREAD_SCHED_OTHER , @c #JUTIL_THREAD_SCHED_FIFO or @c #JUTIL_THREAD_SCHED_RR . */
+  int priority;       /**< Real time priority (1 - 99) for FIFO and round robin. */
+  int nice;           /**< Nice value of thread (-20 - 19) for normal scheduling. */
+  const char *name;   /**< Name shown by @c top or @c perf (max. 15 characters). */
+} jutil_thread_options_t;
+
 /**
  * @brief Holds data for thread runtime and operation.
  * 
@@ -52,7 +129,8 @@ typedef int(*jutil_thread_loop_function_t)(void *ctx, jutil_thread_t *thread_ses
  * @param function  Function, that will be called in thread loop.
  * @param logger    Logger to use for debug and error messages.
  * @param sleep_s   How long thread should sleep between loop executions.
- *                  In seconds.
+ *                  In seconds. With @c #JUTIL_THREAD_WAIT_NOTIFY
+ *                  this is the maximum wait time.
  * @param sleep_ns  Additional nanoseconds to wait before loop executions.
  * @param ctx       Context passed to loop function.
  * 
@@ -61,6 +139,27 @@ typedef int(*jutil_thread_loop_function_t)(void *ctx, jutil_thread_t *thread_ses
  */
 jutil_thread_t *jutil_thread_init(jutil_thread_loop_function_t function, jlog_t *logger, long sleep_s, long sleep_ns, void *ctx);
 
+/**
+ * @brief Initializes session with thread attributes.
+ * 
+ * Smaller stacks let programs with many threads stay below
+ * their address space limits.
+ * 
+ * @param function  Function, that will be called in thread loop.
+ * @param logger    Logger to use for debug and error messages.
+ * @param sleep_s   How long thread should sleep between loop executions.
+ *                  In seconds. With @c #JUTIL_THREAD_WAIT_NOTIFY
+ *                  this is the maximum wait time.
+ * @param sleep_ns  Additional nanoseconds to wait before loop executions.
+ * @param ctx       Context passed to loop function.
+ * @param options   Thread attributes. Copied into session.
+ *                  @c NULL for defaults.
+ * 
+ * @return          Session object.
+ * @return          @c NULL in case of error.
+ */
+jutil_thread_t *jutil_thread_options_init(jutil_thread_loop_function_t function, jlog_t *logger, long sleep_s, long sleep_ns, void *ctx, const jutil_thread_options_t *options);
+
 /**
  * @brief Frees memory of session.
  * 
@@ -97,6 +196,34 @@ int jutil_thread_start(jutil_thread_t *session);
  */
 void jutil_thread_stop(jutil_thread_t *session);
 
+/**
+ * @brief Sets how thread waits between loop executions.
+ * 
+ * Can be changed while thread is running.
+ * 
+ * @param session Session to configure.
+ * @param policy  Wait policy ( @c #JUTIL_THREAD_WAIT_SLEEP ,
+ *                @c #JUTIL_THREAD_WAIT_BUSYPOLL ,
+ *                @c #JUTIL_THREAD_WAIT_NOTIFY ).
+ * 
+ * @return        @c true , if policy was set.
+ * @return        @c false , if error occured.
+ */
+int jutil_thread_setWaitPolicy(jutil_thread_t *session, int policy);
+
+/**
+ * @brief Wakes up thread waiting for next loop execution.
+ * 
+ * Used with @c #JUTIL_THREAD_WAIT_NOTIFY . If the thread
+ * is currently running the loop function, the next wait
+ * returns immediately, so no notification gets lost.
+ * 
+ * Can be called from any thread.
+ * 
+ * @param session Thread to wake up.
+ */
+void jutil_thread_notify(jutil_thread_t *session);
+
 /**
  * @brief Locks the mutex.
  * 
@@ -105,6 +232,10 @@ void jutil_thread_stop(jutil_thread_t *session);
  * Mutex should afterwards be unlocked with
  * @c #jcon_thread_unlockMutex() .
  * 
+ * Mutex is not used by thread internally, so holding it
+ * does not block @c #jutil_thread_notify() or
+ * @c #jutil_thread_stop() .
+ * 
  * @param session Session to lock.
  */
 void jutil_thread_lockMutex(jutil_thread_t *session);
@@ -116,6 +247,37 @@ void jutil_thread_lockMutex(jutil_thread_t *session);
  */
 void jutil_thread_unlockMutex(jutil_thread_t *session);
 
+/**
+ * @brief Locks reader-writer lock for reading.
+ * 
+ * For data, that is mostly read by loop function and
+ * rarely changed. Multiple readers can hold the lock
+ * at the same time. Lock should afterwards be unlocked
+ * with @c #jutil_thread_unlockRW() .
+ * 
+ * @param session Session to lock.
+ */
+void jutil_thread_lockRead(jutil_thread_t *session);
+
+/**
+ * @brief Locks reader-writer lock for writing.
+ * 
+ * Waits, until no reader holds the lock.
+ * 
+ * @param session Session to lock.
+ */
+void jutil_thread_lockWrite(jutil_thread_t *session);
+
+/**
+ * @brief Unlocks reader-writer lock.
+ * 
+ * Used after @c #jutil_thread_lockRead() and
+ * @c #jutil_thread_lockWrite() .
+ * 
+ * @param session Session to unlock.
+ */
+void jutil_thread_unlockRW(jutil_thread_t *session);
+
 /**
  * @brief Check if thread is currently running.
  * 
@@ -126,6 +288,24 @@ void jutil_thread_unlockMutex(jutil_thread_t *session);
  */
 int jutil_thread_isRunning(jutil_thread_t *session);
 
+/**
+ * @brief Creates pthread, that blocks asynchronous signals.
+ * 
+ * Same as @c pthread_create() , but the thread starts with
+ * all signals blocked, except signals caused by its own
+ * faults ( @c SIGSEGV , @c SIGBUS , @c SIGFPE , @c SIGILL ).
+ * Used for all threads of the library.
+ * 
+ * @param thread    Set to id of new thread.
+ * @param attr      Thread attributes, can be @c NULL .
+ * @param function  Start function of thread.
+ * @param arg       Argument for start function.
+ * 
+ * @return          @c 0 , if thread was created.
+ * @return          Error number of @c pthread_create() , if error occured.
+ */
+int jutil_thread_createPthread(pthread_t *thread, const pthread_attr_t *attr, void *(*function)(void *), void *arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,203 @@
+/**
+ * @file jutil_threadpool.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Pool of worker threads, that run tasks.
+ * 
+ * Every worker has its own deque of tasks. Tasks submitted
+ * by a worker go to its own deque and are taken newest first,
+ * so data of the submitting task is still in cache. Tasks
+ * submitted by other threads go to a shared queue. Idle
+ * workers take tasks from the shared queue or steal the
+ * oldest tasks from other workers.
+ * 
+ * Results can be handled with a completion callback, which
+ * runs on the worker, or with a future:
+ * 
+ * @code
+ * jutil_threadpool_t *pool = jutil_threadpool_init(0, "hash", NULL);
+ * jutil_threadpool_future_t *future = jutil_threadpool_submitFuture(pool, &hash_block, block);
+ * void *digest = jutil_threadpool_future_wait(future);
+ * jutil_threadpool_future_free(future);
+ * jutil_threadpool_free(pool);
+ * @endcode
+ * 
+ * Workers are named @c "<name>-<index>" and can be pinned to CPUs.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ * @see jutil_thread.h
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_THREADPOOL_H
+#define INCLUDE_JUTIL_THREADPOOL_H
+
+#include <jayc/jlog.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Object pointer.
+ */
+typedef struct __jutil_threadpool jutil_threadpool_t;
+
+/**
+ * @brief Result of a task, that can be waited for.
+ */
+typedef struct __jutil_threadpool_future jutil_threadpool_future_t;
+
+/**
+ * @brief Function run by worker.
+ * 
+ * @param ctx Context given at submission.
+ * 
+ * @return    Result of task. Passed to callback or future.
+ */
+typedef void *(*jutil_threadpool_task_function_t)(void *ctx);
+
+/**
+ * @brief Called by worker, after task is finished.
+ * 
+ * @param ctx     Callback context given at submission.
+ * @param result  Return value of task function.
+ */
+typedef void(*jutil_threadpool_callback_t)(void *ctx, void *result);
+
+/**
+ * @brief Creates pool and starts workers.
+ * 
+ * @param workers Number of worker threads. @c 0 for one
+ *                worker per online CPU.
+ * @param name    Name of workers (max. 10 characters are
+ *                used). @c NULL for @c "pool" .
+ * @param logger  Logger for error messages. @c NULL for
+ *                global logger.
+ * 
+ * @return        Pool object.
+ * @return        @c NULL , if error occured.
+ */
+jutil_threadpool_t *jutil_threadpool_init(size_t workers, const char *name, jlog_t *logger);
+
+/**
+ * @brief Waits for all tasks, stops workers and frees pool.
+ * 
+ * Must not be called by a worker of the pool. No tasks
+ * may be submitted by other threads, while pool is freed.
+ * 
+ * @param pool  Pool to free.
+ */
+void jutil_threadpool_free(jutil_threadpool_t *pool);
+
+/**
+ * @brief Submits task.
+ * 
+ * @param pool          Pool object.
+ * @param function      Task function.
+ * @param ctx           Context for task function.
+ * @param callback      Called with result, after task is
+ *                      finished. Can be @c NULL .
+ * @param callback_ctx  Context for callback.
+ * 
+ * @return              @c true , if task was submitted.
+ * @return              @c false , if error occured.
+ */
+int jutil_threadpool_submit(jutil_threadpool_t *pool, jutil_threadpool_task_function_t function, void *ctx, jutil_threadpool_callback_t callback, void *callback_ctx);
+
+/**
+ * @brief Submits task and returns future for its result.
+ * 
+ * @param pool      Pool object.
+ * @param function  Task function.
+ * @param ctx       Context for task function.
+ * 
+ * @return          Future, has to be freed with
+ *                  @c #jutil_threadpool_future_free() .
+ * @return          @c NULL , if error occured.
+ */
+jutil_threadpool_future_t *jutil_threadpool_submitFuture(jutil_threadpool_t *pool, jutil_threadpool_task_function_t function, void *ctx);
+
+/**
+ * @brief Waits, until all submitted tasks are finished.
+ * 
+ * Must not be called by a worker of the pool.
+ * 
+ * @param pool  Pool object.
+ */
+void jutil_threadpool_wait(jutil_threadpool_t *pool);
+
+/**
+ * @brief Returns number of workers.
+ * 
+ * @param pool  Pool object.
+ * 
+ * @return      Number of worker threads.
+ */
+size_t jutil_threadpool_getWorkers(jutil_threadpool_t *pool);
+
+/**
+ * @brief Pins worker to CPU.
+ * 
+ * @param pool    Pool object.
+ * @param worker  Index of worker.
+ * @param cpu     Number of CPU.
+ * 
+ * @return        @c true , if affinity was set.
+ * @return        @c false , if error occured.
+ */
+int jutil_threadpool_setAffinity(jutil_threadpool_t *pool, size_t worker, int cpu);
+
+/**
+ * @brief Pins each worker to one CPU.
+ * 
+ * Worker @c i is pinned to the @c i -th CPU, the process
+ * may run on (round robin, if there are more workers).
+ * 
+ * @param pool  Pool object.
+ * 
+ * @return      @c true , if all workers were pinned.
+ * @return      @c false , if error occured.
+ */
+int jutil_threadpool_pinWorkers(jutil_threadpool_t *pool);
+
+/**
+ * @brief Waits for result of task.
+ * 
+ * If called by a worker of the pool, it runs other tasks
+ * while waiting, so tasks can wait for tasks they submitted.
+ * 
+ * @param future  Future returned by @c #jutil_threadpool_submitFuture() .
+ * 
+ * @return        Return value of task function.
+ */
+void *jutil_threadpool_future_wait(jutil_threadpool_future_t *future);
+
+/**
+ * @brief Checks, if task of future is finished.
+ * 
+ * @param future  Future object.
+ * 
+ * @return        @c true , if result is available.
+ * @return        @c false , if task is not finished.
+ */
+int jutil_threadpool_future_isDone(jutil_threadpool_future_t *future);
+
+/**
+ * @brief Frees future.
+ * 
+ * Task does not have to be finished. Its result is
+ * discarded in that case.
+ * 
+ * @param future  Future to free.
+ */
+void jutil_threadpool_future_free(jutil_threadpool_future_t *future);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_THREADPOOL_H */
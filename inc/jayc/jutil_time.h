@@ -13,6 +13,7 @@
 #define INCLUDE_JUTIL_TIME_H
 
 #include <stddef.h>
+#include <limits.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -70,6 +71,16 @@ void jutil_time_stopWatch_free(jutil_time_stopWatch_t *session);
 // Time string functions.
 //
 
+/**
+ * @brief Time string with milliseconds.
+ */
+#define JUTIL_TIME_PRECISION_MILLI 3
+
+/**
+ * @brief Time string with microseconds.
+ */
+#define JUTIL_TIME_PRECISION_MICRO 6
+
 /**
  * @brief Formats a timestamp into string.
  * 
@@ -110,6 +121,109 @@ int jutil_time_getTimeString(char *str_buf, size_t str_size, long timestamp);
  */
 int jutil_time_getCurrentTimeString(char *str_buf, size_t str_size);
 
+/**
+ * @brief Creates standardized string for timestamp with fraction
+ *        of second.
+ * 
+ * Format example: "2020-10-07 13:25:44.123" (precision 3).
+ * 
+ * Date and time are formatted once per second and cached per
+ * thread, in between only the fraction is added. So it is
+ * reentrant and does not take the time zone lock for every call.
+ * 
+ * @param str_buf     String buffer.
+ * @param str_size    Size of string buffer.
+ * @param seconds     Timestamp to format.
+ * @param nanoseconds Nanoseconds of timestamp (0 - 999999999).
+ * @param precision   Number of digits of fraction (0 - 9), f.ex.
+ *                    @c #JUTIL_TIME_PRECISION_MILLI .
+ * 
+ * @return            Length of string.
+ * @return            @c 0 , if buffer is too small or error occured.
+ */
+size_t jutil_time_getTimeStringPrecise(char *str_buf, size_t str_size, long seconds, long nanoseconds, int precision);
+
+/**
+ * @brief Creates standardized string for current time with
+ *        fraction of second.
+ * 
+ * Like @c #jutil_time_getTimeStringPrecise() but with current
+ * time ( @c CLOCK_REALTIME ).
+ * 
+ * @param str_buf   String buffer.
+ * @param str_size  Size of string buffer.
+ * @param precision Number of digits of fraction (0 - 9).
+ * 
+ * @return          Length of string.
+ * @return          @c 0 , if buffer is too small or error occured.
+ */
+size_t jutil_time_getCurrentTimeStringPrecise(char *str_buf, size_t str_size, int precision);
+
+
+
+//==============================================================================
+// Coarse clock and deadlines.
+//
+
+/**
+ * @brief Deadline, that never expires.
+ */
+#define JUTIL_TIME_DEADLINE_NEVER ULLONG_MAX
+
+/**
+ * @brief Point in time, until which an operation may take.
+ * 
+ * Value type, can be embedded and copied. Set with
+ * @c #jutil_time_deadline_set() .
+ */
+typedef struct __jutil_time_deadline
+{
+  unsigned long long expires; /**< Coarse milliseconds, when deadline expires. */
+} jutil_time_deadline_t;
+
+/**
+ * @brief Returns milliseconds of @c CLOCK_MONOTONIC_COARSE .
+ * 
+ * Much cheaper than a precise clock, but only advances with
+ * the kernel tick (1 - 10ms). Meant for timeouts, not for
+ * measurements. Not comparable with @c #jutil_time_getNanos() .
+ * 
+ * @return  Milliseconds since unspecified point.
+ */
+unsigned long long jutil_time_getCoarseMillis(void);
+
+/**
+ * @brief Sets deadline relative to now.
+ * 
+ * @param deadline    Deadline to set.
+ * @param timeout_ms  Milliseconds from now. Negative for
+ *                    a deadline, that never expires.
+ */
+void jutil_time_deadline_set(jutil_time_deadline_t *deadline, long timeout_ms);
+
+/**
+ * @brief Checks, if deadline has passed.
+ * 
+ * @param deadline  Deadline to check.
+ * 
+ * @return          @c true , if deadline has passed.
+ * @return          @c false , if time is left.
+ */
+int jutil_time_deadline_isExpired(const jutil_time_deadline_t *deadline);
+
+/**
+ * @brief Returns time left until deadline.
+ * 
+ * Result can be passed as timeout to @c poll() or
+ * @c #jcon_client_setPollTimeout() .
+ * 
+ * @param deadline  Deadline to check.
+ * 
+ * @return          Milliseconds left, @c 0 if deadline has passed.
+ * @return          @c -1 , if deadline never expires.
+ */
+int jutil_time_deadline_getRemaining(const jutil_time_deadline_t *deadline);
+
 
 
 //==============================================================================
@@ -136,12 +250,20 @@ void jutil_time_sleep(long secs, long nanosecs, int exit_on_int);
 
 /**
  * @brief Timer session object.
+ * 
+ * Timer is a pollable file descriptor (timerfd). It becomes
+ * readable, when the interval has passed. The thread, that waits
+ * for it (f.ex. with a jcon_eventLoop together with sockets),
+ * calls @c #jutil_time_timer_process() , which runs the handler.
+ * So the handler needs no synchronization with that thread.
  */
 typedef struct __jutil_time_timer_session jutil_time_timer_t;
 
 /**
  * @brief Handler called by timer.
  * 
+ * Called by @c #jutil_time_timer_process() .
+ * 
  * @param ctx Session context provided by user.
  * 
  * @return    @c true , if timer should continue.
@@ -165,8 +287,7 @@ jutil_time_timer_t *jutil_time_timer_init(void *ctx, jutil_time_timer_handler_t
 /**
  * @brief Stops timer and frees memory.
  * 
- * @bug valgrind still finds lost memory, but this seems to be a false positive.
- *      https://lng-odp.linaro.narkive.com/dLxhUyXZ/bug-1101-new-odp-timer-valgrind-memory
+ * Descriptor has to be removed from event loops before.
  * 
  * @param session Session object to free.
  */
@@ -192,6 +313,194 @@ int jutil_time_timer_start(jutil_time_timer_t *session);
  */
 int jutil_time_timer_stop(jutil_time_timer_t *session);
 
+/**
+ * @brief Returns timerfd of timer.
+ * 
+ * Descriptor is readable, when timer expired. Should only
+ * be used to wait for the descriptor.
+ * 
+ * @param session Timer session.
+ * 
+ * @return        File descriptor.
+ * @return        @c -1 , if session is @c NULL .
+ */
+int jutil_time_timer_getFD(jutil_time_timer_t *session);
+
+/**
+ * @brief Handles expiry of timer.
+ * 
+ * Should be called, when descriptor is readable.
+ * Calls handler once, even if the timer expired multiple
+ * times since last call. Stops timer, if handler returns
+ * @c false . Does not block.
+ * 
+ * @param session Timer session.
+ * 
+ * @return        Number of expirations since last call
+ *                ( @c 0 , if timer did not expire).
+ * @return        @c -1 , if error occured.
+ */
+int jutil_time_timer_process(jutil_time_timer_t *session);
+
+
+
+//==============================================================================
+// Definitions for jutil_time_histogram.
+//
+
+/**
+ * @brief Bits of precision of histogram buckets.
+ * 
+ * Values are recorded with a relative error below
+ * @c 2^-(JUTIL_TIME_HISTOGRAM_BITS-1) (0.8%).
+ * Values below @c 2^JUTIL_TIME_HISTOGRAM_BITS are exact.
+ */
+#define JUTIL_TIME_HISTOGRAM_BITS 8
+
+/**
+ * @brief Histogram session object.
+ * 
+ * Log-linear histogram (like HDR histograms) of 64 bit values,
+ * f.ex. latencies in nanoseconds. Recording is a few
+ * instructions without locks or system calls.
+ * 
+ * Values have to be recorded by one thread. Other threads
+ * may read percentiles or merge it at the same time. For
+ * multiple recording threads, each thread uses its own
+ * histogram and they get merged for reporting.
+ */
+typedef struct __jutil_time_histogram_session jutil_time_histogram_t;
+
+/**
+ * @brief Returns monotonic timestamp in nanoseconds.
+ * 
+ * Uses @c CLOCK_MONOTONIC_RAW . If library is built with
+ * @c JUTIL_TIME_TSC on x86_64 with invariant TSC, reads
+ * the time stamp counter instead (calibrated at first call,
+ * which takes about 10ms).
+ * 
+ * @return  Nanoseconds since unspecified point.
+ */
+unsigned long long jutil_time_getNanos(void);
+
+/**
+ * @brief Initializes empty histogram.
+ * 
+ * @return  New histogram.
+ * @return  @c NULL , if error occured.
+ */
+jutil_time_histogram_t *jutil_time_histogram_init(void);
+
+/**
+ * @brief Frees histogram.
+ * 
+ * @param session Histogram to free.
+ */
+void jutil_time_histogram_free(jutil_time_histogram_t *session);
+
+/**
+ * @brief Records value.
+ * 
+ * @param session Histogram.
+ * @param value   Value to record (f.ex. nanoseconds).
+ */
+void jutil_time_histogram_record(jutil_time_histogram_t *session, unsigned long long value);
+
+/**
+ * @brief Records time since timestamp.
+ * 
+ * @param session Histogram.
+ * @param start   Timestamp from @c #jutil_time_getNanos() .
+ */
+void jutil_time_histogram_recordSince(jutil_time_histogram_t *session, unsigned long long start);
+
+/**
+ * @brief Records value, while other threads may record too.
+ * 
+ * Uses atomic read-modify-write operations, so it is slower
+ * than @c #jutil_time_histogram_record() . If any thread uses
+ * this function on a histogram, all threads have to.
+ * 
+ * @param session Histogram.
+ * @param value   Value to record (f.ex. nanoseconds).
+ */
+void jutil_time_histogram_recordAtomic(jutil_time_histogram_t *session, unsigned long long value);
+
+/**
+ * @brief Adds values of source histogram to destination.
+ * 
+ * @param dest    Histogram to add to. Has to be recorded by
+ *                calling thread or not recorded at all.
+ * @param src     Histogram to add.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+int jutil_time_histogram_merge(jutil_time_histogram_t *dest, const jutil_time_histogram_t *src);
+
+/**
+ * @brief Removes all values.
+ * 
+ * Has to be called by recording thread.
+ * 
+ * @param session Histogram to reset.
+ */
+void jutil_time_histogram_reset(jutil_time_histogram_t *session);
+
+/**
+ * @brief Returns value at percentile.
+ * 
+ * Value is the upper bound of the bucket, so at least
+ * @c percentile percent of values are lower or equal.
+ * 
+ * @param session     Histogram.
+ * @param percentile  Percentile between @c 0 and @c 100
+ *                    (f.ex. @c 99.9 ).
+ * 
+ * @return            Value at percentile.
+ * @return            @c 0 , if histogram is empty.
+ */
+unsigned long long jutil_time_histogram_getPercentile(const jutil_time_histogram_t *session, double percentile);
+
+/**
+ * @brief Returns number of recorded values.
+ * 
+ * @param session Histogram.
+ * 
+ * @return        Number of values.
+ */
+unsigned long long jutil_time_histogram_getCount(const jutil_time_histogram_t *session);
+
+/**
+ * @brief Returns lowest recorded value.
+ * 
+ * @param session Histogram.
+ * 
+ * @return        Lowest value.
+ * @return        @c 0 , if histogram is empty.
+ */
+unsigned long long jutil_time_histogram_getMin(const jutil_time_histogram_t *session);
+
+/**
+ * @brief Returns highest recorded value.
+ * 
+ * @param session Histogram.
+ * 
+ * @return        Highest value.
+ * @return        @c 0 , if histogram is empty.
+ */
+unsigned long long jutil_time_histogram_getMax(const jutil_time_histogram_t *session);
+
+/**
+ * @brief Returns mean of recorded values.
+ * 
+ * @param session Histogram.
+ * 
+ * @return        Mean value.
+ * @return        @c 0 , if histogram is empty.
+ */
+double jutil_time_histogram_getMean(const jutil_time_histogram_t *session);
+
 #ifdef __cplusplus
 }
 #endif
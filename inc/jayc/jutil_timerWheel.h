@@ -0,0 +1,202 @@
+/**
+ * @file jutil_timerWheel.h
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Hierarchical timer wheel for many timeouts.
+ * 
+ * Timers are owned by the caller (usually embedded in a
+ * connection structure) and are kept in lists of wheel slots,
+ * so arming and cancelling a timer is @c O(1) and needs no
+ * memory allocation or system call.
+ * 
+ * The wheel advances in ticks of a fixed resolution. It does
+ * not create threads. Its timerfd becomes readable, while timers
+ * are armed, and @c #jutil_timerWheel_process() calls the handlers
+ * of all expired timers in one batch. The descriptor can be
+ * watched by a jcon_eventLoop:
+ * 
+ * @code
+ * static void timerWheel_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events)
+ * {
+ *   jutil_timerWheel_process((jutil_timerWheel_t *)watcher->ctx);
+ * }
+ * 
+ * watcher.file_descriptor = jutil_timerWheel_getFD(wheel);
+ * watcher.events = JCON_EVENTLOOP_EVENT_READ;
+ * watcher.handler = &timerWheel_handler;
+ * watcher.ctx = wheel;
+ * jcon_eventLoop_add(loop, &watcher);
+ * @endcode
+ * 
+ * All functions of a wheel and its timers have to be called
+ * by the same thread.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#ifndef INCLUDE_JUTIL_TIMERWHEEL_H
+#define INCLUDE_JUTIL_TIMERWHEEL_H
+
+#include <jayc/jlog.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Tick resolution in milliseconds, if @c 0 is given.
+ */
+#define JUTIL_TIMERWHEEL_TICK_DEFAULT 10
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+typedef struct __jutil_timerWheel_session jutil_timerWheel_t;
+
+/**
+ * @brief Timer, that can be armed in a wheel.
+ */
+typedef struct __jutil_timerWheel_timer jutil_timerWheel_timer_t;
+
+/**
+ * @brief Function gets called, when timer expires.
+ * 
+ * Timer is disarmed before call and can be armed again
+ * by the handler. Handler may arm, cancel and free any timer.
+ * 
+ * @param wheel Wheel, that processes the timer.
+ * @param timer Expired timer.
+ */
+typedef void(*jutil_timerWheel_handler_t)(jutil_timerWheel_t *wheel, jutil_timerWheel_timer_t *timer);
+
+/**
+ * @brief Timer, that can be armed in a wheel.
+ * 
+ * Memory is owned by the caller and has to stay valid,
+ * while the timer is armed. Has to be initialized with
+ * @c #jutil_timerWheel_timer_init() .
+ */
+struct __jutil_timerWheel_timer
+{
+  jutil_timerWheel_handler_t handler; /**< Handler to call, when timer expires. */
+  void *ctx;                          /**< Context pointer for handler. */
+
+  jutil_timerWheel_timer_t *next;     /**< Internal. Next timer in slot. */
+  jutil_timerWheel_timer_t **pprev;   /**< Internal. Link pointing to timer. @c NULL , if not armed. */
+  unsigned long long expires;         /**< Internal. Tick, at which timer expires. */
+};
+
+/**
+ * @brief Creates timer wheel.
+ * 
+ * Wheel covers about 18 hours with a tick of 1ms. Longer
+ * timeouts are moved down the wheel again, until they expire.
+ * 
+ * @param tick_ms Resolution in milliseconds. @c 0 for
+ *                @c #JUTIL_TIMERWHEEL_TICK_DEFAULT .
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Timer wheel session.
+ * @return        @c NULL , if error occured.
+ */
+jutil_timerWheel_t *jutil_timerWheel_init(long tick_ms, jlog_t *logger);
+
+/**
+ * @brief Closes timerfd and frees memory.
+ * 
+ * Armed timers are not called and not freed.
+ * 
+ * @param session Session to free.
+ */
+void jutil_timerWheel_free(jutil_timerWheel_t *session);
+
+/**
+ * @brief Initializes timer.
+ * 
+ * @param timer   Timer to initialize.
+ * @param handler Handler to call, when timer expires.
+ * @param ctx     Context pointer for handler.
+ */
+void jutil_timerWheel_timer_init(jutil_timerWheel_timer_t *timer, jutil_timerWheel_handler_t handler, void *ctx);
+
+/**
+ * @brief Arms timer.
+ * 
+ * If timer is already armed, it is moved to the new timeout.
+ * Timeout is rounded up to the next tick, so handler is never
+ * called early.
+ * 
+ * @param session     Timer wheel.
+ * @param timer       Initialized timer.
+ * @param timeout_ms  Milliseconds until timer expires.
+ * 
+ * @return            @c true , if timer was armed.
+ * @return            @c false , if error occured.
+ */
+int jutil_timerWheel_arm(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer, long timeout_ms);
+
+/**
+ * @brief Disarms timer.
+ * 
+ * Does nothing, if timer is not armed. After this call
+ * the timer memory can be freed.
+ * 
+ * @param session Timer wheel of timer.
+ * @param timer   Timer to disarm.
+ */
+void jutil_timerWheel_cancel(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer);
+
+/**
+ * @brief Checks, if timer is armed.
+ * 
+ * @param timer Timer to check.
+ * 
+ * @return      @c true , if timer is armed.
+ * @return      @c false , if timer is not armed.
+ */
+int jutil_timerWheel_isArmed(const jutil_timerWheel_timer_t *timer);
+
+/**
+ * @brief Returns number of armed timers.
+ * 
+ * @param session Timer wheel.
+ * 
+ * @return        Number of armed timers.
+ */
+size_t jutil_timerWheel_getCount(jutil_timerWheel_t *session);
+
+/**
+ * @brief Returns timerfd of wheel.
+ * 
+ * Descriptor is readable, when ticks have passed, while
+ * timers are armed. Should only be used to wait for the
+ * descriptor.
+ * 
+ * @param session Timer wheel.
+ * 
+ * @return        File descriptor.
+ * @return        @c -1 , if session is @c NULL .
+ */
+int jutil_timerWheel_getFD(jutil_timerWheel_t *session);
+
+/**
+ * @brief Advances wheel to current time and calls handlers
+ *        of expired timers.
+ * 
+ * Does not block.
+ * 
+ * @param session Timer wheel to process.
+ * 
+ * @return        Number of handlers called.
+ * @return        @c -1 , if error occured.
+ */
+int jutil_timerWheel_process(jutil_timerWheel_t *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JUTIL_TIMERWHEEL_H */
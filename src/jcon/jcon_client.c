@@ -11,9 +11,20 @@
 
 #include <jayc/jcon_client.h>
 #include <jayc/jcon_client_dev.h>
+#include <jayc/jutil_alloc.h>
 #include <stdlib.h>
 #include <stdbool.h>
 
+/**
+ * @brief Number of segments sent with one call of @c #jcon_client_sendBuffer() .
+ */
+#define JCON_CLIENT_BUFFER_IOV 64
+
+/**
+ * @brief Allocation statistics of module.
+ */
+JUTIL_ALLOC_MODULE("jcon_client");
+
 //------------------------------------------------------------------------------
 //
 void jcon_client_session_free(jcon_client_t *session)
@@ -28,7 +39,7 @@ void jcon_client_session_free(jcon_client_t *session)
     session->session_free_handler(session->session_context);
   }
 
-  free(session);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
@@ -172,4 +183,170 @@ size_t jcon_client_sendData(jcon_client_t *session, void *data_ptr, size_t data_
   }
 
   return 0;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_sendDataV(jcon_client_t *session, const struct iovec *iov, int iov_count)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  if(iov == NULL)
+  {
+    return 0;
+  }
+
+  if(session->function_sendDataV)
+  {
+    return session->function_sendDataV(session->session_context, iov, iov_count);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_trySendDataV(jcon_client_t *session, const struct iovec *iov, int iov_count)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  if(iov == NULL)
+  {
+    return 0;
+  }
+
+  if(session->function_trySendDataV)
+  {
+    return session->function_trySendDataV(session->session_context, iov, iov_count);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_recvBuffer(jcon_client_t *session, jutil_buffer_t *buffer, size_t size)
+{
+  if(session == NULL || buffer == NULL || size == 0)
+  {
+    return 0;
+  }
+
+  size_t available;
+  void *data_ptr = jutil_buffer_reserve(buffer, size, &available);
+  if(data_ptr == NULL)
+  {
+    return 0;
+  }
+
+  size_t bytes_read = jcon_client_recvData(session, data_ptr, size);
+  jutil_buffer_commit(buffer, bytes_read);
+  return bytes_read;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_sendBuffer(jcon_client_t *session, jutil_buffer_t *buffer)
+{
+  if(session == NULL || buffer == NULL)
+  {
+    return 0;
+  }
+
+  struct iovec iov[JCON_CLIENT_BUFFER_IOV];
+  size_t size = jutil_buffer_getSize(buffer);
+  size_t bytes_sent = 0;
+
+  while(bytes_sent < size)
+  {
+    int iov_count = jutil_buffer_getIovec(buffer, bytes_sent, iov, JCON_CLIENT_BUFFER_IOV);
+    size_t iov_size = 0;
+    for(int i = 0; i < iov_count; i++)
+    {
+      iov_size += iov[i].iov_len;
+    }
+
+    size_t ret = jcon_client_sendDataV(session, iov, iov_count);
+    bytes_sent += ret;
+    if(ret != iov_size)
+    {
+      break;
+    }
+  }
+
+  return bytes_sent;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_sendFile(jcon_client_t *session, int file_descriptor, off_t offset, size_t size)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  if(session->function_sendFile)
+  {
+    return session->function_sendFile(session->session_context, file_descriptor, offset, size);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_setCork(jcon_client_t *session, int enable)
+{
+  if(session == NULL)
+  {
+    return false;
+  }
+
+  if(session->function_setCork)
+  {
+    return session->function_setCork(session->session_context, enable);
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_getFileDescriptor(jcon_client_t *session)
+{
+  if(session == NULL)
+  {
+    return -1;
+  }
+
+  if(session->function_getFileDescriptor)
+  {
+    return session->function_getFileDescriptor(session->session_context);
+  }
+
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_setPollTimeout(jcon_client_t *session, int timeout)
+{
+  if(session == NULL)
+  {
+    return false;
+  }
+
+  if(session->function_setPollTimeout)
+  {
+    return session->function_setPollTimeout(session->session_context, timeout);
+  }
+
+  return false;
 }
\ No newline at end of file
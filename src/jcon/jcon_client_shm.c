@@ -0,0 +1,1331 @@
+/**
+ * @file jcon_client_shm.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jcon_client_shm.
+ * 
+ * Every ring has one writer and one reader. The writer owns
+ * @c tail , the reader owns @c head , both only grow and are
+ * masked with the ring size for positions.
+ * 
+ * Wakeups: the reader sets @c armed , before it waits for the
+ * bell (its @c eventfd ). A writer, that finds @c armed set
+ * after publishing data, clears it and rings the bell. If the
+ * reader returns with data left in the ring, it rings its own
+ * bell, so level triggered event loops come back for the rest.
+ * A writer, that found the ring full, sets @c want_space and
+ * the reader rings the bell of the writer, after it made room.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for memfd_create() */
+
+#include <jayc/jcon_client_shm.h>
+#include <jayc/jcon_client_dev.h>
+#include <jayc/jcon_socketUnix.h>
+#include <jayc/jcon_handoff.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_alloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_client_shm");
+
+
+
+//==============================================================================
+// Define constants and defaults.
+//
+
+/**
+ * @brief Connection type, to return for @c #jcon_client_getConnectionType() .
+ */
+#define JCON_CLIENT_SHM_CONNECTIONTYPE "SHM"
+
+/**
+ * @brief Default value for polling timeout.
+ * 
+ * When checking, if new data is available, function @c poll()
+ * is used. This value tells the function, how long to
+ * wait for new data in milliseconds.
+ */
+#define JCON_CLIENT_SHM_POLL_TIMEOUT_DEFAULT 10
+
+/**
+ * @brief Milliseconds, server waits for shared memory of new client.
+ */
+#define JCON_CLIENT_SHM_TIMEOUT_HANDSHAKE 1000
+
+/**
+ * @brief Nanoseconds, blocking sends sleep, while ring of peer is full.
+ */
+#define JCON_CLIENT_SHM_WAIT_INTERVAL 50000
+
+/**
+ * @brief Identifies shared memory of jcon_client_shm ("JCSM").
+ */
+#define JCON_CLIENT_SHM_MAGIC 0x4A43534D
+
+/**
+ * @brief Version of memory layout.
+ */
+#define JCON_CLIENT_SHM_VERSION 1
+
+/**
+ * @brief Side of client in rings and bells.
+ */
+#define JCON_CLIENT_SHM_SIDE_CLIENT 0
+
+/**
+ * @brief Side of server in rings and bells.
+ */
+#define JCON_CLIENT_SHM_SIDE_SERVER 1
+
+/**
+ * @brief Descriptors passed at handshake (memory and two bells).
+ */
+#define JCON_CLIENT_SHM_HANDSHAKE_FDS 3
+
+/**
+ * @brief Size of reference string buffer.
+ */
+#define JCON_CLIENT_SHM_SIZE_REFERENCE 128
+
+/**
+ * @brief Size of cache line, rings keep positions of reader
+ *        and writer on different lines.
+ */
+#define JCON_CLIENT_SHM_CACHE_LINE 64
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Control block of one ring in shared memory.
+ */
+typedef struct __jcon_client_shm_ring
+{
+  _Alignas(JCON_CLIENT_SHM_CACHE_LINE) _Atomic uint64_t head;   /**< Bytes read, written by reader. */
+  _Alignas(JCON_CLIENT_SHM_CACHE_LINE) _Atomic uint64_t tail;   /**< Bytes written, written by writer. */
+  _Alignas(JCON_CLIENT_SHM_CACHE_LINE) _Atomic uint32_t armed;  /**< Reader waits for bell. */
+  _Atomic uint32_t want_space;                                  /**< Writer waits for space. */
+  _Atomic uint32_t closed;                                      /**< Writer closed connection. */
+} jcon_client_shm_ring_t;
+
+/**
+ * @brief Header of shared memory. Followed by data of both rings.
+ */
+typedef struct __jcon_client_shm_header
+{
+  uint32_t magic;                     /**< @c #JCON_CLIENT_SHM_MAGIC . */
+  uint32_t version;                   /**< @c #JCON_CLIENT_SHM_VERSION . */
+  uint64_t ring_size;                 /**< Size of every ring in bytes. */
+  jcon_client_shm_ring_t rings[2];    /**< Ring @c i is written by side @c i . */
+} jcon_client_shm_header_t;
+
+
+
+//==============================================================================
+// Declare handlers and internal functions.
+//
+
+/**
+ * @brief Function for context free handler.
+ * 
+ * Will close connection, if connected and free context data.
+ * 
+ * @param ctx Context to free.
+ */
+static void jcon_client_shm_session_free(void *ctx);
+
+/**
+ * @brief Connects to server and passes shared memory.
+ * 
+ * Not usable, if initialized via @c #jcon_client_shm_session_accept() .
+ * 
+ * @param ctx Context of session to reset.
+ * 
+ * @return    @c true , if reset was successful.
+ * @return    @c false , if reset failed.
+ */
+static int jcon_client_shm_reset(void *ctx);
+
+/**
+ * @brief Closes connection and unmaps shared memory.
+ * 
+ * @param ctx Context of session to close.
+ */
+static void jcon_client_shm_close(void *ctx);
+
+/**
+ * @brief Checks, wether client is connected.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c true , if client is connected.
+ * @return    @c false , if client is not connected or error occured.
+ */
+static int jcon_client_shm_isConnected(void *ctx);
+
+/**
+ * @brief Returnes @c jcon_client_shm_context_t#reference_string .
+ * 
+ * @param ctx Context of session to ask from.
+ * 
+ * @return    Session string.
+ * @return    @c NULL , if error occured.
+ */
+static const char *jcon_client_shm_getReferenceString(void *ctx);
+
+/**
+ * @brief Checks, if new data is available to read.
+ * 
+ * Spins on the ring first, then waits on the descriptor.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c true , if new data is available.
+ * @return    @c false , if no new data or error occured.
+ */
+static int jcon_client_shm_newData(void *ctx);
+
+/**
+ * @brief Reads data from ring of peer.
+ * 
+ * @param ctx       Context of session to read from.
+ * @param data_ptr  Pointer, in which data is stored.
+ *                  If NULL, bytes will still be read (number given by
+ *                  data_size), but nothing will be returned.
+ * @param data_size Size (in bytes) of data to read.
+ * 
+ * @return          Size of data recieved.
+ * @return          @c 0 , if no data recieved, or error occured.
+ */
+static size_t jcon_client_shm_recvData(void *ctx, void *data_ptr, size_t data_size);
+
+/**
+ * @brief Writes data to ring, waits while ring is full.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param data_ptr  Pointer to data to be sent.
+ *                  If NULL, nothing will happen.
+ * @param data_size Size of data_ptr in bytes.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_shm_sendData(void *ctx, void *data_ptr, size_t data_size);
+
+/**
+ * @brief Writes data from multiple buffers to ring,
+ *        waits while ring is full.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_shm_sendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Writes data from multiple buffers, as far as ring has space.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if ring is full or error occured.
+ */
+static size_t jcon_client_shm_trySendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Returns descriptor, that is readable for data and hangups.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c epoll descriptor of connection.
+ * @return    @c -1 , if not connected or error occured.
+ */
+static int jcon_client_shm_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Sets timeout for @c #jcon_client_shm_newData() .
+ * 
+ * @param ctx     Context of session to configure.
+ * @param timeout Timeout in milliseconds. @c -1 waits until data arrives.
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_shm_setPollTimeout(void *ctx, int timeout);
+
+/**
+ * @brief Creates session object around context.
+ * 
+ * @param ctx Context, owned by session afterwards.
+ * 
+ * @return    New session.
+ * @return    @c NULL , if error occured. Context is not freed.
+ */
+static jcon_client_t *jcon_client_shm_create(void *ctx);
+
+/**
+ * @brief Maps shared memory and creates wait descriptor.
+ * 
+ * @param ctx     Context of session.
+ * @param memory  Descriptor of shared memory.
+ * @param size    Size of shared memory.
+ * 
+ * @return        @c true , if memory was mapped.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_shm_map(void *ctx, int memory, size_t size);
+
+/**
+ * @brief Unmaps shared memory and closes descriptors.
+ * 
+ * @param ctx Context of session.
+ */
+static void jcon_client_shm_unmap(void *ctx);
+
+/**
+ * @brief Copies buffers into ring of this side.
+ * 
+ * @param ctx       Context of session.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * @param blocking  Wait for space, until all data is written.
+ * 
+ * @return          Size of data written.
+ */
+static size_t jcon_client_shm_write(void *ctx, const struct iovec *iov, int iov_count, int blocking);
+
+/**
+ * @brief Checks, if the peer closed or exited.
+ * 
+ * @param ctx Context of session.
+ * 
+ * @return    @c true , if peer is gone.
+ */
+static int jcon_client_shm_isPeerGone(void *ctx);
+
+/**
+ * @brief Increments @c eventfd .
+ * 
+ * @param fd Bell to ring.
+ */
+static void jcon_client_shm_ring(int fd);
+
+/**
+ * @brief Resets @c eventfd .
+ * 
+ * @param fd Bell to reset.
+ */
+static void jcon_client_shm_drain(int fd);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * Uses logger from @c ctx , or if logger is @c NULL , uses global logger.
+ * 
+ * @param ctx       Session for info about connection.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_client_shm_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_client_shm_context_t *)ctx)->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG
+  #define DEBUG(ctx, fmt, ...)
+#else
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_client_shm_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_client_shm_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_client_shm_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_client_shm_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_client_shm_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(ctx, fmt, ...) jcon_client_shm_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Define context structure.
+//
+
+/**
+ * @brief Data for jcon_client_shm object.
+ */
+typedef struct __jcon_client_shm_context
+{
+  jcon_socket_t *connection;      /**< Unix connection, tells about exit of peer. */
+  int accepted;                   /**< Created by server, can not be reset. */
+  int side;                       /**< @c #JCON_CLIENT_SHM_SIDE_CLIENT or @c #JCON_CLIENT_SHM_SIDE_SERVER . */
+  int connected;                  /**< Memory is mapped and peer was not gone. */
+
+  jcon_client_shm_header_t *header; /**< Mapped shared memory. */
+  size_t map_size;                  /**< Size of mapping. */
+  size_t ring_size;                 /**< Size of every ring. */
+  jcon_client_shm_ring_t *tx;       /**< Ring written by this side. */
+  jcon_client_shm_ring_t *rx;       /**< Ring read by this side. */
+  uint8_t *tx_data;                 /**< Data of written ring. */
+  uint8_t *rx_data;                 /**< Data of read ring. */
+
+  int bell;                       /**< Rung by peer, when data arrived or space is free. */
+  int peer_bell;                  /**< Bell of peer. */
+  int wait_fd;                    /**< @c epoll of bell and connection. */
+
+  int poll_timeout;               /**< Timeout for asking for new data in milliseconds. */
+  long spin_time;                 /**< Nanoseconds to spin on ring, before waiting. */
+  char reference_string[JCON_CLIENT_SHM_SIZE_REFERENCE]; /**< Returned by @c #jcon_client_getReferenceString() . */
+  jlog_t *logger;                 /**< Logger for debug and error messages. */
+} jcon_client_shm_context_t;
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_shm_session_init(char *filepath, size_t ring_size, jlog_t *logger)
+{
+  if(ring_size == 0)
+  {
+    ring_size = JCON_CLIENT_SHM_RING_SIZE_DEFAULT;
+  }
+
+  if(ring_size < JCON_CLIENT_SHM_RING_SIZE_MIN || ring_size > JCON_CLIENT_SHM_RING_SIZE_MAX || (ring_size & (ring_size - 1)) != 0)
+  {
+    ERROR(NULL, "<SHM:%s> Invalid ring size [%zu].", filepath, ring_size);
+    return NULL;
+  }
+
+  jcon_client_shm_context_t *ctx = (jcon_client_shm_context_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_client_shm_context_t));
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "<SHM:%s> calloc() failed.", filepath);
+    return NULL;
+  }
+
+  ctx->accepted = false;
+  ctx->side = JCON_CLIENT_SHM_SIDE_CLIENT;
+  ctx->ring_size = ring_size;
+  ctx->bell = -1;
+  ctx->peer_bell = -1;
+  ctx->wait_fd = -1;
+  ctx->poll_timeout = JCON_CLIENT_SHM_POLL_TIMEOUT_DEFAULT;
+  ctx->spin_time = JCON_CLIENT_SHM_SPIN_DEFAULT;
+  ctx->logger = logger;
+  snprintf(ctx->reference_string, sizeof(ctx->reference_string), "SHM:%s", filepath);
+
+  ctx->connection = jcon_socketUnix_simple_init(filepath, logger);
+  if(ctx->connection == NULL)
+  {
+    ERROR(NULL, "<SHM:%s> jcon_socketUnix_simple_init() failed. Destroying context.", filepath);
+    JUTIL_ALLOC_FREE(ctx);
+    return NULL;
+  }
+
+  jcon_client_t *session = jcon_client_shm_create(ctx);
+  if(session == NULL)
+  {
+    ERROR(NULL, "<SHM:%s> jcon_client_shm_create() failed.", filepath);
+    jcon_socket_free(ctx->connection);
+    JUTIL_ALLOC_FREE(ctx);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_shm_session_accept(jcon_socket_t *unix_session, jlog_t *logger)
+{
+  if(unix_session == NULL)
+  {
+    ERROR(NULL, "<SHM> unix_session is NULL.");
+    return NULL;
+  }
+
+  jcon_client_shm_context_t *ctx = (jcon_client_shm_context_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_client_shm_context_t));
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "<SHM> calloc() failed.");
+    return NULL;
+  }
+
+  ctx->connection = unix_session;
+  ctx->accepted = true;
+  ctx->side = JCON_CLIENT_SHM_SIDE_SERVER;
+  ctx->bell = -1;
+  ctx->peer_bell = -1;
+  ctx->wait_fd = -1;
+  ctx->poll_timeout = JCON_CLIENT_SHM_POLL_TIMEOUT_DEFAULT;
+  ctx->spin_time = JCON_CLIENT_SHM_SPIN_DEFAULT;
+  ctx->logger = logger;
+
+  int socket_fd = jcon_socket_getFileDescriptor(unix_session);
+
+  /* Accepted Unix sockets have no address, the peer process tells connections apart. */
+  pid_t peer_pid;
+  if(jcon_socketUnix_getPeerCredentials(unix_session, &peer_pid, NULL, NULL))
+  {
+    snprintf(ctx->reference_string, sizeof(ctx->reference_string), "SHM:pid=%d,fd=%d", (int)peer_pid, socket_fd);
+  }
+  else
+  {
+    snprintf(ctx->reference_string, sizeof(ctx->reference_string), "SHM:fd=%d", socket_fd);
+  }
+
+  int fds[JCON_CLIENT_SHM_HANDSHAKE_FDS];
+  int count = jcon_handoff_recv(socket_fd, fds, JCON_CLIENT_SHM_HANDSHAKE_FDS, JCON_CLIENT_SHM_TIMEOUT_HANDSHAKE);
+  if(count != JCON_CLIENT_SHM_HANDSHAKE_FDS)
+  {
+    ERROR(ctx, "Client did not send shared memory.");
+    for(int i = 0; i < count; i++)
+    {
+      close(fds[i]);
+    }
+    JUTIL_ALLOC_FREE(ctx);
+    return NULL;
+  }
+
+  /* Bell of client is rung by the server and the other way round. */
+  ctx->peer_bell = fds[1];
+  ctx->bell = fds[2];
+
+  struct stat memory_stat;
+  if(fstat(fds[0], &memory_stat) < 0 || memory_stat.st_size < (off_t)sizeof(jcon_client_shm_header_t))
+  {
+    ERROR(ctx, "Invalid shared memory.");
+    close(fds[0]);
+    close(fds[1]);
+    close(fds[2]);
+    JUTIL_ALLOC_FREE(ctx);
+    return NULL;
+  }
+
+  int ret_map = jcon_client_shm_map(ctx, fds[0], (size_t)memory_stat.st_size);
+  close(fds[0]);
+  if(ret_map == false)
+  {
+    ERROR(ctx, "jcon_client_shm_map() failed.");
+    jcon_client_shm_unmap(ctx);
+    JUTIL_ALLOC_FREE(ctx);
+    return NULL;
+  }
+
+  jcon_client_t *session = jcon_client_shm_create(ctx);
+  if(session == NULL)
+  {
+    ERROR(ctx, "jcon_client_shm_create() failed.");
+    jcon_client_shm_unmap(ctx);
+    JUTIL_ALLOC_FREE(ctx);
+    return NULL;
+  }
+
+  DEBUG(ctx, "Accepted connection with rings of [%zu] bytes.", ctx->ring_size);
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_setSpinTime(jcon_client_t *session, long nanoseconds)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->connection_type == NULL || strcmp(session->connection_type, JCON_CLIENT_SHM_CONNECTIONTYPE) != 0)
+  {
+    ERROR(NULL, "Session is not of type SHM.");
+    return false;
+  }
+
+  if(nanoseconds < 0)
+  {
+    ERROR(session->session_context, "Invalid spin time [%ld].", nanoseconds);
+    return false;
+  }
+
+  ((jcon_client_shm_context_t *)session->session_context)->spin_time = nanoseconds;
+  return true;
+}
+
+
+
+//==============================================================================
+// Implement handlers and internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_shm_create(void *ctx)
+{
+  jcon_client_t *session = (jcon_client_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_t));
+  if(session == NULL)
+  {
+    ERROR(ctx, "malloc() failed.");
+    return NULL;
+  }
+
+  session->function_reset = &jcon_client_shm_reset;
+  session->function_close = &jcon_client_shm_close;
+  session->function_getReferenceString = &jcon_client_shm_getReferenceString;
+  session->function_isConnected = &jcon_client_shm_isConnected;
+  session->function_newData = &jcon_client_shm_newData;
+  session->function_recvData = &jcon_client_shm_recvData;
+  session->function_sendData = &jcon_client_shm_sendData;
+  session->function_sendDataV = &jcon_client_shm_sendDataV;
+  session->function_trySendDataV = &jcon_client_shm_trySendDataV;
+  session->function_sendFile = NULL;
+  session->function_getFileDescriptor = &jcon_client_shm_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_shm_setPollTimeout;
+  session->function_setCork = NULL;
+  session->session_free_handler = &jcon_client_shm_session_free;
+  session->connection_type = JCON_CLIENT_SHM_CONNECTIONTYPE;
+  session->session_context = ctx;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_shm_session_free(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return;
+  }
+
+  jcon_client_shm_close(ctx);
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  jcon_socket_free(session_context->connection);
+  JUTIL_ALLOC_FREE(ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_reset(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(session_context->accepted)
+  {
+    ERROR(ctx, "Accepted connections can not be reset.");
+    return false;
+  }
+
+  jcon_client_shm_close(ctx);
+
+  if(jcon_socket_connect(session_context->connection) == false)
+  {
+    ERROR(ctx, "jcon_socket_connect() failed.");
+    return false;
+  }
+
+  size_t size = sizeof(jcon_client_shm_header_t) + 2 * session_context->ring_size;
+
+  int memory = memfd_create("jcon-shm", MFD_CLOEXEC);
+  if(memory < 0)
+  {
+    ERROR(ctx, "memfd_create() failed [%d : %s].", errno, strerror(errno));
+    jcon_socket_close(session_context->connection);
+    return false;
+  }
+
+  if(ftruncate(memory, (off_t)size) < 0)
+  {
+    ERROR(ctx, "ftruncate() failed [%d : %s].", errno, strerror(errno));
+    close(memory);
+    jcon_socket_close(session_context->connection);
+    return false;
+  }
+
+  int bells[2];
+  bells[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  bells[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(bells[0] < 0 || bells[1] < 0)
+  {
+    ERROR(ctx, "eventfd() failed [%d : %s].", errno, strerror(errno));
+    if(bells[0] >= 0)
+    {
+      close(bells[0]);
+    }
+    if(bells[1] >= 0)
+    {
+      close(bells[1]);
+    }
+    close(memory);
+    jcon_socket_close(session_context->connection);
+    return false;
+  }
+  session_context->bell = bells[0];
+  session_context->peer_bell = bells[1];
+
+  /* Memory is zero after ftruncate(), only the header has to be set. */
+  if(jcon_client_shm_map(ctx, memory, size) == false)
+  {
+    ERROR(ctx, "jcon_client_shm_map() failed.");
+    close(memory);
+    jcon_client_shm_unmap(ctx);
+    jcon_socket_close(session_context->connection);
+    return false;
+  }
+
+  int fds[JCON_CLIENT_SHM_HANDSHAKE_FDS] = { memory, bells[0], bells[1] };
+  int ret_send = jcon_handoff_send(jcon_socket_getFileDescriptor(session_context->connection), fds, JCON_CLIENT_SHM_HANDSHAKE_FDS);
+  close(memory);
+  if(ret_send == false)
+  {
+    ERROR(ctx, "jcon_handoff_send() failed.");
+    jcon_client_shm_unmap(ctx);
+    jcon_socket_close(session_context->connection);
+    return false;
+  }
+
+  DEBUG(ctx, "Connected with rings of [%zu] bytes.", session_context->ring_size);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_shm_close(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(session_context->header == NULL)
+  {
+    DEBUG(ctx, "Client not connected.");
+    return;
+  }
+
+  /* Peer reads what is left in the ring, before it sees the close. */
+  atomic_store_explicit(&session_context->tx->closed, true, memory_order_release);
+  atomic_store(&session_context->tx->armed, false);
+  jcon_client_shm_ring(session_context->peer_bell);
+
+  jcon_client_shm_unmap(ctx);
+  if(jcon_socket_isConnected(session_context->connection))
+  {
+    jcon_socket_close(session_context->connection);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_isConnected(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  return session_context->connected;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_client_shm_getReferenceString(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return NULL;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  return session_context->reference_string;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_newData(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(session_context->connected == false)
+  {
+    return false;
+  }
+
+  jcon_client_shm_ring_t *rx = session_context->rx;
+  uint64_t head = atomic_load_explicit(&rx->head, memory_order_relaxed);
+
+  if(atomic_load_explicit(&rx->tail, memory_order_acquire) != head)
+  {
+    return true;
+  }
+
+  if(session_context->spin_time > 0)
+  {
+    /* Writer does not ring, while reader is spinning. */
+    atomic_store(&rx->armed, false);
+
+    unsigned long long end = jutil_time_getNanos() + (unsigned long long)session_context->spin_time;
+    for(unsigned int i = 1; ; i++)
+    {
+      if(atomic_load_explicit(&rx->tail, memory_order_acquire) != head)
+      {
+        return true;
+      }
+      if((i % 64) == 0 && jutil_time_getNanos() >= end)
+      {
+        break;
+      }
+    }
+
+    jcon_client_shm_drain(session_context->bell);
+    atomic_store(&rx->armed, true);
+    if(atomic_load(&rx->tail) != head)
+    {
+      return true;
+    }
+  }
+
+  struct pollfd poll_fds[1];
+  poll_fds->fd = session_context->wait_fd;
+  poll_fds->events = POLLIN;
+
+  /* Signals must not extend the timeout, so poll is retried until deadline. */
+  int timeout = session_context->poll_timeout;
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, timeout);
+
+  int ret_poll;
+  while((ret_poll = poll(poll_fds, 1, timeout)) < 0 && errno == EINTR)
+  {
+    timeout = jutil_time_deadline_getRemaining(&deadline);
+  }
+
+  if(ret_poll < 0)
+  {
+    ERROR(ctx, "poll() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  /* Hangups also count as new data, so recvData() notices them. */
+  return (ret_poll > 0);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_shm_recvData(void *ctx, void *data_ptr, size_t data_size)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(session_context->connected == false)
+  {
+    ERROR(ctx, "Client not connected.");
+    return 0;
+  }
+
+  jcon_client_shm_ring_t *rx = session_context->rx;
+  size_t mask = session_context->ring_size - 1;
+  uint64_t head = atomic_load_explicit(&rx->head, memory_order_relaxed);
+  size_t done = 0;
+
+  while(done < data_size)
+  {
+    uint64_t tail = atomic_load_explicit(&rx->tail, memory_order_acquire);
+
+    if(tail == head)
+    {
+      if(atomic_load(&rx->armed))
+      {
+        break;
+      }
+
+      /* Data, that arrives after arming, is rung or seen on the second look. */
+      jcon_client_shm_drain(session_context->bell);
+      atomic_store(&rx->armed, true);
+      if(atomic_load(&rx->tail) == head)
+      {
+        break;
+      }
+      continue;
+    }
+
+    size_t length = (size_t)(tail - head);
+    if(length > data_size - done)
+    {
+      length = data_size - done;
+    }
+
+    if(data_ptr)
+    {
+      size_t offset = (size_t)head & mask;
+      size_t first = session_context->ring_size - offset;
+      if(first > length)
+      {
+        first = length;
+      }
+      memcpy((uint8_t *)data_ptr + done, session_context->rx_data + offset, first);
+      memcpy((uint8_t *)data_ptr + done + first, session_context->rx_data, length - first);
+    }
+
+    head += length;
+    done += length;
+    atomic_store_explicit(&rx->head, head, memory_order_release);
+  }
+
+  if(done > 0)
+  {
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&rx->want_space, memory_order_relaxed) && atomic_exchange(&rx->want_space, false))
+    {
+      /* Whoever rings a bell disarms it, so the reader drains it. */
+      atomic_store(&session_context->tx->armed, false);
+      jcon_client_shm_ring(session_context->peer_bell);
+    }
+
+    if(atomic_load(&rx->tail) != head)
+    {
+      /* Level triggered event loops come back for the rest. */
+      atomic_store(&rx->armed, false);
+      jcon_client_shm_ring(session_context->bell);
+    }
+    return done;
+  }
+
+  if(jcon_client_shm_isPeerGone(ctx))
+  {
+    DEBUG(ctx, "Peer closed connection.");
+    session_context->connected = false;
+    return 0;
+  }
+
+  errno = EAGAIN;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_shm_sendData(void *ctx, void *data_ptr, size_t data_size)
+{
+  if(data_ptr == NULL)
+  {
+    return 0;
+  }
+
+  struct iovec iov;
+  iov.iov_base = data_ptr;
+  iov.iov_len = data_size;
+
+  return jcon_client_shm_write(ctx, &iov, 1, true);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_shm_sendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  return jcon_client_shm_write(ctx, iov, iov_count, true);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_shm_trySendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  return jcon_client_shm_write(ctx, iov, iov_count, false);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  return session_context->wait_fd;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_setPollTimeout(void *ctx, int timeout)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(timeout < -1)
+  {
+    ERROR(ctx, "Invalid poll timeout [%d].", timeout);
+    return false;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  session_context->poll_timeout = timeout;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_map(void *ctx, int memory, size_t size)
+{
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, memory, 0);
+  if(map == MAP_FAILED)
+  {
+    ERROR(ctx, "mmap() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  jcon_client_shm_header_t *header = (jcon_client_shm_header_t *)map;
+  session_context->header = header;
+  session_context->map_size = size;
+
+  if(session_context->side == JCON_CLIENT_SHM_SIDE_CLIENT)
+  {
+    header->magic = JCON_CLIENT_SHM_MAGIC;
+    header->version = JCON_CLIENT_SHM_VERSION;
+    header->ring_size = session_context->ring_size;
+    atomic_store(&header->rings[0].armed, true);
+    atomic_store(&header->rings[1].armed, true);
+  }
+  else
+  {
+    uint64_t ring_size = header->ring_size;
+    if(header->magic != JCON_CLIENT_SHM_MAGIC || header->version != JCON_CLIENT_SHM_VERSION
+      || ring_size < JCON_CLIENT_SHM_RING_SIZE_MIN || ring_size > JCON_CLIENT_SHM_RING_SIZE_MAX
+      || (ring_size & (ring_size - 1)) != 0 || size != sizeof(jcon_client_shm_header_t) + 2 * ring_size)
+    {
+      ERROR(ctx, "Shared memory has invalid header.");
+      return false;
+    }
+    session_context->ring_size = (size_t)ring_size;
+  }
+
+  int side = session_context->side;
+  session_context->tx = &header->rings[side];
+  session_context->rx = &header->rings[1 - side];
+  session_context->tx_data = (uint8_t *)map + sizeof(jcon_client_shm_header_t) + (size_t)side * session_context->ring_size;
+  session_context->rx_data = (uint8_t *)map + sizeof(jcon_client_shm_header_t) + (size_t)(1 - side) * session_context->ring_size;
+
+  session_context->wait_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(session_context->wait_fd < 0)
+  {
+    ERROR(ctx, "epoll_create1() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = session_context->bell;
+  if(epoll_ctl(session_context->wait_fd, EPOLL_CTL_ADD, session_context->bell, &event) < 0)
+  {
+    ERROR(ctx, "epoll_ctl() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  int socket_fd = jcon_socket_getFileDescriptor(session_context->connection);
+  event.events = EPOLLRDHUP;
+  event.data.fd = socket_fd;
+  if(epoll_ctl(session_context->wait_fd, EPOLL_CTL_ADD, socket_fd, &event) < 0)
+  {
+    ERROR(ctx, "epoll_ctl() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  session_context->connected = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_shm_unmap(void *ctx)
+{
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(session_context->header)
+  {
+    munmap(session_context->header, session_context->map_size);
+  }
+  if(session_context->wait_fd >= 0)
+  {
+    close(session_context->wait_fd);
+  }
+  if(session_context->bell >= 0)
+  {
+    close(session_context->bell);
+  }
+  if(session_context->peer_bell >= 0)
+  {
+    close(session_context->peer_bell);
+  }
+
+  session_context->header = NULL;
+  session_context->tx = NULL;
+  session_context->rx = NULL;
+  session_context->tx_data = NULL;
+  session_context->rx_data = NULL;
+  session_context->wait_fd = -1;
+  session_context->bell = -1;
+  session_context->peer_bell = -1;
+  session_context->connected = false;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_shm_write(void *ctx, const struct iovec *iov, int iov_count, int blocking)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(session_context->connected == false)
+  {
+    ERROR(ctx, "Client not connected.");
+    return 0;
+  }
+
+  if(iov == NULL || iov_count < 0)
+  {
+    return 0;
+  }
+
+  jcon_client_shm_ring_t *tx = session_context->tx;
+  size_t ring_size = session_context->ring_size;
+  size_t mask = ring_size - 1;
+  uint64_t tail = atomic_load_explicit(&tx->tail, memory_order_relaxed);
+  uint64_t published = tail;
+  size_t done = 0;
+
+  for(int i = 0; i < iov_count; i++)
+  {
+    size_t offset_iov = 0;
+
+    while(offset_iov < iov[i].iov_len)
+    {
+      uint64_t head = atomic_load_explicit(&tx->head, memory_order_acquire);
+      size_t space = ring_size - (size_t)(tail - head);
+
+      if(space == 0)
+      {
+        /* Publish what is written, so the reader can make room. */
+        if(tail != published)
+        {
+          atomic_store_explicit(&tx->tail, tail, memory_order_release);
+          published = tail;
+          atomic_thread_fence(memory_order_seq_cst);
+          if(atomic_load_explicit(&tx->armed, memory_order_relaxed) && atomic_exchange(&tx->armed, false))
+          {
+            jcon_client_shm_ring(session_context->peer_bell);
+          }
+        }
+
+        atomic_store(&tx->want_space, true);
+        if(atomic_load(&tx->head) != head)
+        {
+          continue;
+        }
+
+        if(blocking == false)
+        {
+          return done;
+        }
+
+        if(jcon_client_shm_isPeerGone(ctx))
+        {
+          ERROR(ctx, "Peer closed connection, while sending.");
+          session_context->connected = false;
+          return done;
+        }
+
+        jutil_time_sleep(0, JCON_CLIENT_SHM_WAIT_INTERVAL, false);
+        continue;
+      }
+
+      size_t length = iov[i].iov_len - offset_iov;
+      if(length > space)
+      {
+        length = space;
+      }
+
+      size_t offset = (size_t)tail & mask;
+      size_t first = ring_size - offset;
+      if(first > length)
+      {
+        first = length;
+      }
+      memcpy(session_context->tx_data + offset, (const uint8_t *)iov[i].iov_base + offset_iov, first);
+      memcpy(session_context->tx_data, (const uint8_t *)iov[i].iov_base + offset_iov + first, length - first);
+
+      tail += length;
+      offset_iov += length;
+      done += length;
+    }
+  }
+
+  if(tail != published)
+  {
+    atomic_store_explicit(&tx->tail, tail, memory_order_release);
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&tx->armed, memory_order_relaxed) && atomic_exchange(&tx->armed, false))
+    {
+      jcon_client_shm_ring(session_context->peer_bell);
+    }
+  }
+
+  return done;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_shm_isPeerGone(void *ctx)
+{
+  jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+  if(atomic_load_explicit(&session_context->rx->closed, memory_order_acquire))
+  {
+    return true;
+  }
+
+  /* Nothing is sent over the connection after the handshake, so readable means closed. */
+  char byte;
+  ssize_t ret = recv(jcon_socket_getFileDescriptor(session_context->connection), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  return (ret == 0 || (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR));
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_shm_ring(int fd)
+{
+  uint64_t value = 1;
+  if(write(fd, &value, sizeof(value)) < 0)
+  {
+    /* Counter is already set (EAGAIN) or peer is gone, both wake the reader. */
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_shm_drain(int fd)
+{
+  uint64_t value;
+  if(read(fd, &value, sizeof(value)) < 0)
+  {
+    /* Bell was not rung (EAGAIN). */
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_shm_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(ctx)
+  {
+    jcon_client_shm_context_t *session_context = (jcon_client_shm_context_t *)ctx;
+
+    if(session_context->logger)
+    {
+      jlog_log_message_m(session_context->logger, log_type, file, function, line, "<%s> %s", jcon_client_shm_getReferenceString(ctx), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_client_shm_getReferenceString(ctx), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -11,6 +11,10 @@
 
 #include <jayc/jcon_client_tcp.h>
 #include <jayc/jcon_client_dev.h>
+#include <jayc/jcon_socketUring.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_alloc.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -18,6 +22,15 @@
 #include <stdarg.h>
 #include <stdio.h>
 #include <netinet/in.h>
+#include <unistd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_client_tcp");
+
+
 
 //==============================================================================
 // Define constants and defaults.
@@ -37,6 +50,11 @@
  */
 #define JCON_CLIENT_TCP_POLL_TIMEOUT_DEFAULT 10
 
+/**
+ * @brief Nanoseconds per millisecond, to convert backoff for jutil_thread.
+ */
+#define JCON_CLIENT_TCP_NSECS_PER_MSEC 1000000L
+
 
 
 //==============================================================================
@@ -117,7 +135,7 @@ static size_t jcon_client_tcp_recvData(void *ctx, void *data_ptr, size_t data_si
 
 /**
  * @brief Send data through socket.
- *
+ * 
  * @param ctx       Context of session to send through.
  * @param data_ptr  Pointer to data to be sent.
  *                  If NULL, nothing will happen.
@@ -128,6 +146,128 @@ static size_t jcon_client_tcp_recvData(void *ctx, void *data_ptr, size_t data_si
  */
 static size_t jcon_client_tcp_sendData(void *ctx, void *data_ptr, size_t data_size);
 
+/**
+ * @brief Send data from multiple buffers through socket.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_tcp_sendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends data from multiple buffers without blocking.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if send buffer is full or error occured.
+ */
+static size_t jcon_client_tcp_trySendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends data of file descriptor.
+ * 
+ * @param ctx             Context of session to send through.
+ * @param file_descriptor Descriptor to read data from.
+ * @param offset          Position in file to start reading.
+ * @param size            Number of bytes to send.
+ * 
+ * @return                Size of data sended.
+ * @return                @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_tcp_sendFile(void *ctx, int file_descriptor, off_t offset, size_t size);
+
+/**
+ * @brief Returns file descriptor of socket.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    File descriptor of socket.
+ * @return    @c -1 , if not connected or error occured.
+ */
+static int jcon_client_tcp_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Sets timeout for @c #jcon_client_tcp_newData() .
+ * 
+ * @param ctx     Context of session to configure.
+ * @param timeout Timeout in milliseconds. @c -1 waits until data arrives.
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_tcp_setPollTimeout(void *ctx, int timeout);
+
+/**
+ * @brief Corks or flushes socket.
+ * 
+ * @param ctx     Context of session to configure.
+ * @param enable  @c true to cork, @c false to flush.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_tcp_setCork(void *ctx, int enable);
+
+/**
+ * @brief Checks, if calls should return early, because
+ *        a background reconnect is pending.
+ * 
+ * Wakes up reconnect thread, if client is disconnected.
+ * Reads connection under mutex of reconnect thread, which
+ * is never held during connect attempts.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c true , if reconnects are enabled and client
+ *            is not connected.
+ * @return    @c false , if call should continue.
+ */
+static int jcon_client_tcp_reconnectPending(void *ctx);
+
+/**
+ * @brief Loop function of reconnect thread.
+ * 
+ * Attempts to connect, if client is disconnected and
+ * the backoff time has passed. Connects a new socket
+ * without holding the mutex, so close and reset do not
+ * block on a slow server. The socket is only set under
+ * the mutex, if client is still disconnected and active.
+ * 
+ * @param ctx     Context of session to reconnect.
+ * @param thread  Reconnect thread.
+ * 
+ * @return        @c true , to keep thread running.
+ */
+static int jcon_client_tcp_reconnect_function(void *ctx, jutil_thread_t *thread);
+
+/**
+ * @brief Connects new socket of session outside of mutex
+ *        and sets it, if client is still disconnected.
+ * 
+ * @param ctx     Context of session to connect.
+ * 
+ * @return        @c true , if client is connected afterwards.
+ * @return        @c false , if connect failed or client was closed.
+ */
+static int jcon_client_tcp_connectUnlocked(void *ctx);
+
+/**
+ * @brief Returns context of TCP client.
+ * 
+ * @param session Client session to check.
+ * 
+ * @return        Context of session.
+ * @return        @c NULL , if session is not a TCP client.
+ */
+static void *jcon_client_tcp_getContext(jcon_client_t *session);
+
 /**
  * @brief Logs debug and error messages.
  * 
@@ -148,15 +288,20 @@ static void jcon_client_tcp_log(void *ctx, int log_type, const char *file, const
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_client_tcp_context_t *)ctx)->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG
   #define DEBUG(ctx, fmt, ...)
 #else
-  #define DEBUG(ctx, fmt, ...) jcon_client_tcp_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_client_tcp_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(ctx, fmt, ...) jcon_client_tcp_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(ctx, fmt, ...) jcon_client_tcp_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(ctx, fmt, ...) jcon_client_tcp_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(ctx, fmt, ...) jcon_client_tcp_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_client_tcp_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_client_tcp_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_client_tcp_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_client_tcp_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(ctx, fmt, ...) jcon_client_tcp_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -173,8 +318,29 @@ typedef struct __jcon_client_tcp_context
   jcon_socket_t *connection;             /**< jcon_tcp session object. */
   int poll_timeout;                   /**< Timeout for asking for new data in milliseconds. */
   jlog_t *logger;                     /**< Logger for debug and error messages. */
+
+  int is_clone;                       /**< Cloned sessions can not reconnect. */
+  jutil_thread_t *reconnect_thread;   /**< Background reconnect thread. @c NULL , if disabled. Mutex guards socket and state, not connect attempts. */
+  jutil_time_stopWatch_t *reconnect_timer; /**< Time since last connect attempt. */
+  int reconnect_active;               /**< Cleared by close, set by reset. */
+  long backoff_min;                   /**< Minimum wait between attempts in milliseconds. */
+  long backoff_max;                   /**< Maximum wait between attempts in milliseconds. */
+  long backoff;                       /**< Current wait before next attempt in milliseconds. */
 } jcon_client_tcp_context_t;
 
+/**
+ * @brief Session of cloned connection.
+ * 
+ * Session and context share one allocation,
+ * because servers create them for every connection.
+ * The context is freed with the session.
+ */
+typedef struct __jcon_client_tcp_clone
+{
+  jcon_client_t session;              /**< Session object. */
+  jcon_client_tcp_context_t ctx;      /**< Context of session. */
+} jcon_client_tcp_clone_t;
+
 
 
 //==============================================================================
@@ -185,7 +351,14 @@ typedef struct __jcon_client_tcp_context
 //
 jcon_client_t *jcon_client_tcp_session_init(char *address, uint16_t port, jlog_t *logger)
 {
-  jcon_client_t *session = (jcon_client_t *)malloc(sizeof(jcon_client_t));
+  return jcon_client_tcp_options_init(address, port, NULL, logger);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_tcp_options_init(char *address, uint16_t port, const jcon_socketTCP_options_t *options, jlog_t *logger)
+{
+  jcon_client_t *session = (jcon_client_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_t));
   if(session == NULL)
   {
     ERROR(NULL, "<TCP:%s:%u> malloc() failed.", address, port);
@@ -199,13 +372,19 @@ jcon_client_t *jcon_client_tcp_session_init(char *address, uint16_t port, jlog_t
   session->function_newData = &jcon_client_tcp_newData;
   session->function_recvData = &jcon_client_tcp_recvData;
   session->function_sendData = &jcon_client_tcp_sendData;
+  session->function_sendDataV = &jcon_client_tcp_sendDataV;
+  session->function_trySendDataV = &jcon_client_tcp_trySendDataV;
+  session->function_sendFile = &jcon_client_tcp_sendFile;
+  session->function_getFileDescriptor = &jcon_client_tcp_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_tcp_setPollTimeout;
+  session->function_setCork = &jcon_client_tcp_setCork;
   session->session_free_handler = &jcon_client_tcp_session_free;
   session->connection_type = JCON_CLIENT_TCP_CONNECTIONTYPE;
-  session->session_context = malloc(sizeof(jcon_client_tcp_context_t));
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_client_tcp_context_t));
   if(session->session_context == NULL)
   {
     ERROR(NULL, "<TCP:%s:%u> malloc() failed. Destroying session.", address, port);
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -213,13 +392,42 @@ jcon_client_t *jcon_client_tcp_session_init(char *address, uint16_t port, jlog_t
 
   ctx->poll_timeout = JCON_CLIENT_TCP_POLL_TIMEOUT_DEFAULT;
   ctx->logger = logger;
+  ctx->is_clone = false;
+  ctx->reconnect_thread = NULL;
+  ctx->reconnect_timer = NULL;
+  ctx->reconnect_active = false;
 
-  ctx->connection = jcon_socketTCP_simple_init(address, port, logger);
+  ctx->connection = jcon_socketTCP_options_init(address, port, options, logger);
   if(ctx->connection == NULL)
   {
-    ERROR(NULL, "<TCP:%s:%u> jcon_socketTCP_simple_init() failed. Destroying context and session.", address, port);
-    free(ctx);
-    free(session);
+    ERROR(NULL, "<TCP:%s:%u> jcon_socketTCP_options_init() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_tcp_uring_init(char *address, uint16_t port, jlog_t *logger)
+{
+  jcon_client_t *session = jcon_client_tcp_session_init(address, port, logger);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  jcon_client_tcp_context_t *ctx = (jcon_client_tcp_context_t *)session->session_context;
+
+  jcon_socket_free(ctx->connection);
+  ctx->connection = jcon_socketUring_simple_init(address, port, logger);
+  if(ctx->connection == NULL)
+  {
+    ERROR(NULL, "<TCP:%s:%u> jcon_socketUring_simple_init() failed. Destroying session.", address, port);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -236,13 +444,15 @@ jcon_client_t *jcon_client_tcp_session_tcpClone(jcon_socket_t *tcp_session, jlog
     return NULL;
   }
 
-  jcon_client_t *session = (jcon_client_t *)malloc(sizeof(jcon_client_t));
-  if(session == NULL)
+  jcon_client_tcp_clone_t *clone = (jcon_client_tcp_clone_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_tcp_clone_t));
+  if(clone == NULL)
   {
     ERROR(NULL, "<TCP> malloc() failed.");
     return NULL;
   }
 
+  jcon_client_t *session = &clone->session;
+
   session->function_reset = &jcon_client_tcp_reset;
   session->function_close = &jcon_client_tcp_close;
   session->function_getReferenceString = &jcon_client_tcp_getReferenceString;
@@ -250,25 +460,128 @@ jcon_client_t *jcon_client_tcp_session_tcpClone(jcon_socket_t *tcp_session, jlog
   session->function_newData = &jcon_client_tcp_newData;
   session->function_recvData = &jcon_client_tcp_recvData;
   session->function_sendData = &jcon_client_tcp_sendData;
+  session->function_sendDataV = &jcon_client_tcp_sendDataV;
+  session->function_trySendDataV = &jcon_client_tcp_trySendDataV;
+  session->function_sendFile = &jcon_client_tcp_sendFile;
+  session->function_getFileDescriptor = &jcon_client_tcp_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_tcp_setPollTimeout;
+  session->function_setCork = &jcon_client_tcp_setCork;
   session->session_free_handler = &jcon_client_tcp_session_free;
   session->connection_type = JCON_CLIENT_TCP_CONNECTIONTYPE;
-  session->session_context = malloc(sizeof(jcon_client_tcp_context_t));
-  if(session->session_context == NULL)
-  {
-    ERROR(NULL, "<TCP> malloc() failed. Destroying session.");
-    free(session);
-    return NULL;
-  }
+  session->session_context = &clone->ctx;
 
-  jcon_client_tcp_context_t *ctx = (jcon_client_tcp_context_t *)session->session_context;
+  jcon_client_tcp_context_t *ctx = &clone->ctx;
 
   ctx->poll_timeout = JCON_CLIENT_TCP_POLL_TIMEOUT_DEFAULT;
   ctx->logger = logger;
   ctx->connection = tcp_session;
+  ctx->is_clone = true;
+  ctx->reconnect_thread = NULL;
+  ctx->reconnect_timer = NULL;
+  ctx->reconnect_active = false;
 
   return session;
 }
 
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_setConnectTimeout(jcon_client_t *session, int timeout)
+{
+  jcon_client_tcp_context_t *ctx = (jcon_client_tcp_context_t *)jcon_client_tcp_getContext(session);
+  if(ctx == NULL)
+  {
+    return false;
+  }
+
+  return jcon_socketTCP_setConnectTimeout(ctx->connection, timeout);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_setReconnect(jcon_client_t *session, long backoff_min, long backoff_max)
+{
+  jcon_client_tcp_context_t *ctx = (jcon_client_tcp_context_t *)jcon_client_tcp_getContext(session);
+  if(ctx == NULL)
+  {
+    return false;
+  }
+
+  if(ctx->is_clone)
+  {
+    ERROR(ctx, "Cloned sessions can not reconnect.");
+    return false;
+  }
+
+  if(backoff_min < 0 || backoff_max < backoff_min)
+  {
+    ERROR(ctx, "Invalid backoff [%ld - %ld ms].", backoff_min, backoff_max);
+    return false;
+  }
+
+  /* Reconnect thread connects outside of mutex with socketTCP. */
+  jcon_socketTCP_options_t options;
+  if(backoff_min > 0 && jcon_socketTCP_getOptions(ctx->connection, &options) == false)
+  {
+    ERROR(ctx, "Reconnects need TCP socket.");
+    return false;
+  }
+
+  /* Policy changes restart the thread with new sleep time. */
+  if(ctx->reconnect_thread)
+  {
+    jutil_thread_free(ctx->reconnect_thread);
+    ctx->reconnect_thread = NULL;
+    jutil_time_stopWatch_free(ctx->reconnect_timer);
+    ctx->reconnect_timer = NULL;
+  }
+
+  if(backoff_min == 0)
+  {
+    DEBUG(ctx, "Reconnects disabled.");
+    return true;
+  }
+
+  ctx->backoff_min = backoff_min;
+  ctx->backoff_max = backoff_max;
+  ctx->backoff = 0;
+  ctx->reconnect_active = true;
+
+  ctx->reconnect_timer = jutil_time_stopWatch_init();
+  if(ctx->reconnect_timer == NULL)
+  {
+    ERROR(ctx, "jutil_time_stopWatch_init() failed.");
+    return false;
+  }
+
+  ctx->reconnect_thread = jutil_thread_init
+  (
+    jcon_client_tcp_reconnect_function,
+    ctx->logger,
+    backoff_min / 1000,
+    (backoff_min % 1000) * JCON_CLIENT_TCP_NSECS_PER_MSEC,
+    ctx
+  );
+  if(ctx->reconnect_thread == NULL)
+  {
+    ERROR(ctx, "jutil_thread_init() failed.");
+    jutil_time_stopWatch_free(ctx->reconnect_timer);
+    ctx->reconnect_timer = NULL;
+    return false;
+  }
+
+  if(jutil_thread_start(ctx->reconnect_thread) == false)
+  {
+    ERROR(ctx, "jutil_thread_start() failed.");
+    jutil_thread_free(ctx->reconnect_thread);
+    ctx->reconnect_thread = NULL;
+    jutil_time_stopWatch_free(ctx->reconnect_timer);
+    ctx->reconnect_timer = NULL;
+    return false;
+  }
+
+  return true;
+}
+
 //------------------------------------------------------------------------------
 //
 void jcon_client_tcp_session_free(void *ctx)
@@ -279,11 +592,22 @@ void jcon_client_tcp_session_free(void *ctx)
     return;
   }
 
-  jcon_client_tcp_close(ctx);
   jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
 
+  if(session_context->reconnect_thread)
+  {
+    jutil_thread_free(session_context->reconnect_thread);
+    session_context->reconnect_thread = NULL;
+    jutil_time_stopWatch_free(session_context->reconnect_timer);
+  }
+
+  jcon_client_tcp_close(ctx);
+
   jcon_socket_free(session_context->connection);
-  free(ctx);
+  if(session_context->is_clone == false)
+  {
+    JUTIL_ALLOC_FREE(ctx);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -296,12 +620,36 @@ int jcon_client_tcp_reset(void *ctx)
     return false;
   }
 
-  if(jcon_client_tcp_isConnected(ctx))
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  if(session_context->reconnect_thread)
   {
-    jcon_client_tcp_close(ctx);
+    jutil_thread_lockMutex(session_context->reconnect_thread);
+    session_context->reconnect_active = true;
+    if(jcon_socket_isConnected(session_context->connection))
+    {
+      jcon_socket_close(session_context->connection);
+    }
+    jutil_thread_unlockMutex(session_context->reconnect_thread);
+
+    if(jcon_client_tcp_connectUnlocked(ctx) == false)
+    {
+      /* Failed attempt is retried in background. */
+      jutil_thread_notify(session_context->reconnect_thread);
+      ERROR(ctx, "jcon_socketTCP_openConnection() failed.");
+      return false;
+    }
+
+    jutil_thread_lockMutex(session_context->reconnect_thread);
+    session_context->backoff = 0;
+    jutil_thread_unlockMutex(session_context->reconnect_thread);
+    return true;
   }
 
-  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+  if(jcon_client_tcp_isConnected(ctx))
+  {
+    jcon_socket_close(session_context->connection);
+  }
 
   if(jcon_socket_connect(session_context->connection) == false)
   {
@@ -324,6 +672,18 @@ void jcon_client_tcp_close(void *ctx)
 
   jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
 
+  if(session_context->reconnect_thread)
+  {
+    jutil_thread_lockMutex(session_context->reconnect_thread);
+    session_context->reconnect_active = false;
+    if(jcon_socket_isConnected(session_context->connection))
+    {
+      jcon_socket_close(session_context->connection);
+    }
+    jutil_thread_unlockMutex(session_context->reconnect_thread);
+    return;
+  }
+
   if(jcon_client_tcp_isConnected(ctx) == false)
   {
     DEBUG(ctx, "Client not connected.");
@@ -345,7 +705,16 @@ int jcon_client_tcp_isConnected(void *ctx)
 
   jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
 
-  return jcon_socket_isConnected(session_context->connection);
+  if(session_context->reconnect_thread == NULL)
+  {
+    return jcon_socket_isConnected(session_context->connection);
+  }
+
+  jutil_thread_lockMutex(session_context->reconnect_thread);
+  int ret = jcon_socket_isConnected(session_context->connection);
+  jutil_thread_unlockMutex(session_context->reconnect_thread);
+
+  return ret;
 }
 
 //------------------------------------------------------------------------------
@@ -373,6 +742,11 @@ int jcon_client_tcp_newData(void *ctx)
     return false;
   }
 
+  if(jcon_client_tcp_reconnectPending(ctx))
+  {
+    return false;
+  }
+
   jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
 
   return jcon_socket_pollForInput(session_context->connection, session_context->poll_timeout);
@@ -388,6 +762,11 @@ size_t jcon_client_tcp_recvData(void *ctx, void *data_ptr, size_t data_size)
     return 0;
   }
 
+  if(jcon_client_tcp_reconnectPending(ctx))
+  {
+    return 0;
+  }
+
   jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
 
   return jcon_socket_recvData(session_context->connection, data_ptr, data_size);
@@ -403,15 +782,269 @@ size_t jcon_client_tcp_sendData(void *ctx, void *data_ptr, size_t data_size)
     return 0;
   }
 
+  if(jcon_client_tcp_reconnectPending(ctx))
+  {
+    return 0;
+  }
+
   jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
   
   return jcon_socket_sendData(session_context->connection, data_ptr, data_size);
 }
 
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tcp_sendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  if(jcon_client_tcp_reconnectPending(ctx))
+  {
+    return 0;
+  }
+
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  return jcon_socket_sendDataV(session_context->connection, iov, iov_count);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tcp_trySendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  if(jcon_client_tcp_reconnectPending(ctx))
+  {
+    return 0;
+  }
+
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  return jcon_socket_trySendDataV(session_context->connection, iov, iov_count);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tcp_sendFile(void *ctx, int file_descriptor, off_t offset, size_t size)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  if(jcon_client_tcp_reconnectPending(ctx))
+  {
+    return 0;
+  }
+
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  return jcon_socket_sendFile(session_context->connection, file_descriptor, offset, size);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  return jcon_socket_getFileDescriptor(session_context->connection);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_setPollTimeout(void *ctx, int timeout)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(timeout < -1)
+  {
+    ERROR(ctx, "Invalid poll timeout [%d].", timeout);
+    return false;
+  }
+
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  session_context->poll_timeout = timeout;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_setCork(void *ctx, int enable)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  return jcon_socket_setCork(session_context->connection, enable);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_reconnectPending(void *ctx)
+{
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  if(session_context->reconnect_thread == NULL)
+  {
+    return false;
+  }
+
+  if(jcon_client_tcp_isConnected(ctx))
+  {
+    return false;
+  }
+
+  jutil_thread_notify(session_context->reconnect_thread);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_reconnect_function(void *ctx, jutil_thread_t *thread)
+{
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  jutil_thread_lockMutex(thread);
+
+  if(session_context->reconnect_active == false || jcon_socket_isConnected(session_context->connection))
+  {
+    jutil_thread_unlockMutex(thread);
+    return true;
+  }
+
+  if(jutil_time_stopWatch_check(session_context->reconnect_timer) < (unsigned long)session_context->backoff)
+  {
+    jutil_thread_unlockMutex(thread);
+    return true;
+  }
+
+  jutil_time_stopWatch_reset(session_context->reconnect_timer);
+  jutil_thread_unlockMutex(thread);
+
+  int ret = jcon_client_tcp_connectUnlocked(ctx);
+
+  jutil_thread_lockMutex(thread);
+
+  if(ret)
+  {
+    INFO(ctx, "Reconnected.");
+    session_context->backoff = 0;
+  }
+  else if(session_context->reconnect_active)
+  {
+    session_context->backoff *= 2;
+    if(session_context->backoff < session_context->backoff_min)
+    {
+      session_context->backoff = session_context->backoff_min;
+    }
+    if(session_context->backoff > session_context->backoff_max)
+    {
+      session_context->backoff = session_context->backoff_max;
+    }
+    DEBUG(ctx, "Reconnect failed. Next attempt in [%ld ms].", session_context->backoff);
+  }
+
+  jutil_thread_unlockMutex(thread);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tcp_connectUnlocked(void *ctx)
+{
+  jcon_client_tcp_context_t *session_context = (jcon_client_tcp_context_t *)ctx;
+
+  int fd = jcon_socketTCP_openConnection(session_context->connection);
+  if(fd < 0)
+  {
+    return false;
+  }
+
+  jutil_thread_lockMutex(session_context->reconnect_thread);
+
+  int ret = false;
+  if(session_context->reconnect_active == false)
+  {
+    DEBUG(ctx, "Client closed during connect.");
+  }
+  else if(jcon_socket_isConnected(session_context->connection))
+  {
+    /* Other caller connected first, keep its socket. */
+    ret = true;
+  }
+  else
+  {
+    ret = jcon_socketTCP_setConnection(session_context->connection, fd);
+    if(ret)
+    {
+      fd = -1;
+    }
+  }
+
+  jutil_thread_unlockMutex(session_context->reconnect_thread);
+
+  if(fd >= 0 && close(fd) < 0)
+  {
+    ERROR(ctx, "close() failed [%d : %s].", errno, strerror(errno));
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jcon_client_tcp_getContext(jcon_client_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(session->connection_type == NULL || strcmp(session->connection_type, JCON_CLIENT_TCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(NULL, "Session is not of type TCP.");
+    return NULL;
+  }
+
+  return session->session_context;
+}
+
 //------------------------------------------------------------------------------
 //
 void jcon_client_tcp_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
@@ -0,0 +1,1714 @@
+/**
+ * @file jcon_client_tls.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jcon_client_tls.
+ * 
+ * The TCP socket is switched to non-blocking mode after
+ * connecting, so OpenSSL never blocks while holding the
+ * mutex of the session. Blocking calls wait with @c poll()
+ * outside of the mutex, so one thread can send, while
+ * another one waits for data.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for pread() */
+
+#include <jayc/jcon_client_tls.h>
+#include <jayc/jcon_client_dev.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_alloc.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/x509v3.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_client_tls");
+
+
+
+//==============================================================================
+// Define constants and defaults.
+//
+
+/**
+ * @brief Connection type, to return for @c #jcon_client_getConnectionType() .
+ */
+#define JCON_CLIENT_TLS_CONNECTIONTYPE "TLS"
+
+/**
+ * @brief Default value for polling timeout.
+ * 
+ * When checking, if new data is available, function @c poll()
+ * is used. This value tells the function, how long to
+ * wait for new data in milliseconds.
+ */
+#define JCON_CLIENT_TLS_POLL_TIMEOUT_DEFAULT 10
+
+/**
+ * @brief Default time for handshakes in milliseconds.
+ */
+#define JCON_CLIENT_TLS_HANDSHAKE_TIMEOUT_DEFAULT 10000
+
+/**
+ * @brief Size of buffer for file data, if kTLS is not available.
+ * 
+ * Matches the maximum size of a TLS record.
+ */
+#define JCON_CLIENT_TLS_FILE_BUFFER_SIZE 16384
+
+/**
+ * @brief Size of buffer for OpenSSL error strings.
+ */
+#define JCON_CLIENT_TLS_ERROR_SIZE 256
+
+
+
+//==============================================================================
+// Declare handlers and internal functions.
+//
+
+/**
+ * @brief Function for context free handler.
+ * 
+ * Will close connection, if connected and free context data.
+ * 
+ * @param ctx Context to free.
+ */
+static void jcon_client_tls_session_free(void *ctx);
+
+/**
+ * @brief Connects socket and does handshake.
+ * 
+ * Offers session of last connection for resumption.
+ * Not usable, if initialized via @c #jcon_client_tls_session_tlsClone() .
+ * 
+ * @param ctx Context of session to reset.
+ * 
+ * @return    @c true , if reset was successful.
+ * @return    @c false , if reset failed.
+ */
+static int jcon_client_tls_reset(void *ctx);
+
+/**
+ * @brief Sends close notify and closes connection.
+ * 
+ * @param ctx Context of session to close.
+ */
+static void jcon_client_tls_close(void *ctx);
+
+/**
+ * @brief Checks, wether client is connected.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c true , if client is connected.
+ * @return    @c false , if client is not connected or error occured.
+ */
+static int jcon_client_tls_isConnected(void *ctx);
+
+/**
+ * @brief Returns reference string of socket.
+ * 
+ * @param ctx Context of session to ask from.
+ * 
+ * @return    Session string.
+ * @return    @c NULL , if error occured.
+ */
+static const char *jcon_client_tls_getReferenceString(void *ctx);
+
+/**
+ * @brief Checks, if new data is available to read.
+ * 
+ * Data buffered by OpenSSL is available immediately.
+ * Records, that only carry handshake messages
+ * (like session tickets), are not reported as data.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c true , if new data is available.
+ * @return    @c false , if no new data or error occured.
+ */
+static int jcon_client_tls_newData(void *ctx);
+
+/**
+ * @brief Recieves and decrypts data.
+ * 
+ * @param ctx       Context of session to read from.
+ * @param data_ptr  Pointer, in which data is stored.
+ * @param data_size Size (in bytes) of data to read.
+ * 
+ * @return          Size of data recieved.
+ * @return          @c 0 , if no data recieved, or error occured.
+ */
+static size_t jcon_client_tls_recvData(void *ctx, void *data_ptr, size_t data_size);
+
+/**
+ * @brief Encrypts and sends data.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param data_ptr  Pointer to data to be sent.
+ * @param data_size Size of data_ptr in bytes.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_tls_sendData(void *ctx, void *data_ptr, size_t data_size);
+
+/**
+ * @brief Encrypts and sends data from multiple buffers.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_tls_sendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Encrypts and sends data from multiple buffers without blocking.
+ * 
+ * If send buffer gets full, the next call has to start
+ * with the data, that was not sent, as OpenSSL requires.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if send buffer is full or error occured.
+ */
+static size_t jcon_client_tls_trySendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends data of file descriptor.
+ * 
+ * Uses @c SSL_sendfile() for regular files, if kTLS
+ * is active. Otherwise data is read and encrypted
+ * in user space.
+ * 
+ * @param ctx             Context of session to send through.
+ * @param file_descriptor Descriptor to read data from.
+ * @param offset          Position in file to start reading.
+ * @param size            Number of bytes to send.
+ * 
+ * @return                Size of data sended.
+ * @return                @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_tls_sendFile(void *ctx, int file_descriptor, off_t offset, size_t size);
+
+/**
+ * @brief Returns file descriptor of socket.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    File descriptor of socket.
+ * @return    @c -1 , if not connected or error occured.
+ */
+static int jcon_client_tls_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Sets timeout for @c #jcon_client_tls_newData() .
+ * 
+ * @param ctx     Context of session to configure.
+ * @param timeout Timeout in milliseconds. @c -1 waits until data arrives.
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_tls_setPollTimeout(void *ctx, int timeout);
+
+/**
+ * @brief Corks or flushes socket.
+ * 
+ * @param ctx     Context of session to configure.
+ * @param enable  @c true to cork, @c false to flush.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_tls_setCork(void *ctx, int enable);
+
+/**
+ * @brief Creates OpenSSL context for client.
+ * 
+ * @param options Options to configure context.
+ * @param address Address for log messages.
+ * @param port    Port for log messages.
+ * 
+ * @return        New OpenSSL context.
+ * @return        @c NULL , if error occured.
+ */
+static SSL_CTX *jcon_client_tls_createContext(const jcon_client_tls_options_t *options, const char *address, uint16_t port);
+
+/**
+ * @brief Keeps new sessions for resumption.
+ * 
+ * Called by OpenSSL during handshakes and, with TLS 1.3,
+ * when tickets arrive after the handshake.
+ * 
+ * @param ssl         Connection, that recieved the session.
+ * @param ssl_session New session.
+ * 
+ * @return            @c 1 , if session is kept.
+ * @return            @c 0 , if OpenSSL should free session.
+ */
+static int jcon_client_tls_newSession_callback(SSL *ssl, SSL_SESSION *ssl_session);
+
+/**
+ * @brief Creates connection object and does handshake.
+ * 
+ * Socket has to be connected.
+ * 
+ * @param ctx       Context of session.
+ * @param is_server @c true , if handshake is done as server.
+ * 
+ * @return          @c true , if handshake was successful.
+ * @return          @c false , if error occured.
+ */
+static int jcon_client_tls_start(void *ctx, int is_server);
+
+/**
+ * @brief Runs handshake until done or timed out.
+ * 
+ * @param ctx Context of session.
+ * 
+ * @return    @c true , if handshake was successful.
+ * @return    @c false , if timed out or error occured.
+ */
+static int jcon_client_tls_handshake(void *ctx);
+
+/**
+ * @brief Frees connection object.
+ * 
+ * Socket stays open.
+ * 
+ * @param ctx         Context of session.
+ * @param send_notify @c true , to send close notify to peer.
+ *                    Must be @c false after fatal errors.
+ */
+static void jcon_client_tls_stop(void *ctx, int send_notify);
+
+/**
+ * @brief Closes connection after fatal error or
+ *        close of peer.
+ * 
+ * @param ctx         Context of session.
+ * @param send_notify @c true , to send close notify to peer.
+ */
+static void jcon_client_tls_abort(void *ctx, int send_notify);
+
+/**
+ * @brief Waits, until socket is ready for OpenSSL to continue.
+ * 
+ * @param ctx       Context of session.
+ * @param ssl_error @c SSL_ERROR_WANT_READ or @c SSL_ERROR_WANT_WRITE .
+ * @param timeout   Time to wait in milliseconds. @c -1 waits forever.
+ * 
+ * @return          @c true , if socket is ready.
+ * @return          @c false , if timed out or error occured.
+ */
+static int jcon_client_tls_wait(void *ctx, int ssl_error, int timeout);
+
+/**
+ * @brief Encrypts and sends buffers.
+ * 
+ * @param ctx       Context of session.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * @param blocking  @c false , to return when send buffer is full.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_tls_send(void *ctx, const struct iovec *iov, int iov_count, int blocking);
+
+/**
+ * @brief Blocks @c SIGPIPE for this thread.
+ * 
+ * OpenSSL writes to the socket without @c MSG_NOSIGNAL .
+ * 
+ * @param old_set Stores signal mask to restore.
+ * 
+ * @return        @c true , if @c SIGPIPE was pending before.
+ */
+static int jcon_client_tls_blockSigpipe(sigset_t *old_set);
+
+/**
+ * @brief Consumes @c SIGPIPE raised while blocked
+ *        and restores signal mask.
+ * 
+ * @param old_set       Signal mask to restore.
+ * @param pipe_pending  Return value of @c #jcon_client_tls_blockSigpipe() .
+ */
+static void jcon_client_tls_restoreSigpipe(const sigset_t *old_set, int pipe_pending);
+
+/**
+ * @brief Takes error from OpenSSL error queue and
+ *        formats it. Also clears the queue.
+ * 
+ * Uses @c errno , if queue is empty.
+ * 
+ * @param buf   Buffer for error string.
+ * @param size  Size of @c buf .
+ * 
+ * @return      @c buf .
+ */
+static const char *jcon_client_tls_errorString(char *buf, size_t size);
+
+/**
+ * @brief Returns context of TLS client.
+ * 
+ * @param session Client session to check.
+ * 
+ * @return        Context of session.
+ * @return        @c NULL , if session is not a TLS client.
+ */
+static void *jcon_client_tls_getContext(jcon_client_t *session);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * Uses logger from @c ctx , or if logger is @c NULL , uses global logger.
+ * 
+ * @param ctx       Session for info about connection.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_client_tls_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_client_tls_context_t *)ctx)->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG
+  #define DEBUG(ctx, fmt, ...)
+#else
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_client_tls_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_client_tls_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_client_tls_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_client_tls_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_client_tls_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(ctx, fmt, ...) jcon_client_tls_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Define context structure.
+//
+
+/**
+ * @brief Data for jcon_client_tls object.
+ */
+typedef struct __jcon_client_tls_context
+{
+  jcon_socket_t *connection;          /**< TCP socket, that carries the records. */
+  SSL_CTX *ssl_ctx;                   /**< OpenSSL context. Shared with server for cloned sessions. */
+  SSL *ssl;                           /**< Connection object. @c NULL , if not connected. */
+  SSL_SESSION *resume_session;        /**< Session to offer at next reset. @c NULL , if none recieved yet. */
+  pthread_mutex_t ssl_mutex;          /**< Guards @c ssl and @c resume_session . OpenSSL calls are not thread safe per connection. */
+  int poll_timeout;                   /**< Timeout for asking for new data in milliseconds. */
+  int handshake_timeout;              /**< Time for handshakes in milliseconds. */
+  int ktls_send;                      /**< If @c true , records are sent by the kernel. */
+  jlog_t *logger;                     /**< Logger for debug and error messages. */
+
+  int is_clone;                       /**< Cloned sessions can not reconnect. */
+  char *server_name;                  /**< Name to check certificate against. @c NULL for cloned sessions. */
+  int server_name_ip;                 /**< If @c true , @c server_name is an IP address, that is not sent as SNI. */
+} jcon_client_tls_context_t;
+
+/**
+ * @brief Session of cloned connection.
+ * 
+ * Session and context share one allocation,
+ * because servers create them for every connection.
+ * The context is freed with the session.
+ */
+typedef struct __jcon_client_tls_clone
+{
+  jcon_client_t session;              /**< Session object. */
+  jcon_client_tls_context_t ctx;      /**< Context of session. */
+} jcon_client_tls_clone_t;
+
+
+
+//==============================================================================
+// Implement handlers and internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_tls_session_init(char *address, uint16_t port, jlog_t *logger)
+{
+  return jcon_client_tls_options_init(address, port, NULL, logger);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_tls_options_init(char *address, uint16_t port, const jcon_client_tls_options_t *options, jlog_t *logger)
+{
+  jcon_client_tls_options_t session_options;
+  memset(&session_options, 0, sizeof(jcon_client_tls_options_t));
+  if(options)
+  {
+    session_options = *options;
+  }
+
+  jcon_client_t *session = (jcon_client_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> malloc() failed.", address, port);
+    return NULL;
+  }
+
+  session->function_reset = &jcon_client_tls_reset;
+  session->function_close = &jcon_client_tls_close;
+  session->function_getReferenceString = &jcon_client_tls_getReferenceString;
+  session->function_isConnected = &jcon_client_tls_isConnected;
+  session->function_newData = &jcon_client_tls_newData;
+  session->function_recvData = &jcon_client_tls_recvData;
+  session->function_sendData = &jcon_client_tls_sendData;
+  session->function_sendDataV = &jcon_client_tls_sendDataV;
+  session->function_trySendDataV = &jcon_client_tls_trySendDataV;
+  session->function_sendFile = &jcon_client_tls_sendFile;
+  session->function_getFileDescriptor = &jcon_client_tls_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_tls_setPollTimeout;
+  session->function_setCork = &jcon_client_tls_setCork;
+  session->session_free_handler = &jcon_client_tls_session_free;
+  session->connection_type = JCON_CLIENT_TLS_CONNECTIONTYPE;
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_client_tls_context_t));
+  if(session->session_context == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> malloc() failed. Destroying session.", address, port);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  jcon_client_tls_context_t *ctx = (jcon_client_tls_context_t *)session->session_context;
+
+  ctx->ssl = NULL;
+  ctx->resume_session = NULL;
+  ctx->poll_timeout = JCON_CLIENT_TLS_POLL_TIMEOUT_DEFAULT;
+  ctx->handshake_timeout = (session_options.handshake_timeout == 0 ? JCON_CLIENT_TLS_HANDSHAKE_TIMEOUT_DEFAULT : session_options.handshake_timeout);
+  ctx->ktls_send = false;
+  ctx->logger = logger;
+  ctx->is_clone = false;
+
+  const char *server_name = (session_options.server_name ? session_options.server_name : address);
+  ctx->server_name = (char *)JUTIL_ALLOC_MALLOC(strlen(server_name) + 1);
+  if(ctx->server_name == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> malloc() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+  memcpy(ctx->server_name, server_name, strlen(server_name) + 1);
+
+  struct in6_addr ip_addr;
+  ctx->server_name_ip = (inet_pton(AF_INET, server_name, &ip_addr) == 1 || inet_pton(AF_INET6, server_name, &ip_addr) == 1);
+
+  ctx->ssl_ctx = jcon_client_tls_createContext(&session_options, address, port);
+  if(ctx->ssl_ctx == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> jcon_client_tls_createContext() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx->server_name);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  ctx->connection = jcon_socketTCP_options_init(address, port, &session_options.tcp, logger);
+  if(ctx->connection == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> jcon_socketTCP_options_init() failed. Destroying context and session.", address, port);
+    SSL_CTX_free(ctx->ssl_ctx);
+    JUTIL_ALLOC_FREE(ctx->server_name);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  pthread_mutex_init(&ctx->ssl_mutex, NULL);
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_client_tls_session_tlsClone(jcon_socket_t *tcp_session, struct ssl_ctx_st *ssl_ctx, int handshake_timeout, jlog_t *logger)
+{
+  if(tcp_session == NULL)
+  {
+    ERROR(NULL, "<TLS> tcp_session is NULL.");
+    return NULL;
+  }
+
+  if(ssl_ctx == NULL)
+  {
+    ERROR(NULL, "<TLS> ssl_ctx is NULL.");
+    return NULL;
+  }
+
+  jcon_client_tls_clone_t *clone = (jcon_client_tls_clone_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_tls_clone_t));
+  if(clone == NULL)
+  {
+    ERROR(NULL, "<TLS> malloc() failed.");
+    return NULL;
+  }
+
+  jcon_client_t *session = &clone->session;
+
+  session->function_reset = &jcon_client_tls_reset;
+  session->function_close = &jcon_client_tls_close;
+  session->function_getReferenceString = &jcon_client_tls_getReferenceString;
+  session->function_isConnected = &jcon_client_tls_isConnected;
+  session->function_newData = &jcon_client_tls_newData;
+  session->function_recvData = &jcon_client_tls_recvData;
+  session->function_sendData = &jcon_client_tls_sendData;
+  session->function_sendDataV = &jcon_client_tls_sendDataV;
+  session->function_trySendDataV = &jcon_client_tls_trySendDataV;
+  session->function_sendFile = &jcon_client_tls_sendFile;
+  session->function_getFileDescriptor = &jcon_client_tls_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_tls_setPollTimeout;
+  session->function_setCork = &jcon_client_tls_setCork;
+  session->session_free_handler = &jcon_client_tls_session_free;
+  session->connection_type = JCON_CLIENT_TLS_CONNECTIONTYPE;
+  session->session_context = &clone->ctx;
+
+  jcon_client_tls_context_t *ctx = &clone->ctx;
+
+  ctx->connection = tcp_session;
+  ctx->ssl_ctx = ssl_ctx;
+  ctx->ssl = NULL;
+  ctx->resume_session = NULL;
+  ctx->poll_timeout = JCON_CLIENT_TLS_POLL_TIMEOUT_DEFAULT;
+  ctx->handshake_timeout = handshake_timeout;
+  ctx->ktls_send = false;
+  ctx->logger = logger;
+  ctx->is_clone = true;
+  ctx->server_name = NULL;
+  ctx->server_name_ip = false;
+
+  pthread_mutex_init(&ctx->ssl_mutex, NULL);
+
+  if(jcon_client_tls_start(ctx, true) == false)
+  {
+    DEBUG(ctx, "jcon_client_tls_start() failed. Destroying session.");
+    pthread_mutex_destroy(&ctx->ssl_mutex);
+    JUTIL_ALLOC_FREE(clone);
+    return NULL;
+  }
+
+  /* Server context is shared by all connections. */
+  SSL_CTX_up_ref(ssl_ctx);
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_isResumed(jcon_client_t *session)
+{
+  jcon_client_tls_context_t *ctx = (jcon_client_tls_context_t *)jcon_client_tls_getContext(session);
+  if(ctx == NULL)
+  {
+    return false;
+  }
+
+  pthread_mutex_lock(&ctx->ssl_mutex);
+  int ret = (ctx->ssl ? SSL_session_reused(ctx->ssl) == 1 : false);
+  pthread_mutex_unlock(&ctx->ssl_mutex);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_isKernelOffloaded(jcon_client_t *session)
+{
+  jcon_client_tls_context_t *ctx = (jcon_client_tls_context_t *)jcon_client_tls_getContext(session);
+  if(ctx == NULL)
+  {
+    return false;
+  }
+
+  pthread_mutex_lock(&ctx->ssl_mutex);
+  int ret = (ctx->ssl ? ctx->ktls_send : false);
+  pthread_mutex_unlock(&ctx->ssl_mutex);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_tls_session_free(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  /* Socket can be closed by poll at hangup, before connection object is freed. */
+  if(jcon_client_tls_isConnected(ctx))
+  {
+    jcon_client_tls_close(ctx);
+  }
+  else
+  {
+    jcon_client_tls_stop(ctx, false);
+  }
+
+  jcon_socket_free(session_context->connection);
+
+  if(session_context->resume_session)
+  {
+    SSL_SESSION_free(session_context->resume_session);
+  }
+  SSL_CTX_free(session_context->ssl_ctx);
+  pthread_mutex_destroy(&session_context->ssl_mutex);
+
+  if(session_context->is_clone == false)
+  {
+    JUTIL_ALLOC_FREE(session_context->server_name);
+    JUTIL_ALLOC_FREE(ctx);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_reset(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  if(session_context->is_clone)
+  {
+    ERROR(ctx, "Cloned sessions can not reconnect.");
+    return false;
+  }
+
+  if(jcon_client_tls_isConnected(ctx))
+  {
+    jcon_client_tls_close(ctx);
+  }
+  else
+  {
+    jcon_client_tls_abort(ctx, false);
+  }
+
+  if(jcon_socket_connect(session_context->connection) == false)
+  {
+    ERROR(ctx, "jcon_socket_connect() failed.");
+    return false;
+  }
+
+  if(jcon_client_tls_start(ctx, false) == false)
+  {
+    ERROR(ctx, "jcon_client_tls_start() failed.");
+    jcon_socket_close(session_context->connection);
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_tls_close(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return;
+  }
+
+  if(jcon_client_tls_isConnected(ctx) == false)
+  {
+    DEBUG(ctx, "Client not connected.");
+    return;
+  }
+
+  jcon_client_tls_abort(ctx, true);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_isConnected(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  return (session_context->ssl != NULL && jcon_socket_isConnected(session_context->connection));
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_client_tls_getReferenceString(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return NULL;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  return jcon_socket_getReferenceString(session_context->connection);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_newData(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  if(jcon_client_tls_isConnected(ctx) == false)
+  {
+    return false;
+  }
+
+  pthread_mutex_lock(&session_context->ssl_mutex);
+  int pending = (session_context->ssl ? SSL_pending(session_context->ssl) : 0);
+  pthread_mutex_unlock(&session_context->ssl_mutex);
+
+  if(pending > 0)
+  {
+    return true;
+  }
+
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, session_context->poll_timeout);
+
+  while(true)
+  {
+    int timeout = jutil_time_deadline_getRemaining(&deadline);
+    if(jcon_socket_pollForInput(session_context->connection, timeout) == false)
+    {
+      return false;
+    }
+
+    /* Processes handshake records without consuming data. */
+    char peek;
+    sigset_t old_set;
+    int pipe_pending = jcon_client_tls_blockSigpipe(&old_set);
+
+    pthread_mutex_lock(&session_context->ssl_mutex);
+    if(session_context->ssl == NULL)
+    {
+      pthread_mutex_unlock(&session_context->ssl_mutex);
+      jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+      return false;
+    }
+    ERR_clear_error();
+    int ret_peek = SSL_peek(session_context->ssl, &peek, 1);
+    int ssl_error = SSL_get_error(session_context->ssl, ret_peek);
+    pthread_mutex_unlock(&session_context->ssl_mutex);
+
+    jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+
+    if(ret_peek > 0)
+    {
+      return true;
+    }
+
+    if(ssl_error != SSL_ERROR_WANT_READ && ssl_error != SSL_ERROR_WANT_WRITE)
+    {
+      /* Close or error is reported, so recvData can handle it. */
+      return true;
+    }
+
+    /* Only handshake records (like tickets) arrived. Waits for rest of timeout. */
+    if(timeout == 0)
+    {
+      return false;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tls_recvData(void *ctx, void *data_ptr, size_t data_size)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  if(jcon_client_tls_isConnected(ctx) == false)
+  {
+    ERROR(ctx, "Client not connected.");
+    return 0;
+  }
+
+  if(data_size == 0)
+  {
+    ERROR(ctx, "data_size given is [0].");
+    return 0;
+  }
+
+  if(data_size > INT_MAX)
+  {
+    data_size = INT_MAX;
+  }
+
+  char err_buf[JCON_CLIENT_TLS_ERROR_SIZE];
+  sigset_t old_set;
+  int pipe_pending = jcon_client_tls_blockSigpipe(&old_set);
+  size_t ret = 0;
+
+  while(true)
+  {
+    pthread_mutex_lock(&session_context->ssl_mutex);
+    if(session_context->ssl == NULL)
+    {
+      pthread_mutex_unlock(&session_context->ssl_mutex);
+      break;
+    }
+    ERR_clear_error();
+    int ret_read = SSL_read(session_context->ssl, data_ptr, (int)data_size);
+    int ssl_error = SSL_get_error(session_context->ssl, ret_read);
+    pthread_mutex_unlock(&session_context->ssl_mutex);
+
+    if(ret_read > 0)
+    {
+      ret = (size_t)ret_read;
+      break;
+    }
+
+    if(ssl_error == SSL_ERROR_WANT_READ || ssl_error == SSL_ERROR_WANT_WRITE)
+    {
+      if(jcon_client_tls_wait(ctx, ssl_error, -1))
+      {
+        continue;
+      }
+      break;
+    }
+
+    if(ssl_error == SSL_ERROR_ZERO_RETURN)
+    {
+      DEBUG(ctx, "Peer closed connection.");
+      jcon_client_tls_abort(ctx, true);
+    }
+    else if((ssl_error == SSL_ERROR_SYSCALL && ERR_peek_error() == 0 && (errno == 0 || errno == ECONNRESET))
+    || (ssl_error == SSL_ERROR_SSL && ERR_GET_REASON(ERR_peek_error()) == SSL_R_UNEXPECTED_EOF_WHILE_READING))
+    {
+      DEBUG(ctx, "Connection closed without close notify.");
+      jcon_client_tls_abort(ctx, false);
+    }
+    else
+    {
+      ERROR(ctx, "SSL_read() failed [%s]. Closing connection.", jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      jcon_client_tls_abort(ctx, false);
+    }
+    break;
+  }
+
+  jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tls_sendData(void *ctx, void *data_ptr, size_t data_size)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  struct iovec iov = { data_ptr, data_size };
+
+  return jcon_client_tls_send(ctx, &iov, 1, true);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tls_sendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  return jcon_client_tls_send(ctx, iov, iov_count, true);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tls_trySendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  return jcon_client_tls_send(ctx, iov, iov_count, false);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tls_sendFile(void *ctx, int file_descriptor, off_t offset, size_t size)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  if(jcon_client_tls_isConnected(ctx) == false)
+  {
+    ERROR(ctx, "Client not connected.");
+    return 0;
+  }
+
+  if(file_descriptor < 0)
+  {
+    ERROR(ctx, "Invalid file descriptor [%d].", file_descriptor);
+    return 0;
+  }
+
+  if(size == 0)
+  {
+    ERROR(ctx, "size given is [0].");
+    return 0;
+  }
+
+  /* Kernel can only send regular files by itself. */
+  struct stat file_stat;
+  int use_kernel = (session_context->ktls_send && fstat(file_descriptor, &file_stat) == 0 && S_ISREG(file_stat.st_mode));
+
+  size_t sent = 0;
+
+  if(use_kernel)
+  {
+    char err_buf[JCON_CLIENT_TLS_ERROR_SIZE];
+    sigset_t old_set;
+    int pipe_pending = jcon_client_tls_blockSigpipe(&old_set);
+
+    while(sent < size)
+    {
+      pthread_mutex_lock(&session_context->ssl_mutex);
+      if(session_context->ssl == NULL)
+      {
+        pthread_mutex_unlock(&session_context->ssl_mutex);
+        break;
+      }
+      ERR_clear_error();
+      ossl_ssize_t ret_send = SSL_sendfile(session_context->ssl, file_descriptor, offset + sent, size - sent, 0);
+      int ssl_error = SSL_get_error(session_context->ssl, (ret_send > 0 ? 1 : -1));
+      pthread_mutex_unlock(&session_context->ssl_mutex);
+
+      if(ret_send > 0)
+      {
+        sent += ret_send;
+        continue;
+      }
+
+      if(ssl_error == SSL_ERROR_WANT_WRITE || ssl_error == SSL_ERROR_WANT_READ)
+      {
+        if(jcon_client_tls_wait(ctx, ssl_error, -1))
+        {
+          continue;
+        }
+        break;
+      }
+
+      if(ret_send == 0 || (ssl_error == SSL_ERROR_SYSCALL && ERR_peek_error() == 0 && errno == 0))
+      {
+        /* End of file. */
+        break;
+      }
+
+      if(ssl_error == SSL_ERROR_SYSCALL && (errno == EPIPE || errno == ECONNRESET))
+      {
+        DEBUG(ctx, "Peer closed connection.");
+      }
+      else
+      {
+        ERROR(ctx, "SSL_sendfile() failed [%s]. Closing connection.", jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      }
+      jcon_client_tls_abort(ctx, false);
+      break;
+    }
+
+    jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+
+    return sent;
+  }
+
+  char buf[JCON_CLIENT_TLS_FILE_BUFFER_SIZE];
+  int use_read = false;
+
+  while(sent < size)
+  {
+    size_t chunk = size - sent;
+    if(chunk > sizeof(buf))
+    {
+      chunk = sizeof(buf);
+    }
+
+    ssize_t ret_read;
+    if(use_read == false)
+    {
+      ret_read = pread(file_descriptor, buf, chunk, offset + sent);
+      if(ret_read < 0 && errno == ESPIPE && sent == 0)
+      {
+        /* Descriptor can not seek, for example a pipe. */
+        use_read = true;
+        continue;
+      }
+    }
+    else
+    {
+      ret_read = read(file_descriptor, buf, chunk);
+    }
+
+    if(ret_read < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+
+      ERROR(ctx, "%s() failed [%d : %s].", use_read ? "read" : "pread", errno, strerror(errno));
+      break;
+    }
+
+    if(ret_read == 0)
+    {
+      /* End of file. */
+      break;
+    }
+
+    struct iovec iov = { buf, (size_t)ret_read };
+    size_t ret_send = jcon_client_tls_send(ctx, &iov, 1, true);
+    sent += ret_send;
+
+    if(ret_send < (size_t)ret_read)
+    {
+      break;
+    }
+  }
+
+  return sent;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  return jcon_socket_getFileDescriptor(session_context->connection);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_setPollTimeout(void *ctx, int timeout)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(timeout < -1)
+  {
+    ERROR(ctx, "Invalid poll timeout [%d].", timeout);
+    return false;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  session_context->poll_timeout = timeout;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_setCork(void *ctx, int enable)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  return jcon_socket_setCork(session_context->connection, enable);
+}
+
+//------------------------------------------------------------------------------
+//
+SSL_CTX *jcon_client_tls_createContext(const jcon_client_tls_options_t *options, const char *address, uint16_t port)
+{
+  char err_buf[JCON_CLIENT_TLS_ERROR_SIZE];
+
+  ERR_clear_error();
+  SSL_CTX *ssl_ctx = SSL_CTX_new(TLS_client_method());
+  if(ssl_ctx == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> SSL_CTX_new() failed [%s].", address, port, jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+    return NULL;
+  }
+
+  SSL_CTX_set_min_proto_version(ssl_ctx, TLS1_2_VERSION);
+  SSL_CTX_set_mode(ssl_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
+  if(options->disable_ktls == false)
+  {
+    SSL_CTX_set_options(ssl_ctx, SSL_OP_ENABLE_KTLS);
+  }
+
+  if(options->skip_verify)
+  {
+    SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_NONE, NULL);
+  }
+  else
+  {
+    SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_PEER, NULL);
+
+    int ret_load;
+    if(options->ca_file)
+    {
+      ret_load = SSL_CTX_load_verify_locations(ssl_ctx, options->ca_file, NULL);
+    }
+    else
+    {
+      ret_load = SSL_CTX_set_default_verify_paths(ssl_ctx);
+    }
+
+    if(ret_load != 1)
+    {
+      ERROR(NULL, "<TLS:%s:%u> Loading CA certificates failed [%s].", address, port, jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      SSL_CTX_free(ssl_ctx);
+      return NULL;
+    }
+  }
+
+  if(options->cert_file)
+  {
+    const char *key_file = (options->key_file ? options->key_file : options->cert_file);
+
+    if(SSL_CTX_use_certificate_chain_file(ssl_ctx, options->cert_file) != 1
+    || SSL_CTX_use_PrivateKey_file(ssl_ctx, key_file, SSL_FILETYPE_PEM) != 1
+    || SSL_CTX_check_private_key(ssl_ctx) != 1)
+    {
+      ERROR(NULL, "<TLS:%s:%u> Loading certificate [%s] failed [%s].", address, port, options->cert_file, jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      SSL_CTX_free(ssl_ctx);
+      return NULL;
+    }
+  }
+
+  /* Sessions are kept by callback instead of internal cache,
+     so TLS 1.3 tickets, that arrive after the handshake, are used too. */
+  SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(ssl_ctx, &jcon_client_tls_newSession_callback);
+
+  return ssl_ctx;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_newSession_callback(SSL *ssl, SSL_SESSION *ssl_session)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)SSL_get_app_data(ssl);
+  if(session_context == NULL)
+  {
+    return 0;
+  }
+
+  /* Called from OpenSSL functions, so mutex is already held. */
+  if(session_context->resume_session)
+  {
+    SSL_SESSION_free(session_context->resume_session);
+  }
+  session_context->resume_session = ssl_session;
+
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_start(void *ctx, int is_server)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+  char err_buf[JCON_CLIENT_TLS_ERROR_SIZE];
+
+  int fd = jcon_socket_getFileDescriptor(session_context->connection);
+  int flags = fcntl(fd, F_GETFL, 0);
+  if(flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+  {
+    ERROR(ctx, "fcntl() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  pthread_mutex_lock(&session_context->ssl_mutex);
+
+  ERR_clear_error();
+  SSL *ssl = SSL_new(session_context->ssl_ctx);
+  if(ssl == NULL)
+  {
+    ERROR(ctx, "SSL_new() failed [%s].", jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+    pthread_mutex_unlock(&session_context->ssl_mutex);
+    return false;
+  }
+
+  if(SSL_set_fd(ssl, fd) != 1)
+  {
+    ERROR(ctx, "SSL_set_fd() failed [%s].", jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+    SSL_free(ssl);
+    pthread_mutex_unlock(&session_context->ssl_mutex);
+    return false;
+  }
+  SSL_set_app_data(ssl, session_context);
+
+  if(is_server)
+  {
+    SSL_set_accept_state(ssl);
+  }
+  else
+  {
+    SSL_set_connect_state(ssl);
+
+    int ret_name = 1;
+    if(session_context->server_name_ip == false)
+    {
+      ret_name = SSL_set_tlsext_host_name(ssl, session_context->server_name);
+    }
+
+    if(ret_name == 1 && SSL_get_verify_mode(ssl) != SSL_VERIFY_NONE)
+    {
+      if(session_context->server_name_ip)
+      {
+        ret_name = X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl), session_context->server_name);
+      }
+      else
+      {
+        ret_name = SSL_set1_host(ssl, session_context->server_name);
+      }
+    }
+
+    if(ret_name != 1)
+    {
+      ERROR(ctx, "Setting server name [%s] failed [%s].", session_context->server_name, jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      SSL_free(ssl);
+      pthread_mutex_unlock(&session_context->ssl_mutex);
+      return false;
+    }
+
+    if(session_context->resume_session && SSL_SESSION_is_resumable(session_context->resume_session))
+    {
+      SSL_set_session(ssl, session_context->resume_session);
+    }
+  }
+
+  session_context->ssl = ssl;
+
+  sigset_t old_set;
+  int pipe_pending = jcon_client_tls_blockSigpipe(&old_set);
+  int ret_handshake = jcon_client_tls_handshake(ctx);
+  jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+
+  if(ret_handshake == false)
+  {
+    SSL_free(ssl);
+    session_context->ssl = NULL;
+    pthread_mutex_unlock(&session_context->ssl_mutex);
+    return false;
+  }
+
+  session_context->ktls_send = (BIO_get_ktls_send(SSL_get_wbio(ssl)) ? true : false);
+
+  DEBUG
+  (
+    ctx,
+    "Handshake done [%s : %s, resumed: %s, kTLS: %s].",
+    SSL_get_version(ssl),
+    SSL_get_cipher_name(ssl),
+    SSL_session_reused(ssl) ? "yes" : "no",
+    session_context->ktls_send ? "yes" : "no"
+  );
+
+  pthread_mutex_unlock(&session_context->ssl_mutex);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_handshake(void *ctx)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+  char err_buf[JCON_CLIENT_TLS_ERROR_SIZE];
+
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, session_context->handshake_timeout);
+
+  while(true)
+  {
+    ERR_clear_error();
+    int ret_handshake = SSL_do_handshake(session_context->ssl);
+    if(ret_handshake == 1)
+    {
+      return true;
+    }
+
+    int ssl_error = SSL_get_error(session_context->ssl, ret_handshake);
+    if(ssl_error != SSL_ERROR_WANT_READ && ssl_error != SSL_ERROR_WANT_WRITE)
+    {
+      ERROR(ctx, "SSL_do_handshake() failed [%s].", jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      return false;
+    }
+
+    int timeout = jutil_time_deadline_getRemaining(&deadline);
+    if(timeout == 0 || jcon_client_tls_wait(ctx, ssl_error, timeout) == false)
+    {
+      ERROR(ctx, "Handshake timed out [%d ms].", session_context->handshake_timeout);
+      return false;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_tls_stop(void *ctx, int send_notify)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  pthread_mutex_lock(&session_context->ssl_mutex);
+
+  if(session_context->ssl == NULL)
+  {
+    pthread_mutex_unlock(&session_context->ssl_mutex);
+    return;
+  }
+
+  if(send_notify)
+  {
+    sigset_t old_set;
+    int pipe_pending = jcon_client_tls_blockSigpipe(&old_set);
+
+    ERR_clear_error();
+    if(session_context->is_clone == false && session_context->resume_session == NULL)
+    {
+      /* TLS 1.3 tickets arrive after the handshake. Takes them, if already recieved. */
+      char peek;
+      SSL_peek(session_context->ssl, &peek, 1);
+      ERR_clear_error();
+    }
+
+    /* Does not wait for close notify of peer. */
+    SSL_shutdown(session_context->ssl);
+    ERR_clear_error();
+
+    jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+  }
+
+  SSL_free(session_context->ssl);
+  session_context->ssl = NULL;
+  session_context->ktls_send = false;
+
+  pthread_mutex_unlock(&session_context->ssl_mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_tls_abort(void *ctx, int send_notify)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  jcon_client_tls_stop(ctx, send_notify);
+
+  if(jcon_socket_isConnected(session_context->connection))
+  {
+    jcon_socket_close(session_context->connection);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_wait(void *ctx, int ssl_error, int timeout)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  struct pollfd poll_fd;
+  poll_fd.fd = jcon_socket_getFileDescriptor(session_context->connection);
+  poll_fd.events = (ssl_error == SSL_ERROR_WANT_WRITE ? POLLOUT : POLLIN);
+  poll_fd.revents = 0;
+
+  if(poll_fd.fd < 0)
+  {
+    return false;
+  }
+
+  int ret_poll;
+  do
+  {
+    ret_poll = poll(&poll_fd, 1, timeout);
+  } while(ret_poll < 0 && errno == EINTR);
+
+  if(ret_poll < 0)
+  {
+    ERROR(ctx, "poll() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  return (ret_poll > 0);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_tls_send(void *ctx, const struct iovec *iov, int iov_count, int blocking)
+{
+  jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+  if(jcon_client_tls_isConnected(ctx) == false)
+  {
+    ERROR(ctx, "Client not connected.");
+    return 0;
+  }
+
+  char err_buf[JCON_CLIENT_TLS_ERROR_SIZE];
+  sigset_t old_set;
+  int pipe_pending = jcon_client_tls_blockSigpipe(&old_set);
+
+  size_t sent = 0;
+  int finished = false;
+
+  for(int i = 0; i < iov_count && finished == false; i++)
+  {
+    size_t done = 0;
+
+    while(done < iov[i].iov_len)
+    {
+      size_t chunk = iov[i].iov_len - done;
+      if(chunk > INT_MAX)
+      {
+        chunk = INT_MAX;
+      }
+
+      pthread_mutex_lock(&session_context->ssl_mutex);
+      if(session_context->ssl == NULL)
+      {
+        pthread_mutex_unlock(&session_context->ssl_mutex);
+        finished = true;
+        break;
+      }
+      ERR_clear_error();
+      int ret_write = SSL_write(session_context->ssl, (char *)iov[i].iov_base + done, (int)chunk);
+      int ssl_error = SSL_get_error(session_context->ssl, ret_write);
+      pthread_mutex_unlock(&session_context->ssl_mutex);
+
+      if(ret_write > 0)
+      {
+        done += ret_write;
+        sent += ret_write;
+        continue;
+      }
+
+      if(ssl_error == SSL_ERROR_WANT_WRITE || ssl_error == SSL_ERROR_WANT_READ)
+      {
+        if(blocking && jcon_client_tls_wait(ctx, ssl_error, -1))
+        {
+          continue;
+        }
+        finished = true;
+        break;
+      }
+
+      if(ssl_error == SSL_ERROR_ZERO_RETURN || (ssl_error == SSL_ERROR_SYSCALL && (errno == EPIPE || errno == ECONNRESET)))
+      {
+        DEBUG(ctx, "Peer closed connection.");
+      }
+      else
+      {
+        ERROR(ctx, "SSL_write() failed [%s]. Closing connection.", jcon_client_tls_errorString(err_buf, sizeof(err_buf)));
+      }
+      jcon_client_tls_abort(ctx, false);
+      finished = true;
+      break;
+    }
+  }
+
+  jcon_client_tls_restoreSigpipe(&old_set, pipe_pending);
+
+  return sent;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_tls_blockSigpipe(sigset_t *old_set)
+{
+  sigset_t pipe_set, pending_set;
+  sigemptyset(&pipe_set);
+  sigaddset(&pipe_set, SIGPIPE);
+  sigpending(&pending_set);
+  int pipe_pending = sigismember(&pending_set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipe_set, old_set);
+
+  return pipe_pending;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_tls_restoreSigpipe(const sigset_t *old_set, int pipe_pending)
+{
+  if(pipe_pending == false)
+  {
+    sigset_t pipe_set, pending_set;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    sigpending(&pending_set);
+
+    if(sigismember(&pending_set, SIGPIPE))
+    {
+      struct timespec no_wait = { 0, 0 };
+      sigtimedwait(&pipe_set, NULL, &no_wait);
+    }
+  }
+
+  pthread_sigmask(SIG_SETMASK, old_set, NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_client_tls_errorString(char *buf, size_t size)
+{
+  unsigned long error = ERR_get_error();
+  if(error == 0)
+  {
+    snprintf(buf, size, "%d : %s", errno, strerror(errno));
+  }
+  else
+  {
+    ERR_error_string_n(error, buf, size);
+  }
+
+  ERR_clear_error();
+  return buf;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jcon_client_tls_getContext(jcon_client_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(session->connection_type == NULL || strcmp(session->connection_type, JCON_CLIENT_TLS_CONNECTIONTYPE) != 0)
+  {
+    ERROR(NULL, "Session is not of type TLS.");
+    return NULL;
+  }
+
+  return session->session_context;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_client_tls_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(ctx)
+  {
+    jcon_client_tls_context_t *session_context = (jcon_client_tls_context_t *)ctx;
+
+    if(session_context->logger)
+    {
+      jlog_log_message_m(session_context->logger, log_type, file, function, line, "<%s> %s", jcon_client_tls_getReferenceString(ctx), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_client_tls_getReferenceString(ctx), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
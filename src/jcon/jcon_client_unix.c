@@ -11,6 +11,7 @@
 
 #include <jayc/jcon_client_unix.h>
 #include <jayc/jcon_client_dev.h>
+#include <jayc/jutil_alloc.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -19,6 +20,14 @@
 #include <stdio.h>
 #include <sys/un.h>
 
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_client_unix");
+
+
+
 //==============================================================================
 // Define constants and defaults.
 //
@@ -117,7 +126,7 @@ static size_t jcon_client_unix_recvData(void *ctx, void *data_ptr, size_t data_s
 
 /**
  * @brief Send data through socket.
- *
+ * 
  * @param ctx       Context of session to send through.
  * @param data_ptr  Pointer to data to be sent.
  *                  If NULL, nothing will happen.
@@ -128,6 +137,85 @@ static size_t jcon_client_unix_recvData(void *ctx, void *data_ptr, size_t data_s
  */
 static size_t jcon_client_unix_sendData(void *ctx, void *data_ptr, size_t data_size);
 
+/**
+ * @brief Send data from multiple buffers through socket.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_unix_sendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends data from multiple buffers without blocking.
+ * 
+ * @param ctx       Context of session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Size of data sended.
+ * @return          @c 0 , if send buffer is full or error occured.
+ */
+static size_t jcon_client_unix_trySendDataV(void *ctx, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends data of file descriptor.
+ * 
+ * @param ctx             Context of session to send through.
+ * @param file_descriptor Descriptor to read data from.
+ * @param offset          Position in file to start reading.
+ * @param size            Number of bytes to send.
+ * 
+ * @return                Size of data sended.
+ * @return                @c 0 , if no data written or error occured.
+ */
+static size_t jcon_client_unix_sendFile(void *ctx, int file_descriptor, off_t offset, size_t size);
+
+/**
+ * @brief Returns file descriptor of socket.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    File descriptor of socket.
+ * @return    @c -1 , if not connected or error occured.
+ */
+static int jcon_client_unix_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Sets timeout for @c #jcon_client_unix_newData() .
+ * 
+ * @param ctx     Context of session to configure.
+ * @param timeout Timeout in milliseconds. @c -1 waits until data arrives.
+ * 
+ * @return        @c true , if timeout was set.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_unix_setPollTimeout(void *ctx, int timeout);
+
+/**
+ * @brief Corks or flushes socket.
+ * 
+ * @param ctx     Context of session to configure.
+ * @param enable  @c true to cork, @c false to flush.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_client_unix_setCork(void *ctx, int enable);
+
+/**
+ * @brief Returns socket of session, if it is of type UNIX.
+ * 
+ * @param session Client session to check.
+ * 
+ * @return        jcon_socketUnix session of connection.
+ * @return        @c NULL , if session is not of type UNIX.
+ */
+static jcon_socket_t *jcon_client_unix_getConnection(jcon_client_t *session);
+
 /**
  * @brief Logs debug and error messages.
  * 
@@ -148,15 +236,20 @@ static void jcon_client_unix_log(void *ctx, int log_type, const char *file, cons
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_client_unix_context_t *)ctx)->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG
   #define DEBUG(ctx, fmt, ...)
 #else
-  #define DEBUG(ctx, fmt, ...) jcon_client_unix_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_client_unix_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(ctx, fmt, ...) jcon_client_unix_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(ctx, fmt, ...) jcon_client_unix_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(ctx, fmt, ...) jcon_client_unix_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(ctx, fmt, ...) jcon_client_unix_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_client_unix_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_client_unix_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_client_unix_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_client_unix_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(ctx, fmt, ...) jcon_client_unix_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -185,7 +278,7 @@ typedef struct __jcon_client_unix_context
 //
 jcon_client_t *jcon_client_unix_session_init(char *filepath, jlog_t *logger)
 {
-  jcon_client_t *session = (jcon_client_t *)malloc(sizeof(jcon_client_t));
+  jcon_client_t *session = (jcon_client_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_t));
   if(session == NULL)
   {
     ERROR(NULL, "<UNIX:%s> malloc() failed.", filepath);
@@ -199,13 +292,19 @@ jcon_client_t *jcon_client_unix_session_init(char *filepath, jlog_t *logger)
   session->function_newData = &jcon_client_unix_newData;
   session->function_recvData = &jcon_client_unix_recvData;
   session->function_sendData = &jcon_client_unix_sendData;
+  session->function_sendDataV = &jcon_client_unix_sendDataV;
+  session->function_trySendDataV = &jcon_client_unix_trySendDataV;
+  session->function_sendFile = &jcon_client_unix_sendFile;
+  session->function_getFileDescriptor = &jcon_client_unix_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_unix_setPollTimeout;
+  session->function_setCork = &jcon_client_unix_setCork;
   session->session_free_handler = &jcon_client_unix_session_free;
   session->connection_type = JCON_CLIENT_UNIX_CONNECTIONTYPE;
-  session->session_context = malloc(sizeof(jcon_client_unix_context_t));
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_client_unix_context_t));
   if(session->session_context == NULL)
   {
     ERROR(NULL, "<UNIX:%s> malloc() failed. Destroying session.", filepath);
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -218,8 +317,8 @@ jcon_client_t *jcon_client_unix_session_init(char *filepath, jlog_t *logger)
   if(ctx->connection == NULL)
   {
     ERROR(NULL, "<UNIX:%s> jcon_socketUnix_simple_init() failed. Destroying context and session.", filepath);
-    free(ctx);
-    free(session);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -236,7 +335,7 @@ jcon_client_t *jcon_client_unix_session_unixClone(jcon_socket_t *unix_session, j
     return NULL;
   }
 
-  jcon_client_t *session = (jcon_client_t *)malloc(sizeof(jcon_client_t));
+  jcon_client_t *session = (jcon_client_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_client_t));
   if(session == NULL)
   {
     ERROR(NULL, "<UNIX> malloc() failed.");
@@ -250,13 +349,19 @@ jcon_client_t *jcon_client_unix_session_unixClone(jcon_socket_t *unix_session, j
   session->function_newData = &jcon_client_unix_newData;
   session->function_recvData = &jcon_client_unix_recvData;
   session->function_sendData = &jcon_client_unix_sendData;
+  session->function_sendDataV = &jcon_client_unix_sendDataV;
+  session->function_trySendDataV = &jcon_client_unix_trySendDataV;
+  session->function_sendFile = &jcon_client_unix_sendFile;
+  session->function_getFileDescriptor = &jcon_client_unix_getFileDescriptor;
+  session->function_setPollTimeout = &jcon_client_unix_setPollTimeout;
+  session->function_setCork = &jcon_client_unix_setCork;
   session->session_free_handler = &jcon_client_unix_session_free;
   session->connection_type = JCON_CLIENT_UNIX_CONNECTIONTYPE;
-  session->session_context = malloc(sizeof(jcon_client_unix_context_t));
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_client_unix_context_t));
   if(session->session_context == NULL)
   {
     ERROR(NULL, "<unix> malloc() failed. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -283,7 +388,7 @@ void jcon_client_unix_session_free(void *ctx)
   jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
 
   jcon_socket_free(session_context->connection);
-  free(ctx);
+  JUTIL_ALLOC_FREE(ctx);
 }
 
 //------------------------------------------------------------------------------
@@ -296,7 +401,7 @@ int jcon_client_unix_reset(void *ctx)
     return false;
   }
 
-  if(jcon_client_isConnected(ctx))
+  if(jcon_client_unix_isConnected(ctx))
   {
     jcon_client_unix_close(ctx);
   }
@@ -408,10 +513,174 @@ size_t jcon_client_unix_sendData(void *ctx, void *data_ptr, size_t data_size)
   return jcon_socket_sendData(session_context->connection, data_ptr, data_size);
 }
 
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_unix_sendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
+
+  return jcon_socket_sendDataV(session_context->connection, iov, iov_count);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_unix_trySendDataV(void *ctx, const struct iovec *iov, int iov_count)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
+
+  return jcon_socket_trySendDataV(session_context->connection, iov, iov_count);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_unix_sendFile(void *ctx, int file_descriptor, off_t offset, size_t size)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
+
+  return jcon_socket_sendFile(session_context->connection, file_descriptor, offset, size);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_unix_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
+
+  return jcon_socket_getFileDescriptor(session_context->connection);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_unix_setPollTimeout(void *ctx, int timeout)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(timeout < -1)
+  {
+    ERROR(ctx, "Invalid poll timeout [%d].", timeout);
+    return false;
+  }
+
+  jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
+
+  session_context->poll_timeout = timeout;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_unix_setCork(void *ctx, int enable)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_client_unix_context_t *session_context = (jcon_client_unix_context_t *)ctx;
+
+  return jcon_socket_setCork(session_context->connection, enable);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_unix_sendFds(jcon_client_t *session, void *data_ptr, size_t data_size, const int fds[], size_t count)
+{
+  jcon_socket_t *connection = jcon_client_unix_getConnection(session);
+  if(connection == NULL)
+  {
+    return 0;
+  }
+
+  return jcon_socketUnix_sendFds(connection, data_ptr, data_size, fds, count);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_client_unix_recvFds(jcon_client_t *session, void *data_ptr, size_t data_size, int fds[], size_t max, size_t *count)
+{
+  jcon_socket_t *connection = jcon_client_unix_getConnection(session);
+  if(connection == NULL)
+  {
+    if(count)
+    {
+      *count = 0;
+    }
+    return 0;
+  }
+
+  return jcon_socketUnix_recvFds(connection, data_ptr, data_size, fds, max, count);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_client_unix_getPeerCredentials(jcon_client_t *session, pid_t *pid, uid_t *uid, gid_t *gid)
+{
+  jcon_socket_t *connection = jcon_client_unix_getConnection(session);
+  if(connection == NULL)
+  {
+    return false;
+  }
+
+  return jcon_socketUnix_getPeerCredentials(connection, pid, uid, gid);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_client_unix_getConnection(jcon_client_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(session->connection_type == NULL || strcmp(session->connection_type, JCON_CLIENT_UNIX_CONNECTIONTYPE) != 0)
+  {
+    ERROR(NULL, "Session is not of type UNIX.");
+    return NULL;
+  }
+
+  return ((jcon_client_unix_context_t *)session->session_context)->connection;
+}
+
 //------------------------------------------------------------------------------
 //
 void jcon_client_unix_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
@@ -0,0 +1,1574 @@
+/**
+ * @file jcon_clientpool.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_clientpool.
+ * 
+ * Idle connections are kept in intrusive stacks, so the
+ * connection used last is leased first and others can
+ * time out. Shards of threads are stored as thread specific
+ * data of the pool and only touched by their thread. On
+ * thread exit their connections move to the shared lists.
+ * 
+ * Groups hold their members as bit mask of endpoint indices,
+ * so resolving a DNS name replaces them with one store.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for getaddrinfo() */
+
+#include <jayc/jcon_clientpool.h>
+#include <jayc/jcon_client_tcp.h>
+#include <jayc/jcon_client_unix.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <jayc/jutil_hash.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <poll.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_clientpool");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Default of @c jcon_clientpool_options_t#max_idle .
+ */
+#define JCON_CLIENTPOOL_MAXIDLE_DEFAULT 8
+
+/**
+ * @brief Default of @c jcon_clientpool_options_t#shard_idle .
+ */
+#define JCON_CLIENTPOOL_SHARDIDLE_DEFAULT 2
+
+/**
+ * @brief Default of @c jcon_clientpool_options_t#probe_interval .
+ */
+#define JCON_CLIENTPOOL_PROBEINTERVAL_DEFAULT 1000
+
+/**
+ * @brief Default of @c jcon_clientpool_options_t#eject_failures .
+ */
+#define JCON_CLIENTPOOL_EJECTFAILURES_DEFAULT 5
+
+/**
+ * @brief Default of @c jcon_clientpool_options_t#eject_time .
+ */
+#define JCON_CLIENTPOOL_EJECTTIME_DEFAULT 10000
+
+/**
+ * @brief Default of @c jcon_clientpool_options_t#resolve_interval .
+ */
+#define JCON_CLIENTPOOL_RESOLVEINTERVAL_DEFAULT 30000
+
+/**
+ * @brief Nanoseconds per millisecond.
+ */
+#define JCON_CLIENTPOOL_NSECS_PER_MSEC 1000000L
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Connection of pool. Handed out as lease.
+ */
+struct __jcon_clientpool_lease
+{
+  jcon_clientpool_t *pool;              /**< Pool, the connection belongs to. */
+  int endpoint;                         /**< Index of endpoint. */
+  jcon_client_t *client;                /**< Connected client. */
+  unsigned long long last_used;         /**< Time of last release in milliseconds. */
+  unsigned long long checked;           /**< Time connection was known healthy in milliseconds. */
+  struct __jcon_clientpool_lease *next; /**< Next idle connection. */
+};
+
+/**
+ * @brief Server, that connections are opened to.
+ */
+typedef struct __jcon_clientpool_endpoint
+{
+  char *name;                           /**< Name of endpoint. */
+  jcon_clientpool_connect_t connect;    /**< Function to create connected client. */
+  void *ctx;                            /**< Context pointer passed to @c connect . */
+  void *owned_ctx;                      /**< Context allocated by pool. Freed with pool. */
+
+  pthread_mutex_t mutex;                /**< Protects idle list. */
+  jcon_clientpool_lease_t *idle;        /**< Shared idle connections. */
+  size_t idle_number;                   /**< Number of shared idle connections. */
+  atomic_size_t total;                  /**< Number of leased and idle connections. */
+
+  atomic_size_t outstanding;            /**< Number of leased connections. */
+  atomic_size_t failures;               /**< Failures since last success. */
+  atomic_ullong ejected_until;          /**< Time in milliseconds, until endpoint is ejected. */
+} jcon_clientpool_endpoint_t;
+
+/**
+ * @brief Endpoints, that leases are balanced between.
+ */
+typedef struct __jcon_clientpool_group
+{
+  char *name;                           /**< Name of group. */
+  char *host;                           /**< DNS name to resolve. @c NULL for fixed groups. */
+  uint16_t port;                        /**< Port of resolved endpoints. */
+  unsigned long long resolved;          /**< Time of last resolution in milliseconds. */
+  _Atomic uint32_t members;             /**< Bit mask of endpoint indices. */
+} jcon_clientpool_group_t;
+
+/**
+ * @brief Idle connections of one thread.
+ */
+typedef struct __jcon_clientpool_shard
+{
+  jcon_clientpool_t *pool;                                    /**< Pool of shard. */
+  struct __jcon_clientpool_shard *next;                       /**< Next shard of pool. */
+  struct __jcon_clientpool_shard *prev;                       /**< Previous shard of pool. */
+  jcon_clientpool_lease_t *idle[JCON_CLIENTPOOL_ENDPOINT_MAX];/**< Idle connections per endpoint. */
+  size_t idle_number[JCON_CLIENTPOOL_ENDPOINT_MAX];           /**< Number of idle connections per endpoint. */
+} jcon_clientpool_shard_t;
+
+/**
+ * @brief Context of TCP and Unix endpoints.
+ */
+typedef struct __jcon_clientpool_socketContext
+{
+  jcon_clientpool_t *pool;  /**< Pool, whose logger is used. */
+  uint16_t port;            /**< Port of TCP server. @c 0 for Unix sockets. */
+  char address[];           /**< Address of TCP server or path of Unix socket. */
+} jcon_clientpool_socketContext_t;
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+struct __jcon_clientpool_session
+{
+  jcon_clientpool_options_t options;  /**< Limits with defaults applied. */
+  jlog_t *logger;                     /**< Logger for debug and error messages. */
+
+  jcon_clientpool_endpoint_t endpoints[JCON_CLIENTPOOL_ENDPOINT_MAX]; /**< Endpoints of pool. */
+  atomic_int endpoint_number;         /**< Number of endpoints added. */
+
+  jcon_clientpool_group_t groups[JCON_CLIENTPOOL_GROUP_MAX]; /**< Groups of pool. */
+  atomic_int group_number;            /**< Number of groups added. */
+
+  pthread_key_t shard_key;            /**< Shard of calling thread. */
+  pthread_mutex_t mutex;              /**< Protects shard list and adding endpoints and groups. */
+  jcon_clientpool_shard_t *shards;    /**< Shards of all threads. */
+
+  jutil_thread_t *probe_thread;       /**< Thread, that probes shared idle connections. */
+};
+
+static _Thread_local uint64_t jcon_clientpool_random_state = 0; /**< Random state of calling thread. */
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Returns shard of calling thread.
+ * 
+ * Creates shard at first call of thread.
+ * 
+ * @param session Pool object.
+ * 
+ * @return        Shard of thread.
+ * @return        @c NULL , if error occured.
+ */
+static jcon_clientpool_shard_t *jcon_clientpool_getShard(jcon_clientpool_t *session);
+
+/**
+ * @brief Moves connections of exiting thread to shared lists.
+ * 
+ * Destructor of thread specific data.
+ * 
+ * @param ptr Shard of thread.
+ */
+static void jcon_clientpool_shard_free(void *ptr);
+
+/**
+ * @brief Opens new connection of endpoint.
+ * 
+ * @param session   Pool object.
+ * @param endpoint  Index of endpoint.
+ * 
+ * @return          Connection.
+ * @return          @c NULL , if @c max_total is reached or
+ *                  connection failed.
+ */
+static jcon_clientpool_lease_t *jcon_clientpool_connection_create(jcon_clientpool_t *session, int endpoint);
+
+/**
+ * @brief Closes and frees connection.
+ * 
+ * @param connection Connection to destroy.
+ */
+static void jcon_clientpool_connection_destroy(jcon_clientpool_lease_t *connection);
+
+/**
+ * @brief Probes idle connection and reconnects it, if broken.
+ * 
+ * @param connection  Connection to check.
+ * @param now         Current time in milliseconds.
+ * 
+ * @return            @c true , if connection is usable.
+ * @return            @c false , if reconnecting failed
+ *                    (connection is destroyed).
+ */
+static int jcon_clientpool_connection_check(jcon_clientpool_lease_t *connection, unsigned long long now);
+
+/**
+ * @brief Adds connection to shared idle list.
+ * 
+ * Destroys connection, if list is full.
+ * 
+ * @param connection Idle connection.
+ */
+static void jcon_clientpool_putShared(jcon_clientpool_lease_t *connection);
+
+/**
+ * @brief Loop function of probe thread.
+ * 
+ * @param ctx             Pool object.
+ * @param thread_session  Thread session.
+ * 
+ * @return                @c true , to continue.
+ */
+static int jcon_clientpool_probe_function(void *ctx, jutil_thread_t *thread_session);
+
+/**
+ * @brief Probes shared idle connections of endpoint.
+ * 
+ * Closes expired connections and opens connections,
+ * until @c min_idle are idle.
+ * 
+ * @param session   Pool object.
+ * @param endpoint  Index of endpoint.
+ */
+static void jcon_clientpool_probeEndpoint(jcon_clientpool_t *session, int endpoint);
+
+/**
+ * @brief Counts failure of endpoint and ejects it, if needed.
+ * 
+ * @param session   Pool object.
+ * @param endpoint  Index of endpoint.
+ */
+static void jcon_clientpool_addFailure(jcon_clientpool_t *session, int endpoint);
+
+/**
+ * @brief Chooses endpoint to lease from.
+ * 
+ * @param session     Pool object.
+ * @param candidates  Bit mask of endpoints. Not @c 0 .
+ * 
+ * @return            Index of endpoint.
+ */
+static int jcon_clientpool_chooseEndpoint(jcon_clientpool_t *session, uint32_t candidates);
+
+/**
+ * @brief Returns random number of calling thread (xorshift).
+ * 
+ * @return Random number.
+ */
+static uint64_t jcon_clientpool_random(void);
+
+/**
+ * @brief Resolves DNS name and adds its addresses as endpoints.
+ * 
+ * @param session Pool object.
+ * @param host    DNS name.
+ * @param port    Port of endpoints.
+ * @param members Set to bit mask of endpoints.
+ * 
+ * @return        @c true , if at least one address was found.
+ * @return        @c false , if error occured.
+ */
+static int jcon_clientpool_resolve(jcon_clientpool_t *session, const char *host, uint16_t port, uint32_t *members);
+
+/**
+ * @brief Adds group with members.
+ * 
+ * @param session Pool object.
+ * @param name    Name of group.
+ * @param host    DNS name to resolve again. @c NULL for fixed groups.
+ * @param port    Port of resolved endpoints.
+ * @param members Bit mask of endpoints.
+ * 
+ * @return        Index of group.
+ * @return        @c -1 , if error occured.
+ */
+static int jcon_clientpool_insertGroup(jcon_clientpool_t *session, const char *name, const char *host, uint16_t port, uint32_t members);
+
+/**
+ * @brief Connects TCP endpoint.
+ * 
+ * @param ctx Context of endpoint.
+ * 
+ * @return    Connected client.
+ * @return    @c NULL , if connection failed.
+ */
+static jcon_client_t *jcon_clientpool_connectTcp(void *ctx);
+
+/**
+ * @brief Connects Unix socket endpoint.
+ * 
+ * @param ctx Context of endpoint.
+ * 
+ * @return    Connected client.
+ * @return    @c NULL , if connection failed.
+ */
+static jcon_client_t *jcon_clientpool_connectUnix(void *ctx);
+
+/**
+ * @brief Adds endpoint with context allocated by pool.
+ * 
+ * @param session Pool object.
+ * @param name    Name of endpoint.
+ * @param connect Function to create connected client.
+ * @param ctx     Context of endpoint. Freed with pool, or
+ *                here, if error occured.
+ * 
+ * @return        Index of endpoint.
+ * @return        @c -1 , if error occured.
+ */
+static int jcon_clientpool_addOwnedEndpoint(jcon_clientpool_t *session, const char *name, jcon_clientpool_connect_t connect, void *ctx);
+
+/**
+ * @brief Sends log messages to logger of session.
+ * 
+ * @param session   Session object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jcon_clientpool_log(jcon_clientpool_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_clientpool_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_clientpool_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_clientpool_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_clientpool_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_clientpool_t *jcon_clientpool_init(const jcon_clientpool_options_t *options, jlog_t *logger)
+{
+  if(options && (options->probe_interval < 0 || options->idle_timeout < 0))
+  {
+    ERROR(NULL, "Invalid probe interval [%ld ms] or idle timeout [%ld ms].", options->probe_interval, options->idle_timeout);
+    return NULL;
+  }
+
+  jcon_clientpool_t *session = (jcon_clientpool_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_clientpool_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "calloc() failed.");
+    return NULL;
+  }
+
+  if(options)
+  {
+    session->options = *options;
+  }
+  if(session->options.max_idle == 0)
+  {
+    session->options.max_idle = JCON_CLIENTPOOL_MAXIDLE_DEFAULT;
+  }
+  if(session->options.shard_idle == 0)
+  {
+    session->options.shard_idle = JCON_CLIENTPOOL_SHARDIDLE_DEFAULT;
+  }
+  if(session->options.probe_interval == 0)
+  {
+    session->options.probe_interval = JCON_CLIENTPOOL_PROBEINTERVAL_DEFAULT;
+  }
+  if(session->options.eject_failures == 0)
+  {
+    session->options.eject_failures = JCON_CLIENTPOOL_EJECTFAILURES_DEFAULT;
+  }
+  if(session->options.eject_time <= 0)
+  {
+    session->options.eject_time = JCON_CLIENTPOOL_EJECTTIME_DEFAULT;
+  }
+  if(session->options.resolve_interval <= 0)
+  {
+    session->options.resolve_interval = JCON_CLIENTPOOL_RESOLVEINTERVAL_DEFAULT;
+  }
+  if(session->options.min_idle > session->options.max_idle)
+  {
+    session->options.max_idle = session->options.min_idle;
+  }
+
+  session->logger = logger;
+  atomic_init(&session->endpoint_number, 0);
+  atomic_init(&session->group_number, 0);
+  session->shards = NULL;
+
+  if(pthread_key_create(&session->shard_key, &jcon_clientpool_shard_free) != 0)
+  {
+    ERROR(session, "pthread_key_create() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+  pthread_mutex_init(&session->mutex, NULL);
+
+  session->probe_thread = jutil_thread_init
+  (
+    &jcon_clientpool_probe_function,
+    logger,
+    session->options.probe_interval / 1000,
+    (session->options.probe_interval % 1000) * JCON_CLIENTPOOL_NSECS_PER_MSEC,
+    session
+  );
+  if(session->probe_thread == NULL || jutil_thread_start(session->probe_thread) == false)
+  {
+    ERROR(session, "Could not start probe thread. Destroying session.");
+    jutil_thread_free(session->probe_thread);
+    pthread_mutex_destroy(&session->mutex);
+    pthread_key_delete(session->shard_key);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_free(jcon_clientpool_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  jutil_thread_free(session->probe_thread);
+
+  /* Exiting threads do not call the destructor anymore. */
+  pthread_key_delete(session->shard_key);
+
+  while(session->shards)
+  {
+    jcon_clientpool_shard_t *shard = session->shards;
+    session->shards = shard->next;
+
+    for(int i = 0; i < JCON_CLIENTPOOL_ENDPOINT_MAX; i++)
+    {
+      while(shard->idle[i])
+      {
+        jcon_clientpool_lease_t *connection = shard->idle[i];
+        shard->idle[i] = connection->next;
+        jcon_clientpool_connection_destroy(connection);
+      }
+    }
+
+    JUTIL_ALLOC_FREE(shard);
+  }
+
+  int number = atomic_load(&session->endpoint_number);
+  for(int i = 0; i < number; i++)
+  {
+    jcon_clientpool_endpoint_t *endpoint = &session->endpoints[i];
+    while(endpoint->idle)
+    {
+      jcon_clientpool_lease_t *connection = endpoint->idle;
+      endpoint->idle = connection->next;
+      jcon_clientpool_connection_destroy(connection);
+    }
+
+    pthread_mutex_destroy(&endpoint->mutex);
+    JUTIL_ALLOC_FREE(endpoint->name);
+    JUTIL_ALLOC_FREE(endpoint->owned_ctx);
+  }
+
+  number = atomic_load(&session->group_number);
+  for(int i = 0; i < number; i++)
+  {
+    JUTIL_ALLOC_FREE(session->groups[i].name);
+    JUTIL_ALLOC_FREE(session->groups[i].host);
+  }
+
+  pthread_mutex_destroy(&session->mutex);
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_addEndpoint(jcon_clientpool_t *session, const char *name, jcon_clientpool_connect_t connect, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(name == NULL || connect == NULL)
+  {
+    ERROR(session, "No name or connect function given.");
+    return -1;
+  }
+
+  pthread_mutex_lock(&session->mutex);
+
+  if(jcon_clientpool_findEndpoint(session, name) >= 0)
+  {
+    pthread_mutex_unlock(&session->mutex);
+    ERROR(session, "Endpoint [%s] exists.", name);
+    return -1;
+  }
+
+  int index = atomic_load(&session->endpoint_number);
+  if(index >= JCON_CLIENTPOOL_ENDPOINT_MAX)
+  {
+    pthread_mutex_unlock(&session->mutex);
+    ERROR(session, "Pool has maximum number of endpoints [%d].", JCON_CLIENTPOOL_ENDPOINT_MAX);
+    return -1;
+  }
+
+  jcon_clientpool_endpoint_t *endpoint = &session->endpoints[index];
+  endpoint->name = JUTIL_ALLOC_STRDUP(name);
+  if(endpoint->name == NULL)
+  {
+    pthread_mutex_unlock(&session->mutex);
+    ERROR(session, "strdup() failed.");
+    return -1;
+  }
+
+  endpoint->connect = connect;
+  endpoint->ctx = ctx;
+  endpoint->owned_ctx = NULL;
+  pthread_mutex_init(&endpoint->mutex, NULL);
+  endpoint->idle = NULL;
+  endpoint->idle_number = 0;
+  atomic_init(&endpoint->total, 0);
+  atomic_init(&endpoint->outstanding, 0);
+  atomic_init(&endpoint->failures, 0);
+  atomic_init(&endpoint->ejected_until, 0);
+
+  /* Leasing threads read the endpoint after the number. */
+  atomic_store_explicit(&session->endpoint_number, index + 1, memory_order_release);
+
+  pthread_mutex_unlock(&session->mutex);
+
+  DEBUG(session, "Endpoint [%s] added [%d].", name, index);
+  return index;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_addTcpEndpoint(jcon_clientpool_t *session, const char *address, uint16_t port)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(address == NULL)
+  {
+    ERROR(session, "Address is NULL.");
+    return -1;
+  }
+
+  size_t length = strlen(address);
+  jcon_clientpool_socketContext_t *ctx = (jcon_clientpool_socketContext_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_clientpool_socketContext_t) + length + 1);
+  if(ctx == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    return -1;
+  }
+
+  ctx->pool = session;
+  ctx->port = port;
+  memcpy(ctx->address, address, length + 1);
+
+  char name[1024];
+  snprintf(name, sizeof(name), "%s:%u", address, (unsigned int)port);
+
+  return jcon_clientpool_addOwnedEndpoint(session, name, &jcon_clientpool_connectTcp, ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_addUnixEndpoint(jcon_clientpool_t *session, const char *path)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(path == NULL)
+  {
+    ERROR(session, "Path is NULL.");
+    return -1;
+  }
+
+  size_t length = strlen(path);
+  jcon_clientpool_socketContext_t *ctx = (jcon_clientpool_socketContext_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_clientpool_socketContext_t) + length + 1);
+  if(ctx == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    return -1;
+  }
+
+  ctx->pool = session;
+  ctx->port = 0;
+  memcpy(ctx->address, path, length + 1);
+
+  return jcon_clientpool_addOwnedEndpoint(session, path, &jcon_clientpool_connectUnix, ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_findEndpoint(jcon_clientpool_t *session, const char *name)
+{
+  if(session == NULL || name == NULL)
+  {
+    return -1;
+  }
+
+  int number = atomic_load_explicit(&session->endpoint_number, memory_order_acquire);
+  for(int i = 0; i < number; i++)
+  {
+    if(strcmp(session->endpoints[i].name, name) == 0)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_addGroup(jcon_clientpool_t *session, const char *name, const int *endpoints, size_t count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(name == NULL || (endpoints == NULL && count > 0))
+  {
+    ERROR(session, "No name or endpoints given.");
+    return -1;
+  }
+
+  int number = atomic_load_explicit(&session->endpoint_number, memory_order_acquire);
+  uint32_t members = 0;
+  for(size_t i = 0; i < count; i++)
+  {
+    if(endpoints[i] < 0 || endpoints[i] >= number)
+    {
+      ERROR(session, "Invalid endpoint [%d] for group [%s].", endpoints[i], name);
+      return -1;
+    }
+    members |= (uint32_t)1 << endpoints[i];
+  }
+
+  return jcon_clientpool_insertGroup(session, name, NULL, 0, members);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_addDnsGroup(jcon_clientpool_t *session, const char *host, uint16_t port)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(host == NULL)
+  {
+    ERROR(session, "Host is NULL.");
+    return -1;
+  }
+
+  char name[1024];
+  snprintf(name, sizeof(name), "%s:%u", host, (unsigned int)port);
+
+  /* Name can not be resolved yet, the probe thread retries. */
+  uint32_t members = 0;
+  if(jcon_clientpool_resolve(session, host, port, &members) == false)
+  {
+    WARN(session, "Could not resolve [%s]. Group has no endpoints yet.", host);
+  }
+
+  return jcon_clientpool_insertGroup(session, name, host, port, members);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_findGroup(jcon_clientpool_t *session, const char *name)
+{
+  if(session == NULL || name == NULL)
+  {
+    return -1;
+  }
+
+  int number = atomic_load_explicit(&session->group_number, memory_order_acquire);
+  for(int i = 0; i < number; i++)
+  {
+    if(strcmp(session->groups[i].name, name) == 0)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_clientpool_lease_t *jcon_clientpool_leaseGroup(jcon_clientpool_t *session, int group)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(group < 0 || group >= atomic_load_explicit(&session->group_number, memory_order_acquire))
+  {
+    ERROR(session, "Invalid group [%d].", group);
+    return NULL;
+  }
+
+  uint32_t members = atomic_load_explicit(&session->groups[group].members, memory_order_acquire);
+  unsigned long long now = jutil_time_getCoarseMillis();
+
+  uint32_t available = 0;
+  for(int endpoint = 0; endpoint < JCON_CLIENTPOOL_ENDPOINT_MAX; endpoint++)
+  {
+    if((members & ((uint32_t)1 << endpoint))
+      && now >= atomic_load_explicit(&session->endpoints[endpoint].ejected_until, memory_order_relaxed))
+    {
+      available |= (uint32_t)1 << endpoint;
+    }
+  }
+
+  /* All endpoints ejected, better try them than fail. */
+  if(available == 0)
+  {
+    available = members;
+  }
+
+  while(available)
+  {
+    int endpoint = jcon_clientpool_chooseEndpoint(session, available);
+    jcon_clientpool_lease_t *lease = jcon_clientpool_lease(session, endpoint);
+    if(lease)
+    {
+      return lease;
+    }
+
+    available &= ~((uint32_t)1 << endpoint);
+  }
+
+  ERROR(session, "No endpoint of group [%s] available.", session->groups[group].name);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_clientpool_lease_t *jcon_clientpool_lease(jcon_clientpool_t *session, int endpoint)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(endpoint < 0 || endpoint >= atomic_load_explicit(&session->endpoint_number, memory_order_acquire))
+  {
+    ERROR(session, "Invalid endpoint [%d].", endpoint);
+    return NULL;
+  }
+
+  jcon_clientpool_shard_t *shard = jcon_clientpool_getShard(session);
+  jcon_clientpool_endpoint_t *shared = &session->endpoints[endpoint];
+  unsigned long long now = jutil_time_getCoarseMillis();
+
+  for(;;)
+  {
+    jcon_clientpool_lease_t *connection = NULL;
+
+    if(shard && shard->idle[endpoint])
+    {
+      connection = shard->idle[endpoint];
+      shard->idle[endpoint] = connection->next;
+      shard->idle_number[endpoint]--;
+    }
+    else
+    {
+      pthread_mutex_lock(&shared->mutex);
+      connection = shared->idle;
+      if(connection)
+      {
+        shared->idle = connection->next;
+        shared->idle_number--;
+      }
+      pthread_mutex_unlock(&shared->mutex);
+    }
+
+    if(connection == NULL)
+    {
+      break;
+    }
+
+    if(now - connection->checked < (unsigned long long)session->options.probe_interval
+      || jcon_clientpool_connection_check(connection, now))
+    {
+      connection->next = NULL;
+      atomic_fetch_add_explicit(&shared->outstanding, 1, memory_order_relaxed);
+      return connection;
+    }
+  }
+
+  jcon_clientpool_lease_t *connection = jcon_clientpool_connection_create(session, endpoint);
+  if(connection)
+  {
+    atomic_fetch_add_explicit(&shared->outstanding, 1, memory_order_relaxed);
+  }
+
+  return connection;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_clientpool_getClient(jcon_clientpool_lease_t *lease)
+{
+  if(lease == NULL)
+  {
+    return NULL;
+  }
+
+  return lease->client;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_getEndpoint(jcon_clientpool_lease_t *lease)
+{
+  if(lease == NULL)
+  {
+    return -1;
+  }
+
+  return lease->endpoint;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_release(jcon_clientpool_lease_t *lease, int reuse)
+{
+  if(lease == NULL)
+  {
+    ERROR(NULL, "Lease is NULL.");
+    return;
+  }
+
+  jcon_clientpool_t *session = lease->pool;
+  jcon_clientpool_endpoint_t *shared = &session->endpoints[lease->endpoint];
+  atomic_fetch_sub_explicit(&shared->outstanding, 1, memory_order_relaxed);
+
+  if(reuse == false || jcon_client_isConnected(lease->client) == false)
+  {
+    jcon_clientpool_addFailure(session, lease->endpoint);
+    jcon_clientpool_connection_destroy(lease);
+    return;
+  }
+
+  if(atomic_load_explicit(&shared->failures, memory_order_relaxed) != 0)
+  {
+    atomic_store_explicit(&shared->failures, 0, memory_order_relaxed);
+  }
+
+  lease->last_used = jutil_time_getCoarseMillis();
+  lease->checked = lease->last_used;
+
+  jcon_clientpool_shard_t *shard = jcon_clientpool_getShard(session);
+  if(shard && shard->idle_number[lease->endpoint] < session->options.shard_idle)
+  {
+    lease->next = shard->idle[lease->endpoint];
+    shard->idle[lease->endpoint] = lease;
+    shard->idle_number[lease->endpoint]++;
+    return;
+  }
+
+  jcon_clientpool_putShared(lease);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_clientpool_getConnections(jcon_clientpool_t *session, int endpoint)
+{
+  if(session == NULL || endpoint < 0 || endpoint >= atomic_load_explicit(&session->endpoint_number, memory_order_acquire))
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&session->endpoints[endpoint].total, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_clientpool_getOutstanding(jcon_clientpool_t *session, int endpoint)
+{
+  if(session == NULL || endpoint < 0 || endpoint >= atomic_load_explicit(&session->endpoint_number, memory_order_acquire))
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&session->endpoints[endpoint].outstanding, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_isEjected(jcon_clientpool_t *session, int endpoint)
+{
+  if(session == NULL || endpoint < 0 || endpoint >= atomic_load_explicit(&session->endpoint_number, memory_order_acquire))
+  {
+    return false;
+  }
+
+  unsigned long long ejected_until = atomic_load_explicit(&session->endpoints[endpoint].ejected_until, memory_order_relaxed);
+  return (jutil_time_getCoarseMillis() < ejected_until ? true : false);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_clientpool_shard_t *jcon_clientpool_getShard(jcon_clientpool_t *session)
+{
+  jcon_clientpool_shard_t *shard = (jcon_clientpool_shard_t *)pthread_getspecific(session->shard_key);
+  if(shard)
+  {
+    return shard;
+  }
+
+  shard = (jcon_clientpool_shard_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_clientpool_shard_t));
+  if(shard == NULL)
+  {
+    ERROR(session, "calloc() failed. Using shared lists.");
+    return NULL;
+  }
+  shard->pool = session;
+
+  if(pthread_setspecific(session->shard_key, shard) != 0)
+  {
+    ERROR(session, "pthread_setspecific() failed. Using shared lists.");
+    JUTIL_ALLOC_FREE(shard);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&session->mutex);
+  shard->next = session->shards;
+  if(session->shards)
+  {
+    session->shards->prev = shard;
+  }
+  session->shards = shard;
+  pthread_mutex_unlock(&session->mutex);
+
+  return shard;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_shard_free(void *ptr)
+{
+  jcon_clientpool_shard_t *shard = (jcon_clientpool_shard_t *)ptr;
+  jcon_clientpool_t *session = shard->pool;
+
+  pthread_mutex_lock(&session->mutex);
+  if(shard->prev)
+  {
+    shard->prev->next = shard->next;
+  }
+  else
+  {
+    session->shards = shard->next;
+  }
+  if(shard->next)
+  {
+    shard->next->prev = shard->prev;
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  for(int i = 0; i < JCON_CLIENTPOOL_ENDPOINT_MAX; i++)
+  {
+    while(shard->idle[i])
+    {
+      jcon_clientpool_lease_t *connection = shard->idle[i];
+      shard->idle[i] = connection->next;
+      jcon_clientpool_putShared(connection);
+    }
+  }
+
+  JUTIL_ALLOC_FREE(shard);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_clientpool_lease_t *jcon_clientpool_connection_create(jcon_clientpool_t *session, int endpoint)
+{
+  jcon_clientpool_endpoint_t *shared = &session->endpoints[endpoint];
+
+  /* Slot is reserved first, so concurrent leases keep the limit. */
+  size_t total = atomic_load_explicit(&shared->total, memory_order_relaxed);
+  do
+  {
+    if(session->options.max_total > 0 && total >= session->options.max_total)
+    {
+      DEBUG(session, "Endpoint [%s] has maximum number of connections [%zu].", shared->name, session->options.max_total);
+      return NULL;
+    }
+  } while(atomic_compare_exchange_weak_explicit(&shared->total, &total, total + 1, memory_order_relaxed, memory_order_relaxed) == false);
+
+  jcon_clientpool_lease_t *connection = (jcon_clientpool_lease_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_clientpool_lease_t));
+  if(connection == NULL)
+  {
+    atomic_fetch_sub_explicit(&shared->total, 1, memory_order_relaxed);
+    ERROR(session, "malloc() failed.");
+    return NULL;
+  }
+
+  connection->client = shared->connect(shared->ctx);
+  if(connection->client == NULL)
+  {
+    atomic_fetch_sub_explicit(&shared->total, 1, memory_order_relaxed);
+    JUTIL_ALLOC_FREE(connection);
+    ERROR(session, "Could not connect to endpoint [%s].", shared->name);
+    jcon_clientpool_addFailure(session, endpoint);
+    return NULL;
+  }
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_clientpool_connects_total", "Connections opened by client pools.", 1);
+
+  connection->pool = session;
+  connection->endpoint = endpoint;
+  connection->last_used = jutil_time_getCoarseMillis();
+  connection->checked = connection->last_used;
+  connection->next = NULL;
+
+  DEBUG(session, "Connected to endpoint [%s] <%s>.", shared->name, jcon_client_getReferenceString(connection->client));
+  return connection;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_connection_destroy(jcon_clientpool_lease_t *connection)
+{
+  jcon_clientpool_endpoint_t *shared = &connection->pool->endpoints[connection->endpoint];
+
+  jcon_client_close(connection->client);
+  jcon_client_session_free(connection->client);
+  atomic_fetch_sub_explicit(&shared->total, 1, memory_order_relaxed);
+  JUTIL_ALLOC_FREE(connection);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_connection_check(jcon_clientpool_lease_t *connection, unsigned long long now)
+{
+  jcon_clientpool_t *session = connection->pool;
+  int healthy = jcon_client_isConnected(connection->client);
+
+  /* Idle connections have nothing to read, unless the peer closed them. */
+  int file_descriptor = jcon_client_getFileDescriptor(connection->client);
+  if(healthy && file_descriptor >= 0)
+  {
+    struct pollfd poll_fd = { file_descriptor, POLLIN, 0 };
+    healthy = (poll(&poll_fd, 1, 0) == 0);
+  }
+
+  if(healthy && session->options.probe)
+  {
+    healthy = session->options.probe(session->options.probe_ctx, connection->client);
+  }
+
+  if(healthy)
+  {
+    connection->checked = now;
+    return true;
+  }
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_clientpool_probe_failures_total", "Idle connections of client pools found broken.", 1);
+  DEBUG(session, "Connection to endpoint [%s] broken. Reconnecting.", session->endpoints[connection->endpoint].name);
+
+  jcon_client_close(connection->client);
+  if(jcon_client_reset(connection->client) == false)
+  {
+    ERROR(session, "Could not reconnect to endpoint [%s].", session->endpoints[connection->endpoint].name);
+    jcon_clientpool_addFailure(session, connection->endpoint);
+    jcon_clientpool_connection_destroy(connection);
+    return false;
+  }
+
+  connection->checked = now;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_putShared(jcon_clientpool_lease_t *connection)
+{
+  jcon_clientpool_t *session = connection->pool;
+  jcon_clientpool_endpoint_t *shared = &session->endpoints[connection->endpoint];
+
+  pthread_mutex_lock(&shared->mutex);
+  if(shared->idle_number < session->options.max_idle)
+  {
+    connection->next = shared->idle;
+    shared->idle = connection;
+    shared->idle_number++;
+    connection = NULL;
+  }
+  pthread_mutex_unlock(&shared->mutex);
+
+  if(connection)
+  {
+    jcon_clientpool_connection_destroy(connection);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_probe_function(void *ctx, jutil_thread_t *thread_session)
+{
+  jcon_clientpool_t *session = (jcon_clientpool_t *)ctx;
+
+  int number = atomic_load_explicit(&session->endpoint_number, memory_order_acquire);
+  for(int i = 0; i < number && jutil_thread_isRunning(thread_session); i++)
+  {
+    jcon_clientpool_probeEndpoint(session, i);
+  }
+
+  unsigned long long now = jutil_time_getCoarseMillis();
+  number = atomic_load_explicit(&session->group_number, memory_order_acquire);
+  for(int i = 0; i < number && jutil_thread_isRunning(thread_session); i++)
+  {
+    jcon_clientpool_group_t *group = &session->groups[i];
+    if(group->host == NULL || now - group->resolved < (unsigned long long)session->options.resolve_interval)
+    {
+      continue;
+    }
+
+    /* Keep last members, if name can not be resolved. */
+    uint32_t members = 0;
+    if(jcon_clientpool_resolve(session, group->host, group->port, &members))
+    {
+      if(members != atomic_load_explicit(&group->members, memory_order_relaxed))
+      {
+        INFO(session, "Endpoints of group [%s] changed.", group->name);
+      }
+      atomic_store_explicit(&group->members, members, memory_order_release);
+    }
+    group->resolved = now;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_probeEndpoint(jcon_clientpool_t *session, int endpoint)
+{
+  jcon_clientpool_endpoint_t *shared = &session->endpoints[endpoint];
+
+  /* Connections are probed without lock, leases meanwhile connect new ones. */
+  pthread_mutex_lock(&shared->mutex);
+  jcon_clientpool_lease_t *connection = shared->idle;
+  size_t open = shared->idle_number;
+  shared->idle = NULL;
+  shared->idle_number = 0;
+  pthread_mutex_unlock(&shared->mutex);
+
+  jcon_clientpool_lease_t *kept = NULL;
+  jcon_clientpool_lease_t *kept_tail = NULL;
+  size_t kept_number = 0;
+  unsigned long long now = jutil_time_getCoarseMillis();
+
+  while(connection)
+  {
+    jcon_clientpool_lease_t *next = connection->next;
+
+    if(session->options.idle_timeout > 0 && open > session->options.min_idle
+      && now - connection->last_used >= (unsigned long long)session->options.idle_timeout)
+    {
+      DEBUG(session, "Closing idle connection to endpoint [%s].", shared->name);
+      jcon_clientpool_connection_destroy(connection);
+      open--;
+    }
+    else if(jcon_clientpool_connection_check(connection, now) == false)
+    {
+      open--;
+    }
+    else
+    {
+      connection->next = NULL;
+      if(kept_tail)
+      {
+        kept_tail->next = connection;
+      }
+      else
+      {
+        kept = connection;
+      }
+      kept_tail = connection;
+      kept_number++;
+    }
+
+    connection = next;
+  }
+
+  while(kept_number < session->options.min_idle)
+  {
+    connection = jcon_clientpool_connection_create(session, endpoint);
+    if(connection == NULL)
+    {
+      break;
+    }
+
+    connection->next = kept;
+    kept = connection;
+    if(kept_tail == NULL)
+    {
+      kept_tail = connection;
+    }
+    kept_number++;
+  }
+
+  if(kept == NULL)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&shared->mutex);
+  kept_tail->next = shared->idle;
+  shared->idle = kept;
+  shared->idle_number += kept_number;
+  pthread_mutex_unlock(&shared->mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_addFailure(jcon_clientpool_t *session, int endpoint)
+{
+  jcon_clientpool_endpoint_t *shared = &session->endpoints[endpoint];
+
+  size_t failures = atomic_fetch_add_explicit(&shared->failures, 1, memory_order_relaxed) + 1;
+  if(failures < session->options.eject_failures)
+  {
+    return;
+  }
+
+  atomic_store_explicit(&shared->failures, 0, memory_order_relaxed);
+  atomic_store_explicit(&shared->ejected_until, jutil_time_getCoarseMillis() + (unsigned long long)session->options.eject_time, memory_order_relaxed);
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_clientpool_ejections_total", "Endpoints of client pools ejected after failures.", 1);
+  WARN(session, "Ejecting endpoint [%s] for [%ld ms] after [%zu] failures.", shared->name, session->options.eject_time, failures);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_chooseEndpoint(jcon_clientpool_t *session, uint32_t candidates)
+{
+  int chosen[JCON_CLIENTPOOL_ENDPOINT_MAX];
+  int count = 0;
+  for(int endpoint = 0; endpoint < JCON_CLIENTPOOL_ENDPOINT_MAX; endpoint++)
+  {
+    if(candidates & ((uint32_t)1 << endpoint))
+    {
+      chosen[count++] = endpoint;
+    }
+  }
+
+  if(count == 1)
+  {
+    return chosen[0];
+  }
+
+  uint64_t random = jcon_clientpool_random();
+
+  if(session->options.balance == JCON_CLIENTPOOL_BALANCE_LEAST)
+  {
+    /* Start at random candidate, so ties are spread. */
+    int start = (int)(random % (uint64_t)count);
+    int best = chosen[start];
+    size_t best_outstanding = atomic_load_explicit(&session->endpoints[best].outstanding, memory_order_relaxed);
+    for(int i = 1; i < count; i++)
+    {
+      int endpoint = chosen[(start + i) % count];
+      size_t outstanding = atomic_load_explicit(&session->endpoints[endpoint].outstanding, memory_order_relaxed);
+      if(outstanding < best_outstanding)
+      {
+        best = endpoint;
+        best_outstanding = outstanding;
+      }
+    }
+    return best;
+  }
+
+  int first = (int)(random % (uint64_t)count);
+  int second = (int)((random >> 32) % (uint64_t)(count - 1));
+  if(second >= first)
+  {
+    second++;
+  }
+
+  size_t first_outstanding = atomic_load_explicit(&session->endpoints[chosen[first]].outstanding, memory_order_relaxed);
+  size_t second_outstanding = atomic_load_explicit(&session->endpoints[chosen[second]].outstanding, memory_order_relaxed);
+  return (second_outstanding < first_outstanding ? chosen[second] : chosen[first]);
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jcon_clientpool_random(void)
+{
+  uint64_t x = jcon_clientpool_random_state;
+  if(x == 0)
+  {
+    x = jutil_hash_getRandomSeed() ^ (uint64_t)(uintptr_t)&jcon_clientpool_random_state;
+    if(x == 0)
+    {
+      x = 1;
+    }
+  }
+
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  jcon_clientpool_random_state = x;
+  return x;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_resolve(jcon_clientpool_t *session, const char *host, uint16_t port, uint32_t *members)
+{
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo *result = NULL;
+  int ret_gai = getaddrinfo(host, NULL, &hints, &result);
+  if(ret_gai != 0 || result == NULL)
+  {
+    ERROR(session, "getaddrinfo() failed for [%s] [%d : %s].", host, ret_gai, gai_strerror(ret_gai));
+    return false;
+  }
+
+  *members = 0;
+  for(struct addrinfo *info = result; info; info = info->ai_next)
+  {
+    char address[INET_ADDRSTRLEN];
+    if(inet_ntop(AF_INET, &((struct sockaddr_in *)info->ai_addr)->sin_addr, address, sizeof(address)) == NULL)
+    {
+      continue;
+    }
+
+    char name[INET_ADDRSTRLEN + 8];
+    snprintf(name, sizeof(name), "%s:%u", address, (unsigned int)port);
+
+    int endpoint = jcon_clientpool_findEndpoint(session, name);
+    if(endpoint < 0)
+    {
+      endpoint = jcon_clientpool_addTcpEndpoint(session, address, port);
+    }
+    if(endpoint >= 0)
+    {
+      *members |= (uint32_t)1 << endpoint;
+    }
+  }
+
+  freeaddrinfo(result);
+  return (*members != 0 ? true : false);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_insertGroup(jcon_clientpool_t *session, const char *name, const char *host, uint16_t port, uint32_t members)
+{
+  pthread_mutex_lock(&session->mutex);
+
+  if(jcon_clientpool_findGroup(session, name) >= 0)
+  {
+    pthread_mutex_unlock(&session->mutex);
+    ERROR(session, "Group [%s] exists.", name);
+    return -1;
+  }
+
+  int index = atomic_load(&session->group_number);
+  if(index >= JCON_CLIENTPOOL_GROUP_MAX)
+  {
+    pthread_mutex_unlock(&session->mutex);
+    ERROR(session, "Pool has maximum number of groups [%d].", JCON_CLIENTPOOL_GROUP_MAX);
+    return -1;
+  }
+
+  jcon_clientpool_group_t *group = &session->groups[index];
+  group->name = JUTIL_ALLOC_STRDUP(name);
+  group->host = (host ? JUTIL_ALLOC_STRDUP(host) : NULL);
+  if(group->name == NULL || (host && group->host == NULL))
+  {
+    JUTIL_ALLOC_FREE(group->name);
+    JUTIL_ALLOC_FREE(group->host);
+    pthread_mutex_unlock(&session->mutex);
+    ERROR(session, "strdup() failed.");
+    return -1;
+  }
+
+  group->port = port;
+  group->resolved = jutil_time_getCoarseMillis();
+  atomic_init(&group->members, members);
+
+  /* Leasing threads read the group after the number. */
+  atomic_store_explicit(&session->group_number, index + 1, memory_order_release);
+
+  pthread_mutex_unlock(&session->mutex);
+
+  DEBUG(session, "Group [%s] added [%d].", name, index);
+  return index;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_clientpool_connectTcp(void *ctx)
+{
+  jcon_clientpool_socketContext_t *socket_ctx = (jcon_clientpool_socketContext_t *)ctx;
+
+  jcon_client_t *client = jcon_client_tcp_session_init(socket_ctx->address, socket_ctx->port, socket_ctx->pool->logger);
+  if(client == NULL)
+  {
+    return NULL;
+  }
+
+  if(jcon_client_reset(client) == false)
+  {
+    jcon_client_session_free(client);
+    return NULL;
+  }
+
+  return client;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_clientpool_connectUnix(void *ctx)
+{
+  jcon_clientpool_socketContext_t *socket_ctx = (jcon_clientpool_socketContext_t *)ctx;
+
+  jcon_client_t *client = jcon_client_unix_session_init(socket_ctx->address, socket_ctx->pool->logger);
+  if(client == NULL)
+  {
+    return NULL;
+  }
+
+  if(jcon_client_reset(client) == false)
+  {
+    jcon_client_session_free(client);
+    return NULL;
+  }
+
+  return client;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_clientpool_addOwnedEndpoint(jcon_clientpool_t *session, const char *name, jcon_clientpool_connect_t connect, void *ctx)
+{
+  int index = jcon_clientpool_addEndpoint(session, name, connect, ctx);
+  if(index < 0)
+  {
+    JUTIL_ALLOC_FREE(ctx);
+    return -1;
+  }
+
+  session->endpoints[index].owned_ctx = ctx;
+  return index;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_clientpool_log(jcon_clientpool_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session && session->logger)
+  {
+    jlog_log_message_m(session->logger, log_type, file, function, line, "%s", buf);
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, "%s", buf);
+  }
+}
@@ -0,0 +1,1456 @@
+/**
+ * @file jcon_configSync.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_configSync.
+ * 
+ * The primary keeps the snapshot of the last published version.
+ * Deltas are found by diffing it against the latest snapshot,
+ * which only walks the changed paths of the prefix trees.
+ * 
+ * Every delta is encoded once into a buffer and kept in a ring.
+ * Queues of replicas reference the buffer, so sending to many
+ * replicas does not copy. Each replica stores the version, that
+ * was queued for it last. Replicas, whose queue was full, stay
+ * behind and get the missing deltas on the next check.
+ * 
+ * Message layout (after the length prefix, numbers big endian):
+ * 
+ * @code
+ * HELLO: 'H' epoch(8) version(8)
+ * DELTA: 'D' epoch(8) base(8) version(8) count(4) entries
+ * FULL:  'F' epoch(8) version(8) count(4) entries
+ * Entry: 'S' key_length(4) key '\0' value_length(4) value '\0'
+ *        'R' key_length(4) key '\0'
+ * @endcode
+ * 
+ * Strings are terminated, so replicas use them in the frame
+ * without copying.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_configSync.h>
+#include <jayc/jcon_system.h>
+#include <jayc/jcon_frame.h>
+#include <jayc/jconfig_snapshot.h>
+#include <jayc/jconfig_dev.h>
+#include <jayc/jutil_buffer.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_hash.h>
+#include <jayc/jutil_map.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_configSync");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Default of @c jcon_configSync_options_t#history .
+ */
+#define JCON_CONFIGSYNC_HISTORY_DEFAULT 256
+
+/**
+ * @brief Default of @c jcon_configSync_options_t#publish_interval .
+ */
+#define JCON_CONFIGSYNC_PUBLISHINTERVAL_DEFAULT 1000
+
+/**
+ * @brief Default of @c jcon_configSync_options_t#frame_max .
+ */
+#define JCON_CONFIGSYNC_FRAMEMAX_DEFAULT (64 * 1024 * 1024)
+
+/**
+ * @brief Default of @c jcon_configSync_options_t#reconnect_min .
+ */
+#define JCON_CONFIGSYNC_RECONNECTMIN_DEFAULT 100
+
+/**
+ * @brief Default of @c jcon_configSync_options_t#reconnect_max .
+ */
+#define JCON_CONFIGSYNC_RECONNECTMAX_DEFAULT 10000
+
+/**
+ * @brief Time in milliseconds between loop executions of replicas.
+ */
+#define JCON_CONFIGSYNC_REPLICA_SLEEP 10
+
+/**
+ * @brief Nanoseconds per millisecond.
+ */
+#define JCON_CONFIGSYNC_NSECS_PER_MSEC 1000000L
+
+/**
+ * @brief Size of length prefix of messages.
+ */
+#define JCON_CONFIGSYNC_PREFIX_SIZE 4
+
+/**
+ * @brief Size of HELLO message.
+ */
+#define JCON_CONFIGSYNC_HELLO_SIZE 17
+
+/**
+ * @brief Maximum size of header, including length prefix.
+ */
+#define JCON_CONFIGSYNC_HEADER_MAX (JCON_CONFIGSYNC_PREFIX_SIZE + 29)
+
+/**
+ * @brief Minimum size of an entry (remove of single character key).
+ */
+#define JCON_CONFIGSYNC_ENTRY_MIN 7
+
+/**
+ * @brief Message types.
+ */
+#define JCON_CONFIGSYNC_TYPE_HELLO 'H'
+#define JCON_CONFIGSYNC_TYPE_DELTA 'D'
+#define JCON_CONFIGSYNC_TYPE_FULL 'F'
+
+/**
+ * @brief Entry operations.
+ */
+#define JCON_CONFIGSYNC_OP_SET 'S'
+#define JCON_CONFIGSYNC_OP_REMOVE 'R'
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Published version kept for reconnecting replicas.
+ */
+typedef struct __jcon_configSync_delta
+{
+  uint64_t base;            /**< Version, the delta applies to. */
+  uint64_t version;         /**< Version after delta. */
+  jutil_buffer_t *message;  /**< Encoded message with length prefix. */
+} jcon_configSync_delta_t;
+
+/**
+ * @brief Connection of primary to replica.
+ */
+typedef struct __jcon_configSync_replica
+{
+  jcon_frame_t *frame;  /**< Reads HELLO messages. Only used by loop thread. */
+  int subscribed;       /**< @c true , after HELLO was recieved. */
+  int synced;           /**< @c true , if @c version is a version of this primary. */
+  uint64_t version;     /**< Version, that was queued last for replica. */
+} jcon_configSync_replica_t;
+
+/**
+ * @brief Builds entries of message.
+ */
+typedef struct __jcon_configSync_writer
+{
+  jutil_buffer_t *buffer; /**< Entries. */
+  int failed;             /**< @c true , if entry could not be written. */
+} jcon_configSync_writer_t;
+
+/**
+ * @brief Reads fields of recieved message.
+ */
+typedef struct __jcon_configSync_reader
+{
+  const uint8_t *data;  /**< Message. */
+  size_t size;          /**< Size of message. */
+  size_t offset;        /**< Bytes already read. */
+  int failed;           /**< @c true , if message is truncated or invalid. */
+} jcon_configSync_reader_t;
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+struct __jcon_configSync_session
+{
+  int primary;                        /**< @c true for primaries, @c false for replicas. */
+  jconfig_t *table;                   /**< Served or written table. */
+  jcon_configSync_options_t options;  /**< Settings with defaults applied. */
+  jlog_t *logger;                     /**< Logger for debug and error messages. */
+  jutil_thread_t *thread;             /**< Publishes (primary) or recieves (replica). */
+
+  _Atomic uint64_t version;           /**< Version published or recieved last. */
+  uint64_t epoch;                     /**< Epoch of primary. @c 0 , if replica did not recieve table. */
+
+  jcon_system_t *system;              /**< Connections of primary. */
+  pthread_mutex_t mutex;              /**< Protects fields of primary below. */
+  jconfig_snapshot_t *snapshot;       /**< Last published version. */
+  jcon_configSync_delta_t *history;   /**< Ring of last published deltas. */
+  size_t history_start;               /**< Index of oldest delta. */
+  size_t history_number;              /**< Number of deltas in ring. */
+  jutil_buffer_t *full;               /**< Cached FULL message of last version. */
+  jutil_map_t *replicas;              /**< Replicas by reference string. */
+  atomic_size_t replica_number;       /**< Number of subscribed replicas. */
+
+  jcon_client_t *client;              /**< Connection of replica to primary. */
+  jcon_frame_t *frame;                /**< Reads messages of current connection. */
+  int connected;                      /**< @c true , if HELLO was sent on current connection. */
+  unsigned long long reconnect_at;    /**< Time of next connection attempt in milliseconds. */
+  long reconnect_wait;                /**< Current backoff in milliseconds. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Allocates session and applies defaults of options.
+ * 
+ * @param table   Config table.
+ * @param options Settings or @c NULL .
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        Session object.
+ * @return        @c NULL , if error occured.
+ */
+static jcon_configSync_t *jcon_configSync_allocate(jconfig_t *table, const jcon_configSync_options_t *options, jlog_t *logger);
+
+/**
+ * @brief Loop function of primary. Publishes new versions.
+ * 
+ * @param ctx           Session object.
+ * @param thread_session Thread, that runs function.
+ * 
+ * @return              @c true , to keep running.
+ */
+static int jcon_configSync_primary_function(void *ctx, jutil_thread_t *thread_session);
+
+/**
+ * @brief Handles data of replica. Called by event loop.
+ * 
+ * @param ctx     Session object.
+ * @param client  Connection to replica.
+ */
+static void jcon_configSync_primary_data(void *ctx, jcon_client_t *client);
+
+/**
+ * @brief Removes replica, when connection closes. Called by event loop.
+ * 
+ * @param ctx         Session object.
+ * @param ref_string  Reference string of connection.
+ */
+static void jcon_configSync_primary_close(void *ctx, const char *ref_string);
+
+/**
+ * @brief Handles HELLO message of replica.
+ * 
+ * @param ctx         Session object.
+ * @param client      Connection to replica.
+ * @param frame_ptr   Message.
+ * @param frame_size  Size of message.
+ */
+static void jcon_configSync_primary_hello(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size);
+
+/**
+ * @brief Publishes new version, if table changed.
+ * 
+ * Mutex has to be locked.
+ * 
+ * @param session Primary session.
+ * 
+ * @return        Number of changed keys.
+ */
+static size_t jcon_configSync_primary_advance(jcon_configSync_t *session);
+
+/**
+ * @brief Queues messages, that replica misses to the current version.
+ * 
+ * Sends the deltas since the version of the replica, or the
+ * whole table, if they are not kept. Stops at the first message,
+ * the queue refuses. Mutex has to be locked.
+ * 
+ * @param session     Primary session.
+ * @param ref_string  Reference string of connection.
+ * @param replica     Replica to update.
+ */
+static void jcon_configSync_primary_update(jcon_configSync_t *session, const char *ref_string, jcon_configSync_replica_t *replica);
+
+/**
+ * @brief Returns FULL message of current version.
+ * 
+ * Encoded on first use after a version is published.
+ * Mutex has to be locked.
+ * 
+ * @param session Primary session.
+ * 
+ * @return        Message, owned by session.
+ * @return        @c NULL , if error occured.
+ */
+static jutil_buffer_t *jcon_configSync_primary_getFull(jcon_configSync_t *session);
+
+/**
+ * @brief Frees all deltas of history.
+ * 
+ * @param session Primary session.
+ */
+static void jcon_configSync_primary_clearHistory(jcon_configSync_t *session);
+
+/**
+ * @brief Adds header to encoded entries.
+ * 
+ * @param session Primary session.
+ * @param type    @c JCON_CONFIGSYNC_TYPE_DELTA or @c JCON_CONFIGSYNC_TYPE_FULL .
+ * @param base    Version, the delta applies to. Ignored for FULL.
+ * @param version Version of message.
+ * @param entries Encoded entries. Freed by caller.
+ * @param count   Number of entries.
+ * 
+ * @return        Message with length prefix.
+ * @return        @c NULL , if message exceeds @c frame_max or error occured.
+ */
+static jutil_buffer_t *jcon_configSync_message(jcon_configSync_t *session, int type, uint64_t base, uint64_t version, jutil_buffer_t *entries, size_t count);
+
+/**
+ * @brief Encodes changed key as entry. Used as diff handler.
+ * 
+ * @param ctx       Writer.
+ * @param change    Type of change.
+ * @param key       Changed key.
+ * @param old_value Previous value.
+ * @param new_value New value.
+ */
+static void jcon_configSync_encode(void *ctx, int change, const char *key, const char *old_value, const char *new_value);
+
+/**
+ * @brief Loop function of replica. Connects and recieves messages.
+ * 
+ * @param ctx           Session object.
+ * @param thread_session Thread, that runs function.
+ * 
+ * @return              @c true , to keep running.
+ */
+static int jcon_configSync_replica_function(void *ctx, jutil_thread_t *thread_session);
+
+/**
+ * @brief Connects to primary and sends HELLO.
+ * 
+ * @param session Replica session.
+ * 
+ * @return        @c true , if subscribed.
+ * @return        @c false , if connection failed.
+ */
+static int jcon_configSync_replica_connect(jcon_configSync_t *session);
+
+/**
+ * @brief Handles message of primary.
+ * 
+ * @param ctx         Session object.
+ * @param client      Connection to primary.
+ * @param frame_ptr   Message.
+ * @param frame_size  Size of message.
+ */
+static void jcon_configSync_replica_message(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size);
+
+/**
+ * @brief Replaces table with entries of FULL message.
+ * 
+ * @param session Replica session.
+ * @param reader  Reader positioned at first entry.
+ * @param count   Number of entries.
+ * 
+ * @return        @c true , if table was replaced.
+ * @return        @c false , if message is invalid or error occured.
+ */
+static int jcon_configSync_replica_applyFull(jcon_configSync_t *session, jcon_configSync_reader_t *reader, size_t count);
+
+/**
+ * @brief Applies entries of DELTA message to table.
+ * 
+ * Watchers of the table are called for every changed key.
+ * 
+ * @param session Replica session.
+ * @param reader  Reader positioned at first entry.
+ * @param count   Number of entries.
+ * 
+ * @return        @c true , if delta was applied.
+ * @return        @c false , if message is invalid or error occured.
+ */
+static int jcon_configSync_replica_applyDelta(jcon_configSync_t *session, jcon_configSync_reader_t *reader, size_t count);
+
+/**
+ * @brief Stores number in big endian byte order.
+ * 
+ * @param dest  Destination.
+ * @param value Number to store.
+ * @param bytes Size of number in bytes.
+ */
+static void jcon_configSync_putUint(uint8_t *dest, uint64_t value, size_t bytes);
+
+/**
+ * @brief Reads number in big endian byte order.
+ * 
+ * @param reader  Reader of message.
+ * @param bytes   Size of number in bytes.
+ * 
+ * @return        Number.
+ * @return        @c 0 , if message is truncated.
+ */
+static uint64_t jcon_configSync_readUint(jcon_configSync_reader_t *reader, size_t bytes);
+
+/**
+ * @brief Reads terminated string.
+ * 
+ * @param reader  Reader of message.
+ * 
+ * @return        String in message.
+ * @return        @c NULL , if message is truncated or invalid.
+ */
+static const char *jcon_configSync_readString(jcon_configSync_reader_t *reader);
+
+/**
+ * @brief Sends log messages to logger of session.
+ * 
+ * @param session   Session object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jcon_configSync_log(jcon_configSync_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_configSync_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_configSync_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_configSync_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_configSync_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_configSync_t *jcon_configSync_primary_init(jcon_server_t *server, jconfig_t *table, const jcon_configSync_options_t *options, jlog_t *logger)
+{
+  if(server == NULL)
+  {
+    ERROR(NULL, "Server is NULL.");
+    return NULL;
+  }
+
+  jcon_configSync_t *session = jcon_configSync_allocate(table, options, logger);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  session->primary = true;
+  session->epoch = jutil_hash_getRandomSeed() ^ jutil_time_getNanos();
+  if(session->epoch == 0)
+  {
+    session->epoch = 1;
+  }
+
+  session->history = (jcon_configSync_delta_t *)JUTIL_ALLOC_CALLOC(session->options.history, sizeof(jcon_configSync_delta_t));
+  session->replicas = jutil_map_init();
+  if(session->history == NULL || session->replicas == NULL)
+  {
+    ERROR(session, "Could not allocate history or replicas. Destroying session.");
+    jutil_map_free(session->replicas);
+    JUTIL_ALLOC_FREE(session->history);
+    pthread_mutex_destroy(&session->mutex);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(table->snapshots == NULL && jconfig_snapshot_enable(table) == false)
+  {
+    ERROR(session, "Could not enable snapshots of table. Destroying session.");
+    jutil_map_free(session->replicas);
+    JUTIL_ALLOC_FREE(session->history);
+    pthread_mutex_destroy(&session->mutex);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->snapshot = jconfig_snapshot(table);
+  atomic_store(&session->version, jconfig_snapshot_getVersion(session->snapshot));
+
+  /* Handlers can run before the system is returned, they wait for the mutex. */
+  pthread_mutex_lock(&session->mutex);
+  session->system = jcon_system_eventLoop_init
+  (
+    server,
+    1,
+    &jcon_configSync_primary_data,
+    NULL,
+    &jcon_configSync_primary_close,
+    logger,
+    session
+  );
+  pthread_mutex_unlock(&session->mutex);
+
+  if(session->system == NULL)
+  {
+    ERROR(session, "Could not start event loop. Destroying session.");
+    jconfig_snapshot_release(session->snapshot);
+    jutil_map_free(session->replicas);
+    JUTIL_ALLOC_FREE(session->history);
+    pthread_mutex_destroy(&session->mutex);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->thread = jutil_thread_init
+  (
+    &jcon_configSync_primary_function,
+    logger,
+    session->options.publish_interval / 1000,
+    (session->options.publish_interval % 1000) * JCON_CONFIGSYNC_NSECS_PER_MSEC,
+    session
+  );
+  if(session->thread == NULL || jutil_thread_start(session->thread) == false)
+  {
+    ERROR(session, "Could not start publish thread. Destroying session.");
+    jutil_thread_free(session->thread);
+    session->thread = NULL;
+    jcon_configSync_free(session);
+    return NULL;
+  }
+
+  DEBUG(session, "Primary started with epoch [%016" PRIx64 "] at version [%" PRIu64 "].", session->epoch, atomic_load(&session->version));
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_configSync_t *jcon_configSync_replica_init(jcon_client_t *client, jconfig_t *table, const jcon_configSync_options_t *options, jlog_t *logger)
+{
+  if(client == NULL)
+  {
+    ERROR(NULL, "Client is NULL.");
+    return NULL;
+  }
+
+  jcon_configSync_t *session = jcon_configSync_allocate(table, options, logger);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  session->primary = false;
+  session->client = client;
+  session->reconnect_wait = session->options.reconnect_min;
+  session->reconnect_at = 0;
+
+  session->thread = jutil_thread_init
+  (
+    &jcon_configSync_replica_function,
+    logger,
+    0,
+    JCON_CONFIGSYNC_REPLICA_SLEEP * JCON_CONFIGSYNC_NSECS_PER_MSEC,
+    session
+  );
+  if(session->thread == NULL || jutil_thread_start(session->thread) == false)
+  {
+    ERROR(session, "Could not start replica thread. Destroying session.");
+    jutil_thread_free(session->thread);
+    pthread_mutex_destroy(&session->mutex);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_free(jcon_configSync_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(session->thread)
+  {
+    jutil_thread_free(session->thread);
+  }
+
+  if(session->primary)
+  {
+    /* Event loop does not call close handlers, while connections are cleared. */
+    jcon_system_free(session->system);
+
+    jutil_map_data_t *itr = NULL;
+    while((itr = jutil_map_iterate(session->replicas, itr)) != NULL)
+    {
+      jcon_configSync_replica_t *replica = (jcon_configSync_replica_t *)itr->data;
+      jcon_frame_free(replica->frame);
+      JUTIL_ALLOC_FREE(replica);
+    }
+    jutil_map_free(session->replicas);
+
+    jcon_configSync_primary_clearHistory(session);
+    JUTIL_ALLOC_FREE(session->history);
+    jutil_buffer_free(session->full);
+    jconfig_snapshot_release(session->snapshot);
+  }
+  else
+  {
+    jcon_frame_free(session->frame);
+    if(jcon_client_isConnected(session->client))
+    {
+      jcon_client_close(session->client);
+    }
+  }
+
+  pthread_mutex_destroy(&session->mutex);
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_configSync_publish(jcon_configSync_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+  if(session->primary == false)
+  {
+    ERROR(session, "Only primaries publish.");
+    return 0;
+  }
+
+  pthread_mutex_lock(&session->mutex);
+
+  size_t count = jcon_configSync_primary_advance(session);
+
+  jutil_map_data_t *itr = NULL;
+  while((itr = jutil_map_iterate(session->replicas, itr)) != NULL)
+  {
+    jcon_configSync_primary_update(session, itr->index, (jcon_configSync_replica_t *)itr->data);
+  }
+
+  pthread_mutex_unlock(&session->mutex);
+  return count;
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jcon_configSync_getVersion(jcon_configSync_t *session)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  return atomic_load(&session->version);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_configSync_getReplicas(jcon_configSync_t *session)
+{
+  if(session == NULL || session->primary == false)
+  {
+    return 0;
+  }
+
+  return atomic_load(&session->replica_number);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_configSync_t *jcon_configSync_allocate(jconfig_t *table, const jcon_configSync_options_t *options, jlog_t *logger)
+{
+  if(table == NULL)
+  {
+    ERROR(NULL, "Table is NULL.");
+    return NULL;
+  }
+  if(options && (options->publish_interval < 0 || options->reconnect_min < 0 || options->reconnect_max < 0))
+  {
+    ERROR(NULL, "Invalid publish interval [%ld ms] or reconnect wait [%ld ms - %ld ms].", options->publish_interval, options->reconnect_min, options->reconnect_max);
+    return NULL;
+  }
+  if(options && options->frame_max > UINT32_MAX)
+  {
+    ERROR(NULL, "Maximum message size [%zu] does not fit in length prefix.", options->frame_max);
+    return NULL;
+  }
+
+  jcon_configSync_t *session = (jcon_configSync_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_configSync_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "calloc() failed.");
+    return NULL;
+  }
+
+  if(options)
+  {
+    session->options = *options;
+  }
+  if(session->options.history == 0)
+  {
+    session->options.history = JCON_CONFIGSYNC_HISTORY_DEFAULT;
+  }
+  if(session->options.publish_interval == 0)
+  {
+    session->options.publish_interval = JCON_CONFIGSYNC_PUBLISHINTERVAL_DEFAULT;
+  }
+  if(session->options.frame_max == 0)
+  {
+    session->options.frame_max = JCON_CONFIGSYNC_FRAMEMAX_DEFAULT;
+  }
+  if(session->options.reconnect_min == 0)
+  {
+    session->options.reconnect_min = JCON_CONFIGSYNC_RECONNECTMIN_DEFAULT;
+  }
+  if(session->options.reconnect_max == 0)
+  {
+    session->options.reconnect_max = JCON_CONFIGSYNC_RECONNECTMAX_DEFAULT;
+  }
+  if(session->options.reconnect_max < session->options.reconnect_min)
+  {
+    session->options.reconnect_max = session->options.reconnect_min;
+  }
+
+  session->table = table;
+  session->logger = logger;
+  atomic_init(&session->version, 0);
+  atomic_init(&session->replica_number, 0);
+  pthread_mutex_init(&session->mutex, NULL);
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_configSync_primary_function(void *ctx, jutil_thread_t *thread_session)
+{
+  jcon_configSync_publish((jcon_configSync_t *)ctx);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_primary_data(void *ctx, jcon_client_t *client)
+{
+  jcon_configSync_t *session = (jcon_configSync_t *)ctx;
+  const char *ref_string = jcon_client_getReferenceString(client);
+
+  pthread_mutex_lock(&session->mutex);
+
+  jcon_configSync_replica_t *replica = (jcon_configSync_replica_t *)jutil_map_get(session->replicas, ref_string);
+  if(replica == NULL)
+  {
+    replica = (jcon_configSync_replica_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_configSync_replica_t));
+    if(replica)
+    {
+      /* Replicas only send HELLO, so larger frames are errors. */
+      replica->frame = jcon_frame_lengthPrefix_init(client, JCON_CONFIGSYNC_PREFIX_SIZE, JCON_CONFIGSYNC_HELLO_SIZE, &jcon_configSync_primary_hello, session->logger, session);
+    }
+    if(replica == NULL || replica->frame == NULL || jutil_map_add(session->replicas, ref_string, replica) == false)
+    {
+      ERROR(session, "Could not add replica [%s]. Closing connection.", ref_string);
+      if(replica)
+      {
+        jcon_frame_free(replica->frame);
+        JUTIL_ALLOC_FREE(replica);
+      }
+      pthread_mutex_unlock(&session->mutex);
+      jcon_client_close(client);
+      return;
+    }
+  }
+
+  pthread_mutex_unlock(&session->mutex);
+
+  /* Frame is only used by loop thread, HELLO handler locks itself. */
+  if(jcon_frame_process(replica->frame) < 0)
+  {
+    DEBUG(session, "Could not read from replica [%s]. Closing connection.", ref_string);
+    jcon_client_close(client);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_primary_close(void *ctx, const char *ref_string)
+{
+  jcon_configSync_t *session = (jcon_configSync_t *)ctx;
+
+  pthread_mutex_lock(&session->mutex);
+  jcon_configSync_replica_t *replica = (jcon_configSync_replica_t *)jutil_map_remove(session->replicas, ref_string);
+  if(replica && replica->subscribed)
+  {
+    atomic_fetch_sub(&session->replica_number, 1);
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  if(replica)
+  {
+    DEBUG(session, "Replica [%s] disconnected at version [%" PRIu64 "].", ref_string, replica->version);
+    jcon_frame_free(replica->frame);
+    JUTIL_ALLOC_FREE(replica);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_primary_hello(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size)
+{
+  jcon_configSync_t *session = (jcon_configSync_t *)ctx;
+  const char *ref_string = jcon_client_getReferenceString(client);
+
+  jcon_configSync_reader_t reader = {(const uint8_t *)frame_ptr, frame_size, 0, false};
+  int type = (int)jcon_configSync_readUint(&reader, 1);
+  uint64_t epoch = jcon_configSync_readUint(&reader, 8);
+  uint64_t version = jcon_configSync_readUint(&reader, 8);
+
+  if(reader.failed || reader.offset != reader.size || type != JCON_CONFIGSYNC_TYPE_HELLO)
+  {
+    WARN(session, "Invalid message from replica [%s]. Closing connection.", ref_string);
+    jcon_client_close(client);
+    return;
+  }
+
+  pthread_mutex_lock(&session->mutex);
+
+  jcon_configSync_replica_t *replica = (jcon_configSync_replica_t *)jutil_map_get(session->replicas, ref_string);
+  if(replica && replica->subscribed == false)
+  {
+    replica->subscribed = true;
+    replica->synced = (epoch == session->epoch);
+    replica->version = version;
+    atomic_fetch_add(&session->replica_number, 1);
+
+    DEBUG(session, "Replica [%s] subscribed at version [%" PRIu64 "]%s.", ref_string, version, (replica->synced ? "" : " of other epoch"));
+    jcon_configSync_primary_update(session, ref_string, replica);
+  }
+
+  pthread_mutex_unlock(&session->mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_configSync_primary_advance(jcon_configSync_t *session)
+{
+  jconfig_snapshot_t *snapshot = jconfig_snapshot(session->table);
+  if(snapshot == NULL)
+  {
+    ERROR(session, "Could not take snapshot of table.");
+    return 0;
+  }
+  if(jconfig_snapshot_getVersion(snapshot) == jconfig_snapshot_getVersion(session->snapshot))
+  {
+    jconfig_snapshot_release(snapshot);
+    return 0;
+  }
+
+  jcon_configSync_writer_t writer = {jutil_buffer_init(0), false};
+  if(writer.buffer == NULL)
+  {
+    ERROR(session, "Could not allocate delta.");
+    jconfig_snapshot_release(snapshot);
+    return 0;
+  }
+
+  size_t count = jconfig_snapshot_diff(session->snapshot, snapshot, &jcon_configSync_encode, &writer);
+  if(count == 0)
+  {
+    /* Keys were set to the values they had, replicas are still current. */
+    jutil_buffer_free(writer.buffer);
+    jconfig_snapshot_release(snapshot);
+    return 0;
+  }
+
+  uint64_t base = jconfig_snapshot_getVersion(session->snapshot);
+  uint64_t version = jconfig_snapshot_getVersion(snapshot);
+
+  jutil_buffer_t *message = NULL;
+  if(writer.failed == false)
+  {
+    message = jcon_configSync_message(session, JCON_CONFIGSYNC_TYPE_DELTA, base, version, writer.buffer, count);
+  }
+  jutil_buffer_free(writer.buffer);
+
+  if(message == NULL)
+  {
+    /* Without the delta, the chain is broken, so everyone gets the whole table. */
+    ERROR(session, "Could not encode delta to version [%" PRIu64 "]. Replicas get whole table.", version);
+    jcon_configSync_primary_clearHistory(session);
+  }
+  else
+  {
+    if(session->history_number == session->options.history)
+    {
+      jutil_buffer_free(session->history[session->history_start].message);
+      session->history_start = (session->history_start + 1) % session->options.history;
+      session->history_number--;
+    }
+
+    jcon_configSync_delta_t *delta = &session->history[(session->history_start + session->history_number) % session->options.history];
+    delta->base = base;
+    delta->version = version;
+    delta->message = message;
+    session->history_number++;
+  }
+
+  jconfig_snapshot_release(session->snapshot);
+  session->snapshot = snapshot;
+  jutil_buffer_free(session->full);
+  session->full = NULL;
+  atomic_store(&session->version, version);
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_configSync_versions_total", "Config versions published by primaries.", 1);
+  DEBUG(session, "Published version [%" PRIu64 "] with [%zu] changed keys.", version, count);
+  return count;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_primary_update(jcon_configSync_t *session, const char *ref_string, jcon_configSync_replica_t *replica)
+{
+  uint64_t version = atomic_load(&session->version);
+
+  if(replica->subscribed == false || (replica->synced && replica->version == version))
+  {
+    return;
+  }
+
+  if(replica->synced)
+  {
+    size_t i;
+    for(i = 0; i < session->history_number; i++)
+    {
+      if(session->history[(session->history_start + i) % session->options.history].base == replica->version)
+      {
+        break;
+      }
+    }
+
+    if(i < session->history_number)
+    {
+      for(; i < session->history_number; i++)
+      {
+        jcon_configSync_delta_t *delta = &session->history[(session->history_start + i) % session->options.history];
+        if(jcon_system_sendBuffer(session->system, ref_string, delta->message) == false)
+        {
+          /* Queue is full, the rest is sent on the next check. */
+          return;
+        }
+        replica->version = delta->version;
+      }
+      return;
+    }
+  }
+
+  jutil_buffer_t *full = jcon_configSync_primary_getFull(session);
+  if(full == NULL || jcon_system_sendBuffer(session->system, ref_string, full) == false)
+  {
+    return;
+  }
+
+  replica->synced = true;
+  replica->version = version;
+  JUTIL_METRICS_COUNTER_ADD("jcon_configSync_full_total", "Whole tables sent to replicas, that were too far behind.", 1);
+  DEBUG(session, "Sent whole table of version [%" PRIu64 "] to replica [%s].", version, ref_string);
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jcon_configSync_primary_getFull(jcon_configSync_t *session)
+{
+  if(session->full)
+  {
+    return session->full;
+  }
+
+  jcon_configSync_writer_t writer = {jutil_buffer_init(0), false};
+  if(writer.buffer == NULL)
+  {
+    ERROR(session, "Could not allocate table message.");
+    return NULL;
+  }
+
+  size_t count = jconfig_snapshot_diff(NULL, session->snapshot, &jcon_configSync_encode, &writer);
+  if(writer.failed == false)
+  {
+    session->full = jcon_configSync_message(session, JCON_CONFIGSYNC_TYPE_FULL, 0, jconfig_snapshot_getVersion(session->snapshot), writer.buffer, count);
+  }
+  jutil_buffer_free(writer.buffer);
+
+  if(session->full == NULL)
+  {
+    ERROR(session, "Could not encode table with [%zu] keys.", count);
+  }
+
+  return session->full;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_primary_clearHistory(jcon_configSync_t *session)
+{
+  size_t i;
+  for(i = 0; i < session->history_number; i++)
+  {
+    jutil_buffer_free(session->history[(session->history_start + i) % session->options.history].message);
+  }
+
+  session->history_start = 0;
+  session->history_number = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jcon_configSync_message(jcon_configSync_t *session, int type, uint64_t base, uint64_t version, jutil_buffer_t *entries, size_t count)
+{
+  uint8_t header[JCON_CONFIGSYNC_HEADER_MAX];
+  size_t header_size = JCON_CONFIGSYNC_PREFIX_SIZE;
+
+  header[header_size++] = (uint8_t)type;
+  jcon_configSync_putUint(header + header_size, session->epoch, 8);
+  header_size += 8;
+  if(type == JCON_CONFIGSYNC_TYPE_DELTA)
+  {
+    jcon_configSync_putUint(header + header_size, base, 8);
+    header_size += 8;
+  }
+  jcon_configSync_putUint(header + header_size, version, 8);
+  header_size += 8;
+  jcon_configSync_putUint(header + header_size, count, 4);
+  header_size += 4;
+
+  size_t frame_size = header_size - JCON_CONFIGSYNC_PREFIX_SIZE + jutil_buffer_getSize(entries);
+  if(frame_size > session->options.frame_max || count > UINT32_MAX)
+  {
+    ERROR(session, "Message of [%zu] bytes exceeds maximum of [%zu] bytes.", frame_size, session->options.frame_max);
+    return NULL;
+  }
+  jcon_configSync_putUint(header, frame_size, JCON_CONFIGSYNC_PREFIX_SIZE);
+
+  jutil_buffer_t *message = jutil_buffer_copy_init(header, header_size);
+  if(message == NULL || jutil_buffer_appendBuffer(message, entries) == false)
+  {
+    jutil_buffer_free(message);
+    return NULL;
+  }
+
+  return message;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_encode(void *ctx, int change, const char *key, const char *old_value, const char *new_value)
+{
+  jcon_configSync_writer_t *writer = (jcon_configSync_writer_t *)ctx;
+  if(writer->failed)
+  {
+    return;
+  }
+
+  uint8_t header[5];
+  size_t key_length = strlen(key);
+  size_t value_length = (new_value ? strlen(new_value) : 0);
+  if(key_length > UINT32_MAX || value_length > UINT32_MAX)
+  {
+    writer->failed = true;
+    return;
+  }
+
+  header[0] = (change == JCONFIG_CHANGE_REMOVED ? JCON_CONFIGSYNC_OP_REMOVE : JCON_CONFIGSYNC_OP_SET);
+  jcon_configSync_putUint(header + 1, key_length, 4);
+  if(jutil_buffer_append(writer->buffer, header, sizeof(header)) == false || jutil_buffer_append(writer->buffer, key, key_length + 1) == false)
+  {
+    writer->failed = true;
+    return;
+  }
+
+  if(change != JCONFIG_CHANGE_REMOVED)
+  {
+    jcon_configSync_putUint(header, value_length, 4);
+    if(jutil_buffer_append(writer->buffer, header, 4) == false || jutil_buffer_append(writer->buffer, new_value, value_length + 1) == false)
+    {
+      writer->failed = true;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_configSync_replica_function(void *ctx, jutil_thread_t *thread_session)
+{
+  jcon_configSync_t *session = (jcon_configSync_t *)ctx;
+
+  if(session->connected && jcon_client_isConnected(session->client) == false)
+  {
+    WARN(session, "Lost connection to primary at version [%" PRIu64 "].", atomic_load(&session->version));
+    session->connected = false;
+    session->reconnect_wait = session->options.reconnect_min;
+    session->reconnect_at = jutil_time_getCoarseMillis() + (unsigned long long)session->reconnect_wait;
+  }
+
+  if(session->connected == false)
+  {
+    unsigned long long now = jutil_time_getCoarseMillis();
+    if(now < session->reconnect_at)
+    {
+      return true;
+    }
+
+    if(jcon_configSync_replica_connect(session) == false)
+    {
+      DEBUG(session, "Could not connect to primary. Retrying in [%ld ms].", session->reconnect_wait);
+      session->reconnect_at = now + (unsigned long long)session->reconnect_wait;
+      session->reconnect_wait *= 2;
+      if(session->reconnect_wait > session->options.reconnect_max)
+      {
+        session->reconnect_wait = session->options.reconnect_max;
+      }
+      return true;
+    }
+  }
+
+  /* Large tables arrive in many reads, so everything available is read at once. */
+  while(jutil_thread_isRunning(thread_session) && jcon_client_isConnected(session->client) && jcon_client_newData(session->client))
+  {
+    if(jcon_frame_process(session->frame) < 0)
+    {
+      jcon_client_close(session->client);
+      break;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_configSync_replica_connect(jcon_configSync_t *session)
+{
+  if(jcon_client_reset(session->client) == false || jcon_client_isConnected(session->client) == false)
+  {
+    return false;
+  }
+
+  /* Data of the previous connection is discarded with the frame. */
+  jcon_frame_free(session->frame);
+  session->frame = jcon_frame_lengthPrefix_init(session->client, JCON_CONFIGSYNC_PREFIX_SIZE, session->options.frame_max, &jcon_configSync_replica_message, session->logger, session);
+  if(session->frame == NULL)
+  {
+    jcon_client_close(session->client);
+    return false;
+  }
+
+  uint8_t hello[JCON_CONFIGSYNC_HELLO_SIZE];
+  hello[0] = JCON_CONFIGSYNC_TYPE_HELLO;
+  jcon_configSync_putUint(hello + 1, session->epoch, 8);
+  jcon_configSync_putUint(hello + 9, atomic_load(&session->version), 8);
+  if(jcon_frame_send(session->frame, hello, sizeof(hello)) == false)
+  {
+    jcon_client_close(session->client);
+    return false;
+  }
+
+  INFO(session, "Subscribed to primary [%s] at version [%" PRIu64 "].", jcon_client_getReferenceString(session->client), atomic_load(&session->version));
+  session->connected = true;
+  session->reconnect_wait = session->options.reconnect_min;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_replica_message(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size)
+{
+  jcon_configSync_t *session = (jcon_configSync_t *)ctx;
+  if(jcon_client_isConnected(client) == false)
+  {
+    /* Connection was closed by previous message of same read. */
+    return;
+  }
+
+  jcon_configSync_reader_t reader = {(const uint8_t *)frame_ptr, frame_size, 0, false};
+  int type = (int)jcon_configSync_readUint(&reader, 1);
+  uint64_t epoch = jcon_configSync_readUint(&reader, 8);
+  uint64_t base = 0;
+  if(type == JCON_CONFIGSYNC_TYPE_DELTA)
+  {
+    base = jcon_configSync_readUint(&reader, 8);
+  }
+  uint64_t version = jcon_configSync_readUint(&reader, 8);
+  size_t count = (size_t)jcon_configSync_readUint(&reader, 4);
+
+  if(reader.failed || (type != JCON_CONFIGSYNC_TYPE_DELTA && type != JCON_CONFIGSYNC_TYPE_FULL) || count > (reader.size - reader.offset) / JCON_CONFIGSYNC_ENTRY_MIN)
+  {
+    ERROR(session, "Invalid message from primary. Closing connection.");
+    jcon_client_close(client);
+    return;
+  }
+
+  if(type == JCON_CONFIGSYNC_TYPE_DELTA && (epoch != session->epoch || base != atomic_load(&session->version)))
+  {
+    /* A delta was missed, subscribing again sends what is missing. */
+    WARN(session, "Delta from version [%" PRIu64 "] does not follow version [%" PRIu64 "]. Subscribing again.", base, atomic_load(&session->version));
+    jcon_client_close(client);
+    return;
+  }
+
+  int applied;
+  if(type == JCON_CONFIGSYNC_TYPE_FULL)
+  {
+    applied = jcon_configSync_replica_applyFull(session, &reader, count);
+  }
+  else
+  {
+    applied = jcon_configSync_replica_applyDelta(session, &reader, count);
+  }
+
+  if(applied == false)
+  {
+    ERROR(session, "Could not apply version [%" PRIu64 "] of primary. Closing connection.", version);
+    jcon_client_close(client);
+    return;
+  }
+
+  session->epoch = epoch;
+  atomic_store(&session->version, version);
+  JUTIL_METRICS_COUNTER_ADD("jcon_configSync_applied_total", "Config versions applied by replicas.", 1);
+  DEBUG(session, "Applied %s of version [%" PRIu64 "] with [%zu] keys.", (type == JCON_CONFIGSYNC_TYPE_FULL ? "table" : "delta"), version, count);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_configSync_replica_applyFull(jcon_configSync_t *session, jcon_configSync_reader_t *reader, size_t count)
+{
+  jconfig_t *source = jconfig_init();
+  if(source == NULL || jconfig_batch_begin(source, count) == false)
+  {
+    jconfig_free(source);
+    return false;
+  }
+
+  size_t i;
+  for(i = 0; i < count; i++)
+  {
+    int op = (int)jcon_configSync_readUint(reader, 1);
+    const char *key = jcon_configSync_readString(reader);
+    const char *value = jcon_configSync_readString(reader);
+    if(reader->failed || op != JCON_CONFIGSYNC_OP_SET || jconfig_batch_set(source, key, value) == false)
+    {
+      jconfig_free(source);
+      return false;
+    }
+  }
+
+  if(reader->offset != reader->size)
+  {
+    jconfig_free(source);
+    return false;
+  }
+
+  jconfig_batch_commit(source);
+  int ret = jconfig_reload(session->table, source);
+  jconfig_free(source);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_configSync_replica_applyDelta(jcon_configSync_t *session, jcon_configSync_reader_t *reader, size_t count)
+{
+  jconfig_t *table = session->table;
+
+  /* Snapshot is published once for the whole delta. */
+  if(jconfig_batch_begin(table, 0) == false)
+  {
+    return false;
+  }
+
+  size_t i;
+  for(i = 0; i < count && reader->failed == false; i++)
+  {
+    int op = (int)jcon_configSync_readUint(reader, 1);
+    const char *key = jcon_configSync_readString(reader);
+    const char *value = NULL;
+    if(op == JCON_CONFIGSYNC_OP_SET)
+    {
+      value = jcon_configSync_readString(reader);
+    }
+    else if(op != JCON_CONFIGSYNC_OP_REMOVE)
+    {
+      reader->failed = true;
+    }
+    if(reader->failed)
+    {
+      break;
+    }
+
+    const char *current = jconfig_datapoint_get(table, key);
+    if((value && current && strcmp(current, value) == 0) || (value == NULL && current == NULL))
+    {
+      continue;
+    }
+
+    /* Previous value is freed by the change, but watchers get it afterwards. */
+    char *old_value = NULL;
+    if(current)
+    {
+      size_t size = strlen(current) + 1;
+      old_value = (char *)JUTIL_ALLOC_MALLOC(size);
+      if(old_value == NULL)
+      {
+        reader->failed = true;
+        break;
+      }
+      memcpy(old_value, current, size);
+    }
+
+    int changed;
+    if(value)
+    {
+      changed = jconfig_datapoint_set(table, key, value);
+    }
+    else
+    {
+      changed = jconfig_datapoint_delete(table, key);
+    }
+
+    if(changed)
+    {
+      int change = (value == NULL ? JCONFIG_CHANGE_REMOVED : (old_value == NULL ? JCONFIG_CHANGE_ADDED : JCONFIG_CHANGE_CHANGED));
+      jconfig_watcher_notify(table, change, key, strlen(key), old_value, (value ? jconfig_datapoint_get(table, key) : NULL));
+    }
+    else
+    {
+      reader->failed = true;
+    }
+
+    JUTIL_ALLOC_FREE(old_value);
+  }
+
+  jconfig_batch_commit(table);
+  return (reader->failed == false && reader->offset == reader->size);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_putUint(uint8_t *dest, uint64_t value, size_t bytes)
+{
+  size_t i;
+  for(i = 0; i < bytes; i++)
+  {
+    dest[i] = (uint8_t)(value >> ((bytes - i - 1) * 8));
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jcon_configSync_readUint(jcon_configSync_reader_t *reader, size_t bytes)
+{
+  if(reader->failed || reader->size - reader->offset < bytes)
+  {
+    reader->failed = true;
+    return 0;
+  }
+
+  uint64_t value = 0;
+  size_t i;
+  for(i = 0; i < bytes; i++)
+  {
+    value = (value << 8) | reader->data[reader->offset + i];
+  }
+
+  reader->offset += bytes;
+  return value;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_configSync_readString(jcon_configSync_reader_t *reader)
+{
+  size_t length = (size_t)jcon_configSync_readUint(reader, 4);
+  if(reader->failed)
+  {
+    return NULL;
+  }
+
+  const char *string = (const char *)(reader->data + reader->offset);
+  if(reader->size - reader->offset <= length || string[length] != '\0' || memchr(string, '\0', length) != NULL)
+  {
+    reader->failed = true;
+    return NULL;
+  }
+
+  reader->offset += length + 1;
+  return string;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_configSync_log(jcon_configSync_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session && session->logger)
+  {
+    jlog_log_message_m(session->logger, log_type, file, function, line, "%s", buf);
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, "%s", buf);
+  }
+}
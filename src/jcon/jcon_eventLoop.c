@@ -0,0 +1,494 @@
+/**
+ * @file jcon_eventLoop.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_eventLoop using epoll.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_eventLoop.h>
+#include <jayc/jutil_alloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_eventLoop");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Maximum number of events handled per call of @c epoll_wait() .
+ */
+#define JCON_EVENTLOOP_EVENTS_MAX 64
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+struct __jcon_eventLoop_session
+{
+  int epoll_fd;                                         /**< Descriptor of epoll instance. */
+  jcon_eventLoop_watcher_t wakeup_watcher;              /**< Watcher for eventfd used by @c #jcon_eventLoop_wakeup() . */
+
+  struct epoll_event events[JCON_EVENTLOOP_EVENTS_MAX]; /**< Events returned by last @c epoll_wait() . */
+  int events_index;                                     /**< Index of event currently dispatched. */
+  int events_number;                                    /**< Number of events returned by last @c epoll_wait() . */
+
+  jlog_t *logger;                                       /**< Logger for debug and error messages. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Converts jcon_eventLoop event flags to epoll flags.
+ * 
+ * @param events  jcon_eventLoop event flags.
+ * 
+ * @return        epoll event flags.
+ */
+static uint32_t jcon_eventLoop_toEpoll(int events);
+
+/**
+ * @brief Converts epoll flags to jcon_eventLoop event flags.
+ * 
+ * @param events  epoll event flags.
+ * 
+ * @return        jcon_eventLoop event flags.
+ */
+static int jcon_eventLoop_fromEpoll(uint32_t events);
+
+/**
+ * @brief Handler for wakeup eventfd.
+ * 
+ * Resets counter of eventfd.
+ * 
+ * @param loop    Event loop session.
+ * @param watcher Wakeup watcher.
+ * @param events  Ready events.
+ */
+static void jcon_eventLoop_wakeup_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * Uses logger from @c session , or if logger is @c NULL , uses global logger.
+ * 
+ * @param session   Event loop session.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_eventLoop_log(jcon_eventLoop_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_eventLoop_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_eventLoop_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_eventLoop_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_eventLoop_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_eventLoop_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jcon_eventLoop_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_eventLoop_t *jcon_eventLoop_init(jlog_t *logger)
+{
+  jcon_eventLoop_t *session = (jcon_eventLoop_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_eventLoop_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->logger = logger;
+  session->events_index = 0;
+  session->events_number = 0;
+
+  session->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(session->epoll_fd < 0)
+  {
+    ERROR(NULL, "epoll_create1() failed [%d : %s]. Destroying session.", errno, strerror(errno));
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->wakeup_watcher.file_descriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(session->wakeup_watcher.file_descriptor < 0)
+  {
+    ERROR(session, "eventfd() failed [%d : %s]. Destroying session.", errno, strerror(errno));
+    close(session->epoll_fd);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->wakeup_watcher.events = JCON_EVENTLOOP_EVENT_READ;
+  session->wakeup_watcher.handler = &jcon_eventLoop_wakeup_handler;
+  session->wakeup_watcher.ctx = NULL;
+
+  if(jcon_eventLoop_add(session, &session->wakeup_watcher) == false)
+  {
+    ERROR(session, "jcon_eventLoop_add() failed. Destroying session.");
+    close(session->wakeup_watcher.file_descriptor);
+    close(session->epoll_fd);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_eventLoop_free(jcon_eventLoop_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(close(session->wakeup_watcher.file_descriptor) < 0)
+  {
+    ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+  }
+
+  if(close(session->epoll_fd) < 0)
+  {
+    ERROR(NULL, "close() failed [%d : %s].", errno, strerror(errno));
+  }
+
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_eventLoop_add(jcon_eventLoop_t *session, jcon_eventLoop_watcher_t *watcher)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(watcher == NULL)
+  {
+    ERROR(session, "Watcher is NULL.");
+    return false;
+  }
+
+  if(watcher->file_descriptor < 0)
+  {
+    ERROR(session, "Invalid file descriptor [%d].", watcher->file_descriptor);
+    return false;
+  }
+
+  struct epoll_event event;
+  event.events = jcon_eventLoop_toEpoll(watcher->events);
+  event.data.ptr = watcher;
+
+  if(epoll_ctl(session->epoll_fd, EPOLL_CTL_ADD, watcher->file_descriptor, &event) < 0)
+  {
+    ERROR(session, "epoll_ctl() failed for fd [%d] [%d : %s].", watcher->file_descriptor, errno, strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_eventLoop_modify(jcon_eventLoop_t *session, jcon_eventLoop_watcher_t *watcher, int events)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(watcher == NULL)
+  {
+    ERROR(session, "Watcher is NULL.");
+    return false;
+  }
+
+  if(events & JCON_EVENTLOOP_EVENT_EXCLUSIVE)
+  {
+    ERROR(session, "Exclusive flag can not be modified.");
+    return false;
+  }
+
+  struct epoll_event event;
+  event.events = jcon_eventLoop_toEpoll(events);
+  event.data.ptr = watcher;
+
+  if(epoll_ctl(session->epoll_fd, EPOLL_CTL_MOD, watcher->file_descriptor, &event) < 0)
+  {
+    ERROR(session, "epoll_ctl() failed for fd [%d] [%d : %s].", watcher->file_descriptor, errno, strerror(errno));
+    return false;
+  }
+
+  watcher->events = events;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_eventLoop_remove(jcon_eventLoop_t *session, jcon_eventLoop_watcher_t *watcher)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(watcher == NULL)
+  {
+    ERROR(session, "Watcher is NULL.");
+    return;
+  }
+
+  /* Closed descriptors are removed by the kernel. */
+  if(watcher->file_descriptor >= 0)
+  {
+    if(epoll_ctl(session->epoll_fd, EPOLL_CTL_DEL, watcher->file_descriptor, NULL) < 0)
+    {
+      if(errno != EBADF && errno != ENOENT)
+      {
+        ERROR(session, "epoll_ctl() failed for fd [%d] [%d : %s].", watcher->file_descriptor, errno, strerror(errno));
+      }
+    }
+  }
+
+  /* Discard events, that are still waiting for dispatch. */
+  int i;
+  for(i = session->events_index + 1; i < session->events_number; i++)
+  {
+    if(session->events[i].data.ptr == watcher)
+    {
+      session->events[i].data.ptr = NULL;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_eventLoop_run(jcon_eventLoop_t *session, int timeout)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  int ret_wait = epoll_wait(session->epoll_fd, session->events, JCON_EVENTLOOP_EVENTS_MAX, timeout);
+  if(ret_wait < 0)
+  {
+    if(errno == EINTR)
+    {
+      return 0;
+    }
+
+    ERROR(session, "epoll_wait() failed [%d : %s].", errno, strerror(errno));
+    return -1;
+  }
+
+  int dispatched = 0;
+  session->events_number = ret_wait;
+
+  for(session->events_index = 0; session->events_index < session->events_number; session->events_index++)
+  {
+    struct epoll_event *event = &session->events[session->events_index];
+    jcon_eventLoop_watcher_t *watcher = (jcon_eventLoop_watcher_t *)event->data.ptr;
+
+    if(watcher == NULL)
+    {
+      /* Watcher was removed by previous handler. */
+      continue;
+    }
+
+    if(watcher->handler)
+    {
+      watcher->handler(session, watcher, jcon_eventLoop_fromEpoll(event->events));
+      dispatched++;
+    }
+  }
+
+  session->events_index = 0;
+  session->events_number = 0;
+
+  return dispatched;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_eventLoop_wakeup(jcon_eventLoop_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  uint64_t value = 1;
+  if(write(session->wakeup_watcher.file_descriptor, &value, sizeof(value)) < 0)
+  {
+    /* EAGAIN means counter is saturated, loop will wake up anyways. */
+    if(errno != EAGAIN)
+    {
+      ERROR(session, "write() failed [%d : %s].", errno, strerror(errno));
+    }
+  }
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+uint32_t jcon_eventLoop_toEpoll(int events)
+{
+  uint32_t ret = 0;
+
+  if(events & JCON_EVENTLOOP_EVENT_READ)
+  {
+    ret |= EPOLLIN;
+  }
+  if(events & JCON_EVENTLOOP_EVENT_WRITE)
+  {
+    ret |= EPOLLOUT;
+  }
+  if(events & JCON_EVENTLOOP_EVENT_EXCLUSIVE)
+  {
+    ret |= EPOLLEXCLUSIVE;
+  }
+  if(events & JCON_EVENTLOOP_EVENT_ONESHOT)
+  {
+    ret |= EPOLLONESHOT;
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_eventLoop_fromEpoll(uint32_t events)
+{
+  int ret = 0;
+
+  if(events & EPOLLIN)
+  {
+    ret |= JCON_EVENTLOOP_EVENT_READ;
+  }
+  if(events & EPOLLOUT)
+  {
+    ret |= JCON_EVENTLOOP_EVENT_WRITE;
+  }
+  if(events & EPOLLHUP)
+  {
+    ret |= JCON_EVENTLOOP_EVENT_HANGUP;
+  }
+  if(events & EPOLLERR)
+  {
+    ret |= JCON_EVENTLOOP_EVENT_ERROR;
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_eventLoop_wakeup_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events)
+{
+  uint64_t value;
+  if(read(watcher->file_descriptor, &value, sizeof(value)) < 0)
+  {
+    if(errno != EAGAIN)
+    {
+      ERROR(loop, "read() failed [%d : %s].", errno, strerror(errno));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_eventLoop_log(jcon_eventLoop_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<epoll:%d> %s", session->epoll_fd, buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<epoll:%d> %s", session->epoll_fd, buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -0,0 +1,1234 @@
+/**
+ * @file jcon_frame.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_frame.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_frame.h>
+#include <jayc/jutil_lz4.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_frame");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Frames are prefixed by their length.
+ */
+#define JCON_FRAME_MODE_LENGTHPREFIX 0
+
+/**
+ * @brief Frames are terminated by delimiter.
+ */
+#define JCON_FRAME_MODE_DELIMITER 1
+
+/**
+ * @brief Maximum number of bytes read at once.
+ */
+#define JCON_FRAME_BUFFER_SIZE_DEFAULT JUTIL_BUFFER_BLOCKSIZE_DEFAULT
+
+/**
+ * @brief Number of segments sent with one call by @c #jcon_frame_sendBuffer() .
+ */
+#define JCON_FRAME_BUFFER_IOV 64
+
+/**
+ * @brief Maximum size of length prefix.
+ */
+#define JCON_FRAME_PREFIX_MAX 4
+
+/**
+ * @brief Size of header of compressed sessions (codec of frame).
+ */
+#define JCON_FRAME_COMPRESS_HEADER 1
+
+/**
+ * @brief Size of uncompressed length, that follows codec of compressed frames.
+ */
+#define JCON_FRAME_COMPRESS_LENGTH 4
+
+/**
+ * @brief Codec of frames, that offer codecs to peer.
+ */
+#define JCON_FRAME_COMPRESS_OFFER 0xFF
+
+/**
+ * @brief Default of @c jcon_frame_compression_t#threshold .
+ */
+#define JCON_FRAME_COMPRESS_THRESHOLD_DEFAULT 256
+
+/**
+ * @brief Codecs supported by library.
+ */
+#define JCON_FRAME_COMPRESS_SUPPORTED (1U << JCON_FRAME_COMPRESS_LZ4)
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+struct __jcon_frame_session
+{
+  jcon_client_t *client;        /**< Client to read frames from. */
+  int mode;                     /**< @c #JCON_FRAME_MODE_LENGTHPREFIX or @c #JCON_FRAME_MODE_DELIMITER . */
+
+  size_t prefix_size;           /**< Size of length prefix. */
+  uint8_t *delimiter;           /**< Copy of delimiter. */
+  size_t delimiter_size;        /**< Size of delimiter. */
+  size_t frame_max;             /**< Maximum size of frame data. */
+
+  jutil_buffer_t *buffer;       /**< Receive buffer. Holds unhandled data. */
+  size_t buffer_max;            /**< Size, the buffer may grow to. */
+  size_t search_offset;         /**< Position in buffer, where delimiter search continues. */
+
+  jcon_frame_handler_t handler; /**< Handler to call for every frame. */
+  jcon_frame_bufferHandler_t buffer_handler; /**< Handler to call with slices. @c NULL if not set. */
+  jlog_t *logger;               /**< Logger for debug and error messages. */
+  void *ctx;                    /**< Context pointer passed to handler. */
+  jutil_arena_t *arena;         /**< Arena reset after every frame. @c NULL if not set. */
+
+  int compress;                 /**< @c true , if frames have compression header. */
+  unsigned int compress_codecs; /**< Codecs offered to peer. */
+  int compress_codec;           /**< Codec used to send, agreed with peer. */
+  size_t compress_threshold;    /**< Smaller frames are sent uncompressed. */
+  jutil_lz4_t *lz4;             /**< LZ4 context, reused for every frame. */
+  uint8_t *send_buffer;         /**< Gathered and compressed data of sent frames. */
+  size_t send_capacity;         /**< Size of @c send_buffer . */
+  uint8_t *recv_buffer;         /**< Decompressed data of recieved frames. */
+  size_t recv_capacity;         /**< Size of @c recv_buffer . */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Allocates and initializes session.
+ * 
+ * Used by all init functions.
+ * 
+ * @param client    Client to read frames from.
+ * @param mode      Framing mode.
+ * @param frame_max Maximum size of frame data.
+ * @param handler   Handler to call for every frame.
+ * @param logger    Logger for debug and error messages.
+ * @param ctx       Context pointer passed to handler.
+ * 
+ * @return          Session object, without receive buffer.
+ * @return          @c NULL , if error occured.
+ */
+static jcon_frame_t *jcon_frame_allocate(jcon_client_t *client, int mode, size_t frame_max, jcon_frame_handler_t handler, jlog_t *logger, void *ctx);
+
+/**
+ * @brief Allocates receive buffer.
+ * 
+ * @param session Session to allocate buffer for.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_frame_allocateBuffer(jcon_frame_t *session);
+
+/**
+ * @brief Handles complete length prefixed frames in buffer.
+ * 
+ * @param session     Session with buffer.
+ * @param read_offset Set to end of handled data.
+ * 
+ * @return            Number of frames handled.
+ * @return            @c -1 , if frame exceeds maximum size.
+ * @return            @c -2 , if compressed frame is invalid.
+ */
+static int jcon_frame_parseLengthPrefix(jcon_frame_t *session, size_t *read_offset);
+
+/**
+ * @brief Handles complete delimiter terminated frames in buffer.
+ * 
+ * @param session     Session with buffer.
+ * @param read_offset Set to end of handled data.
+ * 
+ * @return            Number of frames handled.
+ * @return            @c -1 , if frame exceeds maximum size.
+ */
+static int jcon_frame_parseDelimiter(jcon_frame_t *session, size_t *read_offset);
+
+/**
+ * @brief Calls handler of session for frame.
+ * 
+ * Handles compression header, if compression is enabled.
+ * 
+ * @param session      Session with buffer.
+ * @param data         Start of buffered data.
+ * @param frame_offset Start of frame in buffer.
+ * @param frame_size   Size of frame in bytes.
+ * 
+ * @return             @c 1 , if handler was called.
+ * @return             @c 0 , if frame was an offer of the peer.
+ * @return             @c -1 , if compressed frame is invalid.
+ */
+static int jcon_frame_handle(jcon_frame_t *session, const uint8_t *data, size_t frame_offset, size_t frame_size);
+
+/**
+ * @brief Decompresses frame and calls handler of session.
+ * 
+ * @param session     Session object.
+ * @param block       Compressed frame after codec.
+ * @param block_size  Size of compressed frame.
+ * 
+ * @return            @c 1 , if handler was called.
+ * @return            @c -1 , if frame is invalid.
+ */
+static int jcon_frame_decompress(jcon_frame_t *session, const uint8_t *block, size_t block_size);
+
+/**
+ * @brief Sends frame compressed.
+ * 
+ * Frame data is given by @c iov or @c frame .
+ * 
+ * @param session     Session to send through.
+ * @param iov         Buffers of frame or @c NULL .
+ * @param iov_count   Number of buffers.
+ * @param frame       Buffer of frame or @c NULL .
+ * @param frame_size  Size of frame data.
+ * 
+ * @return            @c 1 , if frame was sent.
+ * @return            @c 0 , if frame does not get smaller and has to be sent uncompressed.
+ * @return            @c -1 , if error occured.
+ */
+static int jcon_frame_sendCompressed(jcon_frame_t *session, const struct iovec *iov, int iov_count, jutil_buffer_t *frame, size_t frame_size);
+
+/**
+ * @brief Writes length prefix and compression header.
+ * 
+ * @param session     Session object.
+ * @param prefix      Destination of at least
+ *                    @c JCON_FRAME_PREFIX_MAX + @c JCON_FRAME_COMPRESS_HEADER bytes.
+ * @param frame_size  Size of data following the header.
+ * @param codec       Codec written to header, if compression is enabled.
+ * 
+ * @return            Number of bytes written.
+ */
+static size_t jcon_frame_writePrefix(jcon_frame_t *session, uint8_t *prefix, size_t frame_size, int codec);
+
+/**
+ * @brief Grows buffer of session to size.
+ * 
+ * Buffers only grow, so they are allocated for
+ * the first frames and reused afterwards.
+ * 
+ * @param buffer    Buffer to grow.
+ * @param capacity  Size of buffer.
+ * @param size      Needed size.
+ * 
+ * @return          @c true , if buffer has size.
+ * @return          @c false , if error occured.
+ */
+static int jcon_frame_reserve(uint8_t **buffer, size_t *capacity, size_t size);
+
+/**
+ * @brief Sends log messages to logger with session data.
+ * 
+ * Uses logger. If available adds reference string to log messages.
+ * 
+ * @param session   Session object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jcon_frame_log(jcon_frame_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled(((session && session->client) ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_frame_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_frame_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_frame_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_frame_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_frame_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jcon_frame_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_frame_t *jcon_frame_lengthPrefix_init(jcon_client_t *client, size_t prefix_size, size_t frame_max, jcon_frame_handler_t handler, jlog_t *logger, void *ctx)
+{
+  if(prefix_size != 1 && prefix_size != 2 && prefix_size != 4)
+  {
+    ERROR(NULL, "Invalid prefix size [%zu].", prefix_size);
+    return NULL;
+  }
+
+  if(prefix_size < sizeof(size_t) && frame_max >= ((size_t)1 << (prefix_size * 8)))
+  {
+    ERROR(NULL, "Maximum frame size [%zu] does not fit in prefix of [%zu] bytes.", frame_max, prefix_size);
+    return NULL;
+  }
+
+  jcon_frame_t *session = jcon_frame_allocate(client, JCON_FRAME_MODE_LENGTHPREFIX, frame_max, handler, logger, ctx);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  session->prefix_size = prefix_size;
+  session->buffer_max = frame_max + prefix_size;
+
+  if(jcon_frame_allocateBuffer(session) == false)
+  {
+    ERROR(session, "Could not allocate buffer. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_frame_t *jcon_frame_delimiter_init(jcon_client_t *client, const void *delimiter, size_t delimiter_size, size_t frame_max, jcon_frame_handler_t handler, jlog_t *logger, void *ctx)
+{
+  if(delimiter == NULL || delimiter_size == 0)
+  {
+    ERROR(NULL, "No delimiter given.");
+    return NULL;
+  }
+
+  jcon_frame_t *session = jcon_frame_allocate(client, JCON_FRAME_MODE_DELIMITER, frame_max, handler, logger, ctx);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  session->delimiter = (uint8_t *)JUTIL_ALLOC_MALLOC(delimiter_size);
+  if(session->delimiter == NULL)
+  {
+    ERROR(session, "malloc() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+  memcpy(session->delimiter, delimiter, delimiter_size);
+  session->delimiter_size = delimiter_size;
+  session->buffer_max = frame_max + delimiter_size;
+
+  if(jcon_frame_allocateBuffer(session) == false)
+  {
+    ERROR(session, "Could not allocate buffer. Destroying session.");
+    JUTIL_ALLOC_FREE(session->delimiter);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_frame_free(jcon_frame_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  JUTIL_ALLOC_FREE(session->delimiter);
+  jutil_buffer_free(session->buffer);
+  jutil_lz4_free(session->lz4);
+  JUTIL_ALLOC_FREE(session->send_buffer);
+  JUTIL_ALLOC_FREE(session->recv_buffer);
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_process(jcon_frame_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  /* Buffer was released by jcon_frame_trim(). */
+  if(session->buffer == NULL && jcon_frame_allocateBuffer(session) == false)
+  {
+    ERROR(session, "jcon_frame_allocateBuffer() failed.");
+    return -1;
+  }
+
+  size_t pending = jutil_buffer_getSize(session->buffer);
+  if(pending >= session->buffer_max)
+  {
+    ERROR(session, "Receive buffer is full.");
+    return -1;
+  }
+
+  size_t read_size = session->buffer_max - pending;
+  if(read_size > JCON_FRAME_BUFFER_SIZE_DEFAULT)
+  {
+    read_size = JCON_FRAME_BUFFER_SIZE_DEFAULT;
+  }
+
+  /* Partial frames stay contiguous with the recieved data. */
+  size_t ret_recv = jcon_client_recvBuffer(session->client, session->buffer, read_size);
+  if(ret_recv == 0)
+  {
+    return 0;
+  }
+
+  size_t read_offset = 0;
+  int ret_parse;
+  if(session->mode == JCON_FRAME_MODE_LENGTHPREFIX)
+  {
+    ret_parse = jcon_frame_parseLengthPrefix(session, &read_offset);
+  }
+  else
+  {
+    ret_parse = jcon_frame_parseDelimiter(session, &read_offset);
+  }
+
+  if(ret_parse < 0)
+  {
+    if(ret_parse == -1)
+    {
+      ERROR(session, "Frame exceeds maximum size [%zu]. Discarding data and closing client.", session->frame_max);
+    }
+    else
+    {
+      ERROR(session, "Invalid compressed frame. Discarding data and closing client.");
+    }
+    jutil_buffer_consume(session->buffer, jutil_buffer_getSize(session->buffer));
+    session->search_offset = 0;
+    jcon_client_close(session->client);
+    return -1;
+  }
+
+  jutil_buffer_consume(session->buffer, read_offset);
+  session->search_offset -= read_offset;
+
+  return ret_parse;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_send(jcon_frame_t *session, const void *frame_ptr, size_t frame_size)
+{
+  if(frame_ptr == NULL && frame_size > 0)
+  {
+    ERROR(session, "frame_ptr is NULL.");
+    return false;
+  }
+
+  struct iovec iov = { (void *)frame_ptr, frame_size };
+  return jcon_frame_sendV(session, &iov, (frame_size > 0 ? 1 : 0));
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_sendV(jcon_frame_t *session, const struct iovec *iov, int iov_count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if((iov == NULL && iov_count > 0) || iov_count < 0 || iov_count > JCON_FRAME_BUFFER_IOV)
+  {
+    ERROR(session, "Invalid number of buffers [%d].", iov_count);
+    return false;
+  }
+
+  size_t frame_size = 0;
+  for(int i = 0; i < iov_count; i++)
+  {
+    frame_size += iov[i].iov_len;
+  }
+
+  if(frame_size > session->frame_max)
+  {
+    ERROR(session, "Frame size [%zu] exceeds maximum size [%zu].", frame_size, session->frame_max);
+    return false;
+  }
+
+  if(session->compress)
+  {
+    int ret_compress = jcon_frame_sendCompressed(session, iov, iov_count, NULL, frame_size);
+    if(ret_compress != 0)
+    {
+      return (ret_compress > 0);
+    }
+  }
+
+  uint8_t prefix[JCON_FRAME_PREFIX_MAX + JCON_FRAME_COMPRESS_HEADER];
+  struct iovec frame_iov[JCON_FRAME_BUFFER_IOV + 2];
+  int frame_iov_count = 0;
+  size_t total_size = frame_size;
+
+  if(session->mode == JCON_FRAME_MODE_LENGTHPREFIX)
+  {
+    size_t prefix_size = jcon_frame_writePrefix(session, prefix, frame_size, JCON_FRAME_COMPRESS_NONE);
+
+    frame_iov[frame_iov_count].iov_base = prefix;
+    frame_iov[frame_iov_count].iov_len = prefix_size;
+    frame_iov_count++;
+    total_size += prefix_size;
+  }
+
+  for(int i = 0; i < iov_count; i++)
+  {
+    if(iov[i].iov_len > 0)
+    {
+      frame_iov[frame_iov_count++] = iov[i];
+    }
+  }
+
+  if(session->mode == JCON_FRAME_MODE_DELIMITER)
+  {
+    frame_iov[frame_iov_count].iov_base = session->delimiter;
+    frame_iov[frame_iov_count].iov_len = session->delimiter_size;
+    frame_iov_count++;
+    total_size += session->delimiter_size;
+  }
+
+  size_t ret_send = jcon_client_sendDataV(session->client, frame_iov, frame_iov_count);
+  if(ret_send != total_size)
+  {
+    ERROR(session, "Frame not sent completely [%zu / %zu].", ret_send, total_size);
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_sendBuffer(jcon_frame_t *session, jutil_buffer_t *frame)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(frame == NULL)
+  {
+    ERROR(session, "Frame is NULL.");
+    return false;
+  }
+
+  size_t frame_size = jutil_buffer_getSize(frame);
+  if(frame_size > session->frame_max)
+  {
+    ERROR(session, "Frame size [%zu] exceeds maximum size [%zu].", frame_size, session->frame_max);
+    return false;
+  }
+
+  if(session->compress)
+  {
+    int ret_compress = jcon_frame_sendCompressed(session, NULL, 0, frame, frame_size);
+    if(ret_compress != 0)
+    {
+      return (ret_compress > 0);
+    }
+  }
+
+  uint8_t prefix[JCON_FRAME_PREFIX_MAX + JCON_FRAME_COMPRESS_HEADER];
+  struct iovec iov[JCON_FRAME_BUFFER_IOV + 2];
+  size_t frame_offset = 0;
+
+  /* Frames with more segments, than fit in iov, take more calls. */
+  do
+  {
+    int iov_count = 0;
+    size_t total_size = 0;
+
+    if(frame_offset == 0 && session->mode == JCON_FRAME_MODE_LENGTHPREFIX)
+    {
+      size_t prefix_size = jcon_frame_writePrefix(session, prefix, frame_size, JCON_FRAME_COMPRESS_NONE);
+
+      iov[iov_count].iov_base = prefix;
+      iov[iov_count].iov_len = prefix_size;
+      iov_count++;
+      total_size += prefix_size;
+    }
+
+    int segments = jutil_buffer_getIovec(frame, frame_offset, iov + iov_count, JCON_FRAME_BUFFER_IOV);
+    for(int i = 0; i < segments; i++)
+    {
+      frame_offset += iov[iov_count].iov_len;
+      total_size += iov[iov_count].iov_len;
+      iov_count++;
+    }
+
+    if(frame_offset == frame_size && session->mode == JCON_FRAME_MODE_DELIMITER)
+    {
+      iov[iov_count].iov_base = session->delimiter;
+      iov[iov_count].iov_len = session->delimiter_size;
+      iov_count++;
+      total_size += session->delimiter_size;
+    }
+
+    size_t ret_send = jcon_client_sendDataV(session->client, iov, iov_count);
+    if(ret_send != total_size)
+    {
+      ERROR(session, "Frame not sent completely [%zu / %zu].", ret_send, total_size);
+      return false;
+    }
+  } while(frame_offset < frame_size);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_frame_setBufferHandler(jcon_frame_t *session, jcon_frame_bufferHandler_t handler)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  session->buffer_handler = handler;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_frame_setArena(jcon_frame_t *session, jutil_arena_t *arena)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  session->arena = arena;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_setCompression(jcon_frame_t *session, const jcon_frame_compression_t *options)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->mode != JCON_FRAME_MODE_LENGTHPREFIX)
+  {
+    ERROR(session, "Compression needs length prefixed frames.");
+    return false;
+  }
+
+  if(session->compress == false)
+  {
+    /* Header is added to the largest frame, so the prefix has to hold one byte more. */
+    if(session->prefix_size < sizeof(size_t) && session->frame_max + JCON_FRAME_COMPRESS_HEADER >= ((size_t)1 << (session->prefix_size * 8)))
+    {
+      ERROR(session, "Maximum frame size [%zu] with compression header does not fit in prefix of [%zu] bytes.", session->frame_max, session->prefix_size);
+      return false;
+    }
+  }
+
+  unsigned int codecs = JCON_FRAME_COMPRESS_SUPPORTED;
+  size_t threshold = JCON_FRAME_COMPRESS_THRESHOLD_DEFAULT;
+  if(options && options->codecs != 0)
+  {
+    codecs = (options->codecs & JCON_FRAME_COMPRESS_SUPPORTED);
+  }
+  if(options && options->threshold != 0)
+  {
+    threshold = options->threshold;
+  }
+
+  if((codecs & (1U << JCON_FRAME_COMPRESS_LZ4)) && session->lz4 == NULL)
+  {
+    session->lz4 = jutil_lz4_init();
+    if(session->lz4 == NULL)
+    {
+      ERROR(session, "jutil_lz4_init() failed.");
+      return false;
+    }
+  }
+
+  if(session->compress == false)
+  {
+    session->compress = true;
+    session->buffer_max += JCON_FRAME_COMPRESS_HEADER;
+  }
+  session->compress_codecs = codecs;
+  session->compress_codec = JCON_FRAME_COMPRESS_NONE;
+  session->compress_threshold = threshold;
+
+  uint8_t offer[JCON_FRAME_PREFIX_MAX + JCON_FRAME_COMPRESS_HEADER + 1];
+  size_t offer_size = jcon_frame_writePrefix(session, offer, 1, JCON_FRAME_COMPRESS_OFFER);
+  offer[offer_size++] = (uint8_t)codecs;
+
+  if(jcon_client_sendData(session->client, offer, offer_size) != offer_size)
+  {
+    ERROR(session, "Could not send offer of codecs.");
+    return false;
+  }
+
+  DEBUG(session, "Offered codecs [0x%02x] with threshold [%zu].", codecs, threshold);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_getCompression(jcon_frame_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return JCON_FRAME_COMPRESS_NONE;
+  }
+
+  return session->compress_codec;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_trim(jcon_frame_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  jutil_lz4_free(session->lz4);
+  session->lz4 = NULL;
+
+  JUTIL_ALLOC_FREE(session->send_buffer);
+  session->send_buffer = NULL;
+  session->send_capacity = 0;
+
+  JUTIL_ALLOC_FREE(session->recv_buffer);
+  session->recv_buffer = NULL;
+  session->recv_capacity = 0;
+
+  if(jutil_buffer_getSize(session->buffer) > 0)
+  {
+    return false;
+  }
+
+  jutil_buffer_free(session->buffer);
+  session->buffer = NULL;
+  session->search_offset = 0;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_frame_getPending(jcon_frame_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  return jutil_buffer_getSize(session->buffer);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_frame_t *jcon_frame_allocate(jcon_client_t *client, int mode, size_t frame_max, jcon_frame_handler_t handler, jlog_t *logger, void *ctx)
+{
+  if(client == NULL)
+  {
+    ERROR(NULL, "Client is NULL.");
+    return NULL;
+  }
+
+  if(handler == NULL)
+  {
+    ERROR(NULL, "Handler is NULL.");
+    return NULL;
+  }
+
+  if(frame_max == 0)
+  {
+    ERROR(NULL, "Maximum frame size is [0].");
+    return NULL;
+  }
+
+  jcon_frame_t *session = (jcon_frame_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_frame_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->client = client;
+  session->mode = mode;
+  session->prefix_size = 0;
+  session->delimiter = NULL;
+  session->delimiter_size = 0;
+  session->frame_max = frame_max;
+
+  session->buffer = NULL;
+  session->buffer_max = 0;
+  session->search_offset = 0;
+
+  session->handler = handler;
+  session->buffer_handler = NULL;
+  session->logger = logger;
+  session->ctx = ctx;
+  session->arena = NULL;
+
+  session->compress = false;
+  session->compress_codecs = 0;
+  session->compress_codec = JCON_FRAME_COMPRESS_NONE;
+  session->compress_threshold = 0;
+  session->lz4 = NULL;
+  session->send_buffer = NULL;
+  session->send_capacity = 0;
+  session->recv_buffer = NULL;
+  session->recv_capacity = 0;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_allocateBuffer(jcon_frame_t *session)
+{
+  size_t capacity = JCON_FRAME_BUFFER_SIZE_DEFAULT;
+  if(capacity > session->buffer_max)
+  {
+    capacity = session->buffer_max;
+  }
+
+  session->buffer = jutil_buffer_init(capacity);
+  if(session->buffer == NULL)
+  {
+    ERROR(session, "jutil_buffer_init() failed.");
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_parseLengthPrefix(jcon_frame_t *session, size_t *read_offset)
+{
+  int frames = 0;
+  size_t pending;
+  const uint8_t *data = (const uint8_t *)jutil_buffer_getData(session->buffer, &pending);
+
+  while(pending - *read_offset >= session->prefix_size)
+  {
+    const uint8_t *prefix = data + *read_offset;
+    size_t frame_size = 0;
+    size_t i;
+    for(i = 0; i < session->prefix_size; i++)
+    {
+      frame_size = (frame_size << 8) | prefix[i];
+    }
+
+    if(frame_size > session->frame_max + (session->compress ? JCON_FRAME_COMPRESS_HEADER : 0))
+    {
+      return -1;
+    }
+
+    if(pending - *read_offset < session->prefix_size + frame_size)
+    {
+      break;
+    }
+
+    int ret_handle = jcon_frame_handle(session, data, *read_offset + session->prefix_size, frame_size);
+    if(ret_handle < 0)
+    {
+      return -2;
+    }
+    *read_offset += session->prefix_size + frame_size;
+    frames += ret_handle;
+  }
+
+  return frames;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_parseDelimiter(jcon_frame_t *session, size_t *read_offset)
+{
+  int frames = 0;
+  size_t pending;
+  const uint8_t *data = (const uint8_t *)jutil_buffer_getData(session->buffer, &pending);
+
+  while(pending >= session->delimiter_size && pending - session->search_offset >= session->delimiter_size)
+  {
+    const uint8_t *match = memchr
+    (
+      data + session->search_offset,
+      session->delimiter[0],
+      pending - session->search_offset - session->delimiter_size + 1
+    );
+    if(match == NULL)
+    {
+      session->search_offset = pending - session->delimiter_size + 1;
+      break;
+    }
+
+    size_t match_offset = match - data;
+    if(memcmp(match, session->delimiter, session->delimiter_size) != 0)
+    {
+      session->search_offset = match_offset + 1;
+      continue;
+    }
+
+    size_t frame_size = match_offset - *read_offset;
+    if(frame_size > session->frame_max)
+    {
+      return -1;
+    }
+
+    frames += jcon_frame_handle(session, data, *read_offset, frame_size);
+    *read_offset = match_offset + session->delimiter_size;
+    session->search_offset = *read_offset;
+  }
+
+  /* No delimiter in reach of maximum frame size. */
+  if(session->search_offset - *read_offset > session->frame_max)
+  {
+    return -1;
+  }
+
+  return frames;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_handle(jcon_frame_t *session, const uint8_t *data, size_t frame_offset, size_t frame_size)
+{
+  if(session->compress)
+  {
+    if(frame_size < JCON_FRAME_COMPRESS_HEADER)
+    {
+      ERROR(session, "Frame without compression header.");
+      return -1;
+    }
+
+    int codec = data[frame_offset];
+    if(codec == JCON_FRAME_COMPRESS_OFFER)
+    {
+      unsigned int codecs = (frame_size > JCON_FRAME_COMPRESS_HEADER ? data[frame_offset + 1] : 0);
+      codecs &= session->compress_codecs;
+
+      session->compress_codec = ((codecs & (1U << JCON_FRAME_COMPRESS_LZ4)) ? JCON_FRAME_COMPRESS_LZ4 : JCON_FRAME_COMPRESS_NONE);
+      DEBUG(session, "Peer offered codecs, sending with codec [%d].", session->compress_codec);
+      return 0;
+    }
+
+    if(codec == JCON_FRAME_COMPRESS_LZ4 && (session->compress_codecs & (1U << JCON_FRAME_COMPRESS_LZ4)))
+    {
+      return jcon_frame_decompress(session, data + frame_offset + JCON_FRAME_COMPRESS_HEADER, frame_size - JCON_FRAME_COMPRESS_HEADER);
+    }
+
+    if(codec != JCON_FRAME_COMPRESS_NONE)
+    {
+      ERROR(session, "Frame with codec [%d], that was not offered.", codec);
+      return -1;
+    }
+
+    frame_offset += JCON_FRAME_COMPRESS_HEADER;
+    frame_size -= JCON_FRAME_COMPRESS_HEADER;
+  }
+
+  jutil_buffer_t *frame = NULL;
+  if(session->buffer_handler)
+  {
+    frame = jutil_buffer_slice(session->buffer, frame_offset, frame_size);
+    if(frame == NULL)
+    {
+      ERROR(session, "jutil_buffer_slice() failed. Passing frame to data handler.");
+    }
+  }
+
+  if(frame)
+  {
+    session->buffer_handler(session->ctx, session->client, frame);
+    jutil_buffer_free(frame);
+  }
+  else
+  {
+    session->handler(session->ctx, session->client, data + frame_offset, frame_size);
+  }
+
+  jutil_arena_reset(session->arena);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_decompress(jcon_frame_t *session, const uint8_t *block, size_t block_size)
+{
+  if(block_size < JCON_FRAME_COMPRESS_LENGTH)
+  {
+    ERROR(session, "Compressed frame without length.");
+    return -1;
+  }
+
+  size_t frame_size = 0;
+  size_t i;
+  for(i = 0; i < JCON_FRAME_COMPRESS_LENGTH; i++)
+  {
+    frame_size = (frame_size << 8) | block[i];
+  }
+
+  if(frame_size > session->frame_max)
+  {
+    ERROR(session, "Uncompressed frame size [%zu] exceeds maximum size [%zu].", frame_size, session->frame_max);
+    return -1;
+  }
+
+  if(jcon_frame_reserve(&session->recv_buffer, &session->recv_capacity, frame_size) == false)
+  {
+    ERROR(session, "Could not allocate buffer for [%zu] bytes.", frame_size);
+    return -1;
+  }
+
+  if(jutil_lz4_decompress(block + JCON_FRAME_COMPRESS_LENGTH, block_size - JCON_FRAME_COMPRESS_LENGTH, session->recv_buffer, frame_size) != frame_size)
+  {
+    ERROR(session, "Invalid LZ4 block of [%zu] bytes.", block_size - JCON_FRAME_COMPRESS_LENGTH);
+    return -1;
+  }
+
+  /* Buffer of session is reused by the next frame, so handlers, that can keep frames, get a copy. */
+  jutil_buffer_t *frame = NULL;
+  if(session->buffer_handler)
+  {
+    frame = jutil_buffer_copy_init(session->recv_buffer, frame_size);
+    if(frame == NULL)
+    {
+      ERROR(session, "jutil_buffer_copy_init() failed. Passing frame to data handler.");
+    }
+  }
+
+  if(frame)
+  {
+    session->buffer_handler(session->ctx, session->client, frame);
+    jutil_buffer_free(frame);
+  }
+  else
+  {
+    session->handler(session->ctx, session->client, session->recv_buffer, frame_size);
+  }
+
+  jutil_arena_reset(session->arena);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_sendCompressed(jcon_frame_t *session, const struct iovec *iov, int iov_count, jutil_buffer_t *frame, size_t frame_size)
+{
+  /* Compressed frames have to be smaller than uncompressed ones with header. */
+  if(session->compress_codec != JCON_FRAME_COMPRESS_LZ4 || frame_size < session->compress_threshold || frame_size <= JCON_FRAME_COMPRESS_LENGTH)
+  {
+    return 0;
+  }
+
+  /* Context was released by jcon_frame_trim(). */
+  if(session->lz4 == NULL)
+  {
+    session->lz4 = jutil_lz4_init();
+    if(session->lz4 == NULL)
+    {
+      ERROR(session, "jutil_lz4_init() failed. Sending uncompressed.");
+      return 0;
+    }
+  }
+
+  /* Gathered data and compressed data share the buffer. */
+  if(jcon_frame_reserve(&session->send_buffer, &session->send_capacity, 2 * frame_size) == false)
+  {
+    ERROR(session, "Could not allocate buffer for [%zu] bytes. Sending uncompressed.", frame_size);
+    return 0;
+  }
+
+  const uint8_t *input = session->send_buffer;
+  uint8_t *output = session->send_buffer + frame_size;
+
+  if(frame)
+  {
+    jutil_buffer_copyOut(frame, 0, session->send_buffer, frame_size);
+  }
+  else if(iov_count == 1)
+  {
+    input = (const uint8_t *)iov[0].iov_base;
+  }
+  else
+  {
+    size_t offset = 0;
+    for(int i = 0; i < iov_count; i++)
+    {
+      memcpy(session->send_buffer + offset, iov[i].iov_base, iov[i].iov_len);
+      offset += iov[i].iov_len;
+    }
+  }
+
+  size_t block_size = jutil_lz4_compress(session->lz4, input, frame_size, output, frame_size - JCON_FRAME_COMPRESS_LENGTH);
+  if(block_size == 0)
+  {
+    return 0;
+  }
+
+  uint8_t prefix[JCON_FRAME_PREFIX_MAX + JCON_FRAME_COMPRESS_HEADER + JCON_FRAME_COMPRESS_LENGTH];
+  size_t prefix_size = jcon_frame_writePrefix(session, prefix, JCON_FRAME_COMPRESS_LENGTH + block_size, JCON_FRAME_COMPRESS_LZ4);
+  size_t i;
+  for(i = 0; i < JCON_FRAME_COMPRESS_LENGTH; i++)
+  {
+    prefix[prefix_size++] = (uint8_t)(frame_size >> ((JCON_FRAME_COMPRESS_LENGTH - i - 1) * 8));
+  }
+
+  struct iovec frame_iov[2] = { { prefix, prefix_size }, { output, block_size } };
+  size_t ret_send = jcon_client_sendDataV(session->client, frame_iov, 2);
+  if(ret_send != prefix_size + block_size)
+  {
+    ERROR(session, "Frame not sent completely [%zu / %zu].", ret_send, prefix_size + block_size);
+    return -1;
+  }
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_frame_compressed_input_bytes_total", "Bytes of frames before compression.", (unsigned long long)frame_size);
+  JUTIL_METRICS_COUNTER_ADD("jcon_frame_compressed_output_bytes_total", "Bytes of frames after compression.", (unsigned long long)block_size);
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_frame_writePrefix(jcon_frame_t *session, uint8_t *prefix, size_t frame_size, int codec)
+{
+  size_t wire_size = frame_size + (session->compress ? JCON_FRAME_COMPRESS_HEADER : 0);
+
+  size_t i;
+  for(i = 0; i < session->prefix_size; i++)
+  {
+    prefix[i] = (uint8_t)(wire_size >> ((session->prefix_size - i - 1) * 8));
+  }
+
+  if(session->compress)
+  {
+    prefix[i++] = (uint8_t)codec;
+  }
+
+  return i;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_frame_reserve(uint8_t **buffer, size_t *capacity, size_t size)
+{
+  if(size <= *capacity)
+  {
+    return true;
+  }
+
+  size_t new_capacity = *capacity * 2;
+  if(new_capacity < size)
+  {
+    new_capacity = size;
+  }
+
+  uint8_t *new_buffer = (uint8_t *)JUTIL_ALLOC_MALLOC(new_capacity);
+  if(new_buffer == NULL)
+  {
+    return false;
+  }
+
+  JUTIL_ALLOC_FREE(*buffer);
+  *buffer = new_buffer;
+  *capacity = new_capacity;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_frame_log(jcon_frame_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session && session->client)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<%s> %s", jcon_client_getReferenceString(session->client), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_client_getReferenceString(session->client), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -0,0 +1,488 @@
+/**
+ * @file jcon_handoff.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_handoff.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for MSG_CMSG_CLOEXEC and F_DUPFD_CLOEXEC */
+
+#include <jayc/jcon_handoff.h>
+#include <jayc/jcon_server_tcp.h>
+#include <jayc/jcon_server_unix.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+//==============================================================================
+// Define constants and structures.
+//
+
+/**
+ * @brief Marks messages with descriptors ("JCHO").
+ */
+#define JCON_HANDOFF_MAGIC 0x4A43484F
+
+/**
+ * @brief Variable with number of inherited descriptors.
+ */
+#define JCON_HANDOFF_ENV_FDS "LISTEN_FDS"
+
+/**
+ * @brief Variable with process id, the descriptors are meant for.
+ */
+#define JCON_HANDOFF_ENV_PID "LISTEN_PID"
+
+/**
+ * @brief Variable with names of inherited descriptors (set by systemd).
+ */
+#define JCON_HANDOFF_ENV_NAMES "LISTEN_FDNAMES"
+
+/**
+ * @brief Data sent together with descriptors.
+ */
+typedef struct __jcon_handoff_header
+{
+  uint32_t magic;                     /**< @c #JCON_HANDOFF_MAGIC . */
+  uint32_t count;                     /**< Number of descriptors in message. */
+} jcon_handoff_header_t;
+
+/**
+ * @brief Control buffer for @c SCM_RIGHTS , aligned for @c struct @c cmsghdr .
+ */
+typedef union __jcon_handoff_control
+{
+  char buf[CMSG_SPACE(sizeof(int) * JCON_HANDOFF_LISTENERS_MAX)]; /**< Space for all descriptors. */
+  struct cmsghdr align;               /**< Forces alignment. */
+} jcon_handoff_control_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Parses number from environment variable.
+ * 
+ * @param name  Name of variable.
+ * @param value Set to parsed number.
+ * 
+ * @return      @c true , if variable is set and a positive number.
+ * @return      @c false , if not set or invalid.
+ */
+static int jcon_handoff_getEnvNumber(const char *name, long *value);
+
+/**
+ * @brief Closes descriptors.
+ * 
+ * @param fds   Descriptors to close.
+ * @param count Number of descriptors.
+ */
+static void jcon_handoff_closeAll(const int fds[], size_t count);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_handoff_send(int channel, const int fds[], size_t count)
+{
+  if(channel < 0 || fds == NULL || count == 0 || count > JCON_HANDOFF_LISTENERS_MAX)
+  {
+    JLOG_ERROR("Invalid arguments (channel [%d], count [%zu]).", channel, count);
+    return false;
+  }
+
+  jcon_handoff_header_t header;
+  header.magic = JCON_HANDOFF_MAGIC;
+  header.count = (uint32_t)count;
+
+  struct iovec iov;
+  iov.iov_base = &header;
+  iov.iov_len = sizeof(header);
+
+  jcon_handoff_control_t control;
+  memset(&control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+
+  ssize_t ret_send;
+  do
+  {
+    ret_send = sendmsg(channel, &msg, MSG_NOSIGNAL);
+  } while(ret_send < 0 && errno == EINTR);
+
+  if(ret_send < 0)
+  {
+    JLOG_ERROR("sendmsg() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+  if((size_t)ret_send != sizeof(header))
+  {
+    JLOG_ERROR("sendmsg() sent incomplete header [%zd].", ret_send);
+    return false;
+  }
+
+  JLOG_DEBUG("Sent [%zu] descriptors over [%d].", count, channel);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_handoff_sendServers(int channel, jcon_server_t *const servers[], size_t count)
+{
+  if(servers == NULL || count == 0 || count > JCON_HANDOFF_LISTENERS_MAX)
+  {
+    JLOG_ERROR("Invalid number of servers [%zu].", count);
+    return false;
+  }
+
+  int fds[JCON_HANDOFF_LISTENERS_MAX];
+  for(size_t i = 0; i < count; i++)
+  {
+    fds[i] = (servers[i] ? jcon_server_getFileDescriptor(servers[i]) : -1);
+    if(fds[i] < 0)
+    {
+      JLOG_ERROR("Server [%zu] has no listening socket.", i);
+      return false;
+    }
+  }
+
+  return jcon_handoff_send(channel, fds, count);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_handoff_recv(int channel, int fds[], size_t max, int timeout)
+{
+  if(channel < 0 || fds == NULL || max == 0)
+  {
+    JLOG_ERROR("Invalid arguments (channel [%d], max [%zu]).", channel, max);
+    return -1;
+  }
+
+  if(timeout >= 0)
+  {
+    struct pollfd pfd;
+    pfd.fd = channel;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ret_poll;
+    do
+    {
+      ret_poll = poll(&pfd, 1, timeout);
+    } while(ret_poll < 0 && errno == EINTR);
+
+    if(ret_poll < 0)
+    {
+      JLOG_ERROR("poll() failed [%d : %s].", errno, strerror(errno));
+      return -1;
+    }
+    if(ret_poll == 0)
+    {
+      JLOG_ERROR("No descriptors recieved within [%d ms].", timeout);
+      return -1;
+    }
+  }
+
+  jcon_handoff_header_t header;
+  memset(&header, 0, sizeof(header));
+
+  struct iovec iov;
+  iov.iov_base = &header;
+  iov.iov_len = sizeof(header);
+
+  jcon_handoff_control_t control;
+  memset(&control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+
+  ssize_t ret_recv;
+  do
+  {
+    ret_recv = recvmsg(channel, &msg, MSG_CMSG_CLOEXEC);
+  } while(ret_recv < 0 && errno == EINTR);
+
+  if(ret_recv < 0)
+  {
+    JLOG_ERROR("recvmsg() failed [%d : %s].", errno, strerror(errno));
+    return -1;
+  }
+
+  /* Collect descriptors first, so they are closed on every error. */
+  int received[JCON_HANDOFF_LISTENERS_MAX];
+  size_t count = 0;
+  for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+  {
+    if(cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+    {
+      continue;
+    }
+
+    size_t number = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    if(number > JCON_HANDOFF_LISTENERS_MAX - count)
+    {
+      number = JCON_HANDOFF_LISTENERS_MAX - count;
+    }
+    memcpy(&received[count], CMSG_DATA(cmsg), sizeof(int) * number);
+    count += number;
+  }
+
+  if(ret_recv == 0)
+  {
+    JLOG_ERROR("Channel [%d] closed by peer.", channel);
+    jcon_handoff_closeAll(received, count);
+    return -1;
+  }
+  if(msg.msg_flags & MSG_CTRUNC)
+  {
+    JLOG_ERROR("Descriptors were truncated.");
+    jcon_handoff_closeAll(received, count);
+    return -1;
+  }
+  if((size_t)ret_recv != sizeof(header) || header.magic != JCON_HANDOFF_MAGIC || header.count != count)
+  {
+    JLOG_ERROR("Invalid handoff message ([%zd] bytes, [%zu] descriptors).", ret_recv, count);
+    jcon_handoff_closeAll(received, count);
+    return -1;
+  }
+  if(count > max)
+  {
+    JLOG_ERROR("Recieved [%zu] descriptors, space for [%zu].", count, max);
+    jcon_handoff_closeAll(received, count);
+    return -1;
+  }
+
+  memcpy(fds, received, sizeof(int) * count);
+
+  JLOG_DEBUG("Recieved [%zu] descriptors over [%d].", count, channel);
+  return (int)count;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_handoff_getInherited(int fds[], size_t max)
+{
+  if(fds == NULL)
+  {
+    JLOG_ERROR("fds is NULL.");
+    return -1;
+  }
+
+  long pid = 0;
+  long count = 0;
+  if(jcon_handoff_getEnvNumber(JCON_HANDOFF_ENV_PID, &pid) == false)
+  {
+    return 0;
+  }
+
+  /* Descriptors of a parent, that did not exec. */
+  if(pid != (long)getpid())
+  {
+    JLOG_DEBUG("Descriptors are for process [%ld].", pid);
+    return 0;
+  }
+
+  int ret = 0;
+  if(jcon_handoff_getEnvNumber(JCON_HANDOFF_ENV_FDS, &count) == false)
+  {
+    JLOG_ERROR("Invalid value of %s.", JCON_HANDOFF_ENV_FDS);
+    ret = -1;
+  }
+  else if((size_t)count > max || count > INT_MAX - JCON_HANDOFF_LISTEN_FDS_START)
+  {
+    JLOG_ERROR("Inherited [%ld] descriptors, space for [%zu].", count, max);
+    ret = -1;
+  }
+  else
+  {
+    for(long i = 0; i < count; i++)
+    {
+      int fd = JCON_HANDOFF_LISTEN_FDS_START + (int)i;
+      if(fcntl(fd, F_SETFD, FD_CLOEXEC) < 0)
+      {
+        JLOG_ERROR("fcntl() failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+        ret = -1;
+        break;
+      }
+      fds[i] = fd;
+    }
+
+    if(ret == 0)
+    {
+      ret = (int)count;
+    }
+  }
+
+  unsetenv(JCON_HANDOFF_ENV_PID);
+  unsetenv(JCON_HANDOFF_ENV_FDS);
+  unsetenv(JCON_HANDOFF_ENV_NAMES);
+
+  if(ret > 0)
+  {
+    JLOG_DEBUG("Inherited [%d] descriptors.", ret);
+  }
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_handoff_exportInherited(const int fds[], size_t count)
+{
+  /* Does not log, loggers may be locked by threads of the parent. */
+  if(fds == NULL || count == 0 || count > JCON_HANDOFF_LISTENERS_MAX)
+  {
+    return false;
+  }
+
+  /* Copies above the target range first, so descriptors
+     already in the range are not replaced before they are moved. */
+  int copies[JCON_HANDOFF_LISTENERS_MAX];
+  for(size_t i = 0; i < count; i++)
+  {
+    copies[i] = fcntl(fds[i], F_DUPFD_CLOEXEC, JCON_HANDOFF_LISTEN_FDS_START + (int)count);
+    if(copies[i] < 0)
+    {
+      jcon_handoff_closeAll(copies, i);
+      return false;
+    }
+  }
+
+  int ret = true;
+  for(size_t i = 0; i < count; i++)
+  {
+    /* dup2() clears close-on-exec of the new descriptor. */
+    if(dup2(copies[i], JCON_HANDOFF_LISTEN_FDS_START + (int)i) < 0)
+    {
+      ret = false;
+      break;
+    }
+  }
+  jcon_handoff_closeAll(copies, count);
+
+  if(ret == false)
+  {
+    return false;
+  }
+
+  char value[32];
+  snprintf(value, sizeof(value), "%zu", count);
+  if(setenv(JCON_HANDOFF_ENV_FDS, value, true) < 0)
+  {
+    return false;
+  }
+
+  snprintf(value, sizeof(value), "%ld", (long)getpid());
+  if(setenv(JCON_HANDOFF_ENV_PID, value, true) < 0)
+  {
+    return false;
+  }
+
+  unsetenv(JCON_HANDOFF_ENV_NAMES);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_handoff_adoptServer(int fd, jlog_t *logger)
+{
+  struct sockaddr_storage addr;
+  socklen_t addrlen = sizeof(addr);
+  memset(&addr, 0, sizeof(addr));
+
+  if(getsockname(fd, (struct sockaddr *)&addr, &addrlen) < 0)
+  {
+    JLOG_ERROR("getsockname() failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    if(fd > 0)
+    {
+      close(fd);
+    }
+    return NULL;
+  }
+
+  switch(addr.ss_family)
+  {
+    case AF_INET:
+    case AF_INET6:
+      return jcon_server_tcp_adopt_init(fd, NULL, logger);
+
+    case AF_LOCAL:
+      return jcon_server_unix_adopt_init(fd, logger);
+
+    default:
+      JLOG_ERROR("Family [%d] of [%d] is not supported.", (int)addr.ss_family, fd);
+      close(fd);
+      return NULL;
+  }
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_handoff_getEnvNumber(const char *name, long *value)
+{
+  const char *string = getenv(name);
+  if(string == NULL || *string == 0)
+  {
+    return false;
+  }
+
+  char *end = NULL;
+  errno = 0;
+  long number = strtol(string, &end, 10);
+  if(errno != 0 || end == NULL || *end != 0 || number <= 0)
+  {
+    return false;
+  }
+
+  *value = number;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_handoff_closeAll(const int fds[], size_t count)
+{
+  for(size_t i = 0; i < count; i++)
+  {
+    close(fds[i]);
+  }
+}
@@ -0,0 +1,355 @@
+/**
+ * @file jcon_metrics.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_metrics.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_metrics.h>
+#include <jayc/jcon_server_tcp.h>
+#include <jayc/jcon_server.h>
+#include <jayc/jcon_client.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_metrics");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Milliseconds to wait for request of client.
+ */
+#define JCON_METRICS_TIMEOUT_REQUEST 1000
+
+/**
+ * @brief Size of buffer for request. Rest of request is ignored.
+ */
+#define JCON_METRICS_SIZE_REQUEST 1024
+
+/**
+ * @brief Name of serving thread.
+ */
+#define JCON_METRICS_THREAD_NAME "jcon-metrics"
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Session object of metrics endpoint.
+ */
+struct __jcon_metrics_session
+{
+  jcon_server_t *server;  /**< Server, that accepts requests. */
+  jutil_thread_t *thread; /**< Thread, that answers requests. */
+  jlog_t *logger;         /**< Logger for debug and error messages. */
+
+  jcon_metrics_format_handler_t handler;  /**< Formats metrics, @c NULL for @c #jutil_metrics_format() . */
+  void *handler_ctx;                      /**< Context pointer passed to handler. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Loop function of thread, answers one connection.
+ * 
+ * @param ctx     Session object.
+ * @param thread  Thread session.
+ * 
+ * @return        @c true , thread keeps running.
+ */
+static int jcon_metrics_thread_function(void *ctx, jutil_thread_t *thread);
+
+/**
+ * @brief Reads request and sends response to client.
+ * 
+ * @param session Session object.
+ * @param client  Accepted client.
+ */
+static void jcon_metrics_answer(jcon_metrics_t *session, jcon_client_t *client);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * @param session   Session for logger and reference string.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_metrics_log(jcon_metrics_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allows to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_metrics_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_metrics_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_metrics_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_metrics_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_metrics_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jcon_metrics_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_metrics_t *jcon_metrics_init(char *address, uint16_t port, jlog_t *logger)
+{
+  return jcon_metrics_handler_init(address, port, NULL, NULL, logger);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_metrics_t *jcon_metrics_handler_init(char *address, uint16_t port, jcon_metrics_format_handler_t handler, void *ctx, jlog_t *logger)
+{
+  jcon_metrics_t *session = (jcon_metrics_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_metrics_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->logger = logger;
+  session->thread = NULL;
+  session->handler = handler;
+  session->handler_ctx = ctx;
+
+  session->server = jcon_server_tcp_session_init(address, port, logger);
+  if(session->server == NULL)
+  {
+    ERROR(NULL, "jcon_server_tcp_session_init() failed.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jcon_server_reset(session->server) == false)
+  {
+    ERROR(session, "jcon_server_reset() failed.");
+    jcon_server_free(session->server);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  /* Server polls for connections, thread does not need to sleep. */
+  jutil_thread_options_t options;
+  memset(&options, 0, sizeof(options));
+  options.name = JCON_METRICS_THREAD_NAME;
+
+  session->thread = jutil_thread_options_init(&jcon_metrics_thread_function, logger, 0, 0, session, &options);
+  if(session->thread == NULL)
+  {
+    ERROR(session, "jutil_thread_options_init() failed.");
+    jcon_server_free(session->server);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jutil_thread_start(session->thread) == false)
+  {
+    ERROR(session, "jutil_thread_start() failed.");
+    jutil_thread_free(session->thread);
+    jcon_server_free(session->server);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  DEBUG(session, "Serving metrics.");
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_metrics_free(jcon_metrics_t *session)
+{
+  if(session == NULL)
+  {
+    return;
+  }
+
+  if(session->thread)
+  {
+    jutil_thread_free(session->thread);
+  }
+  if(session->server)
+  {
+    jcon_server_free(session->server);
+  }
+
+  JUTIL_ALLOC_FREE(session);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_metrics_thread_function(void *ctx, jutil_thread_t *thread)
+{
+  jcon_metrics_t *session = (jcon_metrics_t *)ctx;
+
+  if(jcon_server_newConnection(session->server) == false)
+  {
+    return true;
+  }
+
+  jcon_client_t *client = jcon_server_acceptConnection(session->server);
+  if(client == NULL)
+  {
+    return true;
+  }
+
+  jcon_metrics_answer(session, client);
+  jcon_client_session_free(client);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_metrics_answer(jcon_metrics_t *session, jcon_client_t *client)
+{
+  char request[JCON_METRICS_SIZE_REQUEST];
+
+  jcon_client_setPollTimeout(client, JCON_METRICS_TIMEOUT_REQUEST);
+  if(jcon_client_newData(client) == false)
+  {
+    DEBUG(session, "No request from [%s].", jcon_client_getReferenceString(client));
+    return;
+  }
+
+  size_t length = jcon_client_recvData(client, request, sizeof(request) - 1);
+  request[length] = 0;
+
+  if(strncmp(request, "GET ", 4) != 0)
+  {
+    static const char *refused = "HTTP/1.0 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\n\r\n";
+    DEBUG(session, "Refused request from [%s].", jcon_client_getReferenceString(client));
+    jcon_client_sendData(client, (void *)refused, strlen(refused));
+    return;
+  }
+
+  size_t body_length = 0;
+  char *body = (session->handler ? session->handler(session->handler_ctx, &body_length) : jutil_metrics_format(&body_length));
+  if(body == NULL)
+  {
+    static const char *failed = "HTTP/1.0 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+    ERROR(session, "Formatting metrics failed.");
+    jcon_client_sendData(client, (void *)failed, strlen(failed));
+    return;
+  }
+
+  char header[128];
+  int header_length = snprintf(header, sizeof(header), "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n", body_length);
+
+  /* Send until done, sendDataV() may write less than given. */
+  size_t sent = 0;
+  size_t total = (size_t)header_length + body_length;
+  while(sent < total && jcon_client_isConnected(client))
+  {
+    struct iovec iov[2];
+    int iov_count = 0;
+
+    if(sent < (size_t)header_length)
+    {
+      iov[iov_count].iov_base = header + sent;
+      iov[iov_count].iov_len = (size_t)header_length - sent;
+      iov_count++;
+      iov[iov_count].iov_base = body;
+      iov[iov_count].iov_len = body_length;
+      iov_count++;
+    }
+    else
+    {
+      iov[iov_count].iov_base = body + (sent - (size_t)header_length);
+      iov[iov_count].iov_len = total - sent;
+      iov_count++;
+    }
+
+    size_t ret_send = jcon_client_sendDataV(client, iov, iov_count);
+    if(ret_send == 0)
+    {
+      break;
+    }
+    sent += ret_send;
+  }
+
+  free(body);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_metrics_log(jcon_metrics_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session && session->server)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<metrics:%s> %s", jcon_server_getReferenceString(session->server), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<metrics:%s> %s", jcon_server_getReferenceString(session->server), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -0,0 +1,674 @@
+/**
+ * @file jcon_pipeline.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_pipeline.
+ * 
+ * Requests in flight are stored in a table of window
+ * slots. The slot of a request is its id modulo the
+ * window, so replies find their request without search.
+ * Ids, whose slot is still taken by a slower request,
+ * are skipped.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_pipeline.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_alloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/uio.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_pipeline");
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Request in flight.
+ */
+typedef struct __jcon_pipeline_slot
+{
+  int used;                               /**< @c true , if request waits for reply. */
+  uint32_t id;                            /**< Correlation id of request. */
+  unsigned long long deadline;            /**< Time in milliseconds, when request expires. */
+  jcon_pipeline_completion_t completion;  /**< Handler to call with reply. */
+  void *ctx;                              /**< Context pointer passed to handler. */
+} jcon_pipeline_slot_t;
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+struct __jcon_pipeline_session
+{
+  jcon_client_t *client;          /**< Client to send requests through. */
+  jcon_frame_t *frame;            /**< Frame session of client. */
+  jlog_t *logger;                 /**< Logger for debug and error messages. */
+
+  jcon_pipeline_slot_t *slots;    /**< Requests in flight. */
+  size_t window;                  /**< Number of slots. */
+  size_t in_flight;               /**< Number of used slots. */
+  uint32_t next_id;               /**< Id of next request. */
+
+  unsigned long long timeout;     /**< Timeout of requests in milliseconds. @c 0 if disabled. */
+  int processing;                 /**< @c true , while replies are handled. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Takes slot for new request.
+ * 
+ * @param session     Session object.
+ * @param completion  Handler of request.
+ * @param ctx         Context pointer of request.
+ * 
+ * @return            Slot with id of request.
+ * @return            @c NULL , if window is full.
+ */
+static jcon_pipeline_slot_t *jcon_pipeline_takeSlot(jcon_pipeline_t *session, jcon_pipeline_completion_t completion, void *ctx);
+
+/**
+ * @brief Completes request and frees its slot.
+ * 
+ * Slot is freed before the handler is called, so
+ * the handler can send new requests.
+ * 
+ * @param session     Session object.
+ * @param slot        Slot of request.
+ * @param status      Status passed to handler.
+ * @param reply_ptr   Reply data.
+ * @param reply_size  Size of reply in bytes.
+ */
+static void jcon_pipeline_complete(jcon_pipeline_t *session, jcon_pipeline_slot_t *slot, int status, const void *reply_ptr, size_t reply_size);
+
+/**
+ * @brief Completes all requests in flight.
+ * 
+ * @param session Session object.
+ * @param status  Status passed to handlers.
+ */
+static void jcon_pipeline_completeAll(jcon_pipeline_t *session, int status);
+
+/**
+ * @brief Completes requests, whose deadline passed.
+ * 
+ * @param session Session object.
+ */
+static void jcon_pipeline_expire(jcon_pipeline_t *session);
+
+/**
+ * @brief Waits, until window has a free slot.
+ * 
+ * @param session Session object.
+ * 
+ * @return        @c true , if a slot is free.
+ * @return        @c false , if called from completion handler,
+ *                connection was closed or error occured.
+ */
+static int jcon_pipeline_waitSlot(jcon_pipeline_t *session);
+
+/**
+ * @brief Handles reply frame.
+ * 
+ * @param ctx         Session object.
+ * @param client      Client, the frame was recieved from.
+ * @param frame_ptr   Frame data.
+ * @param frame_size  Size of frame in bytes.
+ */
+static void jcon_pipeline_frameHandler(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size);
+
+/**
+ * @brief Writes correlation id in network byte order.
+ * 
+ * @param buffer  Memory of @c #JCON_PIPELINE_ID_SIZE bytes.
+ * @param id      Id to write.
+ */
+static void jcon_pipeline_writeId(uint8_t *buffer, uint32_t id);
+
+/**
+ * @brief Sends log messages to logger with session data.
+ * 
+ * Uses logger. If available adds reference string to log messages.
+ * 
+ * @param session   Session object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jcon_pipeline_log(jcon_pipeline_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_pipeline_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_pipeline_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_pipeline_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_pipeline_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_pipeline_t *jcon_pipeline_init(jcon_client_t *client, size_t prefix_size, size_t frame_max, size_t window, jlog_t *logger)
+{
+  if(client == NULL)
+  {
+    ERROR(NULL, "Client is NULL.");
+    return NULL;
+  }
+
+  if(window == 0 || window > SIZE_MAX / sizeof(jcon_pipeline_slot_t))
+  {
+    ERROR(NULL, "Invalid window [%zu].", window);
+    return NULL;
+  }
+
+  if(frame_max > SIZE_MAX - JCON_PIPELINE_ID_SIZE)
+  {
+    ERROR(NULL, "Invalid maximum frame size [%zu].", frame_max);
+    return NULL;
+  }
+
+  jcon_pipeline_t *session = (jcon_pipeline_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_pipeline_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->client = client;
+  session->logger = logger;
+  session->window = window;
+  session->in_flight = 0;
+  session->next_id = 0;
+  session->timeout = 0;
+  session->processing = false;
+
+  session->slots = (jcon_pipeline_slot_t *)JUTIL_ALLOC_CALLOC(window, sizeof(jcon_pipeline_slot_t));
+  if(session->slots == NULL)
+  {
+    ERROR(session, "calloc() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->frame = jcon_frame_lengthPrefix_init(client, prefix_size, frame_max + JCON_PIPELINE_ID_SIZE, &jcon_pipeline_frameHandler, logger, session);
+  if(session->frame == NULL)
+  {
+    ERROR(session, "jcon_frame_lengthPrefix_init() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session->slots);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_free(jcon_pipeline_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  jcon_pipeline_completeAll(session, JCON_PIPELINE_STATUS_CLOSED);
+
+  jcon_frame_free(session->frame);
+  JUTIL_ALLOC_FREE(session->slots);
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_request(jcon_pipeline_t *session, const void *data_ptr, size_t data_size, jcon_pipeline_completion_t completion, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_pipeline_waitSlot(session) == false)
+  {
+    return false;
+  }
+
+  return jcon_pipeline_tryRequest(session, data_ptr, data_size, completion, ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_requestBuffer(jcon_pipeline_t *session, jutil_buffer_t *request, jcon_pipeline_completion_t completion, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(request == NULL || completion == NULL)
+  {
+    ERROR(session, "No request or completion handler given.");
+    return false;
+  }
+
+  if(jcon_pipeline_waitSlot(session) == false)
+  {
+    return false;
+  }
+
+  jcon_pipeline_slot_t *slot = jcon_pipeline_takeSlot(session, completion, ctx);
+  if(slot == NULL)
+  {
+    return false;
+  }
+
+  /* Id is a buffer of its own, request segments are referenced. */
+  uint8_t id[JCON_PIPELINE_ID_SIZE];
+  jcon_pipeline_writeId(id, slot->id);
+
+  jutil_buffer_t *frame = jutil_buffer_copy_init(id, sizeof(id));
+  int ret = (frame && jutil_buffer_appendBuffer(frame, request) && jcon_frame_sendBuffer(session->frame, frame));
+  jutil_buffer_free(frame);
+
+  if(ret == false)
+  {
+    ERROR(session, "Request [%u] not sent.", (unsigned int)slot->id);
+    slot->used = false;
+    session->in_flight--;
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_tryRequest(jcon_pipeline_t *session, const void *data_ptr, size_t data_size, jcon_pipeline_completion_t completion, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if((data_ptr == NULL && data_size > 0) || completion == NULL)
+  {
+    ERROR(session, "No request or completion handler given.");
+    return false;
+  }
+
+  jcon_pipeline_slot_t *slot = jcon_pipeline_takeSlot(session, completion, ctx);
+  if(slot == NULL)
+  {
+    return false;
+  }
+
+  uint8_t id[JCON_PIPELINE_ID_SIZE];
+  jcon_pipeline_writeId(id, slot->id);
+
+  struct iovec iov[2] =
+  {
+    { id, sizeof(id) },
+    { (void *)data_ptr, data_size }
+  };
+
+  if(jcon_frame_sendV(session->frame, iov, 2) == false)
+  {
+    ERROR(session, "Request [%u] not sent.", (unsigned int)slot->id);
+    slot->used = false;
+    session->in_flight--;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_process(jcon_pipeline_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(session->processing)
+  {
+    ERROR(session, "Called from completion handler.");
+    return -1;
+  }
+
+  session->processing = true;
+  int ret = jcon_frame_process(session->frame);
+  jcon_pipeline_expire(session);
+  session->processing = false;
+
+  if(ret < 0 || jcon_client_isConnected(session->client) == false)
+  {
+    if(session->in_flight > 0)
+    {
+      ERROR(session, "Connection lost with [%zu] requests in flight.", session->in_flight);
+    }
+    jcon_pipeline_completeAll(session, JCON_PIPELINE_STATUS_CLOSED);
+    return -1;
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_wait(jcon_pipeline_t *session, size_t in_flight)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  while(session->in_flight > in_flight)
+  {
+    if(jcon_client_isConnected(session->client) == false)
+    {
+      jcon_pipeline_completeAll(session, JCON_PIPELINE_STATUS_CLOSED);
+      return false;
+    }
+
+    if(jcon_client_newData(session->client) == false)
+    {
+      /* Poll timeout passed, requests may have expired. */
+      jcon_pipeline_expire(session);
+      continue;
+    }
+
+    if(jcon_pipeline_process(session) < 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_setTimeout(jcon_pipeline_t *session, unsigned long long timeout)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  session->timeout = timeout;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_pipeline_getInFlight(jcon_pipeline_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  return session->in_flight;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_parseRequest(const void *frame_ptr, size_t frame_size, uint32_t *id, const void **data_ptr, size_t *data_size)
+{
+  if(frame_ptr == NULL || frame_size < JCON_PIPELINE_ID_SIZE)
+  {
+    return false;
+  }
+
+  const uint8_t *frame = (const uint8_t *)frame_ptr;
+  if(id)
+  {
+    *id = ((uint32_t)frame[0] << 24) | ((uint32_t)frame[1] << 16) | ((uint32_t)frame[2] << 8) | (uint32_t)frame[3];
+  }
+  if(data_ptr)
+  {
+    *data_ptr = frame + JCON_PIPELINE_ID_SIZE;
+  }
+  if(data_size)
+  {
+    *data_size = frame_size - JCON_PIPELINE_ID_SIZE;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_reply(jcon_frame_t *frame, uint32_t id, const void *reply_ptr, size_t reply_size)
+{
+  if(frame == NULL || (reply_ptr == NULL && reply_size > 0))
+  {
+    ERROR(NULL, "No frame session or reply given.");
+    return false;
+  }
+
+  uint8_t id_buffer[JCON_PIPELINE_ID_SIZE];
+  jcon_pipeline_writeId(id_buffer, id);
+
+  struct iovec iov[2] =
+  {
+    { id_buffer, sizeof(id_buffer) },
+    { (void *)reply_ptr, reply_size }
+  };
+
+  return jcon_frame_sendV(frame, iov, 2);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_pipeline_slot_t *jcon_pipeline_takeSlot(jcon_pipeline_t *session, jcon_pipeline_completion_t completion, void *ctx)
+{
+  if(session->in_flight >= session->window)
+  {
+    return NULL;
+  }
+
+  /* A free slot exists, so this ends after at most window ids. */
+  jcon_pipeline_slot_t *slot;
+  do
+  {
+    slot = &session->slots[session->next_id % session->window];
+    session->next_id++;
+  } while(slot->used);
+
+  slot->used = true;
+  slot->id = session->next_id - 1;
+  slot->deadline = (session->timeout > 0 ? jutil_time_getCoarseMillis() + session->timeout : 0);
+  slot->completion = completion;
+  slot->ctx = ctx;
+  session->in_flight++;
+
+  return slot;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_complete(jcon_pipeline_t *session, jcon_pipeline_slot_t *slot, int status, const void *reply_ptr, size_t reply_size)
+{
+  jcon_pipeline_completion_t completion = slot->completion;
+  void *ctx = slot->ctx;
+
+  slot->used = false;
+  session->in_flight--;
+
+  completion(ctx, status, reply_ptr, reply_size);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_completeAll(jcon_pipeline_t *session, int status)
+{
+  for(size_t i = 0; i < session->window && session->in_flight > 0; i++)
+  {
+    if(session->slots[i].used)
+    {
+      jcon_pipeline_complete(session, &session->slots[i], status, NULL, 0);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_expire(jcon_pipeline_t *session)
+{
+  if(session->timeout == 0 || session->in_flight == 0)
+  {
+    return;
+  }
+
+  unsigned long long now = jutil_time_getCoarseMillis();
+  for(size_t i = 0; i < session->window; i++)
+  {
+    jcon_pipeline_slot_t *slot = &session->slots[i];
+    if(slot->used && slot->deadline <= now)
+    {
+      DEBUG(session, "Request [%u] expired.", (unsigned int)slot->id);
+      jcon_pipeline_complete(session, slot, JCON_PIPELINE_STATUS_TIMEOUT, NULL, 0);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_pipeline_waitSlot(jcon_pipeline_t *session)
+{
+  if(session->in_flight < session->window)
+  {
+    return true;
+  }
+
+  /* Replies are read by the running process call. */
+  if(session->processing)
+  {
+    DEBUG(session, "Window is full in completion handler.");
+    return false;
+  }
+
+  return jcon_pipeline_wait(session, session->window - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_frameHandler(void *ctx, jcon_client_t *client, const void *frame_ptr, size_t frame_size)
+{
+  jcon_pipeline_t *session = (jcon_pipeline_t *)ctx;
+
+  uint32_t id;
+  const void *reply_ptr;
+  size_t reply_size;
+  if(jcon_pipeline_parseRequest(frame_ptr, frame_size, &id, &reply_ptr, &reply_size) == false)
+  {
+    ERROR(session, "Reply without correlation id [%zu bytes]. Discarding.", frame_size);
+    return;
+  }
+
+  jcon_pipeline_slot_t *slot = &session->slots[id % session->window];
+  if(slot->used == false || slot->id != id)
+  {
+    /* Request expired or id was not sent by this session. */
+    DEBUG(session, "Reply for unknown request [%u]. Discarding.", (unsigned int)id);
+    return;
+  }
+
+  jcon_pipeline_complete(session, slot, JCON_PIPELINE_STATUS_OK, reply_ptr, reply_size);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_writeId(uint8_t *buffer, uint32_t id)
+{
+  buffer[0] = (uint8_t)(id >> 24);
+  buffer[1] = (uint8_t)(id >> 16);
+  buffer[2] = (uint8_t)(id >> 8);
+  buffer[3] = (uint8_t)id;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_pipeline_log(jcon_pipeline_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session && session->client)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<%s> %s", jcon_client_getReferenceString(session->client), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_client_getReferenceString(session->client), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -0,0 +1,1712 @@
+/**
+ * @file jcon_preFork.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jcon_preFork.
+ * 
+ * The supervisor keeps a @c socketpair() to every worker.
+ * Requests are fixed size structs, metrics are answered with
+ * a header and the text of @c #jutil_metrics_format() .
+ * A worker, whose channel is closed, stops like on a request,
+ * so workers do not outlive a crashed supervisor for long.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for NSIG and MSG_NOSIGNAL */
+
+#include <jayc/jcon_preFork.h>
+#include <jayc/jcon_metrics.h>
+#include <jayc/jcon_server.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_map.h>
+#include <jayc/jproc.h>
+#include <jayc/jutil_alloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_preFork");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Nanoseconds between two runs of supervisor.
+ */
+#define JCON_PREFORK_SUPERVISE_INTERVAL 100000000
+
+/**
+ * @brief Milliseconds to wait for metrics of one worker.
+ */
+#define JCON_PREFORK_TIMEOUT_METRICS 1000
+
+/**
+ * @brief Milliseconds workers get after stop timeout to exit,
+ *        before they are killed.
+ */
+#define JCON_PREFORK_TIMEOUT_EXIT 500
+
+/**
+ * @brief Nanoseconds between checks, if workers exited.
+ */
+#define JCON_PREFORK_EXIT_INTERVAL 10000000
+
+/**
+ * @brief Maximum size of metrics text of one worker.
+ */
+#define JCON_PREFORK_SIZE_METRICS_MAX (64 * 1024 * 1024)
+
+/**
+ * @brief Largest double, that still holds every integer exactly.
+ */
+#define JCON_PREFORK_INTEGER_MAX 9007199254740992.0
+
+/**
+ * @brief Request for metrics of worker.
+ */
+#define JCON_PREFORK_REQUEST_METRICS 1
+
+/**
+ * @brief Request to drain and exit.
+ */
+#define JCON_PREFORK_REQUEST_STOP 2
+
+/**
+ * @brief Name of supervisor thread.
+ */
+#define JCON_PREFORK_THREAD_NAME "jcon-prefork"
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Request from supervisor to worker.
+ */
+typedef struct __jcon_preFork_request
+{
+  uint32_t type;      /**< @c #JCON_PREFORK_REQUEST_METRICS or @c #JCON_PREFORK_REQUEST_STOP . */
+  uint32_t reserved;  /**< Padding, always @c 0 . */
+  uint64_t sequence;  /**< Returned with answer, to drop late answers. */
+  int64_t timeout;    /**< Drain timeout in milliseconds for stop. */
+} jcon_preFork_request_t;
+
+/**
+ * @brief Header of metrics answer. Followed by text.
+ */
+typedef struct __jcon_preFork_response
+{
+  uint64_t sequence;  /**< Sequence of request. */
+  uint64_t length;    /**< Length of following text. */
+} jcon_preFork_response_t;
+
+/**
+ * @brief State of one worker process.
+ */
+typedef struct __jcon_preFork_worker
+{
+  pid_t pid;                    /**< Process ID, @c 0 if not running. */
+  int channel;                  /**< Supervisor end of socket pair, @c -1 if closed. */
+  int stopping;                 /**< Stop request was sent. */
+  unsigned long long started;   /**< Coarse milliseconds of last start. */
+} jcon_preFork_worker_t;
+
+/**
+ * @brief Session object of supervisor.
+ */
+struct __jcon_preFork_session
+{
+  jcon_server_t *server;                              /**< Shared listening server. */
+  size_t loop_number;                                 /**< Event loops per worker. */
+  jcon_system_threadData_handler_t data_handler;      /**< Handler for data of connections. */
+  jcon_system_threadCreate_handler_t create_handler;  /**< Handler for new connections. */
+  jcon_system_threadClose_handler_t close_handler;    /**< Handler for closed connections. */
+  jcon_preFork_worker_handler_t worker_handler;       /**< Called in new workers. */
+  jlog_t *logger;                                     /**< Logger for debug and error messages. */
+  void *session_context;                              /**< Context pointer passed to handlers. */
+
+  jcon_preFork_worker_t *workers; /**< Array of workers. */
+  size_t worker_number;           /**< Number of workers. */
+  pthread_mutex_t mutex;          /**< Locks workers and channels. */
+  uint64_t sequence;              /**< Sequence of last metrics request. */
+  long stop_timeout;              /**< Drain timeout for free and restarts. */
+
+  jutil_thread_t *supervisor;     /**< Reaps and restarts workers. */
+  atomic_int running;             /**< Workers are restarted, while set. */
+  atomic_size_t restarts;         /**< Number of restarted workers. */
+
+  jcon_metrics_t *metrics;        /**< Endpoint of @c #jcon_preFork_serveMetrics() . */
+  int shutdown_registered;        /**< Handlers added to jproc_exit. */
+};
+
+/**
+ * @brief Merged sample of a metric family.
+ */
+typedef struct __jcon_preFork_sample
+{
+  char *key;        /**< Name and labels of sample. */
+  double value;     /**< Merged value. */
+  int is_quantile;  /**< Quantiles are merged with maximum. */
+} jcon_preFork_sample_t;
+
+/**
+ * @brief Merged metric family.
+ */
+typedef struct __jcon_preFork_family
+{
+  char *name;                       /**< Name of family. */
+  char *help;                       /**< @c # HELP line, @c NULL if not sent. */
+  char *type;                       /**< @c # TYPE line, @c NULL if not sent. */
+  jcon_preFork_sample_t *samples;   /**< Samples in order of first appearance. */
+  size_t sample_number;             /**< Number of samples. */
+  size_t sample_capacity;           /**< Allocated samples. */
+} jcon_preFork_family_t;
+
+/**
+ * @brief Metrics of all workers, while they are merged.
+ */
+typedef struct __jcon_preFork_merge
+{
+  jutil_map_t *index;                 /**< Maps names to families. */
+  jcon_preFork_family_t **families;   /**< Families in order of first appearance. */
+  size_t family_number;               /**< Number of families. */
+  size_t family_capacity;             /**< Allocated families. */
+} jcon_preFork_merge_t;
+
+/**
+ * @brief Growing text buffer.
+ */
+typedef struct __jcon_preFork_text
+{
+  char *data;       /**< Text, @c NULL after error. */
+  size_t length;    /**< Length of text. */
+  size_t capacity;  /**< Allocated bytes. */
+} jcon_preFork_text_t;
+
+
+
+//==============================================================================
+// Define global variables.
+//
+
+/**
+ * @brief Index of worker, @c -1 in supervisor.
+ */
+static long jcon_preFork_worker_index = -1;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Loop function of supervisor thread.
+ * 
+ * Reaps exited workers and restarts them.
+ * 
+ * @param ctx     Session object.
+ * @param thread  Thread session.
+ * 
+ * @return        @c true , thread keeps running.
+ */
+static int jcon_preFork_supervise(void *ctx, jutil_thread_t *thread);
+
+/**
+ * @brief Forks worker. Mutex has to be locked.
+ * 
+ * @param session Session object.
+ * @param index   Index of worker.
+ * 
+ * @return        @c true , if worker was forked.
+ * @return        @c false , if error occured.
+ */
+static int jcon_preFork_spawn(jcon_preFork_t *session, size_t index);
+
+/**
+ * @brief Runs worker after fork. Does not return.
+ * 
+ * @param session Session object (copy of worker).
+ * @param index   Index of worker.
+ * @param channel Worker end of socket pair.
+ */
+static void jcon_preFork_worker_run(jcon_preFork_t *session, size_t index, int channel);
+
+/**
+ * @brief Sends metrics of worker to supervisor.
+ * 
+ * @param channel   Worker end of socket pair.
+ * @param sequence  Sequence of request.
+ * 
+ * @return          @c true , if metrics were sent.
+ * @return          @c false , if error occured.
+ */
+static int jcon_preFork_worker_sendMetrics(int channel, uint64_t sequence);
+
+/**
+ * @brief Resets signals inherited from supervisor.
+ * 
+ * Unblocks all signals (library threads block them) and
+ * restores default handlers. @c SIGINT is ignored, so
+ * Ctrl-C on the terminal only reaches the supervisor,
+ * which then stops the workers.
+ */
+static void jcon_preFork_worker_resetSignals(void);
+
+/**
+ * @brief Collects exited workers. Mutex has to be locked.
+ * 
+ * @param session Session object.
+ * 
+ * @return        Number of running workers.
+ */
+static size_t jcon_preFork_reap(jcon_preFork_t *session);
+
+/**
+ * @brief Closes channel and forgets worker. Mutex has to be locked.
+ * 
+ * @param worker Worker, that exited.
+ */
+static void jcon_preFork_forget(jcon_preFork_worker_t *worker);
+
+/**
+ * @brief Sends stop request to all workers.
+ * 
+ * @param session Session object.
+ * @param timeout Drain timeout in milliseconds.
+ */
+static void jcon_preFork_requestStop(jcon_preFork_t *session, long timeout);
+
+/**
+ * @brief Waits for workers to exit, kills them at deadline.
+ * 
+ * @param session   Session object.
+ * @param deadline  Time to wait for workers.
+ * 
+ * @return          @c true , if all workers exited by themselves.
+ * @return          @c false , if workers were killed.
+ */
+static int jcon_preFork_waitStopped(jcon_preFork_t *session, const jutil_time_deadline_t *deadline);
+
+/**
+ * @brief Reads metrics answer of worker. Mutex has to be locked.
+ * 
+ * Answers of earlier requests, that timed out, are skipped.
+ * If the channel is out of sync, it is closed,
+ * so the worker exits and is restarted.
+ * 
+ * @param session   Session object.
+ * @param worker    Worker to read from.
+ * @param sequence  Sequence of request.
+ * 
+ * @return          Text of metrics (freed with @c free() ).
+ * @return          @c NULL , if worker did not answer.
+ */
+static char *jcon_preFork_readMetrics(jcon_preFork_t *session, jcon_preFork_worker_t *worker, uint64_t sequence);
+
+/**
+ * @brief Reads from descriptor until full or deadline.
+ * 
+ * @param fd        Descriptor to read from.
+ * @param buf       Buffer to fill.
+ * @param size      Bytes to read.
+ * @param deadline  Deadline, @c NULL waits forever.
+ * 
+ * @return          Bytes read. Less than @c size ,
+ *                  if timed out, closed or error occured.
+ */
+static size_t jcon_preFork_readAll(int fd, void *buf, size_t size, const jutil_time_deadline_t *deadline);
+
+/**
+ * @brief Writes full buffer to socket.
+ * 
+ * @param fd    Socket to write to.
+ * @param buf   Data to write.
+ * @param size  Bytes to write.
+ * 
+ * @return      @c true , if all data was written.
+ * @return      @c false , if error occured.
+ */
+static int jcon_preFork_writeAll(int fd, const void *buf, size_t size);
+
+/**
+ * @brief Parses metrics text of one worker into merge.
+ * 
+ * @param merge Merge to add samples to.
+ * @param text  Text of worker. Modified while parsing.
+ * 
+ * @return      @c true , if text was parsed.
+ * @return      @c false , if error occured.
+ */
+static int jcon_preFork_merge_parse(jcon_preFork_merge_t *merge, char *text);
+
+/**
+ * @brief Returns family, creates it if needed.
+ * 
+ * @param merge   Merge object.
+ * @param name    Name of family (not terminated).
+ * @param length  Length of name.
+ * 
+ * @return        Family object.
+ * @return        @c NULL , if error occured.
+ */
+static jcon_preFork_family_t *jcon_preFork_merge_getFamily(jcon_preFork_merge_t *merge, const char *name, size_t length);
+
+/**
+ * @brief Adds value to sample of family.
+ * 
+ * @param family      Family of sample.
+ * @param key         Name and labels of sample.
+ * @param value       Value of worker.
+ * @param is_quantile Merge with maximum instead of sum.
+ * 
+ * @return            @c true , if value was added.
+ * @return            @c false , if error occured.
+ */
+static int jcon_preFork_merge_addSample(jcon_preFork_family_t *family, const char *key, double value, int is_quantile);
+
+/**
+ * @brief Writes merged metrics as text.
+ * 
+ * @param merge Merge object.
+ * @param text  Buffer to append to.
+ */
+static void jcon_preFork_merge_format(jcon_preFork_merge_t *merge, jcon_preFork_text_t *text);
+
+/**
+ * @brief Frees families of merge.
+ * 
+ * @param merge Merge object.
+ */
+static void jcon_preFork_merge_clear(jcon_preFork_merge_t *merge);
+
+/**
+ * @brief Appends formatted string to text.
+ * 
+ * Sets data to @c NULL , if memory could not be allocated.
+ * 
+ * @param text  Buffer to append to.
+ * @param fmt   Format string for stdarg.h .
+ */
+static void jcon_preFork_text_append(jcon_preFork_text_t *text, const char *fmt, ...);
+
+/**
+ * @brief Adapter for jcon_metrics.
+ * 
+ * @param ctx     Session object.
+ * @param length  Set to length of text.
+ * 
+ * @return        Text of @c #jcon_preFork_formatMetrics() .
+ */
+static char *jcon_preFork_metrics_handler(void *ctx, size_t *length);
+
+/**
+ * @brief Shutdown handler, tells workers to stop.
+ * 
+ * @param exit_value  Exit value of process.
+ * @param deadline    End of phase.
+ * @param ctx         Session object.
+ */
+static void jcon_preFork_shutdown_accept(int exit_value, const jutil_time_deadline_t *deadline, void *ctx);
+
+/**
+ * @brief Shutdown handler, waits for workers until deadline.
+ * 
+ * @param exit_value  Exit value of process.
+ * @param deadline    End of phase.
+ * @param ctx         Session object.
+ */
+static void jcon_preFork_shutdown_drain(int exit_value, const jutil_time_deadline_t *deadline, void *ctx);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * @param session   Session for logger and reference string.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_preFork_log(jcon_preFork_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allows to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_preFork_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_preFork_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_preFork_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_preFork_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_preFork_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jcon_preFork_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_preFork_t *jcon_preFork_init
+(
+  jcon_server_t *server,
+  size_t process_number,
+  size_t loop_number,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+)
+{
+  if(server == NULL)
+  {
+    ERROR(NULL, "Server is NULL.");
+    return NULL;
+  }
+
+  if(process_number == 0 || process_number > JCON_PREFORK_PROCESSES_MAX)
+  {
+    ERROR(NULL, "Invalid number of processes [%zu] (1 - %d).", process_number, JCON_PREFORK_PROCESSES_MAX);
+    return NULL;
+  }
+
+  if(loop_number == 0)
+  {
+    ERROR(NULL, "Invalid number of event loops [0].");
+    return NULL;
+  }
+
+  if(jcon_server_isOpen(server) == false)
+  {
+    if(jcon_server_reset(server) == false)
+    {
+      ERROR(NULL, "jcon_server_reset() failed.");
+      return NULL;
+    }
+  }
+
+  if(jcon_server_getFileDescriptor(server) < 0)
+  {
+    ERROR(NULL, "Server does not provide a file descriptor.");
+    return NULL;
+  }
+
+  jcon_preFork_t *session = (jcon_preFork_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_preFork_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->server = server;
+  session->loop_number = loop_number;
+  session->data_handler = data_handler;
+  session->create_handler = create_handler;
+  session->close_handler = close_handler;
+  session->worker_handler = NULL;
+  session->logger = logger;
+  session->session_context = ctx;
+  session->worker_number = process_number;
+  session->sequence = 0;
+  session->stop_timeout = JCON_PREFORK_STOP_TIMEOUT_DEFAULT;
+  session->metrics = NULL;
+  session->shutdown_registered = false;
+  atomic_init(&session->running, false);
+  atomic_init(&session->restarts, 0);
+
+  session->workers = (jcon_preFork_worker_t *)JUTIL_ALLOC_CALLOC(process_number, sizeof(jcon_preFork_worker_t));
+  if(session->workers == NULL)
+  {
+    ERROR(session, "calloc() failed.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  for(size_t i = 0; i < process_number; i++)
+  {
+    session->workers[i].channel = -1;
+  }
+
+  if(pthread_mutex_init(&session->mutex, NULL) != 0)
+  {
+    ERROR(session, "pthread_mutex_init() failed.");
+    JUTIL_ALLOC_FREE(session->workers);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  jutil_thread_options_t options;
+  memset(&options, 0, sizeof(options));
+  options.name = JCON_PREFORK_THREAD_NAME;
+
+  session->supervisor = jutil_thread_options_init(&jcon_preFork_supervise, logger, 0, JCON_PREFORK_SUPERVISE_INTERVAL, session, &options);
+  if(session->supervisor == NULL)
+  {
+    ERROR(session, "jutil_thread_options_init() failed.");
+    pthread_mutex_destroy(&session->mutex);
+    JUTIL_ALLOC_FREE(session->workers);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  DEBUG(session, "Session created with [%zu] workers.", process_number);
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_free(jcon_preFork_t *session)
+{
+  if(session == NULL)
+  {
+    return;
+  }
+
+  if(session->shutdown_registered)
+  {
+    jproc_exit_removeShutdownHandler(JPROC_EXIT_PHASE_ACCEPT, &jcon_preFork_shutdown_accept, session);
+    jproc_exit_removeShutdownHandler(JPROC_EXIT_PHASE_DRAIN, &jcon_preFork_shutdown_drain, session);
+  }
+
+  /* Metrics thread asks workers, so it has to be gone first. */
+  jcon_metrics_free(session->metrics);
+
+  atomic_store(&session->running, false);
+  jutil_thread_free(session->supervisor);
+
+  jcon_preFork_stop(session, session->stop_timeout);
+
+  DEBUG(session, "Freeing session.");
+  pthread_mutex_destroy(&session->mutex);
+  JUTIL_ALLOC_FREE(session->workers);
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_setWorkerHandler(jcon_preFork_t *session, jcon_preFork_worker_handler_t handler)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  pthread_mutex_lock(&session->mutex);
+  session->worker_handler = handler;
+  pthread_mutex_unlock(&session->mutex);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_setStopTimeout(jcon_preFork_t *session, long timeout)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  pthread_mutex_lock(&session->mutex);
+  session->stop_timeout = timeout;
+  pthread_mutex_unlock(&session->mutex);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_start(jcon_preFork_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  int ret = true;
+
+  pthread_mutex_lock(&session->mutex);
+  atomic_store(&session->running, true);
+  for(size_t i = 0; i < session->worker_number; i++)
+  {
+    if(session->workers[i].pid == 0 && jcon_preFork_spawn(session, i) == false)
+    {
+      ret = false;
+    }
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  if(jutil_thread_isRunning(session->supervisor) == false)
+  {
+    if(jutil_thread_start(session->supervisor) == false)
+    {
+      ERROR(session, "jutil_thread_start() failed.");
+      return false;
+    }
+  }
+
+  INFO(session, "Started [%zu] workers.", jcon_preFork_getRunning(session));
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_stop(jcon_preFork_t *session, long timeout)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  jcon_preFork_requestStop(session, timeout);
+
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, (timeout < 0 ? -1 : timeout + JCON_PREFORK_TIMEOUT_EXIT));
+  return jcon_preFork_waitStopped(session, &deadline);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_preFork_getRunning(jcon_preFork_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  size_t running = 0;
+
+  pthread_mutex_lock(&session->mutex);
+  for(size_t i = 0; i < session->worker_number; i++)
+  {
+    if(session->workers[i].pid > 0)
+    {
+      running++;
+    }
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  return running;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_preFork_getRestarts(jcon_preFork_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  return atomic_load(&session->restarts);
+}
+
+//------------------------------------------------------------------------------
+//
+long jcon_preFork_getWorker(void)
+{
+  return jcon_preFork_worker_index;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jcon_preFork_formatMetrics(jcon_preFork_t *session, size_t *length)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  jcon_preFork_merge_t merge;
+  memset(&merge, 0, sizeof(merge));
+  merge.index = jutil_map_init();
+  if(merge.index == NULL)
+  {
+    ERROR(session, "jutil_map_init() failed.");
+    return NULL;
+  }
+
+  int ret = true;
+  size_t running = 0;
+
+  pthread_mutex_lock(&session->mutex);
+  uint64_t sequence = ++session->sequence;
+  for(size_t i = 0; i < session->worker_number && ret; i++)
+  {
+    jcon_preFork_worker_t *worker = &session->workers[i];
+    if(worker->pid <= 0)
+    {
+      continue;
+    }
+
+    running++;
+    if(worker->channel < 0 || worker->stopping)
+    {
+      continue;
+    }
+
+    jcon_preFork_request_t request;
+    memset(&request, 0, sizeof(request));
+    request.type = JCON_PREFORK_REQUEST_METRICS;
+    request.sequence = sequence;
+
+    if(jcon_preFork_writeAll(worker->channel, &request, sizeof(request)) == false)
+    {
+      continue;
+    }
+
+    char *text = jcon_preFork_readMetrics(session, worker, sequence);
+    if(text == NULL)
+    {
+      WARN(session, "Worker [%zu] did not send metrics.", i);
+      continue;
+    }
+
+    ret = jcon_preFork_merge_parse(&merge, text);
+    JUTIL_ALLOC_FREE(text);
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  jcon_preFork_text_t text;
+  memset(&text, 0, sizeof(text));
+
+  if(ret)
+  {
+    jcon_preFork_merge_format(&merge, &text);
+    jcon_preFork_text_append(&text, "# HELP jcon_prefork_workers Running worker processes.\n");
+    jcon_preFork_text_append(&text, "# TYPE jcon_prefork_workers gauge\n");
+    jcon_preFork_text_append(&text, "jcon_prefork_workers %zu\n", running);
+    jcon_preFork_text_append(&text, "# HELP jcon_prefork_restarts_total Worker processes restarted by supervisor.\n");
+    jcon_preFork_text_append(&text, "# TYPE jcon_prefork_restarts_total counter\n");
+    jcon_preFork_text_append(&text, "jcon_prefork_restarts_total %zu\n", atomic_load(&session->restarts));
+  }
+  jcon_preFork_merge_clear(&merge);
+
+  if(text.data == NULL)
+  {
+    ERROR(session, "Merging metrics failed.");
+    return NULL;
+  }
+
+  if(length)
+  {
+    *length = text.length;
+  }
+  return text.data;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_serveMetrics(jcon_preFork_t *session, char *address, uint16_t port)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->metrics)
+  {
+    ERROR(session, "Metrics are already served.");
+    return false;
+  }
+
+  session->metrics = jcon_metrics_handler_init(address, port, &jcon_preFork_metrics_handler, session, session->logger);
+  if(session->metrics == NULL)
+  {
+    ERROR(session, "jcon_metrics_handler_init() failed.");
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_addShutdownHandlers(jcon_preFork_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->shutdown_registered)
+  {
+    return true;
+  }
+
+  if(jproc_exit_addShutdownHandler(JPROC_EXIT_PHASE_ACCEPT, &jcon_preFork_shutdown_accept, session) == false)
+  {
+    ERROR(session, "jproc_exit_addShutdownHandler() failed.");
+    return false;
+  }
+
+  if(jproc_exit_addShutdownHandler(JPROC_EXIT_PHASE_DRAIN, &jcon_preFork_shutdown_drain, session) == false)
+  {
+    ERROR(session, "jproc_exit_addShutdownHandler() failed.");
+    jproc_exit_removeShutdownHandler(JPROC_EXIT_PHASE_ACCEPT, &jcon_preFork_shutdown_accept, session);
+    return false;
+  }
+
+  session->shutdown_registered = true;
+  return true;
+}
+
+
+
+//==============================================================================
+// Implement supervisor functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_supervise(void *ctx, jutil_thread_t *thread)
+{
+  jcon_preFork_t *session = (jcon_preFork_t *)ctx;
+
+  pthread_mutex_lock(&session->mutex);
+  jcon_preFork_reap(session);
+
+  if(atomic_load(&session->running))
+  {
+    unsigned long long now = jutil_time_getCoarseMillis();
+    for(size_t i = 0; i < session->worker_number; i++)
+    {
+      jcon_preFork_worker_t *worker = &session->workers[i];
+      if(worker->pid != 0 || now - worker->started < JCON_PREFORK_RESTART_DELAY)
+      {
+        continue;
+      }
+
+      if(jcon_preFork_spawn(session, i))
+      {
+        atomic_fetch_add(&session->restarts, 1);
+        INFO(session, "Restarted worker [%zu].", i);
+      }
+    }
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_spawn(jcon_preFork_t *session, size_t index)
+{
+  jcon_preFork_worker_t *worker = &session->workers[index];
+  worker->started = jutil_time_getCoarseMillis();
+
+  int channels[2];
+  if(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, channels) < 0)
+  {
+    ERROR(session, "socketpair() failed. Error: %s.", strerror(errno));
+    return false;
+  }
+
+  pid_t pid = fork();
+  if(pid < 0)
+  {
+    ERROR(session, "fork() failed. Error: %s.", strerror(errno));
+    close(channels[0]);
+    close(channels[1]);
+    return false;
+  }
+
+  if(pid == 0)
+  {
+    close(channels[0]);
+    jcon_preFork_worker_run(session, index, channels[1]);
+  }
+
+  close(channels[1]);
+  worker->pid = pid;
+  worker->channel = channels[0];
+  worker->stopping = false;
+
+  DEBUG(session, "Forked worker [%zu] (pid [%d]).", index, (int)pid);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_preFork_reap(jcon_preFork_t *session)
+{
+  size_t running = 0;
+
+  for(size_t i = 0; i < session->worker_number; i++)
+  {
+    jcon_preFork_worker_t *worker = &session->workers[i];
+    if(worker->pid <= 0)
+    {
+      continue;
+    }
+
+    int status;
+    pid_t ret = waitpid(worker->pid, &status, WNOHANG);
+    if(ret == 0)
+    {
+      running++;
+      continue;
+    }
+
+    if(ret < 0)
+    {
+      ERROR(session, "waitpid() failed for worker [%zu]. Error: %s.", i, strerror(errno));
+    }
+    else if(WIFSIGNALED(status))
+    {
+      WARN(session, "Worker [%zu] (pid [%d]) killed by signal [%d].", i, (int)worker->pid, WTERMSIG(status));
+    }
+    else if(worker->stopping == false || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+      WARN(session, "Worker [%zu] (pid [%d]) exited with [%d].", i, (int)worker->pid, WEXITSTATUS(status));
+    }
+    else
+    {
+      DEBUG(session, "Worker [%zu] (pid [%d]) stopped.", i, (int)worker->pid);
+    }
+
+    jcon_preFork_forget(worker);
+  }
+
+  return running;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_forget(jcon_preFork_worker_t *worker)
+{
+  if(worker->channel >= 0)
+  {
+    close(worker->channel);
+  }
+
+  worker->pid = 0;
+  worker->channel = -1;
+  worker->stopping = false;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_requestStop(jcon_preFork_t *session, long timeout)
+{
+  atomic_store(&session->running, false);
+
+  jcon_preFork_request_t request;
+  memset(&request, 0, sizeof(request));
+  request.type = JCON_PREFORK_REQUEST_STOP;
+  request.timeout = timeout;
+
+  pthread_mutex_lock(&session->mutex);
+  for(size_t i = 0; i < session->worker_number; i++)
+  {
+    jcon_preFork_worker_t *worker = &session->workers[i];
+    if(worker->pid <= 0 || worker->stopping)
+    {
+      continue;
+    }
+
+    /* If writing fails, worker is already gone and gets reaped. */
+    if(worker->channel >= 0)
+    {
+      jcon_preFork_writeAll(worker->channel, &request, sizeof(request));
+    }
+    worker->stopping = true;
+  }
+  pthread_mutex_unlock(&session->mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_waitStopped(jcon_preFork_t *session, const jutil_time_deadline_t *deadline)
+{
+  while(true)
+  {
+    pthread_mutex_lock(&session->mutex);
+    size_t running = jcon_preFork_reap(session);
+    pthread_mutex_unlock(&session->mutex);
+
+    if(running == 0)
+    {
+      return true;
+    }
+
+    if(jutil_time_deadline_isExpired(deadline))
+    {
+      break;
+    }
+
+    jutil_time_sleep(0, JCON_PREFORK_EXIT_INTERVAL, false);
+  }
+
+  size_t killed = 0;
+
+  pthread_mutex_lock(&session->mutex);
+  for(size_t i = 0; i < session->worker_number; i++)
+  {
+    jcon_preFork_worker_t *worker = &session->workers[i];
+    if(worker->pid <= 0)
+    {
+      continue;
+    }
+
+    kill(worker->pid, SIGKILL);
+    while(waitpid(worker->pid, NULL, 0) < 0 && errno == EINTR);
+    jcon_preFork_forget(worker);
+    killed++;
+  }
+  pthread_mutex_unlock(&session->mutex);
+
+  WARN(session, "Killed [%zu] workers, that did not stop in time.", killed);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jcon_preFork_readMetrics(jcon_preFork_t *session, jcon_preFork_worker_t *worker, uint64_t sequence)
+{
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, JCON_PREFORK_TIMEOUT_METRICS);
+
+  while(true)
+  {
+    jcon_preFork_response_t response;
+    size_t ret = jcon_preFork_readAll(worker->channel, &response, sizeof(response), &deadline);
+    if(ret == 0)
+    {
+      /* Nothing read, answer may still come and is skipped next time. */
+      return NULL;
+    }
+
+    if(ret < sizeof(response) || response.length > JCON_PREFORK_SIZE_METRICS_MAX)
+    {
+      break;
+    }
+
+    char *text = (char *)JUTIL_ALLOC_MALLOC(response.length + 1);
+    if(text == NULL)
+    {
+      ERROR(session, "malloc() failed.");
+      break;
+    }
+
+    if(jcon_preFork_readAll(worker->channel, text, response.length, &deadline) < response.length)
+    {
+      JUTIL_ALLOC_FREE(text);
+      break;
+    }
+    text[response.length] = '\0';
+
+    if(response.sequence == sequence)
+    {
+      return text;
+    }
+    JUTIL_ALLOC_FREE(text);
+  }
+
+  ERROR(session, "Channel to worker (pid [%d]) out of sync. Closing it.", (int)worker->pid);
+  close(worker->channel);
+  worker->channel = -1;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_preFork_readAll(int fd, void *buf, size_t size, const jutil_time_deadline_t *deadline)
+{
+  size_t done = 0;
+
+  while(done < size)
+  {
+    if(deadline)
+    {
+      struct pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLIN;
+      pfd.revents = 0;
+
+      int ret = poll(&pfd, 1, jutil_time_deadline_getRemaining(deadline));
+      if(ret < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if(ret <= 0)
+      {
+        break;
+      }
+    }
+
+    ssize_t ret = read(fd, (char *)buf + done, size - done);
+    if(ret < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if(ret <= 0)
+    {
+      break;
+    }
+    done += (size_t)ret;
+  }
+
+  return done;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_writeAll(int fd, const void *buf, size_t size)
+{
+  size_t done = 0;
+
+  while(done < size)
+  {
+    ssize_t ret = send(fd, (const char *)buf + done, size - done, MSG_NOSIGNAL);
+    if(ret < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if(ret <= 0)
+    {
+      return false;
+    }
+    done += (size_t)ret;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jcon_preFork_metrics_handler(void *ctx, size_t *length)
+{
+  return jcon_preFork_formatMetrics((jcon_preFork_t *)ctx, length);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_shutdown_accept(int exit_value, const jutil_time_deadline_t *deadline, void *ctx)
+{
+  jcon_preFork_t *session = (jcon_preFork_t *)ctx;
+
+  /* Workers drain until end of shutdown, the drain phase waits for them. */
+  jcon_preFork_requestStop(session, jutil_time_deadline_getRemaining(deadline));
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_shutdown_drain(int exit_value, const jutil_time_deadline_t *deadline, void *ctx)
+{
+  jcon_preFork_waitStopped((jcon_preFork_t *)ctx, deadline);
+}
+
+
+
+//==============================================================================
+// Implement worker functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_worker_run(jcon_preFork_t *session, size_t index, int channel)
+{
+  jcon_preFork_worker_index = (long)index;
+
+  /* Channels of other workers are only used by the supervisor. */
+  for(size_t i = 0; i < session->worker_number; i++)
+  {
+    if(session->workers[i].channel >= 0)
+    {
+      close(session->workers[i].channel);
+    }
+  }
+
+  jcon_preFork_worker_resetSignals();
+
+  if(session->worker_handler)
+  {
+    session->worker_handler(session->session_context, index);
+  }
+
+  jcon_system_t *system = jcon_system_eventLoop_init
+  (
+    session->server,
+    session->loop_number,
+    session->data_handler,
+    session->create_handler,
+    session->close_handler,
+    session->logger,
+    session->session_context
+  );
+  if(system == NULL)
+  {
+    ERROR(session, "Worker [%zu]: jcon_system_eventLoop_init() failed.", index);
+    _exit(EXIT_FAILURE);
+  }
+
+  long timeout = session->stop_timeout;
+
+  while(true)
+  {
+    jcon_preFork_request_t request;
+    if(jcon_preFork_readAll(channel, &request, sizeof(request), NULL) < sizeof(request))
+    {
+      /* Supervisor is gone. */
+      break;
+    }
+
+    if(request.type == JCON_PREFORK_REQUEST_STOP)
+    {
+      timeout = (long)request.timeout;
+      break;
+    }
+
+    if(request.type == JCON_PREFORK_REQUEST_METRICS && jcon_preFork_worker_sendMetrics(channel, request.sequence) == false)
+    {
+      break;
+    }
+  }
+
+  DEBUG(session, "Worker [%zu] stopping.", index);
+  jcon_system_drain(system, timeout);
+  jcon_system_free(system);
+  close(channel);
+  _exit(EXIT_SUCCESS);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_worker_sendMetrics(int channel, uint64_t sequence)
+{
+  size_t length = 0;
+  char *text = jutil_metrics_format(&length);
+  if(text == NULL)
+  {
+    length = 0;
+  }
+
+  jcon_preFork_response_t response;
+  response.sequence = sequence;
+  response.length = length;
+
+  int ret = jcon_preFork_writeAll(channel, &response, sizeof(response));
+  if(ret && length > 0)
+  {
+    ret = jcon_preFork_writeAll(channel, text, length);
+  }
+
+  free(text);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_worker_resetSignals(void)
+{
+  sigset_t mask;
+  sigemptyset(&mask);
+  pthread_sigmask(SIG_SETMASK, &mask, NULL);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_handler = SIG_DFL;
+
+  /* Fails for signals, that can not be changed. */
+  for(int i = 1; i < NSIG; i++)
+  {
+    if(i != SIGKILL && i != SIGSTOP)
+    {
+      sigaction(i, &action, NULL);
+    }
+  }
+
+  action.sa_handler = SIG_IGN;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGPIPE, &action, NULL);
+}
+
+
+
+//==============================================================================
+// Implement merge functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_merge_parse(jcon_preFork_merge_t *merge, char *text)
+{
+  jcon_preFork_family_t *family = NULL;
+  char *line = text;
+
+  while(*line)
+  {
+    char *end = strchr(line, '\n');
+    char *next = (end ? end + 1 : line + strlen(line));
+    if(end)
+    {
+      *end = '\0';
+    }
+
+    if(strncmp(line, "# HELP ", 7) == 0 || strncmp(line, "# TYPE ", 7) == 0)
+    {
+      char *name = line + 7;
+      size_t length = strcspn(name, " ");
+
+      family = jcon_preFork_merge_getFamily(merge, name, length);
+      if(family == NULL)
+      {
+        return false;
+      }
+
+      char **target = (line[2] == 'H' ? &family->help : &family->type);
+      if(*target == NULL)
+      {
+        *target = JUTIL_ALLOC_STRDUP(line);
+        if(*target == NULL)
+        {
+          return false;
+        }
+      }
+    }
+    else if(line[0] != '#' && line[0] != '\0')
+    {
+      /* Labels may contain spaces in quoted values. */
+      char *p = line + strcspn(line, " {");
+      size_t name_length = (size_t)(p - line);
+      if(*p == '{')
+      {
+        int quoted = false;
+        for(p++; *p && (quoted || *p != '}'); p++)
+        {
+          if(*p == '\\' && p[1])
+          {
+            p++;
+          }
+          else if(*p == '"')
+          {
+            quoted = !quoted;
+          }
+        }
+        if(*p == '}')
+        {
+          p++;
+        }
+      }
+
+      char *value_end;
+      double value = strtod(p, &value_end);
+      if(value_end != p)
+      {
+        *p = '\0';
+
+        /* Samples of summaries carry suffixes ( _sum , _count ) of their family. */
+        if(family == NULL || strncmp(family->name, line, strlen(family->name)) != 0)
+        {
+          family = jcon_preFork_merge_getFamily(merge, line, name_length);
+          if(family == NULL)
+          {
+            return false;
+          }
+        }
+
+        int is_quantile = (strstr(line + name_length, "quantile=\"") != NULL);
+        if(jcon_preFork_merge_addSample(family, line, value, is_quantile) == false)
+        {
+          return false;
+        }
+      }
+    }
+
+    line = next;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_preFork_family_t *jcon_preFork_merge_getFamily(jcon_preFork_merge_t *merge, const char *name, size_t length)
+{
+  char *index = JUTIL_ALLOC_STRNDUP(name, length);
+  if(index == NULL)
+  {
+    return NULL;
+  }
+
+  jcon_preFork_family_t *family = (jcon_preFork_family_t *)jutil_map_get(merge->index, index);
+  if(family)
+  {
+    JUTIL_ALLOC_FREE(index);
+    return family;
+  }
+
+  if(merge->family_number == merge->family_capacity)
+  {
+    size_t capacity = (merge->family_capacity ? merge->family_capacity * 2 : 16);
+    jcon_preFork_family_t **families = (jcon_preFork_family_t **)JUTIL_ALLOC_REALLOC(merge->families, capacity * sizeof(jcon_preFork_family_t *));
+    if(families == NULL)
+    {
+      JUTIL_ALLOC_FREE(index);
+      return NULL;
+    }
+    merge->families = families;
+    merge->family_capacity = capacity;
+  }
+
+  family = (jcon_preFork_family_t *)JUTIL_ALLOC_CALLOC(1, sizeof(jcon_preFork_family_t));
+  if(family == NULL)
+  {
+    JUTIL_ALLOC_FREE(index);
+    return NULL;
+  }
+  family->name = index;
+
+  if(jutil_map_add(merge->index, index, family) == false)
+  {
+    JUTIL_ALLOC_FREE(family);
+    JUTIL_ALLOC_FREE(index);
+    return NULL;
+  }
+
+  merge->families[merge->family_number++] = family;
+  return family;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_preFork_merge_addSample(jcon_preFork_family_t *family, const char *key, double value, int is_quantile)
+{
+  for(size_t i = 0; i < family->sample_number; i++)
+  {
+    jcon_preFork_sample_t *sample = &family->samples[i];
+    if(strcmp(sample->key, key) == 0)
+    {
+      if(is_quantile)
+      {
+        sample->value = (value > sample->value ? value : sample->value);
+      }
+      else
+      {
+        sample->value += value;
+      }
+      return true;
+    }
+  }
+
+  if(family->sample_number == family->sample_capacity)
+  {
+    size_t capacity = (family->sample_capacity ? family->sample_capacity * 2 : 4);
+    jcon_preFork_sample_t *samples = (jcon_preFork_sample_t *)JUTIL_ALLOC_REALLOC(family->samples, capacity * sizeof(jcon_preFork_sample_t));
+    if(samples == NULL)
+    {
+      return false;
+    }
+    family->samples = samples;
+    family->sample_capacity = capacity;
+  }
+
+  char *copy = JUTIL_ALLOC_STRDUP(key);
+  if(copy == NULL)
+  {
+    return false;
+  }
+
+  jcon_preFork_sample_t *sample = &family->samples[family->sample_number++];
+  sample->key = copy;
+  sample->value = value;
+  sample->is_quantile = is_quantile;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_merge_format(jcon_preFork_merge_t *merge, jcon_preFork_text_t *text)
+{
+  for(size_t i = 0; i < merge->family_number; i++)
+  {
+    jcon_preFork_family_t *family = merge->families[i];
+
+    if(family->help)
+    {
+      jcon_preFork_text_append(text, "%s\n", family->help);
+    }
+    if(family->type)
+    {
+      jcon_preFork_text_append(text, "%s\n", family->type);
+    }
+
+    for(size_t j = 0; j < family->sample_number; j++)
+    {
+      jcon_preFork_sample_t *sample = &family->samples[j];
+      double magnitude = (sample->value < 0 ? -sample->value : sample->value);
+
+      /* Counters and gauges stay integers, like in jutil_metrics. */
+      if(magnitude < JCON_PREFORK_INTEGER_MAX && sample->value == (double)(long long)sample->value)
+      {
+        jcon_preFork_text_append(text, "%s %lld\n", sample->key, (long long)sample->value);
+      }
+      else
+      {
+        jcon_preFork_text_append(text, "%s %.9g\n", sample->key, sample->value);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_merge_clear(jcon_preFork_merge_t *merge)
+{
+  for(size_t i = 0; i < merge->family_number; i++)
+  {
+    jcon_preFork_family_t *family = merge->families[i];
+    for(size_t j = 0; j < family->sample_number; j++)
+    {
+      JUTIL_ALLOC_FREE(family->samples[j].key);
+    }
+    JUTIL_ALLOC_FREE(family->samples);
+    JUTIL_ALLOC_FREE(family->help);
+    JUTIL_ALLOC_FREE(family->type);
+    JUTIL_ALLOC_FREE(family->name);
+    JUTIL_ALLOC_FREE(family);
+  }
+
+  JUTIL_ALLOC_FREE(merge->families);
+  jutil_map_free(merge->index);
+  memset(merge, 0, sizeof(jcon_preFork_merge_t));
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_text_append(jcon_preFork_text_t *text, const char *fmt, ...)
+{
+  if(text->data == NULL && text->capacity > 0)
+  {
+    /* Earlier append failed. */
+    return;
+  }
+
+  while(true)
+  {
+    size_t space = text->capacity - text->length;
+
+    va_list args;
+    va_start(args, fmt);
+    int ret = vsnprintf((text->data ? text->data + text->length : NULL), space, fmt, args);
+    va_end(args);
+
+    if(ret < 0)
+    {
+      free(text->data);
+      text->data = NULL;
+      return;
+    }
+
+    if((size_t)ret < space)
+    {
+      text->length += (size_t)ret;
+      return;
+    }
+
+    size_t capacity = (text->capacity ? text->capacity * 2 : 4096);
+    while(capacity - text->length <= (size_t)ret)
+    {
+      capacity *= 2;
+    }
+
+    char *data = (char *)realloc(text->data, capacity);
+    if(data == NULL)
+    {
+      free(text->data);
+      text->data = NULL;
+      return;
+    }
+    text->data = data;
+    text->capacity = capacity;
+  }
+}
+
+
+
+//==============================================================================
+// Implement log function.
+//
+
+//------------------------------------------------------------------------------
+//
+void jcon_preFork_log(jcon_preFork_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session && session->server)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<prefork:%s> %s", jcon_server_getReferenceString(session->server), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<prefork:%s> %s", jcon_server_getReferenceString(session->server), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -10,8 +10,15 @@
  */
 
 #include <jayc/jcon_server_dev.h>
+#include <jayc/jutil_alloc.h>
 #include <stdbool.h>
 #include <stdlib.h>
+
+/**
+ * @brief Allocation statistics of module.
+ */
+JUTIL_ALLOC_MODULE("jcon_server");
+
 //------------------------------------------------------------------------------
 //
 void jcon_server_free(jcon_server_t *session)
@@ -21,7 +28,7 @@ void jcon_server_free(jcon_server_t *session)
     session->session_free_handler(session->session_context);
   }
 
-  free(session);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
@@ -98,5 +105,39 @@ jcon_client_t *jcon_server_acceptConnection(jcon_server_t *session)
     return session->function_acceptConnection(session->session_context);
   }
 
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_server_getFileDescriptor(jcon_server_t *session)
+{
+  if(session == NULL)
+  {
+    return -1;
+  }
+
+  if(session->function_getFileDescriptor)
+  {
+    return session->function_getFileDescriptor(session->session_context);
+  }
+
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_cloneListener(jcon_server_t *session)
+{
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  if(session->function_cloneListener)
+  {
+    return session->function_cloneListener(session->session_context);
+  }
+
   return NULL;
 }
\ No newline at end of file
@@ -13,12 +13,24 @@
 #include <jayc/jcon_server_dev.h>
 #include <jayc/jcon_client_tcp.h>
 #include <jayc/jcon_socketTCP.h>
+#include <jayc/jcon_socketUring.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_server_tcp");
+
+
 
 //==============================================================================
 // Define constants and defaults.
@@ -116,6 +128,29 @@ static int jcon_server_tcp_newConnection(void *ctx);
  */
 static jcon_client_t *jcon_server_tcp_acceptConnection(void *ctx);
 
+/**
+ * @brief Returns file descriptor of listening socket.
+ * 
+ * @param ctx Context pointer for session data.
+ * 
+ * @return    File descriptor of listening socket.
+ * @return    @c -1 , if server is not open or error occured.
+ */
+static int jcon_server_tcp_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Opens another listener on the same address and port.
+ * 
+ * Only available for sessions created with
+ * @c #jcon_server_tcp_reusePort_init() .
+ * 
+ * @param ctx Context of session to clone.
+ * 
+ * @return    New open server session.
+ * @return    @c NULL , if error occured.
+ */
+static jcon_server_t *jcon_server_tcp_cloneListener(void *ctx);
+
 /**
  * @brief Logs debug and error messages.
  * 
@@ -136,15 +171,20 @@ static void jcon_server_tcp_log(void *ctx, int log_type, const char *file, const
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_server_tcp_context_t *)ctx)->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG
   #define DEBUG(ctx, fmt, ...)
 #else
-  #define DEBUG(ctx, fmt, ...) jcon_server_tcp_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_server_tcp_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(ctx, fmt, ...) jcon_server_tcp_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(ctx, fmt, ...) jcon_server_tcp_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(ctx, fmt, ...) jcon_server_tcp_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(ctx, fmt, ...) jcon_server_tcp_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_server_tcp_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_server_tcp_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_server_tcp_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_server_tcp_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(ctx, fmt, ...) jcon_server_tcp_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -161,6 +201,11 @@ typedef struct __jcon_server_tcp_context
   jcon_socket_t *server;                 /**< jcon_tcp session object. */
   int poll_timeout;                   /**< Timeout for asking for new data in milliseconds. */
   jlog_t *logger;                     /**< Logger for debug and error messages. */
+
+  char *address;                      /**< Address, used to open cloned listeners. */
+  uint16_t port;                      /**< Port, used to open cloned listeners. */
+  int reuse_port;                     /**< If @c true , address can be shared with cloned listeners. */
+  jcon_socketTCP_options_t options;   /**< Socket options, used to open cloned listeners. */
 } jcon_server_tcp_context_t;
 
 
@@ -173,7 +218,14 @@ typedef struct __jcon_server_tcp_context
 //
 jcon_server_t *jcon_server_tcp_session_init(char *address, uint16_t port, jlog_t *logger)
 {
-  jcon_server_t *session = (jcon_server_t *)malloc(sizeof(jcon_server_t));
+  return jcon_server_tcp_options_init(address, port, NULL, logger);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tcp_options_init(char *address, uint16_t port, const jcon_socketTCP_options_t *options, jlog_t *logger)
+{
+  jcon_server_t *session = (jcon_server_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_server_t));
   if(session == NULL)
   {
     ERROR(NULL, "<TCP:%s:%u> malloc() failed.", address, port);
@@ -187,12 +239,14 @@ jcon_server_t *jcon_server_tcp_session_init(char *address, uint16_t port, jlog_t
   session->function_getReferenceString = &jcon_server_tcp_getReferenceString;
   session->function_newConnection = &jcon_server_tcp_newConnection;
   session->function_acceptConnection = &jcon_server_tcp_acceptConnection;
+  session->function_getFileDescriptor = &jcon_server_tcp_getFileDescriptor;
+  session->function_cloneListener = &jcon_server_tcp_cloneListener;
   session->connection_type = JCON_SERVER_TCP_CONNECTIONTYPE;
-  session->session_context = malloc(sizeof(jcon_server_tcp_context_t));
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_server_tcp_context_t));
   if(session->session_context == NULL)
   {
     ERROR(NULL, "<TCP:%s:%u> malloc() failed. Destroying session.", address, port);
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -200,16 +254,129 @@ jcon_server_t *jcon_server_tcp_session_init(char *address, uint16_t port, jlog_t
 
   ctx->poll_timeout = JCON_SERVER_TCP_POLL_TIMEOUT_DEFAULT;
   ctx->logger = logger;
+  ctx->port = port;
+
+  memset(&ctx->options, 0, sizeof(jcon_socketTCP_options_t));
+  if(options)
+  {
+    ctx->options = *options;
+  }
+  ctx->reuse_port = (ctx->options.reuse_port ? true : false);
+
+  ctx->address = (char *)JUTIL_ALLOC_MALLOC(strlen(address) + 1);
+  if(ctx->address == NULL)
+  {
+    ERROR(NULL, "<TCP:%s:%u> malloc() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+  memcpy(ctx->address, address, strlen(address) + 1);
+
+  ctx->server = jcon_socketTCP_options_init(address, port, &ctx->options, logger);
+  if(ctx->server == NULL)
+  {
+    ERROR(NULL, "<TCP:%s:%u> jcon_socketTCP_options_init() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx->address);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tcp_reusePort_init(char *address, uint16_t port, jlog_t *logger)
+{
+  jcon_server_t *session = jcon_server_tcp_session_init(address, port, logger);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  jcon_server_tcp_context_t *ctx = (jcon_server_tcp_context_t *)session->session_context;
+
+  if(jcon_socketTCP_setReusePort(ctx->server, true) == false)
+  {
+    ERROR(ctx, "jcon_socketTCP_setReusePort() failed. Destroying session.");
+    jcon_server_free(session);
+    return NULL;
+  }
+  ctx->reuse_port = true;
+  ctx->options.reuse_port = true;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tcp_uring_init(char *address, uint16_t port, jlog_t *logger)
+{
+  jcon_server_t *session = jcon_server_tcp_session_init(address, port, logger);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  jcon_server_tcp_context_t *ctx = (jcon_server_tcp_context_t *)session->session_context;
 
-  ctx->server = jcon_socketTCP_simple_init(address, port, logger);
+  jcon_socket_free(ctx->server);
+  ctx->server = jcon_socketUring_simple_init(address, port, logger);
   if(ctx->server == NULL)
   {
-    ERROR(NULL, "<TCP:%s:%u> jcon_socketTCP_simple_init() failed. Destroying context and session.", address, port);
-    free(ctx);
-    free(session);
+    ERROR(NULL, "<TCP:%s:%u> jcon_socketUring_simple_init() failed. Destroying session.", address, port);
+    JUTIL_ALLOC_FREE(ctx->address);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tcp_adopt_init(int fd, const jcon_socketTCP_options_t *options, jlog_t *logger)
+{
+  jcon_socket_t *server = jcon_socketTCP_adopt_init(fd, options, logger);
+  if(server == NULL)
+  {
+    ERROR(NULL, "<TCP:fd=%d> jcon_socketTCP_adopt_init() failed. Closing socket.", fd);
+    if(fd > 0 && close(fd) < 0)
+    {
+      ERROR(NULL, "<TCP:fd=%d> close() failed [%d : %s].", fd, errno, strerror(errno));
+    }
+    return NULL;
+  }
+
+  /* Address and options of the socket are kept
+     for cloned listeners and to bind again after reset. */
+  char address[INET6_ADDRSTRLEN];
+  uint16_t port = 0;
+  jcon_socketTCP_options_t socket_options;
+  if(jcon_socketTCP_getLocalAddress(server, address, sizeof(address), &port) == false
+    || jcon_socketTCP_getOptions(server, &socket_options) == false)
+  {
+    ERROR(NULL, "<TCP:fd=%d> Reading address of socket failed.", fd);
+    jcon_socket_free(server);
     return NULL;
   }
 
+  jcon_server_t *session = jcon_server_tcp_options_init(address, port, &socket_options, logger);
+  if(session == NULL)
+  {
+    jcon_socket_free(server);
+    return NULL;
+  }
+
+  jcon_server_tcp_context_t *ctx = (jcon_server_tcp_context_t *)session->session_context;
+
+  jcon_socket_free(ctx->server);
+  ctx->server = server;
+
+  DEBUG(ctx, "Adopted listening socket [%d].", fd);
   return session;
 }
 
@@ -231,7 +398,8 @@ void jcon_server_tcp_session_free(void *ctx)
   jcon_server_tcp_context_t *session_context = (jcon_server_tcp_context_t *)ctx;
   jcon_socket_free(session_context->server);
 
-  free(ctx);
+  JUTIL_ALLOC_FREE(session_context->address);
+  JUTIL_ALLOC_FREE(ctx);
 }
 
 //------------------------------------------------------------------------------
@@ -336,6 +504,12 @@ jcon_client_t *jcon_server_tcp_acceptConnection(void *ctx)
   jcon_socket_t *new_connection = jcon_socket_accept(session_context->server);
   if(new_connection == NULL)
   {
+    if(errno == EAGAIN)
+    {
+      DEBUG(ctx, "No pending connection.");
+      errno = EAGAIN;
+      return NULL;
+    }
     ERROR(ctx, "jcon_tcp_accept() failed.");
     return NULL;
   }
@@ -351,10 +525,65 @@ jcon_client_t *jcon_server_tcp_acceptConnection(void *ctx)
   return new_client;
 }
 
+//------------------------------------------------------------------------------
+//
+int jcon_server_tcp_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_server_tcp_context_t *session_context = (jcon_server_tcp_context_t *)ctx;
+
+  return jcon_socket_getFileDescriptor(session_context->server);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tcp_cloneListener(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return NULL;
+  }
+
+  jcon_server_tcp_context_t *session_context = (jcon_server_tcp_context_t *)ctx;
+
+  if(session_context->reuse_port == false)
+  {
+    ERROR(ctx, "Server was not created to share its address.");
+    return NULL;
+  }
+
+  jcon_server_t *listener = jcon_server_tcp_options_init(session_context->address, session_context->port, &session_context->options, session_context->logger);
+  if(listener == NULL)
+  {
+    ERROR(ctx, "jcon_server_tcp_options_init() failed.");
+    return NULL;
+  }
+
+  if(jcon_server_reset(listener) == false)
+  {
+    ERROR(ctx, "jcon_server_reset() failed for cloned listener.");
+    jcon_server_free(listener);
+    return NULL;
+  }
+
+  return listener;
+}
+
 //------------------------------------------------------------------------------
 //
 void jcon_server_tcp_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
@@ -0,0 +1,701 @@
+/**
+ * @file jcon_server_tls.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jcon_server_tls.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_server_tls.h>
+#include <jayc/jcon_server_dev.h>
+#include <jayc/jcon_client_tls.h>
+#include <jayc/jcon_socketTCP.h>
+#include <jayc/jutil_alloc.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_server_tls");
+
+
+
+//==============================================================================
+// Define constants and defaults.
+//
+
+/**
+ * @brief Connection type, to return for @c #jcon_server_getConnectionType() .
+ */
+#define JCON_SERVER_TLS_CONNECTIONTYPE "TLS"
+
+/**
+ * @brief Default value for polling timeout.
+ * 
+ * When checking, if new connections are available, function @c poll()
+ * is used. This value tells the function, how long to
+ * wait for new connections in milliseconds.
+ */
+#define JCON_SERVER_TLS_POLL_TIMEOUT_DEFAULT 10
+
+/**
+ * @brief Default time for handshakes in milliseconds.
+ * 
+ * Shorter than for clients, because the handshake
+ * holds up accepting other connections.
+ */
+#define JCON_SERVER_TLS_HANDSHAKE_TIMEOUT_DEFAULT 2000
+
+/**
+ * @brief Session ID context for session cache.
+ * 
+ * Sessions are only resumed within the same context.
+ */
+#define JCON_SERVER_TLS_SESSION_ID_CONTEXT "jcon_server_tls"
+
+/**
+ * @brief Size of buffer for OpenSSL error strings.
+ */
+#define JCON_SERVER_TLS_ERROR_SIZE 256
+
+
+
+//==============================================================================
+// Declare handlers and internal functions.
+//
+
+/**
+ * @brief Function for context free handler.
+ * 
+ * Will close server and free context data.
+ * 
+ * @param ctx Session context to free.
+ */
+static void jcon_server_tls_session_free(void *ctx);
+
+/**
+ * @brief Function for reset handler.
+ * 
+ * Restarts the server.
+ * 
+ * @param ctx Context pointer with socket data.
+ * 
+ * @return    @c true , if reset was successful.
+ * @return    @c false , if reset failed.
+ */
+static int jcon_server_tls_reset(void *ctx);
+
+/**
+ * @brief Function for close handler.
+ * 
+ * Closes server socket.
+ * 
+ * @param ctx Context pointer with socket data.
+ */
+static void jcon_server_tls_close(void *ctx);
+
+/**
+ * @brief Checks if socket is open.
+ * 
+ * @param ctx Context pointer with socket data.
+ * 
+ * @return    @c true , if socket is open.
+ * @return    @c false , if socket closed or error occured.
+ */
+static int jcon_server_tls_isOpen(void *ctx);
+
+/**
+ * @brief Returns reference string of listening socket.
+ * 
+ * @param ctx Context of session to ask from.
+ * 
+ * @return    Session string.
+ * @return    @c NULL , if error occured.
+ */
+static const char *jcon_server_tls_getReferenceString(void *ctx);
+
+/**
+ * @brief Checks, if new connection is available.
+ * 
+ * Polls socket, to check if new connections are available.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    @c true , if new connection is available.
+ * @return    @c false , if no connection or error occured.
+ */
+static int jcon_server_tls_newConnection(void *ctx);
+
+/**
+ * @brief Accepts connection, does handshake and creates jcon_client.
+ * 
+ * @param ctx Context of session to check.
+ * 
+ * @return    New jcon_client session object.
+ * @return    @c NULL , if no connection, handshake failed or error occured.
+ */
+static jcon_client_t *jcon_server_tls_acceptConnection(void *ctx);
+
+/**
+ * @brief Returns file descriptor of listening socket.
+ * 
+ * @param ctx Context pointer for session data.
+ * 
+ * @return    File descriptor of listening socket.
+ * @return    @c -1 , if server is not open or error occured.
+ */
+static int jcon_server_tls_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Opens another listener on the same address and port.
+ * 
+ * Only available, if @c tcp.reuse_port was set.
+ * The listener shares the OpenSSL context, so sessions
+ * are resumed on every listener.
+ * 
+ * @param ctx Context of session to clone.
+ * 
+ * @return    New open server session.
+ * @return    @c NULL , if error occured.
+ */
+static jcon_server_t *jcon_server_tls_cloneListener(void *ctx);
+
+/**
+ * @brief Creates server session with existing OpenSSL context.
+ * 
+ * @param address           IP address, the server will be open to.
+ * @param port              Port, the server will be open to.
+ * @param tcp_options       Options for listening socket.
+ * @param ssl_ctx           OpenSSL context. Reference is taken over.
+ * @param handshake_timeout Time for handshakes in milliseconds.
+ * @param logger            jlog logger to use.
+ * 
+ * @return                  jcon_server session object.
+ * @return                  @c NULL , if an error occured
+ *                          ( @c ssl_ctx is still owned by caller).
+ */
+static jcon_server_t *jcon_server_tls_create(char *address, uint16_t port, const jcon_socketTCP_options_t *tcp_options, SSL_CTX *ssl_ctx, int handshake_timeout, jlog_t *logger);
+
+/**
+ * @brief Creates OpenSSL context for server.
+ * 
+ * @param options Options to configure context.
+ * @param address Address for log messages.
+ * @param port    Port for log messages.
+ * 
+ * @return        New OpenSSL context.
+ * @return        @c NULL , if error occured.
+ */
+static SSL_CTX *jcon_server_tls_createContext(const jcon_client_tls_options_t *options, const char *address, uint16_t port);
+
+/**
+ * @brief Takes error from OpenSSL error queue and
+ *        formats it. Also clears the queue.
+ * 
+ * @param buf   Buffer for error string.
+ * @param size  Size of @c buf .
+ * 
+ * @return      @c buf .
+ */
+static const char *jcon_server_tls_errorString(char *buf, size_t size);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * Uses logger from @c ctx , or if logger is @c NULL , uses global logger.
+ * 
+ * @param ctx       Session for info about connection.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_server_tls_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_server_tls_context_t *)ctx)->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG
+  #define DEBUG(ctx, fmt, ...)
+#else
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_server_tls_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_server_tls_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_server_tls_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_server_tls_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_server_tls_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(ctx, fmt, ...) jcon_server_tls_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Define context structure.
+//
+
+/**
+ * @brief Data for jcon_server_tls object.
+ */
+typedef struct __jcon_server_tls_context
+{
+  jcon_socket_t *server;              /**< Listening TCP socket. */
+  SSL_CTX *ssl_ctx;                   /**< OpenSSL context. Shared with cloned listeners and accepted connections. */
+  int poll_timeout;                   /**< Timeout for asking for new connections in milliseconds. */
+  int handshake_timeout;              /**< Time for handshakes in milliseconds. */
+  jlog_t *logger;                     /**< Logger for debug and error messages. */
+
+  char *address;                      /**< Address, used to open cloned listeners. */
+  uint16_t port;                      /**< Port, used to open cloned listeners. */
+  jcon_socketTCP_options_t options;   /**< Socket options, used to open cloned listeners. */
+} jcon_server_tls_context_t;
+
+
+
+//==============================================================================
+// Implement handlers and internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tls_session_init(char *address, uint16_t port, const char *cert_file, const char *key_file, jlog_t *logger)
+{
+  jcon_client_tls_options_t options;
+  memset(&options, 0, sizeof(jcon_client_tls_options_t));
+  options.cert_file = cert_file;
+  options.key_file = key_file;
+
+  return jcon_server_tls_options_init(address, port, &options, logger);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tls_options_init(char *address, uint16_t port, const jcon_client_tls_options_t *options, jlog_t *logger)
+{
+  if(options == NULL || options->cert_file == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> No certificate given.", address, port);
+    return NULL;
+  }
+
+  SSL_CTX *ssl_ctx = jcon_server_tls_createContext(options, address, port);
+  if(ssl_ctx == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> jcon_server_tls_createContext() failed.", address, port);
+    return NULL;
+  }
+
+  int handshake_timeout = (options->handshake_timeout == 0 ? JCON_SERVER_TLS_HANDSHAKE_TIMEOUT_DEFAULT : options->handshake_timeout);
+
+  jcon_server_t *session = jcon_server_tls_create(address, port, &options->tcp, ssl_ctx, handshake_timeout, logger);
+  if(session == NULL)
+  {
+    SSL_CTX_free(ssl_ctx);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tls_create(char *address, uint16_t port, const jcon_socketTCP_options_t *tcp_options, SSL_CTX *ssl_ctx, int handshake_timeout, jlog_t *logger)
+{
+  jcon_server_t *session = (jcon_server_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_server_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> malloc() failed.", address, port);
+    return NULL;
+  }
+
+  session->session_free_handler = &jcon_server_tls_session_free;
+  session->function_reset = &jcon_server_tls_reset;
+  session->function_close = &jcon_server_tls_close;
+  session->function_isOpen = &jcon_server_tls_isOpen;
+  session->function_getReferenceString = &jcon_server_tls_getReferenceString;
+  session->function_newConnection = &jcon_server_tls_newConnection;
+  session->function_acceptConnection = &jcon_server_tls_acceptConnection;
+  session->function_getFileDescriptor = &jcon_server_tls_getFileDescriptor;
+  session->function_cloneListener = &jcon_server_tls_cloneListener;
+  session->connection_type = JCON_SERVER_TLS_CONNECTIONTYPE;
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_server_tls_context_t));
+  if(session->session_context == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> malloc() failed. Destroying session.", address, port);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  jcon_server_tls_context_t *ctx = (jcon_server_tls_context_t *)session->session_context;
+
+  ctx->poll_timeout = JCON_SERVER_TLS_POLL_TIMEOUT_DEFAULT;
+  ctx->handshake_timeout = handshake_timeout;
+  ctx->logger = logger;
+  ctx->port = port;
+  ctx->options = *tcp_options;
+
+  ctx->address = (char *)JUTIL_ALLOC_MALLOC(strlen(address) + 1);
+  if(ctx->address == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> malloc() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+  memcpy(ctx->address, address, strlen(address) + 1);
+
+  ctx->server = jcon_socketTCP_options_init(address, port, &ctx->options, logger);
+  if(ctx->server == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> jcon_socketTCP_options_init() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx->address);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  ctx->ssl_ctx = ssl_ctx;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_server_tls_session_free(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return;
+  }
+
+  if(jcon_server_tls_isOpen(ctx))
+  {
+    jcon_server_tls_close(ctx);
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+  jcon_socket_free(session_context->server);
+
+  /* Accepted connections and cloned listeners hold own references. */
+  SSL_CTX_free(session_context->ssl_ctx);
+
+  JUTIL_ALLOC_FREE(session_context->address);
+  JUTIL_ALLOC_FREE(ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_server_tls_reset(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(jcon_server_tls_isOpen(ctx))
+  {
+    jcon_server_tls_close(ctx);
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  return jcon_socket_bind(session_context->server);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_server_tls_close(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return;
+  }
+
+  if(jcon_server_tls_isOpen(ctx) == false)
+  {
+    DEBUG(ctx, "Server already closed.");
+    return;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  jcon_socket_close(session_context->server);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_server_tls_isOpen(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return 0;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  return jcon_socket_isConnected(session_context->server);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_server_tls_getReferenceString(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return NULL;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  return jcon_socket_getReferenceString(session_context->server);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_server_tls_newConnection(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  return jcon_socket_pollForInput(session_context->server, session_context->poll_timeout);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_client_t *jcon_server_tls_acceptConnection(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return NULL;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  jcon_socket_t *new_connection = jcon_socket_accept(session_context->server);
+  if(new_connection == NULL)
+  {
+    if(errno == EAGAIN)
+    {
+      DEBUG(ctx, "No pending connection.");
+      errno = EAGAIN;
+      return NULL;
+    }
+    ERROR(ctx, "jcon_socket_accept() failed.");
+    return NULL;
+  }
+
+  jcon_client_t *new_client = jcon_client_tls_session_tlsClone(new_connection, session_context->ssl_ctx, session_context->handshake_timeout, session_context->logger);
+  if(new_client == NULL)
+  {
+    WARN(ctx, "Handshake with [%s] failed.", jcon_socket_getReferenceString(new_connection));
+    jcon_socket_free(new_connection);
+    return NULL;
+  }
+
+  return new_client;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_server_tls_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  return jcon_socket_getFileDescriptor(session_context->server);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_tls_cloneListener(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return NULL;
+  }
+
+  jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+  if(session_context->options.reuse_port == false)
+  {
+    ERROR(ctx, "Server was not created to share its address.");
+    return NULL;
+  }
+
+  SSL_CTX_up_ref(session_context->ssl_ctx);
+
+  jcon_server_t *listener = jcon_server_tls_create
+  (
+    session_context->address,
+    session_context->port,
+    &session_context->options,
+    session_context->ssl_ctx,
+    session_context->handshake_timeout,
+    session_context->logger
+  );
+  if(listener == NULL)
+  {
+    ERROR(ctx, "jcon_server_tls_create() failed.");
+    SSL_CTX_free(session_context->ssl_ctx);
+    return NULL;
+  }
+
+  if(jcon_server_reset(listener) == false)
+  {
+    ERROR(ctx, "jcon_server_reset() failed for cloned listener.");
+    jcon_server_free(listener);
+    return NULL;
+  }
+
+  return listener;
+}
+
+//------------------------------------------------------------------------------
+//
+SSL_CTX *jcon_server_tls_createContext(const jcon_client_tls_options_t *options, const char *address, uint16_t port)
+{
+  char err_buf[JCON_SERVER_TLS_ERROR_SIZE];
+
+  ERR_clear_error();
+  SSL_CTX *ssl_ctx = SSL_CTX_new(TLS_server_method());
+  if(ssl_ctx == NULL)
+  {
+    ERROR(NULL, "<TLS:%s:%u> SSL_CTX_new() failed [%s].", address, port, jcon_server_tls_errorString(err_buf, sizeof(err_buf)));
+    return NULL;
+  }
+
+  SSL_CTX_set_min_proto_version(ssl_ctx, TLS1_2_VERSION);
+  SSL_CTX_set_mode(ssl_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
+  if(options->disable_ktls == false)
+  {
+    SSL_CTX_set_options(ssl_ctx, SSL_OP_ENABLE_KTLS);
+  }
+
+  if(options->disable_tickets)
+  {
+    SSL_CTX_set_options(ssl_ctx, SSL_OP_NO_TICKET);
+  }
+
+  SSL_CTX_set_session_cache_mode(ssl_ctx, SSL_SESS_CACHE_SERVER);
+  SSL_CTX_set_session_id_context(ssl_ctx, (const unsigned char *)JCON_SERVER_TLS_SESSION_ID_CONTEXT, strlen(JCON_SERVER_TLS_SESSION_ID_CONTEXT));
+
+  const char *key_file = (options->key_file ? options->key_file : options->cert_file);
+
+  if(SSL_CTX_use_certificate_chain_file(ssl_ctx, options->cert_file) != 1
+  || SSL_CTX_use_PrivateKey_file(ssl_ctx, key_file, SSL_FILETYPE_PEM) != 1
+  || SSL_CTX_check_private_key(ssl_ctx) != 1)
+  {
+    ERROR(NULL, "<TLS:%s:%u> Loading certificate [%s] failed [%s].", address, port, options->cert_file, jcon_server_tls_errorString(err_buf, sizeof(err_buf)));
+    SSL_CTX_free(ssl_ctx);
+    return NULL;
+  }
+
+  if(options->ca_file)
+  {
+    STACK_OF(X509_NAME) *ca_names = SSL_load_client_CA_file(options->ca_file);
+    if(ca_names == NULL || SSL_CTX_load_verify_locations(ssl_ctx, options->ca_file, NULL) != 1)
+    {
+      ERROR(NULL, "<TLS:%s:%u> Loading CA certificates [%s] failed [%s].", address, port, options->ca_file, jcon_server_tls_errorString(err_buf, sizeof(err_buf)));
+      if(ca_names)
+      {
+        sk_X509_NAME_pop_free(ca_names, X509_NAME_free);
+      }
+      SSL_CTX_free(ssl_ctx);
+      return NULL;
+    }
+
+    SSL_CTX_set_client_CA_list(ssl_ctx, ca_names);
+    SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+  }
+
+  return ssl_ctx;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_server_tls_errorString(char *buf, size_t size)
+{
+  unsigned long error = ERR_get_error();
+  if(error == 0)
+  {
+    snprintf(buf, size, "%d : %s", errno, strerror(errno));
+  }
+  else
+  {
+    ERR_error_string_n(error, buf, size);
+  }
+
+  ERR_clear_error();
+  return buf;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_server_tls_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(ctx)
+  {
+    jcon_server_tls_context_t *session_context = (jcon_server_tls_context_t *)ctx;
+
+    if(session_context->logger)
+    {
+      jlog_log_message_m(session_context->logger, log_type, file, function, line, "<%s> %s", jcon_server_tls_getReferenceString(ctx), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_server_tls_getReferenceString(ctx), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -13,12 +13,22 @@
 #include <jayc/jcon_server_dev.h>
 #include <jayc/jcon_client_unix.h>
 #include <jayc/jcon_socketUnix.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <string.h>
+#include <unistd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_server_unix");
+
+
 
 //==============================================================================
 // Define constants and defaults.
@@ -116,6 +126,31 @@ static int jcon_server_unix_newConnection(void *ctx);
  */
 static jcon_client_t *jcon_server_unix_acceptConnection(void *ctx);
 
+/**
+ * @brief Returns file descriptor of listening socket.
+ * 
+ * @param ctx Context pointer for session data.
+ * 
+ * @return    File descriptor of listening socket.
+ * @return    @c -1 , if server is not open or error occured.
+ */
+static int jcon_server_unix_getFileDescriptor(void *ctx);
+
+/**
+ * @brief Creates server session around socket.
+ * 
+ * Used by @c #jcon_server_unix_session_init() and
+ * @c #jcon_server_unix_adopt_init() .
+ * 
+ * @param server  Socket session, owned by new session.
+ *                Not freed if an error occured.
+ * @param logger  Logger for debug and error messages.
+ * 
+ * @return        New server session.
+ * @return        @c NULL , if error occured.
+ */
+static jcon_server_t *jcon_server_unix_create(jcon_socket_t *server, jlog_t *logger);
+
 /**
  * @brief Logs debug and error messages.
  * 
@@ -136,15 +171,20 @@ static void jcon_server_unix_log(void *ctx, int log_type, const char *file, cons
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ((jcon_server_unix_context_t *)ctx)->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG
   #define DEBUG(ctx, fmt, ...)
 #else
-  #define DEBUG(ctx, fmt, ...) jcon_server_unix_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jcon_server_unix_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(ctx, fmt, ...) jcon_server_unix_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(ctx, fmt, ...) jcon_server_unix_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(ctx, fmt, ...) jcon_server_unix_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(ctx, fmt, ...) jcon_server_unix_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jcon_server_unix_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_server_unix_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_server_unix_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_server_unix_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(ctx, fmt, ...) jcon_server_unix_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -173,10 +213,59 @@ typedef struct __jcon_server_unix_context
 //
 jcon_server_t *jcon_server_unix_session_init(char *filepath, jlog_t *logger)
 {
-  jcon_server_t *session = (jcon_server_t *)malloc(sizeof(jcon_server_t));
+  jcon_socket_t *server = jcon_socketUnix_simple_init(filepath, logger);
+  if(server == NULL)
+  {
+    ERROR(NULL, "<UNIX:%s> jcon_socketUnix_simple_init() failed.", filepath);
+    return NULL;
+  }
+
+  jcon_server_t *session = jcon_server_unix_create(server, logger);
+  if(session == NULL)
+  {
+    ERROR(NULL, "<UNIX:%s> jcon_server_unix_create() failed.", filepath);
+    jcon_socket_free(server);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_unix_adopt_init(int fd, jlog_t *logger)
+{
+  jcon_socket_t *server = jcon_socketUnix_adopt_init(fd, logger);
+  if(server == NULL)
+  {
+    ERROR(NULL, "<UNIX:fd=%d> jcon_socketUnix_adopt_init() failed. Closing socket.", fd);
+    if(fd > 0 && close(fd) < 0)
+    {
+      ERROR(NULL, "<UNIX:fd=%d> close() failed [%d : %s].", fd, errno, strerror(errno));
+    }
+    return NULL;
+  }
+
+  jcon_server_t *session = jcon_server_unix_create(server, logger);
+  if(session == NULL)
+  {
+    ERROR(NULL, "<UNIX:fd=%d> jcon_server_unix_create() failed.", fd);
+    jcon_socket_free(server);
+    return NULL;
+  }
+
+  DEBUG(session->session_context, "Adopted listening socket [%d].", fd);
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_server_t *jcon_server_unix_create(jcon_socket_t *server, jlog_t *logger)
+{
+  jcon_server_t *session = (jcon_server_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_server_t));
   if(session == NULL)
   {
-    ERROR(NULL, "<UNIX:%s> malloc() failed.", filepath);
+    ERROR(NULL, "malloc() failed.");
     return NULL;
   }
 
@@ -187,12 +276,14 @@ jcon_server_t *jcon_server_unix_session_init(char *filepath, jlog_t *logger)
   session->function_getReferenceString = &jcon_server_unix_getReferenceString;
   session->function_newConnection = &jcon_server_unix_newConnection;
   session->function_acceptConnection = &jcon_server_unix_acceptConnection;
+  session->function_getFileDescriptor = &jcon_server_unix_getFileDescriptor;
+  session->function_cloneListener = NULL;
   session->connection_type = JCON_SERVER_UNIX_CONNECTIONTYPE;
-  session->session_context = malloc(sizeof(jcon_server_unix_context_t));
+  session->session_context = JUTIL_ALLOC_MALLOC(sizeof(jcon_server_unix_context_t));
   if(session->session_context == NULL)
   {
-    ERROR(NULL, "<UNIX:%s> malloc() failed. Destroying session.", filepath);
-    free(session);
+    ERROR(NULL, "malloc() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -200,15 +291,7 @@ jcon_server_t *jcon_server_unix_session_init(char *filepath, jlog_t *logger)
 
   ctx->poll_timeout = JCON_SERVER_UNIX_POLL_TIMEOUT_DEFAULT;
   ctx->logger = logger;
-
-  ctx->server = jcon_socketUnix_simple_init(filepath, logger);
-  if(ctx->server == NULL)
-  {
-    ERROR(NULL, "<UNIX:%s> jcon_socketUnix_simple_init() failed. Destroying context and session.", filepath);
-    free(ctx);
-    free(session);
-    return NULL;
-  }
+  ctx->server = server;
 
   return session;
 }
@@ -231,7 +314,7 @@ void jcon_server_unix_session_free(void *ctx)
   jcon_server_unix_context_t *session_context = (jcon_server_unix_context_t *)ctx;
   jcon_socket_free(session_context->server);
 
-  free(ctx);
+  JUTIL_ALLOC_FREE(ctx);
 }
 
 //------------------------------------------------------------------------------
@@ -336,6 +419,12 @@ jcon_client_t *jcon_server_unix_acceptConnection(void *ctx)
   jcon_socket_t *new_connection = jcon_socket_accept(session_context->server);
   if(new_connection == NULL)
   {
+    if(errno == EAGAIN)
+    {
+      DEBUG(ctx, "No pending connection.");
+      errno = EAGAIN;
+      return NULL;
+    }
     ERROR(ctx, "jcon_unix_accept() failed.");
     return NULL;
   }
@@ -351,10 +440,30 @@ jcon_client_t *jcon_server_unix_acceptConnection(void *ctx)
   return new_client;
 }
 
+//------------------------------------------------------------------------------
+//
+int jcon_server_unix_getFileDescriptor(void *ctx)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return -1;
+  }
+
+  jcon_server_unix_context_t *session_context = (jcon_server_unix_context_t *)ctx;
+
+  return jcon_socket_getFileDescriptor(session_context->server);
+}
+
 //------------------------------------------------------------------------------
 //
 void jcon_server_unix_log(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(ctx, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
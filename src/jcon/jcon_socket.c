@@ -9,8 +9,14 @@
  * 
  */
 
+#define _GNU_SOURCE /* needed for splice() */
+
 #include <jayc/jcon_socket.h>
 #include <jayc/jcon_socket_dev.h>
+#include <jayc/jlog_ratelimit.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_alloc.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -19,7 +25,54 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <poll.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_socket");
+
+
+
+//==============================================================================
+// Define constants and internal functions.
+//
+
+/**
+ * @brief Reference string is not formatted yet.
+ */
+#define JCON_SOCKET_REFERENCESTRING_EMPTY 0
+
+/**
+ * @brief Reference string is being formatted by another thread.
+ */
+#define JCON_SOCKET_REFERENCESTRING_BUSY 1
+
+/**
+ * @brief Reference string is formatted and does not change anymore.
+ */
+#define JCON_SOCKET_REFERENCESTRING_READY 2
+
+/**
+ * @brief Formats reference string, if not done yet.
+ * 
+ * Only the first caller formats, concurrent callers wait
+ * for it to finish. If the implementation can't format the
+ * string, the socket type is used with @c :- as address.
+ * 
+ * @param session Session object.
+ */
+static void jcon_socket_formatReferenceString(jcon_socket_t *session);
+
+
 
 //==============================================================================
 // Define Log function and macros.
@@ -39,17 +92,47 @@
  */
 static void jcon_socket_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG /* Allow to turn of debug messages at compile time. */
   #define DEBUG(session, fmt, ...)
 #else
-  #define DEBUG(session, fmt, ...) jcon_socket_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_socket_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(session, fmt, ...) jcon_socket_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(session, fmt, ...) jcon_socket_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(session, fmt, ...) jcon_socket_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(session, fmt, ...) jcon_socket_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_socket_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_socket_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_socket_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_socket_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(session, fmt, ...) jcon_socket_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
+/**
+ * @brief Error log for failures, that can repeat for every call.
+ * 
+ * Rate limited per call site, suppressed messages are summed
+ * up before the next message. Keeps @c errno for arguments.
+ * Every call is counted in metric @c jcon_socket_errors_total .
+ */
+#define ERROR_RL(session, fmt, ...) \
+  do \
+  { \
+    static jlog_ratelimit_t log_site; \
+    if(LOG_ENABLED(session, JLOG_LOGTYPE_ERROR) && jlog_ratelimit_check(&log_site, JLOG_RATELIMIT_INTERVAL, JLOG_RATELIMIT_BURST)) \
+    { \
+      unsigned long log_suppressed = jlog_ratelimit_takeSuppressed(&log_site); \
+      if(log_suppressed) \
+      { \
+        int log_errno = errno; \
+        ERROR(session, "Suppressed %lu messages (rate limit).", log_suppressed); \
+        errno = log_errno; \
+      } \
+      ERROR(session, fmt, ##__VA_ARGS__); \
+    } \
+    JUTIL_METRICS_COUNTER_ADD("jcon_socket_errors_total", "Failed socket operations.", 1); \
+  } while(0)
+
 
 
 //==============================================================================
@@ -76,8 +159,7 @@ void jcon_socket_free(jcon_socket_t *session)
     session->session_free_handler(session);
   }
 
-  free(session->referenceString);
-  free(session);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
@@ -140,7 +222,12 @@ int jcon_socket_bind(jcon_socket_t *session)
     return false;
   }
 
-  session->connection_type = JCON_SOCKET_CONNECTIONTYPE_SERVER;
+  /* Bound datagram sockets send and recieve directly,
+     so their handler sets the type to client. */
+  if(session->connection_type == JCON_SOCKET_CONNECTIONTYPE_NOTDEF)
+  {
+    session->connection_type = JCON_SOCKET_CONNECTIONTYPE_SERVER;
+  }
   return true;
 }
 
@@ -190,15 +277,28 @@ int jcon_socket_pollForInput(jcon_socket_t *session, int timeout)
     return false;
   }
 
+  if(session->function_poll)
+  {
+    return session->function_poll(session, timeout);
+  }
+
   struct pollfd poll_fds[1];
   poll_fds->fd = session->file_descriptor;
   poll_fds->events = POLLIN;
 
-  int ret_poll = poll(poll_fds, 1, timeout);
+  /* Signals must not extend the timeout, so poll is retried until deadline. */
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, timeout);
+
+  int ret_poll;
+  while((ret_poll = poll(poll_fds, 1, timeout)) < 0 && errno == EINTR)
+  {
+    timeout = jutil_time_deadline_getRemaining(&deadline);
+  }
 
   if(ret_poll < 0)
   {
-    ERROR(session, "poll() failed [%d : %s].", errno, strerror(errno));
+    ERROR_RL(session, "poll() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
@@ -298,18 +398,32 @@ size_t jcon_socket_recvData(jcon_socket_t *session, void *data_ptr, size_t data_
     return 0;
   }
 
-  void *buf = malloc(data_size);
+  /* Read directly into caller buffer. Without buffer, data is
+     read into scratch buffer on stack and discarded. */
+  char discard[JCON_SOCKET_DISCARD_SIZE];
+  void *buf = data_ptr;
   if(buf == NULL)
   {
-    ERROR(session, "malloc() failed.");
-    return 0;
+    buf = discard;
+    if(data_size > sizeof(discard))
+    {
+      data_size = sizeof(discard);
+    }
   }
 
-  int ret_recv = recv(session->file_descriptor, buf, data_size, 0);
+  ssize_t ret_recv;
+  if(session->function_recv)
+  {
+    struct iovec iov = { buf, data_size };
+    ret_recv = session->function_recv(session, &iov, 1);
+  }
+  else
+  {
+    ret_recv = recv(session->file_descriptor, buf, data_size, 0);
+  }
   if(ret_recv < 0)
   {
-    ERROR(session, "recv() failed [%d : %s].", errno, strerror(errno));
-    free(buf);
+    ERROR_RL(session, "recv() failed [%d : %s].", errno, strerror(errno));
     return 0;
   }
 
@@ -317,26 +431,65 @@ size_t jcon_socket_recvData(jcon_socket_t *session, void *data_ptr, size_t data_
   {
     DEBUG(session, "recv() returned [0]. Closing connection.");
     jcon_socket_close(session);
-    free(buf);
     return 0;
   }
 
-  size_t cpy_size = ret_recv;
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_received_bytes_total", "Bytes received by sockets.", (unsigned long long)ret_recv);
+  return ret_recv;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_socket_recvDataV(jcon_socket_t *session, const struct iovec *iov, int iov_count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return 0;
+  }
+
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT)
+  {
+    ERROR(session, "Session is not of type client.");
+    return 0;
+  }
+
+  if(iov == NULL || iov_count <= 0)
+  {
+    ERROR(session, "No buffers given.");
+    return 0;
+  }
 
-  /* Potential for buffer overflow. Checking and trimming data if necessary. */
-  if(ret_recv > data_size)
+  ssize_t ret_read;
+  if(session->function_recv)
   {
-    DEBUG(session, "Buffer overflow detected [%d > %d]. Trimming data.", ret_recv, data_size);
-    cpy_size = data_size;
+    ret_read = session->function_recv(session, iov, iov_count);
+  }
+  else
+  {
+    ret_read = readv(session->file_descriptor, iov, iov_count);
+  }
+  if(ret_read < 0)
+  {
+    ERROR_RL(session, "readv() failed [%d : %s].", errno, strerror(errno));
+    return 0;
   }
 
-  if(data_ptr)
+  if(ret_read == 0)
   {
-    memcpy(data_ptr, buf, cpy_size);
+    DEBUG(session, "readv() returned [0]. Closing connection.");
+    jcon_socket_close(session);
+    return 0;
   }
-  free(buf);
 
-  return cpy_size;
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_received_bytes_total", "Bytes received by sockets.", (unsigned long long)ret_read);
+  return ret_read;
 }
 
 //------------------------------------------------------------------------------
@@ -374,7 +527,16 @@ size_t jcon_socket_sendData(jcon_socket_t *session, void *data_ptr, size_t data_
   }
 
   /* Fixed broken pipe termination, by preventing SIGPIPE. */
-  int ret_send = send(session->file_descriptor, data_ptr, data_size, MSG_NOSIGNAL);
+  ssize_t ret_send;
+  if(session->function_send)
+  {
+    struct iovec iov = { data_ptr, data_size };
+    ret_send = session->function_send(session, &iov, 1, MSG_NOSIGNAL);
+  }
+  else
+  {
+    ret_send = send(session->file_descriptor, data_ptr, data_size, MSG_NOSIGNAL);
+  }
   if(ret_send < 0)
   {
     if(errno == ECONNRESET || errno == EPIPE)
@@ -383,14 +545,465 @@ size_t jcon_socket_sendData(jcon_socket_t *session, void *data_ptr, size_t data_
     }
     else
     {
-      ERROR(session, "send() failed [%d : %s].", errno, strerror(errno));
+      ERROR_RL(session, "send() failed [%d : %s].", errno, strerror(errno));
     }
     return 0;
   }
 
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_sent_bytes_total", "Bytes sent by sockets.", (unsigned long long)ret_send);
   return ret_send;
 }
 
+//------------------------------------------------------------------------------
+//
+size_t jcon_socket_sendDataV(jcon_socket_t *session, const struct iovec *iov, int iov_count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return 0;
+  }
+
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT)
+  {
+    ERROR(session, "Session is not of type client.");
+    return 0;
+  }
+
+  if(iov == NULL || iov_count <= 0)
+  {
+    ERROR(session, "No buffers given.");
+    return 0;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = (struct iovec *)iov;
+  msg.msg_iovlen = iov_count;
+
+  /* Prevent SIGPIPE, same as jcon_socket_sendData(). */
+  ssize_t ret_send;
+  if(session->function_send)
+  {
+    ret_send = session->function_send(session, iov, iov_count, MSG_NOSIGNAL);
+  }
+  else
+  {
+    ret_send = sendmsg(session->file_descriptor, &msg, MSG_NOSIGNAL);
+  }
+  if(ret_send < 0)
+  {
+    if(errno == ECONNRESET || errno == EPIPE)
+    {
+      jcon_socket_close(session);
+    }
+    else
+    {
+      ERROR_RL(session, "sendmsg() failed [%d : %s].", errno, strerror(errno));
+    }
+    return 0;
+  }
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_sent_bytes_total", "Bytes sent by sockets.", (unsigned long long)ret_send);
+  return ret_send;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_socket_trySendDataV(jcon_socket_t *session, const struct iovec *iov, int iov_count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return 0;
+  }
+
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT)
+  {
+    ERROR(session, "Session is not of type client.");
+    return 0;
+  }
+
+  if(iov == NULL || iov_count <= 0)
+  {
+    ERROR(session, "No buffers given.");
+    return 0;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = (struct iovec *)iov;
+  msg.msg_iovlen = iov_count;
+
+  ssize_t ret_send;
+  if(session->function_send)
+  {
+    ret_send = session->function_send(session, iov, iov_count, MSG_NOSIGNAL | MSG_DONTWAIT);
+  }
+  else
+  {
+    ret_send = sendmsg(session->file_descriptor, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+  }
+  if(ret_send < 0)
+  {
+    if(errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      /* Send buffer is full, not an error. */
+      errno = EAGAIN;
+    }
+    else if(errno == ECONNRESET || errno == EPIPE)
+    {
+      jcon_socket_close(session);
+    }
+    else
+    {
+      ERROR_RL(session, "sendmsg() failed [%d : %s].", errno, strerror(errno));
+    }
+    return 0;
+  }
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_sent_bytes_total", "Bytes sent by sockets.", (unsigned long long)ret_send);
+  return ret_send;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_socket_sendFile(jcon_socket_t *session, int file_descriptor, off_t offset, size_t size)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return 0;
+  }
+
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT)
+  {
+    ERROR(session, "Session is not of type client.");
+    return 0;
+  }
+
+  if(file_descriptor < 0)
+  {
+    ERROR(session, "Invalid file descriptor [%d].", file_descriptor);
+    return 0;
+  }
+
+  if(size == 0)
+  {
+    ERROR(session, "size given is [0].");
+    return 0;
+  }
+
+  /*
+   * sendfile() and splice() have no MSG_NOSIGNAL, so SIGPIPE
+   * is blocked for this thread and a raised one is consumed.
+   */
+  sigset_t pipe_set, old_set, pending_set;
+  sigemptyset(&pipe_set);
+  sigaddset(&pipe_set, SIGPIPE);
+  sigpending(&pending_set);
+  int pipe_pending = sigismember(&pending_set, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipe_set, &old_set);
+
+  size_t sent = 0;
+  int use_splice = false;
+  int broken_pipe = false;
+
+  while(sent < size)
+  {
+    ssize_t ret_send;
+    if(use_splice == false)
+    {
+      ret_send = sendfile(session->file_descriptor, file_descriptor, &offset, size - sent);
+      if(ret_send < 0 && (errno == EINVAL || errno == ESPIPE || errno == ENOSYS) && sent == 0)
+      {
+        /* Descriptor can not be read by sendfile(), for example a pipe. */
+        use_splice = true;
+        continue;
+      }
+    }
+    else
+    {
+      ret_send = splice(file_descriptor, NULL, session->file_descriptor, NULL, size - sent, SPLICE_F_MOVE | SPLICE_F_MORE);
+    }
+
+    if(ret_send < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+
+      if(errno == ECONNRESET || errno == EPIPE)
+      {
+        broken_pipe = (errno == EPIPE);
+        jcon_socket_close(session);
+      }
+      else
+      {
+        ERROR_RL(session, "%s() failed [%d : %s].", use_splice ? "splice" : "sendfile", errno, strerror(errno));
+      }
+      break;
+    }
+
+    if(ret_send == 0)
+    {
+      /* End of file. */
+      break;
+    }
+
+    sent += ret_send;
+  }
+
+  if(broken_pipe && pipe_pending == false)
+  {
+    struct timespec no_wait = { 0, 0 };
+    sigtimedwait(&pipe_set, NULL, &no_wait);
+  }
+  pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_sent_bytes_total", "Bytes sent by sockets.", sent);
+  return sent;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_socket_recvBatch(jcon_socket_t *session, jcon_socket_datagram_t *datagrams, size_t count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return 0;
+  }
+
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT)
+  {
+    ERROR(session, "Session is not of type client.");
+    return 0;
+  }
+
+  if(datagrams == NULL || count == 0)
+  {
+    ERROR(session, "No datagrams given.");
+    return 0;
+  }
+
+  if(session->function_recv)
+  {
+    ERROR(session, "Socket does not support batch functions.");
+    return 0;
+  }
+
+  if(count > JCON_SOCKET_BATCH_MAX)
+  {
+    count = JCON_SOCKET_BATCH_MAX;
+  }
+
+  struct mmsghdr msgs[JCON_SOCKET_BATCH_MAX];
+  struct iovec iov[JCON_SOCKET_BATCH_MAX];
+  memset(msgs, 0, sizeof(struct mmsghdr) * count);
+
+  for(size_t i = 0; i < count; i++)
+  {
+    iov[i].iov_base = datagrams[i].data_ptr;
+    iov[i].iov_len = datagrams[i].data_size;
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &datagrams[i].address;
+    msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+  }
+
+  /* Blocks only for the first datagram. */
+  int ret_recv = recvmmsg(session->file_descriptor, msgs, (unsigned int)count, MSG_WAITFORONE, NULL);
+  if(ret_recv < 0)
+  {
+    if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+    {
+      DEBUG(session, "No datagram available.");
+      errno = EAGAIN;
+      return 0;
+    }
+    if(errno == ECONNREFUSED)
+    {
+      /* ICMP error of an earlier datagram, socket stays usable. */
+      DEBUG(session, "recvmmsg() reported [ECONNREFUSED].");
+      return 0;
+    }
+    ERROR_RL(session, "recvmmsg() failed [%d : %s].", errno, strerror(errno));
+    jcon_socket_close(session);
+    return 0;
+  }
+
+  if(ret_recv > 0 && msgs[0].msg_len == 0)
+  {
+    int type = 0;
+    socklen_t type_size = sizeof(type);
+    if(getsockopt(session->file_descriptor, SOL_SOCKET, SO_TYPE, &type, &type_size) == 0 && type != SOCK_DGRAM)
+    {
+      DEBUG(session, "recvmmsg() recieved [EOF]. Closing socket.");
+      jcon_socket_close(session);
+      return 0;
+    }
+  }
+
+  unsigned long long received = 0;
+  for(int i = 0; i < ret_recv; i++)
+  {
+    datagrams[i].transferred = msgs[i].msg_len;
+    datagrams[i].address_size = msgs[i].msg_hdr.msg_namelen;
+    datagrams[i].truncated = ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? true : false);
+    received += msgs[i].msg_len;
+  }
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_received_bytes_total", "Bytes received by sockets.", received);
+
+  return (size_t)ret_recv;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_socket_sendBatch(jcon_socket_t *session, jcon_socket_datagram_t *datagrams, size_t count)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return 0;
+  }
+
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT)
+  {
+    ERROR(session, "Session is not of type client.");
+    return 0;
+  }
+
+  if(datagrams == NULL || count == 0)
+  {
+    ERROR(session, "No datagrams given.");
+    return 0;
+  }
+
+  if(session->function_send)
+  {
+    ERROR(session, "Socket does not support batch functions.");
+    return 0;
+  }
+
+  struct mmsghdr msgs[JCON_SOCKET_BATCH_MAX];
+  struct iovec iov[JCON_SOCKET_BATCH_MAX];
+  size_t sent = 0;
+
+  while(sent < count)
+  {
+    size_t batch = count - sent;
+    if(batch > JCON_SOCKET_BATCH_MAX)
+    {
+      batch = JCON_SOCKET_BATCH_MAX;
+    }
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * batch);
+    for(size_t i = 0; i < batch; i++)
+    {
+      jcon_socket_datagram_t *datagram = &datagrams[sent + i];
+      iov[i].iov_base = datagram->data_ptr;
+      iov[i].iov_len = datagram->data_size;
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      if(datagram->address_size > 0)
+      {
+        msgs[i].msg_hdr.msg_name = &datagram->address;
+        msgs[i].msg_hdr.msg_namelen = datagram->address_size;
+      }
+    }
+
+    int ret_send = sendmmsg(session->file_descriptor, msgs, (unsigned int)batch, MSG_NOSIGNAL);
+    if(ret_send < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      if(errno == ECONNRESET || errno == EPIPE)
+      {
+        DEBUG(session, "sendmmsg() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+        jcon_socket_close(session);
+        break;
+      }
+      if(errno == ECONNREFUSED)
+      {
+        DEBUG(session, "sendmmsg() reported [ECONNREFUSED].");
+        break;
+      }
+      ERROR_RL(session, "sendmmsg() failed [%d : %s].", errno, strerror(errno));
+      break;
+    }
+
+    unsigned long long sent_bytes = 0;
+    for(int i = 0; i < ret_send; i++)
+    {
+      datagrams[sent + i].transferred = msgs[i].msg_len;
+      sent_bytes += msgs[i].msg_len;
+    }
+    JUTIL_METRICS_COUNTER_ADD("jcon_socket_sent_bytes_total", "Bytes sent by sockets.", sent_bytes);
+    sent += (size_t)ret_send;
+  }
+
+  return sent;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socket_setCork(jcon_socket_t *session, int enable)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return false;
+  }
+
+  if(session->function_setCork == NULL)
+  {
+    DEBUG(session, "Corking not supported by socket type.");
+    return false;
+  }
+
+  return session->function_setCork(session, enable);
+}
+
 //------------------------------------------------------------------------------
 //
 int jcon_socket_isConnected(jcon_socket_t *session)
@@ -427,9 +1040,69 @@ const char *jcon_socket_getReferenceString(jcon_socket_t *session)
     return NULL;
   }
 
+  jcon_socket_formatReferenceString(session);
   return session->referenceString;
 }
 
+//------------------------------------------------------------------------------
+//
+int jcon_socket_getFileDescriptor(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(jcon_socket_isConnected(session) == false)
+  {
+    return -1;
+  }
+
+  if(session->function_getFileDescriptor)
+  {
+    return session->function_getFileDescriptor(session);
+  }
+
+  return session->file_descriptor;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jcon_socket_formatReferenceString(jcon_socket_t *session)
+{
+  int state = __atomic_load_n(&session->referenceString_state, __ATOMIC_ACQUIRE);
+  if(state == JCON_SOCKET_REFERENCESTRING_READY)
+  {
+    return;
+  }
+
+  int expected = JCON_SOCKET_REFERENCESTRING_EMPTY;
+  if(__atomic_compare_exchange_n(&session->referenceString_state, &expected, JCON_SOCKET_REFERENCESTRING_BUSY, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE) == false)
+  {
+    /* Another thread is formatting, which only takes a moment. */
+    while(__atomic_load_n(&session->referenceString_state, __ATOMIC_ACQUIRE) != JCON_SOCKET_REFERENCESTRING_READY)
+    {
+      sched_yield();
+    }
+    return;
+  }
+
+  if(session->function_formatReferenceString == NULL
+    || session->function_formatReferenceString(session, session->referenceString, sizeof(session->referenceString)) == false)
+  {
+    snprintf(session->referenceString, sizeof(session->referenceString), "%s:-", (session->socket_type ? session->socket_type : "SOCKET"));
+  }
+
+  __atomic_store_n(&session->referenceString_state, JCON_SOCKET_REFERENCESTRING_READY, __ATOMIC_RELEASE);
+}
+
 
 
 //==============================================================================
@@ -440,6 +1113,11 @@ const char *jcon_socket_getReferenceString(jcon_socket_t *session)
 //
 void jcon_socket_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
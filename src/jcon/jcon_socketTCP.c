@@ -9,8 +9,11 @@
  * 
  */
 
+#define _GNU_SOURCE /* needed for SO_REUSEPORT and accept4() */
+
 #include <jayc/jcon_socketTCP.h>
 #include <jayc/jcon_socket_dev.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -18,10 +21,21 @@
 #include <stdarg.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <netdb.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_socketTCP");
+
+
 
 //==============================================================================
 // Define constants and structures.
@@ -29,15 +43,41 @@
 
 #define JCON_SOCKETTCP_CONNECTIONTYPE "TCP"
 
+/**
+ * @brief Address of IPv4 or IPv6 socket.
+ */
+typedef union __jcon_socketTCP_address
+{
+  struct sockaddr base;               /**< Generic address, family decides used member. */
+  struct sockaddr_in in4;             /**< IPv4 address. */
+  struct sockaddr_in6 in6;            /**< IPv6 address. */
+} jcon_socketTCP_address_t;
+
 /**
  * @brief Session context for TCP sockets.
  * 
  */
 typedef struct __jcon_socketTCP_context
 {
-  struct sockaddr_in socket_address;  /**< Address struct. */
+  jcon_socketTCP_address_t socket_address;  /**< Address struct. */
+  jcon_socketTCP_options_t options;   /**< Tuning options, set before connecting or binding. */
+  int connect_timeout;                /**< Timeout for connect in milliseconds, @c -1 blocks. */
+  int reuse_port;                     /**< If @c true , @c SO_REUSEPORT is set before binding. */
+  int is_clone;                       /**< If @c true , context is allocated together with the session. */
 } jcon_socketTCP_ctx_t;
 
+/**
+ * @brief Session of accepted connection.
+ * 
+ * Session and context share one allocation,
+ * because servers create them for every connection.
+ */
+typedef struct __jcon_socketTCP_clone
+{
+  jcon_socket_t session;              /**< Session object. */
+  jcon_socketTCP_ctx_t ctx;           /**< Context of session. */
+} jcon_socketTCP_clone_t;
+
 
 
 //==============================================================================
@@ -53,12 +93,13 @@ typedef struct __jcon_socketTCP_context
  * 
  * @param fd              File descriptor of new socket.
  * @param socket_address  Address struct of new socket.
+ * @param options         Options of listener, applied to new socket.
  * @param logger          Logger for new session.
  * 
  * @return                Session object for new client connection.
  * @return                @c NULL in case of error.
  */
-static jcon_socket_t *jcon_socketTCP_clone(int fd, struct sockaddr_in socket_address, jlog_t *logger);
+static jcon_socket_t *jcon_socketTCP_clone(int fd, jcon_socketTCP_address_t socket_address, const jcon_socketTCP_options_t *options, jlog_t *logger);
 
 /**
  * @brief Frees session memory.
@@ -81,6 +122,34 @@ static void jcon_socketTCP_free(jcon_socket_t *session);
  */
 static int jcon_socketTCP_connect(jcon_socket_t *session);
 
+/**
+ * @brief Creates socket and connects it to address of session.
+ * 
+ * Does not change session.
+ * 
+ * @param session Session with address, options and connect timeout.
+ * 
+ * @return        Descriptor of connected socket.
+ * @return        @c -1 , if connection failed.
+ */
+static int jcon_socketTCP_connectDescriptor(jcon_socket_t *session);
+
+/**
+ * @brief Connects socket without blocking longer than timeout.
+ * 
+ * Sets socket non-blocking for @c connect() , waits with
+ * @c poll() and restores blocking mode afterwards.
+ * 
+ * @param session Session for log messages.
+ * @param fd      Socket to connect.
+ * @param addr    Address of server.
+ * @param timeout Timeout in milliseconds.
+ * 
+ * @return        @c true , if connection was established.
+ * @return        @c false , if timed out or error occured.
+ */
+static int jcon_socketTCP_connectTimeout(jcon_socket_t *session, int fd, const jcon_socketTCP_address_t *addr, int timeout);
+
 /**
  * @brief Binds socket to address.
  * 
@@ -106,15 +175,73 @@ static int jcon_socketTCP_bind(jcon_socket_t *session);
  */
 static jcon_socket_t *jcon_socketTCP_accept(jcon_socket_t *session);
 
+/**
+ * @brief Sets @c TCP_CORK option of socket.
+ * 
+ * Called by @c #jcon_socket_setCork() .
+ * 
+ * @param session Session to configure.
+ * @param enable  Value of option.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketTCP_setCork(jcon_socket_t *session, int enable);
+
+/**
+ * @brief Sets socket options, that are shared by
+ *        clients and listeners.
+ * 
+ * Socket buffers, keepalive, @c TCP_NODELAY and busy polling.
+ * Options set to @c 0 are skipped.
+ * 
+ * @param session Session for log messages.
+ * @param fd      Socket to configure.
+ * @param options Options to apply.
+ * 
+ * @return        @c true , if all options were set.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketTCP_applyOptions(jcon_socket_t *session, int fd, const jcon_socketTCP_options_t *options);
+
+/**
+ * @brief Sets integer socket option and logs errors.
+ * 
+ * @param session Session for log messages.
+ * @param fd      Socket to configure.
+ * @param level   Protocol level ( @c SOL_SOCKET , @c IPPROTO_TCP , ...).
+ * @param name    Option to set.
+ * @param value   Value of option.
+ * @param string  Name of option for log messages.
+ * 
+ * @return        @c true , if option was set.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketTCP_setOption(jcon_socket_t *session, int fd, int level, int name, int value, const char *string);
+
+/**
+ * @brief Returns size of address struct, depending on family.
+ * 
+ * @param socket_address  Address struct.
+ * 
+ * @return                Size for @c connect() and @c bind() .
+ */
+static socklen_t jcon_socketTCP_getAddressSize(const jcon_socketTCP_address_t *socket_address);
+
 /**
  * @brief Extract IP address from address struct.
  * 
+ * IPv4 addresses mapped into IPv6 are written in IPv4 notation,
+ * so dual-stack listeners create the same reference strings.
+ * 
  * @param socket_address  Address struct.
+ * @param buf             Buffer to write IP address into.
+ * @param size            Size of buffer.
  * 
- * @return                String with IP address.
+ * @return                buf with IP address.
  * @return                @c NULL in case of error.
  */
-static char *jcon_socketTCP_getIP(struct sockaddr_in socket_address);
+static char *jcon_socketTCP_getIP(const jcon_socketTCP_address_t *socket_address, char *buf, size_t size);
 
 /**
  * @brief Extract port number from address struct. 
@@ -124,23 +251,26 @@ static char *jcon_socketTCP_getIP(struct sockaddr_in socket_address);
  * @return                Port number.
  * @return                @c 0 in case of error.
  */
-static uint16_t jcon_socketTCP_getPort(struct sockaddr_in socket_address);
+static uint16_t jcon_socketTCP_getPort(const jcon_socketTCP_address_t *socket_address);
 
 /**
- * @brief Create reference string from socket address.
+ * @brief Formats reference string from socket address.
  * 
  * Reference string consists of connection type (TCP),
  * IP address ( @c #jcon_tcp_getIP() ) and port number
  * ( @c #jcon_tcp_getPort() ).
  * 
  * These items get combined into one string.
+ * IPv6 addresses are put into brackets.
  * 
- * @param socket_address  Address struct.
+ * @param session Session object.
+ * @param buf     Buffer to write reference string to.
+ * @param size    Size of @c buf .
  * 
- * @return                Allocated reference string.
- * @return                @c NULL in case of error.
+ * @return        @c true , if reference string was formatted.
+ * @return        @c false , if error occured.
  */
-static char *jcon_socketTCP_createReferenceString(struct sockaddr_in socket_address);
+static int jcon_socketTCP_formatReferenceString(jcon_socket_t *session, char *buf, size_t size);
 
 /**
  * @brief Sends log messages to logger with session data.
@@ -162,15 +292,20 @@ static void jcon_socketTCP_log(jcon_socket_t *session, int log_type, const char
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG /* Allow to turn of debug messages at compile time. */
   #define DEBUG(session, fmt, ...)
 #else
-  #define DEBUG(session, fmt, ...) jcon_socketTCP_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_socketTCP_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(session, fmt, ...) jcon_socketTCP_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(session, fmt, ...) jcon_socketTCP_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(session, fmt, ...) jcon_socketTCP_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(session, fmt, ...) jcon_socketTCP_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_socketTCP_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_socketTCP_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_socketTCP_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_socketTCP_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(session, fmt, ...) jcon_socketTCP_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -183,7 +318,14 @@ static void jcon_socketTCP_log(jcon_socket_t *session, int log_type, const char
 //
 jcon_socket_t *jcon_socketTCP_simple_init(const char *address, uint16_t port, jlog_t *logger)
 {
-  jcon_socket_t *session = (jcon_socket_t *)malloc(sizeof(jcon_socket_t));
+  return jcon_socketTCP_options_init(address, port, NULL, logger);
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketTCP_options_init(const char *address, uint16_t port, const jcon_socketTCP_options_t *options, jlog_t *logger)
+{
+  jcon_socket_t *session = (jcon_socket_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socket_t));
   if(session == NULL)
   {
     ERROR(NULL, "malloc() failed.");
@@ -194,48 +336,315 @@ jcon_socket_t *jcon_socketTCP_simple_init(const char *address, uint16_t port, jl
   session->function_bind = &jcon_socketTCP_bind;
   session->function_close = NULL;
   session->function_accept = &jcon_socketTCP_accept;
+  session->function_setCork = &jcon_socketTCP_setCork;
+  session->function_recv = NULL;
+  session->function_send = NULL;
+  session->function_poll = NULL;
+  session->function_getFileDescriptor = NULL;
+  session->function_formatReferenceString = &jcon_socketTCP_formatReferenceString;
   session->session_free_handler = &jcon_socketTCP_free;
+  session->referenceString_state = 0;
 
   session->file_descriptor = 0;
   session->logger = logger;
   session->socket_type = JCON_SOCKETTCP_CONNECTIONTYPE;
   session->connection_type = 0;
 
-  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)malloc(sizeof(jcon_socketTCP_ctx_t));
+  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socketTCP_ctx_t));
   if(ctx == NULL)
   {
     ERROR(NULL, "malloc() failed. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
-  ctx->socket_address.sin_family = AF_INET;
-  ctx->socket_address.sin_port = htons(port);
+  memset(ctx, 0, sizeof(jcon_socketTCP_ctx_t));
+  if(options)
+  {
+    ctx->options = *options;
+  }
+  ctx->connect_timeout = -1;
+  ctx->reuse_port = (ctx->options.reuse_port ? true : false);
+
+  if(ctx->options.ipv6)
+  {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET6;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_V4MAPPED;
+
+    struct addrinfo *result = NULL;
+    int ret_gai = getaddrinfo(address, NULL, &hints, &result);
+    if(ret_gai != 0 || result == NULL)
+    {
+      ERROR(NULL, "<TCP:%s:%u> getaddrinfo() failed [%d : %s]. Destroying context and session.", address, port, ret_gai, gai_strerror(ret_gai));
+      JUTIL_ALLOC_FREE(ctx);
+      JUTIL_ALLOC_FREE(session);
+      return NULL;
+    }
+
+    memcpy(&ctx->socket_address.in6, result->ai_addr, sizeof(struct sockaddr_in6));
+    ctx->socket_address.in6.sin6_port = htons(port);
+    freeaddrinfo(result);
+  }
+  else
+  {
+    ctx->socket_address.in4.sin_family = AF_INET;
+    ctx->socket_address.in4.sin_port = htons(port);
+
+    struct hostent *hostinfo;
+    hostinfo = gethostbyname(address);
+    if(hostinfo == NULL)
+    {
+      ERROR(NULL, "<TCP:%s:%u> gethostbyname() failed. Destroying context and session.", address, port);
+      JUTIL_ALLOC_FREE(ctx);
+      JUTIL_ALLOC_FREE(session);
+      return NULL;
+    }
+    ctx->socket_address.in4.sin_addr = *(struct in_addr *)hostinfo->h_addr_list[0];
+  }
+
+  session->session_ctx = (void *)ctx;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_setConnectTimeout(jcon_socket_t *session, int timeout)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETTCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(session, "Session is not of type TCP.");
+    return false;
+  }
 
-  struct hostent *hostinfo;
-  hostinfo = gethostbyname(address);
-  if(hostinfo == NULL)
+  if(timeout < -1)
   {
-    ERROR(NULL, "<TCP:%s:%u> gethostbyname() failed. Destroying context and session.", address, port);
-    free(session);
+    ERROR(session, "Invalid connect timeout [%d].", timeout);
+    return false;
+  }
+
+  ((jcon_socketTCP_ctx_t *)session->session_ctx)->connect_timeout = timeout;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_setReusePort(jcon_socket_t *session, int enable)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETTCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(session, "Session is not of type TCP.");
+    return false;
+  }
+
+  ((jcon_socketTCP_ctx_t *)session->session_ctx)->reuse_port = (enable ? true : false);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketTCP_adopt_init(int fd, const jcon_socketTCP_options_t *options, jlog_t *logger)
+{
+  if(fd <= 0)
+  {
+    ERROR(NULL, "Invalid file descriptor [%d].", fd);
     return NULL;
   }
-  ctx->socket_address.sin_addr = *(struct in_addr *)hostinfo->h_addr_list[0];
 
-  session->referenceString = jcon_socketTCP_createReferenceString(ctx->socket_address);
-  if(session->referenceString == NULL)
+  int value = 0;
+  socklen_t value_size = sizeof(value);
+  if(getsockopt(fd, SOL_SOCKET, SO_TYPE, &value, &value_size) < 0)
   {
-    ERROR(NULL, "<TCP> jcon_socketTCP_createReferenceString() failed. Destroying session.");
-    free(session);
-    free(ctx);
+    ERROR(NULL, "getsockopt(SO_TYPE) failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    return NULL;
+  }
+  if(value != SOCK_STREAM)
+  {
+    ERROR(NULL, "Descriptor [%d] is not a stream socket.", fd);
     return NULL;
   }
 
-  session->session_ctx = (void *)ctx;
+  value_size = sizeof(value);
+  if(getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &value, &value_size) < 0 || value == 0)
+  {
+    ERROR(NULL, "Descriptor [%d] is not listening.", fd);
+    return NULL;
+  }
+
+  jcon_socketTCP_address_t addr;
+  socklen_t addrlen = sizeof(addr);
+  memset(&addr, 0, sizeof(addr));
+  if(getsockname(fd, &addr.base, &addrlen) < 0)
+  {
+    ERROR(NULL, "getsockname() failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    return NULL;
+  }
+  if(addr.base.sa_family != AF_INET && addr.base.sa_family != AF_INET6)
+  {
+    ERROR(NULL, "Descriptor [%d] is not an IP socket.", fd);
+    return NULL;
+  }
+
+  /* Inherited descriptors may come without these flags.
+     Accepting stops at EAGAIN, like with own listeners. */
+  int flags = fcntl(fd, F_GETFL);
+  if(flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) < 0)
+  {
+    ERROR(NULL, "fcntl() failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    return NULL;
+  }
+
+  /* Family of the socket decides, how the placeholder address is resolved. */
+  jcon_socketTCP_options_t adopt_options;
+  memset(&adopt_options, 0, sizeof(adopt_options));
+  if(options)
+  {
+    adopt_options = *options;
+  }
+  adopt_options.ipv6 = (addr.base.sa_family == AF_INET6 ? true : false);
+
+  jcon_socket_t *session = jcon_socketTCP_options_init((adopt_options.ipv6 ? "::" : "0.0.0.0"), 0, &adopt_options, logger);
+  if(session == NULL)
+  {
+    ERROR(NULL, "jcon_socketTCP_options_init() failed for [%d].", fd);
+    return NULL;
+  }
+
+  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)session->session_ctx;
+  ctx->socket_address = addr;
+
+  value_size = sizeof(value);
+  if(getsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &value, &value_size) == 0)
+  {
+    ctx->reuse_port = (value ? true : false);
+    ctx->options.reuse_port = ctx->reuse_port;
+  }
+
+  /* Socket stays bound, reset only binds again after close. */
+  session->file_descriptor = fd;
+  session->connection_type = JCON_SOCKET_CONNECTIONTYPE_SERVER;
 
   return session;
 }
 
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_getLocalAddress(jcon_socket_t *session, char *buf, size_t size, uint16_t *port)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETTCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(session, "Session is not of type TCP.");
+    return false;
+  }
+
+  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)session->session_ctx;
+
+  if(jcon_socketTCP_getIP(&ctx->socket_address, buf, size) == NULL)
+  {
+    ERROR(session, "jcon_socketTCP_getIP() failed.");
+    return false;
+  }
+
+  if(port)
+  {
+    *port = jcon_socketTCP_getPort(&ctx->socket_address);
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_getOptions(jcon_socket_t *session, jcon_socketTCP_options_t *options)
+{
+  if(session == NULL || options == NULL)
+  {
+    ERROR(NULL, "Session or options is NULL.");
+    return false;
+  }
+
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETTCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(session, "Session is not of type TCP.");
+    return false;
+  }
+
+  *options = ((jcon_socketTCP_ctx_t *)session->session_ctx)->options;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_openConnection(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETTCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(session, "Session is not of type TCP.");
+    return -1;
+  }
+
+  return jcon_socketTCP_connectDescriptor(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_setConnection(jcon_socket_t *session, int fd)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETTCP_CONNECTIONTYPE) != 0)
+  {
+    ERROR(session, "Session is not of type TCP.");
+    return false;
+  }
+
+  if(fd < 0)
+  {
+    ERROR(session, "Invalid file descriptor [%d].", fd);
+    return false;
+  }
+
+  if(jcon_socket_isConnected(session))
+  {
+    DEBUG(session, "Session is already connected.");
+    return false;
+  }
+
+  session->file_descriptor = fd;
+  session->connection_type = JCON_SOCKET_CONNECTIONTYPE_CLIENT;
+  return true;
+}
+
 
 
 //==============================================================================
@@ -244,7 +653,7 @@ jcon_socket_t *jcon_socketTCP_simple_init(const char *address, uint16_t port, jl
 
 //------------------------------------------------------------------------------
 //
-jcon_socket_t *jcon_socketTCP_clone(int fd, struct sockaddr_in socket_address, jlog_t *logger)
+jcon_socket_t *jcon_socketTCP_clone(int fd, jcon_socketTCP_address_t socket_address, const jcon_socketTCP_options_t *options, jlog_t *logger)
 {
   if(fd <= 0)
   {
@@ -252,43 +661,50 @@ jcon_socket_t *jcon_socketTCP_clone(int fd, struct sockaddr_in socket_address, j
     return NULL;
   }
 
-  jcon_socket_t *session = (jcon_socket_t *)malloc(sizeof(jcon_socket_t));
-  if(session == NULL)
+  jcon_socketTCP_clone_t *clone = (jcon_socketTCP_clone_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socketTCP_clone_t));
+  if(clone == NULL)
   {
     ERROR(NULL, "malloc() failed.");
     return NULL;
   }
 
+  jcon_socket_t *session = &clone->session;
   session->function_connect = NULL; /* Cloned sessions cannot reconnect. */
   session->function_bind = NULL; /* Cloned sessions cannot bind. */
   session->function_close = NULL;
   session->function_accept = NULL; /* Cloned sessions cannot bind and therefore not accept. */
+  session->function_setCork = &jcon_socketTCP_setCork;
+  session->function_recv = NULL;
+  session->function_send = NULL;
+  session->function_poll = NULL;
+  session->function_getFileDescriptor = NULL;
+  session->function_formatReferenceString = &jcon_socketTCP_formatReferenceString;
   session->session_free_handler = &jcon_socketTCP_free;
+  session->referenceString_state = 0;
 
   session->file_descriptor = fd;
   session->logger = logger;
+  session->socket_type = JCON_SOCKETTCP_CONNECTIONTYPE;
   session->connection_type = JCON_SOCKET_CONNECTIONTYPE_CLIENT;
 
-  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)malloc(sizeof(jcon_socketTCP_ctx_t));
-  if(ctx == NULL)
-  {
-    ERROR(NULL, "malloc() failed. Destroying session.");
-    free(session);
-    return NULL;
-  }
-
+  jcon_socketTCP_ctx_t *ctx = &clone->ctx;
+  memset(ctx, 0, sizeof(jcon_socketTCP_ctx_t));
   ctx->socket_address = socket_address;
-  session->referenceString = jcon_socketTCP_createReferenceString(socket_address);
-  if(session->referenceString == NULL)
+  ctx->options = *options;
+  ctx->connect_timeout = -1;
+  ctx->reuse_port = false;
+  ctx->is_clone = true;
+
+  session->session_ctx = ctx;
+
+  if(jcon_socketTCP_applyOptions(session, fd, options) == false
+    || (options->quick_ack && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK") == false))
   {
-    ERROR(NULL, "<TCP> json_socketTCP_createReferenceString() failed. Destroying context and session.");
-    free(session);
-    free(ctx);
+    ERROR(session, "Setting options failed. Destroying session.");
+    JUTIL_ALLOC_FREE(clone);
     return NULL;
   }
 
-  session->session_ctx = ctx;
-
   return session;
 }
 
@@ -302,9 +718,10 @@ void jcon_socketTCP_free(jcon_socket_t *session)
     return;
   }
 
-  if(session->session_ctx)
+  /* Context of clones is freed with the session. */
+  if(session->session_ctx && ((jcon_socketTCP_ctx_t *)session->session_ctx)->is_clone == false)
   {
-    free(session->session_ctx);
+    JUTIL_ALLOC_FREE(session->session_ctx);
   }
 }
 
@@ -324,26 +741,133 @@ int jcon_socketTCP_connect(jcon_socket_t *session)
     return true;
   }
 
-  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int fd = jcon_socketTCP_connectDescriptor(session);
   if(fd < 0)
   {
-    ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
-  struct sockaddr_in addr = ((jcon_socketTCP_ctx_t *)session->session_ctx)->socket_address;
+  session->file_descriptor = fd;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_connectDescriptor(jcon_socket_t *session)
+{
+  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)session->session_ctx;
+  jcon_socketTCP_address_t addr = ctx->socket_address;
 
-  if(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  int fd = socket(addr.base.sa_family, SOCK_STREAM, 0);
+  if(fd < 0)
+  {
+    ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
+    return -1;
+  }
+
+  if(jcon_socketTCP_applyOptions(session, fd, &ctx->options) == false
+    || (ctx->options.fast_open && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, 1, "TCP_FASTOPEN_CONNECT") == false))
+  {
+    ERROR(session, "Setting options failed. Closing socket.");
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return -1;
+  }
+
+  if(ctx->connect_timeout >= 0)
+  {
+    if(jcon_socketTCP_connectTimeout(session, fd, &addr, ctx->connect_timeout) == false)
+    {
+      if(close(fd) < 0)
+      {
+        ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+      }
+      return -1;
+    }
+  }
+  else if(connect(fd, &addr.base, jcon_socketTCP_getAddressSize(&addr)) < 0)
   {
     ERROR(session, "connect() failed [%d : %s]. Closing socket.", errno, strerror(errno));
     if(close(fd) < 0)
     {
       ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
     }
+    return -1;
+  }
+
+  /* Not permanent, kernel may switch back to delayed ACKs. */
+  if(ctx->options.quick_ack)
+  {
+    jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+  }
+
+  return fd;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_connectTimeout(jcon_socket_t *session, int fd, const jcon_socketTCP_address_t *addr, int timeout)
+{
+  int flags = fcntl(fd, F_GETFL, 0);
+  if(flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+  {
+    ERROR(session, "fcntl() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  if(connect(fd, &addr->base, jcon_socketTCP_getAddressSize(addr)) < 0)
+  {
+    if(errno != EINPROGRESS)
+    {
+      ERROR(session, "connect() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+      return false;
+    }
+
+    struct pollfd poll_fd;
+    poll_fd.fd = fd;
+    poll_fd.events = POLLOUT;
+
+    int ret_poll;
+    do
+    {
+      ret_poll = poll(&poll_fd, 1, timeout);
+    } while(ret_poll < 0 && errno == EINTR);
+
+    if(ret_poll < 0)
+    {
+      ERROR(session, "poll() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+      return false;
+    }
+
+    if(ret_poll == 0)
+    {
+      ERROR(session, "connect() timed out after [%d ms]. Closing socket.", timeout);
+      return false;
+    }
+
+    int error = 0;
+    socklen_t error_size = sizeof(error);
+    if(getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_size) < 0)
+    {
+      ERROR(session, "getsockopt() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+      return false;
+    }
+
+    if(error)
+    {
+      ERROR(session, "connect() failed [%d : %s]. Closing socket.", error, strerror(error));
+      return false;
+    }
+  }
+
+  if(fcntl(fd, F_SETFL, flags) < 0)
+  {
+    ERROR(session, "fcntl() failed [%d : %s]. Closing socket.", errno, strerror(errno));
     return false;
   }
 
-  session->file_descriptor = fd;
   return true;
 }
 
@@ -364,16 +888,46 @@ int jcon_socketTCP_bind(jcon_socket_t *session)
     return true;
   }
 
-  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  jcon_socketTCP_ctx_t *ctx = (jcon_socketTCP_ctx_t *)session->session_ctx;
+  jcon_socketTCP_address_t addr = ctx->socket_address;
+
+  /* Listener never blocks, so accepting can stop at EAGAIN. */
+  int fd = socket(addr.base.sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
   if(fd < 0)
   {
     ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
-  struct sockaddr_in addr = ((jcon_socketTCP_ctx_t *)session->session_ctx)->socket_address;
+  /* Buffer sizes have to be set before listen(),
+     so the window scale of accepted connections fits. */
+  if(jcon_socketTCP_applyOptions(session, fd, &ctx->options) == false
+    || (addr.base.sa_family == AF_INET6 && jcon_socketTCP_setOption(session, fd, IPPROTO_IPV6, IPV6_V6ONLY, (ctx->options.v6_only ? 1 : 0), "IPV6_V6ONLY") == false)
+    || (ctx->options.fast_open > 0 && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_FASTOPEN, ctx->options.fast_open, "TCP_FASTOPEN") == false))
+  {
+    ERROR(session, "Setting options failed. Closing socket.");
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return false;
+  }
 
-  if(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  if(ctx->reuse_port)
+  {
+    int value = 1;
+    if(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value)) < 0)
+    {
+      ERROR(session, "setsockopt(SO_REUSEPORT) failed [%d : %s]. Closing socket.", errno, strerror(errno));
+      if(close(fd) < 0)
+      {
+        ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+      }
+      return false;
+    }
+  }
+
+  if(bind(fd, &addr.base, jcon_socketTCP_getAddressSize(&addr)) < 0)
   {
     ERROR(session, "bind() failed [%d : %s]. Closing socket.", errno, strerror(errno));
     if(close(fd) < 0)
@@ -383,7 +937,7 @@ int jcon_socketTCP_bind(jcon_socket_t *session)
     return false;
   }
 
-  if(listen(fd, 5) < 0)
+  if(listen(fd, (ctx->options.backlog > 0 ? ctx->options.backlog : SOMAXCONN)) < 0)
   {
     ERROR(session, "listen() failed [%d : %s]. Closing socket.", errno, strerror(errno));
     if(close(fd) < 0)
@@ -409,20 +963,27 @@ jcon_socket_t *jcon_socketTCP_accept(jcon_socket_t *session)
   }
 
   int new_fd;
-  struct sockaddr_in new_addr;
-  socklen_t addrlen = sizeof(struct sockaddr_in);
+  jcon_socketTCP_address_t new_addr;
+  socklen_t addrlen = sizeof(jcon_socketTCP_address_t);
 
-  new_fd = accept(session->file_descriptor, (struct sockaddr *)&new_addr, &addrlen);
+  new_fd = accept4(session->file_descriptor, &new_addr.base, &addrlen, SOCK_CLOEXEC);
   if(new_fd < 0)
   {
-    ERROR(session, "accept() failed [%d : %s].", errno, strerror(errno));
+    if(errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      DEBUG(session, "No pending connection.");
+      errno = EAGAIN; /* Callers tell an empty backlog from errors by errno. */
+      return NULL;
+    }
+    ERROR(session, "accept4() failed [%d : %s].", errno, strerror(errno));
     return NULL;
   }
 
-  jcon_socket_t *new_con = jcon_socketTCP_clone(new_fd, new_addr, session->logger);
+  jcon_socket_t *new_con = jcon_socketTCP_clone(new_fd, new_addr, &((jcon_socketTCP_ctx_t *)session->session_ctx)->options, session->logger);
   if(new_con == NULL)
   {
-    ERROR(session, "jcon_socket_clone() failed with new connection [TCP:%s:%u].", jcon_socketTCP_getIP(new_addr), jcon_socketTCP_getPort(new_addr));
+    char ip[INET6_ADDRSTRLEN];
+    ERROR(session, "jcon_socket_clone() failed with new connection [TCP:%s:%u].", jcon_socketTCP_getIP(&new_addr, ip, sizeof(ip)), jcon_socketTCP_getPort(&new_addr));
     close(new_fd);
     return NULL;
   }
@@ -432,73 +993,178 @@ jcon_socket_t *jcon_socketTCP_accept(jcon_socket_t *session)
 
 //------------------------------------------------------------------------------
 //
-char *jcon_socketTCP_getIP(struct sockaddr_in socket_address)
+int jcon_socketTCP_setCork(jcon_socket_t *session, int enable)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  int value = (enable ? 1 : 0);
+  if(setsockopt(session->file_descriptor, IPPROTO_TCP, TCP_CORK, &value, sizeof(value)) < 0)
+  {
+    ERROR(session, "setsockopt(TCP_CORK) failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_applyOptions(jcon_socket_t *session, int fd, const jcon_socketTCP_options_t *options)
+{
+  if(options->send_buffer > 0 && jcon_socketTCP_setOption(session, fd, SOL_SOCKET, SO_SNDBUF, options->send_buffer, "SO_SNDBUF") == false)
+  {
+    return false;
+  }
+
+  if(options->recv_buffer > 0 && jcon_socketTCP_setOption(session, fd, SOL_SOCKET, SO_RCVBUF, options->recv_buffer, "SO_RCVBUF") == false)
+  {
+    return false;
+  }
+
+  if(options->keepalive)
+  {
+    if(jcon_socketTCP_setOption(session, fd, SOL_SOCKET, SO_KEEPALIVE, 1, "SO_KEEPALIVE") == false
+      || (options->keepalive_idle > 0 && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_KEEPIDLE, options->keepalive_idle, "TCP_KEEPIDLE") == false)
+      || (options->keepalive_interval > 0 && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_KEEPINTVL, options->keepalive_interval, "TCP_KEEPINTVL") == false)
+      || (options->keepalive_count > 0 && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_KEEPCNT, options->keepalive_count, "TCP_KEEPCNT") == false))
+    {
+      return false;
+    }
+  }
+
+  if(options->no_delay && jcon_socketTCP_setOption(session, fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY") == false)
+  {
+    return false;
+  }
+
+  if(options->busy_poll > 0 && jcon_socketTCP_setOption(session, fd, SOL_SOCKET, SO_BUSY_POLL, options->busy_poll, "SO_BUSY_POLL") == false)
+  {
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketTCP_setOption(jcon_socket_t *session, int fd, int level, int name, int value, const char *string)
+{
+  if(setsockopt(fd, level, name, &value, sizeof(value)) < 0)
+  {
+    ERROR(session, "setsockopt(%s) failed [%d : %s].", string, errno, strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+socklen_t jcon_socketTCP_getAddressSize(const jcon_socketTCP_address_t *socket_address)
+{
+  if(socket_address->base.sa_family == AF_INET6)
+  {
+    return sizeof(struct sockaddr_in6);
+  }
+
+  return sizeof(struct sockaddr_in);
+}
+
+//------------------------------------------------------------------------------
+//
+char *jcon_socketTCP_getIP(const jcon_socketTCP_address_t *socket_address, char *buf, size_t size)
 {
-  char *ip = inet_ntoa(socket_address.sin_addr);
+  const char *ip;
+
+  if(socket_address->base.sa_family == AF_INET6)
+  {
+    if(IN6_IS_ADDR_V4MAPPED(&socket_address->in6.sin6_addr))
+    {
+      ip = inet_ntop(AF_INET, &socket_address->in6.sin6_addr.s6_addr[12], buf, size);
+    }
+    else
+    {
+      ip = inet_ntop(AF_INET6, &socket_address->in6.sin6_addr, buf, size);
+    }
+  }
+  else
+  {
+    ip = inet_ntop(AF_INET, &socket_address->in4.sin_addr, buf, size);
+  }
+
   if(ip == NULL)
   {
-    ERROR(NULL, "inet_ntoa() failed.");
+    ERROR(NULL, "inet_ntop() failed [%d : %s].", errno, strerror(errno));
     return NULL;
   }
 
-  return ip;
+  return buf;
 }
 
 //------------------------------------------------------------------------------
 //
-uint16_t jcon_socketTCP_getPort(struct sockaddr_in socket_address)
+uint16_t jcon_socketTCP_getPort(const jcon_socketTCP_address_t *socket_address)
 {
-  return ntohs(socket_address.sin_port);
+  if(socket_address->base.sa_family == AF_INET6)
+  {
+    return ntohs(socket_address->in6.sin6_port);
+  }
+
+  return ntohs(socket_address->in4.sin_port);
 }
 
 //------------------------------------------------------------------------------
 //
-char *jcon_socketTCP_createReferenceString(struct sockaddr_in socket_address)
+int jcon_socketTCP_formatReferenceString(jcon_socket_t *session, char *buf, size_t size)
 {
-  char buf[128] = { 0 };
+  if(session->session_ctx == NULL)
+  {
+    return false;
+  }
+
+  const jcon_socketTCP_address_t *socket_address = &((jcon_socketTCP_ctx_t *)session->session_ctx)->socket_address;
+  char ip_buf[INET6_ADDRSTRLEN];
   char *ip;
   uint16_t port;
   
-  ip = jcon_socketTCP_getIP(socket_address);
+  ip = jcon_socketTCP_getIP(socket_address, ip_buf, sizeof(ip_buf));
   if(ip == NULL)
   {
     ERROR(NULL, "jcon_socketTCP_getIP() failed.");
-    return NULL;
+    return false;
   }
 
   port = jcon_socketTCP_getPort(socket_address);
   if(port == 0)
   {
     ERROR(NULL, "jcon_socketTCP_getPort() failed.");
-    return NULL;
-  }
-
-  if(sprintf(buf, "TCP:%s:%u", ip, port) < 0)
-  {
-    ERROR(NULL, "sprintf() failed.");
-    return NULL;
+    return false;
   }
 
-  size_t size_refString = sizeof(char) * (strlen(buf) + 1);
-  char *ret = (char *)malloc(size_refString);
-  if(ret == NULL)
+  /* Mapped IPv4 addresses do not contain colons. */
+  const char *fmt = (strchr(ip, ':') ? "TCP:[%s]:%u" : "TCP:%s:%u");
+  if(snprintf(buf, size, fmt, ip, port) < 0)
   {
-    ERROR(NULL, "<TCP:%s:%u> malloc() failed.", ip, port);
-    return NULL;
+    ERROR(NULL, "snprintf() failed.");
+    return false;
   }
 
-  /* Changed implementation from using strcpy, to using memcpy;
-     to calm down devskim checks. */
-  memset(ret, 0, size_refString);
-  memcpy(ret, buf, size_refString);
-
-  return ret;
+  return true;
 }
 
 //------------------------------------------------------------------------------
 //
 void jcon_socketTCP_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
@@ -0,0 +1,371 @@
+/**
+ * @file jcon_socketUDP.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementations for jcon_socketUDP.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jcon_socketUDP.h>
+#include <jayc/jcon_socket_dev.h>
+#include <jayc/jutil_alloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_socketUDP");
+
+
+
+//==============================================================================
+// Define constants and structures.
+//
+
+#define JCON_SOCKETUDP_CONNECTIONTYPE "UDP"
+
+/**
+ * @brief Session context for UDP sockets.
+ * 
+ */
+typedef struct __jcon_socketUDP_context
+{
+  struct sockaddr_in socket_address;  /**< Address struct. */
+} jcon_socketUDP_ctx_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Frees session memory.
+ * 
+ * Called by @c #jcon_socket_free() .
+ * 
+ * @param session Session object to free.
+ */
+static void jcon_socketUDP_free(jcon_socket_t *session);
+
+/**
+ * @brief Creates socket with address as default destination.
+ * 
+ * Called by @c #jcon_socket_connect() .
+ * Datagrams from other addresses are filtered by the kernel.
+ * 
+ * @param session Session to connect.
+ * 
+ * @return        @c true , if socket was created.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUDP_connect(jcon_socket_t *session);
+
+/**
+ * @brief Creates socket, that recieves on address.
+ * 
+ * Called by @c #jcon_socket_bind() .
+ * Session stays a client, so datagrams can be read.
+ * 
+ * @param session Session to bind.
+ * 
+ * @return        @c true , if socket was bound to address.
+ * @return        @c false , if binding failed.
+ */
+static int jcon_socketUDP_bind(jcon_socket_t *session);
+
+/**
+ * @brief Formats reference string from socket address.
+ * 
+ * Reference string consists of connection type (UDP),
+ * IP address and port number.
+ * 
+ * @param session Session object.
+ * @param buf     Buffer to write reference string to.
+ * @param size    Size of @c buf .
+ * 
+ * @return        @c true , if reference string was formatted.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUDP_formatReferenceString(jcon_socket_t *session, char *buf, size_t size);
+
+/**
+ * @brief Sends log messages to logger with session data.
+ * 
+ * Uses logger. If available adds reference string to log messages.
+ * 
+ * @param session   Session object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jcon_socketUDP_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allow to turn of debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_socketUDP_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_socketUDP_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_socketUDP_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_socketUDP_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_socketUDP_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jcon_socketUDP_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface funcions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUDP_simple_init(const char *address, uint16_t port, jlog_t *logger)
+{
+  jcon_socket_t *session = (jcon_socket_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socket_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->function_connect = &jcon_socketUDP_connect;
+  session->function_bind = &jcon_socketUDP_bind;
+  session->function_close = NULL;
+  session->function_accept = NULL; /* Datagram sockets have no connections to accept. */
+  session->function_setCork = NULL;
+  session->function_recv = NULL;
+  session->function_send = NULL;
+  session->function_poll = NULL;
+  session->function_getFileDescriptor = NULL;
+  session->function_formatReferenceString = &jcon_socketUDP_formatReferenceString;
+  session->session_free_handler = &jcon_socketUDP_free;
+  session->referenceString_state = 0;
+
+  session->file_descriptor = 0;
+  session->logger = logger;
+  session->socket_type = JCON_SOCKETUDP_CONNECTIONTYPE;
+  session->connection_type = 0;
+
+  jcon_socketUDP_ctx_t *ctx = (jcon_socketUDP_ctx_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socketUDP_ctx_t));
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "malloc() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  memset(ctx, 0, sizeof(jcon_socketUDP_ctx_t));
+  ctx->socket_address.sin_family = AF_INET;
+  ctx->socket_address.sin_port = htons(port);
+
+  struct hostent *hostinfo;
+  hostinfo = gethostbyname(address);
+  if(hostinfo == NULL)
+  {
+    ERROR(NULL, "<UDP:%s:%u> gethostbyname() failed. Destroying context and session.", address, port);
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+  ctx->socket_address.sin_addr = *(struct in_addr *)hostinfo->h_addr_list[0];
+
+  session->session_ctx = (void *)ctx;
+
+  return session;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUDP_free(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(session->session_ctx)
+  {
+    JUTIL_ALLOC_FREE(session->session_ctx);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUDP_connect(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_socket_isConnected(session))
+  {
+    DEBUG(session, "Session is already connected.");
+    return true;
+  }
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if(fd < 0)
+  {
+    ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  struct sockaddr_in addr = ((jcon_socketUDP_ctx_t *)session->session_ctx)->socket_address;
+
+  if(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    ERROR(session, "connect() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return false;
+  }
+
+  session->file_descriptor = fd;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUDP_bind(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_socket_isConnected(session))
+  {
+    DEBUG(session, "Session is already connected.");
+    return true;
+  }
+
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if(fd < 0)
+  {
+    ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  struct sockaddr_in addr = ((jcon_socketUDP_ctx_t *)session->session_ctx)->socket_address;
+
+  if(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    ERROR(session, "bind() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return false;
+  }
+
+  session->file_descriptor = fd;
+  session->connection_type = JCON_SOCKET_CONNECTIONTYPE_CLIENT;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUDP_formatReferenceString(jcon_socket_t *session, char *buf, size_t size)
+{
+  if(session->session_ctx == NULL)
+  {
+    return false;
+  }
+
+  struct sockaddr_in *socket_address = &((jcon_socketUDP_ctx_t *)session->session_ctx)->socket_address;
+  char ip[INET_ADDRSTRLEN];
+  uint16_t port = ntohs(socket_address->sin_port);
+
+  if(inet_ntop(AF_INET, &socket_address->sin_addr, ip, sizeof(ip)) == NULL)
+  {
+    ERROR(NULL, "inet_ntop() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  if(port == 0)
+  {
+    ERROR(NULL, "Port is [0].");
+    return false;
+  }
+
+  if(snprintf(buf, size, "UDP:%s:%u", ip, port) < 0)
+  {
+    ERROR(NULL, "snprintf() failed.");
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUDP_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<%s> %s", jcon_socket_getReferenceString(session), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_socket_getReferenceString(session), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -9,8 +9,12 @@
  * 
  */
 
+#define _GNU_SOURCE /* needed for accept4(), struct ucred */
+
 #include <jayc/jcon_socketUnix.h>
 #include <jayc/jcon_socket_dev.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -18,15 +22,33 @@
 #include <stdarg.h>
 #include <string.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_socketUnix");
+
+
+
 //==============================================================================
 // Define constants and structures.
 //
 
 #define JCON_SOCKETUNIX_CONNECTIONTYPE "UNIX"
 
+/**
+ * @brief Control buffer for @c SCM_RIGHTS , aligned for @c struct @c cmsghdr .
+ */
+typedef union __jcon_socketUnix_control
+{
+  char buf[CMSG_SPACE(sizeof(int) * JCON_SOCKETUNIX_FDS_MAX)]; /**< Space for all descriptors. */
+  struct cmsghdr align;               /**< Forces alignment. */
+} jcon_socketUnix_control_t;
+
 /**
  * @brief Session context for Unix sockets.
  * 
@@ -34,6 +56,7 @@
 typedef struct __jcon_socketUnix_context
 {
   struct sockaddr_un socket_address;  /**< Address struct. */
+  int type;                           /**< @c SOCK_STREAM , @c SOCK_SEQPACKET or @c SOCK_DGRAM . */
 } jcon_socketUnix_ctx_t;
 
 
@@ -51,12 +74,13 @@ typedef struct __jcon_socketUnix_context
  * 
  * @param fd              File descriptor of new socket.
  * @param socket_address  Address struct of new socket.
+ * @param type            Socket type of listener.
  * @param logger          Logger for new session.
  * 
  * @return                Session object for new client connection.
  * @return                @c NULL in case of error.
  */
-static jcon_socket_t *jcon_socketUnix_clone(int fd, struct sockaddr_un socket_address, jlog_t *logger);
+static jcon_socket_t *jcon_socketUnix_clone(int fd, struct sockaddr_un socket_address, int type, jlog_t *logger);
 
 /**
  * @brief Frees session memory.
@@ -115,33 +139,46 @@ static jcon_socket_t *jcon_socketUnix_accept(jcon_socket_t *session);
 static char *jcon_socketUnix_getFile(struct sockaddr_un socket_address);
 
 /**
- * @brief Create reference string from socket address.
+ * @brief Formats reference string from socket address.
  * 
- * Reference string consists of connection type (Unix),
- * IP address ( @c #jcon_Unix_getIP() ) and port number
- * ( @c #jcon_Unix_getPort() ).
+ * Reference string consists of connection type (Unix)
+ * and the path of the socket file.
  * 
- * These items get combined into one string.
+ * @param session Session object.
+ * @param buf     Buffer to write reference string to.
+ * @param size    Size of @c buf .
  * 
- * @param socket_address  Address struct.
- * 
- * @return                Allocated reference string.
- * @return                @c NULL in case of error.
+ * @return        @c true , if reference string was formatted.
+ * @return        @c false , if error occured.
  */
-static char *jcon_socketUnix_createReferenceString(struct sockaddr_un socket_address);
+static int jcon_socketUnix_formatReferenceString(jcon_socket_t *session, char *buf, size_t size);
 
 /**
- * @brief Create reference string without address.
+ * @brief Formats reference string without address.
  * 
  * In the case of clients accepted by a server,
  * there is no valid address available.
  * 
- * In that case return the ref_string "UNIX:-"
+ * In that case the ref_string is "UNIX:-"
  * 
- * @return  Allocated empty ref string.
- * @return  @c NULL in case of error.
+ * @param session Session object.
+ * @param buf     Buffer to write reference string to.
+ * @param size    Size of @c buf .
+ * 
+ * @return        @c true , if reference string was formatted.
+ * @return        @c false , if error occured.
  */
-static char *jcon_socketUnix_createEmptyReferenceString();
+static int jcon_socketUnix_formatEmptyReferenceString(jcon_socket_t *session, char *buf, size_t size);
+
+/**
+ * @brief Checks, that session is a connected Unix client.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        @c true , if session can send and recieve.
+ * @return        @c false , if not.
+ */
+static int jcon_socketUnix_checkConnection(jcon_socket_t *session);
 
 /**
  * @brief Sends log messages to logger with session data.
@@ -163,15 +200,20 @@ static void jcon_socketUnix_log(jcon_socket_t *session, int log_type, const char
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG /* Allow to turn of debug messages at compile time. */
   #define DEBUG(session, fmt, ...)
 #else
-  #define DEBUG(session, fmt, ...) jcon_socketUnix_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_socketUnix_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(session, fmt, ...) jcon_socketUnix_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(session, fmt, ...) jcon_socketUnix_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(session, fmt, ...) jcon_socketUnix_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(session, fmt, ...) jcon_socketUnix_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_socketUnix_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_socketUnix_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_socketUnix_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_socketUnix_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(session, fmt, ...) jcon_socketUnix_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -184,7 +226,7 @@ static void jcon_socketUnix_log(jcon_socket_t *session, int log_type, const char
 //
 jcon_socket_t *jcon_socketUnix_simple_init(const char *filepath, jlog_t *logger)
 {
-  jcon_socket_t *session = (jcon_socket_t *)malloc(sizeof(jcon_socket_t));
+  jcon_socket_t *session = (jcon_socket_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socket_t));
   if(session == NULL)
   {
     ERROR(NULL, "malloc() failed.");
@@ -194,7 +236,7 @@ jcon_socket_t *jcon_socketUnix_simple_init(const char *filepath, jlog_t *logger)
   if(filepath == NULL)
   {
     ERROR(NULL, "filepath is NULL.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -202,48 +244,346 @@ jcon_socket_t *jcon_socketUnix_simple_init(const char *filepath, jlog_t *logger)
   session->function_bind = &jcon_socketUnix_bind;
   session->function_close = NULL;
   session->function_accept = &jcon_socketUnix_accept;
+  session->function_setCork = NULL; /* Unix sockets do not split into segments. */
+  session->function_recv = NULL;
+  session->function_send = NULL;
+  session->function_poll = NULL;
+  session->function_getFileDescriptor = NULL;
+  session->function_formatReferenceString = &jcon_socketUnix_formatReferenceString;
   session->session_free_handler = &jcon_socketUnix_free;
+  session->referenceString_state = 0;
 
   session->file_descriptor = 0;
   session->logger = logger;
   session->socket_type = JCON_SOCKETUNIX_CONNECTIONTYPE;
   session->connection_type = 0;
 
-  jcon_socketUnix_ctx_t *ctx = (jcon_socketUnix_ctx_t *)malloc(sizeof(jcon_socketUnix_ctx_t));
+  jcon_socketUnix_ctx_t *ctx = (jcon_socketUnix_ctx_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socketUnix_ctx_t));
   if(ctx == NULL)
   {
     ERROR(NULL, "malloc() failed. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
   if(strlen(filepath) >= sizeof(ctx->socket_address.sun_path))
   {
     ERROR(NULL, "Filepath too long.");
-    free(session);
-    free(ctx);
+    JUTIL_ALLOC_FREE(session);
+    JUTIL_ALLOC_FREE(ctx);
     return NULL;
   }
 
   ctx->socket_address.sun_family = AF_LOCAL;
+  ctx->type = SOCK_STREAM;
   
   memset(ctx->socket_address.sun_path, 0, sizeof(ctx->socket_address.sun_path));
   memcpy(ctx->socket_address.sun_path, filepath, strlen(filepath));
 
-  session->referenceString = jcon_socketUnix_createReferenceString(ctx->socket_address);
-  if(session->referenceString == NULL)
+  session->session_ctx = (void *)ctx;
+
+  return session;
+}
+
+
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUnix_datagram_init(const char *filepath, int type, jlog_t *logger)
+{
+  if(type != SOCK_DGRAM && type != SOCK_SEQPACKET)
   {
-    ERROR(NULL, "<Unix> jcon_SocketUnix_createReferenceString() failed. Destroying session.");
-    free(session);
-    free(ctx);
+    ERROR(NULL, "Invalid socket type [%d].", type);
     return NULL;
   }
 
-  session->session_ctx = (void *)ctx;
+  jcon_socket_t *session = jcon_socketUnix_simple_init(filepath, logger);
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  ((jcon_socketUnix_ctx_t *)session->session_ctx)->type = type;
+  if(type == SOCK_DGRAM)
+  {
+    session->function_accept = NULL; /* Datagram sockets have no connections to accept. */
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUnix_adopt_init(int fd, jlog_t *logger)
+{
+  if(fd <= 0)
+  {
+    ERROR(NULL, "Invalid file descriptor [%d].", fd);
+    return NULL;
+  }
+
+  int type = 0;
+  socklen_t value_size = sizeof(type);
+  if(getsockopt(fd, SOL_SOCKET, SO_TYPE, &type, &value_size) < 0)
+  {
+    ERROR(NULL, "getsockopt(SO_TYPE) failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    return NULL;
+  }
+  if(type != SOCK_STREAM && type != SOCK_SEQPACKET && type != SOCK_DGRAM)
+  {
+    ERROR(NULL, "Invalid socket type [%d] of descriptor [%d].", type, fd);
+    return NULL;
+  }
+
+  if(type != SOCK_DGRAM)
+  {
+    int listening = 0;
+    value_size = sizeof(listening);
+    if(getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &value_size) < 0 || listening == 0)
+    {
+      ERROR(NULL, "Descriptor [%d] is not listening.", fd);
+      return NULL;
+    }
+  }
+
+  struct sockaddr_un addr;
+  socklen_t addrlen = sizeof(addr);
+  memset(&addr, 0, sizeof(addr));
+  if(getsockname(fd, (struct sockaddr *)&addr, &addrlen) < 0)
+  {
+    ERROR(NULL, "getsockname() failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    return NULL;
+  }
+  if(addr.sun_family != AF_LOCAL)
+  {
+    ERROR(NULL, "Descriptor [%d] is not a Unix socket.", fd);
+    return NULL;
+  }
+
+  /* Inherited descriptors may come without these flags.
+     Datagram sockets recieve on this socket, so they block. */
+  int flags = fcntl(fd, F_GETFL);
+  if(flags < 0
+    || (type != SOCK_DGRAM && fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    || fcntl(fd, F_SETFD, FD_CLOEXEC) < 0)
+  {
+    ERROR(NULL, "fcntl() failed for [%d] [%d : %s].", fd, errno, strerror(errno));
+    return NULL;
+  }
+
+  jcon_socket_t *session = (type == SOCK_STREAM ? jcon_socketUnix_simple_init(addr.sun_path, logger) : jcon_socketUnix_datagram_init(addr.sun_path, type, logger));
+  if(session == NULL)
+  {
+    ERROR(NULL, "Creating session failed for [%d].", fd);
+    return NULL;
+  }
+
+  /* Socket stays bound, the file is not unlinked and bound again. */
+  ((jcon_socketUnix_ctx_t *)session->session_ctx)->socket_address = addr;
+  session->file_descriptor = fd;
+  session->connection_type = (type == SOCK_DGRAM ? JCON_SOCKET_CONNECTIONTYPE_CLIENT : JCON_SOCKET_CONNECTIONTYPE_SERVER);
 
   return session;
 }
 
+//------------------------------------------------------------------------------
+//
+size_t jcon_socketUnix_sendFds(jcon_socket_t *session, void *data_ptr, size_t data_size, const int fds[], size_t count)
+{
+  if(jcon_socketUnix_checkConnection(session) == false)
+  {
+    return 0;
+  }
+
+  if(data_ptr == NULL || data_size == 0)
+  {
+    ERROR(session, "No data given, descriptors need at least one byte.");
+    return 0;
+  }
+
+  if(count > JCON_SOCKETUNIX_FDS_MAX || (count > 0 && fds == NULL))
+  {
+    ERROR(session, "Invalid descriptors (count [%zu]).", count);
+    return 0;
+  }
+
+  struct iovec iov;
+  iov.iov_base = data_ptr;
+  iov.iov_len = data_size;
+
+  jcon_socketUnix_control_t control;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  if(count > 0)
+  {
+    memset(&control, 0, CMSG_SPACE(sizeof(int) * count));
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+  }
+
+  ssize_t ret_send;
+  do
+  {
+    ret_send = sendmsg(session->file_descriptor, &msg, MSG_NOSIGNAL);
+  } while(ret_send < 0 && errno == EINTR);
+
+  if(ret_send < 0)
+  {
+    if(errno == EPIPE || errno == ECONNRESET)
+    {
+      DEBUG(session, "Peer closed connection.");
+      jcon_socket_close(session);
+    }
+    else
+    {
+      ERROR(session, "sendmsg() failed [%d : %s].", errno, strerror(errno));
+    }
+    return 0;
+  }
+
+  DEBUG(session, "Sent [%zd] bytes with [%zu] descriptors.", ret_send, count);
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_sent_bytes_total", "Bytes sent by sockets.", (unsigned long long)ret_send);
+  return ret_send;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_socketUnix_recvFds(jcon_socket_t *session, void *data_ptr, size_t data_size, int fds[], size_t max, size_t *count)
+{
+  if(count)
+  {
+    *count = 0;
+  }
+
+  if(jcon_socketUnix_checkConnection(session) == false)
+  {
+    return 0;
+  }
+
+  if(data_ptr == NULL || data_size == 0)
+  {
+    ERROR(session, "No buffer given.");
+    return 0;
+  }
+
+  if(max > JCON_SOCKETUNIX_FDS_MAX || (max > 0 && (fds == NULL || count == NULL)))
+  {
+    ERROR(session, "Invalid descriptor buffer (max [%zu]).", max);
+    return 0;
+  }
+
+  struct iovec iov;
+  iov.iov_base = data_ptr;
+  iov.iov_len = data_size;
+
+  /* Without space the kernel closes passed descriptors,
+     so callers, that do not expect any, do not leak them. */
+  jcon_socketUnix_control_t control;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  if(max > 0)
+  {
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * max);
+  }
+
+  ssize_t ret_recv;
+  do
+  {
+    ret_recv = recvmsg(session->file_descriptor, &msg, MSG_CMSG_CLOEXEC);
+  } while(ret_recv < 0 && errno == EINTR);
+
+  if(ret_recv < 0)
+  {
+    if(errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+      ERROR(session, "recvmsg() failed [%d : %s].", errno, strerror(errno));
+    }
+    return 0;
+  }
+
+  size_t received = 0;
+  if(max > 0)
+  {
+    for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if(cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      {
+        continue;
+      }
+
+      size_t number = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      if(number > max - received)
+      {
+        number = max - received;
+      }
+      memcpy(&fds[received], CMSG_DATA(cmsg), sizeof(int) * number);
+      received += number;
+    }
+    *count = received;
+  }
+
+  if(msg.msg_flags & MSG_CTRUNC)
+  {
+    WARN(session, "Peer sent more descriptors, than fit into buffer. Rest was closed.");
+  }
+
+  if(ret_recv == 0)
+  {
+    DEBUG(session, "recvmsg() returned [0]. Closing connection.");
+    jcon_socket_close(session);
+    return 0;
+  }
+
+  DEBUG(session, "Recieved [%zd] bytes with [%zu] descriptors.", ret_recv, received);
+  JUTIL_METRICS_COUNTER_ADD("jcon_socket_received_bytes_total", "Bytes received by sockets.", (unsigned long long)ret_recv);
+  return ret_recv;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUnix_getPeerCredentials(jcon_socket_t *session, pid_t *pid, uid_t *uid, gid_t *gid)
+{
+  if(jcon_socketUnix_checkConnection(session) == false)
+  {
+    return false;
+  }
+
+  struct ucred credentials;
+  socklen_t credentials_size = sizeof(credentials);
+  if(getsockopt(session->file_descriptor, SOL_SOCKET, SO_PEERCRED, &credentials, &credentials_size) < 0)
+  {
+    ERROR(session, "getsockopt(SO_PEERCRED) failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  if(pid)
+  {
+    *pid = credentials.pid;
+  }
+  if(uid)
+  {
+    *uid = credentials.uid;
+  }
+  if(gid)
+  {
+    *gid = credentials.gid;
+  }
+
+  return true;
+}
+
 
 
 //==============================================================================
@@ -252,7 +592,7 @@ jcon_socket_t *jcon_socketUnix_simple_init(const char *filepath, jlog_t *logger)
 
 //------------------------------------------------------------------------------
 //
-jcon_socket_t *jcon_socketUnix_clone(int fd, struct sockaddr_un socket_address, jlog_t *logger)
+jcon_socket_t *jcon_socketUnix_clone(int fd, struct sockaddr_un socket_address, int type, jlog_t *logger)
 {
   if(fd <= 0)
   {
@@ -260,7 +600,7 @@ jcon_socket_t *jcon_socketUnix_clone(int fd, struct sockaddr_un socket_address,
     return NULL;
   }
 
-  jcon_socket_t *session = (jcon_socket_t *)malloc(sizeof(jcon_socket_t));
+  jcon_socket_t *session = (jcon_socket_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socket_t));
   if(session == NULL)
   {
     ERROR(NULL, "malloc() failed.");
@@ -271,30 +611,30 @@ jcon_socket_t *jcon_socketUnix_clone(int fd, struct sockaddr_un socket_address,
   session->function_bind = NULL; /* Cloned sessions cannot bind. */
   session->function_close = NULL;
   session->function_accept = NULL; /* Cloned sessions cannot bind and therefore not accept. */
+  session->function_setCork = NULL; /* Unix sockets do not split into segments. */
+  session->function_recv = NULL;
+  session->function_send = NULL;
+  session->function_poll = NULL;
+  session->function_getFileDescriptor = NULL;
+  session->function_formatReferenceString = &jcon_socketUnix_formatEmptyReferenceString;
   session->session_free_handler = &jcon_socketUnix_free;
+  session->referenceString_state = 0;
 
   session->file_descriptor = fd;
   session->logger = logger;
+  session->socket_type = JCON_SOCKETUNIX_CONNECTIONTYPE;
   session->connection_type = JCON_SOCKET_CONNECTIONTYPE_CLIENT;
 
-  jcon_socketUnix_ctx_t *ctx = (jcon_socketUnix_ctx_t *)malloc(sizeof(jcon_socketUnix_ctx_t));
+  jcon_socketUnix_ctx_t *ctx = (jcon_socketUnix_ctx_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socketUnix_ctx_t));
   if(ctx == NULL)
   {
     ERROR(NULL, "malloc() failed. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
   ctx->socket_address = socket_address;
-  session->referenceString = jcon_socketUnix_createEmptyReferenceString();
-  if(session->referenceString == NULL)
-  {
-    ERROR(NULL, "<Unix> json_socketUnix_createReferenceString() failed. Destroying context and session.");
-    free(session);
-    free(ctx);
-    return NULL;
-  }
-
+  ctx->type = type;
   session->session_ctx = ctx;
 
   return session;
@@ -312,7 +652,7 @@ void jcon_socketUnix_free(jcon_socket_t *session)
 
   if(session->session_ctx)
   {
-    free(session->session_ctx);
+    JUTIL_ALLOC_FREE(session->session_ctx);
   }
 }
 
@@ -332,14 +672,16 @@ int jcon_socketUnix_connect(jcon_socket_t *session)
     return true;
   }
 
-  int fd = socket(AF_LOCAL, SOCK_STREAM, 0);
+  jcon_socketUnix_ctx_t *ctx = (jcon_socketUnix_ctx_t *)session->session_ctx;
+
+  int fd = socket(AF_LOCAL, ctx->type, 0);
   if(fd < 0)
   {
     ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
-  struct sockaddr_un addr = ((jcon_socketUnix_ctx_t *)session->session_ctx)->socket_address;
+  struct sockaddr_un addr = ctx->socket_address;
 
   if(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
   {
@@ -372,18 +714,27 @@ int jcon_socketUnix_bind(jcon_socket_t *session)
     return true;
   }
 
-  int fd = socket(AF_LOCAL, SOCK_STREAM, 0);
+  jcon_socketUnix_ctx_t *ctx = (jcon_socketUnix_ctx_t *)session->session_ctx;
+
+  /* Listener never blocks, so accepting can stop at EAGAIN.
+     Datagram sockets recieve on this socket, so they block. */
+  int flags = SOCK_CLOEXEC | (ctx->type == SOCK_DGRAM ? 0 : SOCK_NONBLOCK);
+  int fd = socket(AF_LOCAL, ctx->type | flags, 0);
   if(fd < 0)
   {
     ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
-  struct sockaddr_un addr = ((jcon_socketUnix_ctx_t *)session->session_ctx)->socket_address;
+  struct sockaddr_un addr = ctx->socket_address;
 
-  if(unlink(addr.sun_path) < 0)
+  if(unlink(addr.sun_path) < 0 && errno != ENOENT)
   {
-    ERROR(session, "unlink() failed [%d : %s].", errno, strerror(errno));
+    ERROR(session, "unlink() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
     return false;
   }
 
@@ -397,7 +748,14 @@ int jcon_socketUnix_bind(jcon_socket_t *session)
     return false;
   }
 
-  if(listen(fd, 5) < 0)
+  if(ctx->type == SOCK_DGRAM)
+  {
+    session->file_descriptor = fd;
+    session->connection_type = JCON_SOCKET_CONNECTIONTYPE_CLIENT;
+    return true;
+  }
+
+  if(listen(fd, SOMAXCONN) < 0)
   {
     ERROR(session, "listen() failed [%d : %s]. Closing socket.", errno, strerror(errno));
     if(close(fd) < 0)
@@ -426,14 +784,20 @@ jcon_socket_t *jcon_socketUnix_accept(jcon_socket_t *session)
   struct sockaddr_un new_addr;
   socklen_t addrlen = sizeof(struct sockaddr_un);
 
-  new_fd = accept(session->file_descriptor, (struct sockaddr *)&new_addr, &addrlen);
+  new_fd = accept4(session->file_descriptor, (struct sockaddr *)&new_addr, &addrlen, SOCK_CLOEXEC);
   if(new_fd < 0)
   {
-    ERROR(session, "accept() failed [%d : %s].", errno, strerror(errno));
+    if(errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      DEBUG(session, "No pending connection.");
+      errno = EAGAIN; /* Callers tell an empty backlog from errors by errno. */
+      return NULL;
+    }
+    ERROR(session, "accept4() failed [%d : %s].", errno, strerror(errno));
     return NULL;
   }
 
-  jcon_socket_t *new_con = jcon_socketUnix_clone(new_fd, new_addr, session->logger);
+  jcon_socket_t *new_con = jcon_socketUnix_clone(new_fd, new_addr, ((jcon_socketUnix_ctx_t *)session->session_ctx)->type, session->logger);
   if(new_con == NULL)
   {
     ERROR(session, "jcon_socketUnix_clone() failed with new connection [Unix:%s].", jcon_socketUnix_getFile(new_addr));
@@ -460,66 +824,71 @@ char *jcon_socketUnix_getFile(struct sockaddr_un socket_address)
 
 //------------------------------------------------------------------------------
 //
-char *jcon_socketUnix_createReferenceString(struct sockaddr_un socket_address)
+int jcon_socketUnix_formatReferenceString(jcon_socket_t *session, char *buf, size_t size)
 {
-  char buf[128] = { 0 };
-  char *file;
-  
-  file = jcon_socketUnix_getFile(socket_address);
-  if(file == NULL)
+  if(session->session_ctx == NULL)
   {
-    ERROR(NULL, "jcon_client_tcp_getFile() failed.");
-    return NULL;
+    return false;
   }
 
-  if(sprintf(buf, "UNIX:%s", file) < 0)
+  const char *file = ((jcon_socketUnix_ctx_t *)session->session_ctx)->socket_address.sun_path;
+
+  if(snprintf(buf, size, "UNIX:%s", file) < 0)
   {
-    ERROR(NULL, "sprintf() failed.");
-    return NULL;
+    ERROR(NULL, "snprintf() failed.");
+    return false;
   }
 
-  size_t size_refString = sizeof(char) * (strlen(buf) + 1);
-  char *ret = (char *)malloc(size_refString);
-  if(ret == NULL)
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUnix_formatEmptyReferenceString(jcon_socket_t *session, char *buf, size_t size)
+{
+  if(snprintf(buf, size, "UNIX:-") < 0)
   {
-    ERROR(NULL, "<UNIX:%s> malloc() failed.", file);
-    return NULL;
+    ERROR(NULL, "snprintf() failed.");
+    return false;
   }
 
-  /* Changed implementation from using strcpy, to using memcpy;
-     to calm down devskim checks. */
-  memset(ret, 0, size_refString);
-  memcpy(ret, buf, size_refString);
-
-  return ret;
+  return true;
 }
 
 //------------------------------------------------------------------------------
 //
-char *jcon_socketUnix_createEmptyReferenceString()
+int jcon_socketUnix_checkConnection(jcon_socket_t *session)
 {
-  const char *buf = "UNIX:-";
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
 
-  size_t size_refString = sizeof(char) * (strlen(buf) + 1);
-  char *ret = (char *)malloc(size_refString);
-  if(ret == NULL)
+  if(session->socket_type == NULL || strcmp(session->socket_type, JCON_SOCKETUNIX_CONNECTIONTYPE) != 0)
   {
-    ERROR(NULL, "<UNIX> malloc() failed.");
-    return NULL;
+    ERROR(session, "Session is not of type UNIX.");
+    return false;
   }
 
-  /* Changed implementation from using strcpy, to using memcpy;
-     to calm down devskim checks. */
-  memset(ret, 0, size_refString);
-  memcpy(ret, buf, size_refString);
+  if(session->connection_type != JCON_SOCKET_CONNECTIONTYPE_CLIENT || jcon_socket_isConnected(session) == false)
+  {
+    ERROR(session, "Session is not connected.");
+    return false;
+  }
 
-  return ret;
+  return true;
 }
 
 //------------------------------------------------------------------------------
 //
 void jcon_socketUnix_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
@@ -0,0 +1,1548 @@
+/**
+ * @file jcon_socketUring.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementations for jcon_socketUring.
+ * 
+ * No liburing is used. Rings are set up with the raw system
+ * calls and mapped into memory, heads and tails are accessed
+ * with atomic builtins.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for syscall() */
+
+#include <jayc/jcon_socketUring.h>
+#include <jayc/jcon_socket_dev.h>
+#include <jayc/jutil_alloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/io_uring.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_socketUring");
+
+
+
+//==============================================================================
+// Define constants and structures.
+//
+
+#define JCON_SOCKETURING_CONNECTIONTYPE "TCP_URING"
+
+/**
+ * @brief Submission entries of accept and recieve rings.
+ */
+#define JCON_SOCKETURING_RING_ENTRIES 16
+
+/**
+ * @brief Submission entries of send rings.
+ * 
+ * Sends are done one at a time.
+ */
+#define JCON_SOCKETURING_SENDRING_ENTRIES 2
+
+/**
+ * @brief Number of provided recieve buffers per connection.
+ * 
+ * Has to be a power of 2.
+ */
+#define JCON_SOCKETURING_BUFFER_NUMBER 16
+
+/**
+ * @brief Size of one provided recieve buffer in bytes.
+ */
+#define JCON_SOCKETURING_BUFFER_SIZE 4096
+
+/**
+ * @brief Buffer group of provided buffers.
+ * 
+ * Every connection has its own rings, so group can always be the same.
+ */
+#define JCON_SOCKETURING_BUFFER_GROUP 0
+
+/**
+ * @brief Time to wait for cancelled requests on close in milliseconds.
+ */
+#define JCON_SOCKETURING_CANCEL_TIMEOUT 1000
+
+#define JCON_SOCKETURING_TAG_ACCEPT 1 /**< @c user_data of multishot accept. */
+#define JCON_SOCKETURING_TAG_RECV 2   /**< @c user_data of multishot recieve. */
+#define JCON_SOCKETURING_TAG_SEND 3   /**< @c user_data of send. */
+#define JCON_SOCKETURING_TAG_CANCEL 4 /**< @c user_data of cancel request. */
+
+/**
+ * @brief Mapped io_uring instance.
+ */
+typedef struct __jcon_socketUring_ring
+{
+  int file_descriptor;          /**< Descriptor of ring, @c -1 if not set up. */
+
+  unsigned *sq_head;            /**< Head of submission queue (written by kernel). */
+  unsigned *sq_tail;            /**< Tail of submission queue. */
+  unsigned *sq_mask;            /**< Index mask of submission queue. */
+  unsigned *sq_array;           /**< Indices of submission entries. */
+  struct io_uring_sqe *sqes;    /**< Submission entries. */
+
+  unsigned *cq_head;            /**< Head of completion queue. */
+  unsigned *cq_tail;            /**< Tail of completion queue (written by kernel). */
+  unsigned *cq_mask;            /**< Index mask of completion queue. */
+  struct io_uring_cqe *cqes;    /**< Completion entries. */
+
+  void *sq_map;                 /**< Mapping of submission ring. */
+  size_t sq_map_size;           /**< Size of submission ring mapping. */
+  void *cq_map;                 /**< Mapping of completion ring, same as sq_map with single mmap. */
+  size_t cq_map_size;           /**< Size of completion ring mapping. */
+  size_t sqes_size;             /**< Size of submission entry mapping. */
+} jcon_socketUring_ring_t;
+
+/**
+ * @brief Session context for io_uring sockets.
+ */
+typedef struct __jcon_socketUring_context
+{
+  struct sockaddr_in socket_address;    /**< Address struct. */
+
+  jcon_socketUring_ring_t ring;         /**< Ring for accept or recieve. Used by reading thread only. */
+  jcon_socketUring_ring_t send_ring;    /**< Ring for sends. */
+  pthread_mutex_t send_mutex;           /**< Guards send_ring. */
+
+  struct io_uring_buf_ring *buffer_ring;  /**< Registered ring of provided buffers. */
+  size_t buffer_ring_size;              /**< Size of buffer ring mapping. */
+  char *buffers;                        /**< Memory of provided buffers. */
+  unsigned short buffer_tail;           /**< Local copy of buffer ring tail. */
+
+  size_t completion_offset;             /**< Bytes of head completion, that were already read. */
+  int armed;                            /**< @c true , while multishot request is active. */
+  int listening;                        /**< @c true , if socket accepts connections. */
+} jcon_socketUring_ctx_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Allocates session and context with all handlers.
+ * 
+ * @param socket_address  Address struct.
+ * @param logger          Logger for session.
+ * 
+ * @return                Session object without descriptor.
+ * @return                @c NULL in case of error.
+ */
+static jcon_socket_t *jcon_socketUring_create(struct sockaddr_in socket_address, jlog_t *logger);
+
+/**
+ * @brief Creates session from accepted socket.
+ * 
+ * Sets up rings and arms recieve.
+ * 
+ * @param fd              File descriptor of new socket.
+ * @param socket_address  Address struct of new socket.
+ * @param logger          Logger for new session.
+ * 
+ * @return                Session object for new client connection.
+ * @return                @c NULL in case of error.
+ */
+static jcon_socket_t *jcon_socketUring_clone(int fd, struct sockaddr_in socket_address, jlog_t *logger);
+
+/**
+ * @brief Frees session memory.
+ * 
+ * Called by @c #jcon_socket_free() .
+ * 
+ * @param session Session object to free.
+ */
+static void jcon_socketUring_free(jcon_socket_t *session);
+
+/**
+ * @brief Connect to server.
+ * 
+ * Called by @c #jcon_socket_connect() .
+ * 
+ * @param session Session to connect.
+ * 
+ * @return        @c true , if connection was established.
+ * @return        @c false , if connection failed.
+ */
+static int jcon_socketUring_connect(jcon_socket_t *session);
+
+/**
+ * @brief Binds socket to address and arms multishot accept.
+ * 
+ * Called by @c #jcon_socket_bind() .
+ * 
+ * @param session Session to bind.
+ * 
+ * @return        @c true , if socket was bound to address.
+ * @return        @c false , if binding failed.
+ */
+static int jcon_socketUring_bind(jcon_socket_t *session);
+
+/**
+ * @brief Cancels requests and tears down rings.
+ * 
+ * Called by @c #jcon_socket_close() , before the
+ * socket descriptor is closed.
+ * 
+ * @param session Session to clean up.
+ */
+static void jcon_socketUring_close(jcon_socket_t *session);
+
+/**
+ * @brief Takes accepted connection from completion queue.
+ * 
+ * Called by @c #jcon_socket_accept() . Does not block.
+ * 
+ * @param session Server session, to accept connection.
+ * 
+ * @return        Session object of client connection.
+ * @return        @c NULL , if no new connection was available
+ *                ( @c errno is @c EAGAIN ) or error occured.
+ */
+static jcon_socket_t *jcon_socketUring_accept(jcon_socket_t *session);
+
+/**
+ * @brief Sets @c TCP_CORK option of socket.
+ * 
+ * Called by @c #jcon_socket_setCork() .
+ * 
+ * @param session Session to configure.
+ * @param enable  Value of option.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUring_setCork(jcon_socket_t *session, int enable);
+
+/**
+ * @brief Copies recieved data out of provided buffers.
+ * 
+ * Called by @c #jcon_socket_recvData() and @c #jcon_socket_recvDataV() .
+ * Blocks, if no data was recieved yet. Buffers are given back
+ * to the kernel, once they are read completely.
+ * 
+ * @param session   Session to read from.
+ * @param iov       Array of buffers to fill.
+ * @param iov_count Number of buffers in iov.
+ * 
+ * @return          Number of bytes read.
+ * @return          @c 0 , if peer closed the connection.
+ * @return          @c -1 , if error occured ( @c errno is set).
+ */
+static ssize_t jcon_socketUring_recv(jcon_socket_t *session, const struct iovec *iov, int iov_count);
+
+/**
+ * @brief Sends data with @c IORING_OP_SENDMSG .
+ * 
+ * Called by send functions of jcon_socket.
+ * Waits for completion of the request.
+ * 
+ * @param session   Session to send through.
+ * @param iov       Array of buffers to send.
+ * @param iov_count Number of buffers in iov.
+ * @param flags     Flags for @c sendmsg() .
+ * 
+ * @return          Number of bytes sent.
+ * @return          @c -1 , if error occured ( @c errno is set).
+ */
+static ssize_t jcon_socketUring_send(jcon_socket_t *session, const struct iovec *iov, int iov_count, int flags);
+
+/**
+ * @brief Waits for completions on recieve or accept ring.
+ * 
+ * Called by @c #jcon_socket_pollForInput() .
+ * 
+ * @param session Session to wait on.
+ * @param timeout Time to wait in milliseconds.
+ * 
+ * @return        @c true , if input is available.
+ * @return        @c false , if timed out or error occured.
+ */
+static int jcon_socketUring_poll(jcon_socket_t *session, int timeout);
+
+/**
+ * @brief Returns descriptor of recieve or accept ring.
+ * 
+ * Called by @c #jcon_socket_getFileDescriptor() .
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Descriptor of ring.
+ */
+static int jcon_socketUring_getFileDescriptor(jcon_socket_t *session);
+
+/**
+ * @brief Sets up ring and maps queues.
+ * 
+ * @param session Session for log messages.
+ * @param ring    Ring to set up.
+ * @param entries Number of submission entries.
+ * 
+ * @return        @c true , if ring was set up.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUring_ring_init(jcon_socket_t *session, jcon_socketUring_ring_t *ring, unsigned entries);
+
+/**
+ * @brief Unmaps queues and closes ring.
+ * 
+ * @param ring  Ring to tear down.
+ */
+static void jcon_socketUring_ring_free(jcon_socketUring_ring_t *ring);
+
+/**
+ * @brief Gets next free submission entry.
+ * 
+ * Entry is cleared. It gets visible to the kernel with
+ * @c #jcon_socketUring_ring_submit() .
+ * 
+ * @param ring  Ring to get entry from.
+ * 
+ * @return      Submission entry.
+ * @return      @c NULL , if submission queue is full.
+ */
+static struct io_uring_sqe *jcon_socketUring_ring_getSqe(jcon_socketUring_ring_t *ring);
+
+/**
+ * @brief Submits entries and waits for completions.
+ * 
+ * @param ring          Ring to enter.
+ * @param to_submit     Number of entries to submit.
+ * @param min_complete  Number of completions to wait for.
+ * 
+ * @return              @c true , if successful.
+ * @return              @c false , if error occured ( @c errno is set).
+ */
+static int jcon_socketUring_ring_submit(jcon_socketUring_ring_t *ring, unsigned to_submit, unsigned min_complete);
+
+/**
+ * @brief Returns head of completion queue, without removing it.
+ * 
+ * @param ring  Ring to check.
+ * 
+ * @return      Completion entry.
+ * @return      @c NULL , if completion queue is empty.
+ */
+static struct io_uring_cqe *jcon_socketUring_ring_peek(jcon_socketUring_ring_t *ring);
+
+/**
+ * @brief Removes head of completion queue.
+ * 
+ * @param ring  Ring to advance.
+ */
+static void jcon_socketUring_ring_advance(jcon_socketUring_ring_t *ring);
+
+/**
+ * @brief Registers buffer ring and provides all buffers.
+ * 
+ * @param session Session to set up buffers for.
+ * 
+ * @return        @c true , if buffers were registered.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUring_buffers_init(jcon_socket_t *session);
+
+/**
+ * @brief Frees provided buffers.
+ * 
+ * Ring has to be closed or the buffers not in use anymore.
+ * 
+ * @param ctx Context of session.
+ */
+static void jcon_socketUring_buffers_free(jcon_socketUring_ctx_t *ctx);
+
+/**
+ * @brief Gives buffer back to the kernel.
+ * 
+ * @param ctx         Context of session.
+ * @param buffer_id   ID of buffer.
+ */
+static void jcon_socketUring_buffers_recycle(jcon_socketUring_ctx_t *ctx, unsigned short buffer_id);
+
+/**
+ * @brief Submits multishot accept or recieve.
+ * 
+ * @param session Session to arm.
+ * 
+ * @return        @c true , if request was submitted.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUring_arm(jcon_socket_t *session);
+
+/**
+ * @brief Returns next completion with data.
+ * 
+ * Completions without data (cancel results, recieves
+ * without free buffer) are removed. Multishot request
+ * is rearmed, if it was terminated by missing buffers.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Completion entry.
+ * @return        @c NULL , if no completion is available.
+ */
+static struct io_uring_cqe *jcon_socketUring_nextCompletion(jcon_socket_t *session);
+
+/**
+ * @brief Sets up rings and buffers of connected socket and arms recieve.
+ * 
+ * @param session Session with connected socket descriptor.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUring_setupClient(jcon_socket_t *session);
+
+/**
+ * @brief Formats reference string from socket address.
+ * 
+ * Same format as jcon_socketTCP, so sessions can be
+ * found by the same reference.
+ * 
+ * @param session Session object.
+ * @param buf     Buffer to write reference string to.
+ * @param size    Size of @c buf .
+ * 
+ * @return        @c true , if reference string was formatted.
+ * @return        @c false , if error occured.
+ */
+static int jcon_socketUring_formatReferenceString(jcon_socket_t *session, char *buf, size_t size);
+
+/**
+ * @brief Sends log messages to logger with session data.
+ * 
+ * Uses logger. If available adds reference string to log messages.
+ * 
+ * @param session   Session object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jcon_socketUring_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JCON_NO_DEBUG /* Allow to turn of debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_socketUring_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_socketUring_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_socketUring_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_socketUring_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_socketUring_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jcon_socketUring_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface funcions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUring_simple_init(const char *address, uint16_t port, jlog_t *logger)
+{
+  struct sockaddr_in socket_address;
+  memset(&socket_address, 0, sizeof(socket_address));
+  socket_address.sin_family = AF_INET;
+  socket_address.sin_port = htons(port);
+
+  struct hostent *hostinfo;
+  hostinfo = gethostbyname(address);
+  if(hostinfo == NULL)
+  {
+    ERROR(NULL, "<TCP:%s:%u> gethostbyname() failed.", address, port);
+    return NULL;
+  }
+  socket_address.sin_addr = *(struct in_addr *)hostinfo->h_addr_list[0];
+
+  jcon_socket_t *session = jcon_socketUring_create(socket_address, logger);
+  if(session == NULL)
+  {
+    ERROR(NULL, "<TCP:%s:%u> jcon_socketUring_create() failed.", address, port);
+    return NULL;
+  }
+
+  session->connection_type = 0;
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_isSupported(void)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  int fd = (int)syscall(__NR_io_uring_setup, 1, &params);
+  if(fd < 0)
+  {
+    return false;
+  }
+
+  /* Registering a buffer ring fails on kernels without
+     provided buffer rings and multishot recieve. */
+  int ret = false;
+  size_t size = sizeof(struct io_uring_buf);
+  void *buffer_ring = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(buffer_ring != MAP_FAILED)
+  {
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (unsigned long)buffer_ring;
+    reg.ring_entries = 1;
+    reg.bgid = JCON_SOCKETURING_BUFFER_GROUP;
+
+    ret = (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0);
+    munmap(buffer_ring, size);
+  }
+
+  close(fd);
+  return ret;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUring_create(struct sockaddr_in socket_address, jlog_t *logger)
+{
+  jcon_socket_t *session = (jcon_socket_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socket_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->function_connect = &jcon_socketUring_connect;
+  session->function_bind = &jcon_socketUring_bind;
+  session->function_close = &jcon_socketUring_close;
+  session->function_accept = &jcon_socketUring_accept;
+  session->function_setCork = &jcon_socketUring_setCork;
+  session->function_recv = &jcon_socketUring_recv;
+  session->function_send = &jcon_socketUring_send;
+  session->function_poll = &jcon_socketUring_poll;
+  session->function_getFileDescriptor = &jcon_socketUring_getFileDescriptor;
+  session->function_formatReferenceString = &jcon_socketUring_formatReferenceString;
+  session->session_free_handler = &jcon_socketUring_free;
+  session->referenceString_state = 0;
+
+  session->file_descriptor = 0;
+  session->logger = logger;
+  session->socket_type = JCON_SOCKETURING_CONNECTIONTYPE;
+  session->connection_type = 0;
+
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_socketUring_ctx_t));
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "malloc() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  memset(ctx, 0, sizeof(jcon_socketUring_ctx_t));
+  ctx->socket_address = socket_address;
+  ctx->ring.file_descriptor = -1;
+  ctx->send_ring.file_descriptor = -1;
+
+  if(pthread_mutex_init(&ctx->send_mutex, NULL) != 0)
+  {
+    ERROR(NULL, "pthread_mutex_init() failed. Destroying context and session.");
+    JUTIL_ALLOC_FREE(ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->session_ctx = (void *)ctx;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUring_clone(int fd, struct sockaddr_in socket_address, jlog_t *logger)
+{
+  if(fd <= 0)
+  {
+    ERROR(NULL, "Invalid file descriptor [%d].", fd);
+    return NULL;
+  }
+
+  jcon_socket_t *session = jcon_socketUring_create(socket_address, logger);
+  if(session == NULL)
+  {
+    ERROR(NULL, "jcon_socketUring_create() failed.");
+    return NULL;
+  }
+
+  session->function_connect = NULL; /* Cloned sessions cannot reconnect. */
+  session->function_bind = NULL; /* Cloned sessions cannot bind. */
+  session->function_accept = NULL; /* Cloned sessions cannot bind and therefore not accept. */
+  session->file_descriptor = fd;
+
+  if(jcon_socketUring_setupClient(session) == false)
+  {
+    ERROR(session, "jcon_socketUring_setupClient() failed. Destroying session.");
+    session->file_descriptor = 0; /* Descriptor is closed by caller. */
+    jcon_socket_free(session);
+    return NULL;
+  }
+
+  session->connection_type = JCON_SOCKET_CONNECTIONTYPE_CLIENT;
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_free(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+  if(ctx)
+  {
+    /* Rings exist, if setup succeeded, but session never got connected. */
+    jcon_socketUring_close(session);
+    pthread_mutex_destroy(&ctx->send_mutex);
+    JUTIL_ALLOC_FREE(ctx);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_connect(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_socket_isConnected(session))
+  {
+    DEBUG(session, "Session is already connected.");
+    return true;
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(fd < 0)
+  {
+    ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+  struct sockaddr_in addr = ctx->socket_address;
+
+  if(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    ERROR(session, "connect() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return false;
+  }
+
+  session->file_descriptor = fd;
+
+  if(jcon_socketUring_setupClient(session) == false)
+  {
+    ERROR(session, "jcon_socketUring_setupClient() failed. Closing socket.");
+    jcon_socketUring_close(session);
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    session->file_descriptor = 0;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_bind(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_socket_isConnected(session))
+  {
+    DEBUG(session, "Session is already connected.");
+    return true;
+  }
+
+  /* Listener stays blocking. io_uring fails requests on non-blocking
+     sockets with -EAGAIN instead of waiting for them. */
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(fd < 0)
+  {
+    ERROR(session, "socket() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+  struct sockaddr_in addr = ctx->socket_address;
+
+  if(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    ERROR(session, "bind() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return false;
+  }
+
+  if(listen(fd, SOMAXCONN) < 0)
+  {
+    ERROR(session, "listen() failed [%d : %s]. Closing socket.", errno, strerror(errno));
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    return false;
+  }
+
+  session->file_descriptor = fd;
+  ctx->listening = true;
+  ctx->completion_offset = 0;
+
+  if(jcon_socketUring_ring_init(session, &ctx->ring, JCON_SOCKETURING_RING_ENTRIES) == false
+    || jcon_socketUring_arm(session) == false)
+  {
+    ERROR(session, "Setting up accept ring failed. Closing socket.");
+    jcon_socketUring_close(session);
+    if(close(fd) < 0)
+    {
+      ERROR(session, "close() failed [%d : %s].", errno, strerror(errno));
+    }
+    session->file_descriptor = 0;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_close(jcon_socket_t *session)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  if(ctx->armed && ctx->ring.file_descriptor >= 0)
+  {
+    /* Kernel writes into provided buffers, until the multishot
+       request is finished. So wait for its last completion,
+       before buffers are freed. */
+    struct io_uring_sqe *sqe = jcon_socketUring_ring_getSqe(&ctx->ring);
+    if(sqe)
+    {
+      sqe->opcode = IORING_OP_ASYNC_CANCEL;
+      sqe->addr = (ctx->listening ? JCON_SOCKETURING_TAG_ACCEPT : JCON_SOCKETURING_TAG_RECV);
+      sqe->user_data = JCON_SOCKETURING_TAG_CANCEL;
+      if(jcon_socketUring_ring_submit(&ctx->ring, 1, 0) == false)
+      {
+        ERROR(session, "io_uring_enter() failed [%d : %s].", errno, strerror(errno));
+      }
+    }
+
+    while(ctx->armed)
+    {
+      struct io_uring_cqe *cqe = jcon_socketUring_ring_peek(&ctx->ring);
+      if(cqe == NULL)
+      {
+        struct pollfd poll_fd;
+        poll_fd.fd = ctx->ring.file_descriptor;
+        poll_fd.events = POLLIN;
+        poll_fd.revents = 0;
+
+        int ret_poll = poll(&poll_fd, 1, JCON_SOCKETURING_CANCEL_TIMEOUT);
+        if(ret_poll < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if(ret_poll <= 0)
+        {
+          WARN(session, "Cancelled request did not finish.");
+          break;
+        }
+        continue;
+      }
+
+      if(cqe->user_data != JCON_SOCKETURING_TAG_CANCEL && (cqe->flags & IORING_CQE_F_MORE) == 0)
+      {
+        ctx->armed = false;
+      }
+      if(ctx->listening && cqe->user_data == JCON_SOCKETURING_TAG_ACCEPT && cqe->res >= 0)
+      {
+        close(cqe->res);
+      }
+      jcon_socketUring_ring_advance(&ctx->ring);
+    }
+  }
+
+  jcon_socketUring_ring_free(&ctx->ring);
+  jcon_socketUring_ring_free(&ctx->send_ring);
+  jcon_socketUring_buffers_free(ctx);
+  ctx->armed = false;
+  ctx->listening = false;
+  ctx->completion_offset = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_socket_t *jcon_socketUring_accept(jcon_socket_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  struct io_uring_cqe *cqe = jcon_socketUring_nextCompletion(session);
+  if(cqe == NULL)
+  {
+    DEBUG(session, "No pending connection.");
+    errno = EAGAIN; /* Callers tell an empty backlog from errors by errno. */
+    return NULL;
+  }
+
+  int new_fd = cqe->res;
+  int more = (cqe->flags & IORING_CQE_F_MORE);
+  jcon_socketUring_ring_advance(&((jcon_socketUring_ctx_t *)session->session_ctx)->ring);
+
+  if(!more)
+  {
+    ((jcon_socketUring_ctx_t *)session->session_ctx)->armed = false;
+    if(jcon_socketUring_arm(session) == false)
+    {
+      ERROR(session, "jcon_socketUring_arm() failed.");
+    }
+  }
+
+  if(new_fd < 0)
+  {
+    errno = -new_fd;
+    ERROR(session, "accept failed [%d : %s].", errno, strerror(errno));
+    return NULL;
+  }
+
+  struct sockaddr_in new_addr;
+  socklen_t addrlen = sizeof(struct sockaddr_in);
+  if(getpeername(new_fd, (struct sockaddr *)&new_addr, &addrlen) < 0)
+  {
+    ERROR(session, "getpeername() failed [%d : %s].", errno, strerror(errno));
+    close(new_fd);
+    return NULL;
+  }
+
+  jcon_socket_t *new_con = jcon_socketUring_clone(new_fd, new_addr, session->logger);
+  if(new_con == NULL)
+  {
+    ERROR(session, "jcon_socketUring_clone() failed with new connection [TCP:%s:%u].", inet_ntoa(new_addr.sin_addr), ntohs(new_addr.sin_port));
+    close(new_fd);
+    return NULL;
+  }
+
+  return new_con;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_setCork(jcon_socket_t *session, int enable)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  int value = (enable ? 1 : 0);
+  if(setsockopt(session->file_descriptor, IPPROTO_TCP, TCP_CORK, &value, sizeof(value)) < 0)
+  {
+    ERROR(session, "setsockopt(TCP_CORK) failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+ssize_t jcon_socketUring_recv(jcon_socket_t *session, const struct iovec *iov, int iov_count)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  struct io_uring_cqe *cqe;
+  while((cqe = jcon_socketUring_nextCompletion(session)) == NULL)
+  {
+    if(ctx->armed == false)
+    {
+      errno = ENOTCONN;
+      return -1;
+    }
+
+    if(jcon_socketUring_ring_submit(&ctx->ring, 0, 1) == false)
+    {
+      return -1;
+    }
+  }
+
+  int more = (cqe->flags & IORING_CQE_F_MORE);
+
+  if(cqe->res <= 0)
+  {
+    int res = cqe->res;
+    jcon_socketUring_ring_advance(&ctx->ring);
+    if(!more)
+    {
+      ctx->armed = false;
+    }
+
+    if(res == 0)
+    {
+      return 0;
+    }
+    errno = -res;
+    return -1;
+  }
+
+  /* Completion stays at head, until its buffer is read completely.
+     That keeps the ring descriptor readable for level triggered
+     event loops. */
+  unsigned short buffer_id = (unsigned short)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+  size_t available = (size_t)cqe->res - ctx->completion_offset;
+  const char *data = ctx->buffers + ((size_t)buffer_id * JCON_SOCKETURING_BUFFER_SIZE) + ctx->completion_offset;
+
+  size_t copied = 0;
+  for(int i = 0; i < iov_count && available > 0; i++)
+  {
+    size_t n = iov[i].iov_len;
+    if(n > available)
+    {
+      n = available;
+    }
+    memcpy(iov[i].iov_base, data + copied, n);
+    copied += n;
+    available -= n;
+  }
+
+  ctx->completion_offset += copied;
+  if(available == 0)
+  {
+    ctx->completion_offset = 0;
+    jcon_socketUring_buffers_recycle(ctx, buffer_id);
+    jcon_socketUring_ring_advance(&ctx->ring);
+
+    if(!more)
+    {
+      ctx->armed = false;
+      if(jcon_socketUring_arm(session) == false)
+      {
+        ERROR(session, "jcon_socketUring_arm() failed.");
+      }
+    }
+  }
+
+  return (ssize_t)copied;
+}
+
+//------------------------------------------------------------------------------
+//
+ssize_t jcon_socketUring_send(jcon_socket_t *session, const struct iovec *iov, int iov_count, int flags)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = (struct iovec *)iov;
+  msg.msg_iovlen = iov_count;
+
+  pthread_mutex_lock(&ctx->send_mutex);
+
+  if(ctx->send_ring.file_descriptor < 0)
+  {
+    pthread_mutex_unlock(&ctx->send_mutex);
+    errno = ENOTCONN;
+    return -1;
+  }
+
+  struct io_uring_sqe *sqe = jcon_socketUring_ring_getSqe(&ctx->send_ring);
+  if(sqe == NULL)
+  {
+    pthread_mutex_unlock(&ctx->send_mutex);
+    errno = EBUSY;
+    return -1;
+  }
+
+  /* MSG_DONTWAIT is passed through, so the request
+     fails with -EAGAIN instead of waiting. */
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = session->file_descriptor;
+  sqe->addr = (unsigned long)&msg;
+  sqe->len = 1;
+  sqe->msg_flags = (unsigned)flags;
+  sqe->user_data = JCON_SOCKETURING_TAG_SEND;
+
+  struct io_uring_cqe *cqe;
+  int submit = 1;
+  while((cqe = jcon_socketUring_ring_peek(&ctx->send_ring)) == NULL)
+  {
+    if(jcon_socketUring_ring_submit(&ctx->send_ring, submit, 1) == false)
+    {
+      int error = errno;
+      pthread_mutex_unlock(&ctx->send_mutex);
+      errno = error;
+      return -1;
+    }
+    submit = 0;
+  }
+
+  int res = cqe->res;
+  jcon_socketUring_ring_advance(&ctx->send_ring);
+  pthread_mutex_unlock(&ctx->send_mutex);
+
+  if(res < 0)
+  {
+    errno = -res;
+    return -1;
+  }
+
+  return res;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_poll(jcon_socket_t *session, int timeout)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  while(true)
+  {
+    if(jcon_socketUring_nextCompletion(session))
+    {
+      return true;
+    }
+
+    if(ctx->armed == false)
+    {
+      return false;
+    }
+
+    struct pollfd poll_fd;
+    poll_fd.fd = ctx->ring.file_descriptor;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+
+    int ret_poll = poll(&poll_fd, 1, timeout);
+    if(ret_poll < 0)
+    {
+      ERROR(session, "poll() failed [%d : %s].", errno, strerror(errno));
+      return false;
+    }
+
+    if(ret_poll == 0)
+    {
+      return false;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_getFileDescriptor(jcon_socket_t *session)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  if(ctx->ring.file_descriptor < 0)
+  {
+    return session->file_descriptor;
+  }
+
+  return ctx->ring.file_descriptor;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_ring_init(jcon_socket_t *session, jcon_socketUring_ring_t *ring, unsigned entries)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  memset(ring, 0, sizeof(jcon_socketUring_ring_t));
+  ring->file_descriptor = -1;
+
+  int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if(fd < 0)
+  {
+    ERROR(session, "io_uring_setup() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+  ring->file_descriptor = fd;
+
+  ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+  if(params.features & IORING_FEAT_SINGLE_MMAP)
+  {
+    if(ring->cq_map_size > ring->sq_map_size)
+    {
+      ring->sq_map_size = ring->cq_map_size;
+    }
+    ring->cq_map_size = 0;
+  }
+
+  ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if(ring->sq_map == MAP_FAILED)
+  {
+    ERROR(session, "mmap() failed [%d : %s].", errno, strerror(errno));
+    ring->sq_map = NULL;
+    jcon_socketUring_ring_free(ring);
+    return false;
+  }
+
+  if(ring->cq_map_size == 0)
+  {
+    ring->cq_map = ring->sq_map;
+  }
+  else
+  {
+    ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if(ring->cq_map == MAP_FAILED)
+    {
+      ERROR(session, "mmap() failed [%d : %s].", errno, strerror(errno));
+      ring->cq_map = NULL;
+      jcon_socketUring_ring_free(ring);
+      return false;
+    }
+  }
+
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if(ring->sqes == MAP_FAILED)
+  {
+    ERROR(session, "mmap() failed [%d : %s].", errno, strerror(errno));
+    ring->sqes = NULL;
+    jcon_socketUring_ring_free(ring);
+    return false;
+  }
+
+  char *sq = (char *)ring->sq_map;
+  ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+  ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+  ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+
+  char *cq = (char *)ring->cq_map;
+  ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+  ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+  ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_ring_free(jcon_socketUring_ring_t *ring)
+{
+  if(ring->sqes)
+  {
+    munmap(ring->sqes, ring->sqes_size);
+  }
+  if(ring->cq_map && ring->cq_map != ring->sq_map)
+  {
+    munmap(ring->cq_map, ring->cq_map_size);
+  }
+  if(ring->sq_map)
+  {
+    munmap(ring->sq_map, ring->sq_map_size);
+  }
+  if(ring->file_descriptor >= 0)
+  {
+    close(ring->file_descriptor);
+  }
+
+  memset(ring, 0, sizeof(jcon_socketUring_ring_t));
+  ring->file_descriptor = -1;
+}
+
+//------------------------------------------------------------------------------
+//
+struct io_uring_sqe *jcon_socketUring_ring_getSqe(jcon_socketUring_ring_t *ring)
+{
+  unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+  unsigned tail = *ring->sq_tail;
+  unsigned mask = *ring->sq_mask;
+
+  if(tail - head > mask)
+  {
+    return NULL;
+  }
+
+  unsigned index = tail & mask;
+  struct io_uring_sqe *sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+  ring->sq_array[index] = index;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+  return sqe;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_ring_submit(jcon_socketUring_ring_t *ring, unsigned to_submit, unsigned min_complete)
+{
+  unsigned flags = (min_complete > 0 ? IORING_ENTER_GETEVENTS : 0);
+
+  /* Retrying with the same count is safe, the kernel
+     only submits entries, that were not consumed yet. */
+  while(syscall(__NR_io_uring_enter, ring->file_descriptor, to_submit, min_complete, flags, NULL, 0) < 0)
+  {
+    if(errno != EINTR)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+struct io_uring_cqe *jcon_socketUring_ring_peek(jcon_socketUring_ring_t *ring)
+{
+  unsigned head = *ring->cq_head;
+  unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+  if(head == tail)
+  {
+    return NULL;
+  }
+
+  return &ring->cqes[head & *ring->cq_mask];
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_ring_advance(jcon_socketUring_ring_t *ring)
+{
+  __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_buffers_init(jcon_socket_t *session)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  ctx->buffer_ring_size = JCON_SOCKETURING_BUFFER_NUMBER * sizeof(struct io_uring_buf);
+  void *buffer_ring = mmap(NULL, ctx->buffer_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(buffer_ring == MAP_FAILED)
+  {
+    ERROR(session, "mmap() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+  ctx->buffer_ring = (struct io_uring_buf_ring *)buffer_ring;
+
+  ctx->buffers = (char *)JUTIL_ALLOC_MALLOC(JCON_SOCKETURING_BUFFER_NUMBER * JCON_SOCKETURING_BUFFER_SIZE);
+  if(ctx->buffers == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    jcon_socketUring_buffers_free(ctx);
+    return false;
+  }
+
+  struct io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = (unsigned long)ctx->buffer_ring;
+  reg.ring_entries = JCON_SOCKETURING_BUFFER_NUMBER;
+  reg.bgid = JCON_SOCKETURING_BUFFER_GROUP;
+
+  if(syscall(__NR_io_uring_register, ctx->ring.file_descriptor, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+  {
+    ERROR(session, "io_uring_register(IORING_REGISTER_PBUF_RING) failed [%d : %s].", errno, strerror(errno));
+    jcon_socketUring_buffers_free(ctx);
+    return false;
+  }
+
+  ctx->buffer_tail = 0;
+  for(unsigned short i = 0; i < JCON_SOCKETURING_BUFFER_NUMBER; i++)
+  {
+    jcon_socketUring_buffers_recycle(ctx, i);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_buffers_free(jcon_socketUring_ctx_t *ctx)
+{
+  if(ctx->buffer_ring)
+  {
+    munmap(ctx->buffer_ring, ctx->buffer_ring_size);
+    ctx->buffer_ring = NULL;
+  }
+
+  JUTIL_ALLOC_FREE(ctx->buffers);
+  ctx->buffers = NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_buffers_recycle(jcon_socketUring_ctx_t *ctx, unsigned short buffer_id)
+{
+  /* Only address, length and ID are written. The reserved field
+     of the first entry holds the ring tail. */
+  struct io_uring_buf *buf = &ctx->buffer_ring->bufs[ctx->buffer_tail & (JCON_SOCKETURING_BUFFER_NUMBER - 1)];
+  buf->addr = (unsigned long)(ctx->buffers + ((size_t)buffer_id * JCON_SOCKETURING_BUFFER_SIZE));
+  buf->len = JCON_SOCKETURING_BUFFER_SIZE;
+  buf->bid = buffer_id;
+
+  ctx->buffer_tail++;
+  __atomic_store_n(&ctx->buffer_ring->tail, ctx->buffer_tail, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_arm(jcon_socket_t *session)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  struct io_uring_sqe *sqe = jcon_socketUring_ring_getSqe(&ctx->ring);
+  if(sqe == NULL)
+  {
+    ERROR(session, "Submission queue is full.");
+    return false;
+  }
+
+  sqe->fd = session->file_descriptor;
+  if(ctx->listening)
+  {
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = JCON_SOCKETURING_TAG_ACCEPT;
+  }
+  else
+  {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = JCON_SOCKETURING_BUFFER_GROUP;
+    sqe->user_data = JCON_SOCKETURING_TAG_RECV;
+  }
+
+  if(jcon_socketUring_ring_submit(&ctx->ring, 1, 0) == false)
+  {
+    ERROR(session, "io_uring_enter() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  ctx->armed = true;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+struct io_uring_cqe *jcon_socketUring_nextCompletion(jcon_socket_t *session)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  if(ctx->ring.file_descriptor < 0)
+  {
+    return NULL;
+  }
+
+  struct io_uring_cqe *cqe;
+  while((cqe = jcon_socketUring_ring_peek(&ctx->ring)) != NULL)
+  {
+    if(cqe->user_data == JCON_SOCKETURING_TAG_CANCEL)
+    {
+      jcon_socketUring_ring_advance(&ctx->ring);
+      continue;
+    }
+
+    /* Recieve ran out of buffers. All earlier completions
+       were read, so every buffer is free again. */
+    if(!ctx->listening && cqe->res == -ENOBUFS)
+    {
+      int more = (cqe->flags & IORING_CQE_F_MORE);
+      jcon_socketUring_ring_advance(&ctx->ring);
+      if(!more)
+      {
+        ctx->armed = false;
+        if(jcon_socketUring_arm(session) == false)
+        {
+          ERROR(session, "jcon_socketUring_arm() failed.");
+          return NULL;
+        }
+      }
+      continue;
+    }
+
+    return cqe;
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_setupClient(jcon_socket_t *session)
+{
+  jcon_socketUring_ctx_t *ctx = (jcon_socketUring_ctx_t *)session->session_ctx;
+
+  ctx->listening = false;
+  ctx->completion_offset = 0;
+
+  if(jcon_socketUring_ring_init(session, &ctx->ring, JCON_SOCKETURING_RING_ENTRIES) == false)
+  {
+    ERROR(session, "jcon_socketUring_ring_init() failed.");
+    return false;
+  }
+
+  if(jcon_socketUring_ring_init(session, &ctx->send_ring, JCON_SOCKETURING_SENDRING_ENTRIES) == false)
+  {
+    ERROR(session, "jcon_socketUring_ring_init() failed.");
+    jcon_socketUring_ring_free(&ctx->ring);
+    return false;
+  }
+
+  if(jcon_socketUring_buffers_init(session) == false)
+  {
+    ERROR(session, "jcon_socketUring_buffers_init() failed.");
+    jcon_socketUring_ring_free(&ctx->ring);
+    jcon_socketUring_ring_free(&ctx->send_ring);
+    return false;
+  }
+
+  if(jcon_socketUring_arm(session) == false)
+  {
+    ERROR(session, "jcon_socketUring_arm() failed.");
+    jcon_socketUring_ring_free(&ctx->ring);
+    jcon_socketUring_ring_free(&ctx->send_ring);
+    jcon_socketUring_buffers_free(ctx);
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_socketUring_formatReferenceString(jcon_socket_t *session, char *buf, size_t size)
+{
+  if(session->session_ctx == NULL)
+  {
+    return false;
+  }
+
+  struct sockaddr_in *socket_address = &((jcon_socketUring_ctx_t *)session->session_ctx)->socket_address;
+  char ip[INET_ADDRSTRLEN];
+  uint16_t port;
+
+  if(inet_ntop(AF_INET, &socket_address->sin_addr, ip, sizeof(ip)) == NULL)
+  {
+    ERROR(NULL, "inet_ntop() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  port = ntohs(socket_address->sin_port);
+  if(port == 0)
+  {
+    ERROR(NULL, "Port is [0].");
+    return false;
+  }
+
+  if(snprintf(buf, size, "TCP:%s:%u", ip, port) < 0)
+  {
+    ERROR(NULL, "snprintf() failed.");
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_socketUring_log(jcon_socket_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<%s> %s", jcon_socket_getReferenceString(session), buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<%s> %s", jcon_socket_getReferenceString(session), buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}
@@ -9,17 +9,40 @@
  * 
  */
 
+#define _GNU_SOURCE /* needed for pthread_setaffinity_np() */
+
 #include <jayc/jcon_system.h>
 #include <jayc/jcon_server.h>
 #include <jayc/jcon_thread.h>
+#include <jayc/jcon_eventLoop.h>
 #include <jayc/jutil_thread.h>
 #include <jayc/jutil_linkedlist.h>
+#include <jayc/jutil_hash.h>
+#include <jayc/jproc.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <string.h>
 #include <stdarg.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+#include <time.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_system");
+
+
 
 //==============================================================================
 // Define constants.
@@ -27,6 +50,89 @@
 
 #define JCON_SYSTEM_LOOPSLEEP_DEFAULT 100000000
 
+/**
+ * @brief Each connection is handled by its own jcon_thread.
+ */
+#define JCON_SYSTEM_MODE_THREADED 0
+
+/**
+ * @brief Connections are multiplexed on event loops.
+ */
+#define JCON_SYSTEM_MODE_EVENTLOOP 1
+
+/**
+ * @brief Maximum time in milliseconds an event loop waits for events.
+ * 
+ * Loops get woken up on shutdown, so this only bounds
+ * how long a loop can go without checking its state.
+ */
+#define JCON_SYSTEM_EVENTLOOP_TIMEOUT_DEFAULT 1000
+
+/**
+ * @brief Maximum number of workers for @c #jcon_system_workerPool_init() .
+ */
+#define JCON_SYSTEM_WORKERS_MAX 256
+
+/**
+ * @brief Initial number of slots and hash buckets of connection registry.
+ * 
+ * Both grow by doubling.
+ */
+#define JCON_SYSTEM_REGISTRY_SIZE_INITIAL 16
+
+/**
+ * @brief Default number of connections accepted per wakeup.
+ * 
+ * Bounds the time other work of the control thread or
+ * loop is delayed by a burst of connections.
+ */
+#define JCON_SYSTEM_ACCEPT_BATCH_DEFAULT 64
+
+/**
+ * @brief Default number of connection records kept for reuse.
+ */
+#define JCON_SYSTEM_POOL_DEFAULT 64
+
+/**
+ * @brief Maximum number of queued buffers sent with one call.
+ */
+#define JCON_SYSTEM_SEND_IOV_MAX 16
+
+/**
+ * @brief Default size of send queue in bytes, at which
+ *        further data for the connection is refused.
+ */
+#define JCON_SYSTEM_SEND_HIGH_DEFAULT 4194304
+
+/**
+ * @brief Default size of send queue in bytes, at which
+ *        a connection over the high watermark accepts data again.
+ */
+#define JCON_SYSTEM_SEND_LOW_DEFAULT 1048576
+
+/**
+ * @brief Milliseconds between checks of @c #jcon_system_drain() .
+ */
+#define JCON_SYSTEM_DRAIN_INTERVAL 10
+
+/**
+ * @brief Milliseconds between checks of loops for idle connections.
+ */
+#define JCON_SYSTEM_IDLE_INTERVAL 1000
+
+/**
+ * @brief Milliseconds connection threads wait, before they retry
+ *        to send the rest of a partially sent queue entry.
+ */
+#define JCON_SYSTEM_SEND_RETRY_INTERVAL 1
+
+/**
+ * @brief Longest time in milliseconds connection threads try
+ *        to finish a partially sent queue entry, before they
+ *        postpone the data handler.
+ */
+#define JCON_SYSTEM_SEND_FINISH_TIMEOUT 10
+
 
 
 //==============================================================================
@@ -34,22 +140,166 @@
 //
 
 /**
- * @brief Structure for linked list.
+ * @brief Event loop with thread running it.
+ */
+typedef struct __jcon_system_loop
+{
+  jcon_eventLoop_t *event_loop;   /**< Event loop multiplexing connections. */
+  jutil_thread_t *thread;         /**< Thread running event loop. */
+  jcon_system_t *system;          /**< System session, that owns the loop. */
+  int run_signal;                 /**< If @c false , thread stops. Protected by mutex of @c #thread . */
+  jutil_linkedlist_t *closed;     /**< Connections closed by workers, that the loop has to remove.
+                                       Protected by mutex of @c #thread . */
+
+  jcon_server_t *listener;                    /**< Server, the loop accepts from. @c NULL , if loop does not accept. */
+  int owns_listener;                          /**< @c true , if @c #listener was cloned for this loop. */
+  jcon_eventLoop_watcher_t listener_watcher;  /**< Watcher for @c #listener . */
+  int listening;                              /**< @c true , while @c #listener_watcher is in loop. */
+
+  long idle_checked;                          /**< Time in milliseconds of last check for idle connections. */
+} jcon_system_loop_t;
+
+/**
+ * @brief Bounded queue of connections, that have data available.
+ * 
+ * Filled by event loops, emptied by workers.
+ */
+typedef struct __jcon_system_workQueue
+{
+  struct __jcon_system_connectionPair **jobs; /**< Ring buffer of connections. */
+  size_t size;                                /**< Capacity of @c #jobs . */
+  size_t head;                                /**< Index of next job to take. */
+  size_t number;                              /**< Number of queued jobs. */
+  int run_signal;                             /**< If @c false , producers and consumers return. */
+
+  pthread_mutex_t mutex;                      /**< Protects queue. */
+  pthread_cond_t cond_notEmpty;               /**< Signaled, when job is added. */
+  pthread_cond_t cond_notFull;                /**< Signaled, when job is taken. */
+} jcon_system_workQueue_t;
+
+/**
+ * @brief Worker thread, that runs data handlers.
+ */
+typedef struct __jcon_system_worker
+{
+  jutil_thread_t *thread;         /**< Thread of worker. */
+  jcon_system_t *system;          /**< System session, that owns the worker. */
+  size_t index;                   /**< Index of worker, used for cpu pinning. */
+  int pinned;                     /**< @c true , once cpu affinity was set. */
+} jcon_system_worker_t;
+
+/**
+ * @brief Entry in send queue of a connection.
+ * 
+ * Queues of all connections of a broadcast reference
+ * the same buffer.
+ */
+typedef struct __jcon_system_sendEntry
+{
+  jutil_buffer_t *buffer;               /**< Reference of buffer to send. */
+  size_t size;                          /**< Size of @c #buffer in bytes. */
+  size_t offset;                        /**< Bytes of @c #buffer already sent. */
+  struct __jcon_system_sendEntry *next; /**< Next entry in queue. */
+} jcon_system_sendEntry_t;
+
+/**
+ * @brief Connection handled by system.
  */
 typedef struct __jcon_system_connectionPair
 {
-  jcon_thread_t *thread;  /**< jcon_thread session. */
-  jcon_client_t *client;  /**< jcon_client session used for jcon_thread. */
+  jcon_thread_t *thread;              /**< jcon_thread session. Only used in threaded mode. */
+  jcon_client_t *client;              /**< jcon_client session used for jcon_thread. */
+  jcon_system_t *system;              /**< System, that handles connection. Only used in threaded mode. */
+
+  jcon_eventLoop_watcher_t watcher;   /**< Watcher for client descriptor. Only used in event loop mode. */
+  jcon_system_loop_t *loop;           /**< Event loop, that handles connection. Only used in event loop mode. */
+
+  size_t slot;                                    /**< Index in @c jcon_system_registry_t#slots . */
+  uint32_t hash;                                  /**< Hash of reference string. */
+  struct __jcon_system_connectionPair *hash_next; /**< Next connection in same hash bucket. */
+
+  pthread_mutex_t send_mutex;         /**< Protects send queue, @c #registered and @c #in_worker . */
+  jcon_system_sendEntry_t *send_head; /**< First entry of send queue. */
+  jcon_system_sendEntry_t *send_tail; /**< Last entry of send queue. */
+  size_t send_bytes;                  /**< Queued bytes, that are not sent yet. */
+  int registered;                     /**< @c true , while watcher is registered with loop. Only used in event loop mode. */
+  int in_worker;                      /**< @c true , while connection is queued for or handled by a worker,
+                                           or its thread runs the data handler in threaded mode. */
+  int send_over;                      /**< @c true , from reaching high watermark, until drained to low watermark. */
+  long send_over_since;               /**< Time in milliseconds, when queue reached high watermark. */
+
+  long idle_since;                    /**< Time in milliseconds, when connection last recieved data.
+                                           Only used by thread of loop. */
+  int hibernated;                     /**< @c true , while connection is idle and released its memory. */
 } jcon_system_connection_t;
 
+/**
+ * @brief Registry of all connections.
+ * 
+ * Connections are stored densely in @c #slots , so they
+ * can be removed in constant time by moving the last one
+ * into the free slot. A hash table over the reference strings
+ * allows lookup without scanning.
+ * 
+ * Protected by control mutex, except @c #number .
+ */
+typedef struct __jcon_system_registry
+{
+  jcon_system_connection_t **slots;   /**< Array of connections. */
+  size_t slot_capacity;               /**< Size of @c #slots . */
+  jcon_system_connection_t **buckets; /**< Heads of hash chains. */
+  size_t bucket_number;               /**< Size of @c #buckets . Always power of 2. */
+  atomic_size_t number;               /**< Number of connections. Can be read without lock. */
+  uint64_t seed;                      /**< Seed of hashes, random per process. */
+} jcon_system_registry_t;
+
 /**
  * @brief Session object. Holds data for operation.
  */
 struct __jcon_system_session
 {
   jcon_server_t *server;                              /**< Server to handle. */
-  jutil_linkedlist_t *connections;                    /**< List of connections. */
-  jutil_thread_t *control_thread;                     /**< Thread to control server and connection list. */
+  jcon_system_registry_t connections;                 /**< Registry of connections. */
+  jutil_thread_t *control_thread;                     /**< Thread to control server and connection list.
+                                                           In event loop mode, this is the thread of the first loop. */
+
+  int mode;                                           /**< Either @c #JCON_SYSTEM_MODE_THREADED
+                                                           or @c #JCON_SYSTEM_MODE_EVENTLOOP . */
+  jcon_system_loop_t *loops;                          /**< Array of event loops. */
+  size_t loop_number;                                 /**< Size of @c #loops . */
+  size_t loop_next;                                   /**< Index of loop, that gets next connection. */
+  int multi_acceptor;                                 /**< If @c true , every loop accepts on its own listener
+                                                           and keeps the connections it accepted. */
+
+  size_t accept_batch;                                /**< Maximum number of connections accepted per wakeup. */
+  atomic_int accepting;                               /**< If @c false , listeners get closed and no
+                                                           connections are accepted anymore. */
+  int shutdown_registered;                            /**< @c true , if handlers were added to jproc shutdown. */
+  size_t last_accepted;                               /**< Connections accepted at last wakeup. Protected by control mutex. */
+  size_t last_cleaned;                                /**< Connections freed at last cleanup. Protected by control mutex. */
+
+  jcon_system_connection_t *pool;                     /**< Records of closed connections, linked by @c hash_next . */
+  size_t pool_number;                                 /**< Number of records in @c #pool . */
+  size_t pool_size;                                   /**< Maximum number of records in @c #pool . */
+  pthread_mutex_t pool_mutex;                         /**< Protects @c #pool . */
+
+  jcon_system_worker_t *workers;                      /**< Array of workers. */
+  size_t worker_number;                               /**< Size of @c #workers . @c 0 , if handlers run on loop threads. */
+  jcon_system_workQueue_t queue;                      /**< Queue of connections for workers. */
+
+  atomic_size_t send_pending;                         /**< Number of connections with queued data. */
+  atomic_size_t send_over;                            /**< Number of connections over high watermark. */
+  size_t send_high;                                   /**< High watermark of send queues. @c 0 , if unbounded. */
+  size_t send_low;                                    /**< Low watermark of send queues. */
+  long send_evict_timeout;                            /**< Milliseconds a connection may stay over high watermark.
+                                                           @c 0 , if slow connections are not closed. */
+  jcon_system_watermark_handler_t watermark_handler;  /**< Handler to call, when a queue crosses a watermark. */
+
+  atomic_long idle_timeout;                           /**< Milliseconds without data, after which connections
+                                                           hibernate. @c 0 , if disabled. */
+  jcon_system_idle_handler_t idle_handler;            /**< Handler to call, when a connection hibernates or wakes up.
+                                                           Protected by control mutex. */
+  atomic_size_t idle_number;                          /**< Number of hibernated connections. */
 
   jcon_system_threadData_handler_t data_handler;      /**< Handler to manage, when data is available through a client. */
   jcon_system_threadCreate_handler_t create_handler;  /**< Handler to manage, when new client is connected. */
@@ -78,6 +328,257 @@ struct __jcon_system_session
  */
 static int jcon_system_control_function(void *ctx, jutil_thread_t *thread_handler);
 
+/**
+ * @brief Allocates session and sets common members.
+ * 
+ * @param server          jcon_server session to use.
+ * @param data_handler    Handler to manage new data.
+ * @param create_handler  Handler gets called, when connection is created.
+ * @param close_handler   Handler gets called, when connection is closed.
+ * @param logger          Logger to print debug and error messages.
+ * @param ctx             Context pointer passed to handlers.
+ * 
+ * @return                Allocated session without threads.
+ * @return                @c NULL , if error occured.
+ */
+static jcon_system_t *jcon_system_allocate
+(
+  jcon_server_t *server,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+);
+
+/**
+ * @brief Creates event loops and their threads.
+ * 
+ * @param session     System session.
+ * @param loop_number Number of loops to create.
+ * 
+ * @return            @c true , if loops were created.
+ * @return            @c false , if error occured.
+ */
+static int jcon_system_createLoops(jcon_system_t *session, size_t loop_number);
+
+/**
+ * @brief Opens server, registers it with first loop and starts loop threads.
+ * 
+ * In multi acceptor mode, the other loops get a cloned
+ * listener each.
+ * 
+ * @param session System session.
+ * 
+ * @return        @c true , if loops were started.
+ * @return        @c false , if error occured.
+ */
+static int jcon_system_startEventLoops(jcon_system_t *session);
+
+/**
+ * @brief Stops loop threads and frees loops.
+ * 
+ * @param session System session.
+ */
+static void jcon_system_freeLoops(jcon_system_t *session);
+
+/**
+ * @brief Shutdown handler, stops accepting connections.
+ * 
+ * @param exit_value  Exit value of process.
+ * @param deadline    End of shutdown.
+ * @param ctx         System session.
+ */
+static void jcon_system_shutdown_accept(int exit_value, const jutil_time_deadline_t *deadline, void *ctx);
+
+/**
+ * @brief Shutdown handler, drains connections until deadline.
+ * 
+ * @param exit_value  Exit value of process.
+ * @param deadline    End of shutdown.
+ * @param ctx         System session.
+ */
+static void jcon_system_shutdown_drain(int exit_value, const jutil_time_deadline_t *deadline, void *ctx);
+
+/**
+ * @brief Loop function for event loop threads.
+ * 
+ * Waits for events and dispatches them.
+ * 
+ * @param ctx             Loop of type @c #jcon_system_loop_t .
+ * @param thread_handler  jutil_thread session. Used for mutex.
+ * 
+ * @return                @c true , if thread should continue.
+ * @return                @c false , if thread should stop.
+ */
+static int jcon_system_eventLoop_function(void *ctx, jutil_thread_t *thread_handler);
+
+/**
+ * @brief Event handler for listening socket.
+ * 
+ * Accepts new connection and assigns it to a loop.
+ * 
+ * @param loop    Event loop, that dispatches the event.
+ * @param watcher Watcher of listener. Context is the
+ *                @c #jcon_system_loop_t , that accepts.
+ * @param events  Ready events.
+ */
+static void jcon_system_server_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events);
+
+/**
+ * @brief Event handler for client connections.
+ * 
+ * Calls data handler, if data is available and
+ * closes connection on disconnect.
+ * 
+ * @param loop    Event loop, that dispatches the event.
+ * @param watcher Watcher of connection.
+ * @param events  Ready events.
+ */
+static void jcon_system_connection_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events);
+
+/**
+ * @brief Adds connection to event loop.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to add.
+ * 
+ * @return            @c true , if connection was added.
+ * @return            @c false , if error occured.
+ */
+static int jcon_system_eventLoop_addConnection(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Removes disconnected client from event loop and list.
+ * 
+ * Calls close handler and frees connection.
+ * Has to be called by thread of loop, that
+ * handles the connection.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to remove.
+ */
+static void jcon_system_eventLoop_removeConnection(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Initializes work queue.
+ * 
+ * @param session     System session.
+ * @param queue_depth Capacity of queue.
+ * 
+ * @return            @c true , if queue was initialized.
+ * @return            @c false , if error occured.
+ */
+static int jcon_system_workQueue_init(jcon_system_t *session, size_t queue_depth);
+
+/**
+ * @brief Frees memory of work queue.
+ * 
+ * @param session System session.
+ */
+static void jcon_system_workQueue_free(jcon_system_t *session);
+
+/**
+ * @brief Wakes up all threads waiting on queue and lets them return.
+ * 
+ * @param session System session.
+ */
+static void jcon_system_workQueue_stop(jcon_system_t *session);
+
+/**
+ * @brief Adds connection to queue.
+ * 
+ * Waits, if queue is full.
+ * 
+ * @param session     System session.
+ * @param connection  Connection with available data.
+ * 
+ * @return            @c true , if connection was queued.
+ * @return            @c false , if queue was stopped.
+ */
+static int jcon_system_workQueue_push(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Takes connection from queue.
+ * 
+ * Waits, if queue is empty.
+ * 
+ * @param session System session.
+ * 
+ * @return        Connection with available data.
+ * @return        @c NULL , if queue was stopped.
+ */
+static jcon_system_connection_t *jcon_system_workQueue_pop(jcon_system_t *session);
+
+/**
+ * @brief Creates worker threads.
+ * 
+ * @param session       System session.
+ * @param worker_number Number of workers to create.
+ * 
+ * @return              @c true , if workers were created.
+ * @return              @c false , if error occured.
+ */
+static int jcon_system_createWorkers(jcon_system_t *session, size_t worker_number);
+
+/**
+ * @brief Stops worker threads and frees them.
+ * 
+ * @param session System session.
+ */
+static void jcon_system_freeWorkers(jcon_system_t *session);
+
+/**
+ * @brief Loop function for worker threads.
+ * 
+ * Takes connection from queue, calls data handler
+ * and rearms connection in its event loop.
+ * 
+ * @param ctx             Worker of type @c #jcon_system_worker_t .
+ * @param thread_handler  jutil_thread session.
+ * 
+ * @return                @c true , if thread should continue.
+ * @return                @c false , if thread should stop.
+ */
+static int jcon_system_worker_function(void *ctx, jutil_thread_t *thread_handler);
+
+/**
+ * @brief Removes connections, that were closed by workers.
+ * 
+ * @param loop  Loop to clean up.
+ */
+static void jcon_system_eventLoop_removeClosed(jcon_system_loop_t *loop);
+
+/**
+ * @brief Removes connections of loop, that stayed over
+ *        high watermark for too long.
+ * 
+ * Has to be called by thread of loop.
+ * 
+ * @param loop  Loop to check.
+ */
+static void jcon_system_eventLoop_evictSlow(jcon_system_loop_t *loop);
+
+/**
+ * @brief Hibernates connections of loop, that did not
+ *        recieve data for the idle timeout.
+ * 
+ * Has to be called by thread of loop.
+ * 
+ * @param loop  Loop to check.
+ */
+static void jcon_system_eventLoop_hibernateIdle(jcon_system_loop_t *loop);
+
+/**
+ * @brief Wakes up hibernated connection, that recieved data.
+ * 
+ * Has to be called by thread of loop.
+ * 
+ * @param session     System session.
+ * @param connection  Hibernated connection.
+ */
+static void jcon_system_eventLoop_wakeIdle(jcon_system_t *session, jcon_system_connection_t *connection);
+
 /**
  * @brief Restarts server.
  * 
@@ -96,8 +597,23 @@ static int jcon_system_resetServer(jcon_system_t *session);
  * linked list.
  * 
  * @param session System session.
+ * 
+ * @return        Number of accepted connections.
+ */
+static size_t jcon_system_checkForConnections(jcon_system_t *session);
+
+/**
+ * @brief Accepts pending connections, until backlog is empty
+ *        or @c jcon_system_t#accept_batch is reached.
+ * 
+ * @param session   System session.
+ * @param listener  Server to accept from.
+ * @param loop      Event loop for new connections,
+ *                  see @c #jcon_system_addConnection() .
+ * 
+ * @return          Number of accepted connections.
  */
-static void jcon_system_checkForConnections(jcon_system_t *session);
+static size_t jcon_system_acceptConnections(jcon_system_t *session, jcon_server_t *listener, jcon_system_loop_t *loop);
 
 /**
  * @brief Manages disconnects.
@@ -107,8 +623,10 @@ static void jcon_system_checkForConnections(jcon_system_t *session);
  * from linked list.
  * 
  * @param session System session.
+ * 
+ * @return        Number of freed connections.
  */
-static void jcon_system_cleanupConnections(jcon_system_t *session);
+static size_t jcon_system_cleanupConnections(jcon_system_t *session);
 
 /**
  * @brief Frees all connections and removes them.
@@ -118,77 +636,321 @@ static void jcon_system_cleanupConnections(jcon_system_t *session);
 static void jcon_system_clearConnections(jcon_system_t *session);
 
 /**
- * @brief Adds new connecton to linked list.
+ * @brief Adds new connecton to registry.
  * 
  * @param session System session.
  * @param client  Client for new connection.
+ * @param loop    Event loop to handle connection.
+ *                If @c NULL , loops are assigned in round robin order.
+ *                Ignored in threaded mode.
  * 
- * @return        @c true , if client was added to list.
+ * @return        @c true , if client was added to registry.
  * @return        @c false , if error occured.
  */
-static int jcon_system_addConnection(jcon_system_t *session, jcon_client_t *client);
+static int jcon_system_addConnection(jcon_system_t *session, jcon_client_t *client, jcon_system_loop_t *loop);
 
 /**
- * @brief Closes connection and removes it from list.
+ * @brief Closes connection and removes it from registry.
  * 
- * @param session         System session.
- * @param connection_node Node in linked list of connection.
+ * @param session     System session.
+ * @param connection  Connection to free.
  */
-static void jcon_system_freeConnection(jcon_system_t *session, jutil_linkedlist_t *connection_node);
+static void jcon_system_freeConnection(jcon_system_t *session, jcon_system_connection_t *connection);
 
 /**
- * @brief Handler for jcon_thread.
+ * @brief Takes connection record from pool.
  * 
- * Currently not used.
+ * Allocates a new record, if pool is empty.
+ * The send mutex of the record is initialized.
  * 
- * @param ctx               Context pointer provided by user.
- * @param create_type       Either @c #JCON_THREAD_CREATETYPE_INIT
- *                          or @c #JCON_THREAD_CREATETYPE_CLONE .
- * @param reference_string  Reference string of the client created.
+ * @param session System session.
+ * 
+ * @return        Connection record.
+ * @return        @c NULL , if error occured.
  */
-static void jcon_system_connectionThread_create(void *ctx, int create_type, const char *reference_string);
+static jcon_system_connection_t *jcon_system_pool_take(jcon_system_t *session);
 
 /**
- * @brief Handler for jcon_thread.
+ * @brief Puts connection record back into pool.
  * 
- * Currently not used.
+ * Frees record, if pool is full.
  * 
- * @param ctx               Context pointer provided by user.
- * @param create_type       Either @c #JCON_THREAD_CLOSETYPE_DISCONNECT
- *                          or @c #JCON_THREAD_CLOSETYPE_EXTERN .
- * @param reference_string  Reference string of the client closed.
+ * @param session     System session.
+ * @param connection  Record without client, thread or queued data.
  */
-static void jcon_system_connectionThread_close(void *ctx, int close_type, const char *reference_string);
+static void jcon_system_pool_put(jcon_system_t *session, jcon_system_connection_t *connection);
 
 /**
- * @brief Logs debug and error messages.
+ * @brief Frees records of pool, until @c size are left.
  * 
- * Uses logger from @c ctx , or if logger is @c NULL , uses global logger.
+ * Has to be called with pool mutex locked.
  * 
- * @param session   System session.
- * @param log_type  Type of log message.
- * @param file      Source code file, where message was logged.
- * @param function  Function in which message was logged.
- * @param line      Line, where message was logged.
- * @param fmt       Format string for stdarg.h .
+ * @param session System session.
+ * @param size    Number of records to keep.
  */
-static void jcon_system_log(jcon_system_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+static void jcon_system_pool_trim(jcon_system_t *session, size_t size);
 
+/**
+ * @brief Adds connection to registry.
+ * 
+ * Has to be called with control mutex locked.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to add.
+ * 
+ * @return            @c true , if connection was added.
+ * @return            @c false , if error occured.
+ */
+static int jcon_system_registry_insert(jcon_system_t *session, jcon_system_connection_t *connection);
 
+/**
+ * @brief Removes connection from registry.
+ * 
+ * Has to be called with control mutex locked.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to remove.
+ * 
+ * @return            @c true , if connection was removed.
+ * @return            @c false , if connection was not registered.
+ */
+static int jcon_system_registry_remove(jcon_system_t *session, jcon_system_connection_t *connection);
 
-//==============================================================================
-// Define log macros.
+/**
+ * @brief Finds connection by reference string of its client.
+ * 
+ * Has to be called with control mutex locked.
+ * 
+ * @param session           System session.
+ * @param reference_string  Reference string to look for.
+ * 
+ * @return                  Connection with reference string.
+ * @return                  @c NULL , if not found.
+ */
+static jcon_system_connection_t *jcon_system_registry_find(jcon_system_t *session, const char *reference_string);
+
+/**
+ * @brief Frees memory of empty registry.
+ * 
+ * @param session System session.
+ */
+static void jcon_system_registry_free(jcon_system_t *session);
+
+/**
+ * @brief Calculates seeded hash of reference string.
+ * 
+ * @param registry          Registry with seed.
+ * @param reference_string  String to hash.
+ * 
+ * @return                  Hash value.
+ */
+static uint32_t jcon_system_registry_hash(jcon_system_registry_t *registry, const char *reference_string);
+
+/**
+ * @brief Appends buffer to send queue of connection.
+ * 
+ * Takes a new reference of the buffer. If the queue was
+ * empty, the connection gets armed for writing.
+ * Buffers are refused, while the queue is over the
+ * high watermark.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to queue for.
+ * @param buffer      Buffer to queue.
+ * 
+ * @return            @c true , if buffer was queued.
+ * @return            @c false , if client is not connected, queue is
+ *                    over high watermark or error occured.
+ */
+static int jcon_system_sendQueue_push(jcon_system_t *session, jcon_system_connection_t *connection, jutil_buffer_t *buffer);
+
+/**
+ * @brief Sends queued data, until queue is empty or
+ *        socket send buffer is full.
+ * 
+ * Never blocks. Has to be called with send mutex
+ * of connection locked. Watermark handler is not called,
+ * so it does not run with the lock held. That is done by
+ * @c #jcon_system_sendQueue_notify() .
+ * 
+ * @param session     System session.
+ * @param connection  Connection to send queued data of.
+ * 
+ * @return            @c true , if queue dropped to low watermark.
+ * @return            @c false , if not.
+ */
+static int jcon_system_sendQueue_flush(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Calls watermark handler for connection.
+ * 
+ * Must not be called with send mutex locked.
+ * 
+ * @param session     System session.
+ * @param connection  Connection, that crossed a watermark.
+ * @param over        @c true , if high watermark was reached,
+ *                    @c false , if queue dropped to low watermark.
+ */
+static void jcon_system_sendQueue_notify(jcon_system_t *session, jcon_system_connection_t *connection, int over);
+
+/**
+ * @brief Checks, if connection stayed over high watermark
+ *        for longer than the eviction timeout.
+ * 
+ * Has to be called with send mutex of connection locked.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to check.
+ * 
+ * @return            @c true , if connection should be closed.
+ * @return            @c false , if not.
+ */
+static int jcon_system_sendQueue_expired(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Returns monotonic time in milliseconds.
+ * 
+ * @return  Current time.
+ */
+static long jcon_system_getTime(void);
+
+/**
+ * @brief Frees all entries of send queue.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to clear queue of.
+ */
+static void jcon_system_sendQueue_clear(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Updates events of connection watcher.
+ * 
+ * Watches for writing, while send queue is not empty.
+ * In worker pool mode the oneshot watcher gets rearmed.
+ * Does nothing, while watcher is not registered or
+ * connection is handled by a worker.
+ * 
+ * Has to be called with send mutex of connection locked.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to update.
+ * 
+ * @return            @c true , if watcher is up to date.
+ * @return            @c false , if error occured.
+ */
+static int jcon_system_sendQueue_rearm(jcon_system_t *session, jcon_system_connection_t *connection);
+
+/**
+ * @brief Sends queued data of all connections.
+ * 
+ * Used by control thread in threaded mode. Skips connections,
+ * whose thread runs the data handler, so queued data does not
+ * interleave with direct sends of the handler. They are sent
+ * on the next call.
+ * Frees connections, that stayed over high watermark
+ * for too long. Has to be called with control mutex locked.
+ * 
+ * @param session System session.
+ */
+static void jcon_system_flushConnections(jcon_system_t *session);
+
+/**
+ * @brief Sends the rest of a partially sent queue entry.
+ * 
+ * Retries, while the send buffer is full, for at most
+ * @c #JCON_SYSTEM_SEND_FINISH_TIMEOUT milliseconds. Stops
+ * earlier, if the client disconnects or the connection stayed
+ * over high watermark for too long. Must not be called with
+ * send mutex locked. Connection has to be marked with
+ * @c jcon_system_connection_t#in_worker , so no other thread
+ * sends its queue meanwhile.
+ * 
+ * @param session     System session.
+ * @param connection  Connection to send queued data of.
+ * @param drained     Set to @c true , if queue dropped to low watermark.
+ * 
+ * @return            @c true , if no partially sent entry is left.
+ * @return            @c false , if the peer did not make room in time.
+ */
+static int jcon_system_sendQueue_finish(jcon_system_t *session, jcon_system_connection_t *connection, int *drained);
+
+/**
+ * @brief Handler for jcon_thread.
+ * 
+ * Currently not used.
+ * 
+ * @param ctx               Context pointer provided by user.
+ * @param create_type       Either @c #JCON_THREAD_CREATETYPE_INIT
+ *                          or @c #JCON_THREAD_CREATETYPE_CLONE .
+ * @param reference_string  Reference string of the client created.
+ */
+static void jcon_system_connectionThread_create(void *ctx, int create_type, const char *reference_string);
+
+/**
+ * @brief Handler for jcon_thread.
+ * 
+ * Currently not used.
+ * 
+ * @param ctx               Context pointer provided by user.
+ * @param create_type       Either @c #JCON_THREAD_CLOSETYPE_DISCONNECT
+ *                          or @c #JCON_THREAD_CLOSETYPE_EXTERN .
+ * @param reference_string  Reference string of the client closed.
+ */
+static void jcon_system_connectionThread_close(void *ctx, int close_type, const char *reference_string);
+
+/**
+ * @brief Data handler for jcon_thread.
+ * 
+ * Takes the send queue of the connection from the control
+ * thread and finishes a partially sent entry, before the
+ * data handler of the system runs. So data, that the handler
+ * sends directly through the client, never lands inside
+ * a queued message.
+ * 
+ * If the entry can not be finished in time, the handler is
+ * postponed and the control thread keeps sending the queue.
+ * The data stays unread, so jcon_thread calls again on its
+ * next iteration and can still be stopped in between.
+ * 
+ * @param ctx     Connection of thread.
+ * @param client  Client with available data.
+ */
+static void jcon_system_connectionThread_data(void *ctx, jcon_client_t *client);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * Uses logger from @c ctx , or if logger is @c NULL , uses global logger.
+ * 
+ * @param session   System session.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jcon_system_log(jcon_system_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled(((session && session->server) ? session->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG /* Allows to disable debug messages at compile time. */
   #define DEBUG(session, fmt, ...)
 #else
-  #define DEBUG(session, fmt, ...) jcon_system_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_system_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(session, fmt, ...) jcon_system_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(session, fmt, ...) jcon_system_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(session, fmt, ...) jcon_system_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(session, fmt, ...) jcon_system_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_system_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_system_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_system_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_system_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(session, fmt, ...) jcon_system_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -209,27 +971,13 @@ jcon_system_t *jcon_system_init
   void *ctx
 )
 {
-  if(server == NULL)
-  {
-    ERROR(NULL,"Server is NULL.");
-    return NULL;
-  }
-
-  jcon_system_t *session = (jcon_system_t *)malloc(sizeof(jcon_system_t));
+  jcon_system_t *session = jcon_system_allocate(server, data_handler, create_handler, close_handler, logger, ctx);
   if(session == NULL)
   {
-    ERROR(NULL, "malloc() failed.");
+    ERROR(NULL, "jcon_system_allocate() failed.");
     return NULL;
   }
 
-  session->server = server;
-  session->connections = NULL;
-  session->data_handler = data_handler;
-  session->create_handler = create_handler;
-  session->close_handler = close_handler;
-  session->logger = logger;
-  session->session_context = ctx;
-
   session->control_thread = jutil_thread_init
   (
     jcon_system_control_function,
@@ -241,7 +989,7 @@ jcon_system_t *jcon_system_init
   if(session->control_thread == NULL)
   {
     ERROR(session, "jutil_thread_init() failed. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -251,7 +999,7 @@ jcon_system_t *jcon_system_init
     {
       ERROR(session, "jcon_system_resetServer() failed. Destroying session.");
       jutil_thread_free(session->control_thread);
-      free(session);
+      JUTIL_ALLOC_FREE(session);
       return NULL;
     }
   }
@@ -260,10 +1008,200 @@ jcon_system_t *jcon_system_init
   {
     ERROR(session, "jutil_thread_start() failed. Destroying session.");
     jutil_thread_free(session->control_thread);
-    free(session);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_system_t *jcon_system_eventLoop_init
+(
+  jcon_server_t *server,
+  size_t loop_number,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+)
+{
+  if(loop_number == 0)
+  {
+    ERROR(NULL, "loop_number is [0].");
+    return NULL;
+  }
+
+  jcon_system_t *session = jcon_system_allocate(server, data_handler, create_handler, close_handler, logger, ctx);
+  if(session == NULL)
+  {
+    ERROR(NULL, "jcon_system_allocate() failed.");
+    return NULL;
+  }
+
+  session->mode = JCON_SYSTEM_MODE_EVENTLOOP;
+
+  if(jcon_system_createLoops(session, loop_number) == false)
+  {
+    ERROR(session, "jcon_system_createLoops() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jcon_system_startEventLoops(session) == false)
+  {
+    ERROR(session, "jcon_system_startEventLoops() failed. Destroying session.");
+    jcon_system_freeLoops(session);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_system_t *jcon_system_multiAcceptor_init
+(
+  jcon_server_t *server,
+  size_t loop_number,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+)
+{
+  if(loop_number == 0)
+  {
+    ERROR(NULL, "loop_number is [0].");
+    return NULL;
+  }
+
+  jcon_system_t *session = jcon_system_allocate(server, data_handler, create_handler, close_handler, logger, ctx);
+  if(session == NULL)
+  {
+    ERROR(NULL, "jcon_system_allocate() failed.");
+    return NULL;
+  }
+
+  session->mode = JCON_SYSTEM_MODE_EVENTLOOP;
+  session->multi_acceptor = true;
+
+  if(jcon_system_createLoops(session, loop_number) == false)
+  {
+    ERROR(session, "jcon_system_createLoops() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jcon_system_startEventLoops(session) == false)
+  {
+    ERROR(session, "jcon_system_startEventLoops() failed. Destroying session.");
+    jcon_system_freeLoops(session);
+    jcon_system_clearConnections(session);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_system_t *jcon_system_workerPool_init
+(
+  jcon_server_t *server,
+  size_t loop_number,
+  size_t worker_number,
+  size_t queue_depth,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+)
+{
+  if(loop_number == 0)
+  {
+    ERROR(NULL, "loop_number is [0].");
+    return NULL;
+  }
+
+  if(worker_number == 0 || worker_number > JCON_SYSTEM_WORKERS_MAX)
+  {
+    ERROR(NULL, "Invalid worker_number [%zu].", worker_number);
+    return NULL;
+  }
+
+  if(queue_depth == 0)
+  {
+    ERROR(NULL, "queue_depth is [0].");
+    return NULL;
+  }
+
+  jcon_system_t *session = jcon_system_allocate(server, data_handler, create_handler, close_handler, logger, ctx);
+  if(session == NULL)
+  {
+    ERROR(NULL, "jcon_system_allocate() failed.");
+    return NULL;
+  }
+
+  session->mode = JCON_SYSTEM_MODE_EVENTLOOP;
+
+  if(jcon_system_workQueue_init(session, queue_depth) == false)
+  {
+    ERROR(session, "jcon_system_workQueue_init() failed. Destroying session.");
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jcon_system_createWorkers(session, worker_number) == false)
+  {
+    ERROR(session, "jcon_system_createWorkers() failed. Destroying session.");
+    jcon_system_workQueue_free(session);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jcon_system_createLoops(session, loop_number) == false)
+  {
+    ERROR(session, "jcon_system_createLoops() failed. Destroying session.");
+    jcon_system_freeWorkers(session);
+    jcon_system_workQueue_free(session);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jcon_system_startEventLoops(session) == false)
+  {
+    ERROR(session, "jcon_system_startEventLoops() failed. Destroying session.");
+    jcon_system_workQueue_stop(session);
+    jcon_system_freeWorkers(session);
+    jcon_system_freeLoops(session);
+    jcon_system_workQueue_free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
+  size_t i;
+  for(i = 0; i < session->worker_number; i++)
+  {
+    if(jutil_thread_start(session->workers[i].thread) == false)
+    {
+      ERROR(session, "jutil_thread_start() failed. Destroying session.");
+      jcon_system_workQueue_stop(session);
+      jcon_system_freeWorkers(session);
+      jcon_system_freeLoops(session);
+      jcon_system_clearConnections(session);
+      jcon_system_workQueue_free(session);
+      JUTIL_ALLOC_FREE(session);
+      return NULL;
+    }
+  }
+
   return session;
 }
 
@@ -277,367 +1215,2472 @@ void jcon_system_free(jcon_system_t *session)
     return;
   }
 
-  jutil_thread_free(session->control_thread);
-  jcon_system_clearConnections(session);
+  if(session->shutdown_registered)
+  {
+    jproc_exit_removeShutdownHandler(JPROC_EXIT_PHASE_ACCEPT, &jcon_system_shutdown_accept, session);
+    jproc_exit_removeShutdownHandler(JPROC_EXIT_PHASE_DRAIN, &jcon_system_shutdown_drain, session);
+  }
+
+  if(session->mode == JCON_SYSTEM_MODE_EVENTLOOP)
+  {
+    /* Connections are only touched by loop and worker threads, so stop them first. */
+    if(session->worker_number > 0)
+    {
+      jcon_system_workQueue_stop(session);
+      jcon_system_freeWorkers(session);
+    }
+    jcon_system_freeLoops(session);
+    jcon_system_clearConnections(session);
+    if(session->queue.jobs)
+    {
+      jcon_system_workQueue_free(session);
+    }
+  }
+  else
+  {
+    /* Connection threads notify the control thread, so free it after them. */
+    jutil_thread_stop(session->control_thread);
+    jcon_system_clearConnections(session);
+    jutil_thread_free(session->control_thread);
+  }
+
+  pthread_mutex_lock(&session->pool_mutex);
+  jcon_system_pool_trim(session, 0);
+  pthread_mutex_unlock(&session->pool_mutex);
+  pthread_mutex_destroy(&session->pool_mutex);
+
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_system_getConnectionType(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(session->server == NULL)
+  {
+    ERROR(NULL, "Server is NULL.");
+    return NULL;
+  }
+
+  return jcon_server_getConnectionType(session->server);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jcon_system_getReferenceString(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return NULL;
+  }
+
+  if(session->server == NULL)
+  {
+    ERROR(NULL, "Server is NULL.");
+    return NULL;
+  }
+
+  return jcon_server_getReferenceString(session->server);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_isServerOpen(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->server == NULL)
+  {
+    ERROR(NULL, "Server is NULL.");
+    return false;
+  }
+
+  return jcon_server_isOpen(session->server);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_control_isRunning(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  return jutil_thread_isRunning(session->control_thread);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_getConnectionNumber(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  return atomic_load(&session->connections.number);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_findConnection(jcon_system_t *session, const char *reference_string, jcon_system_connection_handler_t handler, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(reference_string == NULL)
+  {
+    ERROR(session, "reference_string is NULL.");
+    return false;
+  }
+
+  jutil_thread_lockMutex(session->control_thread);
+
+  jcon_system_connection_t *connection = jcon_system_registry_find(session, reference_string);
+  if(connection && handler)
+  {
+    handler(ctx, connection->client);
+  }
+
+  jutil_thread_unlockMutex(session->control_thread);
+
+  return (connection != NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_broadcast(jcon_system_t *session, const void *data_ptr, size_t data_size, jcon_system_broadcastFilter_t filter, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(data_ptr == NULL || data_size == 0)
+  {
+    ERROR(session, "No data given.");
+    return 0;
+  }
+
+  jutil_buffer_t *buffer = jutil_buffer_copy_init(data_ptr, data_size);
+  if(buffer == NULL)
+  {
+    ERROR(session, "jutil_buffer_copy_init() failed.");
+    return 0;
+  }
+
+  size_t queued = jcon_system_broadcastBuffer(session, buffer, filter, ctx);
+  jutil_buffer_free(buffer);
+
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_broadcastBuffer(jcon_system_t *session, jutil_buffer_t *buffer, jcon_system_broadcastFilter_t filter, void *ctx)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jutil_buffer_getSize(buffer) == 0)
+  {
+    ERROR(session, "No data given.");
+    return 0;
+  }
+
+  size_t queued = 0;
+
+  jutil_thread_lockMutex(session->control_thread);
+
+  size_t number = atomic_load(&session->connections.number);
+  for(size_t i = 0; i < number; i++)
+  {
+    jcon_system_connection_t *connection = session->connections.slots[i];
+
+    if(filter && filter(ctx, jcon_client_getReferenceString(connection->client)) == false)
+    {
+      continue;
+    }
+
+    if(jcon_system_sendQueue_push(session, connection, buffer))
+    {
+      queued++;
+    }
+  }
+
+  jutil_thread_unlockMutex(session->control_thread);
+
+  /* Control thread sends queues of connections, that are not in their data handler. */
+  if(queued > 0 && session->mode == JCON_SYSTEM_MODE_THREADED)
+  {
+    jutil_thread_notify(session->control_thread);
+  }
+
+  return queued;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_send(jcon_system_t *session, const char *reference_string, const void *data_ptr, size_t data_size)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(data_ptr == NULL || data_size == 0)
+  {
+    ERROR(session, "No data given.");
+    return false;
+  }
+
+  jutil_buffer_t *buffer = jutil_buffer_copy_init(data_ptr, data_size);
+  if(buffer == NULL)
+  {
+    ERROR(session, "jutil_buffer_copy_init() failed.");
+    return false;
+  }
+
+  int ret = jcon_system_sendBuffer(session, reference_string, buffer);
+  jutil_buffer_free(buffer);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_sendBuffer(jcon_system_t *session, const char *reference_string, jutil_buffer_t *buffer)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(reference_string == NULL)
+  {
+    ERROR(session, "reference_string is NULL.");
+    return false;
+  }
+
+  if(jutil_buffer_getSize(buffer) == 0)
+  {
+    ERROR(session, "No data given.");
+    return false;
+  }
+
+  int ret = false;
+
+  jutil_thread_lockMutex(session->control_thread);
+
+  jcon_system_connection_t *connection = jcon_system_registry_find(session, reference_string);
+  if(connection)
+  {
+    ret = jcon_system_sendQueue_push(session, connection, buffer);
+  }
+
+  jutil_thread_unlockMutex(session->control_thread);
+
+  if(ret && session->mode == JCON_SYSTEM_MODE_THREADED)
+  {
+    jutil_thread_notify(session->control_thread);
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_setSendLimits(jcon_system_t *session, size_t high_watermark, size_t low_watermark, long evict_timeout)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(high_watermark > 0 && low_watermark >= high_watermark)
+  {
+    ERROR(session, "Low watermark [%zu] has to be below high watermark [%zu].", low_watermark, high_watermark);
+    return false;
+  }
+
+  if(evict_timeout < 0)
+  {
+    ERROR(session, "Invalid eviction timeout [%ld].", evict_timeout);
+    return false;
+  }
+
+  jutil_thread_lockMutex(session->control_thread);
+  session->send_high = high_watermark;
+  session->send_low = low_watermark;
+  session->send_evict_timeout = evict_timeout;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_setWatermarkHandler(jcon_system_t *session, jcon_system_watermark_handler_t handler)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  jutil_thread_lockMutex(session->control_thread);
+  session->watermark_handler = handler;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_setIdleTimeout(jcon_system_t *session, long idle_timeout, jcon_system_idle_handler_t handler)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->mode != JCON_SYSTEM_MODE_EVENTLOOP)
+  {
+    ERROR(session, "Idle timeout is only supported in event loop mode.");
+    return false;
+  }
+
+  if(idle_timeout < 0)
+  {
+    ERROR(session, "Invalid idle timeout [%ld].", idle_timeout);
+    return false;
+  }
+
+  jutil_thread_lockMutex(session->control_thread);
+  session->idle_handler = handler;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  atomic_store(&session->idle_timeout, idle_timeout);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_getHibernatedNumber(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  return atomic_load(&session->idle_number);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_setAcceptBatch(jcon_system_t *session, size_t batch)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(batch == 0)
+  {
+    ERROR(session, "batch is [0].");
+    return false;
+  }
+
+  jutil_thread_lockMutex(session->control_thread);
+  session->accept_batch = batch;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_setPoolSize(jcon_system_t *session, size_t size)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  int ret = true;
+
+  pthread_mutex_lock(&session->pool_mutex);
+  session->pool_size = size;
+  jcon_system_pool_trim(session, size);
+
+  while(session->pool_number < size)
+  {
+    jcon_system_connection_t *connection = (jcon_system_connection_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_system_connection_t));
+    if(connection == NULL)
+    {
+      ERROR(session, "malloc() failed.");
+      ret = false;
+      break;
+    }
+
+    int error = pthread_mutex_init(&connection->send_mutex, NULL);
+    if(error)
+    {
+      ERROR(session, "pthread_mutex_init() failed [%d : %s].", error, strerror(error));
+      JUTIL_ALLOC_FREE(connection);
+      ret = false;
+      break;
+    }
+
+    connection->hash_next = session->pool;
+    session->pool = connection;
+    session->pool_number++;
+  }
+  pthread_mutex_unlock(&session->pool_mutex);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_getAcceptedLast(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  size_t ret;
+
+  jutil_thread_lockMutex(session->control_thread);
+  ret = session->last_accepted;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_getCleanedLast(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  size_t ret;
+
+  jutil_thread_lockMutex(session->control_thread);
+  ret = session->last_cleaned;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_stopAccepting(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(atomic_exchange(&session->accepting, false) == false)
+  {
+    return true;
+  }
+
+  /* Threads close their listeners at next wakeup. */
+  if(session->mode == JCON_SYSTEM_MODE_EVENTLOOP)
+  {
+    for(size_t i = 0; i < session->loop_number; i++)
+    {
+      jcon_eventLoop_wakeup(session->loops[i].event_loop);
+    }
+  }
+  else
+  {
+    jutil_thread_notify(session->control_thread);
+  }
+
+  DEBUG(session, "Stopped accepting connections.");
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_drain(jcon_system_t *session, long timeout)
+{
+  if(jcon_system_stopAccepting(session) == false)
+  {
+    return false;
+  }
+
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, timeout);
+
+  size_t number;
+  while((number = atomic_load(&session->connections.number)) > 0)
+  {
+    if(jutil_time_deadline_isExpired(&deadline))
+    {
+      WARN(session, "[%zu] connections still open after drain timeout.", number);
+      return false;
+    }
+
+    jutil_time_sleep(0, JCON_SYSTEM_DRAIN_INTERVAL * 1000000L, false);
+  }
+
+  DEBUG(session, "All connections drained.");
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_addShutdownHandlers(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->shutdown_registered)
+  {
+    return true;
+  }
+
+  if(jproc_exit_addShutdownHandler(JPROC_EXIT_PHASE_ACCEPT, &jcon_system_shutdown_accept, session) == false)
+  {
+    ERROR(session, "jproc_exit_addShutdownHandler() failed.");
+    return false;
+  }
+
+  if(jproc_exit_addShutdownHandler(JPROC_EXIT_PHASE_DRAIN, &jcon_system_shutdown_drain, session) == false)
+  {
+    ERROR(session, "jproc_exit_addShutdownHandler() failed.");
+    jproc_exit_removeShutdownHandler(JPROC_EXIT_PHASE_ACCEPT, &jcon_system_shutdown_accept, session);
+    return false;
+  }
+
+  session->shutdown_registered = true;
+  return true;
+}
+
+
+
+//==============================================================================
+// Implement functions for session creation.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_system_t *jcon_system_allocate
+(
+  jcon_server_t *server,
+  jcon_system_threadData_handler_t data_handler,
+  jcon_system_threadCreate_handler_t create_handler,
+  jcon_system_threadClose_handler_t close_handler,
+  jlog_t *logger,
+  void *ctx
+)
+{
+  if(server == NULL)
+  {
+    ERROR(NULL,"Server is NULL.");
+    return NULL;
+  }
+
+  jcon_system_t *session = (jcon_system_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_system_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  session->server = server;
+  session->connections.slots = NULL;
+  session->connections.slot_capacity = 0;
+  session->connections.buckets = NULL;
+  session->connections.bucket_number = 0;
+  atomic_init(&session->connections.number, 0);
+  session->connections.seed = jutil_hash_getRandomSeed();
+  session->control_thread = NULL;
+  session->mode = JCON_SYSTEM_MODE_THREADED;
+  session->loops = NULL;
+  session->loop_number = 0;
+  session->loop_next = 0;
+  session->multi_acceptor = false;
+  session->accept_batch = JCON_SYSTEM_ACCEPT_BATCH_DEFAULT;
+  atomic_init(&session->accepting, true);
+  session->shutdown_registered = false;
+  session->last_accepted = 0;
+  session->last_cleaned = 0;
+  session->pool = NULL;
+  session->pool_number = 0;
+  session->pool_size = JCON_SYSTEM_POOL_DEFAULT;
+  session->workers = NULL;
+  session->worker_number = 0;
+  session->queue.jobs = NULL;
+  atomic_init(&session->send_pending, 0);
+  atomic_init(&session->send_over, 0);
+  session->send_high = JCON_SYSTEM_SEND_HIGH_DEFAULT;
+  session->send_low = JCON_SYSTEM_SEND_LOW_DEFAULT;
+  session->send_evict_timeout = 0;
+  session->watermark_handler = NULL;
+  atomic_init(&session->idle_timeout, 0);
+  session->idle_handler = NULL;
+  atomic_init(&session->idle_number, 0);
+  session->data_handler = data_handler;
+  session->create_handler = create_handler;
+  session->close_handler = close_handler;
+  session->logger = logger;
+  session->session_context = ctx;
+
+  int error = pthread_mutex_init(&session->pool_mutex, NULL);
+  if(error)
+  {
+    ERROR(NULL, "pthread_mutex_init() failed [%d : %s].", error, strerror(error));
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+
+
+//==============================================================================
+// Implement functions for control thread.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_control_function(void *ctx, jutil_thread_t *thread_handler)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(thread_handler == NULL)
+  {
+    ERROR(NULL, "thread_handler is NULL.");
+    return false;
+  }
+
+  jcon_system_t *session = (jcon_system_t *)ctx;
+  int ret = true;
+
+  jutil_thread_lockMutex(thread_handler);
+  /* Check for closed connections. */
+  session->last_cleaned = jcon_system_cleanupConnections(session);
+  /* Check for new connections. */
+  if(atomic_load(&session->accepting))
+  {
+    session->last_accepted = jcon_system_checkForConnections(session);
+  }
+  else if(jcon_server_isOpen(session->server))
+  {
+    jcon_server_close(session->server);
+    session->last_accepted = 0;
+  }
+  /* Send queued broadcasts. */
+  if(atomic_load(&session->send_pending) > 0)
+  {
+    jcon_system_flushConnections(session);
+  }
+  jutil_thread_unlockMutex(thread_handler);
+
+  return ret;
+}
+
+
+
+//==============================================================================
+// Implement functions for server control.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_resetServer(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(session->server == NULL)
+  {
+    ERROR(NULL, "Server is NULL.");
+    return false;
+  }
+
+  int ret;
+  jutil_thread_lockMutex(session->control_thread);
+  ret = jcon_server_reset(session->server);
+  jutil_thread_unlockMutex(session->control_thread);
+
+  if(ret == false)
+  {
+    ERROR(session, "jcon_server_reset() failed.");
+  }
+
+  return ret;
+}
+
+
+
+//==============================================================================
+// Implement functions for server connections.
+//
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_checkForConnections(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  if(jcon_server_newConnection(session->server))
+  {
+    return jcon_system_acceptConnections(session, session->server, NULL);
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_acceptConnections(jcon_system_t *session, jcon_server_t *listener, jcon_system_loop_t *loop)
+{
+  size_t accepted = 0;
+
+  while(accepted < session->accept_batch)
+  {
+    jcon_client_t *new_client = jcon_server_acceptConnection(listener);
+    if(new_client == NULL)
+    {
+      /* Backlog is empty (or accepting failed, which is logged by the server). */
+      break;
+    }
+
+    if(jcon_system_addConnection(session, new_client, loop) == false)
+    {
+      ERROR(session, "jcon_system_addConnection() failed.");
+      jcon_client_session_free(new_client);
+      continue;
+    }
+
+    accepted++;
+  }
+
+  JUTIL_METRICS_COUNTER_ADD("jcon_system_accepts_total", "Accepted connections.", accepted);
+
+  return accepted;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jcon_system_cleanupConnections(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  size_t cleaned = 0;
+  size_t i = atomic_load(&session->connections.number);
+
+  /* Backwards, because freeing moves the last connection into the free slot. */
+  while(i > 0)
+  {
+    i--;
+    jcon_system_connection_t *connection = session->connections.slots[i];
+
+    if(jcon_thread_isRunning(connection->thread) == false)
+    {
+      jcon_system_freeConnection(session, connection);
+      cleaned++;
+    }
+  }
+
+  return cleaned;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_clearConnections(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  size_t number;
+  while((number = atomic_load(&session->connections.number)) > 0)
+  {
+    jcon_system_connection_t *connection = session->connections.slots[number - 1];
+    DEBUG(session, "Destroying connection [%p].", connection);
+    jcon_system_freeConnection(session, connection);
+  }
+
+  jcon_system_registry_free(session);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_addConnection(jcon_system_t *session, jcon_client_t *client, jcon_system_loop_t *loop)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(client == NULL)
+  {
+    ERROR(session, "Client is NULL.");
+    return false;
+  }
+
+  jcon_system_connection_t *new_connection = jcon_system_pool_take(session);
+  if(new_connection == NULL)
+  {
+    ERROR(session, "jcon_system_pool_take() failed.");
+    return false;
+  }
+
+  new_connection->client = client;
+  new_connection->thread = NULL;
+  new_connection->loop = NULL;
+  new_connection->system = session;
+
+  new_connection->send_head = NULL;
+  new_connection->send_tail = NULL;
+  new_connection->send_bytes = 0;
+  new_connection->registered = false;
+  new_connection->in_worker = false;
+  new_connection->send_over = false;
+  new_connection->send_over_since = 0;
+  new_connection->idle_since = jcon_system_getTime();
+  new_connection->hibernated = false;
+
+  if(session->mode == JCON_SYSTEM_MODE_EVENTLOOP)
+  {
+    new_connection->loop = loop;
+
+    if(jcon_system_eventLoop_addConnection(session, new_connection) == false)
+    {
+      ERROR(session, "jcon_system_eventLoop_addConnection() failed.");
+      jcon_system_pool_put(session, new_connection);
+      return false;
+    }
+
+    JUTIL_METRICS_GAUGE_ADD("jcon_system_connections", "Open connections.", 1);
+    return true;
+  }
+
+  new_connection->thread = jcon_thread_init
+  (
+    client,
+    jcon_system_connectionThread_data,
+    jcon_system_connectionThread_create,
+    jcon_system_connectionThread_close,
+    session->logger,
+    new_connection
+  );
+  if(new_connection->thread == NULL)
+  {
+    ERROR(session, "jcon_thread_init() failed.");
+    jcon_system_pool_put(session, new_connection);
+    return false;
+  }
+
+  if(jcon_system_registry_insert(session, new_connection) == false)
+  {
+    ERROR(session, "jcon_system_registry_insert() failed.");
+    jcon_thread_free(new_connection->thread);
+    jcon_system_pool_put(session, new_connection);
+    return false;
+  }
+
+  JUTIL_METRICS_GAUGE_ADD("jcon_system_connections", "Open connections.", 1);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_freeConnection(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(connection == NULL)
+  {
+    ERROR(session, "Connection is NULL.");
+    return;
+  }
+
+  if(jcon_system_registry_remove(session, connection) == false)
+  {
+    ERROR(session, "Connection not found in registry.");
+  }
+
+  if(connection->thread)
+  {
+    jcon_thread_free(connection->thread);
+  }
+  if(connection->client)
+  {
+    DEBUG(session, "Freeing client [%s].", jcon_client_getReferenceString(connection->client));
+    jcon_client_session_free(connection->client);
+  }
+
+  if(connection->hibernated)
+  {
+    atomic_fetch_sub(&session->idle_number, 1);
+    JUTIL_METRICS_GAUGE_ADD("jcon_system_connections_hibernated", "Hibernated connections.", -1);
+  }
+
+  jcon_system_sendQueue_clear(session, connection);
+  jcon_system_pool_put(session, connection);
+
+  JUTIL_METRICS_GAUGE_ADD("jcon_system_connections", "Open connections.", -1);
+}
+
+
+
+//==============================================================================
+// Implement functions for connection pool.
+//
+
+//------------------------------------------------------------------------------
+//
+jcon_system_connection_t *jcon_system_pool_take(jcon_system_t *session)
+{
+  jcon_system_connection_t *connection = NULL;
+
+  pthread_mutex_lock(&session->pool_mutex);
+  if(session->pool)
+  {
+    connection = session->pool;
+    session->pool = connection->hash_next;
+    session->pool_number--;
+  }
+  pthread_mutex_unlock(&session->pool_mutex);
+
+  if(connection)
+  {
+    return connection;
+  }
+
+  connection = (jcon_system_connection_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_system_connection_t));
+  if(connection == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    return NULL;
+  }
+
+  int error = pthread_mutex_init(&connection->send_mutex, NULL);
+  if(error)
+  {
+    ERROR(session, "pthread_mutex_init() failed [%d : %s].", error, strerror(error));
+    JUTIL_ALLOC_FREE(connection);
+    return NULL;
+  }
+
+  return connection;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_pool_put(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  pthread_mutex_lock(&session->pool_mutex);
+  if(session->pool_number < session->pool_size)
+  {
+    connection->hash_next = session->pool;
+    session->pool = connection;
+    session->pool_number++;
+    connection = NULL;
+  }
+  pthread_mutex_unlock(&session->pool_mutex);
+
+  if(connection)
+  {
+    pthread_mutex_destroy(&connection->send_mutex);
+    JUTIL_ALLOC_FREE(connection);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_pool_trim(jcon_system_t *session, size_t size)
+{
+  while(session->pool_number > size)
+  {
+    jcon_system_connection_t *connection = session->pool;
+    session->pool = connection->hash_next;
+    session->pool_number--;
+
+    pthread_mutex_destroy(&connection->send_mutex);
+    JUTIL_ALLOC_FREE(connection);
+  }
+}
+
+
+
+//==============================================================================
+// Implement functions for connection registry.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_registry_insert(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  jcon_system_registry_t *registry = &session->connections;
+  size_t number = atomic_load(&registry->number);
+
+  if(number == registry->slot_capacity)
+  {
+    size_t new_capacity = (registry->slot_capacity ? registry->slot_capacity * 2 : JCON_SYSTEM_REGISTRY_SIZE_INITIAL);
+    jcon_system_connection_t **new_slots = (jcon_system_connection_t **)JUTIL_ALLOC_REALLOC(registry->slots, new_capacity * sizeof(jcon_system_connection_t *));
+    if(new_slots == NULL)
+    {
+      ERROR(session, "realloc() failed.");
+      return false;
+    }
+
+    registry->slots = new_slots;
+    registry->slot_capacity = new_capacity;
+  }
+
+  if(number >= registry->bucket_number)
+  {
+    /* Keep chains short by rehashing into twice the buckets. */
+    size_t new_number = (registry->bucket_number ? registry->bucket_number * 2 : JCON_SYSTEM_REGISTRY_SIZE_INITIAL);
+    jcon_system_connection_t **new_buckets = (jcon_system_connection_t **)JUTIL_ALLOC_CALLOC(new_number, sizeof(jcon_system_connection_t *));
+    if(new_buckets == NULL)
+    {
+      ERROR(session, "calloc() failed.");
+      return false;
+    }
+
+    size_t i;
+    for(i = 0; i < number; i++)
+    {
+      jcon_system_connection_t *itr = registry->slots[i];
+      size_t bucket = itr->hash & (new_number - 1);
+      itr->hash_next = new_buckets[bucket];
+      new_buckets[bucket] = itr;
+    }
+
+    JUTIL_ALLOC_FREE(registry->buckets);
+    registry->buckets = new_buckets;
+    registry->bucket_number = new_number;
+  }
+
+  connection->slot = number;
+  registry->slots[number] = connection;
+
+  connection->hash = jcon_system_registry_hash(registry, jcon_client_getReferenceString(connection->client));
+  size_t bucket = connection->hash & (registry->bucket_number - 1);
+  connection->hash_next = registry->buckets[bucket];
+  registry->buckets[bucket] = connection;
+
+  atomic_store(&registry->number, number + 1);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_registry_remove(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  jcon_system_registry_t *registry = &session->connections;
+  size_t number = atomic_load(&registry->number);
+
+  if(connection->slot >= number || registry->slots[connection->slot] != connection)
+  {
+    return false;
+  }
+
+  jcon_system_connection_t **itr = &registry->buckets[connection->hash & (registry->bucket_number - 1)];
+  while(*itr != NULL && *itr != connection)
+  {
+    itr = &(*itr)->hash_next;
+  }
+  if(*itr)
+  {
+    *itr = connection->hash_next;
+  }
+
+  /* Move last connection into free slot. */
+  jcon_system_connection_t *last = registry->slots[number - 1];
+  registry->slots[connection->slot] = last;
+  last->slot = connection->slot;
+
+  atomic_store(&registry->number, number - 1);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_system_connection_t *jcon_system_registry_find(jcon_system_t *session, const char *reference_string)
+{
+  jcon_system_registry_t *registry = &session->connections;
+
+  if(registry->bucket_number == 0)
+  {
+    return NULL;
+  }
+
+  uint32_t hash = jcon_system_registry_hash(registry, reference_string);
+  jcon_system_connection_t *itr = registry->buckets[hash & (registry->bucket_number - 1)];
+
+  while(itr != NULL)
+  {
+    if(itr->hash == hash && strcmp(jcon_client_getReferenceString(itr->client), reference_string) == 0)
+    {
+      return itr;
+    }
+    itr = itr->hash_next;
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_registry_free(jcon_system_t *session)
+{
+  JUTIL_ALLOC_FREE(session->connections.slots);
+  JUTIL_ALLOC_FREE(session->connections.buckets);
+
+  session->connections.slots = NULL;
+  session->connections.slot_capacity = 0;
+  session->connections.buckets = NULL;
+  session->connections.bucket_number = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+uint32_t jcon_system_registry_hash(jcon_system_registry_t *registry, const char *reference_string)
+{
+  uint64_t hash = jutil_hash64_str(reference_string, registry->seed);
+  return (uint32_t)(hash ^ (hash >> 32));
+}
+
+
+
+//==============================================================================
+// Implement functions for event loop mode.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_createLoops(jcon_system_t *session, size_t loop_number)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  session->loops = (jcon_system_loop_t *)JUTIL_ALLOC_MALLOC(loop_number * sizeof(jcon_system_loop_t));
+  if(session->loops == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    return false;
+  }
+
+  size_t i;
+  for(i = 0; i < loop_number; i++)
+  {
+    jcon_system_loop_t *loop = &session->loops[i];
+    loop->system = session;
+    loop->run_signal = true;
+    loop->closed = NULL;
+    loop->listener = NULL;
+    loop->owns_listener = false;
+    loop->listening = false;
+    loop->idle_checked = 0;
+
+    loop->event_loop = jcon_eventLoop_init(session->logger);
+    if(loop->event_loop == NULL)
+    {
+      ERROR(session, "jcon_eventLoop_init() failed.");
+      session->loop_number = i;
+      jcon_system_freeLoops(session);
+      return false;
+    }
+
+    loop->thread = jutil_thread_init
+    (
+      jcon_system_eventLoop_function,
+      session->logger,
+      0,
+      0,
+      loop
+    );
+    if(loop->thread == NULL)
+    {
+      ERROR(session, "jutil_thread_init() failed.");
+      jcon_eventLoop_free(loop->event_loop);
+      session->loop_number = i;
+      jcon_system_freeLoops(session);
+      return false;
+    }
+  }
+
+  session->loop_number = loop_number;
+  session->control_thread = session->loops[0].thread;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_startEventLoops(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(jcon_system_isServerOpen(session) == false)
+  {
+    if(jcon_system_resetServer(session) == false)
+    {
+      ERROR(session, "jcon_system_resetServer() failed.");
+      return false;
+    }
+  }
+
+  size_t i;
+  for(i = 0; i < session->loop_number; i++)
+  {
+    jcon_system_loop_t *loop = &session->loops[i];
+
+    if(i == 0)
+    {
+      loop->listener = session->server;
+    }
+    else if(session->multi_acceptor)
+    {
+      loop->listener = jcon_server_cloneListener(session->server);
+      if(loop->listener == NULL)
+      {
+        ERROR(session, "jcon_server_cloneListener() failed for loop [%zu].", i);
+        return false;
+      }
+      loop->owns_listener = true;
+    }
+    else
+    {
+      continue;
+    }
+
+    loop->listener_watcher.file_descriptor = jcon_server_getFileDescriptor(loop->listener);
+    loop->listener_watcher.events = JCON_EVENTLOOP_EVENT_READ;
+    loop->listener_watcher.handler = &jcon_system_server_handler;
+    loop->listener_watcher.ctx = loop;
+
+    if(loop->listener_watcher.file_descriptor < 0)
+    {
+      ERROR(session, "Server does not provide a file descriptor.");
+      return false;
+    }
+
+    if(jcon_eventLoop_add(loop->event_loop, &loop->listener_watcher) == false)
+    {
+      ERROR(session, "jcon_eventLoop_add() failed.");
+      return false;
+    }
+    loop->listening = true;
+  }
+
+  for(i = 0; i < session->loop_number; i++)
+  {
+    if(jutil_thread_start(session->loops[i].thread) == false)
+    {
+      ERROR(session, "jutil_thread_start() failed.");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_freeLoops(jcon_system_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  size_t i;
+
+  for(i = 0; i < session->loop_number; i++)
+  {
+    jutil_thread_lockMutex(session->loops[i].thread);
+    session->loops[i].run_signal = false;
+    jutil_thread_unlockMutex(session->loops[i].thread);
+
+    jcon_eventLoop_wakeup(session->loops[i].event_loop);
+  }
+
+  /* First loop holds the control mutex, so it gets stopped last. */
+  for(i = session->loop_number; i > 0; i--)
+  {
+    jutil_thread_free(session->loops[i - 1].thread);
+    jcon_eventLoop_free(session->loops[i - 1].event_loop);
+    jutil_linkedlist_free(&session->loops[i - 1].closed);
+    if(session->loops[i - 1].owns_listener)
+    {
+      jcon_server_free(session->loops[i - 1].listener);
+    }
+  }
+
+  JUTIL_ALLOC_FREE(session->loops);
+  session->loops = NULL;
+  session->loop_number = 0;
+  session->control_thread = NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_eventLoop_function(void *ctx, jutil_thread_t *thread_handler)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  if(thread_handler == NULL)
+  {
+    ERROR(NULL, "thread_handler is NULL.");
+    return false;
+  }
+
+  jcon_system_loop_t *loop = (jcon_system_loop_t *)ctx;
+  int ret;
+
+  if(jcon_eventLoop_run(loop->event_loop, JCON_SYSTEM_EVENTLOOP_TIMEOUT_DEFAULT) < 0)
+  {
+    ERROR(loop->system, "jcon_eventLoop_run() failed.");
+  }
+
+  if(loop->system->worker_number > 0)
+  {
+    jcon_system_eventLoop_removeClosed(loop);
+  }
+
+  if(loop->system->send_evict_timeout > 0 && atomic_load(&loop->system->send_over) > 0)
+  {
+    jcon_system_eventLoop_evictSlow(loop);
+  }
+
+  if(atomic_load(&loop->system->idle_timeout) > 0)
+  {
+    long now = jcon_system_getTime();
+    if(now - loop->idle_checked >= JCON_SYSTEM_IDLE_INTERVAL)
+    {
+      loop->idle_checked = now;
+      jcon_system_eventLoop_hibernateIdle(loop);
+    }
+  }
+
+  /* Listener is removed by its own loop, while no event of it is dispatched. */
+  if(loop->listening && atomic_load(&loop->system->accepting) == false)
+  {
+    jcon_eventLoop_remove(loop->event_loop, &loop->listener_watcher);
+    jcon_server_close(loop->listener);
+    loop->listening = false;
+  }
+
+  jutil_thread_lockMutex(thread_handler);
+  ret = loop->run_signal;
+  jutil_thread_unlockMutex(thread_handler);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_server_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events)
+{
+  jcon_system_loop_t *accept_loop = (jcon_system_loop_t *)watcher->ctx;
+  jcon_system_t *session = accept_loop->system;
+
+  if(events & (JCON_EVENTLOOP_EVENT_ERROR | JCON_EVENTLOOP_EVENT_HANGUP))
+  {
+    ERROR(session, "Error on listening socket.");
+    return;
+  }
+
+  /* Accepted connections stay on their loop, so the kernel spreads the load. */
+  size_t accepted = jcon_system_acceptConnections(session, accept_loop->listener, (session->multi_acceptor ? accept_loop : NULL));
+
+  jutil_thread_lockMutex(session->control_thread);
+  session->last_accepted = accepted;
+  jutil_thread_unlockMutex(session->control_thread);
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_connection_handler(jcon_eventLoop_t *loop, jcon_eventLoop_watcher_t *watcher, int events)
+{
+  jcon_system_connection_t *connection = (jcon_system_connection_t *)watcher->ctx;
+  jcon_system_t *session = connection->loop->system;
+
+  /* Hibernated connections are never in a worker, so the handler runs alone. */
+  if(events & JCON_EVENTLOOP_EVENT_READ)
+  {
+    connection->idle_since = jcon_system_getTime();
+    if(connection->hibernated)
+    {
+      jcon_system_eventLoop_wakeIdle(session, connection);
+    }
+  }
+
+  pthread_mutex_lock(&connection->send_mutex);
+  if(connection->in_worker)
+  {
+    /* Watcher was rearmed by broadcast before worker took it. Worker rearms it again. */
+    pthread_mutex_unlock(&connection->send_mutex);
+    return;
+  }
+
+  int drained = false;
+  /* Transports without write events (jcon_client_shm) become readable, when the peer made room. */
+  if((events & JCON_EVENTLOOP_EVENT_WRITE) || ((events & JCON_EVENTLOOP_EVENT_READ) && connection->send_head))
+  {
+    drained = jcon_system_sendQueue_flush(session, connection);
+  }
+
+  if(session->worker_number > 0 && (events & JCON_EVENTLOOP_EVENT_READ))
+  {
+    /* Watcher is disabled (oneshot) until the worker rearms it. */
+    connection->in_worker = true;
+    pthread_mutex_unlock(&connection->send_mutex);
+
+    if(drained)
+    {
+      jcon_system_sendQueue_notify(session, connection, false);
+    }
+
+    if(jcon_system_workQueue_push(session, connection) == false)
+    {
+      DEBUG(session, "Work queue stopped.");
+    }
+    return;
+  }
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  if(drained)
+  {
+    jcon_system_sendQueue_notify(session, connection, false);
+  }
+
+  if(events & JCON_EVENTLOOP_EVENT_READ)
+  {
+    if(session->data_handler)
+    {
+      unsigned long long handler_start = JUTIL_METRICS_NOW();
+      session->data_handler(session->session_context, connection->client);
+      JUTIL_METRICS_HISTOGRAM_SINCE("jcon_system_handler_seconds", "Duration of data handler calls.", handler_start);
+    }
+  }
+
+  if(events & (JCON_EVENTLOOP_EVENT_ERROR | JCON_EVENTLOOP_EVENT_HANGUP))
+  {
+    DEBUG(session, "Connection error or hangup [%s].", jcon_client_getReferenceString(connection->client));
+    jcon_system_eventLoop_removeConnection(session, connection);
+    return;
+  }
+
+  if(jcon_client_isConnected(connection->client) == false)
+  {
+    DEBUG(session, "Client disconnect [%s].", jcon_client_getReferenceString(connection->client));
+    jcon_system_eventLoop_removeConnection(session, connection);
+    return;
+  }
+
+  pthread_mutex_lock(&connection->send_mutex);
+  int ret_rearm = jcon_system_sendQueue_rearm(session, connection);
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  if(ret_rearm == false)
+  {
+    ERROR(session, "jcon_system_sendQueue_rearm() failed. Closing connection.");
+    jcon_system_eventLoop_removeConnection(session, connection);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_eventLoop_addConnection(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  int fd = jcon_client_getFileDescriptor(connection->client);
+  if(fd < 0)
+  {
+    ERROR(session, "Client does not provide a file descriptor.");
+    return false;
+  }
+
+  if(connection->loop == NULL)
+  {
+    /* Only the thread of the first loop accepts, so no lock needed. */
+    connection->loop = &session->loops[session->loop_next];
+    session->loop_next = (session->loop_next + 1) % session->loop_number;
+  }
+
+  connection->watcher.file_descriptor = fd;
+  connection->watcher.events = JCON_EVENTLOOP_EVENT_READ;
+  if(session->worker_number > 0)
+  {
+    connection->watcher.events |= JCON_EVENTLOOP_EVENT_ONESHOT;
+  }
+  connection->watcher.handler = &jcon_system_connection_handler;
+  connection->watcher.ctx = connection;
+
+  jutil_thread_lockMutex(session->control_thread);
+  int ret_insert = jcon_system_registry_insert(session, connection);
+  jutil_thread_unlockMutex(session->control_thread);
+
+  if(ret_insert == false)
+  {
+    ERROR(session, "jcon_system_registry_insert() failed.");
+    return false;
+  }
+
+  if(session->create_handler)
+  {
+    session->create_handler(session->session_context, jcon_client_getReferenceString(connection->client));
+  }
+
+  /* From here on the connection belongs to the loop thread. */
+  if(jcon_eventLoop_add(connection->loop->event_loop, &connection->watcher) == false)
+  {
+    ERROR(session, "jcon_eventLoop_add() failed.");
+
+    jutil_thread_lockMutex(session->control_thread);
+    jcon_system_registry_remove(session, connection);
+    jutil_thread_unlockMutex(session->control_thread);
+
+    if(session->close_handler)
+    {
+      session->close_handler(session->session_context, jcon_client_getReferenceString(connection->client));
+    }
+    return false;
+  }
+
+  /* Broadcasts, that were queued before registration, need write events. */
+  pthread_mutex_lock(&connection->send_mutex);
+  connection->registered = true;
+  if(connection->send_head)
+  {
+    jcon_system_sendQueue_rearm(session, connection);
+  }
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_eventLoop_removeConnection(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  /* Broadcasts must not modify the watcher anymore. */
+  pthread_mutex_lock(&connection->send_mutex);
+  connection->registered = false;
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  if(jcon_client_isConnected(connection->client) == false)
+  {
+    /* Descriptor is closed, number might already be reused. */
+    connection->watcher.file_descriptor = -1;
+  }
+  jcon_eventLoop_remove(connection->loop->event_loop, &connection->watcher);
+
+  if(session->close_handler)
+  {
+    session->close_handler(session->session_context, jcon_client_getReferenceString(connection->client));
+  }
+
+  jutil_thread_lockMutex(session->control_thread);
+  jcon_system_freeConnection(session, connection);
+  jutil_thread_unlockMutex(session->control_thread);
+}
+
+
+
+//==============================================================================
+// Implement functions for worker pool.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_workQueue_init(jcon_system_t *session, size_t queue_depth)
+{
+  jcon_system_workQueue_t *queue = &session->queue;
+
+  queue->jobs = (jcon_system_connection_t **)JUTIL_ALLOC_MALLOC(queue_depth * sizeof(jcon_system_connection_t *));
+  if(queue->jobs == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    return false;
+  }
+
+  queue->size = queue_depth;
+  queue->head = 0;
+  queue->number = 0;
+  queue->run_signal = true;
+
+  int error = pthread_mutex_init(&queue->mutex, NULL);
+  if(error)
+  {
+    ERROR(session, "pthread_mutex_init() failed [%d : %s].", error, strerror(error));
+    JUTIL_ALLOC_FREE(queue->jobs);
+    queue->jobs = NULL;
+    return false;
+  }
+
+  error = pthread_cond_init(&queue->cond_notEmpty, NULL);
+  if(error)
+  {
+    ERROR(session, "pthread_cond_init() failed [%d : %s].", error, strerror(error));
+    pthread_mutex_destroy(&queue->mutex);
+    JUTIL_ALLOC_FREE(queue->jobs);
+    queue->jobs = NULL;
+    return false;
+  }
+
+  error = pthread_cond_init(&queue->cond_notFull, NULL);
+  if(error)
+  {
+    ERROR(session, "pthread_cond_init() failed [%d : %s].", error, strerror(error));
+    pthread_cond_destroy(&queue->cond_notEmpty);
+    pthread_mutex_destroy(&queue->mutex);
+    JUTIL_ALLOC_FREE(queue->jobs);
+    queue->jobs = NULL;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_workQueue_free(jcon_system_t *session)
+{
+  jcon_system_workQueue_t *queue = &session->queue;
+
+  pthread_cond_destroy(&queue->cond_notFull);
+  pthread_cond_destroy(&queue->cond_notEmpty);
+  pthread_mutex_destroy(&queue->mutex);
+
+  JUTIL_ALLOC_FREE(queue->jobs);
+  queue->jobs = NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_workQueue_stop(jcon_system_t *session)
+{
+  jcon_system_workQueue_t *queue = &session->queue;
+
+  pthread_mutex_lock(&queue->mutex);
+  queue->run_signal = false;
+  pthread_cond_broadcast(&queue->cond_notEmpty);
+  pthread_cond_broadcast(&queue->cond_notFull);
+  pthread_mutex_unlock(&queue->mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_workQueue_push(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  jcon_system_workQueue_t *queue = &session->queue;
+
+  pthread_mutex_lock(&queue->mutex);
+
+  /* Full queue throttles the loop, so clients get read slower. */
+  while(queue->number == queue->size && queue->run_signal)
+  {
+    pthread_cond_wait(&queue->cond_notFull, &queue->mutex);
+  }
+
+  if(queue->run_signal == false)
+  {
+    pthread_mutex_unlock(&queue->mutex);
+    return false;
+  }
+
+  queue->jobs[(queue->head + queue->number) % queue->size] = connection;
+  queue->number++;
+
+  pthread_cond_signal(&queue->cond_notEmpty);
+  pthread_mutex_unlock(&queue->mutex);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jcon_system_connection_t *jcon_system_workQueue_pop(jcon_system_t *session)
+{
+  jcon_system_workQueue_t *queue = &session->queue;
+  jcon_system_connection_t *connection;
+
+  pthread_mutex_lock(&queue->mutex);
+
+  while(queue->number == 0 && queue->run_signal)
+  {
+    pthread_cond_wait(&queue->cond_notEmpty, &queue->mutex);
+  }
+
+  if(queue->run_signal == false)
+  {
+    pthread_mutex_unlock(&queue->mutex);
+    return NULL;
+  }
+
+  connection = queue->jobs[queue->head];
+  queue->head = (queue->head + 1) % queue->size;
+  queue->number--;
+
+  pthread_cond_signal(&queue->cond_notFull);
+  pthread_mutex_unlock(&queue->mutex);
+
+  return connection;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_createWorkers(jcon_system_t *session, size_t worker_number)
+{
+  session->workers = (jcon_system_worker_t *)JUTIL_ALLOC_MALLOC(worker_number * sizeof(jcon_system_worker_t));
+  if(session->workers == NULL)
+  {
+    ERROR(session, "malloc() failed.");
+    return false;
+  }
+
+  size_t i;
+  for(i = 0; i < worker_number; i++)
+  {
+    jcon_system_worker_t *worker = &session->workers[i];
+    worker->system = session;
+    worker->index = i;
+    worker->pinned = false;
+
+    worker->thread = jutil_thread_init
+    (
+      jcon_system_worker_function,
+      session->logger,
+      0,
+      0,
+      worker
+    );
+    if(worker->thread == NULL)
+    {
+      ERROR(session, "jutil_thread_init() failed.");
+      session->worker_number = i;
+      jcon_system_freeWorkers(session);
+      return false;
+    }
+  }
+
+  session->worker_number = worker_number;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_freeWorkers(jcon_system_t *session)
+{
+  size_t i;
+  for(i = 0; i < session->worker_number; i++)
+  {
+    jutil_thread_free(session->workers[i].thread);
+  }
+
+  JUTIL_ALLOC_FREE(session->workers);
+  session->workers = NULL;
+  session->worker_number = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_worker_function(void *ctx, jutil_thread_t *thread_handler)
+{
+  if(ctx == NULL)
+  {
+    ERROR(NULL, "Context is NULL.");
+    return false;
+  }
+
+  jcon_system_worker_t *worker = (jcon_system_worker_t *)ctx;
+  jcon_system_t *session = worker->system;
+
+  if(worker->pinned == false)
+  {
+    long cpu_number = sysconf(_SC_NPROCESSORS_ONLN);
+    if(cpu_number > 0)
+    {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(worker->index % cpu_number, &cpu_set);
+
+      int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+      if(error)
+      {
+        WARN(session, "pthread_setaffinity_np() failed [%d : %s].", error, strerror(error));
+      }
+    }
+    worker->pinned = true;
+  }
+
+  jcon_system_connection_t *connection = jcon_system_workQueue_pop(session);
+  if(connection == NULL)
+  {
+    return false;
+  }
+
+  if(session->data_handler)
+  {
+    unsigned long long handler_start = JUTIL_METRICS_NOW();
+    session->data_handler(session->session_context, connection->client);
+    JUTIL_METRICS_HISTOGRAM_SINCE("jcon_system_handler_seconds", "Duration of data handler calls.", handler_start);
+  }
+
+  if(jcon_client_isConnected(connection->client))
+  {
+    pthread_mutex_lock(&connection->send_mutex);
+    connection->in_worker = false;
+    int ret_rearm = jcon_system_sendQueue_rearm(session, connection);
+    if(ret_rearm == false)
+    {
+      /* Keep broadcasts from touching the watcher until the loop removes it. */
+      connection->in_worker = true;
+    }
+    pthread_mutex_unlock(&connection->send_mutex);
+
+    if(ret_rearm)
+    {
+      return true;
+    }
+
+    ERROR(session, "jcon_system_sendQueue_rearm() failed. Closing connection.");
+  }
+
+  /* Removal has to be done by thread of loop. */
+  jutil_thread_lockMutex(connection->loop->thread);
+  int ret_append = jutil_linkedlist_append(&connection->loop->closed, (void *)connection);
+  jutil_thread_unlockMutex(connection->loop->thread);
+
+  if(ret_append == false)
+  {
+    ERROR(session, "jutil_linkedlist_append() failed.");
+  }
+
+  jcon_eventLoop_wakeup(connection->loop->event_loop);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_eventLoop_removeClosed(jcon_system_loop_t *loop)
+{
+  jutil_linkedlist_t *closed;
+
+  jutil_thread_lockMutex(loop->thread);
+  closed = loop->closed;
+  loop->closed = NULL;
+  jutil_thread_unlockMutex(loop->thread);
+
+  while(closed != NULL)
+  {
+    jcon_system_connection_t *connection = (jcon_system_connection_t *)jutil_linkedlist_pop(&closed);
+    if(connection)
+    {
+      jcon_system_eventLoop_removeConnection(loop->system, connection);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_eventLoop_evictSlow(jcon_system_loop_t *loop)
+{
+  jcon_system_t *session = loop->system;
+  jutil_linkedlist_t *evicted = NULL;
+
+  jutil_thread_lockMutex(session->control_thread);
+
+  size_t number = atomic_load(&session->connections.number);
+  for(size_t i = 0; i < number; i++)
+  {
+    jcon_system_connection_t *connection = session->connections.slots[i];
+    if(connection->loop != loop)
+    {
+      continue;
+    }
+
+    /* Connections handled by workers are checked again next time. */
+    pthread_mutex_lock(&connection->send_mutex);
+    int expired = (connection->in_worker == false && jcon_system_sendQueue_expired(session, connection));
+    pthread_mutex_unlock(&connection->send_mutex);
+
+    if(expired)
+    {
+      WARN(session, "Closing slow connection [%s].", jcon_client_getReferenceString(connection->client));
+      if(jutil_linkedlist_append(&evicted, (void *)connection) == false)
+      {
+        ERROR(session, "jutil_linkedlist_append() failed.");
+      }
+    }
+  }
+
+  jutil_thread_unlockMutex(session->control_thread);
+
+  /* Removal takes control mutex itself. */
+  while(evicted != NULL)
+  {
+    jcon_system_connection_t *connection = (jcon_system_connection_t *)jutil_linkedlist_pop(&evicted);
+    if(connection)
+    {
+      jcon_system_eventLoop_removeConnection(session, connection);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_eventLoop_hibernateIdle(jcon_system_loop_t *loop)
+{
+  jcon_system_t *session = loop->system;
+  jutil_linkedlist_t *idle = NULL;
+  long idle_timeout = atomic_load(&session->idle_timeout);
+  long now = jcon_system_getTime();
+
+  jutil_thread_lockMutex(session->control_thread);
+  jcon_system_idle_handler_t handler = session->idle_handler;
+
+  size_t number = atomic_load(&session->connections.number);
+  for(size_t i = 0; i < number; i++)
+  {
+    jcon_system_connection_t *connection = session->connections.slots[i];
+    if(connection->loop != loop || connection->hibernated || now - connection->idle_since < idle_timeout)
+    {
+      continue;
+    }
+
+    /* Connections with queued data or in a worker are checked again next time. */
+    pthread_mutex_lock(&connection->send_mutex);
+    int ready = (connection->in_worker == false && connection->send_head == NULL);
+    pthread_mutex_unlock(&connection->send_mutex);
+
+    if(ready)
+    {
+      if(jutil_linkedlist_append(&idle, (void *)connection) == false)
+      {
+        ERROR(session, "jutil_linkedlist_append() failed.");
+      }
+    }
+  }
+
+  jutil_thread_unlockMutex(session->control_thread);
+
+  /* Only this thread removes or dispatches connections of the loop, so they stay valid. */
+  size_t hibernated = 0;
+  while(idle != NULL)
+  {
+    jcon_system_connection_t *connection = (jcon_system_connection_t *)jutil_linkedlist_pop(&idle);
+    if(connection == NULL)
+    {
+      continue;
+    }
+
+    connection->hibernated = true;
+    hibernated++;
+
+    if(handler)
+    {
+      handler(session->session_context, connection->client, true);
+    }
+  }
+
+  if(hibernated > 0)
+  {
+    atomic_fetch_add(&session->idle_number, hibernated);
+    JUTIL_METRICS_GAUGE_ADD("jcon_system_connections_hibernated", "Hibernated connections.", (long long)hibernated);
+    DEBUG(session, "Hibernated [%zu] idle connections.", hibernated);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jcon_system_eventLoop_wakeIdle(jcon_system_t *session, jcon_system_connection_t *connection)
+{
+  connection->hibernated = false;
+  atomic_fetch_sub(&session->idle_number, 1);
+  JUTIL_METRICS_GAUGE_ADD("jcon_system_connections_hibernated", "Hibernated connections.", -1);
+
+  jutil_thread_lockMutex(session->control_thread);
+  jcon_system_idle_handler_t handler = session->idle_handler;
+  jutil_thread_unlockMutex(session->control_thread);
+
+  if(handler)
+  {
+    handler(session->session_context, connection->client, false);
+  }
+}
+
+
+
+//==============================================================================
+// Implement functions for send queues.
+//
+
+//------------------------------------------------------------------------------
+//
+int jcon_system_sendQueue_push(jcon_system_t *session, jcon_system_connection_t *connection, jutil_buffer_t *buffer)
+{
+  if(jcon_client_isConnected(connection->client) == false)
+  {
+    return false;
+  }
+
+  pthread_mutex_lock(&connection->send_mutex);
+
+  if(connection->send_over)
+  {
+    pthread_mutex_unlock(&connection->send_mutex);
+    return false;
+  }
+
+  jcon_system_sendEntry_t *entry = (jcon_system_sendEntry_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_system_sendEntry_t));
+  if(entry == NULL)
+  {
+    pthread_mutex_unlock(&connection->send_mutex);
+    ERROR(session, "malloc() failed.");
+    return false;
+  }
+
+  entry->buffer = jutil_buffer_ref(buffer);
+  entry->size = jutil_buffer_getSize(buffer);
+  entry->offset = 0;
+  entry->next = NULL;
 
-  free(session);
-}
+  if(connection->send_tail)
+  {
+    connection->send_tail->next = entry;
+    connection->send_tail = entry;
+  }
+  else
+  {
+    connection->send_head = entry;
+    connection->send_tail = entry;
+    atomic_fetch_add(&session->send_pending, 1);
 
-//------------------------------------------------------------------------------
-//
-const char *jcon_system_getConnectionType(jcon_system_t *session)
-{
-  if(session == NULL)
+    if(jcon_system_sendQueue_rearm(session, connection) == false)
+    {
+      /* Data stays queued, next event of connection retries. */
+      ERROR(session, "jcon_system_sendQueue_rearm() failed.");
+    }
+  }
+  connection->send_bytes += entry->size;
+
+  int over = false;
+  if(session->send_high > 0 && connection->send_bytes >= session->send_high)
   {
-    ERROR(NULL, "Session is NULL.");
-    return NULL;
+    connection->send_over = true;
+    connection->send_over_since = jcon_system_getTime();
+    atomic_fetch_add(&session->send_over, 1);
+    over = true;
   }
 
-  if(session->server == NULL)
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  if(over)
   {
-    ERROR(NULL, "Server is NULL.");
-    return NULL;
+    jcon_system_sendQueue_notify(session, connection, true);
   }
 
-  return jcon_server_getConnectionType(session->server);
+  return true;
 }
 
 //------------------------------------------------------------------------------
 //
-const char *jcon_system_getReferenceString(jcon_system_t *session)
+int jcon_system_sendQueue_flush(jcon_system_t *session, jcon_system_connection_t *connection)
 {
-  if(session == NULL)
+  while(connection->send_head)
   {
-    ERROR(NULL, "Session is NULL.");
-    return NULL;
+    struct iovec iov[JCON_SYSTEM_SEND_IOV_MAX];
+    int iov_count = 0;
+    size_t total = 0;
+
+    for(jcon_system_sendEntry_t *entry = connection->send_head; entry && iov_count < JCON_SYSTEM_SEND_IOV_MAX; entry = entry->next)
+    {
+      int segments = jutil_buffer_getIovec(entry->buffer, entry->offset, iov + iov_count, JCON_SYSTEM_SEND_IOV_MAX - iov_count);
+      for(int i = 0; i < segments; i++)
+      {
+        total += iov[iov_count + i].iov_len;
+      }
+      iov_count += segments;
+    }
+
+    size_t sent = jcon_client_trySendDataV(connection->client, iov, iov_count);
+    if(sent == 0)
+    {
+      /* Send buffer full or client disconnected. */
+      break;
+    }
+    connection->send_bytes -= sent;
+
+    size_t left = sent;
+    while(left > 0)
+    {
+      jcon_system_sendEntry_t *entry = connection->send_head;
+      size_t remaining = entry->size - entry->offset;
+
+      if(left < remaining)
+      {
+        entry->offset += left;
+        break;
+      }
+
+      left -= remaining;
+      connection->send_head = entry->next;
+      jutil_buffer_free(entry->buffer);
+      JUTIL_ALLOC_FREE(entry);
+    }
+
+    if(connection->send_head == NULL)
+    {
+      connection->send_tail = NULL;
+      atomic_fetch_sub(&session->send_pending, 1);
+    }
+
+    if(sent < total)
+    {
+      break;
+    }
   }
 
-  if(session->server == NULL)
+  if(connection->send_over && connection->send_bytes <= session->send_low)
   {
-    ERROR(NULL, "Server is NULL.");
-    return NULL;
+    connection->send_over = false;
+    atomic_fetch_sub(&session->send_over, 1);
+    return true;
   }
 
-  return jcon_server_getReferenceString(session->server);
+  return false;
 }
 
 //------------------------------------------------------------------------------
 //
-int jcon_system_isServerOpen(jcon_system_t *session)
+void jcon_system_sendQueue_notify(jcon_system_t *session, jcon_system_connection_t *connection, int over)
 {
-  if(session == NULL)
+  if(over)
   {
-    ERROR(NULL, "Session is NULL.");
-    return false;
+    DEBUG(session, "Send queue reached high watermark [%s].", jcon_client_getReferenceString(connection->client));
   }
-
-  if(session->server == NULL)
+  else
   {
-    ERROR(NULL, "Server is NULL.");
-    return false;
+    DEBUG(session, "Send queue dropped to low watermark [%s].", jcon_client_getReferenceString(connection->client));
   }
 
-  return jcon_server_isOpen(session->server);
+  if(session->watermark_handler)
+  {
+    session->watermark_handler(session->session_context, jcon_client_getReferenceString(connection->client), over);
+  }
 }
 
 //------------------------------------------------------------------------------
 //
-int jcon_system_control_isRunning(jcon_system_t *session)
+int jcon_system_sendQueue_expired(jcon_system_t *session, jcon_system_connection_t *connection)
 {
-  if(session == NULL)
+  if(session->send_evict_timeout <= 0 || connection->send_over == false)
   {
-    ERROR(NULL, "Session is NULL.");
     return false;
   }
 
-  return jutil_thread_isRunning(session->control_thread);
+  return (jcon_system_getTime() - connection->send_over_since >= session->send_evict_timeout);
 }
 
 //------------------------------------------------------------------------------
 //
-size_t jcon_system_getConnectionNumber(jcon_system_t *session)
+long jcon_system_getTime(void)
 {
-  if(session == NULL)
-  {
-    ERROR(NULL, "Session is NULL.");
-    return 0;
-  }
-
-  size_t ret;
-
-  jutil_thread_lockMutex(session->control_thread);
-  ret = jutil_linkedlist_size(&session->connections);
-  jutil_thread_unlockMutex(session->control_thread);
-
-  return ret;
+  /* Only used for eviction and idle timeouts, kernel tick is precise enough. */
+  return (long)jutil_time_getCoarseMillis();
 }
 
-
-
-//==============================================================================
-// Implement functions for control thread.
-//
-
 //------------------------------------------------------------------------------
 //
-int jcon_system_control_function(void *ctx, jutil_thread_t *thread_handler)
+void jcon_system_sendQueue_clear(jcon_system_t *session, jcon_system_connection_t *connection)
 {
-  if(ctx == NULL)
+  if(connection->send_head)
   {
-    ERROR(NULL, "Context is NULL.");
-    return false;
+    atomic_fetch_sub(&session->send_pending, 1);
   }
-
-  if(thread_handler == NULL)
+  if(connection->send_over)
   {
-    ERROR(NULL, "thread_handler is NULL.");
-    return false;
+    atomic_fetch_sub(&session->send_over, 1);
+    connection->send_over = false;
   }
 
-  jcon_system_t *session = (jcon_system_t *)ctx;
-  int ret = true;
-
-  /* Check for closed connections. */
-  jutil_thread_lockMutex(thread_handler);
-  jcon_system_cleanupConnections(session);
-  jutil_thread_unlockMutex(thread_handler);
-
-  /* Check for new connections. */
-  jutil_thread_lockMutex(thread_handler);
-  jcon_system_checkForConnections(session);
-  jutil_thread_unlockMutex(thread_handler);
+  while(connection->send_head)
+  {
+    jcon_system_sendEntry_t *entry = connection->send_head;
+    connection->send_head = entry->next;
+    jutil_buffer_free(entry->buffer);
+    JUTIL_ALLOC_FREE(entry);
+  }
 
-  return ret;
+  connection->send_tail = NULL;
+  connection->send_bytes = 0;
 }
 
-
-
-//==============================================================================
-// Implement functions for server control.
-//
-
 //------------------------------------------------------------------------------
 //
-int jcon_system_resetServer(jcon_system_t *session)
+int jcon_system_sendQueue_rearm(jcon_system_t *session, jcon_system_connection_t *connection)
 {
-  if(session == NULL)
+  if(session->mode != JCON_SYSTEM_MODE_EVENTLOOP)
   {
-    ERROR(NULL, "Session is NULL.");
-    return false;
+    return true;
   }
 
-  if(session->server == NULL)
+  if(connection->registered == false || connection->in_worker)
   {
-    ERROR(NULL, "Server is NULL.");
-    return false;
+    return true;
   }
 
-  int ret;
-  jutil_thread_lockMutex(session->control_thread);
-  ret = jcon_server_reset(session->server);
-  jutil_thread_unlockMutex(session->control_thread);
+  int events = JCON_EVENTLOOP_EVENT_READ;
+  if(connection->send_head)
+  {
+    events |= JCON_EVENTLOOP_EVENT_WRITE;
+  }
 
-  if(ret == false)
+  if(session->worker_number > 0)
   {
-    ERROR(session, "jcon_server_reset() failed.");
+    /* Oneshot watchers have to be rearmed every time. */
+    events |= JCON_EVENTLOOP_EVENT_ONESHOT;
+  }
+  else if(events == connection->watcher.events)
+  {
+    return true;
   }
 
-  return ret;
+  return jcon_eventLoop_modify(connection->loop->event_loop, &connection->watcher, events);
 }
 
-
-
-//==============================================================================
-// Implement functions for server connections.
-//
-
 //------------------------------------------------------------------------------
 //
-void jcon_system_checkForConnections(jcon_system_t *session)
+void jcon_system_flushConnections(jcon_system_t *session)
 {
-  if(session == NULL)
-  {
-    ERROR(NULL, "Session is NULL.");
-    return;
-  }
+  size_t i = atomic_load(&session->connections.number);
 
-  if(jcon_server_newConnection(session->server))
+  /* Backwards, because freeing moves the last connection into the free slot. */
+  while(i > 0)
   {
-    jcon_client_t *new_client = jcon_server_acceptConnection(session->server);
-    if(new_client)
+    i--;
+    jcon_system_connection_t *connection = session->connections.slots[i];
+
+    pthread_mutex_lock(&connection->send_mutex);
+    int drained = false;
+    if(connection->send_head && connection->in_worker == false)
     {
-      if(jcon_system_addConnection(session, new_client) == false)
-      {
-        ERROR(session, "jcon_system_addConnection() failed.");
-      }
+      drained = jcon_system_sendQueue_flush(session, connection);
     }
-    else
+    int expired = jcon_system_sendQueue_expired(session, connection);
+    pthread_mutex_unlock(&connection->send_mutex);
+
+    if(drained)
+    {
+      jcon_system_sendQueue_notify(session, connection, false);
+    }
+
+    if(expired)
     {
-      ERROR(session, "jcon_server_acceptConnection() failed.");
+      WARN(session, "Closing slow connection [%s].", jcon_client_getReferenceString(connection->client));
+      jcon_system_freeConnection(session, connection);
     }
   }
 }
 
 //------------------------------------------------------------------------------
 //
-void jcon_system_cleanupConnections(jcon_system_t *session)
+int jcon_system_sendQueue_finish(jcon_system_t *session, jcon_system_connection_t *connection, int *drained)
 {
+  int finished = true;
+  jutil_time_deadline_t deadline;
+  jutil_time_deadline_set(&deadline, JCON_SYSTEM_SEND_FINISH_TIMEOUT);
 
-  if(session == NULL)
+  *drained = false;
+
+  pthread_mutex_lock(&connection->send_mutex);
+  while(connection->send_head && connection->send_head->offset > 0)
   {
-    ERROR(NULL, "Session is NULL.");
-    return;
-  }
+    if(jcon_system_sendQueue_flush(session, connection))
+    {
+      *drained = true;
+    }
 
-  jutil_linkedlist_t *itr = session->connections;
+    if(connection->send_head == NULL || connection->send_head->offset == 0)
+    {
+      break;
+    }
 
-  while(itr != NULL)
-  {
-    jcon_system_connection_t *connection = (jcon_system_connection_t *)jutil_linkedlist_getData(itr);
-    if(connection)
+    /* Disconnected or evicted connections are closed anyway. */
+    if(jcon_client_isConnected(connection->client) == false || jcon_system_sendQueue_expired(session, connection))
     {
-      if(jcon_thread_isRunning(connection->thread) == false)
-      {
-        jcon_system_freeConnection(session, itr);
-        break;
-      }
-      else
-      {
-        itr = jutil_linkedlist_iterate(itr);
-      }
+      break;
     }
-    else
+
+    if(jutil_time_deadline_isExpired(&deadline))
     {
-      jutil_linkedlist_removeNode(&session->connections, itr);
+      finished = false;
       break;
     }
+
+    /* Pushes must not wait, while the peer makes room. */
+    pthread_mutex_unlock(&connection->send_mutex);
+    jutil_time_sleep(0, JCON_SYSTEM_SEND_RETRY_INTERVAL * 1000000L, false);
+    pthread_mutex_lock(&connection->send_mutex);
   }
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  return finished;
 }
 
+
+
+//==============================================================================
+// Implement handlers for jcon_thread.
+//
+
 //------------------------------------------------------------------------------
 //
-void jcon_system_clearConnections(jcon_system_t *session)
+void jcon_system_connectionThread_create(void *ctx, int create_type, const char *reference_string)
 {
-  if(session == NULL)
-  {
-    ERROR(NULL, "Session is NULL.");
-    return;
-  }
-
-  jutil_linkedlist_t *itr = session->connections;
-  while(itr != NULL)
-  {
-    DEBUG(session, "Destroying node [%p].", itr);
-    jutil_linkedlist_t *tmp = itr;
-    itr = jutil_linkedlist_iterate(itr);
-    jcon_system_freeConnection(session, tmp);
-  }
 }
 
 //------------------------------------------------------------------------------
 //
-int jcon_system_addConnection(jcon_system_t *session, jcon_client_t *client)
+void jcon_system_connectionThread_close(void *ctx, int close_type, const char *reference_string)
 {
-  if(session == NULL)
-  {
-    ERROR(NULL, "Session is NULL.");
-    return false;
-  }
-
-  if(client == NULL)
-  {
-    ERROR(session, "Client is NULL.");
-    return false;
-  }
-
-  jcon_system_connection_t *new_connection = (jcon_system_connection_t *)malloc(sizeof(jcon_system_connection_t));
-  if(new_connection == NULL)
-  {
-    ERROR(session, "malloc() failed.");
-    return false;
-  }
-
-  new_connection->client = client;
-  new_connection->thread = jcon_thread_init
-  (
-    client,
-    session->data_handler,
-    jcon_system_connectionThread_create,
-    jcon_system_connectionThread_close,
-    session->logger,
-    NULL
-  );
-  if(new_connection->thread == NULL)
-  {
-    ERROR(session, "jcon_thread_init() failed.");
-    free(new_connection);
-    return false;
-  }
-
-  if(jutil_linkedlist_append(&session->connections, (void *)new_connection) == false)
-  {
-    ERROR(session, "jutil_linkedlist_append() failed.");
-    jcon_thread_free(new_connection->thread);
-    return false;
-  }
-
-  return true;
 }
 
 //------------------------------------------------------------------------------
 //
-void jcon_system_freeConnection(jcon_system_t *session, jutil_linkedlist_t *connection_node)
+void jcon_system_connectionThread_data(void *ctx, jcon_client_t *client)
 {
-  if(session == NULL)
+  jcon_system_connection_t *connection = (jcon_system_connection_t *)ctx;
+  jcon_system_t *session = connection->system;
+
+  pthread_mutex_lock(&connection->send_mutex);
+  connection->in_worker = true;
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  int drained = false;
+  int finished = jcon_system_sendQueue_finish(session, connection, &drained);
+
+  if(drained)
   {
-    ERROR(NULL, "Session is NULL.");
-    return;
+    jcon_system_sendQueue_notify(session, connection, false);
   }
 
-  if(connection_node == NULL)
+  if(finished == false)
   {
-    ERROR(session, "Connection Node is NULL.");
-    return;
+    DEBUG(session, "Peer is not reading, data handler postponed [%s].", jcon_client_getReferenceString(client));
   }
-
-  jcon_system_connection_t *connection = (jcon_system_connection_t *)jutil_linkedlist_getData(connection_node);
-  if(connection)
+  else if(session->data_handler)
   {
-    if(connection->thread)
-    {
-      jcon_thread_free(connection->thread);
-    }
-    if(connection->client)
-    {
-      DEBUG(session, "Freeing client [%s].", jcon_client_getReferenceString(connection->client));
-      jcon_client_session_free(connection->client);
-    }
-
-    free(connection);
+    session->data_handler(session->session_context, client);
   }
 
-  if(jutil_linkedlist_removeNode(&session->connections, connection_node) == NULL)
+  pthread_mutex_lock(&connection->send_mutex);
+  connection->in_worker = false;
+  int pending = (connection->send_head != NULL);
+  pthread_mutex_unlock(&connection->send_mutex);
+
+  /* Data queued meanwhile was skipped by the control thread. */
+  if(pending)
   {
-    ERROR(session, "jutil_linkedlist_removeNode() failed.");
+    jutil_thread_notify(session->control_thread);
   }
 }
 
 
 
 //==============================================================================
-// Implement handlers for jcon_thread.
+// Implement shutdown handlers.
 //
 
 //------------------------------------------------------------------------------
 //
-void jcon_system_connectionThread_create(void *ctx, int create_type, const char *reference_string)
+void jcon_system_shutdown_accept(int exit_value, const jutil_time_deadline_t *deadline, void *ctx)
 {
+  jcon_system_stopAccepting((jcon_system_t *)ctx);
 }
 
 //------------------------------------------------------------------------------
 //
-void jcon_system_connectionThread_close(void *ctx, int close_type, const char *reference_string)
+void jcon_system_shutdown_drain(int exit_value, const jutil_time_deadline_t *deadline, void *ctx)
 {
+  jcon_system_drain((jcon_system_t *)ctx, jutil_time_deadline_getRemaining(deadline));
 }
 
 
@@ -650,6 +3693,11 @@ void jcon_system_connectionThread_close(void *ctx, int close_type, const char *r
 //
 void jcon_system_log(jcon_system_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
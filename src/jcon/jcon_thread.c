@@ -11,12 +11,24 @@
 
 #include <jayc/jcon_thread.h>
 #include <jayc/jutil_thread.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <jayc/jutil_time.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <errno.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdatomic.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jcon_thread");
+
+
 
 //==============================================================================
 // Define constants and defaults.
@@ -24,6 +36,21 @@
 
 #define JCON_THREAD_LOOPSLEEP_DEFAULT 100000000
 
+/**
+ * @brief Time adaptive threads poll without timeout after data (50 us).
+ */
+#define JCON_THREAD_SPIN_DEFAULT 50000
+
+/**
+ * @brief Longest poll timeout of idle adaptive threads in milliseconds.
+ */
+#define JCON_THREAD_PARKMAX_DEFAULT 100
+
+/**
+ * @brief Poll timeout of clients, restored after adaptive mode.
+ */
+#define JCON_THREAD_POLLTIMEOUT_DEFAULT 10
+
 
 
 //==============================================================================
@@ -45,6 +72,17 @@
  */
 static int jcon_thread_run_function(void *session_ptr, jutil_thread_t *thread_handler);
 
+/**
+ * @brief Sets poll timeout of client for adaptive wait mode.
+ * 
+ * Polls without timeout during spin time after last data,
+ * then doubles timeout with every empty poll, up to maximum.
+ * Restores poll timeout, if mode changed.
+ * 
+ * @param session Session to adapt.
+ */
+static void jcon_thread_adaptPollTimeout(jcon_thread_t *session);
+
 /**
  * @brief Logs debug and error messages.
  * 
@@ -65,15 +103,20 @@ static void jcon_thread_log(jcon_thread_t *session, int log_type, const char *fi
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled(((session && session->client) ? session->logger : NULL), log_type))
+
 #ifdef JCON_NO_DEBUG /* Allows to disable debug messages at compile time. */
   #define DEBUG(session, fmt, ...)
 #else
-  #define DEBUG(session, fmt, ...) jcon_thread_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jcon_thread_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(session, fmt, ...) jcon_thread_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(session, fmt, ...) jcon_thread_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(session, fmt, ...) jcon_thread_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(session, fmt, ...) jcon_thread_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jcon_thread_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jcon_thread_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jcon_thread_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jcon_thread_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(session, fmt, ...) jcon_thread_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 
@@ -96,6 +139,13 @@ struct __jcon_thread_session
 
   jlog_t *logger;                               /**< Logger for debug and error messages. */
   void *session_context;                        /**< Context pointer to pass to handlers. */
+
+  atomic_int wait_mode;                         /**< How thread waits for data. */
+  int adaptive_supported;                       /**< @c true , if client supports poll timeouts. */
+  atomic_ullong spin_time;                      /**< Time to poll without timeout after data in nanoseconds. */
+  atomic_int park_max;                          /**< Longest poll timeout in milliseconds. */
+  unsigned long long last_data;                 /**< Time of last data in nanoseconds. */
+  int poll_timeout;                             /**< Poll timeout set by thread. @c -1 , if not adapting. */
 };
 
 
@@ -122,7 +172,7 @@ jcon_thread_t *jcon_thread_init
     return NULL;
   }
 
-  jcon_thread_t *session = (jcon_thread_t *)malloc(sizeof(jcon_thread_t));
+  jcon_thread_t *session = (jcon_thread_t *)JUTIL_ALLOC_MALLOC(sizeof(jcon_thread_t));
   if(session == NULL)
   {
     ERROR(NULL, "malloc() failed.");
@@ -137,6 +187,14 @@ jcon_thread_t *jcon_thread_init
   session->logger = logger;
   session->session_context = ctx;
 
+  /* Clients without poll timeouts fall back to sleeping. */
+  session->adaptive_supported = jcon_client_setPollTimeout(client, 0);
+  atomic_init(&session->wait_mode, (session->adaptive_supported ? JCON_THREAD_WAITMODE_ADAPTIVE : JCON_THREAD_WAITMODE_SLEEP));
+  atomic_init(&session->spin_time, JCON_THREAD_SPIN_DEFAULT);
+  atomic_init(&session->park_max, JCON_THREAD_PARKMAX_DEFAULT);
+  session->last_data = jutil_time_getNanos();
+  session->poll_timeout = (atomic_load(&session->wait_mode) == JCON_THREAD_WAITMODE_ADAPTIVE ? 0 : -1);
+
   session->thread = jutil_thread_init
   (
     jcon_thread_run_function,
@@ -148,15 +206,20 @@ jcon_thread_t *jcon_thread_init
   if(session->thread == NULL)
   {
     ERROR(session, "jutil_thread_init() failed. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
+  if(atomic_load(&session->wait_mode) == JCON_THREAD_WAITMODE_ADAPTIVE)
+  {
+    jutil_thread_setWaitPolicy(session->thread, JUTIL_THREAD_WAIT_BUSYPOLL);
+  }
+
   if(jutil_thread_start(session->thread) == false)
   {
     ERROR(session, "jutil_thread_start() failed. Destroying session.");
     jutil_thread_free(session->thread);
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -174,7 +237,7 @@ void jcon_thread_free(jcon_thread_t *session)
   }
 
   jutil_thread_free(session->thread);
-  free(session);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
@@ -187,6 +250,9 @@ int jcon_thread_isRunning(jcon_thread_t *session)
     return false;
   }
 
+  /* Joins thread, if it exited after disconnect. Otherwise it counts as running. */
+  jutil_thread_manage(session->thread);
+
   return jutil_thread_isRunning(session->thread);
 }
 
@@ -216,6 +282,84 @@ const char *jcon_thread_getReferenceString(jcon_thread_t *session)
   return jcon_client_getReferenceString(session->client);
 }
 
+//------------------------------------------------------------------------------
+//
+int jcon_thread_setWaitMode(jcon_thread_t *session, int mode)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  switch(mode)
+  {
+    case JCON_THREAD_WAITMODE_SLEEP:
+    {
+      if(jutil_thread_setWaitPolicy(session->thread, JUTIL_THREAD_WAIT_NOTIFY) == false)
+      {
+        return false;
+      }
+      break;
+    }
+
+    case JCON_THREAD_WAITMODE_POLL:
+    {
+      if(jutil_thread_setWaitPolicy(session->thread, JUTIL_THREAD_WAIT_BUSYPOLL) == false)
+      {
+        return false;
+      }
+      break;
+    }
+
+    case JCON_THREAD_WAITMODE_ADAPTIVE:
+    {
+      if(session->adaptive_supported == false)
+      {
+        ERROR(session, "Client does not support poll timeouts.");
+        return false;
+      }
+
+      if(jutil_thread_setWaitPolicy(session->thread, JUTIL_THREAD_WAIT_BUSYPOLL) == false)
+      {
+        return false;
+      }
+      break;
+    }
+
+    default:
+    {
+      ERROR(session, "Invalid wait mode [%d].", mode);
+      return false;
+    }
+  }
+
+  /* Poll timeout of client is changed by thread only. */
+  atomic_store(&session->wait_mode, mode);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jcon_thread_setAdaptivePolling(jcon_thread_t *session, long spin_us, int park_max)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(spin_us < 0 || park_max <= 0)
+  {
+    ERROR(session, "Invalid spin time [%ld us] or maximum poll timeout [%d ms].", spin_us, park_max);
+    return false;
+  }
+
+  atomic_store(&session->spin_time, (unsigned long long)spin_us * 1000ULL);
+  atomic_store(&session->park_max, park_max);
+  return true;
+}
+
 
 
 //==============================================================================
@@ -240,21 +384,31 @@ int jcon_thread_run_function(void *session_ptr, jutil_thread_t *thread_handler)
 
   jcon_thread_t *session = (jcon_thread_t *)session_ptr;
   int ret = true;
+
+  jcon_thread_adaptPollTimeout(session);
   
-  /* Check for new data */
-  jutil_thread_lockMutex(thread_handler);
+  /* Check for new data. Poll without holding the mutex, so
+     stopping the thread does not wait for the poll timeout. */
   if(jcon_client_newData(session->client))
   {
     DEBUG(session, "New data available.");
+    if(session->poll_timeout >= 0)
+    {
+      session->last_data = jutil_time_getNanos();
+    }
+
+    jutil_thread_lockMutex(thread_handler);
     if(session->data_handler)
     {
+      unsigned long long handler_start = JUTIL_METRICS_NOW();
       session->data_handler(
         session->session_context,
         session->client
       );
+      JUTIL_METRICS_HISTOGRAM_SINCE("jcon_system_handler_seconds", "Duration of data handler calls.", handler_start);
     }
+    jutil_thread_unlockMutex(thread_handler);
   }
-  jutil_thread_unlockMutex(thread_handler);
 
   /* Check connection state */
   jutil_thread_lockMutex(thread_handler);
@@ -277,10 +431,49 @@ int jcon_thread_run_function(void *session_ptr, jutil_thread_t *thread_handler)
   return ret;
 }
 
+//------------------------------------------------------------------------------
+//
+void jcon_thread_adaptPollTimeout(jcon_thread_t *session)
+{
+  if(atomic_load_explicit(&session->wait_mode, memory_order_relaxed) != JCON_THREAD_WAITMODE_ADAPTIVE)
+  {
+    if(session->poll_timeout >= 0)
+    {
+      jcon_client_setPollTimeout(session->client, JCON_THREAD_POLLTIMEOUT_DEFAULT);
+      session->poll_timeout = -1;
+    }
+    return;
+  }
+
+  int timeout = 0;
+  unsigned long long spin_time = atomic_load_explicit(&session->spin_time, memory_order_relaxed);
+  if(jutil_time_getNanos() - session->last_data >= spin_time)
+  {
+    /* Idle, park in the kernel for longer and longer. */
+    int park_max = atomic_load_explicit(&session->park_max, memory_order_relaxed);
+    timeout = (session->poll_timeout > 0 ? session->poll_timeout * 2 : 1);
+    if(timeout > park_max)
+    {
+      timeout = park_max;
+    }
+  }
+
+  if(timeout != session->poll_timeout)
+  {
+    jcon_client_setPollTimeout(session->client, timeout);
+    session->poll_timeout = timeout;
+  }
+}
+
 //------------------------------------------------------------------------------
 //
 void jcon_thread_log(jcon_thread_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
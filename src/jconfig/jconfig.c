@@ -4,26 +4,294 @@
  * 
  * @brief Implements jconfig component.
  * 
+ * Datapoints are found by key in a hash map. Additionally
+ * they are kept in a crit-bit tree (binary radix tree, that
+ * branches at the first bit, where keys differ) and a list
+ * in key order. The tree finds the first datapoint with a
+ * prefix and where new datapoints go in the list.
+ * 
  * @date 2020-10-02
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
  */
 
-/* Needed for getline() */
+/* Needed for posix_madvise() and O_CLOEXEC */
 #define _POSIX_C_SOURCE 200809L
 
 #include <jayc/jconfig.h>
 #include <jayc/jconfig_dev.h>
+#include <jayc/jconfig_snapshot.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Allocation statistics of module.
+ */
+JUTIL_ALLOC_MODULE("jconfig");
+
+/**
+ * @brief Initial buffer size, when files can not be mapped.
+ */
+#define JCONFIG_SIZE_READBUFFER 4096
+
+/**
+ * @brief Buffer size of files, that are saved.
+ */
+#define JCONFIG_SIZE_WRITEBUFFER 1048576
+
+/**
+ * @brief Unit of durations or sizes.
+ */
+typedef struct __jconfig_unit
+{
+  const char *name;   /**< Unit string (case is ignored). */
+  uint64_t factor;    /**< Value of one unit in nanoseconds or bytes. */
+} jconfig_unit_t;
+
+/**
+ * @brief Units of durations. Terminated by @c NULL name.
+ * 
+ * First unit is used, if value has none.
+ */
+static const jconfig_unit_t jconfig_units_duration[] =
+{
+  { "s",  1000000000ULL },
+  { "ns", 1ULL },
+  { "us", 1000ULL },
+  { "ms", 1000000ULL },
+  { "m",  60000000000ULL },
+  { "h",  3600000000000ULL },
+  { "d",  86400000000000ULL },
+  { NULL, 0 }
+};
+
+/**
+ * @brief Units of sizes. Terminated by @c NULL name.
+ * 
+ * First unit is used, if value has none.
+ */
+static const jconfig_unit_t jconfig_units_size[] =
+{
+  { "b",   1ULL },
+  { "k",   1024ULL },
+  { "kib", 1024ULL },
+  { "kb",  1000ULL },
+  { "m",   1048576ULL },
+  { "mib", 1048576ULL },
+  { "mb",  1000000ULL },
+  { "g",   1073741824ULL },
+  { "gib", 1073741824ULL },
+  { "gb",  1000000000ULL },
+  { "t",   1099511627776ULL },
+  { "tib", 1099511627776ULL },
+  { "tb",  1000000000000ULL },
+  { NULL, 0 }
+};
+
+/**
+ * @brief Reads file, that can not be mapped.
+ * 
+ * @param fd   File descriptor to read.
+ * @param size Returns number of bytes read.
+ * 
+ * @return     Allocated buffer with file content.
+ * @return     @c NULL , if error occured.
+ */
+static char *jconfig_raw_readAll(int fd, size_t *size);
+
+/**
+ * @brief Maps or reads file.
+ * 
+ * @param filename  Path of file.
+ * @param size      Returns size of content.
+ * @param mapped    Returns @c true , if content is mapped.
+ * 
+ * @return          File content. Released with
+ *                  @c #jconfig_raw_releaseFile() .
+ * @return          @c NULL , if error occured.
+ */
+static char *jconfig_raw_openFile(const char *filename, size_t *size, int *mapped);
+
+/**
+ * @brief Releases content of @c #jconfig_raw_openFile() .
+ * 
+ * @param content File content.
+ * @param size    Size of content.
+ * @param mapped  @c true , if content is mapped.
+ */
+static void jconfig_raw_releaseFile(char *content, size_t size, int mapped);
+
+/**
+ * @brief Parses raw format into table.
+ * 
+ * Keys and values are copied into the arena of the table.
+ * 
+ * @param table   Config table.
+ * @param content File content.
+ * @param size    Size of content.
+ * 
+ * @return        @c true , if parsed successfully.
+ * @return        @c false , if error occured.
+ */
+static int jconfig_raw_parse(jconfig_t *table, const char *content, size_t size);
+
+/**
+ * @brief Returns datapoint with data parsed as type.
+ * 
+ * Data is only parsed, if it was not parsed as
+ * same type before.
+ * 
+ * @param table Table to search.
+ * @param key   Key to search for.
+ * @param type  @c JCONFIG_TYPE_* constant.
+ * 
+ * @return      Datapoint with valid @c cache .
+ * @return      @c NULL , if key not found or data can not be parsed.
+ */
+static jconfig_datapoint_t *jconfig_datapoint_getTyped(jconfig_t *table, const char *key, int type);
+
+/**
+ * @brief Parses number with optional unit.
+ * 
+ * Integers are parsed and multiplied exactly. Only numbers
+ * with fraction or exponent (e.g. "1.5k") are computed as
+ * double and rounded.
+ * 
+ * @param data  Value string.
+ * @param units Allowed units.
+ * @param limit Highest allowed result.
+ * @param value Returns number multiplied by unit factor.
+ * 
+ * @return      @c true , if data was parsed.
+ * @return      @c false , if data is invalid or out of range.
+ */
+static int jconfig_value_parseUnit(const char *data, const jconfig_unit_t *units, uint64_t limit, uint64_t *value);
+
+/**
+ * @brief Checks, if only whitespace is left.
+ * 
+ * @param data  Rest of value string.
+ * 
+ * @return      @c true , if string has no other characters.
+ * @return      @c false , if not.
+ */
+static int jconfig_value_isEnd(const char *data);
+
+/**
+ * @brief Compares keys in order of prefix tree.
+ * 
+ * @param key1    First key.
+ * @param length1 Length of first key.
+ * @param key2    Second key.
+ * @param length2 Length of second key.
+ * 
+ * @return        Less than, equal to or greater than @c 0 ,
+ *                if first key is lower, equal or higher.
+ */
+static int jconfig_key_compare(const char *key1, size_t length1, const char *key2, size_t length2);
+
+/**
+ * @brief Internal node of prefix tree.
+ * 
+ * Pointers to nodes are tagged by setting the lowest bit.
+ * Untagged pointers are datapoints (leaves).
+ */
+typedef struct __jconfig_index_node
+{
+  void *child[2];     /**< Subtrees with bit not set (@c 0 ) and set (@c 1 ). */
+  size_t byte;        /**< Byte of key, that is checked. */
+  uint8_t otherbits;  /**< All bits set, except checked bit. */
+} jconfig_index_node_t;
+
+/**
+ * @brief Checks, if tree pointer is internal node.
+ */
+#define JCONFIG_INDEX_ISNODE(p) ((uintptr_t)(p) & 1)
+
+/**
+ * @brief Gets internal node from tagged tree pointer.
+ */
+#define JCONFIG_INDEX_NODE(p) ((jconfig_index_node_t *)((uintptr_t)(p) - 1))
+
+/**
+ * @brief Returns direction to follow at node for key.
+ * 
+ * @param node   Internal node.
+ * @param key    Key to search.
+ * @param length Length of key.
+ * 
+ * @return       @c 0 or @c 1 .
+ */
+static int jconfig_index_direction(jconfig_index_node_t *node, const char *key, size_t length);
+
+/**
+ * @brief Returns lowest or highest datapoint of subtree.
+ * 
+ * @param tree      Subtree (tagged node or datapoint).
+ * @param direction @c 0 for lowest, @c 1 for highest key.
+ * 
+ * @return          Datapoint at edge of subtree.
+ */
+static jconfig_datapoint_t *jconfig_index_edge(void *tree, int direction);
+
+/**
+ * @brief Adds datapoint to tree and ordered list.
+ * 
+ * Key must not be in tree.
+ * 
+ * @param table     Config table.
+ * @param datapoint Datapoint to add.
+ * 
+ * @return          @c true , if added.
+ * @return          @c false , if error occured.
+ */
+static int jconfig_index_insert(jconfig_t *table, jconfig_datapoint_t *datapoint);
+
+/**
+ * @brief Removes datapoint from tree and ordered list.
+ * 
+ * @param table     Config table.
+ * @param datapoint Datapoint of table to remove.
+ */
+static void jconfig_index_remove(jconfig_t *table, jconfig_datapoint_t *datapoint);
+
+/**
+ * @brief Finds first datapoint with key prefix.
+ * 
+ * @param table  Config table.
+ * @param prefix Prefix of key.
+ * @param length Length of prefix.
+ * 
+ * @return       Datapoint with lowest key, that starts with prefix.
+ * @return       @c NULL , if no key has this prefix.
+ */
+static jconfig_datapoint_t *jconfig_index_findPrefix(jconfig_t *table, const char *prefix, size_t length);
+
+/**
+ * @brief Frees internal nodes of tree.
+ * 
+ * Datapoints are not freed.
+ * 
+ * @param tree Tree to free.
+ */
+static void jconfig_index_free(void *tree);
 
 //------------------------------------------------------------------------------
 //
 jconfig_t *jconfig_init()
 {
-  jconfig_t *table = (jconfig_t *)malloc(sizeof(jconfig_t));
+  jconfig_t *table = (jconfig_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_t));
   if(table == NULL)
   {
     return NULL;
@@ -32,10 +300,25 @@ jconfig_t *jconfig_init()
   table->map = jutil_map_init();
   if(table->map == NULL)
   {
-    free(table);
+    JUTIL_ALLOC_FREE(table);
+    return NULL;
+  }
+
+  table->arena = jutil_arena_init(0, 0);
+  if(table->arena == NULL)
+  {
+    jutil_map_free(table->map);
+    JUTIL_ALLOC_FREE(table);
     return NULL;
   }
 
+  table->index = NULL;
+  table->first = NULL;
+  table->watchers = NULL;
+  table->batch = false;
+  table->batch_count = 0;
+  table->snapshots = NULL;
+
   return table;
 }
 
@@ -48,9 +331,19 @@ void jconfig_free(jconfig_t *table)
     return;
   }
 
-  jconfig_clear(table);
+  jconfig_snapshot_disable(table);
+  jconfig_datapoint_clear(table);
   jutil_map_free(table->map);
-  free(table);
+  jutil_arena_free(table->arena);
+
+  while(table->watchers != NULL)
+  {
+    jconfig_watcher_t *watcher = table->watchers;
+    table->watchers = watcher->next;
+    JUTIL_ALLOC_FREE(watcher);
+  }
+
+  JUTIL_ALLOC_FREE(table);
 }
 
 //------------------------------------------------------------------------------
@@ -69,19 +362,23 @@ int jconfig_datapoint_delete(jconfig_t *table, const char *key)
   {
     return false;
   }
-  if(strlen(key) >= JUTIL_MAP_SIZE_INDEX)
+
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)jutil_map_remove(table->map, key);
+
+  if(datapoint == NULL)
   {
     return false;
   }
 
-  void *data = jutil_map_remove(table->map, key);
-
-  if(data == NULL)
+  jconfig_index_remove(table, datapoint);
+  jconfig_snapshot_remove(table, datapoint->key, datapoint->key_length);
+  if(datapoint->data_allocated)
   {
-    return false;
+    JUTIL_ALLOC_FREE(datapoint->data);
   }
+  JUTIL_ALLOC_FREE(datapoint);
 
-  free(data);
+  jconfig_snapshot_publish(table);
   return true;
 }
 
@@ -101,12 +398,84 @@ const char *jconfig_datapoint_get(jconfig_t *table, const char *key)
   {
     return NULL;
   }
-  if(strlen(key) >= JUTIL_MAP_SIZE_INDEX)
+
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)jutil_map_get(table->map, key);
+  if(datapoint == NULL)
   {
     return NULL;
   }
 
-  return (const char *)jutil_map_get(table->map, key);
+  return (const char *)datapoint->data;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_datapoint_getInt64(jconfig_t *table, const char *key, int64_t *value)
+{
+  jconfig_datapoint_t *datapoint = jconfig_datapoint_getTyped(table, key, JCONFIG_TYPE_INT64);
+  if(datapoint == NULL || value == NULL)
+  {
+    return false;
+  }
+
+  *value = datapoint->cache.integer;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_datapoint_getDouble(jconfig_t *table, const char *key, double *value)
+{
+  jconfig_datapoint_t *datapoint = jconfig_datapoint_getTyped(table, key, JCONFIG_TYPE_DOUBLE);
+  if(datapoint == NULL || value == NULL)
+  {
+    return false;
+  }
+
+  *value = datapoint->cache.real;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_datapoint_getBool(jconfig_t *table, const char *key, int *value)
+{
+  jconfig_datapoint_t *datapoint = jconfig_datapoint_getTyped(table, key, JCONFIG_TYPE_BOOL);
+  if(datapoint == NULL || value == NULL)
+  {
+    return false;
+  }
+
+  *value = (int)datapoint->cache.integer;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_datapoint_getDuration(jconfig_t *table, const char *key, int64_t *nanoseconds)
+{
+  jconfig_datapoint_t *datapoint = jconfig_datapoint_getTyped(table, key, JCONFIG_TYPE_DURATION);
+  if(datapoint == NULL || nanoseconds == NULL)
+  {
+    return false;
+  }
+
+  *nanoseconds = datapoint->cache.integer;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_datapoint_getSize(jconfig_t *table, const char *key, uint64_t *bytes)
+{
+  jconfig_datapoint_t *datapoint = jconfig_datapoint_getTyped(table, key, JCONFIG_TYPE_SIZE);
+  if(datapoint == NULL || bytes == NULL)
+  {
+    return false;
+  }
+
+  *bytes = datapoint->cache.size;
+  return true;
 }
 
 //------------------------------------------------------------------------------
@@ -125,37 +494,28 @@ int jconfig_datapoint_set(jconfig_t *table, const char *key, const char *value)
   {
     return false;
   }
-  if(strlen(key) >= JUTIL_MAP_SIZE_INDEX)
-  {
-    return false;
-  }
   if(value == NULL)
   {
     return false;
   }
 
   size_t data_size = strlen(value) + 1;
-  char *data = (char *)malloc(sizeof(char) * data_size);
+  char *data = (char *)JUTIL_ALLOC_MALLOC(sizeof(char) * data_size);
   if(data == NULL)
   {
     return false;
   }
 
-  char *old_data = (char *)jutil_map_get(table->map, key);
-  if(old_data)
-  {
-    free(old_data);
-  }
-
   memset(data, 0, data_size);
   memcpy(data, value, data_size);
 
-  if(jutil_map_set(table->map, key, (void *)data) == false)
+  if(jconfig_datapoint_put(table, key, strlen(key), data, true) == false)
   {
-    free(data);
+    JUTIL_ALLOC_FREE(data);
     return false;
   }
 
+  jconfig_snapshot_publish(table);
   return true;
 }
 
@@ -168,14 +528,108 @@ void jconfig_clear(jconfig_t *table)
     return;
   }
 
-  jutil_map_data_t *itr = NULL;
+  jconfig_datapoint_clear(table);
+  jconfig_snapshot_publish(table);
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_datapoint_clear(jconfig_t *table)
+{
+  jconfig_datapoint_t *datapoint = table->first;
 
-  while( (itr = jutil_map_iterate(table->map, itr)) != NULL )
+  while(datapoint != NULL)
   {
-    free(itr->data);
+    jconfig_datapoint_t *next = datapoint->next;
+    if(datapoint->data_allocated)
+    {
+      JUTIL_ALLOC_FREE(datapoint->data);
+    }
+    JUTIL_ALLOC_FREE(datapoint);
+    datapoint = next;
   }
 
+  jutil_arena_reset(table->arena);
+
+  jconfig_index_free(table->index);
+  table->index = NULL;
+  table->first = NULL;
+
   jutil_map_clear(table->map);
+  jconfig_snapshot_clear(table);
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_batch_begin(jconfig_t *table, size_t expected)
+{
+  if(table == NULL || table->batch)
+  {
+    return false;
+  }
+
+  /* Storage is sized once, instead of growing while keys are added. */
+  if(jutil_map_resize(table->map, jutil_map_size(table->map) + expected) == false)
+  {
+    return false;
+  }
+
+  table->batch = true;
+  table->batch_count = 0;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_batch_set(jconfig_t *table, const char *key, const char *value)
+{
+  if(table == NULL || table->batch == false)
+  {
+    return false;
+  }
+  if(key == NULL || value == NULL)
+  {
+    return false;
+  }
+
+  size_t key_length = strlen(key);
+  if(key_length == 0)
+  {
+    return false;
+  }
+
+  size_t value_length = strlen(value);
+  char *data = (char *)jutil_arena_allocAligned(table->arena, value_length + 1, 1);
+  if(data == NULL)
+  {
+    return false;
+  }
+  memcpy(data, value, value_length + 1);
+
+  if(jconfig_datapoint_put(table, key, key_length, data, false) == false)
+  {
+    return false;
+  }
+
+  table->batch_count++;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jconfig_batch_commit(jconfig_t *table)
+{
+  if(table == NULL || table->batch == false)
+  {
+    return 0;
+  }
+
+  size_t count = table->batch_count;
+  table->batch = false;
+  table->batch_count = 0;
+
+  jconfig_snapshot_publish(table);
+  return count;
 }
 
 //------------------------------------------------------------------------------
@@ -187,24 +641,31 @@ jconfig_iterator_t *jconfig_iterate(jconfig_t *table, const char *prefix, jconfi
     return NULL;
   }
 
-  jutil_map_data_t *search = jutil_map_iterate(table->map, (jutil_map_data_t *)itr);
+  size_t length = (prefix ? strlen(prefix) : 0);
 
-  if(prefix == NULL || strlen(prefix) == 0)
+  if(itr == NULL)
   {
-    return search;
+    if(length == 0)
+    {
+      return (jconfig_iterator_t *)table->first;
+    }
+
+    return (jconfig_iterator_t *)jconfig_index_findPrefix(table, prefix, length);
   }
 
-  while(search != NULL)
+  /* Keys with prefix are next to each other in list. */
+  jconfig_datapoint_t *next = ((jconfig_datapoint_t *)itr)->next;
+  if(next == NULL || length == 0)
   {
-    if(strncmp(search->index, prefix, strlen(prefix)) == 0)
-    {
-      return (jconfig_iterator_t *)search;
-    }
+    return (jconfig_iterator_t *)next;
+  }
 
-    search = jutil_map_iterate(table->map, search);
+  if(next->key_length < length || memcmp(next->key, prefix, length) != 0)
+  {
+    return NULL;
   }
 
-  return NULL;
+  return (jconfig_iterator_t *)next;
 }
 
 //------------------------------------------------------------------------------
@@ -216,8 +677,8 @@ const char *jconfig_itr_getKey(jconfig_iterator_t *itr)
     return NULL;
   }
 
-  jutil_map_data_t *map_itr = itr;
-  return (const char *)map_itr->index;
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)itr;
+  return (const char *)datapoint->key;
 }
 
 //------------------------------------------------------------------------------
@@ -229,46 +690,188 @@ const char *jconfig_itr_getData(jconfig_iterator_t *itr)
     return NULL;
   }
 
-  jutil_map_data_t *map_itr = itr;
-  return (const char *)map_itr->data;
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)itr;
+  return (const char *)datapoint->data;
 }
 
 //------------------------------------------------------------------------------
 //
-int jconfig_raw_saveToFile(jconfig_t *table, const char *filename)
+int jconfig_watcher_add(jconfig_t *table, const char *prefix, jconfig_watcher_handler_t handler, void *ctx)
 {
-  if(table == NULL)
+  if(table == NULL || handler == NULL)
   {
     return false;
   }
 
-  FILE *fd = fopen(filename, "w");
-  if(fd == NULL)
+  size_t prefix_length = (prefix ? strlen(prefix) : 0);
+  jconfig_watcher_t *watcher = (jconfig_watcher_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_watcher_t) + prefix_length + 1);
+  if(watcher == NULL)
   {
     return false;
   }
 
-  jutil_map_data_t *map_itr = NULL;
+  if(prefix_length > 0)
+  {
+    memcpy(watcher->prefix, prefix, prefix_length);
+  }
+  watcher->prefix[prefix_length] = 0;
+  watcher->prefix_length = prefix_length;
+  watcher->handler = handler;
+  watcher->ctx = ctx;
 
-  while( (map_itr = jutil_map_iterate(table->map, map_itr)) )
+  /* Appended, so watchers are called in order of registration. */
+  jconfig_watcher_t **last = &table->watchers;
+  while(*last != NULL)
   {
-    if(map_itr->index == NULL)
-    {
-      fclose(fd);
-      return false;
-    }
+    last = &(*last)->next;
+  }
 
-    if(map_itr->data == NULL)
+  watcher->next = NULL;
+  *last = watcher;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_watcher_remove(jconfig_t *table, jconfig_watcher_handler_t handler, void *ctx)
+{
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  jconfig_watcher_t **watcher;
+  for(watcher = &table->watchers; *watcher != NULL; watcher = &(*watcher)->next)
+  {
+    if((*watcher)->handler == handler && (*watcher)->ctx == ctx)
+    {
+      jconfig_watcher_t *found = *watcher;
+      *watcher = found->next;
+      JUTIL_ALLOC_FREE(found);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_reload(jconfig_t *table, jconfig_t *source)
+{
+  if(table == NULL || source == NULL || table == source)
+  {
+    return false;
+  }
+
+  /* Swap content, old content stays valid for watchers until source is cleared. */
+  jutil_map_t *map = table->map;
+  void *index = table->index;
+  jconfig_datapoint_t *first = table->first;
+  jutil_arena_t *arena = table->arena;
+
+  table->map = source->map;
+  table->index = source->index;
+  table->first = source->first;
+  table->arena = source->arena;
+
+  source->map = map;
+  source->index = index;
+  source->first = first;
+  source->arena = arena;
+
+  /* Both lists are sorted, so diff is found by walking them together.
+     Snapshots are changed by the diff, so unchanged keys stay shared. */
+  jconfig_datapoint_t *old_datapoint = source->first;
+  jconfig_datapoint_t *new_datapoint = table->first;
+
+  while((table->watchers != NULL || table->snapshots != NULL) && (old_datapoint != NULL || new_datapoint != NULL))
+  {
+    int compare;
+    if(old_datapoint == NULL)
+    {
+      compare = 1;
+    }
+    else if(new_datapoint == NULL)
+    {
+      compare = -1;
+    }
+    else
+    {
+      compare = jconfig_key_compare(old_datapoint->key, old_datapoint->key_length, new_datapoint->key, new_datapoint->key_length);
+    }
+
+    if(compare < 0)
+    {
+      jconfig_watcher_notify(table, JCONFIG_CHANGE_REMOVED, old_datapoint->key, old_datapoint->key_length, old_datapoint->data, NULL);
+      jconfig_snapshot_remove(table, old_datapoint->key, old_datapoint->key_length);
+      old_datapoint = old_datapoint->next;
+    }
+    else if(compare > 0)
+    {
+      jconfig_watcher_notify(table, JCONFIG_CHANGE_ADDED, new_datapoint->key, new_datapoint->key_length, NULL, new_datapoint->data);
+      jconfig_snapshot_put(table, new_datapoint->key, new_datapoint->key_length, new_datapoint->data);
+      new_datapoint = new_datapoint->next;
+    }
+    else
+    {
+      if(strcmp(old_datapoint->data, new_datapoint->data) != 0)
+      {
+        jconfig_watcher_notify(table, JCONFIG_CHANGE_CHANGED, new_datapoint->key, new_datapoint->key_length, old_datapoint->data, new_datapoint->data);
+        jconfig_snapshot_put(table, new_datapoint->key, new_datapoint->key_length, new_datapoint->data);
+      }
+
+      old_datapoint = old_datapoint->next;
+      new_datapoint = new_datapoint->next;
+    }
+  }
+
+  jconfig_clear(source);
+  jconfig_snapshot_publish(table);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_raw_saveToFile(jconfig_t *table, const char *filename)
+{
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  FILE *fd = fopen(filename, "w");
+  if(fd == NULL)
+  {
+    return false;
+  }
+
+  /* Large buffer, so big tables are written with few system calls. */
+  setvbuf(fd, NULL, _IOFBF, JCONFIG_SIZE_WRITEBUFFER);
+
+  jconfig_datapoint_t *datapoint;
+
+  for(datapoint = table->first; datapoint != NULL; datapoint = datapoint->next)
+  {
+    if(datapoint->data == NULL)
     {
       fclose(fd);
       return false;
     }
 
-    fprintf(fd, "%s=%s\n", map_itr->index, (const char *)map_itr->data);
+    fwrite(datapoint->key, 1, datapoint->key_length, fd);
+    fputc('=', fd);
+    fputs(datapoint->data, fd);
+    fputc('\n', fd);
   }
 
-  fclose(fd);
-  return true;
+  if(ferror(fd))
+  {
+    fclose(fd);
+    return false;
+  }
+
+  return (fclose(fd) == 0 ? true : false);
 }
 
 //------------------------------------------------------------------------------
@@ -280,51 +883,793 @@ int jconfig_raw_loadFromFile(jconfig_t *table, const char *filename)
     return false;
   }
 
-  FILE *fd = fopen(filename, "r");
-  if(fd == NULL)
+  size_t size;
+  int mapped;
+  char *content = jconfig_raw_openFile(filename, &size, &mapped);
+  if(content == NULL)
   {
     return false;
   }
 
-  jconfig_clear(table);
+  /* Readers of snapshots see the old content, until the whole file is parsed. */
+  jconfig_datapoint_clear(table);
+  int ret = jconfig_raw_parse(table, content, size);
+  jconfig_snapshot_publish(table);
 
-  char *lineptr = NULL;
-  size_t line_size = 0;
-  while(getline(&lineptr, &line_size, fd) > 0)
+  jconfig_raw_releaseFile(content, size, mapped);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+long jconfig_raw_importFromFile(jconfig_t *table, const char *filename)
+{
+  if(table == NULL)
   {
-    char key[2048] = { 0 };
-    char data[2048] = { 0 };
+    return -1;
+  }
+
+  size_t size;
+  int mapped;
+  char *content = jconfig_raw_openFile(filename, &size, &mapped);
+  if(content == NULL)
+  {
+    return -1;
+  }
+
+  /* Counting lines is cheap compared to growing the map repeatedly. */
+  size_t lines = 0;
+  for(const char *line = content; line < content + size; lines++)
+  {
+    const char *line_end = (const char *)memchr(line, '\n', (size_t)(content + size - line));
+    if(line_end == NULL)
+    {
+      lines++;
+      break;
+    }
+    line = line_end + 1;
+  }
+
+  /* Import can be part of a running batch. */
+  size_t before = jutil_map_size(table->map);
+  int ret;
+  if(table->batch)
+  {
+    ret = jutil_map_resize(table->map, before + lines) && jconfig_raw_parse(table, content, size);
+  }
+  else
+  {
+    ret = jconfig_batch_begin(table, lines) && jconfig_raw_parse(table, content, size);
+    jconfig_batch_commit(table);
+  }
+
+  jconfig_raw_releaseFile(content, size, mapped);
+
+  if(ret == false)
+  {
+    return -1;
+  }
+
+  return (long)(jutil_map_size(table->map) - before);
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_raw_reloadFromFile(jconfig_t *table, const char *filename)
+{
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  jconfig_t *source = jconfig_init();
+  if(source == NULL)
+  {
+    return false;
+  }
+
+  int ret = jconfig_raw_loadFromFile(source, filename) && jconfig_reload(table, source);
+
+  jconfig_free(source);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_datapoint_put(jconfig_t *table, const char *key, size_t key_length, char *data, int data_allocated)
+{
+  /* One lookup finds the datapoint or the slot for a new one. */
+  int added = false;
+  void **slot = jutil_map_emplace(table->map, key, &added);
+  if(slot == NULL)
+  {
+    return false;
+  }
+
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)*slot;
+  if(added == false)
+  {
+    if(datapoint->data_allocated)
+    {
+      JUTIL_ALLOC_FREE(datapoint->data);
+    }
+    datapoint->data = data;
+    datapoint->data_allocated = data_allocated;
+    datapoint->cache_type = JCONFIG_TYPE_NONE;
+    jconfig_snapshot_put(table, key, key_length, data);
+    return true;
+  }
+
+  datapoint = (jconfig_datapoint_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_datapoint_t) + key_length + 1);
+  if(datapoint == NULL)
+  {
+    jutil_map_remove(table->map, key);
+    return false;
+  }
+
+  memcpy(datapoint->key, key, key_length);
+  datapoint->key[key_length] = 0;
+  datapoint->key_length = key_length;
+  datapoint->data = data;
+  datapoint->data_allocated = data_allocated;
+  datapoint->cache_type = JCONFIG_TYPE_NONE;
+  datapoint->cache_valid = false;
+
+  *slot = (void *)datapoint;
+
+  if(jconfig_index_insert(table, datapoint) == false)
+  {
+    jutil_map_remove(table->map, datapoint->key);
+    JUTIL_ALLOC_FREE(datapoint);
+    return false;
+  }
+
+  jconfig_snapshot_put(table, key, key_length, data);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jconfig_raw_openFile(const char *filename, size_t *size, int *mapped)
+{
+  int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+  {
+    return NULL;
+  }
+
+  struct stat file_stat;
+  if(fstat(fd, &file_stat) != 0)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  char *content;
+  *mapped = false;
+
+  /* Pipes and files of /proc have no size, they are read. */
+  if(S_ISREG(file_stat.st_mode) && file_stat.st_size > 0)
+  {
+    *size = (size_t)file_stat.st_size;
+    content = (char *)mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(content == MAP_FAILED)
+    {
+      close(fd);
+      return NULL;
+    }
+
+    posix_madvise(content, *size, POSIX_MADV_SEQUENTIAL);
+    *mapped = true;
+  }
+  else
+  {
+    content = jconfig_raw_readAll(fd, size);
+  }
+
+  close(fd);
+  return content;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_raw_releaseFile(char *content, size_t size, int mapped)
+{
+  if(mapped)
+  {
+    munmap(content, size);
+  }
+  else
+  {
+    JUTIL_ALLOC_FREE(content);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+char *jconfig_raw_readAll(int fd, size_t *size)
+{
+  size_t capacity = JCONFIG_SIZE_READBUFFER;
+  size_t used = 0;
+  char *buffer = (char *)JUTIL_ALLOC_MALLOC(capacity);
+  if(buffer == NULL)
+  {
+    return NULL;
+  }
+
+  for(;;)
+  {
+    if(used == capacity)
+    {
+      char *grown = (char *)JUTIL_ALLOC_REALLOC(buffer, capacity * 2);
+      if(grown == NULL)
+      {
+        JUTIL_ALLOC_FREE(buffer);
+        return NULL;
+      }
+
+      buffer = grown;
+      capacity *= 2;
+    }
+
+    ssize_t ret = read(fd, buffer + used, capacity - used);
+    if(ret < 0)
+    {
+      JUTIL_ALLOC_FREE(buffer);
+      return NULL;
+    }
+
+    if(ret == 0)
+    {
+      break;
+    }
+
+    used += (size_t)ret;
+  }
+
+  *size = used;
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_raw_parse(jconfig_t *table, const char *content, size_t size)
+{
+  /* Each line needs at most two bytes more, than it takes in file. */
+  char *strings = (char *)jutil_arena_allocAligned(table->arena, size + 2, 1);
+  if(strings == NULL)
+  {
+    return false;
+  }
+
+  size_t used = 0;
+
+  size_t position = 0;
+  while(position < size)
+  {
+    const char *line = content + position;
+    const char *line_end = (const char *)memchr(line, '\n', size - position);
+    size_t line_length = (line_end ? (size_t)(line_end - line) : size - position);
+    position += line_length + 1;
 
     /* Empty lines are ignored. */
-    if(lineptr[0] == '\n')
+    if(line_length == 0)
     {
-      free(lineptr);
       continue;
     }
 
-    if(sscanf(lineptr, "%2047[^=]=%2047[^\n]\n", key, data) != 2)
+    const char *separator = (const char *)memchr(line, '=', line_length);
+    size_t key_length = (separator ? (size_t)(separator - line) : line_length);
+    if(key_length == 0)
+    {
+      continue;
+    }
+
+    /* Value is stored first, key is only needed until datapoint is created. */
+    char *value = strings + used;
+    size_t value_length = 0;
+    if(separator)
+    {
+      value_length = line_length - key_length - 1;
+      memcpy(value, separator + 1, value_length);
+    }
+    value[value_length] = 0;
+
+    char *key = value + value_length + 1;
+    memcpy(key, line, key_length);
+    key[key_length] = 0;
+
+    if(jconfig_datapoint_put(table, key, key_length, value, false) == false)
+    {
+      return false;
+    }
+
+    used += value_length + 1;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_datapoint_t *jconfig_datapoint_getTyped(jconfig_t *table, const char *key, int type)
+{
+  if(table == NULL || key == NULL)
+  {
+    return NULL;
+  }
+
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)jutil_map_get(table->map, key);
+  if(datapoint == NULL)
+  {
+    return NULL;
+  }
+
+  /* Failed parses are cached as well, so invalid values are not parsed again. */
+  if(datapoint->cache_type != type)
+  {
+    datapoint->cache_valid = jconfig_value_parse(datapoint->data, type, &datapoint->cache);
+    datapoint->cache_type = type;
+  }
+
+  if(datapoint->cache_valid == false)
+  {
+    return NULL;
+  }
+
+  return datapoint;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_value_parse(const char *data, int type, jconfig_value_t *value)
+{
+  if(data == NULL)
+  {
+    return false;
+  }
+
+  char *end;
+  double number;
+
+  switch(type)
+  {
+    case JCONFIG_TYPE_INT64:
+    {
+      errno = 0;
+      long long integer = strtoll(data, &end, 10);
+      if(end == data || errno != 0 || jconfig_value_isEnd(end) == false)
+      {
+        return false;
+      }
+
+      value->integer = (int64_t)integer;
+      return true;
+    }
+
+    case JCONFIG_TYPE_DOUBLE:
+    {
+      errno = 0;
+      number = strtod(data, &end);
+      if(end == data || errno != 0 || jconfig_value_isEnd(end) == false)
+      {
+        return false;
+      }
+
+      value->real = number;
+      return true;
+    }
+
+    case JCONFIG_TYPE_BOOL:
+    {
+      while(*data == ' ' || *data == '\t')
+      {
+        data++;
+      }
+
+      size_t length = strlen(data);
+      while(length > 0 && (data[length - 1] == ' ' || data[length - 1] == '\t'))
+      {
+        length--;
+      }
+
+      static const char *values_true[] = { "true", "yes", "on", "1", NULL };
+      static const char *values_false[] = { "false", "no", "off", "0", NULL };
+
+      for(size_t i = 0; values_true[i] != NULL; i++)
+      {
+        if(strlen(values_true[i]) == length && strncasecmp(data, values_true[i], length) == 0)
+        {
+          value->integer = true;
+          return true;
+        }
+        if(strlen(values_false[i]) == length && strncasecmp(data, values_false[i], length) == 0)
+        {
+          value->integer = false;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    case JCONFIG_TYPE_DURATION:
     {
-      if(strlen(key) == 0)
+      uint64_t amount;
+      if(jconfig_value_parseUnit(data, jconfig_units_duration, (uint64_t)INT64_MAX, &amount) == false)
       {
-        free(lineptr);
-        continue;
+        return false;
       }
+
+      value->integer = (int64_t)amount;
+      return true;
     }
 
-    free(lineptr);
-    lineptr = NULL;
-    line_size = 0;
+    case JCONFIG_TYPE_SIZE:
+    {
+      uint64_t amount;
+      if(jconfig_value_parseUnit(data, jconfig_units_size, UINT64_MAX, &amount) == false)
+      {
+        return false;
+      }
+
+      value->size = amount;
+      return true;
+    }
 
-    if(jconfig_datapoint_set(table, key, data) == false)
+    default:
     {
-      free(lineptr);
-      fclose(fd);
       return false;
     }
   }
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_value_parseUnit(const char *data, const jconfig_unit_t *units, uint64_t limit, uint64_t *value)
+{
+  while(*data == ' ' || *data == '\t')
+  {
+    data++;
+  }
+
+  /* strtoull() would accept and negate a sign. */
+  if(*data == '-')
+  {
+    return false;
+  }
 
-  free(lineptr);
+  char *end;
+  errno = 0;
+  unsigned long long integer = strtoull(data, &end, 10);
+  int is_integer = (end != data && errno == 0 && *end != '.' && *end != 'e' && *end != 'E' && *end != 'x' && *end != 'X');
 
-  fclose(fd);
+  double number = 0.0;
+  if(is_integer == false)
+  {
+    errno = 0;
+    number = strtod(data, &end);
+    if(end == data || errno != 0 || isfinite(number) == false || number < 0.0)
+    {
+      return false;
+    }
+  }
+
+  while(*end == ' ' || *end == '\t')
+  {
+    end++;
+  }
+
+  size_t length = 0;
+  while(end[length] != 0 && end[length] != ' ' && end[length] != '\t')
+  {
+    length++;
+  }
+
+  uint64_t factor = units[0].factor;
+  if(length > 0)
+  {
+    factor = 0;
+    for(size_t i = 0; units[i].name != NULL; i++)
+    {
+      if(strlen(units[i].name) == length && strncasecmp(end, units[i].name, length) == 0)
+      {
+        factor = units[i].factor;
+        break;
+      }
+    }
+
+    if(factor == 0)
+    {
+      return false;
+    }
+  }
+
+  if(jconfig_value_isEnd(end + length) == false)
+  {
+    return false;
+  }
+
+  if(is_integer)
+  {
+    if(integer > limit / factor)
+    {
+      return false;
+    }
+
+    *value = (uint64_t)integer * factor;
+    return true;
+  }
+
+  /* (double)limit rounds up to next power of 2, rounding up must stay below. */
+  number *= (double)factor;
+  if(number + 0.5 >= (double)limit)
+  {
+    return false;
+  }
+
+  *value = (uint64_t)(number + 0.5);
   return true;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_value_isEnd(const char *data)
+{
+  while(*data == ' ' || *data == '\t')
+  {
+    data++;
+  }
+
+  return (*data == 0);
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_key_compare(const char *key1, size_t length1, const char *key2, size_t length2)
+{
+  int compare = memcmp(key1, key2, (length1 < length2 ? length1 : length2));
+  if(compare != 0 || length1 == length2)
+  {
+    return compare;
+  }
+
+  /* Keys contain no '\0' , so shorter key is lower, like in prefix tree. */
+  return (length1 < length2 ? -1 : 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_watcher_notify(jconfig_t *table, int change, const char *key, size_t key_length, const char *old_value, const char *new_value)
+{
+  jconfig_watcher_t *watcher;
+  for(watcher = table->watchers; watcher != NULL; watcher = watcher->next)
+  {
+    if(watcher->prefix_length > key_length || memcmp(watcher->prefix, key, watcher->prefix_length) != 0)
+    {
+      continue;
+    }
+
+    watcher->handler(watcher->ctx, table, change, key, old_value, new_value);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_index_direction(jconfig_index_node_t *node, const char *key, size_t length)
+{
+  uint8_t c = 0;
+  if(node->byte < length)
+  {
+    c = (uint8_t)key[node->byte];
+  }
+
+  return (1 + (node->otherbits | c)) >> 8;
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_datapoint_t *jconfig_index_edge(void *tree, int direction)
+{
+  while(JCONFIG_INDEX_ISNODE(tree))
+  {
+    tree = JCONFIG_INDEX_NODE(tree)->child[direction];
+  }
+
+  return (jconfig_datapoint_t *)tree;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_index_insert(jconfig_t *table, jconfig_datapoint_t *datapoint)
+{
+  if(table->index == NULL)
+  {
+    datapoint->prev = NULL;
+    datapoint->next = NULL;
+    table->index = datapoint;
+    table->first = datapoint;
+    return true;
+  }
+
+  /* Find datapoint, that shares longest prefix. */
+  void *p = table->index;
+  while(JCONFIG_INDEX_ISNODE(p))
+  {
+    jconfig_index_node_t *node = JCONFIG_INDEX_NODE(p);
+    p = node->child[jconfig_index_direction(node, datapoint->key, datapoint->key_length)];
+  }
+  jconfig_datapoint_t *best = (jconfig_datapoint_t *)p;
+
+  /* Keys are unique, so they differ at the latest at terminator. */
+  size_t byte = 0;
+  while(best->key[byte] == datapoint->key[byte])
+  {
+    byte++;
+  }
+
+  uint8_t bits = (uint8_t)best->key[byte] ^ (uint8_t)datapoint->key[byte];
+  while(bits & (bits - 1))
+  {
+    bits &= bits - 1;
+  }
+  uint8_t otherbits = bits ^ 255;
+  int direction = (1 + (otherbits | (uint8_t)best->key[byte])) >> 8;
+
+  jconfig_index_node_t *new_node = (jconfig_index_node_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_index_node_t));
+  if(new_node == NULL)
+  {
+    return false;
+  }
+
+  new_node->byte = byte;
+  new_node->otherbits = otherbits;
+  new_node->child[1 - direction] = datapoint;
+
+  /* Nodes are ordered by checked bit from root to leaves. */
+  void **where = &table->index;
+  while(JCONFIG_INDEX_ISNODE(*where))
+  {
+    jconfig_index_node_t *node = JCONFIG_INDEX_NODE(*where);
+    if(node->byte > byte || (node->byte == byte && node->otherbits > otherbits))
+    {
+      break;
+    }
+
+    where = &node->child[jconfig_index_direction(node, datapoint->key, datapoint->key_length)];
+  }
+
+  new_node->child[direction] = *where;
+  *where = (void *)((uintptr_t)new_node + 1);
+
+  /* New datapoint is next to lowest or highest key of its sibling. */
+  jconfig_datapoint_t *prev;
+  jconfig_datapoint_t *next;
+  if(direction == 0)
+  {
+    prev = jconfig_index_edge(new_node->child[0], 1);
+    next = prev->next;
+  }
+  else
+  {
+    next = jconfig_index_edge(new_node->child[1], 0);
+    prev = next->prev;
+  }
+
+  datapoint->prev = prev;
+  datapoint->next = next;
+
+  if(prev)
+  {
+    prev->next = datapoint;
+  }
+  else
+  {
+    table->first = datapoint;
+  }
+
+  if(next)
+  {
+    next->prev = datapoint;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_index_remove(jconfig_t *table, jconfig_datapoint_t *datapoint)
+{
+  void **where = &table->index;
+  void **parent_where = NULL;
+  jconfig_index_node_t *parent = NULL;
+  int direction = 0;
+
+  while(JCONFIG_INDEX_ISNODE(*where))
+  {
+    parent_where = where;
+    parent = JCONFIG_INDEX_NODE(*where);
+    direction = jconfig_index_direction(parent, datapoint->key, datapoint->key_length);
+    where = &parent->child[direction];
+  }
+
+  if(parent == NULL)
+  {
+    table->index = NULL;
+  }
+  else
+  {
+    *parent_where = parent->child[1 - direction];
+    JUTIL_ALLOC_FREE(parent);
+  }
+
+  if(datapoint->prev)
+  {
+    datapoint->prev->next = datapoint->next;
+  }
+  else
+  {
+    table->first = datapoint->next;
+  }
+
+  if(datapoint->next)
+  {
+    datapoint->next->prev = datapoint->prev;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_datapoint_t *jconfig_index_findPrefix(jconfig_t *table, const char *prefix, size_t length)
+{
+  if(table->index == NULL)
+  {
+    return NULL;
+  }
+
+  /* Subtree below last node, that checks a byte of prefix. */
+  void *p = table->index;
+  void *top = p;
+  while(JCONFIG_INDEX_ISNODE(p))
+  {
+    jconfig_index_node_t *node = JCONFIG_INDEX_NODE(p);
+    p = node->child[jconfig_index_direction(node, prefix, length)];
+    if(node->byte < length)
+    {
+      top = p;
+    }
+  }
+
+  /* All keys of subtree share the checked bytes, so one has to be compared. */
+  jconfig_datapoint_t *datapoint = (jconfig_datapoint_t *)p;
+  if(datapoint->key_length < length || memcmp(datapoint->key, prefix, length) != 0)
+  {
+    return NULL;
+  }
+
+  return jconfig_index_edge(top, 0);
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_index_free(void *tree)
+{
+  /* Rotates left subtrees to the right, so no stack is needed. */
+  while(JCONFIG_INDEX_ISNODE(tree))
+  {
+    jconfig_index_node_t *node = JCONFIG_INDEX_NODE(tree);
+
+    if(JCONFIG_INDEX_ISNODE(node->child[0]))
+    {
+      void *left = node->child[0];
+      node->child[0] = JCONFIG_INDEX_NODE(left)->child[1];
+      JCONFIG_INDEX_NODE(left)->child[1] = tree;
+      tree = left;
+    }
+    else
+    {
+      tree = node->child[1];
+      JUTIL_ALLOC_FREE(node);
+    }
+  }
+}
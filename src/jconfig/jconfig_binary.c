@@ -0,0 +1,563 @@
+/**
+ * @file jconfig_binary.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements binary file format for jconfig.
+ * 
+ * Layout of file:
+ * - Header ( @c jconfig_binary_header_t ).
+ * - One entry ( @c jconfig_binary_entry_t ) per datapoint,
+ *   sorted in byte order of keys.
+ * - String table with keys and values. Each string is
+ *   terminated by @c '\0' , so it can be used in place.
+ * 
+ * Offsets in entries are relative to start of string table.
+ * Checksum is FNV-1a over entries and string table.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for fsync(), posix_madvise() and O_CLOEXEC */
+#define _POSIX_C_SOURCE 200809L
+
+#include <jayc/jconfig_binary.h>
+#include <jayc/jconfig_dev.h>
+#include <jayc/jutil_alloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jconfig_binary");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Identifies binary config files ( @c "JCFB" on little endian hosts).
+ * 
+ * Read as number, so files with other byte order do not match.
+ */
+#define JCONFIG_BINARY_MAGIC 0x4246434A
+
+/**
+ * @brief Appended to filename for temporary file, when saving.
+ */
+#define JCONFIG_BINARY_SUFFIX_TEMP ".tmp"
+
+/**
+ * @brief Start value of FNV-1a checksum.
+ */
+#define JCONFIG_BINARY_FNV_OFFSET 2166136261u
+
+/**
+ * @brief Multiplier of FNV-1a checksum.
+ */
+#define JCONFIG_BINARY_FNV_PRIME 16777619u
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Header at start of file.
+ */
+typedef struct __jconfig_binary_header
+{
+  uint32_t magic;           /**< @c #JCONFIG_BINARY_MAGIC . */
+  uint16_t version;         /**< Format version. */
+  uint16_t flags;           /**< Reserved, @c 0 . */
+  uint32_t count;           /**< Number of entries. */
+  uint32_t checksum;        /**< Checksum of everything after header. */
+  uint64_t strings_offset;  /**< Start of string table in file. */
+  uint64_t strings_size;    /**< Size of string table. */
+} jconfig_binary_header_t;
+
+/**
+ * @brief Index entry of one datapoint.
+ */
+typedef struct __jconfig_binary_entry
+{
+  uint32_t key_offset;      /**< Start of key in string table. */
+  uint32_t key_length;      /**< Length of key without @c '\0' . */
+  uint32_t value_offset;    /**< Start of value in string table. */
+  uint32_t value_length;    /**< Length of value without @c '\0' . */
+} jconfig_binary_entry_t;
+
+/**
+ * @brief Opened binary config file.
+ */
+struct __jconfig_binary
+{
+  void *mapping;                          /**< Mapped file. */
+  size_t mapping_size;                    /**< Size of file. */
+  const jconfig_binary_header_t *header;  /**< Header in mapping. */
+  const jconfig_binary_entry_t *entries;  /**< Index in mapping. */
+  const char *strings;                    /**< String table in mapping. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Continues FNV-1a checksum over data.
+ * 
+ * @param checksum  Checksum of previous data.
+ * @param data      Data to add.
+ * @param size      Size of data.
+ * 
+ * @return          New checksum.
+ */
+static uint32_t jconfig_binary_checksum(uint32_t checksum, const void *data, size_t size);
+
+/**
+ * @brief Writes data to file and adds it to checksum.
+ * 
+ * @param file      File to write to.
+ * @param data      Data to write.
+ * @param size      Size of data.
+ * @param checksum  Checksum to update.
+ * 
+ * @return          @c true , if data was written.
+ * @return          @c false , if error occured.
+ */
+static int jconfig_binary_write(FILE *file, const void *data, size_t size, uint32_t *checksum);
+
+/**
+ * @brief Writes index and string table of config.
+ * 
+ * @param table   Config table to write.
+ * @param file    File to write to (after header).
+ * @param header  Header to fill.
+ * 
+ * @return        @c true , if written successfully.
+ * @return        @c false , if config is too large or error occured.
+ */
+static int jconfig_binary_writeContent(jconfig_t *table, FILE *file, jconfig_binary_header_t *header);
+
+/**
+ * @brief Returns string of string table, after checking bounds.
+ * 
+ * @param binary  File object.
+ * @param offset  Offset in string table.
+ * @param length  Length without @c '\0' .
+ * 
+ * @return        String.
+ * @return        @c NULL , if string is outside of table or not terminated.
+ */
+static const char *jconfig_binary_string(jconfig_binary_t *binary, uint32_t offset, uint32_t length);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jconfig_binary_saveToFile(jconfig_t *table, const char *filename)
+{
+  if(table == NULL || filename == NULL)
+  {
+    return false;
+  }
+
+  size_t filename_length = strlen(filename);
+  char *temp_filename = (char *)JUTIL_ALLOC_MALLOC(filename_length + sizeof(JCONFIG_BINARY_SUFFIX_TEMP));
+  if(temp_filename == NULL)
+  {
+    return false;
+  }
+
+  memcpy(temp_filename, filename, filename_length);
+  memcpy(temp_filename + filename_length, JCONFIG_BINARY_SUFFIX_TEMP, sizeof(JCONFIG_BINARY_SUFFIX_TEMP));
+
+  FILE *file = fopen(temp_filename, "wb");
+  if(file == NULL)
+  {
+    JUTIL_ALLOC_FREE(temp_filename);
+    return false;
+  }
+
+  jconfig_binary_header_t header;
+  memset(&header, 0, sizeof(header));
+
+  /* Header is written last, when counts and checksum are known. */
+  int ret = (fwrite(&header, sizeof(header), 1, file) == 1);
+  ret = ret && jconfig_binary_writeContent(table, file, &header);
+  ret = ret && (fseek(file, 0, SEEK_SET) == 0);
+  ret = ret && (fwrite(&header, sizeof(header), 1, file) == 1);
+  ret = ret && (fflush(file) == 0);
+  ret = ret && (fsync(fileno(file)) == 0);
+
+  if(fclose(file) != 0)
+  {
+    ret = false;
+  }
+
+  if(ret)
+  {
+    ret = (rename(temp_filename, filename) == 0);
+  }
+
+  if(ret == false)
+  {
+    remove(temp_filename);
+  }
+
+  JUTIL_ALLOC_FREE(temp_filename);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_binary_loadFromFile(jconfig_t *table, const char *filename)
+{
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  jconfig_binary_t *binary = jconfig_binary_open(filename, true);
+  if(binary == NULL)
+  {
+    return false;
+  }
+
+  jconfig_datapoint_clear(table);
+
+  size_t strings_size = (size_t)binary->header->strings_size;
+  char *strings = (char *)jutil_arena_allocAligned(table->arena, strings_size, 1);
+  if(strings == NULL)
+  {
+    jconfig_snapshot_publish(table);
+    jconfig_binary_close(binary);
+    return false;
+  }
+
+  /* Values are used from copy of string table, keys are copied by datapoints. */
+  memcpy(strings, binary->strings, strings_size);
+
+  int ret = true;
+  for(uint32_t i = 0; i < binary->header->count; i++)
+  {
+    const jconfig_binary_entry_t *entry = &binary->entries[i];
+
+    if(entry->key_length == 0
+      || jconfig_binary_string(binary, entry->key_offset, entry->key_length) == NULL
+      || jconfig_binary_string(binary, entry->value_offset, entry->value_length) == NULL)
+    {
+      ret = false;
+      break;
+    }
+
+    if(jconfig_datapoint_put(table, strings + entry->key_offset, entry->key_length, strings + entry->value_offset, false) == false)
+    {
+      ret = false;
+      break;
+    }
+  }
+
+  jconfig_snapshot_publish(table);
+  jconfig_binary_close(binary);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_binary_reloadFromFile(jconfig_t *table, const char *filename)
+{
+  if(table == NULL)
+  {
+    return false;
+  }
+
+  jconfig_t *source = jconfig_init();
+  if(source == NULL)
+  {
+    return false;
+  }
+
+  int ret = jconfig_binary_loadFromFile(source, filename) && jconfig_reload(table, source);
+
+  jconfig_free(source);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_binary_t *jconfig_binary_open(const char *filename, int verify)
+{
+  if(filename == NULL)
+  {
+    return NULL;
+  }
+
+  int fd = open(filename, O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+  {
+    return NULL;
+  }
+
+  struct stat file_stat;
+  if(fstat(fd, &file_stat) != 0 || S_ISREG(file_stat.st_mode) == false
+    || (uint64_t)file_stat.st_size < sizeof(jconfig_binary_header_t))
+  {
+    close(fd);
+    return NULL;
+  }
+
+  size_t size = (size_t)file_stat.st_size;
+  void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if(mapping == MAP_FAILED)
+  {
+    return NULL;
+  }
+
+  const jconfig_binary_header_t *header = (const jconfig_binary_header_t *)mapping;
+  uint64_t strings_offset = sizeof(jconfig_binary_header_t) + (uint64_t)header->count * sizeof(jconfig_binary_entry_t);
+
+  int valid = (header->magic == JCONFIG_BINARY_MAGIC
+    && header->version == JCONFIG_BINARY_VERSION
+    && header->strings_offset == strings_offset
+    && header->strings_size <= size
+    && strings_offset + header->strings_size == size);
+
+  if(valid && verify)
+  {
+    uint32_t checksum = jconfig_binary_checksum(JCONFIG_BINARY_FNV_OFFSET, (const char *)mapping + sizeof(jconfig_binary_header_t), size - sizeof(jconfig_binary_header_t));
+    valid = (checksum == header->checksum);
+  }
+
+  if(valid == false)
+  {
+    munmap(mapping, size);
+    return NULL;
+  }
+
+  jconfig_binary_t *binary = (jconfig_binary_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_binary_t));
+  if(binary == NULL)
+  {
+    munmap(mapping, size);
+    return NULL;
+  }
+
+  binary->mapping = mapping;
+  binary->mapping_size = size;
+  binary->header = header;
+  binary->entries = (const jconfig_binary_entry_t *)((const char *)mapping + sizeof(jconfig_binary_header_t));
+  binary->strings = (const char *)mapping + strings_offset;
+
+  /* Lookups jump through index. */
+  posix_madvise(mapping, size, POSIX_MADV_RANDOM);
+
+  return binary;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_binary_close(jconfig_binary_t *binary)
+{
+  if(binary == NULL)
+  {
+    return;
+  }
+
+  munmap(binary->mapping, binary->mapping_size);
+  JUTIL_ALLOC_FREE(binary);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jconfig_binary_get(jconfig_binary_t *binary, const char *key)
+{
+  if(binary == NULL || key == NULL)
+  {
+    return NULL;
+  }
+
+  size_t key_length = strlen(key);
+  if(key_length == 0)
+  {
+    return NULL;
+  }
+
+  size_t low = 0;
+  size_t high = binary->header->count;
+
+  while(low < high)
+  {
+    size_t middle = low + (high - low) / 2;
+    const jconfig_binary_entry_t *entry = &binary->entries[middle];
+
+    const char *entry_key = jconfig_binary_string(binary, entry->key_offset, entry->key_length);
+    if(entry_key == NULL)
+    {
+      return NULL;
+    }
+
+    /* Same order as jconfig_iterate(): bytes first, shorter key wins on equal prefix. */
+    size_t compare_length = (key_length < entry->key_length ? key_length : entry->key_length);
+    int compare = memcmp(key, entry_key, compare_length);
+    if(compare == 0 && key_length != entry->key_length)
+    {
+      compare = (key_length < entry->key_length ? -1 : 1);
+    }
+
+    if(compare == 0)
+    {
+      return jconfig_binary_string(binary, entry->value_offset, entry->value_length);
+    }
+
+    if(compare < 0)
+    {
+      high = middle;
+    }
+    else
+    {
+      low = middle + 1;
+    }
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jconfig_binary_size(jconfig_binary_t *binary)
+{
+  if(binary == NULL)
+  {
+    return 0;
+  }
+
+  return (size_t)binary->header->count;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+uint32_t jconfig_binary_checksum(uint32_t checksum, const void *data, size_t size)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+
+  for(size_t i = 0; i < size; i++)
+  {
+    checksum ^= bytes[i];
+    checksum *= JCONFIG_BINARY_FNV_PRIME;
+  }
+
+  return checksum;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_binary_write(FILE *file, const void *data, size_t size, uint32_t *checksum)
+{
+  if(size == 0)
+  {
+    return true;
+  }
+
+  *checksum = jconfig_binary_checksum(*checksum, data, size);
+  return (fwrite(data, size, 1, file) == 1);
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_binary_writeContent(jconfig_t *table, FILE *file, jconfig_binary_header_t *header)
+{
+  uint32_t checksum = JCONFIG_BINARY_FNV_OFFSET;
+  uint64_t strings_size = 0;
+  uint64_t count = 0;
+  jconfig_datapoint_t *datapoint;
+
+  /* Datapoints are linked in key order, so index is written sorted. */
+  for(datapoint = table->first; datapoint != NULL; datapoint = datapoint->next)
+  {
+    if(datapoint->data == NULL)
+    {
+      return false;
+    }
+
+    size_t value_length = strlen(datapoint->data);
+    uint64_t value_offset = strings_size + datapoint->key_length + 1;
+
+    if(count >= UINT32_MAX || value_offset + value_length >= UINT32_MAX)
+    {
+      return false;
+    }
+
+    jconfig_binary_entry_t entry;
+    entry.key_offset = (uint32_t)strings_size;
+    entry.key_length = (uint32_t)datapoint->key_length;
+    entry.value_offset = (uint32_t)value_offset;
+    entry.value_length = (uint32_t)value_length;
+
+    if(jconfig_binary_write(file, &entry, sizeof(entry), &checksum) == false)
+    {
+      return false;
+    }
+
+    strings_size = value_offset + value_length + 1;
+    count++;
+  }
+
+  for(datapoint = table->first; datapoint != NULL; datapoint = datapoint->next)
+  {
+    if(jconfig_binary_write(file, datapoint->key, datapoint->key_length + 1, &checksum) == false
+      || jconfig_binary_write(file, datapoint->data, strlen(datapoint->data) + 1, &checksum) == false)
+    {
+      return false;
+    }
+  }
+
+  header->magic = JCONFIG_BINARY_MAGIC;
+  header->version = JCONFIG_BINARY_VERSION;
+  header->flags = 0;
+  header->count = (uint32_t)count;
+  header->checksum = checksum;
+  header->strings_offset = sizeof(jconfig_binary_header_t) + count * sizeof(jconfig_binary_entry_t);
+  header->strings_size = strings_size;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jconfig_binary_string(jconfig_binary_t *binary, uint32_t offset, uint32_t length)
+{
+  uint64_t end = (uint64_t)offset + length;
+  if(end >= binary->header->strings_size || binary->strings[end] != 0)
+  {
+    return NULL;
+  }
+
+  return binary->strings + offset;
+}
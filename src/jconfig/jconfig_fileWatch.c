@@ -0,0 +1,203 @@
+/**
+ * @file jconfig_fileWatch.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jconfig_fileWatch with inotify.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for poll() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <jayc/jconfig_fileWatch.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jconfig_fileWatch");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Events of directory, that mean file has new content.
+ */
+#define JCONFIG_FILEWATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO)
+
+/**
+ * @brief Size of buffer for reading events.
+ */
+#define JCONFIG_FILEWATCH_SIZE_BUFFER 4096
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief File watch object.
+ */
+struct __jconfig_fileWatch
+{
+  int fd;         /**< Inotify instance. */
+  int watch;      /**< Watch of directory. */
+  char name[];    /**< Name of file in directory. */
+};
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jconfig_fileWatch_t *jconfig_fileWatch_init(const char *filename)
+{
+  if(filename == NULL)
+  {
+    return NULL;
+  }
+
+  const char *name = strrchr(filename, '/');
+  name = (name ? name + 1 : filename);
+  size_t name_length = strlen(name);
+  if(name_length == 0)
+  {
+    return NULL;
+  }
+
+  /* Directory is everything before name, "." if there is none. */
+  size_t directory_length = (size_t)(name - filename);
+  char *directory = (char *)JUTIL_ALLOC_MALLOC(directory_length + 2);
+  if(directory == NULL)
+  {
+    return NULL;
+  }
+
+  if(directory_length == 0)
+  {
+    strcpy(directory, ".");
+  }
+  else
+  {
+    memcpy(directory, filename, directory_length);
+    directory[directory_length] = 0;
+  }
+
+  jconfig_fileWatch_t *watch = (jconfig_fileWatch_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_fileWatch_t) + name_length + 1);
+  if(watch == NULL)
+  {
+    JUTIL_ALLOC_FREE(directory);
+    return NULL;
+  }
+
+  memcpy(watch->name, name, name_length + 1);
+
+  watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if(watch->fd < 0)
+  {
+    JUTIL_ALLOC_FREE(directory);
+    JUTIL_ALLOC_FREE(watch);
+    return NULL;
+  }
+
+  watch->watch = inotify_add_watch(watch->fd, directory, JCONFIG_FILEWATCH_EVENTS);
+  JUTIL_ALLOC_FREE(directory);
+
+  if(watch->watch < 0)
+  {
+    close(watch->fd);
+    JUTIL_ALLOC_FREE(watch);
+    return NULL;
+  }
+
+  return watch;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_fileWatch_free(jconfig_fileWatch_t *watch)
+{
+  if(watch == NULL)
+  {
+    return;
+  }
+
+  close(watch->fd);
+  JUTIL_ALLOC_FREE(watch);
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_fileWatch_check(jconfig_fileWatch_t *watch, int timeout)
+{
+  if(watch == NULL)
+  {
+    return false;
+  }
+
+  struct pollfd poll_fd;
+  poll_fd.fd = watch->fd;
+  poll_fd.events = POLLIN;
+  poll_fd.revents = 0;
+
+  if(poll(&poll_fd, 1, timeout) <= 0)
+  {
+    return false;
+  }
+
+  _Alignas(struct inotify_event) char buffer[JCONFIG_FILEWATCH_SIZE_BUFFER];
+  int changed = false;
+
+  /* Reads all queued events, so one check covers a burst of writes. */
+  for(;;)
+  {
+    ssize_t size = read(watch->fd, buffer, sizeof(buffer));
+    if(size <= 0)
+    {
+      break;
+    }
+
+    ssize_t position = 0;
+    while(position < size)
+    {
+      const struct inotify_event *event = (const struct inotify_event *)(buffer + position);
+      position += sizeof(struct inotify_event) + event->len;
+
+      if(event->len > 0 && strcmp(event->name, watch->name) == 0)
+      {
+        changed = true;
+      }
+    }
+  }
+
+  return changed;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_fileWatch_getFileDescriptor(jconfig_fileWatch_t *watch)
+{
+  if(watch == NULL)
+  {
+    return -1;
+  }
+
+  return watch->fd;
+}
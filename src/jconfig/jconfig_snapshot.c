@@ -0,0 +1,1175 @@
+/**
+ * @file jconfig_snapshot.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements snapshots of jconfig tables.
+ * 
+ * Every version is a crit-bit tree (like the index of the
+ * table), whose nodes and leaves are reference counted and
+ * never changed, after they were published. Changes copy the
+ * nodes on the path from the root, the copies point to the
+ * same subtrees as the originals. Nodes, that were created
+ * since the last publish, belong to no snapshot yet and are
+ * changed in place, so loading a file does not copy paths
+ * for every key.
+ * 
+ * Readers count themselves, while they take a reference of
+ * the current snapshot. The writer replaces the snapshot and
+ * waits, until no reader is counted, before it drops the
+ * reference of the old snapshot. Readers never wait.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _POSIX_C_SOURCE 200809L /* needed for sched_yield() */
+
+#include <jayc/jconfig_snapshot.h>
+#include <jayc/jconfig_dev.h>
+#include <jayc/jutil_alloc.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jconfig_snapshot");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Checks, if tree pointer is internal node.
+ */
+#define JCONFIG_SNAPSHOT_ISNODE(p) ((uintptr_t)(p) & 1)
+
+/**
+ * @brief Gets internal node from tagged tree pointer.
+ */
+#define JCONFIG_SNAPSHOT_NODE(p) ((jconfig_snapshot_node_t *)((uintptr_t)(p) - 1))
+
+/**
+ * @brief Creates tagged tree pointer from internal node.
+ */
+#define JCONFIG_SNAPSHOT_TAG(n) ((void *)((uintptr_t)(n) + 1))
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Key and value of a version. Never changed.
+ */
+struct __jconfig_snapshot_leaf
+{
+  atomic_size_t references;   /**< Parents and roots pointing to leaf. */
+  const char *data;           /**< Value string, stored after key. */
+  size_t key_length;          /**< Length of @c key . */
+  char key[];                 /**< Key string. */
+};
+
+/**
+ * @brief Internal node of tree.
+ */
+typedef struct __jconfig_snapshot_node
+{
+  atomic_size_t references;   /**< Parents and roots pointing to node. */
+  union
+  {
+    uint64_t version;                         /**< Version, that created node. */
+    struct __jconfig_snapshot_node *pending;  /**< Next node to free, when released. */
+  };
+  void *child[2];             /**< Subtrees with bit not set (@c 0 ) and set (@c 1 ). */
+  size_t byte;                /**< Byte of key, that is checked. */
+  uint8_t otherbits;          /**< All bits set, except checked bit. */
+} jconfig_snapshot_node_t;
+
+/**
+ * @brief Published version.
+ */
+struct __jconfig_snapshot
+{
+  atomic_size_t references;   /**< Readers and table holding snapshot. */
+  void *root;                 /**< Tree of version. */
+  size_t size;                /**< Number of keys. */
+  uint64_t version;           /**< Version number. */
+};
+
+/**
+ * @brief Snapshot data of table.
+ */
+struct __jconfig_snapshot_state
+{
+  _Atomic(jconfig_snapshot_t *) current;  /**< Latest published snapshot. */
+  atomic_size_t readers;                  /**< Readers taking a reference of @c current . */
+  void *root;                             /**< Tree of next version. */
+  size_t size;                            /**< Number of keys in next version. */
+  uint64_t version;                       /**< Number of next version. */
+  int changed;                            /**< @c true , if tree changed since publish. */
+  int failed;                             /**< @c true , if a change could not be stored. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Returns direction to follow at node for key.
+ * 
+ * @param node   Internal node.
+ * @param key    Key to search.
+ * @param length Length of key.
+ * 
+ * @return       @c 0 or @c 1 .
+ */
+static int jconfig_snapshot_direction(jconfig_snapshot_node_t *node, const char *key, size_t length);
+
+/**
+ * @brief Finds leaf, that shares longest prefix with key.
+ * 
+ * Key of leaf has to be compared.
+ * 
+ * @param tree   Tree to search. Must not be empty.
+ * @param key    Key to search.
+ * @param length Length of key.
+ * 
+ * @return       Best matching leaf.
+ */
+static jconfig_snapshot_entry_t *jconfig_snapshot_find(void *tree, const char *key, size_t length);
+
+/**
+ * @brief Returns leaf with lowest key of subtree.
+ * 
+ * @param tree Subtree (tagged node or leaf).
+ * 
+ * @return     Leaf at left edge of subtree.
+ */
+static jconfig_snapshot_entry_t *jconfig_snapshot_first(void *tree);
+
+/**
+ * @brief Returns leaf with next key in subtree.
+ * 
+ * @param tree Subtree, that contains leaf.
+ * @param leaf Previous leaf.
+ * 
+ * @return     Leaf with next higher key.
+ * @return     @c NULL , if @c leaf has highest key of subtree.
+ */
+static jconfig_snapshot_entry_t *jconfig_snapshot_next(void *tree, const jconfig_snapshot_entry_t *leaf);
+
+/**
+ * @brief Finds first leaf with key prefix.
+ * 
+ * @param tree   Tree to search. Must not be empty.
+ * @param prefix Prefix of key.
+ * @param length Length of prefix.
+ * 
+ * @return       Leaf with lowest key, that starts with prefix.
+ * @return       @c NULL , if no key has this prefix.
+ */
+static jconfig_snapshot_entry_t *jconfig_snapshot_findPrefix(void *tree, const char *prefix, size_t length);
+
+/**
+ * @brief Reports differences between two subtrees.
+ * 
+ * @param old_tree  Subtree of old version. Can be @c NULL .
+ * @param new_tree  Subtree of new version at same position. Can be @c NULL .
+ * @param handler   Handler to call for each changed key.
+ * @param ctx       Context pointer passed to handler.
+ * 
+ * @return          Number of changed keys.
+ */
+static size_t jconfig_snapshot_diffTree(void *old_tree, void *new_tree, jconfig_snapshot_diff_handler_t handler, void *ctx);
+
+/**
+ * @brief Parses data at key of snapshot.
+ * 
+ * @param snapshot  Snapshot to search.
+ * @param key       Key to search.
+ * @param type      @c JCONFIG_TYPE_* constant.
+ * @param value     Returns parsed value.
+ * 
+ * @return          @c true , if value was parsed.
+ * @return          @c false , if key does not exist or value is invalid.
+ */
+static int jconfig_snapshot_getTyped(jconfig_snapshot_t *snapshot, const char *key, int type, jconfig_value_t *value);
+
+/**
+ * @brief Takes reference of subtree.
+ * 
+ * @param tree Subtree (tagged node or leaf). Can be @c NULL .
+ */
+static void jconfig_snapshot_ref(void *tree);
+
+/**
+ * @brief Drops reference of subtree and frees unused nodes and leaves.
+ * 
+ * @param tree Subtree (tagged node or leaf). Can be @c NULL .
+ */
+static void jconfig_snapshot_unref(void *tree);
+
+/**
+ * @brief Drops reference of node or leaf.
+ * 
+ * Unused leaves are freed, unused nodes are added
+ * to list, so their children are dropped next.
+ * 
+ * @param tree    Subtree (tagged node or leaf). Can be @c NULL .
+ * @param pending List of nodes to free.
+ */
+static void jconfig_snapshot_drop(void *tree, jconfig_snapshot_node_t **pending);
+
+/**
+ * @brief Makes node writable for next version.
+ * 
+ * Nodes, that can be reached from published snapshots,
+ * are replaced by a copy.
+ * 
+ * @param state Snapshot data of table.
+ * @param where Pointer to node in parent or root.
+ * 
+ * @return      Writable node.
+ * @return      @c NULL , if error occured.
+ */
+static jconfig_snapshot_node_t *jconfig_snapshot_own(jconfig_snapshot_state_t *state, void **where);
+
+/**
+ * @brief Stores key and value in tree of next version.
+ * 
+ * @param state       Snapshot data of table.
+ * @param key         Key string.
+ * @param key_length  Length of key.
+ * @param data        Value string.
+ * 
+ * @return            @c true , if stored.
+ * @return            @c false , if error occured.
+ */
+static int jconfig_snapshot_insert(jconfig_snapshot_state_t *state, const char *key, size_t key_length, const char *data);
+
+/**
+ * @brief Removes key from tree of next version.
+ * 
+ * @param state       Snapshot data of table.
+ * @param key         Key string.
+ * @param key_length  Length of key.
+ * 
+ * @return            @c true , if key was removed or not found.
+ * @return            @c false , if error occured.
+ */
+static int jconfig_snapshot_erase(jconfig_snapshot_state_t *state, const char *key, size_t key_length);
+
+/**
+ * @brief Builds tree of next version from all datapoints of table.
+ * 
+ * @param table Config table with snapshots.
+ * 
+ * @return      @c true , if tree was built.
+ * @return      @c false , if error occured.
+ */
+static int jconfig_snapshot_rebuild(jconfig_t *table);
+
+/**
+ * @brief Publishes tree of next version.
+ * 
+ * @param state Snapshot data of table.
+ * 
+ * @return      @c true , if published.
+ * @return      @c false , if error occured.
+ */
+static int jconfig_snapshot_swap(jconfig_snapshot_state_t *state);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_enable(jconfig_t *table)
+{
+  if(table == NULL)
+  {
+    return false;
+  }
+  if(table->snapshots != NULL)
+  {
+    return true;
+  }
+
+  jconfig_snapshot_state_t *state = (jconfig_snapshot_state_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_snapshot_state_t));
+  if(state == NULL)
+  {
+    return false;
+  }
+
+  atomic_init(&state->current, NULL);
+  atomic_init(&state->readers, 0);
+  state->root = NULL;
+  state->size = 0;
+  state->version = 1;
+  state->changed = false;
+  state->failed = false;
+
+  table->snapshots = state;
+
+  /* First version is published, even during batch, so readers never get NULL. */
+  if(jconfig_snapshot_rebuild(table) == false || jconfig_snapshot_swap(state) == false)
+  {
+    jconfig_snapshot_disable(table);
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_disable(jconfig_t *table)
+{
+  if(table == NULL || table->snapshots == NULL)
+  {
+    return;
+  }
+
+  jconfig_snapshot_state_t *state = table->snapshots;
+  table->snapshots = NULL;
+
+  jconfig_snapshot_release(atomic_load(&state->current));
+  jconfig_snapshot_unref(state->root);
+  JUTIL_ALLOC_FREE(state);
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_t *jconfig_snapshot(jconfig_t *table)
+{
+  if(table == NULL || table->snapshots == NULL)
+  {
+    return NULL;
+  }
+
+  jconfig_snapshot_state_t *state = table->snapshots;
+
+  /* While counted, the writer does not drop the snapshot, that was loaded. */
+  atomic_fetch_add(&state->readers, 1);
+  jconfig_snapshot_t *snapshot = atomic_load(&state->current);
+  atomic_fetch_add_explicit(&snapshot->references, 1, memory_order_relaxed);
+  atomic_fetch_sub(&state->readers, 1);
+
+  return snapshot;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_release(jconfig_snapshot_t *snapshot)
+{
+  if(snapshot == NULL)
+  {
+    return;
+  }
+
+  if(atomic_fetch_sub_explicit(&snapshot->references, 1, memory_order_acq_rel) != 1)
+  {
+    return;
+  }
+
+  jconfig_snapshot_unref(snapshot->root);
+  JUTIL_ALLOC_FREE(snapshot);
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_t *jconfig_snapshot_retain(jconfig_snapshot_t *snapshot)
+{
+  if(snapshot != NULL)
+  {
+    atomic_fetch_add_explicit(&snapshot->references, 1, memory_order_relaxed);
+  }
+
+  return snapshot;
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jconfig_snapshot_getVersion(jconfig_snapshot_t *snapshot)
+{
+  if(snapshot == NULL)
+  {
+    return 0;
+  }
+
+  return snapshot->version;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jconfig_snapshot_getCount(jconfig_snapshot_t *snapshot)
+{
+  if(snapshot == NULL)
+  {
+    return 0;
+  }
+
+  return snapshot->size;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jconfig_snapshot_get(jconfig_snapshot_t *snapshot, const char *key)
+{
+  if(snapshot == NULL || key == NULL)
+  {
+    return NULL;
+  }
+  if(snapshot->root == NULL)
+  {
+    return NULL;
+  }
+
+  size_t length = strlen(key);
+  jconfig_snapshot_entry_t *leaf = jconfig_snapshot_find(snapshot->root, key, length);
+  if(leaf->key_length != length || memcmp(leaf->key, key, length) != 0)
+  {
+    return NULL;
+  }
+
+  return leaf->data;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_getInt64(jconfig_snapshot_t *snapshot, const char *key, int64_t *value)
+{
+  jconfig_value_t parsed;
+  if(value == NULL || jconfig_snapshot_getTyped(snapshot, key, JCONFIG_TYPE_INT64, &parsed) == false)
+  {
+    return false;
+  }
+
+  *value = parsed.integer;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_getDouble(jconfig_snapshot_t *snapshot, const char *key, double *value)
+{
+  jconfig_value_t parsed;
+  if(value == NULL || jconfig_snapshot_getTyped(snapshot, key, JCONFIG_TYPE_DOUBLE, &parsed) == false)
+  {
+    return false;
+  }
+
+  *value = parsed.real;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_getBool(jconfig_snapshot_t *snapshot, const char *key, int *value)
+{
+  jconfig_value_t parsed;
+  if(value == NULL || jconfig_snapshot_getTyped(snapshot, key, JCONFIG_TYPE_BOOL, &parsed) == false)
+  {
+    return false;
+  }
+
+  *value = (int)parsed.integer;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_getDuration(jconfig_snapshot_t *snapshot, const char *key, int64_t *nanoseconds)
+{
+  jconfig_value_t parsed;
+  if(nanoseconds == NULL || jconfig_snapshot_getTyped(snapshot, key, JCONFIG_TYPE_DURATION, &parsed) == false)
+  {
+    return false;
+  }
+
+  *nanoseconds = parsed.integer;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_getSize(jconfig_snapshot_t *snapshot, const char *key, uint64_t *bytes)
+{
+  jconfig_value_t parsed;
+  if(bytes == NULL || jconfig_snapshot_getTyped(snapshot, key, JCONFIG_TYPE_SIZE, &parsed) == false)
+  {
+    return false;
+  }
+
+  *bytes = parsed.size;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+const jconfig_snapshot_entry_t *jconfig_snapshot_iterate(jconfig_snapshot_t *snapshot, const char *prefix, const jconfig_snapshot_entry_t *itr)
+{
+  if(snapshot == NULL || snapshot->root == NULL)
+  {
+    return NULL;
+  }
+
+  size_t length = (prefix ? strlen(prefix) : 0);
+
+  if(itr == NULL)
+  {
+    if(length == 0)
+    {
+      return jconfig_snapshot_first(snapshot->root);
+    }
+
+    return jconfig_snapshot_findPrefix(snapshot->root, prefix, length);
+  }
+
+  jconfig_snapshot_entry_t *leaf = jconfig_snapshot_next(snapshot->root, itr);
+  if(leaf == NULL)
+  {
+    return NULL;
+  }
+
+  if(length > 0 && (leaf->key_length < length || memcmp(leaf->key, prefix, length) != 0))
+  {
+    return NULL;
+  }
+
+  return leaf;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jconfig_snapshot_diff(jconfig_snapshot_t *old_snapshot, jconfig_snapshot_t *new_snapshot, jconfig_snapshot_diff_handler_t handler, void *ctx)
+{
+  if(handler == NULL)
+  {
+    return 0;
+  }
+
+  void *old_tree = (old_snapshot ? old_snapshot->root : NULL);
+  void *new_tree = (new_snapshot ? new_snapshot->root : NULL);
+
+  return jconfig_snapshot_diffTree(old_tree, new_tree, handler, ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jconfig_snapshot_itr_getKey(const jconfig_snapshot_entry_t *itr)
+{
+  if(itr == NULL)
+  {
+    return NULL;
+  }
+
+  return (const char *)itr->key;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jconfig_snapshot_itr_getData(const jconfig_snapshot_entry_t *itr)
+{
+  if(itr == NULL)
+  {
+    return NULL;
+  }
+
+  return itr->data;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_put(jconfig_t *table, const char *key, size_t key_length, const char *data)
+{
+  jconfig_snapshot_state_t *state = table->snapshots;
+  if(state == NULL)
+  {
+    return;
+  }
+
+  /* After an error, the next version is built from the table anyway. */
+  if(state->failed == false && jconfig_snapshot_insert(state, key, key_length, data) == false)
+  {
+    state->failed = true;
+  }
+  state->changed = true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_remove(jconfig_t *table, const char *key, size_t key_length)
+{
+  jconfig_snapshot_state_t *state = table->snapshots;
+  if(state == NULL)
+  {
+    return;
+  }
+
+  if(state->failed == false && jconfig_snapshot_erase(state, key, key_length) == false)
+  {
+    state->failed = true;
+  }
+  state->changed = true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_clear(jconfig_t *table)
+{
+  jconfig_snapshot_state_t *state = table->snapshots;
+  if(state == NULL)
+  {
+    return;
+  }
+
+  jconfig_snapshot_unref(state->root);
+  state->root = NULL;
+  state->size = 0;
+  state->failed = false;
+  state->changed = true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_publish(jconfig_t *table)
+{
+  jconfig_snapshot_state_t *state = table->snapshots;
+  if(state == NULL || table->batch || state->changed == false)
+  {
+    return;
+  }
+
+  /* On errors readers keep the previous version, until the next change. */
+  if(state->failed && jconfig_snapshot_rebuild(table) == false)
+  {
+    return;
+  }
+
+  jconfig_snapshot_swap(state);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_direction(jconfig_snapshot_node_t *node, const char *key, size_t length)
+{
+  uint8_t c = 0;
+  if(node->byte < length)
+  {
+    c = (uint8_t)key[node->byte];
+  }
+
+  return (1 + (node->otherbits | c)) >> 8;
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_entry_t *jconfig_snapshot_find(void *tree, const char *key, size_t length)
+{
+  while(JCONFIG_SNAPSHOT_ISNODE(tree))
+  {
+    jconfig_snapshot_node_t *node = JCONFIG_SNAPSHOT_NODE(tree);
+    tree = node->child[jconfig_snapshot_direction(node, key, length)];
+  }
+
+  return (jconfig_snapshot_entry_t *)tree;
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_entry_t *jconfig_snapshot_first(void *tree)
+{
+  while(JCONFIG_SNAPSHOT_ISNODE(tree))
+  {
+    tree = JCONFIG_SNAPSHOT_NODE(tree)->child[0];
+  }
+
+  return (jconfig_snapshot_entry_t *)tree;
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_entry_t *jconfig_snapshot_next(void *tree, const jconfig_snapshot_entry_t *leaf)
+{
+  /* Next key is lowest of right subtree, where path to leaf last went left. */
+  void *next = NULL;
+  while(JCONFIG_SNAPSHOT_ISNODE(tree))
+  {
+    jconfig_snapshot_node_t *node = JCONFIG_SNAPSHOT_NODE(tree);
+    int direction = jconfig_snapshot_direction(node, leaf->key, leaf->key_length);
+    if(direction == 0)
+    {
+      next = node->child[1];
+    }
+    tree = node->child[direction];
+  }
+
+  if(next == NULL)
+  {
+    return NULL;
+  }
+
+  return jconfig_snapshot_first(next);
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_entry_t *jconfig_snapshot_findPrefix(void *tree, const char *prefix, size_t length)
+{
+  /* Subtree below last node, that checks a byte of prefix. */
+  void *p = tree;
+  void *top = p;
+  while(JCONFIG_SNAPSHOT_ISNODE(p))
+  {
+    jconfig_snapshot_node_t *node = JCONFIG_SNAPSHOT_NODE(p);
+    p = node->child[jconfig_snapshot_direction(node, prefix, length)];
+    if(node->byte < length)
+    {
+      top = p;
+    }
+  }
+
+  /* All keys of subtree share the checked bytes, so one has to be compared. */
+  jconfig_snapshot_entry_t *leaf = (jconfig_snapshot_entry_t *)p;
+  if(leaf->key_length < length || memcmp(leaf->key, prefix, length) != 0)
+  {
+    return NULL;
+  }
+
+  return jconfig_snapshot_first(top);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jconfig_snapshot_diffTree(void *old_tree, void *new_tree, jconfig_snapshot_diff_handler_t handler, void *ctx)
+{
+  if(old_tree == new_tree)
+  {
+    return 0;
+  }
+
+  /* Nodes, that check the same bit, split both key sets the same way. */
+  if(old_tree != NULL && new_tree != NULL && JCONFIG_SNAPSHOT_ISNODE(old_tree) && JCONFIG_SNAPSHOT_ISNODE(new_tree))
+  {
+    jconfig_snapshot_node_t *old_node = JCONFIG_SNAPSHOT_NODE(old_tree);
+    jconfig_snapshot_node_t *new_node = JCONFIG_SNAPSHOT_NODE(new_tree);
+    if(old_node->byte == new_node->byte && old_node->otherbits == new_node->otherbits)
+    {
+      return jconfig_snapshot_diffTree(old_node->child[0], new_node->child[0], handler, ctx)
+        + jconfig_snapshot_diffTree(old_node->child[1], new_node->child[1], handler, ctx);
+    }
+  }
+
+  /* Shapes differ, so keys of both subtrees are merged in order. */
+  size_t changes = 0;
+  jconfig_snapshot_entry_t *old_leaf = (old_tree ? jconfig_snapshot_first(old_tree) : NULL);
+  jconfig_snapshot_entry_t *new_leaf = (new_tree ? jconfig_snapshot_first(new_tree) : NULL);
+
+  while(old_leaf != NULL || new_leaf != NULL)
+  {
+    int compare;
+    if(old_leaf == NULL)
+    {
+      compare = 1;
+    }
+    else if(new_leaf == NULL)
+    {
+      compare = -1;
+    }
+    else
+    {
+      compare = strcmp(old_leaf->key, new_leaf->key);
+    }
+
+    if(compare < 0)
+    {
+      handler(ctx, JCONFIG_CHANGE_REMOVED, old_leaf->key, old_leaf->data, NULL);
+      changes++;
+      old_leaf = jconfig_snapshot_next(old_tree, old_leaf);
+    }
+    else if(compare > 0)
+    {
+      handler(ctx, JCONFIG_CHANGE_ADDED, new_leaf->key, NULL, new_leaf->data);
+      changes++;
+      new_leaf = jconfig_snapshot_next(new_tree, new_leaf);
+    }
+    else
+    {
+      if(old_leaf != new_leaf && strcmp(old_leaf->data, new_leaf->data) != 0)
+      {
+        handler(ctx, JCONFIG_CHANGE_CHANGED, new_leaf->key, old_leaf->data, new_leaf->data);
+        changes++;
+      }
+      old_leaf = jconfig_snapshot_next(old_tree, old_leaf);
+      new_leaf = jconfig_snapshot_next(new_tree, new_leaf);
+    }
+  }
+
+  return changes;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_getTyped(jconfig_snapshot_t *snapshot, const char *key, int type, jconfig_value_t *value)
+{
+  const char *data = jconfig_snapshot_get(snapshot, key);
+  if(data == NULL)
+  {
+    return false;
+  }
+
+  return jconfig_value_parse(data, type, value);
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_ref(void *tree)
+{
+  if(tree == NULL)
+  {
+    return;
+  }
+
+  if(JCONFIG_SNAPSHOT_ISNODE(tree))
+  {
+    atomic_fetch_add_explicit(&JCONFIG_SNAPSHOT_NODE(tree)->references, 1, memory_order_relaxed);
+  }
+  else
+  {
+    atomic_fetch_add_explicit(&((jconfig_snapshot_entry_t *)tree)->references, 1, memory_order_relaxed);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_unref(void *tree)
+{
+  jconfig_snapshot_node_t *pending = NULL;
+  jconfig_snapshot_drop(tree, &pending);
+
+  /* Unused nodes are kept in a list instead of recursion, as trees can be deep. */
+  while(pending != NULL)
+  {
+    jconfig_snapshot_node_t *node = pending;
+    pending = node->pending;
+
+    jconfig_snapshot_drop(node->child[0], &pending);
+    jconfig_snapshot_drop(node->child[1], &pending);
+    JUTIL_ALLOC_FREE(node);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jconfig_snapshot_drop(void *tree, jconfig_snapshot_node_t **pending)
+{
+  if(tree == NULL)
+  {
+    return;
+  }
+
+  if(JCONFIG_SNAPSHOT_ISNODE(tree))
+  {
+    jconfig_snapshot_node_t *node = JCONFIG_SNAPSHOT_NODE(tree);
+    if(atomic_fetch_sub_explicit(&node->references, 1, memory_order_acq_rel) == 1)
+    {
+      node->pending = *pending;
+      *pending = node;
+    }
+  }
+  else
+  {
+    jconfig_snapshot_entry_t *leaf = (jconfig_snapshot_entry_t *)tree;
+    if(atomic_fetch_sub_explicit(&leaf->references, 1, memory_order_acq_rel) == 1)
+    {
+      JUTIL_ALLOC_FREE(leaf);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jconfig_snapshot_node_t *jconfig_snapshot_own(jconfig_snapshot_state_t *state, void **where)
+{
+  jconfig_snapshot_node_t *node = JCONFIG_SNAPSHOT_NODE(*where);
+
+  /* Only parent in next version points to node, if all snapshots with it were released. */
+  if(node->version == state->version || atomic_load_explicit(&node->references, memory_order_acquire) == 1)
+  {
+    node->version = state->version;
+    return node;
+  }
+
+  jconfig_snapshot_node_t *copy = (jconfig_snapshot_node_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_snapshot_node_t));
+  if(copy == NULL)
+  {
+    return NULL;
+  }
+
+  atomic_init(&copy->references, 1);
+  copy->version = state->version;
+  copy->child[0] = node->child[0];
+  copy->child[1] = node->child[1];
+  copy->byte = node->byte;
+  copy->otherbits = node->otherbits;
+
+  jconfig_snapshot_ref(copy->child[0]);
+  jconfig_snapshot_ref(copy->child[1]);
+
+  *where = JCONFIG_SNAPSHOT_TAG(copy);
+  jconfig_snapshot_unref(JCONFIG_SNAPSHOT_TAG(node));
+  return copy;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_insert(jconfig_snapshot_state_t *state, const char *key, size_t key_length, const char *data)
+{
+  jconfig_snapshot_entry_t *best = NULL;
+  int replace = false;
+
+  if(state->root != NULL)
+  {
+    best = jconfig_snapshot_find(state->root, key, key_length);
+    if(best->key_length == key_length && memcmp(best->key, key, key_length) == 0)
+    {
+      if(strcmp(best->data, data) == 0)
+      {
+        return true;
+      }
+      replace = true;
+    }
+  }
+
+  /* Value is stored behind key, so leaf is one allocation. */
+  size_t data_size = strlen(data) + 1;
+  jconfig_snapshot_entry_t *leaf = (jconfig_snapshot_entry_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_snapshot_entry_t) + key_length + 1 + data_size);
+  if(leaf == NULL)
+  {
+    return false;
+  }
+
+  atomic_init(&leaf->references, 1);
+  memcpy(leaf->key, key, key_length);
+  leaf->key[key_length] = 0;
+  leaf->key_length = key_length;
+  memcpy(leaf->key + key_length + 1, data, data_size);
+  leaf->data = leaf->key + key_length + 1;
+
+  if(state->root == NULL)
+  {
+    state->root = leaf;
+    state->size = 1;
+    return true;
+  }
+
+  void **where = &state->root;
+
+  if(replace)
+  {
+    while(JCONFIG_SNAPSHOT_ISNODE(*where))
+    {
+      jconfig_snapshot_node_t *node = jconfig_snapshot_own(state, where);
+      if(node == NULL)
+      {
+        JUTIL_ALLOC_FREE(leaf);
+        return false;
+      }
+      where = &node->child[jconfig_snapshot_direction(node, key, key_length)];
+    }
+
+    jconfig_snapshot_unref(*where);
+    *where = leaf;
+    return true;
+  }
+
+  /* Keys are unique and contain no terminator, so they differ at the latest after the shorter one. */
+  size_t byte = 0;
+  uint8_t c_best;
+  uint8_t c_key;
+  for(;; byte++)
+  {
+    c_best = (byte < best->key_length ? (uint8_t)best->key[byte] : 0);
+    c_key = (byte < key_length ? (uint8_t)key[byte] : 0);
+    if(c_best != c_key)
+    {
+      break;
+    }
+  }
+
+  uint8_t bits = c_best ^ c_key;
+  while(bits & (bits - 1))
+  {
+    bits &= bits - 1;
+  }
+  uint8_t otherbits = bits ^ 255;
+  int direction = (1 + (otherbits | c_best)) >> 8;
+
+  jconfig_snapshot_node_t *new_node = (jconfig_snapshot_node_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_snapshot_node_t));
+  if(new_node == NULL)
+  {
+    JUTIL_ALLOC_FREE(leaf);
+    return false;
+  }
+
+  atomic_init(&new_node->references, 1);
+  new_node->version = state->version;
+  new_node->byte = byte;
+  new_node->otherbits = otherbits;
+  new_node->child[1 - direction] = leaf;
+
+  /* Nodes are ordered by checked bit from root to leaves. */
+  while(JCONFIG_SNAPSHOT_ISNODE(*where))
+  {
+    jconfig_snapshot_node_t *node = JCONFIG_SNAPSHOT_NODE(*where);
+    if(node->byte > byte || (node->byte == byte && node->otherbits > otherbits))
+    {
+      break;
+    }
+
+    node = jconfig_snapshot_own(state, where);
+    if(node == NULL)
+    {
+      JUTIL_ALLOC_FREE(new_node);
+      JUTIL_ALLOC_FREE(leaf);
+      return false;
+    }
+    where = &node->child[jconfig_snapshot_direction(node, key, key_length)];
+  }
+
+  /* Reference of parent moves to new node. */
+  new_node->child[direction] = *where;
+  *where = JCONFIG_SNAPSHOT_TAG(new_node);
+  state->size++;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_erase(jconfig_snapshot_state_t *state, const char *key, size_t key_length)
+{
+  if(state->root == NULL)
+  {
+    return true;
+  }
+
+  /* Paths are only copied, if key exists. */
+  jconfig_snapshot_entry_t *best = jconfig_snapshot_find(state->root, key, key_length);
+  if(best->key_length != key_length || memcmp(best->key, key, key_length) != 0)
+  {
+    return true;
+  }
+
+  void **where = &state->root;
+  void **parent_where = NULL;
+  jconfig_snapshot_node_t *parent = NULL;
+  int direction = 0;
+
+  while(JCONFIG_SNAPSHOT_ISNODE(*where))
+  {
+    parent = jconfig_snapshot_own(state, where);
+    if(parent == NULL)
+    {
+      return false;
+    }
+
+    parent_where = where;
+    direction = jconfig_snapshot_direction(parent, key, key_length);
+    where = &parent->child[direction];
+  }
+
+  jconfig_snapshot_unref(*where);
+
+  if(parent == NULL)
+  {
+    state->root = NULL;
+  }
+  else
+  {
+    /* Parent is only referenced by next version, sibling takes its place. */
+    *parent_where = parent->child[1 - direction];
+    JUTIL_ALLOC_FREE(parent);
+  }
+
+  state->size--;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_rebuild(jconfig_t *table)
+{
+  jconfig_snapshot_state_t *state = table->snapshots;
+
+  jconfig_snapshot_unref(state->root);
+  state->root = NULL;
+  state->size = 0;
+  state->failed = true;
+  state->changed = true;
+
+  jconfig_datapoint_t *datapoint;
+  for(datapoint = table->first; datapoint != NULL; datapoint = datapoint->next)
+  {
+    if(jconfig_snapshot_insert(state, datapoint->key, datapoint->key_length, datapoint->data) == false)
+    {
+      return false;
+    }
+  }
+
+  state->failed = false;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jconfig_snapshot_swap(jconfig_snapshot_state_t *state)
+{
+  jconfig_snapshot_t *snapshot = (jconfig_snapshot_t *)JUTIL_ALLOC_MALLOC(sizeof(jconfig_snapshot_t));
+  if(snapshot == NULL)
+  {
+    return false;
+  }
+
+  atomic_init(&snapshot->references, 1);
+  snapshot->root = state->root;
+  snapshot->size = state->size;
+  snapshot->version = state->version;
+  jconfig_snapshot_ref(snapshot->root);
+
+  /* Published nodes belong to an older version now, so they are copied on change. */
+  state->version++;
+  state->changed = false;
+
+  jconfig_snapshot_t *old = atomic_exchange(&state->current, snapshot);
+
+  /* Readers, that loaded the old snapshot, took their reference, when none is counted. */
+  while(atomic_load(&state->readers) != 0)
+  {
+    sched_yield();
+  }
+
+  jconfig_snapshot_release(old);
+  return true;
+}
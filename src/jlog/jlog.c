@@ -12,11 +12,19 @@
 #include <jayc/jlog.h>
 #include <jayc/jlog_dev.h>
 #include <jayc/jproc.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 
+/**
+ * @brief Allocation statistics of module.
+ */
+JUTIL_ALLOC_MODULE("jlog");
+
 /**
  * @brief Global session object.
  * 
@@ -25,11 +33,35 @@
  */
 static struct __jlog_session *global_session = NULL;
 
+/**
+ * @brief Formats message once and passes it to session handler.
+ * 
+ * Sessions with handler for unformatted messages
+ * get format string and arguments instead.
+ * 
+ * @param session   Session to log with.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called. If @c NULL ,
+ *                  handler without source code info is used.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param args      Arguments for format string.
+ */
+static void jlog_session_log(struct __jlog_session *session, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args);
+
+/**
+ * @brief Counts logged message in metric @c jlog_messages_total .
+ * 
+ * @param log_type  Log type of message.
+ */
+static void jlog_session_count(int log_type);
+
 //------------------------------------------------------------------------------
 //
 jlog_t *jlog_session_quiet()
 {
-  jlog_t *session = (jlog_t *)malloc(sizeof(jlog_t));
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
   if(session == NULL)
   {
     return NULL;
@@ -37,6 +69,7 @@ jlog_t *jlog_session_quiet()
 
   session->log_function = NULL;
   session->log_function_m = NULL;
+  session->log_function_v = NULL;
   session->session_free_handler = NULL;
   session->log_level = 0;
   session->session_context = NULL;
@@ -58,101 +91,51 @@ void jlog_session_free(struct __jlog_session *session)
     session->session_free_handler(session->session_context);
   }
 
-  free(session);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
 //
 void jlog_log_message(struct __jlog_session *session, int log_type, const char *fmt, ...)
 {
-  if(session == NULL)
-  {
-    return;
-  }
-
-  if(session->log_function == NULL)
-  {
-    return;
-  }
-
-  if(log_type < session->log_level)
-  {
-    return;
-  }
-
   va_list args;
-  char buf[2048];
 
   va_start(args, fmt);
-  vsnprintf(buf, sizeof(buf), fmt, args);
-  session->log_function(session->session_context, log_type, buf);
+  jlog_session_log(session, log_type, NULL, NULL, 0, fmt, args);
   va_end(args);
-
-  if(log_type == JLOG_LOGTYPE_FATAL)
-  {
-    jproc_exit(EXIT_FAILURE);
-  }
-
-  #ifdef JLOG_EXIT_ATCRITICAL
-  if(log_type == JLOG_LOGTYPE_CRITICAL)
-  {
-    jproc_exit(EXIT_FAILURE);
-  }
-  #endif /* JLOG_EXIT_ATCRITICAL */
-
-  #ifdef JLOG_EXIT_ATERROR
-  if(log_type == JLOG_LOGTYPE_ERROR)
-  {
-    jproc_exit(EXIT_FAILURE);
-  }
-  #endif /* JLOG_EXIT_ATERROR */
 }
 
 //------------------------------------------------------------------------------
 //
 void jlog_log_message_m(struct __jlog_session *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
-  if(session == NULL)
-  {
-    return;
-  }
-
-  if(session->log_function_m == NULL)
-  {
-    return;
-  }
-
-  if(log_type < session->log_level)
-  {
-    return;
-  }
-
   va_list args;
-  char buf[2048];
 
   va_start(args, fmt);
-  vsnprintf(buf, sizeof(buf), fmt, args);
-  session->log_function_m(session->session_context, log_type, file, function, line, buf);
+  jlog_session_log(session, log_type, file, function, line, fmt, args);
   va_end(args);
+}
 
-  if(log_type == JLOG_LOGTYPE_FATAL)
+//------------------------------------------------------------------------------
+//
+int jlog_isEnabled(struct __jlog_session *session, int log_type)
+{
+  if(session == NULL)
   {
-    jproc_exit(EXIT_FAILURE);
+    session = global_session;
   }
 
-  #ifdef JLOG_EXIT_ATCRITICAL
-  if(log_type == JLOG_LOGTYPE_CRITICAL)
+  if(session == NULL)
   {
-    jproc_exit(EXIT_FAILURE);
+    return false;
   }
-  #endif /* JLOG_EXIT_ATCRITICAL */
 
-  #ifdef JLOG_EXIT_ATERROR
-  if(log_type == JLOG_LOGTYPE_ERROR)
+  if(session->log_function == NULL && session->log_function_m == NULL && session->log_function_v == NULL)
   {
-    jproc_exit(EXIT_FAILURE);
+    return false;
   }
-  #endif /* JLOG_EXIT_ATERROR */
+
+  return (log_type >= session->log_level);
 }
 
 //------------------------------------------------------------------------------
@@ -174,24 +157,25 @@ void jlog_global_session_free()
   if(global_session)
   {
     jlog_session_free(global_session);
+    global_session = NULL;
   }
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_global_log_message(int log_type, const char *fmt, ...)
+int jlog_global_isEnabled(int log_type)
 {
-  if(global_session == NULL)
-  {
-    return;
-  }
+  return jlog_isEnabled(global_session, log_type);
+}
 
+//------------------------------------------------------------------------------
+//
+void jlog_global_log_message(int log_type, const char *fmt, ...)
+{
   va_list args;
-  char buf[2048];
 
   va_start(args, fmt);
-  vsnprintf(buf, sizeof(buf), fmt, args);
-  jlog_log_message(global_session, log_type, buf);
+  jlog_session_log(global_session, log_type, NULL, NULL, 0, fmt, args);
   va_end(args);
 }
 
@@ -199,16 +183,115 @@ void jlog_global_log_message(int log_type, const char *fmt, ...)
 //
 void jlog_global_log_message_m(int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
-  if(global_session == NULL)
+  va_list args;
+
+  va_start(args, fmt);
+  jlog_session_log(global_session, log_type, file, function, line, fmt, args);
+  va_end(args);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_session_log(struct __jlog_session *session, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args)
+{
+  if(session == NULL)
   {
     return;
   }
 
-  va_list args;
-  char buf[2048];
+  if(session->log_function_v == NULL
+    && (file ? (session->log_function_m == NULL) : (session->log_function == NULL)))
+  {
+    return;
+  }
 
-  va_start(args, fmt);
-  vsnprintf(buf, sizeof(buf), fmt, args);
-  jlog_log_message_m(global_session, log_type, file, function, line, buf);
-  va_end(args);
+  if(log_type < session->log_level)
+  {
+    return;
+  }
+
+  if(session->log_function_v)
+  {
+    /* Logger formats message itself, or never. */
+    session->log_function_v(session->session_context, log_type, file, function, line, fmt, args);
+  }
+  else
+  {
+    char buf[2048];
+    vsnprintf(buf, sizeof(buf), fmt, args);
+
+    if(file)
+    {
+      session->log_function_m(session->session_context, log_type, file, function, line, buf);
+    }
+    else
+    {
+      session->log_function(session->session_context, log_type, buf);
+    }
+  }
+
+  jlog_session_count(log_type);
+
+  if(log_type == JLOG_LOGTYPE_FATAL)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+
+  #ifdef JLOG_EXIT_ATCRITICAL
+  if(log_type == JLOG_LOGTYPE_CRITICAL)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+  #endif /* JLOG_EXIT_ATCRITICAL */
+
+  #ifdef JLOG_EXIT_ATERROR
+  if(log_type == JLOG_LOGTYPE_ERROR)
+  {
+    jproc_exit(EXIT_FAILURE);
+  }
+  #endif /* JLOG_EXIT_ATERROR */
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_session_count(int log_type)
+{
+  /* One call site per level, every site caches its own counter. */
+  switch(log_type)
+  {
+    case JLOG_LOGTYPE_DEBUG:
+    {
+      JUTIL_METRICS_COUNTER_ADD("jlog_messages_total{level=\"debug\"}", "Logged messages.", 1);
+      break;
+    }
+    case JLOG_LOGTYPE_INFO:
+    {
+      JUTIL_METRICS_COUNTER_ADD("jlog_messages_total{level=\"info\"}", "Logged messages.", 1);
+      break;
+    }
+    case JLOG_LOGTYPE_WARN:
+    {
+      JUTIL_METRICS_COUNTER_ADD("jlog_messages_total{level=\"warn\"}", "Logged messages.", 1);
+      break;
+    }
+    case JLOG_LOGTYPE_ERROR:
+    {
+      JUTIL_METRICS_COUNTER_ADD("jlog_messages_total{level=\"error\"}", "Logged messages.", 1);
+      break;
+    }
+    case JLOG_LOGTYPE_CRITICAL:
+    {
+      JUTIL_METRICS_COUNTER_ADD("jlog_messages_total{level=\"critical\"}", "Logged messages.", 1);
+      break;
+    }
+    case JLOG_LOGTYPE_FATAL:
+    {
+      JUTIL_METRICS_COUNTER_ADD("jlog_messages_total{level=\"fatal\"}", "Logged messages.", 1);
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
 }
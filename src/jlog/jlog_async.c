@@ -0,0 +1,634 @@
+/**
+ * @file jlog_async.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jlog_async.
+ * 
+ * Records are stored in a ring of fixed size cells.
+ * Log calls reserve a cell by moving the tail with a
+ * compare and swap, copy the message into it and mark
+ * it as filled with a sequence number. The writer thread
+ * takes cells in order from the head, so messages of
+ * one thread keep their order.
+ * 
+ * Messages logged as jutil_buffer are referenced by the
+ * cell and copied into it by the writer thread.
+ * 
+ * The writer waits for notifications, when ring is empty.
+ * Log calls only notify, if it announced to wait.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for strnlen() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <jayc/jlog_async.h>
+#include <jayc/jlog_dev.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_time.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <jayc/jutil_buffer.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jlog_async");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Maximum message length stored in record (same as jlog buffers).
+ */
+#define JLOG_ASYNC_SIZE_MESSAGE 2048
+
+/**
+ * @brief Size of a cache line. Indices are aligned to it.
+ */
+#define JLOG_ASYNC_SIZE_CACHELINE 64
+
+/**
+ * @brief Nanoseconds to sleep, while waiting for writer.
+ */
+#define JLOG_ASYNC_SLEEP_WAIT 10000
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Log message in ring.
+ */
+typedef struct __jlog_async_record
+{
+  atomic_size_t sequence;             /**< Index + 1 , when record was filled. */
+  int log_type;                       /**< Log type of message. */
+  int has_source;                     /**< @c true , if logged with source code information. */
+  const char *file;                   /**< File name in which log was called. */
+  const char *function;               /**< Function name in which log was called. */
+  int line;                           /**< Line number on which log was called. */
+  jutil_buffer_t *buffer;             /**< Reference of message buffer. @c NULL , if stored in @c msg . */
+  char msg[JLOG_ASYNC_SIZE_MESSAGE];  /**< Message string. */
+} jlog_async_record_t;
+
+/**
+ * @brief Session context of jlog_async session.
+ */
+typedef struct __jlog_async_context
+{
+  _Alignas(JLOG_ASYNC_SIZE_CACHELINE)
+  atomic_size_t tail;             /**< Next index to fill. */
+
+  _Alignas(JLOG_ASYNC_SIZE_CACHELINE)
+  atomic_size_t head;             /**< Next index to write. */
+
+  _Alignas(JLOG_ASYNC_SIZE_CACHELINE)
+  atomic_int waiting;             /**< Writer waits for notification. */
+  atomic_size_t dropped;          /**< Number of dropped messages. */
+  size_t dropped_reported;        /**< Dropped messages already reported by writer. */
+  jlog_async_record_t *records;   /**< Ring buffer. */
+  size_t capacity;                /**< Number of records. Power of 2. */
+  int overflow_policy;            /**< What happens, if ring is full. */
+  jlog_t *backend;                /**< Session messages are passed to. */
+  jutil_thread_t *writer;         /**< Writer thread. */
+} jlog_async_context_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Stops writer, writes remaining messages and frees memory.
+ * 
+ * @param ctx Session context to destroy.
+ */
+static void jlog_async_session_free_handler(void *ctx);
+
+/**
+ * @brief Handler to log message.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param msg       Message string to log.
+ */
+static void jlog_async_message_handler(void *ctx, int log_type, const char *msg);
+
+/**
+ * @brief Handler to log message. Contains additional information (filename, function name, line number).
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Message string to log.
+ */
+static void jlog_async_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Stores message in ring.
+ * 
+ * Applies overflow policy, if ring is full.
+ * 
+ * @param context     Session context.
+ * @param log_type    Log type of message.
+ * @param has_source  @c true , if source code information is set.
+ * @param file        File name in which log was called.
+ * @param function    Function name in which log was called.
+ * @param line        Line number on which log was called.
+ * @param msg         Message string to log. Ignored, if @c buffer is set.
+ * @param buffer      Message buffer to reference, or @c NULL .
+ */
+static void jlog_async_push(jlog_async_context_t *context, int log_type, int has_source, const char *file, const char *function, int line, const char *msg, jutil_buffer_t *buffer);
+
+/**
+ * @brief Reserves record for log call.
+ * 
+ * @param context Session context.
+ * @param index   Returns reserved index.
+ * 
+ * @return        @c true , if record was reserved.
+ * @return        @c false , if ring is full.
+ */
+static int jlog_async_reserve(jlog_async_context_t *context, size_t *index);
+
+/**
+ * @brief Passes all filled records to backend.
+ * 
+ * Only called by writer (or after writer is stopped).
+ * 
+ * @param context Session context.
+ */
+static void jlog_async_write(jlog_async_context_t *context);
+
+/**
+ * @brief Checks, if next record is filled.
+ * 
+ * @param context Session context.
+ * 
+ * @return        @c true , if writer can take a record.
+ * @return        @c false , if ring is empty.
+ */
+static int jlog_async_hasRecord(jlog_async_context_t *context);
+
+/**
+ * @brief Passes formatted message to backend.
+ * 
+ * Uses the handler for messages with source code info,
+ * if backend has one, else the plain or unformatted handler.
+ * 
+ * @param backend   Backend session.
+ * @param log_type  Log type of message.
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Formatted message.
+ */
+static void jlog_async_writeMessage(jlog_t *backend, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Calls unformatted handler of backend.
+ * 
+ * @param backend   Backend session with unformatted handler.
+ * @param log_type  Log type of message.
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param ...       Arguments for format string.
+ */
+static void jlog_async_callV(jlog_t *backend, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+/**
+ * @brief Notifies writer, if it is waiting.
+ * 
+ * @param context Session context.
+ */
+static void jlog_async_notify(jlog_async_context_t *context);
+
+/**
+ * @brief Waits, until records reserved so far are written.
+ * 
+ * @param context Session context.
+ */
+static void jlog_async_wait(jlog_async_context_t *context);
+
+/**
+ * @brief Loop function of writer thread.
+ * 
+ * @param ctx     Session context.
+ * @param thread  Writer thread.
+ * 
+ * @return        Always @c true .
+ */
+static int jlog_async_loop(void *ctx, jutil_thread_t *thread);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_async_session_init(jlog_t *backend, size_t capacity, int overflow_policy)
+{
+  if(backend == NULL || capacity == 0 || capacity > (SIZE_MAX / 2) / sizeof(jlog_async_record_t))
+  {
+    return NULL;
+  }
+
+  if(overflow_policy != JLOG_ASYNC_OVERFLOW_DROP
+    && overflow_policy != JLOG_ASYNC_OVERFLOW_BLOCK
+    && overflow_policy != JLOG_ASYNC_OVERFLOW_COUNT)
+  {
+    return NULL;
+  }
+
+  /* Records without source code info and warnings about dropped messages need a plain handler. */
+  if(backend->log_function == NULL && backend->log_function_v == NULL)
+  {
+    return NULL;
+  }
+
+  size_t size = 1;
+  while(size < capacity)
+  {
+    size *= 2;
+  }
+
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  jlog_async_context_t *context = (jlog_async_context_t *)JUTIL_ALLOC_MALLOC_ALIGNED(JLOG_ASYNC_SIZE_CACHELINE, sizeof(jlog_async_context_t));
+  if(context == NULL)
+  {
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  context->records = (jlog_async_record_t *)JUTIL_ALLOC_MALLOC(size * sizeof(jlog_async_record_t));
+  if(context->records == NULL)
+  {
+    JUTIL_ALLOC_FREE_ALIGNED(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  for(size_t i = 0; i < size; i++)
+  {
+    atomic_init(&context->records[i].sequence, i);
+  }
+
+  atomic_init(&context->tail, 0);
+  atomic_init(&context->head, 0);
+  atomic_init(&context->waiting, false);
+  atomic_init(&context->dropped, 0);
+  context->dropped_reported = 0;
+  context->capacity = size;
+  context->overflow_policy = overflow_policy;
+  context->backend = backend;
+
+  /* Writer logs own errors to backend directly, never into ring. */
+  jutil_thread_options_t writer_options = { .name = "jlog-async" };
+  context->writer = jutil_thread_options_init(&jlog_async_loop, backend, 0, 0, context, &writer_options);
+  if(context->writer == NULL)
+  {
+    JUTIL_ALLOC_FREE(context->records);
+    JUTIL_ALLOC_FREE_ALIGNED(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jutil_thread_setWaitPolicy(context->writer, JUTIL_THREAD_WAIT_NOTIFY) == false
+    || jutil_thread_start(context->writer) == false)
+  {
+    jutil_thread_free(context->writer);
+    JUTIL_ALLOC_FREE(context->records);
+    JUTIL_ALLOC_FREE_ALIGNED(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->log_function = &jlog_async_message_handler;
+  session->log_function_m = &jlog_async_message_handler_m;
+  session->log_function_v = NULL;
+  session->session_free_handler = &jlog_async_session_free_handler;
+  session->log_level = backend->log_level;
+  session->session_context = context;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_flush(jlog_t *session)
+{
+  if(session == NULL || session->session_free_handler != &jlog_async_session_free_handler)
+  {
+    return;
+  }
+
+  jlog_async_wait((jlog_async_context_t *)session->session_context);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_logBuffer(jlog_t *session, int log_type, jutil_buffer_t *message)
+{
+  if(session == NULL || message == NULL || jlog_isEnabled(session, log_type) == false)
+  {
+    return;
+  }
+
+  if(session->session_free_handler != &jlog_async_session_free_handler)
+  {
+    char msg[JLOG_ASYNC_SIZE_MESSAGE];
+    size_t length = jutil_buffer_copyOut(message, 0, msg, sizeof(msg) - 1);
+    msg[length] = 0;
+    jlog_log_message(session, log_type, "%s", msg);
+    return;
+  }
+
+  jlog_async_push((jlog_async_context_t *)session->session_context, log_type, false, NULL, NULL, 0, NULL, message);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jlog_async_getDropped(jlog_t *session)
+{
+  if(session == NULL || session->session_free_handler != &jlog_async_session_free_handler)
+  {
+    return 0;
+  }
+
+  jlog_async_context_t *context = (jlog_async_context_t *)session->session_context;
+  return atomic_load_explicit(&context->dropped, memory_order_relaxed);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_session_free_handler(void *ctx)
+{
+  jlog_async_context_t *context = (jlog_async_context_t *)ctx;
+
+  jutil_thread_free(context->writer);
+
+  /* Writer is stopped, records left are written here. */
+  jlog_async_write(context);
+
+  jlog_session_free(context->backend);
+  JUTIL_ALLOC_FREE(context->records);
+  JUTIL_ALLOC_FREE_ALIGNED(context);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_message_handler(void *ctx, int log_type, const char *msg)
+{
+  jlog_async_push((jlog_async_context_t *)ctx, log_type, false, NULL, NULL, 0, msg, NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  jlog_async_push((jlog_async_context_t *)ctx, log_type, true, file, function, line, msg, NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_push(jlog_async_context_t *context, int log_type, int has_source, const char *file, const char *function, int line, const char *msg, jutil_buffer_t *buffer)
+{
+  size_t index;
+  while(jlog_async_reserve(context, &index) == false)
+  {
+    if(context->overflow_policy != JLOG_ASYNC_OVERFLOW_BLOCK)
+    {
+      atomic_fetch_add_explicit(&context->dropped, 1, memory_order_relaxed);
+      JUTIL_METRICS_COUNTER_ADD("jlog_dropped_total", "Log messages dropped by loggers.", 1);
+      return;
+    }
+
+    jutil_time_sleep(0, JLOG_ASYNC_SLEEP_WAIT, false);
+  }
+
+  jlog_async_record_t *record = &context->records[index & (context->capacity - 1)];
+
+  record->log_type = log_type;
+  record->has_source = has_source;
+  record->file = file;
+  record->function = function;
+  record->line = line;
+
+  if(buffer)
+  {
+    record->buffer = jutil_buffer_ref(buffer);
+  }
+  else
+  {
+    size_t length = strnlen(msg, JLOG_ASYNC_SIZE_MESSAGE - 1);
+    record->buffer = NULL;
+    memcpy(record->msg, msg, length);
+    record->msg[length] = 0;
+  }
+
+  atomic_store_explicit(&record->sequence, index + 1, memory_order_release);
+  jlog_async_notify(context);
+
+  /* Program exits after fatal log, so message has to be written now. */
+  if(log_type == JLOG_LOGTYPE_FATAL)
+  {
+    jlog_async_wait(context);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_async_reserve(jlog_async_context_t *context, size_t *index)
+{
+  for(;;)
+  {
+    /* Head is read first, so it is never newer than tail. */
+    size_t head = atomic_load_explicit(&context->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&context->tail, memory_order_relaxed);
+
+    if(tail - head >= context->capacity)
+    {
+      return false;
+    }
+
+    if(atomic_compare_exchange_weak_explicit(&context->tail, &tail, tail + 1, memory_order_relaxed, memory_order_relaxed))
+    {
+      *index = tail;
+      return true;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_write(jlog_async_context_t *context)
+{
+  jlog_t *backend = context->backend;
+  size_t mask = context->capacity - 1;
+  size_t head = atomic_load_explicit(&context->head, memory_order_relaxed);
+
+  for(;;)
+  {
+    jlog_async_record_t *record = &context->records[head & mask];
+    if(atomic_load_explicit(&record->sequence, memory_order_acquire) != head + 1)
+    {
+      break;
+    }
+
+    /* Cell belongs to writer, until head is moved. */
+    if(record->buffer)
+    {
+      size_t length = jutil_buffer_copyOut(record->buffer, 0, record->msg, JLOG_ASYNC_SIZE_MESSAGE - 1);
+      record->msg[length] = 0;
+      jutil_buffer_free(record->buffer);
+      record->buffer = NULL;
+    }
+
+    if(record->has_source)
+    {
+      jlog_async_writeMessage(backend, record->log_type, record->file, record->function, record->line, record->msg);
+    }
+    else
+    {
+      jlog_async_writeMessage(backend, record->log_type, NULL, NULL, 0, record->msg);
+    }
+
+    /* Log calls may reuse record, after it was written. */
+    head++;
+    atomic_store_explicit(&context->head, head, memory_order_release);
+  }
+
+  if(context->overflow_policy != JLOG_ASYNC_OVERFLOW_COUNT)
+  {
+    return;
+  }
+
+  size_t dropped = atomic_load_explicit(&context->dropped, memory_order_relaxed);
+  if(dropped != context->dropped_reported)
+  {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%zu log messages dropped, buffer was full.", dropped - context->dropped_reported);
+    jlog_async_writeMessage(backend, JLOG_LOGTYPE_WARN, NULL, NULL, 0, msg);
+    context->dropped_reported = dropped;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_writeMessage(jlog_t *backend, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  if(file && backend->log_function_m)
+  {
+    backend->log_function_m(backend->session_context, log_type, file, function, line, msg);
+  }
+  else if(backend->log_function_v && (file || backend->log_function == NULL))
+  {
+    jlog_async_callV(backend, log_type, file, function, line, "%s", msg);
+  }
+  else
+  {
+    backend->log_function(backend->session_context, log_type, msg);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_callV(jlog_t *backend, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  backend->log_function_v(backend->session_context, log_type, file, function, line, fmt, args);
+  va_end(args);
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_async_hasRecord(jlog_async_context_t *context)
+{
+  size_t head = atomic_load_explicit(&context->head, memory_order_relaxed);
+  jlog_async_record_t *record = &context->records[head & (context->capacity - 1)];
+
+  return (atomic_load_explicit(&record->sequence, memory_order_acquire) == head + 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_notify(jlog_async_context_t *context)
+{
+  /* Pairs with fence in jlog_async_loop(). */
+  atomic_thread_fence(memory_order_seq_cst);
+
+  if(atomic_load_explicit(&context->waiting, memory_order_relaxed) && atomic_exchange(&context->waiting, false))
+  {
+    jutil_thread_notify(context->writer);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_async_wait(jlog_async_context_t *context)
+{
+  size_t tail = atomic_load_explicit(&context->tail, memory_order_acquire);
+
+  while(atomic_load_explicit(&context->head, memory_order_acquire) < tail)
+  {
+    jlog_async_notify(context);
+    jutil_time_sleep(0, JLOG_ASYNC_SLEEP_WAIT, false);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_async_loop(void *ctx, jutil_thread_t *thread)
+{
+  jlog_async_context_t *context = (jlog_async_context_t *)ctx;
+
+  jlog_async_write(context);
+
+  atomic_store_explicit(&context->waiting, true, memory_order_relaxed);
+
+  /* Log calls either see the flag or their records are seen here. */
+  atomic_thread_fence(memory_order_seq_cst);
+
+  if(jlog_async_hasRecord(context) && atomic_exchange(&context->waiting, false))
+  {
+    jutil_thread_notify(thread);
+  }
+
+  return true;
+}
@@ -0,0 +1,1635 @@
+/**
+ * @file jlog_binary.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jlog_binary.
+ * 
+ * File starts with a header, followed by records. Records start
+ * with size, type and log type. Site records define a call site
+ * with id, line, file, function and format string. Message
+ * records contain time, site id, thread number and arguments.
+ * 
+ * Arguments are stored in order of format string. Integers,
+ * characters, pointers and numbers for '*' are stored as 64 bit,
+ * floating point numbers as @c double and strings with 16 bit
+ * length followed by characters.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for pthread, clock_gettime() and localtime_r() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <jayc/jlog_binary.h>
+#include <jayc/jlog_dev.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jlog_binary");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Magic number at start of file ("JLGB" in little endian).
+ */
+#define JLOG_BINARY_MAGIC 0x42474C4A
+
+/**
+ * @brief Record, that defines call site.
+ */
+#define JLOG_BINARY_RECORD_SITE 1
+
+/**
+ * @brief Record, that contains message.
+ */
+#define JLOG_BINARY_RECORD_MESSAGE 2
+
+/**
+ * @brief Record, that contains message, but not all arguments fit.
+ */
+#define JLOG_BINARY_RECORD_TRUNCATED 3
+
+/**
+ * @brief Size of buffer per thread.
+ */
+#define JLOG_BINARY_SIZE_BUFFER 65536
+
+/**
+ * @brief Max. size of one record.
+ */
+#define JLOG_BINARY_SIZE_RECORD 8192
+
+/**
+ * @brief Max. length of stored strings.
+ */
+#define JLOG_BINARY_SIZE_STRING 2048
+
+/**
+ * @brief Max. length of file and function names in site records.
+ */
+#define JLOG_BINARY_SIZE_NAME 1024
+
+/**
+ * @brief Max. length of format strings in site records.
+ */
+#define JLOG_BINARY_SIZE_FORMAT 4096
+
+/**
+ * @brief Size of decoded message.
+ */
+#define JLOG_BINARY_SIZE_MESSAGE 4096
+
+/**
+ * @brief Number of call sites cached per thread. Must be power of 2.
+ */
+#define JLOG_BINARY_SIZE_CACHE 64
+
+/*
+ * Kinds of conversions in format strings.
+ */
+#define JLOG_BINARY_ARG_NONE    0 /**< No argument ( @c %% or invalid). */
+#define JLOG_BINARY_ARG_INT     1 /**< Signed integer. */
+#define JLOG_BINARY_ARG_UINT    2 /**< Unsigned integer. */
+#define JLOG_BINARY_ARG_CHAR    3 /**< Character. */
+#define JLOG_BINARY_ARG_DOUBLE  4 /**< Floating point number. */
+#define JLOG_BINARY_ARG_STRING  5 /**< String. */
+#define JLOG_BINARY_ARG_POINTER 6 /**< Pointer. */
+#define JLOG_BINARY_ARG_SKIP    7 /**< Pointer argument, that is not stored ( @c %n , @c %ls ). */
+
+/*
+ * Length modifiers of conversions.
+ */
+#define JLOG_BINARY_LENGTH_NONE 0 /**< No modifier. */
+#define JLOG_BINARY_LENGTH_HH   1 /**< @c char */
+#define JLOG_BINARY_LENGTH_H    2 /**< @c short */
+#define JLOG_BINARY_LENGTH_L    3 /**< @c long */
+#define JLOG_BINARY_LENGTH_LL   4 /**< @c long @c long */
+#define JLOG_BINARY_LENGTH_J    5 /**< @c intmax_t */
+#define JLOG_BINARY_LENGTH_Z    6 /**< @c size_t */
+#define JLOG_BINARY_LENGTH_T    7 /**< @c ptrdiff_t */
+#define JLOG_BINARY_LENGTH_LD   8 /**< @c long @c double */
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Header at start of file.
+ */
+typedef struct __jlog_binary_fileHeader
+{
+  uint32_t magic;     /**< @c #JLOG_BINARY_MAGIC */
+  uint16_t version;   /**< @c #JLOG_BINARY_VERSION */
+  uint16_t flags;     /**< Reserved, always @c 0 . */
+} jlog_binary_fileHeader_t;
+
+/**
+ * @brief Header of each record.
+ */
+typedef struct __jlog_binary_recordHeader
+{
+  uint32_t size;      /**< Size of record including header. */
+  uint16_t type;      /**< Type of record. */
+  uint16_t log_type;  /**< Log type of message, @c 0 for sites. */
+} jlog_binary_recordHeader_t;
+
+/**
+ * @brief Content of site record. Followed by file, function
+ *        and format string (without terminating 0).
+ */
+typedef struct __jlog_binary_siteRecord
+{
+  uint32_t id;              /**< Id of site, counted up from @c 0 . */
+  int32_t line;             /**< Line number. */
+  uint16_t file_length;     /**< Length of file name. */
+  uint16_t function_length; /**< Length of function name. */
+  uint32_t fmt_length;      /**< Length of format string. */
+} jlog_binary_siteRecord_t;
+
+/**
+ * @brief Content of message record. Followed by arguments.
+ */
+typedef struct __jlog_binary_messageRecord
+{
+  uint64_t time;    /**< Realtime in nanoseconds. */
+  uint32_t id;      /**< Id of site. */
+  uint32_t thread;  /**< Number of thread, counted up from @c 1 . */
+} jlog_binary_messageRecord_t;
+
+/**
+ * @brief Call site of log message.
+ */
+typedef struct __jlog_binary_site
+{
+  const char *fmt;      /**< Format string. */
+  const char *file;     /**< File name or @c NULL . */
+  const char *function; /**< Function name or @c NULL . */
+  int line;             /**< Line number. */
+  uint32_t hash;        /**< Hash of pointers and line. */
+  uint32_t id;          /**< Id written to file. */
+} jlog_binary_site_t;
+
+/**
+ * @brief Parsed conversion of format string.
+ */
+typedef struct __jlog_binary_conversion
+{
+  const char *spec;       /**< Start of conversion ('%'). */
+  size_t spec_length;     /**< Length of conversion. */
+  const char *flags;      /**< Start of flags. */
+  size_t flags_length;    /**< Length of flags. */
+  const char *width;      /**< Start of width digits. */
+  size_t width_length;    /**< Length of width digits. */
+  int width_star;         /**< Width is read from argument. */
+  int precision_star;     /**< Precision is read from argument. */
+  int precision;          /**< Precision given in format string, @c -1 if none. */
+  int length;             /**< Length modifier. */
+  int kind;               /**< Kind of argument. */
+  char conversion;        /**< Conversion character. */
+} jlog_binary_conversion_t;
+
+struct __jlog_binary_context;
+
+/**
+ * @brief Buffer of one thread.
+ */
+typedef struct __jlog_binary_buffer
+{
+  struct __jlog_binary_context *context;              /**< Session context. */
+  struct __jlog_binary_buffer *next;                  /**< Next buffer of session. */
+  uint32_t thread;                                    /**< Number of thread. */
+  size_t length;                                      /**< Bytes used in data. */
+  jlog_binary_site_t cache[JLOG_BINARY_SIZE_CACHE];   /**< Recently used sites. */
+  unsigned char data[JLOG_BINARY_SIZE_BUFFER];        /**< Complete records, not written yet. */
+} jlog_binary_buffer_t;
+
+/**
+ * @brief Context for jlog_binary session.
+ */
+typedef struct __jlog_binary_context
+{
+  int fd;                         /**< Log file. */
+  pthread_mutex_t mutex;          /**< Protects sites, buffer list and thread count. */
+  pthread_key_t key;              /**< Buffer of thread. */
+  jlog_binary_buffer_t *buffers;  /**< Buffers of all threads. */
+  uint32_t thread_count;          /**< Number of threads, that logged. */
+
+  jlog_binary_site_t *sites;      /**< Known sites, index is id. */
+  size_t site_count;              /**< Number of known sites. */
+  size_t site_capacity;           /**< Number of sites allocated. */
+  uint32_t *site_index;           /**< Hash table of site ids + 1, @c 0 is empty. */
+  size_t site_index_size;         /**< Size of hash table (power of 2). */
+} jlog_binary_context_t;
+
+/**
+ * @brief Site read from file.
+ */
+typedef struct __jlog_binary_decodeSite
+{
+  int line;             /**< Line number. */
+  char *file;           /**< File name, empty if none. */
+  char *function;       /**< Function name. */
+  char *fmt;            /**< Format string. */
+} jlog_binary_decodeSite_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Destroys context of session.
+ * 
+ * Writes buffers of all threads first.
+ * 
+ * @param ctx Session context.
+ */
+static void jlog_binary_session_free_handler(void *ctx);
+
+/**
+ * @brief Handler for formatted messages.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param msg       Message string to log.
+ */
+static void jlog_binary_message_handler(void *ctx, int log_type, const char *msg);
+
+/**
+ * @brief Handler for formatted messages with source code info.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Message string to log.
+ */
+static void jlog_binary_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Handler for unformatted messages.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param args      Arguments for format string.
+ */
+static void jlog_binary_message_handler_v(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args);
+
+/**
+ * @brief Stores formatted message as argument of site with format "%s".
+ * 
+ * @param context   Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Always "%s".
+ */
+static void jlog_binary_recordString(jlog_binary_context_t *context, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+/**
+ * @brief Stores message in buffer of thread.
+ * 
+ * @param context   Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param args      Arguments for format string.
+ */
+static void jlog_binary_record(jlog_binary_context_t *context, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args);
+
+/**
+ * @brief Returns buffer of calling thread and creates it, if needed.
+ * 
+ * @param context Session context.
+ * 
+ * @return        Buffer of thread.
+ * @return        @c NULL , if error occured.
+ */
+static jlog_binary_buffer_t *jlog_binary_buffer_get(jlog_binary_context_t *context);
+
+/**
+ * @brief Writes buffer to file.
+ * 
+ * @param buffer Buffer to write.
+ */
+static void jlog_binary_buffer_flush(jlog_binary_buffer_t *buffer);
+
+/**
+ * @brief Writes and frees buffer of exiting thread.
+ * 
+ * @param ptr Buffer of thread.
+ */
+static void jlog_binary_buffer_destructor(void *ptr);
+
+/**
+ * @brief Returns id of call site.
+ * 
+ * Looks in cache of thread first. Unknown sites get a
+ * new id and are written to file.
+ * 
+ * @param buffer  Buffer of thread.
+ * @param site    Site to look for (id is set).
+ * 
+ * @return        @c true , if id was set.
+ * @return        @c false , if error occured.
+ */
+static int jlog_binary_site_get(jlog_binary_buffer_t *buffer, jlog_binary_site_t *site);
+
+/**
+ * @brief Adds site to table of context and writes it to file.
+ * 
+ * Mutex of context has to be locked.
+ * 
+ * @param context Session context.
+ * @param site    New site (id is set).
+ * 
+ * @return        @c true , if site was added.
+ * @return        @c false , if error occured.
+ */
+static int jlog_binary_site_add(jlog_binary_context_t *context, jlog_binary_site_t *site);
+
+/**
+ * @brief Parses one conversion of format string.
+ * 
+ * Used for storing and decoding arguments, so both
+ * read same arguments.
+ * 
+ * @param fmt         Points to '%' in format string.
+ * @param conversion  Parsed conversion.
+ * 
+ * @return            Position after conversion.
+ */
+static const char *jlog_binary_conversion_parse(const char *fmt, jlog_binary_conversion_t *conversion);
+
+/**
+ * @brief Copies data into record, if it fits.
+ * 
+ * @param data      Record data.
+ * @param position  Write position, moved by size.
+ * @param limit     Size available.
+ * @param value     Data to copy.
+ * @param size      Size of data.
+ * 
+ * @return          @c true , if data fits.
+ * @return          @c false , if record is full.
+ */
+static int jlog_binary_put(unsigned char *data, size_t *position, size_t limit, const void *value, size_t size);
+
+/**
+ * @brief Copies data from record, if it is long enough.
+ * 
+ * @param data      Record data.
+ * @param position  Read position, moved by size.
+ * @param limit     Size of record.
+ * @param value     Destination.
+ * @param size      Size of data.
+ * 
+ * @return          @c true , if data was read.
+ * @return          @c false , if record is too short.
+ */
+static int jlog_binary_get(const unsigned char *data, size_t *position, size_t limit, void *value, size_t size);
+
+/**
+ * @brief Writes all data to file descriptor.
+ * 
+ * @param fd    File descriptor.
+ * @param data  Data to write.
+ * @param size  Size of data.
+ * 
+ * @return      @c true , if everything was written.
+ * @return      @c false , if error occured.
+ */
+static int jlog_binary_write(int fd, const void *data, size_t size);
+
+/**
+ * @brief Reads site record and adds it to decoded sites.
+ * 
+ * @param sites     Decoded sites, can be reallocated.
+ * @param count     Number of decoded sites.
+ * @param data      Content of record.
+ * @param size      Size of content.
+ * 
+ * @return          @c true , if site was read.
+ * @return          @c false , if record is invalid or error occured.
+ */
+static int jlog_binary_decodeSite(jlog_binary_decodeSite_t **sites, size_t *count, const unsigned char *data, size_t size);
+
+/**
+ * @brief Renders message record as text line.
+ * 
+ * @param sites     Decoded sites.
+ * @param count     Number of decoded sites.
+ * @param log_type  Log type of message.
+ * @param truncated @c true , if not all arguments fit in record.
+ * @param data      Content of record.
+ * @param size      Size of content.
+ * @param out       Stream to print to.
+ * 
+ * @return          @c true , if message was rendered.
+ * @return          @c false , if record is invalid.
+ */
+static int jlog_binary_decodeMessage(jlog_binary_decodeSite_t *sites, size_t count, int log_type, int truncated, const unsigned char *data, size_t size, FILE *out);
+
+/**
+ * @brief Appends formatted value to decoded message.
+ * 
+ * @param msg     Message buffer of size @c #JLOG_BINARY_SIZE_MESSAGE .
+ * @param length  Length of message, updated.
+ * @param fmt     Format for value.
+ * @param ...     Value.
+ */
+static void jlog_binary_append(char *msg, size_t *length, const char *fmt, ...);
+
+/**
+ * @brief Returns marker for log type.
+ * 
+ * @param log_type  Log type.
+ * 
+ * @return          Marker string.
+ */
+static const char *jlog_binary_typeString(int log_type);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_binary_session_init(int log_level, const char *filename)
+{
+  if(filename == NULL)
+  {
+    return NULL;
+  }
+
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  jlog_binary_context_t *context = (jlog_binary_context_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_binary_context_t));
+  if(context == NULL)
+  {
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  memset(context, 0, sizeof(jlog_binary_context_t));
+
+  context->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+  if(context->fd < 0)
+  {
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  jlog_binary_fileHeader_t header;
+  header.magic = JLOG_BINARY_MAGIC;
+  header.version = JLOG_BINARY_VERSION;
+  header.flags = 0;
+
+  if(jlog_binary_write(context->fd, &header, sizeof(header)) == false)
+  {
+    close(context->fd);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(pthread_key_create(&(context->key), &jlog_binary_buffer_destructor) != 0)
+  {
+    close(context->fd);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(pthread_mutex_init(&(context->mutex), NULL) != 0)
+  {
+    pthread_key_delete(context->key);
+    close(context->fd);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->log_function = &jlog_binary_message_handler;
+  session->log_function_m = &jlog_binary_message_handler_m;
+  session->log_function_v = &jlog_binary_message_handler_v;
+  session->session_free_handler = &jlog_binary_session_free_handler;
+  session->log_level = log_level;
+  session->session_context = context;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_flush(jlog_t *session)
+{
+  if(session == NULL || session->session_free_handler != &jlog_binary_session_free_handler)
+  {
+    return;
+  }
+
+  jlog_binary_context_t *context = (jlog_binary_context_t *)session->session_context;
+  jlog_binary_buffer_t *buffer = (jlog_binary_buffer_t *)pthread_getspecific(context->key);
+
+  if(buffer)
+  {
+    jlog_binary_buffer_flush(buffer);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_decodeFile(const char *filename, FILE *out)
+{
+  if(filename == NULL || out == NULL)
+  {
+    return false;
+  }
+
+  FILE *file = fopen(filename, "rb");
+  if(file == NULL)
+  {
+    return false;
+  }
+
+  jlog_binary_fileHeader_t header;
+  if(fread(&header, sizeof(header), 1, file) != 1
+    || header.magic != JLOG_BINARY_MAGIC
+    || header.version != JLOG_BINARY_VERSION)
+  {
+    fclose(file);
+    return false;
+  }
+
+  unsigned char *data = (unsigned char *)JUTIL_ALLOC_MALLOC(JLOG_BINARY_SIZE_RECORD);
+  if(data == NULL)
+  {
+    fclose(file);
+    return false;
+  }
+
+  jlog_binary_decodeSite_t *sites = NULL;
+  size_t site_count = 0;
+  int ret = false;
+
+  for(;;)
+  {
+    jlog_binary_recordHeader_t record;
+    size_t read_size = fread(&record, 1, sizeof(record), file);
+    if(read_size == 0 && feof(file))
+    {
+      ret = true;
+      break;
+    }
+
+    if(read_size != sizeof(record)
+      || record.size < sizeof(record)
+      || record.size > JLOG_BINARY_SIZE_RECORD)
+    {
+      break;
+    }
+
+    size_t size = record.size - sizeof(record);
+    if(size > 0 && fread(data, size, 1, file) != 1)
+    {
+      break;
+    }
+
+    int valid = true;
+    switch(record.type)
+    {
+      case JLOG_BINARY_RECORD_SITE:
+      {
+        valid = jlog_binary_decodeSite(&sites, &site_count, data, size);
+        break;
+      }
+
+      case JLOG_BINARY_RECORD_MESSAGE:
+      case JLOG_BINARY_RECORD_TRUNCATED:
+      {
+        valid = jlog_binary_decodeMessage(sites, site_count, record.log_type, (record.type == JLOG_BINARY_RECORD_TRUNCATED), data, size, out);
+        break;
+      }
+
+      default:
+      {
+        /* Unknown records are skipped. */
+        break;
+      }
+    }
+
+    if(valid == false)
+    {
+      break;
+    }
+  }
+
+  for(size_t i = 0; i < site_count; i++)
+  {
+    JUTIL_ALLOC_FREE(sites[i].file);
+  }
+
+  JUTIL_ALLOC_FREE(sites);
+  JUTIL_ALLOC_FREE(data);
+  fclose(file);
+  return ret;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_session_free_handler(void *ctx)
+{
+  jlog_binary_context_t *context = (jlog_binary_context_t *)ctx;
+  if(context == NULL)
+  {
+    return;
+  }
+
+  /* Destructors are not called for threads, that exit later. */
+  pthread_key_delete(context->key);
+
+  jlog_binary_buffer_t *buffer = context->buffers;
+  while(buffer)
+  {
+    jlog_binary_buffer_t *next = buffer->next;
+    jlog_binary_buffer_flush(buffer);
+    JUTIL_ALLOC_FREE(buffer);
+    buffer = next;
+  }
+
+  pthread_mutex_destroy(&(context->mutex));
+  close(context->fd);
+  JUTIL_ALLOC_FREE(context->sites);
+  JUTIL_ALLOC_FREE(context->site_index);
+  JUTIL_ALLOC_FREE(context);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_message_handler(void *ctx, int log_type, const char *msg)
+{
+  jlog_binary_recordString((jlog_binary_context_t *)ctx, log_type, NULL, NULL, 0, "%s", msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  jlog_binary_recordString((jlog_binary_context_t *)ctx, log_type, file, function, line, "%s", msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_message_handler_v(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args)
+{
+  jlog_binary_record((jlog_binary_context_t *)ctx, log_type, file, function, line, fmt, args);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_recordString(jlog_binary_context_t *context, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  va_list args;
+
+  va_start(args, fmt);
+  jlog_binary_record(context, log_type, file, function, line, fmt, args);
+  va_end(args);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_record(jlog_binary_context_t *context, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args)
+{
+  if(context == NULL || fmt == NULL)
+  {
+    return;
+  }
+
+  jlog_binary_buffer_t *buffer = jlog_binary_buffer_get(context);
+  if(buffer == NULL)
+  {
+    return;
+  }
+
+  jlog_binary_site_t site;
+  site.fmt = fmt;
+  site.file = file;
+  site.function = function;
+  site.line = line;
+  if(jlog_binary_site_get(buffer, &site) == false)
+  {
+    return;
+  }
+
+  if(sizeof(buffer->data) - buffer->length < JLOG_BINARY_SIZE_RECORD)
+  {
+    jlog_binary_buffer_flush(buffer);
+  }
+
+  unsigned char *data = buffer->data + buffer->length;
+  size_t position = sizeof(jlog_binary_recordHeader_t);
+  int truncated = false;
+
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  jlog_binary_messageRecord_t message;
+  message.time = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+  message.id = site.id;
+  message.thread = buffer->thread;
+  jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &message, sizeof(message));
+
+  /* Walks conversions like printf and stores arguments. */
+  jlog_binary_conversion_t conversion;
+  const char *next = strchr(fmt, '%');
+  while(next && truncated == false)
+  {
+    next = jlog_binary_conversion_parse(next, &conversion);
+
+    int64_t value;
+    int precision = conversion.precision;
+
+    if(conversion.width_star)
+    {
+      value = va_arg(args, int);
+      truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &value, sizeof(value));
+    }
+
+    if(conversion.precision_star)
+    {
+      precision = va_arg(args, int);
+      value = precision;
+      truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &value, sizeof(value));
+    }
+
+    switch(conversion.kind)
+    {
+      case JLOG_BINARY_ARG_INT:
+      {
+        switch(conversion.length)
+        {
+          case JLOG_BINARY_LENGTH_HH: value = (signed char)va_arg(args, int); break;
+          case JLOG_BINARY_LENGTH_H:  value = (short)va_arg(args, int); break;
+          case JLOG_BINARY_LENGTH_L:  value = va_arg(args, long); break;
+          case JLOG_BINARY_LENGTH_LL: value = va_arg(args, long long); break;
+          case JLOG_BINARY_LENGTH_J:  value = va_arg(args, intmax_t); break;
+          case JLOG_BINARY_LENGTH_Z:  value = (int64_t)va_arg(args, size_t); break;
+          case JLOG_BINARY_LENGTH_T:  value = va_arg(args, ptrdiff_t); break;
+          default:                    value = va_arg(args, int); break;
+        }
+
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &value, sizeof(value));
+        break;
+      }
+
+      case JLOG_BINARY_ARG_UINT:
+      {
+        uint64_t unsigned_value;
+        switch(conversion.length)
+        {
+          case JLOG_BINARY_LENGTH_HH: unsigned_value = (unsigned char)va_arg(args, unsigned int); break;
+          case JLOG_BINARY_LENGTH_H:  unsigned_value = (unsigned short)va_arg(args, unsigned int); break;
+          case JLOG_BINARY_LENGTH_L:  unsigned_value = va_arg(args, unsigned long); break;
+          case JLOG_BINARY_LENGTH_LL: unsigned_value = va_arg(args, unsigned long long); break;
+          case JLOG_BINARY_LENGTH_J:  unsigned_value = va_arg(args, uintmax_t); break;
+          case JLOG_BINARY_LENGTH_Z:  unsigned_value = va_arg(args, size_t); break;
+          case JLOG_BINARY_LENGTH_T:  unsigned_value = (uint64_t)va_arg(args, ptrdiff_t); break;
+          default:                    unsigned_value = va_arg(args, unsigned int); break;
+        }
+
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &unsigned_value, sizeof(unsigned_value));
+        break;
+      }
+
+      case JLOG_BINARY_ARG_CHAR:
+      {
+        value = va_arg(args, int);
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &value, sizeof(value));
+        break;
+      }
+
+      case JLOG_BINARY_ARG_DOUBLE:
+      {
+        double double_value;
+        if(conversion.length == JLOG_BINARY_LENGTH_LD)
+        {
+          double_value = (double)va_arg(args, long double);
+        }
+        else
+        {
+          double_value = va_arg(args, double);
+        }
+
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &double_value, sizeof(double_value));
+        break;
+      }
+
+      case JLOG_BINARY_ARG_STRING:
+      {
+        const char *str = va_arg(args, const char *);
+        if(str == NULL)
+        {
+          str = "(null)";
+        }
+
+        /* Precision limits string, it does not have to be terminated then. */
+        size_t limit = JLOG_BINARY_SIZE_STRING;
+        if(precision >= 0 && (size_t)precision < limit)
+        {
+          limit = (size_t)precision;
+        }
+
+        uint16_t length = (uint16_t)strnlen(str, limit);
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &length, sizeof(length));
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, str, length);
+        break;
+      }
+
+      case JLOG_BINARY_ARG_POINTER:
+      {
+        uint64_t pointer_value = (uint64_t)(uintptr_t)va_arg(args, void *);
+        truncated |= !jlog_binary_put(data, &position, JLOG_BINARY_SIZE_RECORD, &pointer_value, sizeof(pointer_value));
+        break;
+      }
+
+      case JLOG_BINARY_ARG_SKIP:
+      {
+        (void)va_arg(args, void *);
+        break;
+      }
+
+      default:
+      {
+        break;
+      }
+    }
+
+    next = strchr(next, '%');
+  }
+
+  jlog_binary_recordHeader_t header;
+  header.size = (uint32_t)position;
+  header.type = (truncated ? JLOG_BINARY_RECORD_TRUNCATED : JLOG_BINARY_RECORD_MESSAGE);
+  header.log_type = (uint16_t)log_type;
+  memcpy(data, &header, sizeof(header));
+
+  buffer->length += position;
+
+  /* Important messages should not get lost, if process crashes. */
+  if(log_type >= JLOG_LOGTYPE_ERROR)
+  {
+    jlog_binary_buffer_flush(buffer);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jlog_binary_buffer_t *jlog_binary_buffer_get(jlog_binary_context_t *context)
+{
+  jlog_binary_buffer_t *buffer = (jlog_binary_buffer_t *)pthread_getspecific(context->key);
+  if(buffer)
+  {
+    return buffer;
+  }
+
+  buffer = (jlog_binary_buffer_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_binary_buffer_t));
+  if(buffer == NULL)
+  {
+    return NULL;
+  }
+
+  memset(buffer->cache, 0, sizeof(buffer->cache));
+  buffer->context = context;
+  buffer->length = 0;
+
+  if(pthread_setspecific(context->key, buffer) != 0)
+  {
+    JUTIL_ALLOC_FREE(buffer);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&(context->mutex));
+  buffer->thread = ++(context->thread_count);
+  buffer->next = context->buffers;
+  context->buffers = buffer;
+  pthread_mutex_unlock(&(context->mutex));
+
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_buffer_flush(jlog_binary_buffer_t *buffer)
+{
+  if(buffer->length == 0)
+  {
+    return;
+  }
+
+  /* File is opened with O_APPEND, so buffers of threads are not mixed. */
+  jlog_binary_write(buffer->context->fd, buffer->data, buffer->length);
+  buffer->length = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_buffer_destructor(void *ptr)
+{
+  jlog_binary_buffer_t *buffer = (jlog_binary_buffer_t *)ptr;
+  jlog_binary_context_t *context = buffer->context;
+
+  jlog_binary_buffer_flush(buffer);
+
+  pthread_mutex_lock(&(context->mutex));
+  jlog_binary_buffer_t **link = &(context->buffers);
+  while(*link && *link != buffer)
+  {
+    link = &((*link)->next);
+  }
+
+  if(*link)
+  {
+    *link = buffer->next;
+  }
+  pthread_mutex_unlock(&(context->mutex));
+
+  JUTIL_ALLOC_FREE(buffer);
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_site_get(jlog_binary_buffer_t *buffer, jlog_binary_site_t *site)
+{
+  uint64_t hash = (uint64_t)(uintptr_t)site->fmt;
+  hash = (hash ^ (uint64_t)(uintptr_t)site->file) * 0x9E3779B97F4A7C15ULL;
+  hash = (hash ^ (uint64_t)(uintptr_t)site->function) * 0x9E3779B97F4A7C15ULL;
+  hash = (hash ^ (uint64_t)(uint32_t)site->line) * 0x9E3779B97F4A7C15ULL;
+  site->hash = (uint32_t)(hash >> 32);
+
+  jlog_binary_site_t *cached = &(buffer->cache[site->hash & (JLOG_BINARY_SIZE_CACHE - 1)]);
+  if(cached->fmt == site->fmt && cached->line == site->line
+    && cached->file == site->file && cached->function == site->function)
+  {
+    site->id = cached->id;
+    return true;
+  }
+
+  jlog_binary_context_t *context = buffer->context;
+  int ret = false;
+
+  pthread_mutex_lock(&(context->mutex));
+
+  if(context->site_index_size > 0)
+  {
+    size_t mask = context->site_index_size - 1;
+    for(size_t i = site->hash & mask; context->site_index[i] != 0; i = (i + 1) & mask)
+    {
+      jlog_binary_site_t *known = &(context->sites[context->site_index[i] - 1]);
+      if(known->fmt == site->fmt && known->line == site->line
+        && known->file == site->file && known->function == site->function)
+      {
+        site->id = known->id;
+        ret = true;
+        break;
+      }
+    }
+  }
+
+  if(ret == false)
+  {
+    ret = jlog_binary_site_add(context, site);
+  }
+
+  pthread_mutex_unlock(&(context->mutex));
+
+  if(ret)
+  {
+    *cached = *site;
+  }
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_site_add(jlog_binary_context_t *context, jlog_binary_site_t *site)
+{
+  if(context->site_count >= UINT32_MAX - 1)
+  {
+    return false;
+  }
+
+  if(context->site_count == context->site_capacity)
+  {
+    size_t capacity = (context->site_capacity ? context->site_capacity * 2 : 64);
+    jlog_binary_site_t *sites = (jlog_binary_site_t *)JUTIL_ALLOC_REALLOC(context->sites, capacity * sizeof(jlog_binary_site_t));
+    if(sites == NULL)
+    {
+      return false;
+    }
+
+    context->sites = sites;
+    context->site_capacity = capacity;
+  }
+
+  /* Hash table stays at most half full. */
+  if((context->site_count + 1) * 2 > context->site_index_size)
+  {
+    size_t size = (context->site_index_size ? context->site_index_size * 2 : 128);
+    uint32_t *index = (uint32_t *)JUTIL_ALLOC_CALLOC(size, sizeof(uint32_t));
+    if(index == NULL)
+    {
+      return false;
+    }
+
+    for(size_t id = 0; id < context->site_count; id++)
+    {
+      size_t i = context->sites[id].hash & (size - 1);
+      while(index[i] != 0)
+      {
+        i = (i + 1) & (size - 1);
+      }
+      index[i] = (uint32_t)id + 1;
+    }
+
+    JUTIL_ALLOC_FREE(context->site_index);
+    context->site_index = index;
+    context->site_index_size = size;
+  }
+
+  site->id = (uint32_t)context->site_count;
+
+  const char *file = (site->file ? site->file : "");
+  const char *function = (site->function ? site->function : "");
+
+  jlog_binary_siteRecord_t record;
+  record.id = site->id;
+  record.line = site->line;
+  record.file_length = (uint16_t)strnlen(file, JLOG_BINARY_SIZE_NAME);
+  record.function_length = (uint16_t)strnlen(function, JLOG_BINARY_SIZE_NAME);
+  record.fmt_length = (uint32_t)strnlen(site->fmt, JLOG_BINARY_SIZE_FORMAT);
+
+  jlog_binary_recordHeader_t header;
+  header.size = (uint32_t)(sizeof(header) + sizeof(record) + record.file_length + record.function_length + record.fmt_length);
+  header.type = JLOG_BINARY_RECORD_SITE;
+  header.log_type = 0;
+
+  unsigned char *data = (unsigned char *)JUTIL_ALLOC_MALLOC(header.size);
+  if(data == NULL)
+  {
+    return false;
+  }
+
+  size_t position = 0;
+  jlog_binary_put(data, &position, header.size, &header, sizeof(header));
+  jlog_binary_put(data, &position, header.size, &record, sizeof(record));
+  jlog_binary_put(data, &position, header.size, file, record.file_length);
+  jlog_binary_put(data, &position, header.size, function, record.function_length);
+  jlog_binary_put(data, &position, header.size, site->fmt, record.fmt_length);
+
+  /* Site is written, before any message of it can be written. */
+  int ret = jlog_binary_write(context->fd, data, position);
+  JUTIL_ALLOC_FREE(data);
+
+  if(ret == false)
+  {
+    return false;
+  }
+
+  context->sites[context->site_count] = *site;
+  context->site_count++;
+
+  size_t i = site->hash & (context->site_index_size - 1);
+  while(context->site_index[i] != 0)
+  {
+    i = (i + 1) & (context->site_index_size - 1);
+  }
+  context->site_index[i] = site->id + 1;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jlog_binary_conversion_parse(const char *fmt, jlog_binary_conversion_t *conversion)
+{
+  const char *position = fmt + 1;
+
+  conversion->spec = fmt;
+  conversion->width_star = false;
+  conversion->precision_star = false;
+  conversion->precision = -1;
+  conversion->length = JLOG_BINARY_LENGTH_NONE;
+  conversion->kind = JLOG_BINARY_ARG_NONE;
+
+  conversion->flags = position;
+  while(*position && strchr("-+ #0'", *position))
+  {
+    position++;
+  }
+  conversion->flags_length = (size_t)(position - conversion->flags);
+
+  conversion->width = position;
+  if(*position == '*')
+  {
+    conversion->width_star = true;
+    position++;
+  }
+  else
+  {
+    while(*position >= '0' && *position <= '9')
+    {
+      position++;
+    }
+  }
+  conversion->width_length = (size_t)(position - conversion->width);
+
+  if(*position == '.')
+  {
+    position++;
+    if(*position == '*')
+    {
+      conversion->precision_star = true;
+      position++;
+    }
+    else
+    {
+      conversion->precision = 0;
+      while(*position >= '0' && *position <= '9')
+      {
+        if(conversion->precision < JLOG_BINARY_SIZE_MESSAGE)
+        {
+          conversion->precision = conversion->precision * 10 + (*position - '0');
+        }
+        position++;
+      }
+    }
+  }
+
+  switch(*position)
+  {
+    case 'h':
+    {
+      conversion->length = (position[1] == 'h' ? JLOG_BINARY_LENGTH_HH : JLOG_BINARY_LENGTH_H);
+      position += (position[1] == 'h' ? 2 : 1);
+      break;
+    }
+    case 'l':
+    {
+      conversion->length = (position[1] == 'l' ? JLOG_BINARY_LENGTH_LL : JLOG_BINARY_LENGTH_L);
+      position += (position[1] == 'l' ? 2 : 1);
+      break;
+    }
+    case 'j': conversion->length = JLOG_BINARY_LENGTH_J; position++; break;
+    case 'z': conversion->length = JLOG_BINARY_LENGTH_Z; position++; break;
+    case 't': conversion->length = JLOG_BINARY_LENGTH_T; position++; break;
+    case 'L': conversion->length = JLOG_BINARY_LENGTH_LD; position++; break;
+    default: break;
+  }
+
+  conversion->conversion = *position;
+  switch(*position)
+  {
+    case 'd':
+    case 'i':
+    {
+      conversion->kind = JLOG_BINARY_ARG_INT;
+      break;
+    }
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    {
+      conversion->kind = JLOG_BINARY_ARG_UINT;
+      break;
+    }
+    case 'c':
+    {
+      conversion->kind = JLOG_BINARY_ARG_CHAR;
+      break;
+    }
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+    {
+      conversion->kind = JLOG_BINARY_ARG_DOUBLE;
+      break;
+    }
+    case 's':
+    {
+      conversion->kind = (conversion->length == JLOG_BINARY_LENGTH_L ? JLOG_BINARY_ARG_SKIP : JLOG_BINARY_ARG_STRING);
+      break;
+    }
+    case 'p':
+    {
+      conversion->kind = JLOG_BINARY_ARG_POINTER;
+      break;
+    }
+    case 'n':
+    {
+      conversion->kind = JLOG_BINARY_ARG_SKIP;
+      break;
+    }
+    default:
+    {
+      break;
+    }
+  }
+
+  if(*position)
+  {
+    position++;
+  }
+
+  conversion->spec_length = (size_t)(position - fmt);
+  return position;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_put(unsigned char *data, size_t *position, size_t limit, const void *value, size_t size)
+{
+  if(size > limit - *position)
+  {
+    return false;
+  }
+
+  memcpy(data + *position, value, size);
+  *position += size;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_get(const unsigned char *data, size_t *position, size_t limit, void *value, size_t size)
+{
+  if(size > limit - *position)
+  {
+    return false;
+  }
+
+  memcpy(value, data + *position, size);
+  *position += size;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_write(int fd, const void *data, size_t size)
+{
+  const unsigned char *position = (const unsigned char *)data;
+
+  while(size > 0)
+  {
+    ssize_t written = write(fd, position, size);
+    if(written < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+
+      return false;
+    }
+
+    position += written;
+    size -= (size_t)written;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_decodeSite(jlog_binary_decodeSite_t **sites, size_t *count, const unsigned char *data, size_t size)
+{
+  jlog_binary_siteRecord_t record;
+  size_t position = 0;
+
+  if(jlog_binary_get(data, &position, size, &record, sizeof(record)) == false
+    || record.id != *count
+    || size - position != (size_t)record.file_length + record.function_length + record.fmt_length)
+  {
+    return false;
+  }
+
+  /* Sites are written in order of ids, so array grows by one. */
+  jlog_binary_decodeSite_t *new_sites = (jlog_binary_decodeSite_t *)JUTIL_ALLOC_REALLOC(*sites, (*count + 1) * sizeof(jlog_binary_decodeSite_t));
+  if(new_sites == NULL)
+  {
+    return false;
+  }
+  *sites = new_sites;
+
+  /* One allocation holds all three strings. */
+  char *strings = (char *)JUTIL_ALLOC_MALLOC(size - position + 3);
+  if(strings == NULL)
+  {
+    return false;
+  }
+
+  jlog_binary_decodeSite_t *site = &(new_sites[*count]);
+  site->line = record.line;
+
+  site->file = strings;
+  memcpy(site->file, data + position, record.file_length);
+  site->file[record.file_length] = 0;
+  position += record.file_length;
+
+  site->function = site->file + record.file_length + 1;
+  memcpy(site->function, data + position, record.function_length);
+  site->function[record.function_length] = 0;
+  position += record.function_length;
+
+  site->fmt = site->function + record.function_length + 1;
+  memcpy(site->fmt, data + position, record.fmt_length);
+  site->fmt[record.fmt_length] = 0;
+
+  (*count)++;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_binary_decodeMessage(jlog_binary_decodeSite_t *sites, size_t count, int log_type, int truncated, const unsigned char *data, size_t size, FILE *out)
+{
+  jlog_binary_messageRecord_t record;
+  size_t position = 0;
+
+  if(jlog_binary_get(data, &position, size, &record, sizeof(record)) == false
+    || record.id >= count)
+  {
+    return false;
+  }
+
+  jlog_binary_decodeSite_t *site = &(sites[record.id]);
+  char msg[JLOG_BINARY_SIZE_MESSAGE];
+  size_t length = 0;
+  msg[0] = 0;
+
+  /* Walks conversions like when storing and formats each one. */
+  const char *text = site->fmt;
+  const char *next = strchr(text, '%');
+  int complete = true;
+  while(next)
+  {
+    jlog_binary_append(msg, &length, "%.*s", (int)(next - text), text);
+
+    jlog_binary_conversion_t conversion;
+    text = jlog_binary_conversion_parse(next, &conversion);
+    next = strchr(text, '%');
+
+    int64_t width = 0;
+    int64_t precision = conversion.precision;
+
+    if((conversion.width_star && jlog_binary_get(data, &position, size, &width, sizeof(width)) == false)
+      || (conversion.precision_star && jlog_binary_get(data, &position, size, &precision, sizeof(precision)) == false))
+    {
+      complete = false;
+      break;
+    }
+
+    /* Format for value: flags, width, precision and conversion for 64 bit types. */
+    char spec[64];
+    int spec_length = snprintf(spec, sizeof(spec), "%%%.*s", (int)(conversion.flags_length < 8 ? conversion.flags_length : 8), conversion.flags);
+    if(conversion.width_star)
+    {
+      spec_length += snprintf(spec + spec_length, sizeof(spec) - spec_length, "%d", (int)width);
+    }
+    else
+    {
+      spec_length += snprintf(spec + spec_length, sizeof(spec) - spec_length, "%.*s", (int)(conversion.width_length < 8 ? conversion.width_length : 8), conversion.width);
+    }
+
+    if(precision >= 0 && precision <= JLOG_BINARY_SIZE_MESSAGE)
+    {
+      spec_length += snprintf(spec + spec_length, sizeof(spec) - spec_length, ".%d", (int)precision);
+    }
+
+    switch(conversion.kind)
+    {
+      case JLOG_BINARY_ARG_INT:
+      case JLOG_BINARY_ARG_UINT:
+      case JLOG_BINARY_ARG_CHAR:
+      {
+        uint64_t value;
+        if(jlog_binary_get(data, &position, size, &value, sizeof(value)) == false)
+        {
+          complete = false;
+          break;
+        }
+
+        if(conversion.kind == JLOG_BINARY_ARG_CHAR)
+        {
+          snprintf(spec + spec_length, sizeof(spec) - spec_length, "c");
+          jlog_binary_append(msg, &length, spec, (int)value);
+        }
+        else if(conversion.kind == JLOG_BINARY_ARG_INT)
+        {
+          snprintf(spec + spec_length, sizeof(spec) - spec_length, "ll%c", conversion.conversion);
+          jlog_binary_append(msg, &length, spec, (long long)value);
+        }
+        else
+        {
+          snprintf(spec + spec_length, sizeof(spec) - spec_length, "ll%c", conversion.conversion);
+          jlog_binary_append(msg, &length, spec, (unsigned long long)value);
+        }
+        break;
+      }
+
+      case JLOG_BINARY_ARG_DOUBLE:
+      {
+        double value;
+        if(jlog_binary_get(data, &position, size, &value, sizeof(value)) == false)
+        {
+          complete = false;
+          break;
+        }
+
+        snprintf(spec + spec_length, sizeof(spec) - spec_length, "%c", conversion.conversion);
+        jlog_binary_append(msg, &length, spec, value);
+        break;
+      }
+
+      case JLOG_BINARY_ARG_STRING:
+      {
+        uint16_t string_length;
+        char str[JLOG_BINARY_SIZE_STRING + 1];
+        if(jlog_binary_get(data, &position, size, &string_length, sizeof(string_length)) == false
+          || string_length > JLOG_BINARY_SIZE_STRING
+          || jlog_binary_get(data, &position, size, str, string_length) == false)
+        {
+          complete = false;
+          break;
+        }
+
+        str[string_length] = 0;
+        snprintf(spec + spec_length, sizeof(spec) - spec_length, "s");
+        jlog_binary_append(msg, &length, spec, str);
+        break;
+      }
+
+      case JLOG_BINARY_ARG_POINTER:
+      {
+        uint64_t value;
+        if(jlog_binary_get(data, &position, size, &value, sizeof(value)) == false)
+        {
+          complete = false;
+          break;
+        }
+
+        snprintf(spec + spec_length, sizeof(spec) - spec_length, "p");
+        jlog_binary_append(msg, &length, spec, (void *)(uintptr_t)value);
+        break;
+      }
+
+      case JLOG_BINARY_ARG_SKIP:
+      {
+        break;
+      }
+
+      default:
+      {
+        /* "%%" prints '%', invalid conversions are printed as they are. */
+        if(conversion.conversion == '%')
+        {
+          jlog_binary_append(msg, &length, "%%");
+        }
+        else
+        {
+          jlog_binary_append(msg, &length, "%.*s", (int)conversion.spec_length, conversion.spec);
+        }
+        break;
+      }
+    }
+
+    if(complete == false)
+    {
+      break;
+    }
+  }
+
+  if(complete)
+  {
+    jlog_binary_append(msg, &length, "%s", text);
+  }
+
+  if(complete == false || truncated)
+  {
+    jlog_binary_append(msg, &length, " <truncated>");
+  }
+
+  time_t seconds = (time_t)(record.time / 1000000000ULL);
+  long microseconds = (long)((record.time % 1000000000ULL) / 1000);
+  struct tm time_info;
+  char time_string[32];
+  if(localtime_r(&seconds, &time_info) == NULL
+    || strftime(time_string, sizeof(time_string), "%Y-%m-%d %H:%M:%S", &time_info) == 0)
+  {
+    time_string[0] = 0;
+  }
+
+  if(site->file[0])
+  {
+    fprintf(out, "%s.%06ld T%u [ %s %s:%d %s() ] %s\n", time_string, microseconds, (unsigned int)record.thread,
+            jlog_binary_typeString(log_type), site->file, site->line, site->function, msg);
+  }
+  else
+  {
+    fprintf(out, "%s.%06ld T%u [ %s ] %s\n", time_string, microseconds, (unsigned int)record.thread,
+            jlog_binary_typeString(log_type), msg);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_binary_append(char *msg, size_t *length, const char *fmt, ...)
+{
+  size_t space = JLOG_BINARY_SIZE_MESSAGE - *length;
+  if(space <= 1)
+  {
+    return;
+  }
+
+  va_list args;
+
+  va_start(args, fmt);
+  int ret = vsnprintf(msg + *length, space, fmt, args);
+  va_end(args);
+
+  if(ret < 0)
+  {
+    return;
+  }
+
+  *length += ((size_t)ret < space ? (size_t)ret : space - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jlog_binary_typeString(int log_type)
+{
+  switch(log_type)
+  {
+    case JLOG_LOGTYPE_DEBUG:    return "=DBG=";
+    case JLOG_LOGTYPE_INFO:     return "=INF=";
+    case JLOG_LOGTYPE_WARN:     return "=WRN=";
+    case JLOG_LOGTYPE_ERROR:    return "=ERR=";
+    case JLOG_LOGTYPE_CRITICAL: return "*CRT*";
+    case JLOG_LOGTYPE_FATAL:    return "**FATAL**";
+    default:                    return "=DBG=";
+  }
+}
@@ -0,0 +1,829 @@
+/**
+ * @file jlog_file.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jlog_file.
+ * 
+ * Two buffers are used. Log calls append to the active one,
+ * the writer thread swaps them and writes the full one
+ * without holding the mutex.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+/* Needed for localtime_r() and fdatasync() */
+#define _POSIX_C_SOURCE 200809L
+
+#include <jayc/jlog_file.h>
+#include <jayc/jlog_dev.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jlog_file");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Size of each of the two buffers.
+ */
+#define JLOG_FILE_SIZE_BUFFER (1024 * 1024)
+
+/**
+ * @brief Max. length of a line. Longer lines are cut off.
+ */
+#define JLOG_FILE_SIZE_LINE 4096
+
+/**
+ * @brief Size of timestamp prefix buffer.
+ */
+#define JLOG_FILE_SIZE_TIMESTAMP 32
+
+/**
+ * @brief Format of timestamp prefix.
+ */
+#define JLOG_FILE_TIMESTAMP_FORMAT "%Y-%m-%d %H:%M:%S "
+
+/**
+ * @brief Max. time between writes in nanoseconds.
+ */
+#define JLOG_FILE_INTERVAL_NS 200000000L
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Context for jlog_file session.
+ */
+typedef struct __jlog_file_context
+{
+  pthread_mutex_t mutex;            /**< Protects buffers, counters and options. */
+  pthread_cond_t cond_written;      /**< Signaled, when writer finished a buffer. */
+  jutil_thread_t *writer;           /**< Writer thread. */
+  jlog_t *writer_logger;            /**< Quiet logger for writer, so it does not log into this session. */
+
+  char *buffers[2];                 /**< Buffers for lines. */
+  size_t lengths[2];                /**< Bytes used in buffers. */
+  int active;                       /**< Index of buffer, log calls append to. */
+  size_t appended;                  /**< Bytes appended since start. */
+  size_t written;                   /**< Bytes written since start. */
+
+  time_t timestamp_second;          /**< Second, timestamp prefix was formatted for. */
+  char timestamp[JLOG_FILE_SIZE_TIMESTAMP]; /**< Cached timestamp prefix. */
+
+  size_t max_size;                  /**< Rotate at this file size, @c 0 if disabled. */
+  long max_age;                     /**< Rotate at this file age in seconds, @c 0 if disabled. */
+  int max_files;                    /**< Number of rotated files to keep. */
+  int sync;                         /**< Call fdatasync() after writes. */
+
+  int fd;                           /**< Current file, only used by writer. */
+  size_t file_size;                 /**< Size of current file. */
+  time_t file_opened;               /**< Time current file was started. */
+  size_t lost;                      /**< Bytes, that could not be written and were not reported yet.
+                                         Only used by writer. */
+  int lost_error;                   /**< errno of last failed write. */
+
+  char filename[];                  /**< Path of log file. */
+} jlog_file_context_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Stops writer, writes rest of lines and destroys context.
+ * 
+ * @param ctx Session context.
+ */
+static void jlog_file_session_free_handler(void *ctx);
+
+/**
+ * @brief Handler to log message.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param msg       Message string to log.
+ */
+static void jlog_file_message_handler(void *ctx, int log_type, const char *msg);
+
+/**
+ * @brief Handler to log message with source code info.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Message string to log.
+ */
+static void jlog_file_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Formats line into active buffer.
+ * 
+ * Waits, if buffer is full. Wakes writer, when buffer
+ * is half full or message is error or above.
+ * 
+ * @param context   Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called. If @c NULL ,
+ *                  no source code info is printed.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Message string to log.
+ */
+static void jlog_file_print(jlog_file_context_t *context, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Waits, until all lines appended so far are written.
+ * 
+ * @param context Session context.
+ */
+static void jlog_file_wait(jlog_file_context_t *context);
+
+/**
+ * @brief Loop of writer thread.
+ * 
+ * Writes active buffer, if it has data, and rotates file.
+ * 
+ * @param ctx     Session context.
+ * @param thread  Writer thread.
+ * 
+ * @return        Always @c true .
+ */
+static int jlog_file_loop(void *ctx, jutil_thread_t *thread);
+
+/**
+ * @brief Writes buffer to current file.
+ * 
+ * Bytes, that could not be written, are counted
+ * in @c jlog_file_context_t#lost .
+ * 
+ * @param context Session context.
+ * @param data    Data to write.
+ * @param size    Size of data.
+ */
+static void jlog_file_write(jlog_file_context_t *context, const char *data, size_t size);
+
+/**
+ * @brief Writes buffer of lines and rotates file before
+ *        it grows beyond @c max_size .
+ * 
+ * Buffer is split after the last line, that fits into the
+ * current file. Lines longer than @c max_size get a file
+ * of their own.
+ * 
+ * Reports lost bytes of earlier writes first.
+ * 
+ * @param context   Session context.
+ * @param data      Lines to write.
+ * @param size      Size of lines.
+ * @param max_size  Size in bytes, at which file is rotated. @c 0 for no limit.
+ * @param max_files Number of rotated files to keep.
+ */
+static void jlog_file_writeLines(jlog_file_context_t *context, const char *data, size_t size, size_t max_size, int max_files);
+
+/**
+ * @brief Writes warning line about lost bytes into file.
+ * 
+ * @param context Session context.
+ */
+static void jlog_file_reportLost(jlog_file_context_t *context);
+
+/**
+ * @brief Opens log file for appending.
+ * 
+ * @param context Session context.
+ * 
+ * @return        @c true , if file was opened.
+ * @return        @c false , if error occured.
+ */
+static int jlog_file_open(jlog_file_context_t *context);
+
+/**
+ * @brief Renames current and old files and opens new file.
+ * 
+ * @param context   Session context.
+ * @param max_files Number of rotated files to keep.
+ */
+static void jlog_file_rotate(jlog_file_context_t *context, int max_files);
+
+/**
+ * @brief Returns session context, if session is a jlog_file session.
+ * 
+ * @param session Session to check.
+ * 
+ * @return        Session context.
+ * @return        @c NULL , if session is not a jlog_file session.
+ */
+static jlog_file_context_t *jlog_file_getContext(jlog_t *session);
+
+/**
+ * @brief Appends string to line.
+ * 
+ * Cuts string off, if line is full. Last byte
+ * is kept free for line break.
+ * 
+ * @param line    Start of line.
+ * @param length  Length of line, updated.
+ * @param str     String to append.
+ */
+static void jlog_file_append(char *line, size_t *length, const char *str);
+
+/**
+ * @brief Appends decimal number to line.
+ * 
+ * @param line    Start of line.
+ * @param length  Length of line, updated.
+ * @param number  Number to append.
+ */
+static void jlog_file_appendNumber(char *line, size_t *length, int number);
+
+/**
+ * @brief Returns marker for log type.
+ * 
+ * @param log_type  Log type.
+ * 
+ * @return          Marker string.
+ */
+static const char *jlog_file_typeString(int log_type);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_file_session_init(int log_level, const char *filename)
+{
+  if(filename == NULL)
+  {
+    return NULL;
+  }
+
+  size_t filename_length = strlen(filename);
+  jlog_file_context_t *context = (jlog_file_context_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_file_context_t) + filename_length + 1);
+  if(context == NULL)
+  {
+    return NULL;
+  }
+
+  memset(context, 0, sizeof(jlog_file_context_t));
+  memcpy(context->filename, filename, filename_length + 1);
+  context->timestamp_second = -1;
+  context->fd = -1;
+
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
+  context->buffers[0] = (char *)JUTIL_ALLOC_MALLOC(JLOG_FILE_SIZE_BUFFER);
+  context->buffers[1] = (char *)JUTIL_ALLOC_MALLOC(JLOG_FILE_SIZE_BUFFER);
+  context->writer_logger = jlog_session_quiet();
+
+  if(session == NULL || context->buffers[0] == NULL || context->buffers[1] == NULL
+    || context->writer_logger == NULL || jlog_file_open(context) == false)
+  {
+    jlog_session_free(context->writer_logger);
+    JUTIL_ALLOC_FREE(context->buffers[0]);
+    JUTIL_ALLOC_FREE(context->buffers[1]);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(pthread_mutex_init(&(context->mutex), NULL) != 0)
+  {
+    close(context->fd);
+    jlog_session_free(context->writer_logger);
+    JUTIL_ALLOC_FREE(context->buffers[0]);
+    JUTIL_ALLOC_FREE(context->buffers[1]);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(pthread_cond_init(&(context->cond_written), NULL) != 0)
+  {
+    pthread_mutex_destroy(&(context->mutex));
+    close(context->fd);
+    jlog_session_free(context->writer_logger);
+    JUTIL_ALLOC_FREE(context->buffers[0]);
+    JUTIL_ALLOC_FREE(context->buffers[1]);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  jutil_thread_options_t writer_options = { .name = "jlog-file" };
+  context->writer = jutil_thread_options_init(&jlog_file_loop, context->writer_logger, 0, JLOG_FILE_INTERVAL_NS, context, &writer_options);
+  if(context->writer == NULL || jutil_thread_start(context->writer) == false)
+  {
+    if(context->writer)
+    {
+      jutil_thread_free(context->writer);
+    }
+
+    pthread_cond_destroy(&(context->cond_written));
+    pthread_mutex_destroy(&(context->mutex));
+    close(context->fd);
+    jlog_session_free(context->writer_logger);
+    JUTIL_ALLOC_FREE(context->buffers[0]);
+    JUTIL_ALLOC_FREE(context->buffers[1]);
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  session->log_function = &jlog_file_message_handler;
+  session->log_function_m = &jlog_file_message_handler_m;
+  session->log_function_v = NULL;
+  session->session_free_handler = &jlog_file_session_free_handler;
+  session->log_level = log_level;
+  session->session_context = context;
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_file_setRotation(jlog_t *session, size_t max_size, long max_age, int max_files)
+{
+  jlog_file_context_t *context = jlog_file_getContext(session);
+  if(context == NULL || max_age < 0 || max_files < 0)
+  {
+    return false;
+  }
+
+  pthread_mutex_lock(&(context->mutex));
+  context->max_size = max_size;
+  context->max_age = max_age;
+  context->max_files = max_files;
+  pthread_mutex_unlock(&(context->mutex));
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_file_setSync(jlog_t *session, int sync)
+{
+  jlog_file_context_t *context = jlog_file_getContext(session);
+  if(context == NULL)
+  {
+    return false;
+  }
+
+  pthread_mutex_lock(&(context->mutex));
+  context->sync = (sync ? true : false);
+  pthread_mutex_unlock(&(context->mutex));
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_flush(jlog_t *session)
+{
+  jlog_file_context_t *context = jlog_file_getContext(session);
+  if(context == NULL)
+  {
+    return;
+  }
+
+  jlog_file_wait(context);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_session_free_handler(void *ctx)
+{
+  jlog_file_context_t *context = (jlog_file_context_t *)ctx;
+  if(context == NULL)
+  {
+    return;
+  }
+
+  /* Writer only swaps, when other buffer is empty. So rest is in active buffer. */
+  jutil_thread_free(context->writer);
+  jlog_file_writeLines(context, context->buffers[context->active], context->lengths[context->active], context->max_size, context->max_files);
+
+  if(context->sync && context->fd >= 0)
+  {
+    fdatasync(context->fd);
+  }
+
+  if(context->fd >= 0)
+  {
+    close(context->fd);
+  }
+
+  pthread_cond_destroy(&(context->cond_written));
+  pthread_mutex_destroy(&(context->mutex));
+  jlog_session_free(context->writer_logger);
+  JUTIL_ALLOC_FREE(context->buffers[0]);
+  JUTIL_ALLOC_FREE(context->buffers[1]);
+  JUTIL_ALLOC_FREE(context);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_message_handler(void *ctx, int log_type, const char *msg)
+{
+  jlog_file_print((jlog_file_context_t *)ctx, log_type, NULL, NULL, 0, msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  jlog_file_print((jlog_file_context_t *)ctx, log_type, file, function, line, msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_print(jlog_file_context_t *context, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  time_t now = time(NULL);
+
+  pthread_mutex_lock(&(context->mutex));
+
+  /* Space for longest line has to be free. Else writer has to swap buffers first. */
+  while(JLOG_FILE_SIZE_BUFFER - context->lengths[context->active] < JLOG_FILE_SIZE_LINE)
+  {
+    jutil_thread_notify(context->writer);
+    pthread_cond_wait(&(context->cond_written), &(context->mutex));
+  }
+
+  if(now != context->timestamp_second)
+  {
+    struct tm time_info;
+    if(localtime_r(&now, &time_info) == NULL
+      || strftime(context->timestamp, sizeof(context->timestamp), JLOG_FILE_TIMESTAMP_FORMAT, &time_info) == 0)
+    {
+      context->timestamp[0] = 0;
+    }
+
+    context->timestamp_second = now;
+  }
+
+  char *buffer = context->buffers[context->active] + context->lengths[context->active];
+  size_t length = 0;
+
+  jlog_file_append(buffer, &length, context->timestamp);
+  jlog_file_append(buffer, &length, "[ ");
+  jlog_file_append(buffer, &length, jlog_file_typeString(log_type));
+
+  if(file)
+  {
+    jlog_file_append(buffer, &length, " ");
+    jlog_file_append(buffer, &length, file);
+    jlog_file_append(buffer, &length, ":");
+    jlog_file_appendNumber(buffer, &length, line);
+    jlog_file_append(buffer, &length, " ");
+    jlog_file_append(buffer, &length, function);
+    jlog_file_append(buffer, &length, "()");
+  }
+
+  jlog_file_append(buffer, &length, " ] ");
+  jlog_file_append(buffer, &length, msg);
+  buffer[length++] = '\n';
+
+  size_t before = context->lengths[context->active];
+  context->lengths[context->active] += length;
+  context->appended += length;
+
+  int notify = (log_type >= JLOG_LOGTYPE_ERROR
+    || (before < JLOG_FILE_SIZE_BUFFER / 2 && context->lengths[context->active] >= JLOG_FILE_SIZE_BUFFER / 2));
+
+  pthread_mutex_unlock(&(context->mutex));
+
+  if(log_type == JLOG_LOGTYPE_FATAL)
+  {
+    /* Process exits after fatal messages. */
+    jlog_file_wait(context);
+  }
+  else if(notify)
+  {
+    jutil_thread_notify(context->writer);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_wait(jlog_file_context_t *context)
+{
+  pthread_mutex_lock(&(context->mutex));
+  size_t target = context->appended;
+
+  while(context->written < target)
+  {
+    jutil_thread_notify(context->writer);
+    pthread_cond_wait(&(context->cond_written), &(context->mutex));
+  }
+
+  pthread_mutex_unlock(&(context->mutex));
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_file_loop(void *ctx, jutil_thread_t *thread)
+{
+  jlog_file_context_t *context = (jlog_file_context_t *)ctx;
+
+  pthread_mutex_lock(&(context->mutex));
+
+  int index = context->active;
+  size_t size = context->lengths[index];
+  if(size > 0)
+  {
+    context->active = !index;
+  }
+
+  size_t max_size = context->max_size;
+  long max_age = context->max_age;
+  int max_files = context->max_files;
+  int sync = context->sync;
+
+  pthread_mutex_unlock(&(context->mutex));
+
+  if(size > 0)
+  {
+    jlog_file_writeLines(context, context->buffers[index], size, max_size, max_files);
+    if(sync && context->fd >= 0)
+    {
+      fdatasync(context->fd);
+    }
+
+    pthread_mutex_lock(&(context->mutex));
+    context->lengths[index] = 0;
+    context->written += size;
+    pthread_cond_broadcast(&(context->cond_written));
+    pthread_mutex_unlock(&(context->mutex));
+  }
+
+  if((max_size > 0 && context->file_size >= max_size)
+    || (max_age > 0 && time(NULL) - context->file_opened >= max_age && context->file_size > 0))
+  {
+    jlog_file_rotate(context, max_files);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_write(jlog_file_context_t *context, const char *data, size_t size)
+{
+  while(size > 0 && context->fd >= 0)
+  {
+    ssize_t written = write(context->fd, data, size);
+    if(written < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+
+      context->lost_error = errno;
+      break;
+    }
+
+    data += written;
+    size -= (size_t)written;
+    context->file_size += (size_t)written;
+  }
+
+  /* Nothing to log to, lines are reported, once writing works again. */
+  if(size > 0)
+  {
+    context->lost += size;
+    JUTIL_METRICS_COUNTER_ADD("jlog_file_lost_bytes_total", "Bytes of log lines, that could not be written.", (unsigned long long)size);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_writeLines(jlog_file_context_t *context, const char *data, size_t size, size_t max_size, int max_files)
+{
+  if(context->lost > 0 && size > 0)
+  {
+    jlog_file_reportLost(context);
+  }
+
+  int rotate_failed = false;
+  while(size > 0)
+  {
+    size_t chunk = size;
+    if(max_size > 0 && context->file_size + size > max_size)
+    {
+      /* Cut after last line, that fits. */
+      size_t space = (context->file_size < max_size ? max_size - context->file_size : 0);
+      chunk = 0;
+      for(size_t i = space; i > 0; i--)
+      {
+        if(data[i - 1] == '\n')
+        {
+          chunk = i;
+          break;
+        }
+      }
+
+      if(chunk == 0)
+      {
+        if(context->file_size > 0 && rotate_failed == false)
+        {
+          jlog_file_rotate(context, max_files);
+          rotate_failed = (context->file_size > 0);
+          continue;
+        }
+
+        /* Line does not fit into empty file, so it is written on its own. */
+        const char *end = (const char *)memchr(data, '\n', size);
+        chunk = (end ? (size_t)(end - data) + 1 : size);
+      }
+    }
+
+    jlog_file_write(context, data, chunk);
+    data += chunk;
+    size -= chunk;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_reportLost(jlog_file_context_t *context)
+{
+  char line[256];
+  size_t length = 0;
+
+  struct tm time_info;
+  time_t now = time(NULL);
+  if(localtime_r(&now, &time_info))
+  {
+    length = strftime(line, sizeof(line), JLOG_FILE_TIMESTAMP_FORMAT, &time_info);
+  }
+
+  int ret = snprintf(line + length, sizeof(line) - length, "[ %s ] %zu bytes of log lines lost, write failed [%d : %s].\n",
+    jlog_file_typeString(JLOG_LOGTYPE_WARN), context->lost, context->lost_error, strerror(context->lost_error));
+  if(ret < 0)
+  {
+    return;
+  }
+  length += ((size_t)ret < sizeof(line) - length ? (size_t)ret : sizeof(line) - length - 1);
+
+  /* Bytes of report are counted again, if writing still fails. */
+  context->lost = 0;
+  jlog_file_write(context, line, length);
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_file_open(jlog_file_context_t *context)
+{
+  context->fd = open(context->filename, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if(context->fd < 0)
+  {
+    return false;
+  }
+
+  struct stat file_info;
+  context->file_size = (fstat(context->fd, &file_info) == 0 ? (size_t)file_info.st_size : 0);
+  context->file_opened = time(NULL);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_rotate(jlog_file_context_t *context, int max_files)
+{
+  size_t name_size = strlen(context->filename) + 16;
+  char *old_name = (char *)JUTIL_ALLOC_MALLOC(name_size);
+  char *new_name = (char *)JUTIL_ALLOC_MALLOC(name_size);
+  if(old_name == NULL || new_name == NULL)
+  {
+    JUTIL_ALLOC_FREE(old_name);
+    JUTIL_ALLOC_FREE(new_name);
+    return;
+  }
+
+  if(max_files == 0)
+  {
+    unlink(context->filename);
+  }
+  else
+  {
+    /* Moves ".N-1" to ".N" down to ".1", oldest file is replaced. */
+    for(int i = max_files; i > 1; i--)
+    {
+      snprintf(old_name, name_size, "%s.%d", context->filename, i - 1);
+      snprintf(new_name, name_size, "%s.%d", context->filename, i);
+      rename(old_name, new_name);
+    }
+
+    snprintf(new_name, name_size, "%s.1", context->filename);
+    rename(context->filename, new_name);
+  }
+
+  JUTIL_ALLOC_FREE(old_name);
+  JUTIL_ALLOC_FREE(new_name);
+
+  int old_fd = context->fd;
+  if(jlog_file_open(context))
+  {
+    close(old_fd);
+  }
+  else
+  {
+    /* Keeps writing to renamed file, tries again next time. */
+    context->fd = old_fd;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jlog_file_context_t *jlog_file_getContext(jlog_t *session)
+{
+  if(session == NULL || session->session_free_handler != &jlog_file_session_free_handler)
+  {
+    return NULL;
+  }
+
+  return (jlog_file_context_t *)session->session_context;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_append(char *line, size_t *length, const char *str)
+{
+  if(str == NULL)
+  {
+    str = "(null)";
+  }
+
+  size_t str_length = strlen(str);
+  size_t space = JLOG_FILE_SIZE_LINE - 1 - *length;
+  if(str_length > space)
+  {
+    str_length = space;
+  }
+
+  memcpy(line + *length, str, str_length);
+  *length += str_length;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_file_appendNumber(char *line, size_t *length, int number)
+{
+  char digits[16];
+  snprintf(digits, sizeof(digits), "%d", number);
+  jlog_file_append(line, length, digits);
+}
+
+//------------------------------------------------------------------------------
+//
+const char *jlog_file_typeString(int log_type)
+{
+  switch(log_type)
+  {
+    case JLOG_LOGTYPE_DEBUG:    return "=DBG=";
+    case JLOG_LOGTYPE_INFO:     return "=INF=";
+    case JLOG_LOGTYPE_WARN:     return "=WRN=";
+    case JLOG_LOGTYPE_ERROR:    return "=ERR=";
+    case JLOG_LOGTYPE_CRITICAL: return "*CRT*";
+    case JLOG_LOGTYPE_FATAL:    return "**FATAL**";
+    default:                    return "=DBG=";
+  }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file jlog_ratelimit.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jlog_ratelimit.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for CLOCK_MONOTONIC_COARSE */
+
+#include <jayc/jlog_ratelimit.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Clock used for intervals.
+ * 
+ * Coarse clock is enough for intervals and does not need a
+ * system call.
+ */
+#ifdef CLOCK_MONOTONIC_COARSE
+  #define JLOG_RATELIMIT_CLOCK CLOCK_MONOTONIC_COARSE
+#else
+  #define JLOG_RATELIMIT_CLOCK CLOCK_MONOTONIC
+#endif
+
+/**
+ * @brief Mask of message count in state.
+ */
+#define JLOG_RATELIMIT_COUNTMASK 0xFFFFFFFFULL
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jlog_ratelimit_check(jlog_ratelimit_t *site, unsigned long interval_ms, unsigned long burst)
+{
+  if(site == NULL)
+  {
+    return true;
+  }
+
+  if(interval_ms == 0)
+  {
+    interval_ms = 1;
+  }
+
+  if(burst > JLOG_RATELIMIT_COUNTMASK)
+  {
+    burst = JLOG_RATELIMIT_COUNTMASK;
+  }
+
+  struct timespec now;
+  clock_gettime(JLOG_RATELIMIT_CLOCK, &now);
+  uint64_t now_ms = (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+  unsigned long long window = (now_ms / interval_ms) & JLOG_RATELIMIT_COUNTMASK;
+
+  unsigned long long state = atomic_load_explicit(&(site->state), memory_order_relaxed);
+  for(;;)
+  {
+    unsigned long long new_state;
+
+    if((state >> 32) == window)
+    {
+      if((state & JLOG_RATELIMIT_COUNTMASK) >= burst)
+      {
+        atomic_fetch_add_explicit(&(site->suppressed), 1, memory_order_relaxed);
+        return false;
+      }
+
+      new_state = state + 1;
+    }
+    else
+    {
+      /* First message of new interval. */
+      if(burst == 0)
+      {
+        atomic_fetch_add_explicit(&(site->suppressed), 1, memory_order_relaxed);
+        return false;
+      }
+
+      new_state = (window << 32) | 1;
+    }
+
+    /* On failure state is reloaded and checked again. */
+    if(atomic_compare_exchange_weak_explicit(&(site->state), &state, new_state, memory_order_relaxed, memory_order_relaxed))
+    {
+      return true;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_ratelimit_sample(jlog_ratelimit_t *site, unsigned long rate)
+{
+  if(site == NULL || rate <= 1)
+  {
+    return true;
+  }
+
+  unsigned long long calls = atomic_fetch_add_explicit(&(site->state), 1, memory_order_relaxed);
+  if(calls % rate == 0)
+  {
+    return true;
+  }
+
+  atomic_fetch_add_explicit(&(site->suppressed), 1, memory_order_relaxed);
+  return false;
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long jlog_ratelimit_takeSuppressed(jlog_ratelimit_t *site)
+{
+  if(site == NULL)
+  {
+    return 0;
+  }
+
+  /* Cheap check first, so exchange is only done, when needed. */
+  if(atomic_load_explicit(&(site->suppressed), memory_order_relaxed) == 0)
+  {
+    return 0;
+  }
+
+  return atomic_exchange_explicit(&(site->suppressed), 0, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_ratelimit_report(jlog_t *session, jlog_ratelimit_t *site, int log_type, const char *file, const char *function, int line)
+{
+  unsigned long suppressed = jlog_ratelimit_takeSuppressed(site);
+  if(suppressed == 0)
+  {
+    return;
+  }
+
+  if(session)
+  {
+    jlog_log_message_m(session, log_type, file, function, line, "Suppressed %lu messages (rate limit).", suppressed);
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, "Suppressed %lu messages (rate limit).", suppressed);
+  }
+}
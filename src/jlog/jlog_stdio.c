@@ -9,12 +9,26 @@
  * 
  */
 
+/* Needed for localtime_r() */
+#define _POSIX_C_SOURCE 200809L
+
 #include <jayc/jlog_stdio.h>
 #include <jayc/jlog_dev.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jlog_stdio");
+
+
 
 //==============================================================================
 // Define constants.
@@ -55,6 +69,25 @@
  */
 #define JLOG_STDIO_LOGSTRING_FATAL "**FATAL**"
 
+/**
+ * @brief Size of buffer, a log line is formatted in.
+ * 
+ * Messages are formatted by jlog into 2048 bytes,
+ * rest is for prefix with source code info and colors.
+ * Longer lines are cut off.
+ */
+#define JLOG_STDIO_SIZE_BUFFER 4096
+
+/**
+ * @brief Format of timestamp prefix.
+ */
+#define JLOG_STDIO_TIMESTAMP_FORMAT "%Y-%m-%d %H:%M:%S "
+
+/**
+ * @brief Size of timestamp prefix buffer.
+ */
+#define JLOG_STDIO_SIZE_TIMESTAMP 32
+
 
 
 //==============================================================================
@@ -74,6 +107,36 @@ typedef struct __jlog_stdio_color_context
   char *error_color;
 } jlog_stdio_color_context_t;
 
+/**
+ * @brief Session context for jlog_stdio sessions.
+ *        Plain sessions without timestamp have no context.
+ */
+typedef struct __jlog_stdio_context
+{
+  jlog_stdio_color_context_t *color_context;  /**< Colors, @c NULL if output has no color. */
+  int timestamp;                              /**< Print timestamp in front of each line. */
+} jlog_stdio_context_t;
+
+/**
+ * @brief Line buffer of thread.
+ *        Lines are formatted here and written with one call.
+ */
+typedef struct __jlog_stdio_buffer
+{
+  char data[JLOG_STDIO_SIZE_BUFFER];              /**< Formatted line. */
+  size_t length;                                  /**< Bytes used in data. */
+  time_t timestamp_second;                        /**< Second, timestamp prefix was formatted for. */
+  char timestamp[JLOG_STDIO_SIZE_TIMESTAMP];      /**< Cached timestamp prefix. */
+} jlog_stdio_buffer_t;
+
+/**
+ * @brief Line buffer of calling thread.
+ * 
+ * Formatting does not need locks or stack space per call.
+ * Timestamp is only formatted again, when second changes.
+ */
+static _Thread_local jlog_stdio_buffer_t jlog_stdio_buffer = { .timestamp_second = -1 };
+
 
 
 //==============================================================================
@@ -88,11 +151,23 @@ typedef struct __jlog_stdio_color_context
 static void jlog_stdio_color_context_free(void *ctx);
 
 /**
- * @brief Destroys context for jlog_stdio_color session.
+ * @brief Creates jlog_stdio session with context.
+ * 
+ * @param log_level     Log level to use.
+ * @param color_context Colors or @c NULL .
+ * @param timestamp     Print timestamp in front of each line.
+ * 
+ * @return              Session pointer.
+ * @return              @c NULL , if failed.
+ */
+static jlog_t *jlog_stdio_context_session_init(int log_level, jlog_stdio_color_context_t *color_context, int timestamp);
+
+/**
+ * @brief Destroys context for jlog_stdio sessions.
  * 
  * @param ctx Session context to destroy.
  */
-static void jlog_stdio_color_session_free_handler(void *ctx);
+static void jlog_stdio_context_free_handler(void *ctx);
 
 /**
  * @brief Handler to log message.
@@ -116,44 +191,21 @@ static void jlog_stdio_message_handler(void *ctx, int log_type, const char *msg)
 static void jlog_stdio_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
 
 /**
- * @brief Prints message with stdio.
+ * @brief Formats line in buffer of thread and writes it.
  * 
+ * Line is built in one pass and written with one
+ * @c fwrite() , so output of threads is not mixed and
+ * follows output of other stdio calls.
+ * 
+ * @param context   Session context or @c NULL .
  * @param log_type  Log type of message (debug, info, warning, error).
- * @param msg       Message string to log.
- */
-static void jlog_stdio_print(int log_type, const char *msg);
-
-/**
- * @brief Prints message with stdio. Contains additional information.
- *
- * @param log_type  Log type of message (debug, info, warning, error).
- * @param file      File name in which log was called.
+ * @param file      File name in which log was called. If @c NULL ,
+ *                  no source code info is printed.
  * @param function  Function name in which log was called.
  * @param line      Line number on which log was called.
  * @param msg       Message string to log.
  */
-static void jlog_stdio_print_m(int log_type, const char *file, const char *function, int line, const char *msg);
-
-/**
- * @brief Prints message with stdio with color.
- * 
- * @param color_context Contains colors for log types.
- * @param log_type      Log type of message (debug, info, warning, error).
- * @param msg           Message string to log.
- */
-static void jlog_stdio_color_print(jlog_stdio_color_context_t *color_context, int log_type, const char *msg);
-
-/**
- * @brief Prints message with stdio with color. Contains additional information.
- *
- * @param color_context Contains colors for log types.
- * @param log_type      Log type of message (debug, info, warning, error).
- * @param file          File name in which log was called.
- * @param function      Function name in which log was called.
- * @param line          Line number on which log was called.
- * @param msg           Message string to log.
- */
-static void jlog_stdio_color_print_m(jlog_stdio_color_context_t *color_context, int log_type, const char *file, const char *function, int line, const char *msg);
+static void jlog_stdio_print(jlog_stdio_context_t *context, int log_type, const char *file, const char *function, int line, const char *msg);
 
 
 
@@ -174,6 +226,34 @@ static void jlog_stdio_color_print_m(jlog_stdio_color_context_t *color_context,
  */
 static char *jlog_stdio_color_init_colorString(const char *str);
 
+/**
+ * @brief Appends string to line buffer.
+ * 
+ * Cuts string off, if buffer is full. Last byte
+ * is kept free for line break.
+ * 
+ * @param buffer  Line buffer.
+ * @param str     String to append.
+ */
+static void jlog_stdio_buffer_append(jlog_stdio_buffer_t *buffer, const char *str);
+
+/**
+ * @brief Appends decimal number to line buffer.
+ * 
+ * @param buffer  Line buffer.
+ * @param number  Number to append.
+ */
+static void jlog_stdio_buffer_appendNumber(jlog_stdio_buffer_t *buffer, int number);
+
+/**
+ * @brief Appends timestamp of current second to line buffer.
+ * 
+ * Uses cached prefix, if second did not change.
+ * 
+ * @param buffer  Line buffer.
+ */
+static void jlog_stdio_buffer_appendTimestamp(jlog_stdio_buffer_t *buffer);
+
 
 
 //==============================================================================
@@ -184,7 +264,7 @@ static char *jlog_stdio_color_init_colorString(const char *str);
 //
 void *jlog_stdio_color_context_init(const char *debug_color, const char *info_color, const char *warn_color, const char *error_color)
 {
-  jlog_stdio_color_context_t *ctx = (jlog_stdio_color_context_t *)malloc(sizeof(jlog_stdio_color_context_t));
+  jlog_stdio_color_context_t *ctx = (jlog_stdio_color_context_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_stdio_color_context_t));
 
   if(debug_color)
   {
@@ -229,10 +309,11 @@ void *jlog_stdio_color_context_init(const char *debug_color, const char *info_co
 //
 jlog_t *jlog_stdio_session_init(int log_level)
 {
-  jlog_t *session = (jlog_t *)malloc(sizeof(jlog_t));
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
 
   session->log_function = &jlog_stdio_message_handler;
   session->log_function_m = &jlog_stdio_message_handler_m;
+  session->log_function_v = NULL;
   session->session_free_handler = NULL;
   session->log_level = log_level;
   session->session_context = NULL;
@@ -244,15 +325,14 @@ jlog_t *jlog_stdio_session_init(int log_level)
 //
 jlog_t *jlog_stdio_color_session_init(int log_level, void *ctx)
 {
-  jlog_t *session = (jlog_t *)malloc(sizeof(jlog_t));
-
-  session->log_function = &jlog_stdio_message_handler;
-  session->log_function_m = &jlog_stdio_message_handler_m;
-  session->session_free_handler = &jlog_stdio_color_session_free_handler;
-  session->log_level = log_level;
-  session->session_context = ctx;
+  return jlog_stdio_context_session_init(log_level, (jlog_stdio_color_context_t *)ctx, false);
+}
 
-  return session;
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_stdio_timestamp_session_init(int log_level, void *ctx)
+{
+  return jlog_stdio_context_session_init(log_level, (jlog_stdio_color_context_t *)ctx, true);
 }
 
 
@@ -273,338 +353,190 @@ void jlog_stdio_color_context_free(void *ctx)
 
   if(color_context->debug_color)
   {
-    free(color_context->debug_color);
+    JUTIL_ALLOC_FREE(color_context->debug_color);
   }
 
   if(color_context->info_color)
   {
-    free(color_context->info_color);
+    JUTIL_ALLOC_FREE(color_context->info_color);
   }
 
   if(color_context->warn_color)
   {
-    free(color_context->warn_color);
+    JUTIL_ALLOC_FREE(color_context->warn_color);
   }
 
   if(color_context->error_color)
   {
-    free(color_context->error_color);
+    JUTIL_ALLOC_FREE(color_context->error_color);
   }
 
-  free(color_context);
+  JUTIL_ALLOC_FREE(color_context);
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_stdio_color_session_free_handler(void *ctx)
+jlog_t *jlog_stdio_context_session_init(int log_level, jlog_stdio_color_context_t *color_context, int timestamp)
 {
-  jlog_stdio_color_context_free(ctx);
-}
-
-//------------------------------------------------------------------------------
-//
-void jlog_stdio_message_handler(void *ctx, int log_type, const char *msg)
-{
-  if(ctx)
+  jlog_stdio_context_t *context = (jlog_stdio_context_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_stdio_context_t));
+  if(context == NULL)
   {
-    jlog_stdio_color_print((jlog_stdio_color_context_t *)ctx, log_type, msg);
+    return NULL;
   }
-  else
+
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
+  if(session == NULL)
   {
-    jlog_stdio_print(log_type, msg);
+    JUTIL_ALLOC_FREE(context);
+    return NULL;
   }
+
+  context->color_context = color_context;
+  context->timestamp = timestamp;
+
+  session->log_function = &jlog_stdio_message_handler;
+  session->log_function_m = &jlog_stdio_message_handler_m;
+  session->log_function_v = NULL;
+  session->session_free_handler = &jlog_stdio_context_free_handler;
+  session->log_level = log_level;
+  session->session_context = context;
+
+  return session;
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_stdio_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+void jlog_stdio_context_free_handler(void *ctx)
 {
-  if(ctx)
-  {
-    jlog_stdio_color_print_m((jlog_stdio_color_context_t *)ctx, log_type, file, function, line, msg);
-  }
-  else
+  if(ctx == NULL)
   {
-    jlog_stdio_print_m(log_type, file, function, line, msg);
+    return;
   }
+
+  jlog_stdio_context_t *context = (jlog_stdio_context_t *)ctx;
+  jlog_stdio_color_context_free(context->color_context);
+  JUTIL_ALLOC_FREE(context);
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_stdio_print(int log_type, const char *msg)
+void jlog_stdio_message_handler(void *ctx, int log_type, const char *msg)
 {
-  char *type;
-  FILE *out_stream;
-  switch(log_type)
-  {
-    case JLOG_LOGTYPE_DEBUG:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_INFO:
-    {
-      type = JLOG_STDIO_LOGSTRING_INFO;
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_WARN:
-    {
-      type = JLOG_STDIO_LOGSTRING_WARN;
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_ERROR:
-    {
-      type = JLOG_STDIO_LOGSTRING_ERROR;
-      out_stream = stderr;
-      break;
-    }
-    case JLOG_LOGTYPE_CRITICAL:
-    {
-      type = JLOG_STDIO_LOGSTRING_CRITICAL;
-      out_stream = stderr;
-      break;
-    }
-    case JLOG_LOGTYPE_FATAL:
-    {
-      type = JLOG_STDIO_LOGSTRING_FATAL;
-      out_stream = stderr;
-      break;
-    }
-    default:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      out_stream = stdout;
-      break;
-    }
-  }
-
-  fprintf(out_stream, "[ %s ] %s\n", type, msg);
+  jlog_stdio_print((jlog_stdio_context_t *)ctx, log_type, NULL, NULL, 0, msg);
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_stdio_print_m(int log_type, const char *file, const char *function, int line, const char *msg)
+void jlog_stdio_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
 {
-  char *type;
-  FILE *out_stream;
-  switch(log_type)
-  {
-    case JLOG_LOGTYPE_DEBUG:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_INFO:
-    {
-      type = JLOG_STDIO_LOGSTRING_INFO;
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_WARN:
-    {
-      type = JLOG_STDIO_LOGSTRING_WARN;
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_ERROR:
-    {
-      type = JLOG_STDIO_LOGSTRING_ERROR;
-      out_stream = stderr;
-      break;
-    }
-    case JLOG_LOGTYPE_CRITICAL:
-    {
-      type = JLOG_STDIO_LOGSTRING_CRITICAL;
-      out_stream = stderr;
-      break;
-    }
-    case JLOG_LOGTYPE_FATAL:
-    {
-      type = JLOG_STDIO_LOGSTRING_FATAL;
-      out_stream = stderr;
-      break;
-    }
-    default:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      out_stream = stdout;
-      break;
-    }
-  }
-
-  fprintf(out_stream, "[ %s %s:%d %s() ] %s\n", type, file, line, function, msg);
+  jlog_stdio_print((jlog_stdio_context_t *)ctx, log_type, file, function, line, msg);
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_stdio_color_print(jlog_stdio_color_context_t *color_context, int log_type, const char *msg)
+void jlog_stdio_print(jlog_stdio_context_t *context, int log_type, const char *file, const char *function, int line, const char *msg)
 {
+  jlog_stdio_color_context_t *color_context = (context ? context->color_context : NULL);
   char *type;
-  char *color = JLOG_STDIO_COLOR_RESET;
+  char *color = NULL;
   FILE *out_stream;
   switch(log_type)
   {
-    case JLOG_LOGTYPE_DEBUG:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      if(color_context->debug_color)
-      {
-        color = color_context->debug_color;
-      }
-      out_stream = stdout;
-      break;
-    }
     case JLOG_LOGTYPE_INFO:
     {
       type = JLOG_STDIO_LOGSTRING_INFO;
-      if(color_context->info_color)
-      {
-        color = color_context->info_color;
-      }
+      color = (color_context ? color_context->info_color : NULL);
       out_stream = stdout;
       break;
     }
     case JLOG_LOGTYPE_WARN:
     {
       type = JLOG_STDIO_LOGSTRING_WARN;
-      if(color_context->warn_color)
-      {
-        color = color_context->warn_color;
-      }
+      color = (color_context ? color_context->warn_color : NULL);
       out_stream = stdout;
       break;
     }
     case JLOG_LOGTYPE_ERROR:
     {
       type = JLOG_STDIO_LOGSTRING_ERROR;
-      if(color_context->error_color)
-      {
-        color = color_context->error_color;
-      }
+      color = (color_context ? color_context->error_color : NULL);
       out_stream = stderr;
       break;
     }
     case JLOG_LOGTYPE_CRITICAL:
     {
       type = JLOG_STDIO_LOGSTRING_CRITICAL;
-      if(color_context->error_color)
-      {
-        color = color_context->error_color;
-      }
+      color = (color_context ? color_context->error_color : NULL);
       out_stream = stderr;
       break;
     }
     case JLOG_LOGTYPE_FATAL:
     {
       type = JLOG_STDIO_LOGSTRING_FATAL;
-      if(color_context->error_color)
-      {
-        color = color_context->error_color;
-      }
+      color = (color_context ? color_context->error_color : NULL);
       out_stream = stderr;
       break;
     }
+    case JLOG_LOGTYPE_DEBUG:
     default:
     {
       type = JLOG_STDIO_LOGSTRING_DEBUG;
-      if(color_context->debug_color)
-      {
-        color = color_context->debug_color;
-      }
+      color = (color_context ? color_context->debug_color : NULL);
       out_stream = stdout;
       break;
     }
   }
 
-  fprintf(out_stream, "[ %s%s%s ] %s%s%s\n", color, type, JLOG_STDIO_COLOR_RESET, color, msg, JLOG_STDIO_COLOR_RESET);
-}
+  if(color_context && color == NULL)
+  {
+    color = JLOG_STDIO_COLOR_RESET;
+  }
 
-//------------------------------------------------------------------------------
-//
-void jlog_stdio_color_print_m(jlog_stdio_color_context_t *color_context, int log_type, const char *file, const char *function, int line, const char *msg)
-{
-  char *type;
-  char *color = JLOG_STDIO_COLOR_RESET;
-  FILE *out_stream;
-  switch(log_type)
+  jlog_stdio_buffer_t *buffer = &jlog_stdio_buffer;
+  buffer->length = 0;
+
+  if(context && context->timestamp)
   {
-    case JLOG_LOGTYPE_DEBUG:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      if(color_context->debug_color)
-      {
-        color = color_context->debug_color;
-      }
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_INFO:
-    {
-      type = JLOG_STDIO_LOGSTRING_INFO;
-      if(color_context->info_color)
-      {
-        color = color_context->info_color;
-      }
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_WARN:
-    {
-      type = JLOG_STDIO_LOGSTRING_WARN;
-      if(color_context->warn_color)
-      {
-        color = color_context->warn_color;
-      }
-      out_stream = stdout;
-      break;
-    }
-    case JLOG_LOGTYPE_ERROR:
-    {
-      type = JLOG_STDIO_LOGSTRING_ERROR;
-      if(color_context->error_color)
-      {
-        color = color_context->error_color;
-      }
-      out_stream = stderr;
-      break;
-    }
-    case JLOG_LOGTYPE_CRITICAL:
-    {
-      type = JLOG_STDIO_LOGSTRING_CRITICAL;
-      if(color_context->error_color)
-      {
-        color = color_context->error_color;
-      }
-      out_stream = stderr;
-      break;
-    }
-    case JLOG_LOGTYPE_FATAL:
-    {
-      type = JLOG_STDIO_LOGSTRING_FATAL;
-      if(color_context->error_color)
-      {
-        color = color_context->error_color;
-      }
-      out_stream = stderr;
-      break;
-    }
-    default:
-    {
-      type = JLOG_STDIO_LOGSTRING_DEBUG;
-      if(color_context->debug_color)
-      {
-        color = color_context->debug_color;
-      }
-      out_stream = stdout;
-      break;
-    }
+    jlog_stdio_buffer_appendTimestamp(buffer);
+  }
+
+  jlog_stdio_buffer_append(buffer, "[ ");
+  if(color)
+  {
+    jlog_stdio_buffer_append(buffer, color);
+    jlog_stdio_buffer_append(buffer, type);
+    jlog_stdio_buffer_append(buffer, JLOG_STDIO_COLOR_RESET);
+  }
+  else
+  {
+    jlog_stdio_buffer_append(buffer, type);
+  }
+
+  if(file)
+  {
+    jlog_stdio_buffer_append(buffer, " ");
+    jlog_stdio_buffer_append(buffer, file);
+    jlog_stdio_buffer_append(buffer, ":");
+    jlog_stdio_buffer_appendNumber(buffer, line);
+    jlog_stdio_buffer_append(buffer, " ");
+    jlog_stdio_buffer_append(buffer, function);
+    jlog_stdio_buffer_append(buffer, "()");
+  }
+
+  jlog_stdio_buffer_append(buffer, " ] ");
+  if(color)
+  {
+    jlog_stdio_buffer_append(buffer, color);
+    jlog_stdio_buffer_append(buffer, msg);
+    jlog_stdio_buffer_append(buffer, JLOG_STDIO_COLOR_RESET);
+  }
+  else
+  {
+    jlog_stdio_buffer_append(buffer, msg);
   }
 
-  fprintf(out_stream, "[ %s%s%s %s:%d %s() ] %s%s%s\n", color, type, JLOG_STDIO_COLOR_RESET, file, line, function, color, msg, JLOG_STDIO_COLOR_RESET);
+  buffer->data[buffer->length++] = '\n';
+  fwrite(buffer->data, 1, buffer->length, out_stream);
 }
 
 
@@ -623,7 +555,7 @@ char *jlog_stdio_color_init_colorString(const char *str)
   }
 
   size_t size_ret = sizeof(char) * (strlen(str) + 1);
-  char *ret = (char *)malloc(size_ret);
+  char *ret = (char *)JUTIL_ALLOC_MALLOC(size_ret);
   if(ret == NULL)
   {
     return NULL;
@@ -633,4 +565,69 @@ char *jlog_stdio_color_init_colorString(const char *str)
   memcpy(ret, str, size_ret);
 
   return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_stdio_buffer_append(jlog_stdio_buffer_t *buffer, const char *str)
+{
+  if(str == NULL)
+  {
+    str = "(null)";
+  }
+
+  size_t length = strlen(str);
+  size_t space = sizeof(buffer->data) - 1 - buffer->length;
+  if(length > space)
+  {
+    length = space;
+  }
+
+  memcpy(buffer->data + buffer->length, str, length);
+  buffer->length += length;
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_stdio_buffer_appendNumber(jlog_stdio_buffer_t *buffer, int number)
+{
+  /* Digits are written backwards from end of string. */
+  char digits[16];
+  char *position = digits + sizeof(digits) - 1;
+  unsigned int value = (number < 0 ? 0u - (unsigned int)number : (unsigned int)number);
+
+  *position = 0;
+  do
+  {
+    *--position = (char)('0' + (value % 10));
+    value /= 10;
+  } while(value > 0);
+
+  if(number < 0)
+  {
+    *--position = '-';
+  }
+
+  jlog_stdio_buffer_append(buffer, position);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_stdio_buffer_appendTimestamp(jlog_stdio_buffer_t *buffer)
+{
+  time_t now = time(NULL);
+
+  if(now != buffer->timestamp_second)
+  {
+    struct tm time_info;
+
+    if(localtime_r(&now, &time_info) == NULL || strftime(buffer->timestamp, sizeof(buffer->timestamp), JLOG_STDIO_TIMESTAMP_FORMAT, &time_info) == 0)
+    {
+      buffer->timestamp[0] = 0;
+    }
+
+    buffer->timestamp_second = now;
+  }
+
+  jlog_stdio_buffer_append(buffer, buffer->timestamp);
 }
\ No newline at end of file
@@ -9,12 +9,74 @@
  * 
  */
 
+#define _GNU_SOURCE /* needed for SOCK_NONBLOCK and gethostname() */
+
 #include <jayc/jlog_syslog.h>
 #include <jayc/jlog_dev.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
 #include <syslog.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jlog_syslog");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Default path of syslog socket.
+ */
+#define JLOG_SYSLOG_SOCKET_PATH "/dev/log"
+
+/**
+ * @brief Max. size of one datagram.
+ */
+#define JLOG_SYSLOG_SIZE_DATAGRAM 4096
+
+/**
+ * @brief Size of constant header part (hostname, app name, process id).
+ */
+#define JLOG_SYSLOG_SIZE_HEADER 384
+
+/**
+ * @brief Max. length of app name in RFC 5424.
+ */
+#define JLOG_SYSLOG_SIZE_APPNAME 48
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Context for socket sessions.
+ */
+typedef struct __jlog_syslog_socket_context
+{
+  int fd;                                 /**< Non-blocking datagram socket. */
+  int facility;                           /**< Syslog facility (f.ex. @c LOG_USER ). */
+  atomic_size_t dropped;                  /**< Messages dropped since last report. */
+  struct sockaddr_un address;             /**< Address of syslog socket. */
+  char header[JLOG_SYSLOG_SIZE_HEADER];   /**< "HOSTNAME APP-NAME PROCID MSGID SD ", same for all messages. */
+} jlog_syslog_socket_context_t;
 
 //==============================================================================
 // Define global variables.
@@ -32,6 +94,87 @@ static jlog_t *singleton_session;
 // Declare internal functions.
 //
 
+/**
+ * @brief Returns syslog severity for log type.
+ * 
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * 
+ * @return          Severity (f.ex. @c LOG_DEBUG ).
+ */
+static int jlog_syslog_getSeverity(int log_type);
+
+/**
+ * @brief Closes socket and frees context of socket session.
+ * 
+ * @param ctx Session context.
+ */
+static void jlog_syslog_socket_session_free_handler(void *ctx);
+
+/**
+ * @brief Handler to log message over socket.
+ *
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param msg       Message string to log.
+ */
+static void jlog_syslog_socket_message_handler(void *ctx, int log_type, const char *msg);
+
+/**
+ * @brief Handler to log message with source code info over socket.
+ *
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Message string to log.
+ */
+static void jlog_syslog_socket_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Builds RFC 5424 datagram and sends it without blocking.
+ * 
+ * Counts message as dropped, if socket is busy. After the
+ * next message, that could be sent, number of dropped
+ * messages is sent as warning.
+ * 
+ * @param context   Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Message string to log.
+ */
+static void jlog_syslog_socket_send(jlog_syslog_socket_context_t *context, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Writes header of RFC 5424 message into buffer.
+ * 
+ * @param context   Session context.
+ * @param severity  Syslog severity (f.ex. @c LOG_WARNING ).
+ * @param now       Time of message.
+ * @param buffer    Buffer to write to.
+ * @param size      Size of buffer.
+ * 
+ * @return          Length of header.
+ * @return          @c 0 , if header does not fit into buffer.
+ */
+static size_t jlog_syslog_socket_formatPrefix(jlog_syslog_socket_context_t *context, int severity, const struct timespec *now, char *buffer, size_t size);
+
+/**
+ * @brief Sends one datagram without blocking.
+ * 
+ * Connects again once, if syslog daemon was restarted.
+ * 
+ * @param context   Session context.
+ * @param data      Datagram.
+ * @param size      Size of datagram.
+ * 
+ * @return          @c true , if datagram was sent.
+ * @return          @c false , if socket is busy or error occured.
+ */
+static int jlog_syslog_socket_sendDatagram(jlog_syslog_socket_context_t *context, const char *data, size_t size);
+
 /**
  * @brief Handler to free memory.
  * 
@@ -74,10 +217,11 @@ jlog_t *jlog_syslog_session_init(int log_level, const char *id, int facility)
 {
   if(singleton_session == NULL)
   {
-    jlog_t *new_session = (jlog_t *)malloc(sizeof(jlog_t));
+    jlog_t *new_session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
 
     new_session->log_function = &jlog_syslog_message_handler;
     new_session->log_function_m = &jlog_syslog_message_handler_m;
+    new_session->log_function_v = NULL;
     new_session->session_free_handler = &jlog_syslog_session_free_handler;
     new_session->log_level = log_level;
     new_session->session_context = NULL;
@@ -88,6 +232,87 @@ jlog_t *jlog_syslog_session_init(int log_level, const char *id, int facility)
   return singleton_session;
 }
 
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_syslog_socket_session_init(int log_level, const char *id, int facility, const char *path)
+{
+  if(path == NULL)
+  {
+    path = JLOG_SYSLOG_SOCKET_PATH;
+  }
+
+  if(strlen(path) >= sizeof(((struct sockaddr_un *)NULL)->sun_path))
+  {
+    return NULL;
+  }
+
+  jlog_syslog_socket_context_t *context = (jlog_syslog_socket_context_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_syslog_socket_context_t));
+  if(context == NULL)
+  {
+    return NULL;
+  }
+
+  memset(&(context->address), 0, sizeof(context->address));
+  context->address.sun_family = AF_UNIX;
+  strncpy(context->address.sun_path, path, sizeof(context->address.sun_path) - 1);
+  context->facility = facility & LOG_FACMASK;
+  atomic_init(&(context->dropped), 0);
+
+  /* Fields may not contain spaces, app name is limited to 48 characters. */
+  char hostname[256];
+  if(gethostname(hostname, sizeof(hostname)) != 0 || hostname[0] == 0)
+  {
+    strcpy(hostname, "-");
+  }
+  hostname[sizeof(hostname) - 1] = 0;
+
+  char app_name[JLOG_SYSLOG_SIZE_APPNAME + 1];
+  size_t app_length = 0;
+  for(; id && id[app_length] && app_length < JLOG_SYSLOG_SIZE_APPNAME; app_length++)
+  {
+    char c = id[app_length];
+    app_name[app_length] = ((c > 32 && c < 127) ? c : '_');
+  }
+  app_name[app_length] = 0;
+  if(app_length == 0)
+  {
+    strcpy(app_name, "-");
+  }
+
+  snprintf(context->header, sizeof(context->header), "%s %s %ld - - ", hostname, app_name, (long)getpid());
+
+  context->fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(context->fd < 0)
+  {
+    JUTIL_ALLOC_FREE(context);
+    return NULL;
+  }
+
+  if(connect(context->fd, (struct sockaddr *)&(context->address), sizeof(context->address)) != 0)
+  {
+    close(context->fd);
+    JUTIL_ALLOC_FREE(context);
+    return NULL;
+  }
+
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
+  if(session == NULL)
+  {
+    close(context->fd);
+    JUTIL_ALLOC_FREE(context);
+    return NULL;
+  }
+
+  session->log_function = &jlog_syslog_socket_message_handler;
+  session->log_function_m = &jlog_syslog_socket_message_handler_m;
+  session->log_function_v = NULL;
+  session->session_free_handler = &jlog_syslog_socket_session_free_handler;
+  session->log_level = log_level;
+  session->session_context = context;
+
+  return session;
+}
+
 
 
 //==============================================================================
@@ -106,104 +331,189 @@ void jlog_syslog_session_free_handler(void *ctx)
 //
 void jlog_syslog_message_handler(void *ctx, int log_type, const char *msg)
 {
-  int type;
+  int type = jlog_syslog_getSeverity(log_type);
+
+  syslog(type, "%s", msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_syslog_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  int type = jlog_syslog_getSeverity(log_type);
+
+  syslog(type, "[ %s:%d %s() ] %s", file, line, function, msg);
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_syslog_getSeverity(int log_type)
+{
   switch(log_type)
   {
     case JLOG_LOGTYPE_DEBUG:
     {
-      type = LOG_DEBUG;
-      break;
+      return LOG_DEBUG;
     }
 
     case JLOG_LOGTYPE_INFO:
     {
-      type = LOG_INFO;
-      break;
+      return LOG_INFO;
     }
 
     case JLOG_LOGTYPE_WARN:
     {
-      type = LOG_WARNING;
-      break;
+      return LOG_WARNING;
     }
 
     case JLOG_LOGTYPE_ERROR:
     {
-      type = LOG_ERR;
-      break;
+      return LOG_ERR;
     }
 
     case JLOG_LOGTYPE_CRITICAL:
     {
-      type = LOG_CRIT;
-      break;
+      return LOG_CRIT;
     }
 
     case JLOG_LOGTYPE_FATAL:
     {
-      type = LOG_EMERG;
-      break;
+      return LOG_EMERG;
     }
 
     default:
     {
-      type = LOG_DEBUG;
-      break;
+      return LOG_DEBUG;
     }
   }
+}
 
-  syslog(type, "%s", msg);
+//------------------------------------------------------------------------------
+//
+void jlog_syslog_socket_session_free_handler(void *ctx)
+{
+  jlog_syslog_socket_context_t *context = (jlog_syslog_socket_context_t *)ctx;
+  if(context == NULL)
+  {
+    return;
+  }
+
+  close(context->fd);
+  JUTIL_ALLOC_FREE(context);
 }
 
 //------------------------------------------------------------------------------
 //
-void jlog_syslog_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+void jlog_syslog_socket_message_handler(void *ctx, int log_type, const char *msg)
 {
-  int type;
-  switch(log_type)
+  jlog_syslog_socket_send((jlog_syslog_socket_context_t *)ctx, log_type, NULL, NULL, 0, msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_syslog_socket_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  jlog_syslog_socket_send((jlog_syslog_socket_context_t *)ctx, log_type, file, function, line, msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_syslog_socket_send(jlog_syslog_socket_context_t *context, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+
+  char datagram[JLOG_SYSLOG_SIZE_DATAGRAM];
+  size_t prefix_length = jlog_syslog_socket_formatPrefix(context, jlog_syslog_getSeverity(log_type), &now, datagram, sizeof(datagram));
+  if(prefix_length == 0)
   {
-    case JLOG_LOGTYPE_DEBUG:
-    {
-      type = LOG_DEBUG;
-      break;
-    }
+    return;
+  }
 
-    case JLOG_LOGTYPE_INFO:
-    {
-      type = LOG_INFO;
-      break;
-    }
+  int length;
+  if(file)
+  {
+    length = snprintf(datagram + prefix_length, sizeof(datagram) - prefix_length, "[ %s:%d %s() ] %s", file, line, function, msg);
+  }
+  else
+  {
+    length = snprintf(datagram + prefix_length, sizeof(datagram) - prefix_length, "%s", msg);
+  }
 
-    case JLOG_LOGTYPE_WARN:
-    {
-      type = LOG_WARNING;
-      break;
-    }
+  if(length < 0)
+  {
+    return;
+  }
 
-    case JLOG_LOGTYPE_ERROR:
-    {
-      type = LOG_ERR;
-      break;
-    }
+  /* Messages too long for one datagram are truncated. */
+  size_t size = prefix_length + (size_t)length;
+  if(size >= sizeof(datagram))
+  {
+    size = sizeof(datagram) - 1;
+  }
 
-    case JLOG_LOGTYPE_CRITICAL:
-    {
-      type = LOG_CRIT;
-      break;
-    }
+  if(jlog_syslog_socket_sendDatagram(context, datagram, size) == false)
+  {
+    atomic_fetch_add_explicit(&(context->dropped), 1, memory_order_relaxed);
+    JUTIL_METRICS_COUNTER_ADD("jlog_dropped_total", "Log messages dropped by loggers.", 1);
+    return;
+  }
 
-    case JLOG_LOGTYPE_FATAL:
-    {
-      type = LOG_EMERG;
-      break;
-    }
+  size_t dropped = atomic_exchange_explicit(&(context->dropped), 0, memory_order_relaxed);
+  if(dropped == 0)
+  {
+    return;
+  }
 
-    default:
-    {
-      type = LOG_DEBUG;
-      break;
-    }
+  prefix_length = jlog_syslog_socket_formatPrefix(context, LOG_WARNING, &now, datagram, sizeof(datagram));
+  length = snprintf(datagram + prefix_length, sizeof(datagram) - prefix_length, "%zu log messages dropped, syslog socket was busy.", dropped);
+
+  if(prefix_length == 0 || length < 0 || jlog_syslog_socket_sendDatagram(context, datagram, prefix_length + (size_t)length) == false)
+  {
+    atomic_fetch_add_explicit(&(context->dropped), dropped, memory_order_relaxed);
   }
+}
 
-  syslog(type, "[ %s:%d %s() ] %s", file, line, function, msg);
+//------------------------------------------------------------------------------
+//
+size_t jlog_syslog_socket_formatPrefix(jlog_syslog_socket_context_t *context, int severity, const struct timespec *now, char *buffer, size_t size)
+{
+  struct tm time_info;
+  gmtime_r(&(now->tv_sec), &time_info);
+
+  /* <PRI>VERSION TIMESTAMP HOSTNAME APP-NAME PROCID MSGID STRUCTURED-DATA MSG */
+  int length = snprintf(buffer, size, "<%d>1 %04d-%02d-%02dT%02d:%02d:%02d.%06ldZ %s",
+                        context->facility | severity,
+                        time_info.tm_year + 1900, time_info.tm_mon + 1, time_info.tm_mday,
+                        time_info.tm_hour, time_info.tm_min, time_info.tm_sec,
+                        now->tv_nsec / 1000, context->header);
+  if(length < 0 || (size_t)length >= size)
+  {
+    return 0;
+  }
+
+  return (size_t)length;
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_syslog_socket_sendDatagram(jlog_syslog_socket_context_t *context, const char *data, size_t size)
+{
+  if(send(context->fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL) >= 0)
+  {
+    return true;
+  }
+
+  if(errno != ECONNREFUSED && errno != ENOTCONN && errno != ENOENT)
+  {
+    return false;
+  }
+
+  /* Syslog daemon was restarted, socket has to be connected again. */
+  if(connect(context->fd, (struct sockaddr *)&(context->address), sizeof(context->address)) != 0)
+  {
+    return false;
+  }
+
+  return (send(context->fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL) >= 0);
 }
\ No newline at end of file
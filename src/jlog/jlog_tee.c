@@ -0,0 +1,352 @@
+/**
+ * @file jlog_tee.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements functionality for jlog_tee.
+ * 
+ * jlog passes format string and arguments to the unformatted
+ * handler of the tee. Message is only formatted, if a child needs
+ * the formatted string. Wrappers, that only call formatted
+ * handlers (like jlog_async), get the formatted handlers, which
+ * pass the message on to every child. Child handlers are called
+ * directly, so no child exits the program, before the others
+ * logged the message.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jlog_tee.h>
+#include <jayc/jlog_dev.h>
+#include <jayc/jutil_alloc.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jlog_tee");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Size of formatted message (same as jlog buffers).
+ */
+#define JLOG_TEE_SIZE_MESSAGE 2048
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Session context of jlog_tee session.
+ */
+typedef struct __jlog_tee_context
+{
+  jlog_t **sessions;  /**< Child sessions. */
+  size_t count;       /**< Number of child sessions. */
+} jlog_tee_context_t;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Frees child sessions and context.
+ * 
+ * @param ctx Session context to destroy.
+ */
+static void jlog_tee_session_free_handler(void *ctx);
+
+/**
+ * @brief Handler to pass formatted message to child sessions.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param msg       Formatted message.
+ */
+static void jlog_tee_message_handler(void *ctx, int log_type, const char *msg);
+
+/**
+ * @brief Handler to pass formatted message with source
+ *        code info to child sessions.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called.
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Formatted message.
+ */
+static void jlog_tee_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Handler to pass message to child sessions.
+ * 
+ * @param ctx       Session context.
+ * @param log_type  Log type of message (debug, info, warning, error).
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param args      Arguments for format string.
+ */
+static void jlog_tee_message_handler_v(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args);
+
+/**
+ * @brief Checks, if child session logs message.
+ * 
+ * Same checks as jlog does for every log call.
+ * 
+ * @param session   Child session.
+ * @param log_type  Log type of message.
+ * @param has_file  @c true , if message has source code info.
+ * 
+ * @return          @c true , if child logs message.
+ * @return          @c false , if child discards message.
+ */
+static int jlog_tee_isEnabled(jlog_t *session, int log_type, int has_file);
+
+/**
+ * @brief Passes formatted message to child session.
+ * 
+ * Uses the formatted handler for the message, or the
+ * unformatted one, if child does not have it.
+ * 
+ * @param session   Child session, that logs message
+ *                  (see @c #jlog_tee_isEnabled() ).
+ * @param log_type  Log type of message.
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param msg       Formatted message.
+ */
+static void jlog_tee_logFormatted(jlog_t *session, int log_type, const char *file, const char *function, int line, const char *msg);
+
+/**
+ * @brief Calls unformatted handler of child session.
+ * 
+ * @param session   Child session with unformatted handler.
+ * @param log_type  Log type of message.
+ * @param file      File name in which log was called or @c NULL .
+ * @param function  Function name in which log was called.
+ * @param line      Line number on which log was called.
+ * @param fmt       Format string used for stdarg.h .
+ * @param ...       Arguments for format string.
+ */
+static void jlog_tee_callV(jlog_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jlog_t *jlog_tee_session_init(jlog_t **sessions, size_t count)
+{
+  if(sessions == NULL && count > 0)
+  {
+    return NULL;
+  }
+
+  jlog_t *session = (jlog_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_t));
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  jlog_tee_context_t *context = (jlog_tee_context_t *)JUTIL_ALLOC_MALLOC(sizeof(jlog_tee_context_t));
+  if(context == NULL)
+  {
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  context->sessions = (jlog_t **)JUTIL_ALLOC_MALLOC((count > 0 ? count : 1) * sizeof(jlog_t *));
+  if(context->sessions == NULL)
+  {
+    JUTIL_ALLOC_FREE(context);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  /* Messages below lowest level of children are not formatted at all. */
+  int log_level = JLOG_LOGTYPE_FATAL + 1;
+  context->count = 0;
+  for(size_t i = 0; i < count; i++)
+  {
+    if(sessions[i] == NULL)
+    {
+      continue;
+    }
+
+    context->sessions[context->count++] = sessions[i];
+    if(sessions[i]->log_level < log_level)
+    {
+      log_level = sessions[i]->log_level;
+    }
+  }
+
+  session->log_function = &jlog_tee_message_handler;
+  session->log_function_m = &jlog_tee_message_handler_m;
+  session->log_function_v = &jlog_tee_message_handler_v;
+  session->session_free_handler = &jlog_tee_session_free_handler;
+  session->log_level = log_level;
+  session->session_context = context;
+
+  return session;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jlog_tee_session_free_handler(void *ctx)
+{
+  jlog_tee_context_t *context = (jlog_tee_context_t *)ctx;
+  if(context == NULL)
+  {
+    return;
+  }
+
+  for(size_t i = 0; i < context->count; i++)
+  {
+    jlog_session_free(context->sessions[i]);
+  }
+
+  JUTIL_ALLOC_FREE(context->sessions);
+  JUTIL_ALLOC_FREE(context);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_tee_message_handler(void *ctx, int log_type, const char *msg)
+{
+  jlog_tee_message_handler_m(ctx, log_type, NULL, NULL, 0, msg);
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_tee_message_handler_m(void *ctx, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  jlog_tee_context_t *context = (jlog_tee_context_t *)ctx;
+  if(context == NULL)
+  {
+    return;
+  }
+
+  for(size_t i = 0; i < context->count; i++)
+  {
+    jlog_t *child = context->sessions[i];
+    if(jlog_tee_isEnabled(child, log_type, (file != NULL)))
+    {
+      jlog_tee_logFormatted(child, log_type, file, function, line, msg);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_tee_message_handler_v(void *ctx, int log_type, const char *file, const char *function, int line, const char *fmt, va_list args)
+{
+  jlog_tee_context_t *context = (jlog_tee_context_t *)ctx;
+  if(context == NULL)
+  {
+    return;
+  }
+
+  char buf[JLOG_TEE_SIZE_MESSAGE];
+  int formatted = false;
+
+  for(size_t i = 0; i < context->count; i++)
+  {
+    jlog_t *child = context->sessions[i];
+    if(jlog_tee_isEnabled(child, log_type, (file != NULL)) == false)
+    {
+      continue;
+    }
+
+    if(child->log_function_v)
+    {
+      va_list args_copy;
+      va_copy(args_copy, args);
+      child->log_function_v(child->session_context, log_type, file, function, line, fmt, args_copy);
+      va_end(args_copy);
+      continue;
+    }
+
+    if(formatted == false)
+    {
+      va_list args_copy;
+      va_copy(args_copy, args);
+      vsnprintf(buf, sizeof(buf), fmt, args_copy);
+      va_end(args_copy);
+      formatted = true;
+    }
+
+    jlog_tee_logFormatted(child, log_type, file, function, line, buf);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jlog_tee_isEnabled(jlog_t *session, int log_type, int has_file)
+{
+  if(log_type < session->log_level)
+  {
+    return false;
+  }
+
+  if(session->log_function_v)
+  {
+    return true;
+  }
+
+  return (has_file ? (session->log_function_m != NULL) : (session->log_function != NULL));
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_tee_logFormatted(jlog_t *session, int log_type, const char *file, const char *function, int line, const char *msg)
+{
+  if(file && session->log_function_m)
+  {
+    session->log_function_m(session->session_context, log_type, file, function, line, msg);
+  }
+  else if(file == NULL && session->log_function)
+  {
+    session->log_function(session->session_context, log_type, msg);
+  }
+  else
+  {
+    jlog_tee_callV(session, log_type, file, function, line, "%s", msg);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jlog_tee_callV(jlog_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  session->log_function_v(session->session_context, log_type, file, function, line, fmt, args);
+  va_end(args);
+}
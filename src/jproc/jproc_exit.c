@@ -4,15 +4,35 @@
  * 
  * @brief Implements exit functionality for jproc.
  * 
+ * Shutdown handlers are kept in a list per phase. Phases
+ * run one after another, handlers of a phase run in
+ * detached threads. The exiting thread waits for them on
+ * a condition, until the deadline of the phase passes.
+ * Handlers, that are still running then, are abandoned and
+ * end with the process.
+ * 
  * @date 2020-10-01
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
  */
 
+#define _GNU_SOURCE /* needed for pthread_condattr_setclock() */
+
 #include <jayc/jproc.h>
 #include <jayc/jlog.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_alloc.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+/**
+ * @brief Allocation statistics of module.
+ */
+JUTIL_ALLOC_MODULE("jproc_exit");
 
 typedef struct __jproc_exit_function_pair
 {
@@ -20,12 +40,84 @@ typedef struct __jproc_exit_function_pair
   void *ctx;
 } jproc_exit_function_t;
 
+/**
+ * @brief Handler registered for a shutdown phase.
+ */
+typedef struct __jproc_exit_shutdown
+{
+  jproc_shutdown_handler_t handler;   /**< Handler function. */
+  void *ctx;                          /**< Context for handler. */
+  struct __jproc_exit_shutdown *next; /**< Next handler of same phase. */
+} jproc_exit_shutdown_t;
+
+/**
+ * @brief Single run of a shutdown handler.
+ * 
+ * Owned by the thread running it, because the exiting
+ * thread does not wait for handlers past the deadline.
+ */
+typedef struct __jproc_exit_task
+{
+  jproc_shutdown_handler_t handler; /**< Handler to run. */
+  void *ctx;                        /**< Context for handler. */
+  int exit_value;                   /**< Value passed to @c exit() . */
+  int phase;                        /**< Phase of handler. */
+} jproc_exit_task_t;
+
 static jproc_exit_function_t exit_function = { NULL, NULL };
 
+static jproc_exit_shutdown_t *jproc_exit_phases[JPROC_EXIT_PHASE_NUMBER] = { NULL }; /**< Handlers per phase. */
+static size_t jproc_exit_pending[JPROC_EXIT_PHASE_NUMBER] = { 0 };                  /**< Running handlers per phase. */
+static pthread_mutex_t jproc_exit_mutex = PTHREAD_MUTEX_INITIALIZER;                /**< Protects handlers and counters. */
+static pthread_cond_t jproc_exit_cond;                                              /**< Signaled, when a handler returns. */
+static pthread_once_t jproc_exit_cond_once = PTHREAD_ONCE_INIT;                     /**< Initializes condition once. */
+static jutil_time_deadline_t jproc_exit_deadline = { JUTIL_TIME_DEADLINE_NEVER };   /**< End of shutdown. */
+static jutil_time_deadline_t jproc_exit_phase_deadlines[JPROC_EXIT_PHASE_NUMBER];   /**< End of each phase, passed to handlers. */
+static long jproc_exit_timeout = JPROC_EXIT_TIMEOUT_DEFAULT;                        /**< Time for all phases in milliseconds. */
+static atomic_int jproc_exit_started = false;                                       /**< @c true , once shutdown started. */
+
+/**
+ * @brief Runs handlers of phase in parallel and waits until
+ *        they return or deadline passes.
+ * 
+ * @param phase       Phase to run.
+ * @param exit_value  Value passed to @c exit() .
+ */
+static void jproc_exit_runPhase(int phase, int exit_value);
+
+/**
+ * @brief Thread function, runs one shutdown handler.
+ * 
+ * @param ctx Task ( @c jproc_exit_task_t ), freed by thread.
+ * 
+ * @return    @c NULL .
+ */
+static void *jproc_exit_task_function(void *ctx);
+
+/**
+ * @brief Initializes condition on monotonic clock.
+ */
+static void jproc_exit_initCond(void);
+
 //------------------------------------------------------------------------------
 //
 void jproc_exit(int exit_value)
 {
+  if(atomic_exchange(&jproc_exit_started, true))
+  {
+    /* Second request to exit does not wait for shutdown. */
+    _exit(exit_value);
+  }
+
+  pthread_mutex_lock(&jproc_exit_mutex);
+  jutil_time_deadline_set(&jproc_exit_deadline, jproc_exit_timeout);
+  pthread_mutex_unlock(&jproc_exit_mutex);
+
+  for(int phase = 0; phase < JPROC_EXIT_PHASE_NUMBER; phase++)
+  {
+    jproc_exit_runPhase(phase, exit_value);
+  }
+
   if(exit_function.handler)
   {
     exit_function.handler(exit_value, exit_function.ctx);
@@ -43,4 +135,187 @@ int jproc_exit_setHandler(jproc_exit_handler_t handler, void *ctx)
   exit_function.ctx = ctx;
 
   return true;
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------
+//
+int jproc_exit_addShutdownHandler(int phase, jproc_shutdown_handler_t handler, void *ctx)
+{
+  if(phase < 0 || phase >= JPROC_EXIT_PHASE_NUMBER || handler == NULL)
+  {
+    return false;
+  }
+
+  jproc_exit_shutdown_t *entry = (jproc_exit_shutdown_t *)JUTIL_ALLOC_MALLOC(sizeof(jproc_exit_shutdown_t));
+  if(entry == NULL)
+  {
+    return false;
+  }
+
+  entry->handler = handler;
+  entry->ctx = ctx;
+
+  pthread_mutex_lock(&jproc_exit_mutex);
+  entry->next = jproc_exit_phases[phase];
+  jproc_exit_phases[phase] = entry;
+  pthread_mutex_unlock(&jproc_exit_mutex);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jproc_exit_removeShutdownHandler(int phase, jproc_shutdown_handler_t handler, void *ctx)
+{
+  if(phase < 0 || phase >= JPROC_EXIT_PHASE_NUMBER)
+  {
+    return false;
+  }
+
+  int ret = false;
+
+  pthread_mutex_lock(&jproc_exit_mutex);
+  jproc_exit_shutdown_t **itr = &jproc_exit_phases[phase];
+  while(*itr != NULL)
+  {
+    if((*itr)->handler == handler && (*itr)->ctx == ctx)
+    {
+      jproc_exit_shutdown_t *entry = *itr;
+      *itr = entry->next;
+      JUTIL_ALLOC_FREE(entry);
+      ret = true;
+      break;
+    }
+    itr = &(*itr)->next;
+  }
+  pthread_mutex_unlock(&jproc_exit_mutex);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jproc_exit_setTimeout(long timeout)
+{
+  pthread_mutex_lock(&jproc_exit_mutex);
+  jproc_exit_timeout = timeout;
+  pthread_mutex_unlock(&jproc_exit_mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+void jproc_exit_runPhase(int phase, int exit_value)
+{
+  pthread_once(&jproc_exit_cond_once, &jproc_exit_initCond);
+
+  pthread_mutex_lock(&jproc_exit_mutex);
+
+  /* Late phases still get some time, if earlier phases used up the deadline. */
+  jutil_time_deadline_t *deadline = &jproc_exit_phase_deadlines[phase];
+  jutil_time_deadline_set(deadline, JPROC_EXIT_TIMEOUT_PHASE_MIN);
+  if(jproc_exit_deadline.expires > deadline->expires)
+  {
+    *deadline = jproc_exit_deadline;
+  }
+
+  /* List is taken, handlers may remove themselves while running. */
+  jproc_exit_shutdown_t *entries = jproc_exit_phases[phase];
+  jproc_exit_phases[phase] = NULL;
+
+  while(entries != NULL)
+  {
+    jproc_exit_shutdown_t *entry = entries;
+    entries = entry->next;
+
+    jproc_exit_task_t *task = (jproc_exit_task_t *)JUTIL_ALLOC_MALLOC(sizeof(jproc_exit_task_t));
+    pthread_attr_t attr;
+    pthread_t thread;
+    int started = false;
+
+    if(task != NULL && pthread_attr_init(&attr) == 0)
+    {
+      task->handler = entry->handler;
+      task->ctx = entry->ctx;
+      task->exit_value = exit_value;
+      task->phase = phase;
+
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+      started = (jutil_thread_createPthread(&thread, &attr, &jproc_exit_task_function, task) == 0);
+      pthread_attr_destroy(&attr);
+    }
+
+    if(started)
+    {
+      jproc_exit_pending[phase]++;
+    }
+    else
+    {
+      /* Without thread, handler runs here and can not be bounded. */
+      JUTIL_ALLOC_FREE(task);
+      JLOG_WARN("Could not start thread for shutdown handler of phase [%d]. Running it directly.", phase);
+      pthread_mutex_unlock(&jproc_exit_mutex);
+      entry->handler(exit_value, deadline, entry->ctx);
+      pthread_mutex_lock(&jproc_exit_mutex);
+    }
+
+    JUTIL_ALLOC_FREE(entry);
+  }
+
+  while(jproc_exit_pending[phase] > 0)
+  {
+    int remaining = jutil_time_deadline_getRemaining(deadline);
+    if(remaining == 0)
+    {
+      JLOG_WARN("Shutdown deadline passed in phase [%d]. [%zu] handlers still running.", phase, jproc_exit_pending[phase]);
+      break;
+    }
+
+    if(remaining < 0)
+    {
+      pthread_cond_wait(&jproc_exit_cond, &jproc_exit_mutex);
+    }
+    else
+    {
+      struct timespec until;
+      clock_gettime(CLOCK_MONOTONIC, &until);
+      until.tv_sec += remaining / 1000;
+      until.tv_nsec += (long)(remaining % 1000) * 1000000L;
+      if(until.tv_nsec >= 1000000000L)
+      {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&jproc_exit_cond, &jproc_exit_mutex, &until);
+    }
+  }
+
+  pthread_mutex_unlock(&jproc_exit_mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jproc_exit_task_function(void *ctx)
+{
+  jproc_exit_task_t *task = (jproc_exit_task_t *)ctx;
+
+  task->handler(task->exit_value, &jproc_exit_phase_deadlines[task->phase], task->ctx);
+
+  pthread_mutex_lock(&jproc_exit_mutex);
+  jproc_exit_pending[task->phase]--;
+  pthread_cond_broadcast(&jproc_exit_cond);
+  pthread_mutex_unlock(&jproc_exit_mutex);
+
+  JUTIL_ALLOC_FREE(task);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jproc_exit_initCond(void)
+{
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&jproc_exit_cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
@@ -4,15 +4,37 @@
  * 
  * @brief Implements signal functionality for jproc.
  * 
+ * Handlers are installed with @c sigaction() . In file
+ * descriptor mode, signals with handlers are blocked and
+ * read from a @c signalfd() instead, handlers are called
+ * by @c #jproc_signal_dispatch() outside of signal context.
+ * 
  * @date 2020-10-01
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
  */
 
+#define _GNU_SOURCE /* needed for sigaction() and SA_RESTART */
+
 #include <jayc/jproc.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
 #include <signal.h>
+#include <pthread.h>
+#include <sys/signalfd.h>
+
+/**
+ * @brief Number of signal numbers (Linux has signals 1 to 64).
+ */
+#define JPROC_SIGNAL_NUMBER 65
+
+/**
+ * @brief Number of signals read from descriptor at once.
+ */
+#define JPROC_SIGNAL_SIZE_READ 16
 
 typedef struct __jproc_signal_handlerStruct
 {
@@ -20,15 +42,28 @@ typedef struct __jproc_signal_handlerStruct
   void *ctx;
 } jproc_signal_handlerStruct_t;
 
-static jproc_signal_handlerStruct_t jproc_signal_handlers[32] = { { NULL, NULL } };
+static jproc_signal_handlerStruct_t jproc_signal_handlers[JPROC_SIGNAL_NUMBER] = { { NULL, NULL } };
+
+static int jproc_signal_fd = -1;  /**< Descriptor of file descriptor mode, @c -1 if not used. */
+static sigset_t jproc_signal_set; /**< Signals delivered through descriptor. */
 
 static void jproc_signalHandler(int signum);
 
+/**
+ * @brief Adds signal to descriptor and blocks it in calling thread.
+ * 
+ * @param signal_number Signal to add.
+ * 
+ * @return              @c true , if successful.
+ * @return              @c false , if error occured.
+ */
+static int jproc_signal_addToFd(int signal_number);
+
 //------------------------------------------------------------------------------
 //
 int jproc_signal_setHandler(int signal_number, jproc_signal_handler_t handler, void *ctx)
 {
-  if(signal_number >= 32 || signal_number < 0)
+  if(signal_number >= JPROC_SIGNAL_NUMBER || signal_number <= 0)
   {
     return false;
   }
@@ -36,16 +71,114 @@ int jproc_signal_setHandler(int signal_number, jproc_signal_handler_t handler, v
   jproc_signal_handlers[signal_number].handler = handler;
   jproc_signal_handlers[signal_number].ctx = ctx;
 
-  signal(signal_number, jproc_signalHandler);
+  if(jproc_signal_fd >= 0)
+  {
+    return jproc_signal_addToFd(signal_number);
+  }
+
+  /* Restarting keeps system calls of the program from failing with EINTR. */
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = &jproc_signalHandler;
+  action.sa_flags = SA_RESTART;
+  sigfillset(&action.sa_mask);
+
+  if(sigaction(signal_number, &action, NULL) != 0)
+  {
+    return false;
+  }
 
   return true;
 }
 
+//------------------------------------------------------------------------------
+//
+int jproc_signal_useFileDescriptor(void)
+{
+  if(jproc_signal_fd >= 0)
+  {
+    return true;
+  }
+
+  sigemptyset(&jproc_signal_set);
+  jproc_signal_fd = signalfd(-1, &jproc_signal_set, SFD_NONBLOCK | SFD_CLOEXEC);
+  if(jproc_signal_fd < 0)
+  {
+    return false;
+  }
+
+  /* Move handlers, that were installed with sigaction(). */
+  for(int i = 1; i < JPROC_SIGNAL_NUMBER; i++)
+  {
+    if(jproc_signal_handlers[i].handler && jproc_signal_addToFd(i) == false)
+    {
+      close(jproc_signal_fd);
+      jproc_signal_fd = -1;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jproc_signal_getFileDescriptor(void)
+{
+  return jproc_signal_fd;
+}
+
+//------------------------------------------------------------------------------
+//
+int jproc_signal_dispatch(void)
+{
+  if(jproc_signal_fd < 0)
+  {
+    return -1;
+  }
+
+  int dispatched = 0;
+  struct signalfd_siginfo infos[JPROC_SIGNAL_SIZE_READ];
+
+  while(true)
+  {
+    ssize_t ret_read = read(jproc_signal_fd, infos, sizeof(infos));
+    if(ret_read < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        return dispatched;
+      }
+      return -1;
+    }
+
+    size_t count = (size_t)ret_read / sizeof(struct signalfd_siginfo);
+    for(size_t i = 0; i < count; i++)
+    {
+      int signum = (int)infos[i].ssi_signo;
+      if(signum > 0 && signum < JPROC_SIGNAL_NUMBER && jproc_signal_handlers[signum].handler)
+      {
+        jproc_signal_handlers[signum].handler(signum, jproc_signal_handlers[signum].ctx);
+        dispatched++;
+      }
+    }
+
+    if(count < JPROC_SIGNAL_SIZE_READ)
+    {
+      return dispatched;
+    }
+  }
+}
+
 //------------------------------------------------------------------------------
 //
 void jproc_signalHandler(int signum)
 {
-  if(signum >= 32 || signum < 0)
+  if(signum >= JPROC_SIGNAL_NUMBER || signum <= 0)
   {
     return;
   }
@@ -54,4 +187,24 @@ void jproc_signalHandler(int signum)
   {
     jproc_signal_handlers[signum].handler(signum, jproc_signal_handlers[signum].ctx);
   }
-}
\ No newline at end of file
+}
+
+//------------------------------------------------------------------------------
+//
+int jproc_signal_addToFd(int signal_number)
+{
+  sigaddset(&jproc_signal_set, signal_number);
+
+  /* Signal has to be blocked, or it is still delivered to a handler. */
+  if(pthread_sigmask(SIG_BLOCK, &jproc_signal_set, NULL) != 0)
+  {
+    return false;
+  }
+
+  if(signalfd(jproc_signal_fd, &jproc_signal_set, SFD_NONBLOCK | SFD_CLOEXEC) < 0)
+  {
+    return false;
+  }
+
+  return true;
+}
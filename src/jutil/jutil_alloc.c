@@ -0,0 +1,398 @@
+/**
+ * @file jutil_alloc.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_alloc.
+ * 
+ * Without allocator, functions of libc are called directly.
+ * @c calloc() , @c strdup() and aligned memory are built on
+ * @c alloc , so allocators only need three functions.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+//==============================================================================
+// Define global variables.
+//
+
+/**
+ * @brief Allocator used, if object has none.
+ */
+static jutil_alloc_allocator_t jutil_alloc_global = { NULL, NULL, NULL, NULL };
+
+/**
+ * @brief @c true , if allocations are counted.
+ */
+static atomic_int jutil_alloc_statistics = false;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Returns allocator to use.
+ * 
+ * @param allocator Allocator of object, or @c NULL .
+ * 
+ * @return          Allocator of object, global allocator,
+ *                  or @c NULL for libc.
+ */
+static const jutil_alloc_allocator_t *jutil_alloc_select(const jutil_alloc_allocator_t *allocator);
+
+/**
+ * @brief Adds to counter of module.
+ * 
+ * Registers counter at first call.
+ * 
+ * @param site  Cached counter of module.
+ * @param name  Metric name.
+ * @param help  Description of metric.
+ * @param value Value to add.
+ */
+static void jutil_alloc_count(_Atomic(jutil_metrics_counter_t *) *site, const char *name, const char *help, unsigned long long value);
+
+/**
+ * @brief Counts allocation, if statistics are enabled.
+ * 
+ * @param module Statistics of module, or @c NULL .
+ * @param size   Requested bytes.
+ * @param number Number of new allocations ( @c 0 for resize).
+ */
+static void jutil_alloc_countAlloc(jutil_alloc_module_t *module, size_t size, unsigned long long number);
+
+/**
+ * @brief Counts free, if statistics are enabled.
+ * 
+ * @param module Statistics of module, or @c NULL .
+ */
+static void jutil_alloc_countFree(jutil_alloc_module_t *module);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+int jutil_alloc_setAllocator(const jutil_alloc_allocator_t *allocator)
+{
+  if(allocator == NULL)
+  {
+    memset(&jutil_alloc_global, 0, sizeof(jutil_alloc_allocator_t));
+    return true;
+  }
+
+  if(allocator->alloc == NULL || allocator->realloc == NULL || allocator->free == NULL)
+  {
+    return false;
+  }
+
+  jutil_alloc_global = *allocator;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_alloc_setStatistics(int enable)
+{
+  atomic_store_explicit(&jutil_alloc_statistics, (enable ? true : false), memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_alloc_malloc(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, size_t size)
+{
+  const jutil_alloc_allocator_t *selected = jutil_alloc_select(allocator);
+
+  void *ptr;
+  if(selected)
+  {
+    ptr = selected->alloc(selected->ctx, size);
+  }
+  else
+  {
+    ptr = malloc(size);
+  }
+
+  if(ptr)
+  {
+    jutil_alloc_countAlloc(module, size, 1);
+  }
+  return ptr;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_alloc_calloc(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, size_t number, size_t size)
+{
+  if(size && number > SIZE_MAX / size)
+  {
+    return NULL;
+  }
+
+  const jutil_alloc_allocator_t *selected = jutil_alloc_select(allocator);
+  if(selected == NULL)
+  {
+    /* calloc() of libc can skip clearing fresh pages. */
+    void *ptr = calloc(number, size);
+    if(ptr)
+    {
+      jutil_alloc_countAlloc(module, number * size, 1);
+    }
+    return ptr;
+  }
+
+  void *ptr = jutil_alloc_malloc(allocator, module, number * size);
+  if(ptr)
+  {
+    memset(ptr, 0, number * size);
+  }
+  return ptr;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_alloc_realloc(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, void *ptr, size_t size)
+{
+  const jutil_alloc_allocator_t *selected = jutil_alloc_select(allocator);
+
+  void *ret;
+  if(selected)
+  {
+    ret = selected->realloc(selected->ctx, ptr, size);
+  }
+  else
+  {
+    ret = realloc(ptr, size);
+  }
+
+  if(ret)
+  {
+    jutil_alloc_countAlloc(module, size, (ptr ? 0 : 1));
+  }
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_alloc_free(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, void *ptr)
+{
+  if(ptr == NULL)
+  {
+    return;
+  }
+
+  const jutil_alloc_allocator_t *selected = jutil_alloc_select(allocator);
+  if(selected)
+  {
+    selected->free(selected->ctx, ptr);
+  }
+  else
+  {
+    free(ptr);
+  }
+
+  jutil_alloc_countFree(module);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_alloc_mallocAligned(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, size_t alignment, size_t size)
+{
+  if(alignment == 0 || (alignment & (alignment - 1)) != 0)
+  {
+    return NULL;
+  }
+
+  const jutil_alloc_allocator_t *selected = jutil_alloc_select(allocator);
+  if(selected == NULL)
+  {
+    /* aligned_alloc() needs a multiple of the alignment. */
+    if(alignment < sizeof(void *))
+    {
+      alignment = sizeof(void *);
+    }
+    if(size > SIZE_MAX - alignment)
+    {
+      return NULL;
+    }
+
+    void *ptr = aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+    if(ptr)
+    {
+      jutil_alloc_countAlloc(module, size, 1);
+    }
+    return ptr;
+  }
+
+  if(size > SIZE_MAX - alignment - sizeof(void *))
+  {
+    return NULL;
+  }
+
+  unsigned char *block = (unsigned char *)selected->alloc(selected->ctx, size + alignment - 1 + sizeof(void *));
+  if(block == NULL)
+  {
+    return NULL;
+  }
+
+  /* Start of block is stored in front of the aligned memory. */
+  uintptr_t start = (uintptr_t)(block + sizeof(void *));
+  unsigned char *ptr = (unsigned char *)((start + alignment - 1) & ~(uintptr_t)(alignment - 1));
+  memcpy(ptr - sizeof(void *), &block, sizeof(void *));
+
+  jutil_alloc_countAlloc(module, size, 1);
+  return ptr;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_alloc_freeAligned(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, void *ptr)
+{
+  if(ptr == NULL)
+  {
+    return;
+  }
+
+  const jutil_alloc_allocator_t *selected = jutil_alloc_select(allocator);
+  if(selected)
+  {
+    void *block;
+    memcpy(&block, (unsigned char *)ptr - sizeof(void *), sizeof(void *));
+    selected->free(selected->ctx, block);
+  }
+  else
+  {
+    free(ptr);
+  }
+
+  jutil_alloc_countFree(module);
+}
+
+//------------------------------------------------------------------------------
+//
+char *jutil_alloc_strdup(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, const char *string)
+{
+  if(string == NULL)
+  {
+    return NULL;
+  }
+
+  return jutil_alloc_strndup(allocator, module, string, strlen(string));
+}
+
+//------------------------------------------------------------------------------
+//
+char *jutil_alloc_strndup(const jutil_alloc_allocator_t *allocator, jutil_alloc_module_t *module, const char *string, size_t length)
+{
+  if(string == NULL)
+  {
+    return NULL;
+  }
+
+  const char *end = (const char *)memchr(string, 0, length);
+  if(end)
+  {
+    length = (size_t)(end - string);
+  }
+
+  char *copy = (char *)jutil_alloc_malloc(allocator, module, length + 1);
+  if(copy == NULL)
+  {
+    return NULL;
+  }
+
+  memcpy(copy, string, length);
+  copy[length] = 0;
+  return copy;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+const jutil_alloc_allocator_t *jutil_alloc_select(const jutil_alloc_allocator_t *allocator)
+{
+  if(allocator && allocator->alloc)
+  {
+    return allocator;
+  }
+
+  if(jutil_alloc_global.alloc)
+  {
+    return &jutil_alloc_global;
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_alloc_count(_Atomic(jutil_metrics_counter_t *) *site, const char *name, const char *help, unsigned long long value)
+{
+  jutil_metrics_counter_t *counter = atomic_load_explicit(site, memory_order_acquire);
+  if(counter == NULL)
+  {
+    counter = jutil_metrics_counter(name, help);
+    if(counter == NULL)
+    {
+      return;
+    }
+    atomic_store_explicit(site, counter, memory_order_release);
+  }
+
+  jutil_metrics_counter_add(counter, value);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_alloc_countAlloc(jutil_alloc_module_t *module, size_t size, unsigned long long number)
+{
+#ifndef JUTIL_NO_METRICS
+  if(module == NULL || atomic_load_explicit(&jutil_alloc_statistics, memory_order_relaxed) == false)
+  {
+    return;
+  }
+
+  if(number)
+  {
+    jutil_alloc_count(&module->allocations, module->name_allocations, "Allocations of module.", number);
+  }
+  jutil_alloc_count(&module->bytes, module->name_bytes, "Bytes requested by module.", (unsigned long long)size);
+#else
+  (void)module;
+  (void)size;
+  (void)number;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_alloc_countFree(jutil_alloc_module_t *module)
+{
+#ifndef JUTIL_NO_METRICS
+  if(module == NULL || atomic_load_explicit(&jutil_alloc_statistics, memory_order_relaxed) == false)
+  {
+    return;
+  }
+
+  jutil_alloc_count(&module->frees, module->name_frees, "Frees of module.", 1);
+#else
+  (void)module;
+#endif
+}
@@ -0,0 +1,491 @@
+/**
+ * @file jutil_arena.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_arena.
+ * 
+ * Blocks in use are linked from the newest ( @c current )
+ * to the oldest, so marks can release blocks from the top
+ * until they reach the block of the mark. Blocks of default
+ * size are moved to a list of spare blocks, when they are
+ * released, and taken again, before new blocks are allocated.
+ * 
+ * Alignment is calculated from addresses, so blocks only
+ * need the alignment of the allocator or @c mmap() .
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for MAP_ANONYMOUS, MAP_HUGETLB and MADV_HUGEPAGE */
+
+#include <jayc/jutil_arena.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_arena");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Size of huge pages. Mapped blocks are rounded up to it.
+ */
+#define JUTIL_ARENA_SIZE_HUGEPAGE (2 * 1024 * 1024)
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Memory block of arena.
+ */
+typedef struct __jutil_arena_block
+{
+  struct __jutil_arena_block *prev; /**< Older block in use, or next spare block. */
+  size_t size;                      /**< Usable bytes of @c data . */
+  size_t used;                      /**< Allocated bytes of @c data . */
+  size_t map_size;                  /**< Size of mapping, @c 0 if allocated with @c malloc() . */
+  int reusable;                     /**< @c true , if block has default size. */
+  unsigned char data[];             /**< Memory for allocations. */
+} jutil_arena_block_t;
+
+/**
+ * @brief Object pointer.
+ */
+struct __jutil_arena
+{
+  jutil_arena_block_t *current;      /**< Newest block in use. */
+  jutil_arena_block_t *spare;        /**< Released blocks of default size. */
+  size_t block_size;                 /**< Usable bytes of default blocks. */
+  int flags;                         /**< Flags of initialization. */
+  jutil_alloc_allocator_t allocator; /**< Allocator of blocks, empty for global allocator. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Allocates new block.
+ * 
+ * @param arena    Arena object.
+ * @param size     Minimum usable size in bytes.
+ * @param reusable @c true , if block has default size.
+ * 
+ * @return         New block.
+ * @return         @c NULL , if error occured.
+ */
+static jutil_arena_block_t *jutil_arena_block_create(jutil_arena_t *arena, size_t size, int reusable);
+
+/**
+ * @brief Frees block.
+ * 
+ * @param arena Arena object.
+ * @param block Block to free.
+ */
+static void jutil_arena_block_destroy(jutil_arena_t *arena, jutil_arena_block_t *block);
+
+/**
+ * @brief Allocates memory from block.
+ * 
+ * @param block     Block to allocate from.
+ * @param size      Size in bytes.
+ * @param alignment Power of 2.
+ * 
+ * @return          Pointer to memory.
+ * @return          @c NULL , if block is full.
+ */
+static void *jutil_arena_block_alloc(jutil_arena_block_t *block, size_t size, size_t alignment);
+
+/**
+ * @brief Removes newest block from blocks in use.
+ * 
+ * Keeps it as spare block or frees it.
+ * 
+ * @param arena Arena object.
+ */
+static void jutil_arena_release(jutil_arena_t *arena);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_arena_t *jutil_arena_init(size_t block_size, int flags)
+{
+  return jutil_arena_allocator_init(block_size, flags, NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_arena_t *jutil_arena_allocator_init(size_t block_size, int flags, const jutil_alloc_allocator_t *allocator)
+{
+  jutil_arena_t *arena = (jutil_arena_t *)jutil_alloc_malloc(allocator, &jutil_alloc_module, sizeof(jutil_arena_t));
+  if(arena == NULL)
+  {
+    return NULL;
+  }
+
+  arena->current = NULL;
+  arena->spare = NULL;
+  arena->block_size = (block_size ? block_size : JUTIL_ARENA_BLOCKSIZE_DEFAULT);
+  arena->flags = flags;
+  memset(&arena->allocator, 0, sizeof(jutil_alloc_allocator_t));
+  if(allocator)
+  {
+    arena->allocator = *allocator;
+  }
+
+  return arena;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_arena_free(jutil_arena_t *arena)
+{
+  if(arena == NULL)
+  {
+    return;
+  }
+
+  jutil_arena_reset(arena);
+  while(arena->spare)
+  {
+    jutil_arena_block_t *block = arena->spare;
+    arena->spare = block->prev;
+    jutil_arena_block_destroy(arena, block);
+  }
+
+  jutil_alloc_allocator_t allocator = arena->allocator;
+  jutil_alloc_free(&allocator, &jutil_alloc_module, arena);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_arena_alloc(jutil_arena_t *arena, size_t size)
+{
+  return jutil_arena_allocAligned(arena, size, JUTIL_ARENA_ALIGNMENT_DEFAULT);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_arena_allocAligned(jutil_arena_t *arena, size_t size, size_t alignment)
+{
+  if(arena == NULL || alignment == 0 || (alignment & (alignment - 1)) != 0)
+  {
+    return NULL;
+  }
+
+  /* Every allocation gets its own address. */
+  if(size == 0)
+  {
+    size = 1;
+  }
+
+  if(arena->current)
+  {
+    void *ptr = jutil_arena_block_alloc(arena->current, size, alignment);
+    if(ptr)
+    {
+      return ptr;
+    }
+  }
+
+  if(size > SIZE_MAX - alignment - sizeof(jutil_arena_block_t) - JUTIL_ARENA_SIZE_HUGEPAGE)
+  {
+    return NULL;
+  }
+
+  /* Rest of full block is not used anymore. */
+  size_t needed = size + alignment - 1;
+  jutil_arena_block_t *block;
+  if(needed <= arena->block_size && arena->spare)
+  {
+    block = arena->spare;
+    arena->spare = block->prev;
+  }
+  else if(needed <= arena->block_size)
+  {
+    block = jutil_arena_block_create(arena, arena->block_size, true);
+  }
+  else
+  {
+    block = jutil_arena_block_create(arena, needed, false);
+  }
+
+  if(block == NULL)
+  {
+    return NULL;
+  }
+
+  block->used = 0;
+  block->prev = arena->current;
+  arena->current = block;
+
+  return jutil_arena_block_alloc(block, size, alignment);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_arena_calloc(jutil_arena_t *arena, size_t number, size_t size)
+{
+  if(size && number > SIZE_MAX / size)
+  {
+    return NULL;
+  }
+
+  void *ptr = jutil_arena_alloc(arena, number * size);
+  if(ptr)
+  {
+    memset(ptr, 0, number * size);
+  }
+
+  return ptr;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jutil_arena_strdup(jutil_arena_t *arena, const char *string)
+{
+  if(string == NULL)
+  {
+    return NULL;
+  }
+
+  return jutil_arena_strndup(arena, string, strlen(string));
+}
+
+//------------------------------------------------------------------------------
+//
+char *jutil_arena_strndup(jutil_arena_t *arena, const char *string, size_t length)
+{
+  if(string == NULL)
+  {
+    return NULL;
+  }
+
+  const char *end = (const char *)memchr(string, 0, length);
+  if(end)
+  {
+    length = (size_t)(end - string);
+  }
+
+  char *copy = (char *)jutil_arena_allocAligned(arena, length + 1, 1);
+  if(copy == NULL)
+  {
+    return NULL;
+  }
+
+  memcpy(copy, string, length);
+  copy[length] = 0;
+  return copy;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_arena_reset(jutil_arena_t *arena)
+{
+  if(arena == NULL)
+  {
+    return;
+  }
+
+  while(arena->current)
+  {
+    jutil_arena_release(arena);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_arena_mark_t jutil_arena_getMark(jutil_arena_t *arena)
+{
+  jutil_arena_mark_t mark = { NULL, 0 };
+  if(arena && arena->current)
+  {
+    mark.block = arena->current;
+    mark.used = arena->current->used;
+  }
+
+  return mark;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_arena_rewind(jutil_arena_t *arena, jutil_arena_mark_t mark)
+{
+  if(arena == NULL)
+  {
+    return;
+  }
+
+  while(arena->current && arena->current != mark.block)
+  {
+    jutil_arena_release(arena);
+  }
+
+  if(arena->current && mark.used < arena->current->used)
+  {
+    arena->current->used = mark.used;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_arena_getUsed(jutil_arena_t *arena)
+{
+  size_t used = 0;
+  if(arena == NULL)
+  {
+    return used;
+  }
+
+  for(jutil_arena_block_t *block = arena->current; block; block = block->prev)
+  {
+    used += block->used;
+  }
+
+  return used;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_arena_getCapacity(jutil_arena_t *arena)
+{
+  size_t capacity = 0;
+  if(arena == NULL)
+  {
+    return capacity;
+  }
+
+  for(jutil_arena_block_t *block = arena->current; block; block = block->prev)
+  {
+    capacity += block->size;
+  }
+  for(jutil_arena_block_t *block = arena->spare; block; block = block->prev)
+  {
+    capacity += block->size;
+  }
+
+  return capacity;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_arena_block_t *jutil_arena_block_create(jutil_arena_t *arena, size_t size, int reusable)
+{
+  size_t total = sizeof(jutil_arena_block_t) + size;
+  jutil_arena_block_t *block;
+
+  if(arena->flags & JUTIL_ARENA_FLAG_HUGEPAGES)
+  {
+    size_t map_size = (total + JUTIL_ARENA_SIZE_HUGEPAGE - 1) & ~((size_t)JUTIL_ARENA_SIZE_HUGEPAGE - 1);
+
+    /* Reserved huge pages first, then transparent huge pages. */
+    void *ptr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if(ptr == MAP_FAILED)
+    {
+      ptr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if(ptr == MAP_FAILED)
+      {
+        return NULL;
+      }
+      madvise(ptr, map_size, MADV_HUGEPAGE);
+    }
+
+    block = (jutil_arena_block_t *)ptr;
+    block->size = map_size - sizeof(jutil_arena_block_t);
+    block->map_size = map_size;
+  }
+  else
+  {
+    block = (jutil_arena_block_t *)jutil_alloc_malloc(&arena->allocator, &jutil_alloc_module, total);
+    if(block == NULL)
+    {
+      return NULL;
+    }
+
+    block->size = size;
+    block->map_size = 0;
+  }
+
+  block->prev = NULL;
+  block->used = 0;
+  block->reusable = reusable;
+  return block;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_arena_block_destroy(jutil_arena_t *arena, jutil_arena_block_t *block)
+{
+  if(block->map_size)
+  {
+    munmap(block, block->map_size);
+  }
+  else
+  {
+    jutil_alloc_free(&arena->allocator, &jutil_alloc_module, block);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_arena_block_alloc(jutil_arena_block_t *block, size_t size, size_t alignment)
+{
+  uintptr_t start = (uintptr_t)(block->data + block->used);
+  size_t padding = (size_t)(-start & (uintptr_t)(alignment - 1));
+  size_t available = block->size - block->used;
+
+  if(padding > available || size > available - padding)
+  {
+    return NULL;
+  }
+
+  block->used += padding + size;
+  return (void *)(start + padding);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_arena_release(jutil_arena_t *arena)
+{
+  jutil_arena_block_t *block = arena->current;
+  arena->current = block->prev;
+
+  if(block->reusable)
+  {
+    block->prev = arena->spare;
+    arena->spare = block;
+  }
+  else
+  {
+    jutil_arena_block_destroy(arena, block);
+  }
+}
@@ -13,12 +13,21 @@
 #include <jayc/jproc.h>
 #include <jayc/jlog.h>
 #include <jayc/jinfo.h>
+#include <jayc/jutil_alloc.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
 
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_args");
+
+
+
 //==============================================================================
 // Define context structure and log macros.
 //
@@ -178,7 +187,7 @@ char *jutil_args_error(const char *fmt, ...)
   va_end(args);
 
   size_t ret_size = strlen(buf) + 1;
-  char *ret = (char *)malloc(sizeof(char) * ret_size);
+  char *ret = (char *)JUTIL_ALLOC_MALLOC(sizeof(char) * ret_size);
 
   memset(ret, 0, ret_size);
   memcpy(ret, buf, ret_size);
@@ -417,7 +426,7 @@ int jutil_args_processShortTag(jutil_args_ctx_t *ctx)
   /* Read additional arguments for option. */
   if(data_size)
   {
-    data = (char **)malloc(sizeof(char *) * data_size);
+    data = (char **)JUTIL_ALLOC_MALLOC(sizeof(char *) * data_size);
     if(data == NULL)
     {
       ERROR("malloc failed() [tag = -%c].", tag);
@@ -431,7 +440,7 @@ int jutil_args_processShortTag(jutil_args_ctx_t *ctx)
       if(ctx->counter >= ctx->argc)
       {
         jutil_args_printError(ctx, "Missing arguments for tag [-%c].", tag);
-        free(data);
+        JUTIL_ALLOC_FREE(data);
         return false;
       }
 
@@ -441,11 +450,11 @@ int jutil_args_processShortTag(jutil_args_ctx_t *ctx)
 
   /* Call option handler. */
   char *ret_handler = option->handler((const char **)data, data_size);
-  free(data);
+  JUTIL_ALLOC_FREE(data);
   if(ret_handler)
   {
     jutil_args_printError(ctx, (const char *)ret_handler);
-    free(ret_handler);
+    JUTIL_ALLOC_FREE(ret_handler);
     return false;
   }
 
@@ -494,7 +503,7 @@ int jutil_args_processLongTag(jutil_args_ctx_t *ctx)
   /* Read additional arguments for option. */
   if(data_size)
   {
-    data = (char **)malloc(sizeof(char *) * data_size);
+    data = (char **)JUTIL_ALLOC_MALLOC(sizeof(char *) * data_size);
     if(data == NULL)
     {
       ERROR("malloc failed() [tag = --%s].", tag);
@@ -517,11 +526,11 @@ int jutil_args_processLongTag(jutil_args_ctx_t *ctx)
 
   /* Call option handler. */
   char *ret_handler = option->handler((const char **)data, data_size);
-  free(data);
+  JUTIL_ALLOC_FREE(data);
   if(ret_handler)
   {
     jutil_args_printError(ctx, (const char *)ret_handler);
-    free(ret_handler);
+    JUTIL_ALLOC_FREE(ret_handler);
     return false;
   }
 
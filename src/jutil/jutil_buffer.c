@@ -0,0 +1,790 @@
+/**
+ * @file jutil_buffer.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_buffer.
+ * 
+ * Blocks are written only behind their used bytes and only
+ * by the buffer, that allocated them ( @c owner ), so slices
+ * of written bytes stay valid while the owner keeps writing.
+ * Data is moved inside a block only, if no other segment
+ * references it.
+ * 
+ * The first segment is stored in the buffer object, so
+ * buffers with one segment need no extra allocation.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jutil_buffer.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <string.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_buffer");
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Reference counted memory of segments.
+ */
+typedef struct __jutil_buffer_block
+{
+  atomic_size_t references;                 /**< Number of segments referencing block. */
+  _Atomic(jutil_buffer_t *) owner;          /**< Buffer, that may write behind @c used . @c NULL , if read only. */
+  size_t capacity;                          /**< Size of @c data in bytes. */
+  size_t used;                              /**< Bytes written to @c data . */
+  jutil_buffer_freeFunction_t function_free;/**< Releases wrapped memory. */
+  void *ctx;                                /**< Context pointer for @c function_free . */
+  unsigned char *data;                      /**< Memory of block. */
+  _Alignas(max_align_t) unsigned char storage[]; /**< Memory of allocated blocks. */
+} jutil_buffer_block_t;
+
+/**
+ * @brief Part of block in buffer.
+ */
+typedef struct __jutil_buffer_segment
+{
+  struct __jutil_buffer_segment *next;  /**< Next segment of buffer. */
+  jutil_buffer_block_t *block;          /**< Referenced block. */
+  size_t offset;                        /**< Start of segment in block. */
+  size_t length;                        /**< Size of segment in bytes. */
+} jutil_buffer_segment_t;
+
+/**
+ * @brief Object pointer.
+ */
+struct __jutil_buffer
+{
+  atomic_size_t references;       /**< Number of holders of buffer. */
+  jutil_buffer_segment_t *head;   /**< First segment. @c NULL , if buffer has none. */
+  jutil_buffer_segment_t *tail;   /**< Last segment. */
+  size_t size;                    /**< Bytes over all segments. */
+  jutil_buffer_segment_t first;   /**< Storage of first segment, used if free. */
+  int first_used;                 /**< @c true , if @c first is in chain. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Allocates buffer without segments.
+ * 
+ * @return Buffer with one reference.
+ * @return @c NULL , if error occured.
+ */
+static jutil_buffer_t *jutil_buffer_allocate(void);
+
+/**
+ * @brief Allocates block.
+ * 
+ * @param capacity Size of block in bytes.
+ * @param owner    Buffer, that may write block.
+ * 
+ * @return         Block without references.
+ * @return         @c NULL , if error occured.
+ */
+static jutil_buffer_block_t *jutil_buffer_block_create(size_t capacity, jutil_buffer_t *owner);
+
+/**
+ * @brief Releases reference to block.
+ * 
+ * @param block Block to release.
+ */
+static void jutil_buffer_block_release(jutil_buffer_block_t *block);
+
+/**
+ * @brief Adds segment to end of buffer.
+ * 
+ * Takes a reference of @c block .
+ * 
+ * @param buffer Buffer to add to.
+ * @param block  Block of segment.
+ * @param offset Start of segment in block.
+ * @param length Size of segment in bytes.
+ * 
+ * @return       @c true , if segment was added.
+ * @return       @c false , if error occured.
+ */
+static int jutil_buffer_addSegment(jutil_buffer_t *buffer, jutil_buffer_block_t *block, size_t offset, size_t length);
+
+/**
+ * @brief Removes first segment and releases its block.
+ * 
+ * @param buffer Buffer with segments.
+ */
+static void jutil_buffer_removeSegment(jutil_buffer_t *buffer);
+
+/**
+ * @brief Checks, if buffer can write behind last segment.
+ * 
+ * @param buffer Buffer object.
+ * 
+ * @return       @c true , if last segment ends at used bytes
+ *               of block, that is owned by buffer.
+ */
+static int jutil_buffer_isWritable(jutil_buffer_t *buffer);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jutil_buffer_init(size_t capacity)
+{
+  jutil_buffer_t *buffer = jutil_buffer_allocate();
+  if(buffer == NULL || capacity == 0)
+  {
+    return buffer;
+  }
+
+  jutil_buffer_block_t *block = jutil_buffer_block_create(capacity, buffer);
+  if(block == NULL || jutil_buffer_addSegment(buffer, block, 0, 0) == false)
+  {
+    JUTIL_ALLOC_FREE(block);
+    JUTIL_ALLOC_FREE(buffer);
+    return NULL;
+  }
+
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jutil_buffer_copy_init(const void *data, size_t size)
+{
+  if(data == NULL && size > 0)
+  {
+    return NULL;
+  }
+
+  jutil_buffer_t *buffer = jutil_buffer_init(size);
+  if(buffer == NULL)
+  {
+    return NULL;
+  }
+
+  if(size > 0)
+  {
+    memcpy(buffer->tail->block->data, data, size);
+    jutil_buffer_commit(buffer, size);
+  }
+
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jutil_buffer_wrap_init(void *data, size_t size, jutil_buffer_freeFunction_t function_free, void *ctx)
+{
+  if(data == NULL && size > 0)
+  {
+    return NULL;
+  }
+
+  jutil_buffer_t *buffer = jutil_buffer_allocate();
+  if(buffer == NULL)
+  {
+    return NULL;
+  }
+
+  jutil_buffer_block_t *block = jutil_buffer_block_create(0, NULL);
+  if(block == NULL)
+  {
+    JUTIL_ALLOC_FREE(buffer);
+    return NULL;
+  }
+
+  block->data = (unsigned char *)data;
+  block->capacity = size;
+  block->used = size;
+  block->function_free = function_free;
+  block->ctx = ctx;
+
+  jutil_buffer_addSegment(buffer, block, 0, size);
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jutil_buffer_ref(jutil_buffer_t *buffer)
+{
+  if(buffer)
+  {
+    atomic_fetch_add_explicit(&buffer->references, 1, memory_order_relaxed);
+  }
+
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_buffer_free(jutil_buffer_t *buffer)
+{
+  if(buffer == NULL)
+  {
+    return;
+  }
+
+  if(atomic_fetch_sub_explicit(&buffer->references, 1, memory_order_acq_rel) != 1)
+  {
+    return;
+  }
+
+  while(buffer->head)
+  {
+    jutil_buffer_removeSegment(buffer);
+  }
+
+  JUTIL_ALLOC_FREE(buffer);
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jutil_buffer_slice(jutil_buffer_t *buffer, size_t offset, size_t length)
+{
+  if(buffer == NULL || offset > buffer->size || length > buffer->size - offset)
+  {
+    return NULL;
+  }
+
+  jutil_buffer_t *slice = jutil_buffer_allocate();
+  if(slice == NULL)
+  {
+    return NULL;
+  }
+
+  for(jutil_buffer_segment_t *segment = buffer->head; segment && length > 0; segment = segment->next)
+  {
+    if(offset >= segment->length)
+    {
+      offset -= segment->length;
+      continue;
+    }
+
+    size_t part = segment->length - offset;
+    if(part > length)
+    {
+      part = length;
+    }
+
+    if(jutil_buffer_addSegment(slice, segment->block, segment->offset + offset, part) == false)
+    {
+      jutil_buffer_free(slice);
+      return NULL;
+    }
+
+    offset = 0;
+    length -= part;
+  }
+
+  return slice;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_buffer_append(jutil_buffer_t *buffer, const void *data, size_t size)
+{
+  if(buffer == NULL || (data == NULL && size > 0) || atomic_load_explicit(&buffer->references, memory_order_relaxed) > 1)
+  {
+    return false;
+  }
+
+  if(size == 0)
+  {
+    return true;
+  }
+
+  if(jutil_buffer_isWritable(buffer) && buffer->tail->block->capacity - buffer->tail->block->used >= size)
+  {
+    memcpy(buffer->tail->block->data + buffer->tail->block->used, data, size);
+    jutil_buffer_commit(buffer, size);
+    return true;
+  }
+
+  jutil_buffer_block_t *block = jutil_buffer_block_create((size > JUTIL_BUFFER_BLOCKSIZE_DEFAULT ? size : JUTIL_BUFFER_BLOCKSIZE_DEFAULT), buffer);
+  if(block == NULL)
+  {
+    return false;
+  }
+
+  if(jutil_buffer_addSegment(buffer, block, 0, 0) == false)
+  {
+    JUTIL_ALLOC_FREE(block);
+    return false;
+  }
+
+  memcpy(block->data, data, size);
+  jutil_buffer_commit(buffer, size);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_buffer_appendBuffer(jutil_buffer_t *buffer, jutil_buffer_t *source)
+{
+  if(buffer == NULL || source == NULL || source == buffer || atomic_load_explicit(&buffer->references, memory_order_relaxed) > 1)
+  {
+    return false;
+  }
+
+  for(jutil_buffer_segment_t *segment = source->head; segment; segment = segment->next)
+  {
+    if(segment->length == 0)
+    {
+      continue;
+    }
+
+    if(jutil_buffer_addSegment(buffer, segment->block, segment->offset, segment->length) == false)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_buffer_reserve(jutil_buffer_t *buffer, size_t size, size_t *available)
+{
+  if(buffer == NULL || atomic_load_explicit(&buffer->references, memory_order_relaxed) > 1)
+  {
+    return NULL;
+  }
+
+  jutil_buffer_segment_t *tail = buffer->tail;
+  int writable = jutil_buffer_isWritable(buffer);
+  size_t moved = 0;
+
+  if(writable)
+  {
+    jutil_buffer_block_t *block = tail->block;
+    if(block->capacity - block->used < size && tail->length + size <= block->capacity
+      && atomic_load_explicit(&block->references, memory_order_acquire) == 1)
+    {
+      /* No other segment reads the block, data is moved to its start. */
+      memmove(block->data, block->data + tail->offset, tail->length);
+      tail->offset = 0;
+      block->used = tail->length;
+    }
+
+    if(block->capacity - block->used >= size)
+    {
+      if(available)
+      {
+        *available = block->capacity - block->used;
+      }
+      return block->data + block->used;
+    }
+
+    moved = tail->length;
+  }
+
+  if(size > SIZE_MAX / 2 - moved)
+  {
+    return NULL;
+  }
+
+  /* Blocks of a growing segment double, so moving stays linear. */
+  size_t capacity = size + moved;
+  if(moved > 0 && capacity < tail->block->capacity * 2)
+  {
+    capacity = tail->block->capacity * 2;
+  }
+  if(capacity < JUTIL_BUFFER_BLOCKSIZE_DEFAULT)
+  {
+    capacity = JUTIL_BUFFER_BLOCKSIZE_DEFAULT;
+  }
+
+  jutil_buffer_block_t *block = jutil_buffer_block_create(capacity, buffer);
+  if(block == NULL)
+  {
+    return NULL;
+  }
+
+  /* Last segment moves to the new block, so data stays contiguous. */
+  if(writable)
+  {
+    jutil_buffer_block_t *old_block = tail->block;
+    memcpy(block->data, old_block->data + tail->offset, moved);
+    block->used = moved;
+
+    atomic_fetch_add_explicit(&block->references, 1, memory_order_relaxed);
+    atomic_store_explicit(&old_block->owner, NULL, memory_order_relaxed);
+    tail->block = block;
+    tail->offset = 0;
+    jutil_buffer_block_release(old_block);
+  }
+  else if(jutil_buffer_addSegment(buffer, block, 0, 0) == false)
+  {
+    JUTIL_ALLOC_FREE(block);
+    return NULL;
+  }
+
+  if(available)
+  {
+    *available = block->capacity - block->used;
+  }
+  return block->data + block->used;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_buffer_commit(jutil_buffer_t *buffer, size_t size)
+{
+  if(buffer == NULL || jutil_buffer_isWritable(buffer) == false)
+  {
+    return;
+  }
+
+  jutil_buffer_block_t *block = buffer->tail->block;
+  if(size > block->capacity - block->used)
+  {
+    size = block->capacity - block->used;
+  }
+
+  block->used += size;
+  buffer->tail->length += size;
+  buffer->size += size;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_buffer_consume(jutil_buffer_t *buffer, size_t size)
+{
+  if(buffer == NULL || atomic_load_explicit(&buffer->references, memory_order_relaxed) > 1)
+  {
+    return;
+  }
+
+  while(buffer->head && size > 0)
+  {
+    jutil_buffer_segment_t *segment = buffer->head;
+    if(size < segment->length)
+    {
+      segment->offset += size;
+      segment->length -= size;
+      buffer->size -= size;
+      return;
+    }
+
+    size -= segment->length;
+
+    /* Owned block is kept for next writes. */
+    if(segment == buffer->tail && atomic_load_explicit(&segment->block->owner, memory_order_relaxed) == buffer)
+    {
+      buffer->size -= segment->length;
+      segment->offset += segment->length;
+      segment->length = 0;
+      return;
+    }
+
+    jutil_buffer_removeSegment(buffer);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_buffer_getSize(jutil_buffer_t *buffer)
+{
+  if(buffer == NULL)
+  {
+    return 0;
+  }
+
+  return buffer->size;
+}
+
+//------------------------------------------------------------------------------
+//
+const void *jutil_buffer_getData(jutil_buffer_t *buffer, size_t *size)
+{
+  if(size)
+  {
+    *size = 0;
+  }
+
+  if(buffer == NULL)
+  {
+    return NULL;
+  }
+
+  for(jutil_buffer_segment_t *segment = buffer->head; segment; segment = segment->next)
+  {
+    if(segment->length > 0)
+    {
+      if(size)
+      {
+        *size = segment->length;
+      }
+      return segment->block->data + segment->offset;
+    }
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_buffer_getIovec(jutil_buffer_t *buffer, size_t offset, struct iovec *iov, int iov_max)
+{
+  if(buffer == NULL || iov == NULL)
+  {
+    return 0;
+  }
+
+  int iov_count = 0;
+  for(jutil_buffer_segment_t *segment = buffer->head; segment && iov_count < iov_max; segment = segment->next)
+  {
+    if(offset >= segment->length)
+    {
+      offset -= segment->length;
+      continue;
+    }
+
+    iov[iov_count].iov_base = segment->block->data + segment->offset + offset;
+    iov[iov_count].iov_len = segment->length - offset;
+    iov_count++;
+    offset = 0;
+  }
+
+  return iov_count;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_buffer_copyOut(jutil_buffer_t *buffer, size_t offset, void *dest, size_t size)
+{
+  if(buffer == NULL || dest == NULL)
+  {
+    return 0;
+  }
+
+  size_t copied = 0;
+  for(jutil_buffer_segment_t *segment = buffer->head; segment && copied < size; segment = segment->next)
+  {
+    if(offset >= segment->length)
+    {
+      offset -= segment->length;
+      continue;
+    }
+
+    size_t part = segment->length - offset;
+    if(part > size - copied)
+    {
+      part = size - copied;
+    }
+
+    memcpy((unsigned char *)dest + copied, segment->block->data + segment->offset + offset, part);
+    copied += part;
+    offset = 0;
+  }
+
+  return copied;
+}
+
+//------------------------------------------------------------------------------
+//
+const void *jutil_buffer_flatten(jutil_buffer_t *buffer)
+{
+  if(buffer == NULL || buffer->size == 0)
+  {
+    return NULL;
+  }
+
+  size_t size;
+  const void *data = jutil_buffer_getData(buffer, &size);
+  if(size == buffer->size)
+  {
+    return data;
+  }
+
+  if(atomic_load_explicit(&buffer->references, memory_order_relaxed) > 1)
+  {
+    return NULL;
+  }
+
+  jutil_buffer_block_t *block = jutil_buffer_block_create(buffer->size, buffer);
+  if(block == NULL)
+  {
+    return NULL;
+  }
+  block->used = jutil_buffer_copyOut(buffer, 0, block->data, buffer->size);
+
+  size = buffer->size;
+  while(buffer->head)
+  {
+    jutil_buffer_removeSegment(buffer);
+  }
+
+  /* First segment is free again, so adding can not fail. */
+  jutil_buffer_addSegment(buffer, block, 0, size);
+  return block->data;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_t *jutil_buffer_allocate(void)
+{
+  jutil_buffer_t *buffer = (jutil_buffer_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_buffer_t));
+  if(buffer == NULL)
+  {
+    return NULL;
+  }
+
+  atomic_init(&buffer->references, 1);
+  buffer->head = NULL;
+  buffer->tail = NULL;
+  buffer->size = 0;
+  buffer->first_used = false;
+
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_buffer_block_t *jutil_buffer_block_create(size_t capacity, jutil_buffer_t *owner)
+{
+  if(capacity > SIZE_MAX - sizeof(jutil_buffer_block_t))
+  {
+    return NULL;
+  }
+
+  jutil_buffer_block_t *block = (jutil_buffer_block_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_buffer_block_t) + capacity);
+  if(block == NULL)
+  {
+    return NULL;
+  }
+
+  atomic_init(&block->references, 0);
+  atomic_init(&block->owner, owner);
+  block->capacity = capacity;
+  block->used = 0;
+  block->function_free = NULL;
+  block->ctx = NULL;
+  block->data = block->storage;
+
+  return block;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_buffer_block_release(jutil_buffer_block_t *block)
+{
+  if(atomic_fetch_sub_explicit(&block->references, 1, memory_order_acq_rel) != 1)
+  {
+    return;
+  }
+
+  if(block->function_free)
+  {
+    block->function_free(block->ctx, block->data);
+  }
+
+  JUTIL_ALLOC_FREE(block);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_buffer_addSegment(jutil_buffer_t *buffer, jutil_buffer_block_t *block, size_t offset, size_t length)
+{
+  jutil_buffer_segment_t *segment;
+  if(buffer->first_used == false)
+  {
+    segment = &buffer->first;
+    buffer->first_used = true;
+  }
+  else
+  {
+    segment = (jutil_buffer_segment_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_buffer_segment_t));
+    if(segment == NULL)
+    {
+      return false;
+    }
+  }
+
+  atomic_fetch_add_explicit(&block->references, 1, memory_order_relaxed);
+  segment->next = NULL;
+  segment->block = block;
+  segment->offset = offset;
+  segment->length = length;
+
+  if(buffer->tail)
+  {
+    buffer->tail->next = segment;
+  }
+  else
+  {
+    buffer->head = segment;
+  }
+  buffer->tail = segment;
+  buffer->size += length;
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_buffer_removeSegment(jutil_buffer_t *buffer)
+{
+  jutil_buffer_segment_t *segment = buffer->head;
+  buffer->head = segment->next;
+  if(buffer->head == NULL)
+  {
+    buffer->tail = NULL;
+  }
+  buffer->size -= segment->length;
+
+  /* Slices can not write, when buffer address is reused. */
+  jutil_buffer_t *owner = buffer;
+  atomic_compare_exchange_strong_explicit(&segment->block->owner, &owner, NULL, memory_order_relaxed, memory_order_relaxed);
+  jutil_buffer_block_release(segment->block);
+
+  if(segment == &buffer->first)
+  {
+    buffer->first_used = false;
+  }
+  else
+  {
+    JUTIL_ALLOC_FREE(segment);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_buffer_isWritable(jutil_buffer_t *buffer)
+{
+  jutil_buffer_segment_t *tail = buffer->tail;
+  if(tail == NULL)
+  {
+    return false;
+  }
+
+  return (atomic_load_explicit(&tail->block->owner, memory_order_relaxed) == buffer && tail->offset + tail->length == tail->block->used);
+}
@@ -12,12 +12,23 @@
 #define _POSIX_C_SOURCE 200809L /* Needed for getline() */
 
 #include <jayc/jutil_cli.h>
+#include <jayc/jutil_arena.h>
 #include <jayc/jlog.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_cli");
+
+
 
 //==============================================================================
 // Define constants and structures.
@@ -29,9 +40,16 @@
 #define JUTIL_CLI_ARGS_MAX 16
 
 /**
- * @brief Delimiter characters for @c strtok() .
+ * @brief Initial size of read buffer in batch mode.
+ *        Grows for longer lines.
+ */
+#define JUTIL_CLI_BATCH_BUFSIZE 262144
+
+/**
+ * @brief Block size of argument arena. Fits most command lines
+ *        and what handlers allocate for them.
  */
-#define JUTIL_CLI_DELIMS " "
+#define JUTIL_CLI_ARENA_BLOCKSIZE 4096
 
 /**
  * @brief Session object.
@@ -41,6 +59,8 @@ struct __jutil_cli_session
   jutil_cli_cmdHandler_t handler;                 /**< Handler to call, when data recieved. */
   jutil_cli_getInputFunction_t function_getInput; /**< Function to get input for processing. */
   void *session_ctx;                              /**< Context pointer to pass to handler. */
+  jutil_arena_t *arena;                           /**< Arguments of current command. Reset after handler. */
+  int stopped;                                    /**< @c true , if batch should stop after command. */
 };
 
 
@@ -87,6 +107,21 @@ struct __jutil_cli_session
  */
 static int jutil_cli_getInput_default(void *ctx, char **buf_ptr, size_t *buf_size);
 
+/**
+ * @brief Tokenizes line and calls handler.
+ * 
+ * Empty lines are skipped. Argument arena is
+ * reset after the handler.
+ * 
+ * @param session Session object.
+ * @param line    Line without newline. Is modified.
+ * @param ret     Set to return value of handler.
+ * 
+ * @return        @c true , if handler was called.
+ * @return        @c false , if line is empty or invalid.
+ */
+static int jutil_cli_runLine(jutil_cli_t *session, char *line, int *ret);
+
 
 
 //==============================================================================
@@ -102,15 +137,23 @@ jutil_cli_t *jutil_cli_init(jutil_cli_cmdHandler_t handler, jutil_cli_getInputFu
     return NULL;
   }
 
-  jutil_cli_t *session = (jutil_cli_t *)malloc(sizeof(jutil_cli_t));
+  jutil_cli_t *session = (jutil_cli_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_cli_t));
   if(session == NULL)
   {
     return NULL;
   }
 
+  session->arena = jutil_arena_init(JUTIL_CLI_ARENA_BLOCKSIZE, 0);
+  if(session->arena == NULL)
+  {
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
   session->handler = handler;
   session->function_getInput = input_function;
   session->session_ctx = ctx;
+  session->stopped = false;
 
   return session;
 }
@@ -124,7 +167,8 @@ void jutil_cli_free(jutil_cli_t *session)
     return;
   }
 
-  free(session);
+  jutil_arena_free(session->arena);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
@@ -152,52 +196,228 @@ int jutil_cli_run(jutil_cli_t *session)
     return false;
   }
 
-  /* Processing arguments. */
-  char *args_buf[JUTIL_CLI_ARGS_MAX];
-  size_t arg_size;
+  /* Arguments point into the line, it is freed after the handler. */
+  int ret = false;
+  jutil_cli_runLine(session, cmd_str, &ret);
+
+  free(cmd_str);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+long jutil_cli_runBatch(jutil_cli_t *session, int file_descriptor)
+{
+  if(session == NULL || file_descriptor < 0)
+  {
+    return -1;
+  }
+
+  size_t buf_size = JUTIL_CLI_BATCH_BUFSIZE;
+  char *buf = (char *)JUTIL_ALLOC_MALLOC(buf_size + 1);
+  if(buf == NULL)
+  {
+    ERROR("malloc() failed.");
+    return -1;
+  }
+
+  size_t length = 0;
+  long commands = 0;
+  int end_of_file = false;
+  session->stopped = false;
 
-  char *arg_buf = strtok(cmd_str, JUTIL_CLI_DELIMS);
-  for(arg_size = 0; arg_buf != NULL; arg_size++)
+  while(session->stopped == false && end_of_file == false)
   {
-    /* Check not to overflow args_buf. */
-    if(arg_size >= JUTIL_CLI_ARGS_MAX)
+    ssize_t ret_read = read(file_descriptor, buf + length, buf_size - length);
+    if(ret_read < 0)
     {
-      DEBUG("Too many arguments [%lu].", arg_size+1);
-      break;
+      if(errno == EINTR)
+      {
+        continue;
+      }
+
+      ERROR("read() failed [%d : %s].", errno, strerror(errno));
+      JUTIL_ALLOC_FREE(buf);
+      return -1;
+    }
+
+    if(ret_read == 0)
+    {
+      end_of_file = true;
+    }
+    length += (size_t)ret_read;
+
+    /* Run all complete lines, the last line also at end of file. */
+    char *line = buf;
+    char *end = buf + length;
+    while(line < end && session->stopped == false)
+    {
+      char *newline = (char *)memchr(line, '\n', (size_t)(end - line));
+      if(newline == NULL)
+      {
+        if(end_of_file == false)
+        {
+          break;
+        }
+        newline = end;
+      }
+
+      *newline = '\0';
+      int ret = false;
+      if(jutil_cli_runLine(session, line, &ret))
+      {
+        commands++;
+      }
+      line = newline + 1;
+    }
+
+    if(line >= end)
+    {
+      length = 0;
+      continue;
     }
 
-    size_t len_arg = strlen(arg_buf);
+    length = (size_t)(end - line);
+    memmove(buf, line, length);
 
-    /* Check if string empty. */
-    if(len_arg == 0)
+    if(length == buf_size)
+    {
+      char *new_buf = (char *)JUTIL_ALLOC_REALLOC(buf, buf_size * 2 + 1);
+      if(new_buf == NULL)
+      {
+        ERROR("realloc() failed.");
+        JUTIL_ALLOC_FREE(buf);
+        return -1;
+      }
+      buf = new_buf;
+      buf_size *= 2;
+    }
+  }
+
+  JUTIL_ALLOC_FREE(buf);
+  return commands;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cli_stop(jutil_cli_t *session)
+{
+  if(session == NULL)
+  {
+    return;
+  }
+
+  session->stopped = true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cli_tokenize(char *line, const char **args, size_t args_max, size_t *arg_size)
+{
+  if(line == NULL || args == NULL || arg_size == NULL)
+  {
+    return false;
+  }
+
+  /* Unquoted and unescaped bytes are moved forward in place. */
+  char *read_ptr = line;
+  char *write_ptr = line;
+  size_t count = 0;
+
+  for(;;)
+  {
+    while(*read_ptr == ' ' || *read_ptr == '\t')
+    {
+      read_ptr++;
+    }
+
+    if(*read_ptr == '\0')
     {
-      ERROR("Read empty string [ctr = %lu].", arg_size);
       break;
     }
 
-    args_buf[arg_size] = (char *)malloc(sizeof(char) * (len_arg+1));
-    if(args_buf[arg_size] == NULL)
+    if(count >= args_max)
     {
-      ERROR("malloc() failed.");
+      DEBUG("Too many arguments [%lu].", count + 1);
       break;
     }
 
-    memset(args_buf[arg_size], 0, len_arg+1);
-    memcpy(args_buf[arg_size], arg_buf, len_arg);
+    args[count++] = write_ptr;
+    char quote = '\0';
+
+    while(*read_ptr != '\0')
+    {
+      char c = *read_ptr;
+
+      if(quote)
+      {
+        if(c == quote)
+        {
+          quote = '\0';
+          read_ptr++;
+        }
+        else if(c == '\\' && quote == '"' && read_ptr[1] != '\0')
+        {
+          *write_ptr++ = read_ptr[1];
+          read_ptr += 2;
+        }
+        else
+        {
+          *write_ptr++ = *read_ptr++;
+        }
+        continue;
+      }
+
+      if(c == ' ' || c == '\t')
+      {
+        break;
+      }
+
+      if(c == '"' || c == '\'')
+      {
+        quote = c;
+        read_ptr++;
+      }
+      else if(c == '\\' && read_ptr[1] != '\0')
+      {
+        *write_ptr++ = read_ptr[1];
+        read_ptr += 2;
+      }
+      else
+      {
+        *write_ptr++ = *read_ptr++;
+      }
+    }
+
+    if(quote)
+    {
+      ERROR("Missing closing quote [%c] in argument [%lu].", quote, count);
+      return false;
+    }
 
-    arg_buf = strtok(NULL, JUTIL_CLI_DELIMS);
+    int end_of_line = (*read_ptr == '\0');
+    *write_ptr++ = '\0';
+    if(end_of_line)
+    {
+      break;
+    }
+    read_ptr++;
   }
 
-  free(cmd_str);
-  int ret = session->handler((const char **)args_buf, arg_size, session->session_ctx);
+  *arg_size = count;
+  return true;
+}
 
-  size_t ctr;
-  for(ctr = 0; ctr < arg_size; ctr++)
+//------------------------------------------------------------------------------
+//
+jutil_arena_t *jutil_cli_getArena(jutil_cli_t *session)
+{
+  if(session == NULL)
   {
-    free(args_buf[ctr]);
+    return NULL;
   }
 
-  return ret;
+  return session->arena;
 }
 
 
@@ -206,6 +426,40 @@ int jutil_cli_run(jutil_cli_t *session)
 // Implement internal functions.
 //
 
+//------------------------------------------------------------------------------
+//
+int jutil_cli_runLine(jutil_cli_t *session, char *line, int *ret)
+{
+  size_t length = strlen(line);
+  if(length > 0 && line[length - 1] == '\r')
+  {
+    line[length - 1] = '\0';
+  }
+
+  while(*line == ' ' || *line == '\t')
+  {
+    line++;
+  }
+
+  /* Scripts can have comments. */
+  if(*line == '\0' || *line == '#')
+  {
+    return false;
+  }
+
+  const char *args[JUTIL_CLI_ARGS_MAX];
+  size_t arg_size = 0;
+  if(jutil_cli_tokenize(line, args, JUTIL_CLI_ARGS_MAX, &arg_size) == false || arg_size == 0)
+  {
+    return false;
+  }
+
+  *ret = session->handler(args, arg_size, session->session_ctx);
+
+  jutil_arena_reset(session->arena);
+  return true;
+}
+
 //------------------------------------------------------------------------------
 //
 int jutil_cli_getInput_default(void *ctx, char **buf_ptr, size_t *buf_size)
@@ -0,0 +1,932 @@
+/**
+ * @file jutil_cmap.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_cmap.
+ * 
+ * Entries are stored in a chained hash table. Published
+ * nodes are never changed, except for their next pointer.
+ * Changing data or growing the table creates new nodes,
+ * so readers always see complete entries.
+ * 
+ * Readers only announce the epoch, in which their read
+ * section started, in a record of their own thread
+ * (one cache line per thread). Writers unlink memory,
+ * start a new epoch and wait, until no record shows an
+ * older epoch, before the memory is freed.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _POSIX_C_SOURCE 200809L /* needed for sched_yield() */
+
+#include <jayc/jutil_cmap.h>
+#include <jayc/jutil_hash.h>
+#include <jayc/jutil_alloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_cmap");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Number of buckets of new tables. Has to be a power of 2.
+ */
+#define JUTIL_CMAP_CAPACITY_MIN 16
+
+/**
+ * @brief Size of a cache line. Reader records are aligned to it.
+ */
+#define JUTIL_CMAP_SIZE_CACHELINE 64
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+struct __jutil_cmap_table;
+
+/**
+ * @brief Entry of map.
+ * 
+ * Public pair is first member, so pointers to the
+ * pair can be cast to the node.
+ */
+typedef struct __jutil_cmap_node
+{
+  jutil_map_data_t pair;                    /**< Index and data returned to user. Index points to @c key . */
+  uint32_t hash;                            /**< Hash of index. */
+  uint32_t length;                          /**< Length of index. */
+  _Atomic(struct __jutil_cmap_node *) next; /**< Next node in bucket. */
+  struct __jutil_cmap_table *table;         /**< Table, node belongs to. Used for iteration. */
+  char key[];                               /**< Index string. */
+} jutil_cmap_node_t;
+
+/**
+ * @brief Hash table with chained buckets.
+ */
+typedef struct __jutil_cmap_table
+{
+  size_t capacity;                          /**< Number of buckets. Power of 2. */
+  _Atomic(jutil_cmap_node_t *) buckets[];   /**< First node of each bucket. */
+} jutil_cmap_table_t;
+
+/**
+ * @brief Read section record of one thread.
+ * 
+ * Aligned to cache line, so readers do not
+ * write to lines of other threads.
+ */
+typedef struct __jutil_cmap_reader
+{
+  _Alignas(JUTIL_CMAP_SIZE_CACHELINE)
+  _Atomic uint_fast64_t epoch;              /**< Epoch of running section. @c 0 , if thread is not reading. */
+  atomic_int used;                          /**< Record belongs to a running thread. */
+  unsigned int nesting;                     /**< Number of nested sections. Only used by owner thread. */
+  struct __jutil_cmap_reader *next;         /**< Next record. Not changed, after record is listed. */
+} jutil_cmap_reader_t;
+
+/**
+ * @brief Object pointer.
+ */
+struct __jutil_cmap
+{
+  _Atomic(jutil_cmap_table_t *) table;      /**< Current table. */
+  atomic_size_t size;                       /**< Number of entries. */
+  pthread_mutex_t mutex;                    /**< Serializes writers. */
+  uint64_t seed;                            /**< Seed of hashes, random per process. */
+};
+
+
+
+//==============================================================================
+// Define global variables.
+//
+
+/**
+ * @brief Current epoch. Only changed by writers.
+ */
+static _Atomic uint_fast64_t jutil_cmap_epoch = 1;
+
+/**
+ * @brief List of reader records. Records are not freed,
+ *        but reused by new threads.
+ */
+static _Atomic(jutil_cmap_reader_t *) jutil_cmap_readers = NULL;
+
+/**
+ * @brief Creates key for thread exit.
+ */
+static pthread_once_t jutil_cmap_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Key to release records at thread exit.
+ */
+static pthread_key_t jutil_cmap_key;
+
+/**
+ * @brief @c true , if @c #jutil_cmap_key was created.
+ */
+static int jutil_cmap_keyCreated = false;
+
+/**
+ * @brief Record of calling thread.
+ */
+static _Thread_local jutil_cmap_reader_t *jutil_cmap_reader = NULL;
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Checks index and returns its length.
+ * 
+ * @param index Index to check.
+ * 
+ * @return      Length of index.
+ * @return      @c 0 , if index is @c NULL , empty or too long.
+ */
+static size_t jutil_cmap_checkIndex(const char *index);
+
+/**
+ * @brief Calculates seeded hash of index.
+ * 
+ * @param map   Map with seed.
+ * @param index Index to hash.
+ * @param size  Length of index.
+ * 
+ * @return      Hash value.
+ */
+static uint32_t jutil_cmap_hash(jutil_cmap_t *map, const char *index, size_t size);
+
+/**
+ * @brief Finds node in current table.
+ * 
+ * Has to be called inside read section or by writer.
+ * 
+ * @param map   Map object.
+ * @param index Index string to search by.
+ * @param size  Length of index.
+ * @param hash  Hash of index.
+ * @param link  Returns link pointing to node. Can be @c NULL .
+ * 
+ * @return      Node with index.
+ * @return      @c NULL , if not found.
+ */
+static jutil_cmap_node_t *jutil_cmap_find(jutil_cmap_t *map, const char *index, size_t size, uint32_t hash, _Atomic(jutil_cmap_node_t *) **link);
+
+/**
+ * @brief Creates node, that is not linked yet.
+ * 
+ * @param table Table of node.
+ * @param index Index string.
+ * @param size  Length of index.
+ * @param hash  Hash of index.
+ * @param data  Data of node.
+ * 
+ * @return      New node.
+ * @return      @c NULL , if error occured.
+ */
+static jutil_cmap_node_t *jutil_cmap_node_create(jutil_cmap_table_t *table, const char *index, size_t size, uint32_t hash, void *data);
+
+/**
+ * @brief Inserts new entry into current table.
+ * 
+ * Has to be called by writer. Grows table, if needed.
+ * 
+ * @param map   Map object.
+ * @param index Index string.
+ * @param size  Length of index.
+ * @param hash  Hash of index.
+ * @param data  Data to store.
+ * 
+ * @return      @c true , if entry was inserted.
+ * @return      @c false , if error occured.
+ */
+static int jutil_cmap_insert(jutil_cmap_t *map, const char *index, size_t size, uint32_t hash, void *data);
+
+/**
+ * @brief Replaces table with one of double capacity.
+ * 
+ * Has to be called by writer. Old nodes are freed,
+ * after readers left.
+ * 
+ * @param map Map object.
+ * 
+ * @return    @c true , if table was replaced.
+ * @return    @c false , if error occured.
+ */
+static int jutil_cmap_grow(jutil_cmap_t *map);
+
+/**
+ * @brief Allocates empty table.
+ * 
+ * @param capacity Number of buckets.
+ * 
+ * @return         New table.
+ * @return         @c NULL , if error occured.
+ */
+static jutil_cmap_table_t *jutil_cmap_table_create(size_t capacity);
+
+/**
+ * @brief Frees table and its nodes.
+ * 
+ * @param table Table to free.
+ */
+static void jutil_cmap_table_free(jutil_cmap_table_t *table);
+
+/**
+ * @brief Waits, until read sections, that were
+ *        running at call, have ended.
+ */
+static void jutil_cmap_synchronize();
+
+/**
+ * @brief Returns record of calling thread.
+ * 
+ * Takes unused record or creates new one.
+ * 
+ * @return  Record of thread.
+ * @return  @c NULL , if error occured.
+ */
+static jutil_cmap_reader_t *jutil_cmap_getReader();
+
+/**
+ * @brief Creates key for thread exit.
+ */
+static void jutil_cmap_keyInit();
+
+/**
+ * @brief Releases record at thread exit.
+ * 
+ * @param ptr Record of thread.
+ */
+static void jutil_cmap_keyDestructor(void *ptr);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_cmap_t *jutil_cmap_init()
+{
+  jutil_cmap_t *map = (jutil_cmap_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_cmap_t));
+  if(map == NULL)
+  {
+    return NULL;
+  }
+
+  jutil_cmap_table_t *table = jutil_cmap_table_create(JUTIL_CMAP_CAPACITY_MIN);
+  if(table == NULL)
+  {
+    JUTIL_ALLOC_FREE(map);
+    return NULL;
+  }
+
+  if(pthread_mutex_init(&map->mutex, NULL) != 0)
+  {
+    jutil_cmap_table_free(table);
+    JUTIL_ALLOC_FREE(map);
+    return NULL;
+  }
+
+  atomic_init(&map->table, table);
+  atomic_init(&map->size, 0);
+  map->seed = jutil_hash_getRandomSeed();
+
+  return map;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_free(jutil_cmap_t *map)
+{
+  if(map == NULL)
+  {
+    return;
+  }
+
+  jutil_cmap_table_free(atomic_load(&map->table));
+  pthread_mutex_destroy(&map->mutex);
+  JUTIL_ALLOC_FREE(map);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cmap_readBegin()
+{
+  jutil_cmap_reader_t *reader = jutil_cmap_getReader();
+  if(reader == NULL)
+  {
+    return false;
+  }
+
+  if(reader->nesting++ == 0)
+  {
+    atomic_store_explicit(&reader->epoch, atomic_load_explicit(&jutil_cmap_epoch, memory_order_relaxed), memory_order_relaxed);
+
+    /* Writers have to see the epoch, before the table is read. */
+    atomic_thread_fence(memory_order_seq_cst);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_readEnd()
+{
+  jutil_cmap_reader_t *reader = jutil_cmap_reader;
+  if(reader == NULL || reader->nesting == 0)
+  {
+    return;
+  }
+
+  if(--reader->nesting == 0)
+  {
+    atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cmap_add(jutil_cmap_t *map, const char *index, void *data)
+{
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  size_t size = jutil_cmap_checkIndex(index);
+  if(size == 0)
+  {
+    return false;
+  }
+
+  uint32_t hash = jutil_cmap_hash(map, index, size);
+  int ret = false;
+
+  pthread_mutex_lock(&map->mutex);
+  if(jutil_cmap_find(map, index, size, hash, NULL) == NULL)
+  {
+    ret = jutil_cmap_insert(map, index, size, hash, data);
+  }
+  pthread_mutex_unlock(&map->mutex);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_cmap_remove(jutil_cmap_t *map, const char *index)
+{
+  if(map == NULL)
+  {
+    return NULL;
+  }
+
+  size_t size = jutil_cmap_checkIndex(index);
+  if(size == 0)
+  {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&map->mutex);
+
+  _Atomic(jutil_cmap_node_t *) *link;
+  jutil_cmap_node_t *node = jutil_cmap_find(map, index, size, jutil_cmap_hash(map, index, size), &link);
+  if(node == NULL)
+  {
+    pthread_mutex_unlock(&map->mutex);
+    return NULL;
+  }
+
+  /* Readers at node still find the rest of the bucket. */
+  atomic_store_explicit(link, atomic_load_explicit(&node->next, memory_order_relaxed), memory_order_release);
+  atomic_fetch_sub(&map->size, 1);
+
+  jutil_cmap_synchronize();
+  pthread_mutex_unlock(&map->mutex);
+
+  void *data = node->pair.data;
+  JUTIL_ALLOC_FREE(node);
+
+  return data;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cmap_contains(jutil_cmap_t *map, const char *index)
+{
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  size_t size = jutil_cmap_checkIndex(index);
+  if(size == 0)
+  {
+    return false;
+  }
+
+  uint32_t hash = jutil_cmap_hash(map, index, size);
+
+  if(jutil_cmap_readBegin() == false)
+  {
+    return false;
+  }
+
+  int ret = (jutil_cmap_find(map, index, size, hash, NULL) != NULL);
+  jutil_cmap_readEnd();
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_cmap_get(jutil_cmap_t *map, const char *index)
+{
+  if(map == NULL)
+  {
+    return NULL;
+  }
+
+  size_t size = jutil_cmap_checkIndex(index);
+  if(size == 0)
+  {
+    return NULL;
+  }
+
+  uint32_t hash = jutil_cmap_hash(map, index, size);
+
+  if(jutil_cmap_readBegin() == false)
+  {
+    return NULL;
+  }
+
+  void *data = NULL;
+  jutil_cmap_node_t *node = jutil_cmap_find(map, index, size, hash, NULL);
+  if(node)
+  {
+    data = node->pair.data;
+  }
+  jutil_cmap_readEnd();
+
+  return data;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cmap_set(jutil_cmap_t *map, const char *index, void *data, void **old_data)
+{
+  if(old_data)
+  {
+    *old_data = NULL;
+  }
+
+  if(map == NULL)
+  {
+    return false;
+  }
+
+  size_t size = jutil_cmap_checkIndex(index);
+  if(size == 0)
+  {
+    return false;
+  }
+
+  uint32_t hash = jutil_cmap_hash(map, index, size);
+
+  pthread_mutex_lock(&map->mutex);
+
+  _Atomic(jutil_cmap_node_t *) *link;
+  jutil_cmap_node_t *node = jutil_cmap_find(map, index, size, hash, &link);
+  if(node == NULL)
+  {
+    int ret = jutil_cmap_insert(map, index, size, hash, data);
+    pthread_mutex_unlock(&map->mutex);
+    return ret;
+  }
+
+  jutil_cmap_node_t *replace = jutil_cmap_node_create(node->table, index, size, hash, data);
+  if(replace == NULL)
+  {
+    pthread_mutex_unlock(&map->mutex);
+    return false;
+  }
+
+  atomic_init(&replace->next, atomic_load_explicit(&node->next, memory_order_relaxed));
+  atomic_store_explicit(link, replace, memory_order_release);
+
+  jutil_cmap_synchronize();
+  pthread_mutex_unlock(&map->mutex);
+
+  if(old_data)
+  {
+    *old_data = node->pair.data;
+  }
+  JUTIL_ALLOC_FREE(node);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_cmap_size(jutil_cmap_t *map)
+{
+  if(map == NULL)
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&map->size, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_clear(jutil_cmap_t *map)
+{
+  if(map == NULL)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&map->mutex);
+
+  jutil_cmap_table_t *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+  jutil_cmap_table_t *empty = jutil_cmap_table_create(JUTIL_CMAP_CAPACITY_MIN);
+
+  if(empty)
+  {
+    atomic_store_explicit(&map->table, empty, memory_order_release);
+    atomic_store(&map->size, 0);
+    jutil_cmap_synchronize();
+    jutil_cmap_table_free(table);
+  }
+  else
+  {
+    /* Keep table, but unlink bucket by bucket. */
+    for(size_t i = 0; i < table->capacity; i++)
+    {
+      jutil_cmap_node_t *node = atomic_exchange(&table->buckets[i], NULL);
+      if(node == NULL)
+      {
+        continue;
+      }
+
+      jutil_cmap_synchronize();
+      while(node)
+      {
+        jutil_cmap_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        JUTIL_ALLOC_FREE(node);
+        node = next;
+      }
+    }
+    atomic_store(&map->size, 0);
+  }
+
+  pthread_mutex_unlock(&map->mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+const jutil_map_data_t *jutil_cmap_iterate(jutil_cmap_t *map, const jutil_map_data_t *itr)
+{
+  if(map == NULL)
+  {
+    return NULL;
+  }
+
+  jutil_cmap_table_t *table;
+  size_t bucket;
+
+  if(itr == NULL)
+  {
+    table = atomic_load_explicit(&map->table, memory_order_acquire);
+    bucket = 0;
+  }
+  else
+  {
+    jutil_cmap_node_t *node = (jutil_cmap_node_t *)itr;
+    jutil_cmap_node_t *next = atomic_load_explicit(&node->next, memory_order_acquire);
+    if(next)
+    {
+      return &next->pair;
+    }
+
+    table = node->table;
+    bucket = (node->hash & (table->capacity - 1)) + 1;
+  }
+
+  for(; bucket < table->capacity; bucket++)
+  {
+    jutil_cmap_node_t *node = atomic_load_explicit(&table->buckets[bucket], memory_order_acquire);
+    if(node)
+    {
+      return &node->pair;
+    }
+  }
+
+  return NULL;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_cmap_checkIndex(const char *index)
+{
+  if(index == NULL)
+  {
+    return 0;
+  }
+
+  size_t size = strlen(index);
+  if(size >= UINT32_MAX)
+  {
+    return 0;
+  }
+
+  return size;
+}
+
+//------------------------------------------------------------------------------
+//
+uint32_t jutil_cmap_hash(jutil_cmap_t *map, const char *index, size_t size)
+{
+  uint64_t hash = jutil_hash64(index, size, map->seed);
+  return (uint32_t)(hash ^ (hash >> 32));
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_cmap_node_t *jutil_cmap_find(jutil_cmap_t *map, const char *index, size_t size, uint32_t hash, _Atomic(jutil_cmap_node_t *) **link)
+{
+  jutil_cmap_table_t *table = atomic_load_explicit(&map->table, memory_order_acquire);
+  _Atomic(jutil_cmap_node_t *) *current = &table->buckets[hash & (table->capacity - 1)];
+
+  jutil_cmap_node_t *node;
+  while( (node = atomic_load_explicit(current, memory_order_acquire)) != NULL )
+  {
+    if(node->hash == hash && node->length == size && memcmp(node->key, index, size) == 0)
+    {
+      if(link)
+      {
+        *link = current;
+      }
+      return node;
+    }
+
+    current = &node->next;
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_cmap_node_t *jutil_cmap_node_create(jutil_cmap_table_t *table, const char *index, size_t size, uint32_t hash, void *data)
+{
+  jutil_cmap_node_t *node = (jutil_cmap_node_t *)JUTIL_ALLOC_MALLOC(offsetof(jutil_cmap_node_t, key) + size + 1);
+  if(node == NULL)
+  {
+    return NULL;
+  }
+
+  memcpy(node->key, index, size + 1);
+  node->pair.index = node->key;
+  node->pair.data = data;
+  node->hash = hash;
+  node->length = (uint32_t)size;
+  node->table = table;
+  atomic_init(&node->next, NULL);
+
+  return node;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cmap_insert(jutil_cmap_t *map, const char *index, size_t size, uint32_t hash, void *data)
+{
+  jutil_cmap_table_t *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+
+  /* Table stays usable with longer buckets, if growing fails. */
+  if(atomic_load_explicit(&map->size, memory_order_relaxed) >= table->capacity)
+  {
+    if(jutil_cmap_grow(map))
+    {
+      table = atomic_load_explicit(&map->table, memory_order_relaxed);
+    }
+  }
+
+  jutil_cmap_node_t *node = jutil_cmap_node_create(table, index, size, hash, data);
+  if(node == NULL)
+  {
+    return false;
+  }
+
+  _Atomic(jutil_cmap_node_t *) *bucket = &table->buckets[hash & (table->capacity - 1)];
+  atomic_init(&node->next, atomic_load_explicit(bucket, memory_order_relaxed));
+
+  /* Node is complete, before readers can reach it. */
+  atomic_store_explicit(bucket, node, memory_order_release);
+  atomic_fetch_add(&map->size, 1);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_cmap_grow(jutil_cmap_t *map)
+{
+  jutil_cmap_table_t *table = atomic_load_explicit(&map->table, memory_order_relaxed);
+  jutil_cmap_table_t *grown = jutil_cmap_table_create(table->capacity * 2);
+  if(grown == NULL)
+  {
+    return false;
+  }
+
+  /* Nodes are copied, because readers may still walk old buckets. */
+  for(size_t i = 0; i < table->capacity; i++)
+  {
+    jutil_cmap_node_t *node = atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+    while(node)
+    {
+      jutil_cmap_node_t *copy = jutil_cmap_node_create(grown, node->key, node->length, node->hash, node->pair.data);
+      if(copy == NULL)
+      {
+        jutil_cmap_table_free(grown);
+        return false;
+      }
+
+      _Atomic(jutil_cmap_node_t *) *bucket = &grown->buckets[node->hash & (grown->capacity - 1)];
+      atomic_init(&copy->next, atomic_load_explicit(bucket, memory_order_relaxed));
+      atomic_init(bucket, copy);
+
+      node = atomic_load_explicit(&node->next, memory_order_relaxed);
+    }
+  }
+
+  atomic_store_explicit(&map->table, grown, memory_order_release);
+
+  jutil_cmap_synchronize();
+  jutil_cmap_table_free(table);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_cmap_table_t *jutil_cmap_table_create(size_t capacity)
+{
+  jutil_cmap_table_t *table = (jutil_cmap_table_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_cmap_table_t) + capacity * sizeof(_Atomic(jutil_cmap_node_t *)));
+  if(table == NULL)
+  {
+    return NULL;
+  }
+
+  table->capacity = capacity;
+  for(size_t i = 0; i < capacity; i++)
+  {
+    atomic_init(&table->buckets[i], NULL);
+  }
+
+  return table;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_table_free(jutil_cmap_table_t *table)
+{
+  for(size_t i = 0; i < table->capacity; i++)
+  {
+    jutil_cmap_node_t *node = atomic_load_explicit(&table->buckets[i], memory_order_relaxed);
+    while(node)
+    {
+      jutil_cmap_node_t *next = atomic_load_explicit(&node->next, memory_order_relaxed);
+      JUTIL_ALLOC_FREE(node);
+      node = next;
+    }
+  }
+
+  JUTIL_ALLOC_FREE(table);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_synchronize()
+{
+  /* Readers, that see the new epoch, also see unlinked memory as unlinked. */
+  atomic_thread_fence(memory_order_seq_cst);
+  uint_fast64_t epoch = atomic_fetch_add(&jutil_cmap_epoch, 1) + 1;
+
+  jutil_cmap_reader_t *reader = atomic_load_explicit(&jutil_cmap_readers, memory_order_acquire);
+  for(; reader != NULL; reader = reader->next)
+  {
+    /* Section of calling thread would never end. */
+    if(reader == jutil_cmap_reader)
+    {
+      continue;
+    }
+
+    uint_fast64_t reader_epoch;
+    while( (reader_epoch = atomic_load_explicit(&reader->epoch, memory_order_acquire)) != 0 && reader_epoch < epoch )
+    {
+      sched_yield();
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_cmap_reader_t *jutil_cmap_getReader()
+{
+  if(jutil_cmap_reader)
+  {
+    return jutil_cmap_reader;
+  }
+
+  pthread_once(&jutil_cmap_once, jutil_cmap_keyInit);
+
+  jutil_cmap_reader_t *reader = atomic_load_explicit(&jutil_cmap_readers, memory_order_acquire);
+  for(; reader != NULL; reader = reader->next)
+  {
+    int unused = false;
+    if(atomic_compare_exchange_strong(&reader->used, &unused, true))
+    {
+      break;
+    }
+  }
+
+  if(reader == NULL)
+  {
+    reader = (jutil_cmap_reader_t *)JUTIL_ALLOC_MALLOC_ALIGNED(JUTIL_CMAP_SIZE_CACHELINE, sizeof(jutil_cmap_reader_t));
+    if(reader == NULL)
+    {
+      return NULL;
+    }
+
+    atomic_init(&reader->epoch, 0);
+    atomic_init(&reader->used, true);
+    reader->next = atomic_load_explicit(&jutil_cmap_readers, memory_order_relaxed);
+    while(!atomic_compare_exchange_weak_explicit(&jutil_cmap_readers, &reader->next, reader, memory_order_release, memory_order_relaxed));
+  }
+
+  reader->nesting = 0;
+
+  if(jutil_cmap_keyCreated)
+  {
+    pthread_setspecific(jutil_cmap_key, reader);
+  }
+
+  jutil_cmap_reader = reader;
+  return reader;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_keyInit()
+{
+  if(pthread_key_create(&jutil_cmap_key, jutil_cmap_keyDestructor) == 0)
+  {
+    jutil_cmap_keyCreated = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_cmap_keyDestructor(void *ptr)
+{
+  jutil_cmap_reader_t *reader = (jutil_cmap_reader_t *)ptr;
+
+  reader->nesting = 0;
+  atomic_store_explicit(&reader->epoch, 0, memory_order_release);
+  atomic_store_explicit(&reader->used, false, memory_order_release);
+}
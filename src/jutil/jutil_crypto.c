@@ -9,117 +9,766 @@
  * 
  */
 
+#define _POSIX_C_SOURCE 200809L /* needed for mmap() and posix_madvise() */
+
 #include <jayc/jutil_crypto.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
-#include <openssl/md5.h>
-#include <openssl/sha.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <openssl/evp.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_crypto");
+
+
+
+//==============================================================================
+// Define constants and structures.
+//
+
+/**
+ * @brief Size of file window mapped at once.
+ */
+#define JUTIL_CRYPTO_SIZE_MAP (64UL * 1024UL * 1024UL)
+
+/**
+ * @brief Size of read buffer for descriptors, that can not be mapped.
+ */
+#define JUTIL_CRYPTO_SIZE_READ (1024UL * 1024UL)
+
+/**
+ * @brief Alignment of read buffer.
+ */
+#define JUTIL_CRYPTO_ALIGN_READ 4096
+
+/**
+ * @brief Number of hash types.
+ */
+#define JUTIL_CRYPTO_HASH_COUNT 3
+
+/**
+ * @brief Batches with less messages are hashed by calling thread.
+ */
+#define JUTIL_CRYPTO_BATCH_PARALLEL 1024
+
+/**
+ * @brief Minimum number of messages per part of parallel batch.
+ */
+#define JUTIL_CRYPTO_BATCH_PART 256
+
+/**
+ * @brief Part of batch, hashed by one thread.
+ */
+typedef struct __jutil_crypto_batch
+{
+  int type;                             /**< Hash type. */
+  const void *const *inputs;            /**< Messages of whole batch. */
+  const size_t *sizes;                  /**< Sizes of messages. */
+  unsigned char *const *outputs;        /**< Output buffers of messages. */
+  size_t begin;                         /**< First message of part. */
+  size_t end;                           /**< Message after last of part. */
+} jutil_crypto_batch_t;
+
+/**
+ * @brief Streaming hash context.
+ */
+struct __jutil_crypto_hash
+{
+  EVP_MD_CTX *ctx;    /**< OpenSSL digest context. */
+  const EVP_MD *md;   /**< Digest algorithm. */
+};
+
+/**
+ * @brief Hex digits of every byte value, two characters per byte.
+ */
+static const char jutil_crypto_hex_table[513] =
+  "000102030405060708090a0b0c0d0e0f"
+  "101112131415161718191a1b1c1d1e1f"
+  "202122232425262728292a2b2c2d2e2f"
+  "303132333435363738393a3b3c3d3e3f"
+  "404142434445464748494a4b4c4d4e4f"
+  "505152535455565758595a5b5c5d5e5f"
+  "606162636465666768696a6b6c6d6e6f"
+  "707172737475767778797a7b7c7d7e7f"
+  "808182838485868788898a8b8c8d8e8f"
+  "909192939495969798999a9b9c9d9e9f"
+  "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+  "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+  "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+  "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+  "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+  "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+/**
+ * @brief Base64 alphabet (RFC 4648).
+ */
+static const char jutil_crypto_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ * @brief Value of base64 characters, @c 255 for invalid characters.
+ */
+static const unsigned char jutil_crypto_base64_values[256] =
+{
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,  62, 255, 255, 255,  63,
+   52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255, 255,
+  255,   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,
+   15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25, 255, 255, 255, 255, 255,
+  255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,
+   41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  51, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+  255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+};
+
+static pthread_once_t jutil_crypto_once = PTHREAD_ONCE_INIT;    /**< Fetches digests once. */
+static const EVP_MD *jutil_crypto_md[JUTIL_CRYPTO_HASH_COUNT];  /**< Digest per hash type. */
+static pthread_key_t jutil_crypto_ctx_key;                      /**< Frees thread contexts at thread exit. */
+static int jutil_crypto_ctx_key_valid = false;                  /**< @c true , if key was created. */
+static _Thread_local EVP_MD_CTX *jutil_crypto_ctx = NULL;       /**< Context of calling thread for one-shot hashes. */
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Fetches digests from OpenSSL providers.
+ * 
+ * Fetching on every hash would look up the provider
+ * each time, so digests are fetched once.
+ */
+static void jutil_crypto_fetch(void);
+
+/**
+ * @brief Frees context of exiting thread.
+ * 
+ * @param ctx OpenSSL digest context.
+ */
+static void jutil_crypto_freeContext(void *ctx);
+
+/**
+ * @brief Hashes buffer in one call with context of calling thread.
+ * 
+ * @param type    Hash type.
+ * @param input   Input data.
+ * @param size    Size of input.
+ * @param output  Buffer for hash.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jutil_crypto_digest(int type, const void *input, size_t size, unsigned char *output);
+
+/**
+ * @brief Returns OpenSSL digest of hash type.
+ * 
+ * @param type  Hash type.
+ * 
+ * @return      Digest algorithm.
+ * @return      @c NULL , if type is unknown.
+ */
+static const EVP_MD *jutil_crypto_getMD(int type);
+
+/**
+ * @brief Adds regular file to hash through memory maps.
+ * 
+ * @param session         Hash context.
+ * @param file_descriptor File to hash.
+ * @param size            Size of file.
+ * 
+ * @return                @c true , if successful.
+ * @return                @c false , if error occured.
+ */
+static int jutil_crypto_hash_updateMapped(jutil_crypto_hash_t *session, int file_descriptor, off_t size);
+
+/**
+ * @brief Adds data read from descriptor until end of file.
+ * 
+ * @param session         Hash context.
+ * @param file_descriptor Descriptor to read.
+ * 
+ * @return                @c true , if successful.
+ * @return                @c false , if error occured.
+ */
+static int jutil_crypto_hash_updateRead(jutil_crypto_hash_t *session, int file_descriptor);
+
+/**
+ * @brief Hashes messages of batch part.
+ * 
+ * Used as task of thread pool.
+ * 
+ * @param ctx Batch part ( @c jutil_crypto_batch_t ).
+ * 
+ * @return    @c ctx , if all messages were hashed.
+ * @return    @c NULL , if error occured.
+ */
+static void *jutil_crypto_batch_run(void *ctx);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
 
 //------------------------------------------------------------------------------
 //
 int jutil_crypto_md5_raw(const char *input, size_t size_input, unsigned char *output)
 {
-  MD5_CTX ctx;
+  return jutil_crypto_digest(JUTIL_CRYPTO_HASH_MD5, input, size_input, output);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_md5_str(const char *input, size_t size_input, char *output)
+{
+  unsigned char hash_buf[16];
+  if(jutil_crypto_md5_raw(input, size_input, hash_buf) == false)
+  {
+    return false;
+  }
+
+  jutil_crypto_toHex(hash_buf, sizeof(hash_buf), output);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_sha256_raw(const char *input, size_t size_input, unsigned char *output)
+{
+  return jutil_crypto_digest(JUTIL_CRYPTO_HASH_SHA256, input, size_input, output);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_sha256_str(const char *input, size_t size_input, char *output)
+{
+  unsigned char hash_buf[32];
+  if(jutil_crypto_sha256_raw(input, size_input, hash_buf) == false)
+  {
+    return false;
+  }
+
+  jutil_crypto_toHex(hash_buf, sizeof(hash_buf), output);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_sha512_raw(const char *input, size_t size_input, unsigned char *output)
+{
+  return jutil_crypto_digest(JUTIL_CRYPTO_HASH_SHA512, input, size_input, output);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_sha512_str(const char *input, size_t size_input, char *output)
+{
+  unsigned char hash_buf[64];
+  if(jutil_crypto_sha512_raw(input, size_input, hash_buf) == false)
+  {
+    return false;
+  }
+
+  jutil_crypto_toHex(hash_buf, sizeof(hash_buf), output);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_crypto_hash_getSize(int type)
+{
+  const EVP_MD *md = jutil_crypto_getMD(type);
+  if(md == NULL)
+  {
+    return 0;
+  }
+
+  return (size_t)EVP_MD_size(md);
+}
 
-  MD5_Init(&ctx);
+//------------------------------------------------------------------------------
+//
+jutil_crypto_hash_t *jutil_crypto_hash_init(int type)
+{
+  const EVP_MD *md = jutil_crypto_getMD(type);
+  if(md == NULL)
+  {
+    return NULL;
+  }
+
+  jutil_crypto_hash_t *session = (jutil_crypto_hash_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_crypto_hash_t));
+  if(session == NULL)
+  {
+    return NULL;
+  }
+
+  session->md = md;
+  session->ctx = EVP_MD_CTX_new();
+  if(session->ctx == NULL)
+  {
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
 
-  /*
-   * Solution, to fix string sizes over 512 Bytes.
-   * Found here: https://stackoverflow.com/questions/7627723/how-to-create-a-md5-hash-of-a-string-in-c
-   */
-  while(size_input > 0)
+  if(EVP_DigestInit_ex(session->ctx, session->md, NULL) != 1)
   {
-    if(size_input > 512)
+    EVP_MD_CTX_free(session->ctx);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_hash_update(jutil_crypto_hash_t *session, const void *data, size_t size)
+{
+  if(session == NULL || (data == NULL && size > 0))
+  {
+    return false;
+  }
+
+  return (EVP_DigestUpdate(session->ctx, data, size) == 1);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_crypto_hash_final(jutil_crypto_hash_t *session, unsigned char *output)
+{
+  if(session == NULL || output == NULL)
+  {
+    return 0;
+  }
+
+  unsigned int size = 0;
+  if(EVP_DigestFinal_ex(session->ctx, output, &size) != 1)
+  {
+    return 0;
+  }
+
+  /* Context is ready for next hash. */
+  if(EVP_DigestInit_ex(session->ctx, session->md, NULL) != 1)
+  {
+    return 0;
+  }
+
+  return (size_t)size;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_crypto_hash_free(jutil_crypto_hash_t *session)
+{
+  if(session)
+  {
+    EVP_MD_CTX_free(session->ctx);
+    JUTIL_ALLOC_FREE(session);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_crypto_hashFile(int type, int file_descriptor, unsigned char *output)
+{
+  if(file_descriptor < 0 || output == NULL)
+  {
+    return 0;
+  }
+
+  jutil_crypto_hash_t *session = jutil_crypto_hash_init(type);
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  struct stat file_info;
+  int ret;
+  if(fstat(file_descriptor, &file_info) == 0 && S_ISREG(file_info.st_mode))
+  {
+    ret = jutil_crypto_hash_updateMapped(session, file_descriptor, file_info.st_size);
+  }
+  else
+  {
+    ret = jutil_crypto_hash_updateRead(session, file_descriptor);
+  }
+
+  size_t size = (ret ? jutil_crypto_hash_final(session, output) : 0);
+  jutil_crypto_hash_free(session);
+
+  return size;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_hashBatch(int type, const void *const inputs[], const size_t sizes[], unsigned char *const outputs[], size_t count, jutil_threadpool_t *pool)
+{
+  if(inputs == NULL || sizes == NULL || outputs == NULL || jutil_crypto_getMD(type) == NULL)
+  {
+    return false;
+  }
+
+  jutil_crypto_batch_t whole = { type, inputs, sizes, outputs, 0, count };
+  size_t workers = (pool ? jutil_threadpool_getWorkers(pool) : 0);
+  if(workers == 0 || count < JUTIL_CRYPTO_BATCH_PARALLEL)
+  {
+    return (jutil_crypto_batch_run(&whole) != NULL);
+  }
+
+  /* Calling thread hashes the last part, while workers hash the others. */
+  size_t parts = workers + 1;
+  if(parts > count / JUTIL_CRYPTO_BATCH_PART)
+  {
+    parts = count / JUTIL_CRYPTO_BATCH_PART;
+  }
+
+  jutil_crypto_batch_t *batches = (jutil_crypto_batch_t *)JUTIL_ALLOC_MALLOC(parts * sizeof(jutil_crypto_batch_t));
+  jutil_threadpool_future_t **futures = (jutil_threadpool_future_t **)JUTIL_ALLOC_CALLOC(parts, sizeof(jutil_threadpool_future_t *));
+  if(batches == NULL || futures == NULL)
+  {
+    JUTIL_ALLOC_FREE(batches);
+    JUTIL_ALLOC_FREE(futures);
+    return (jutil_crypto_batch_run(&whole) != NULL);
+  }
+
+  for(size_t i = 0; i < parts; i++)
+  {
+    batches[i] = whole;
+    batches[i].begin = count * i / parts;
+    batches[i].end = count * (i + 1) / parts;
+  }
+
+  for(size_t i = 0; i + 1 < parts; i++)
+  {
+    futures[i] = jutil_threadpool_submitFuture(pool, &jutil_crypto_batch_run, &batches[i]);
+  }
+
+  int ret = true;
+  for(size_t i = parts; i > 0; i--)
+  {
+    /* Parts, that could not be submitted, are hashed here. */
+    void *result = (futures[i - 1] ? jutil_threadpool_future_wait(futures[i - 1]) : jutil_crypto_batch_run(&batches[i - 1]));
+    if(result == NULL)
     {
-      MD5_Update(&ctx, input, 512);
+      ret = false;
     }
-    else
+    jutil_threadpool_future_free(futures[i - 1]);
+  }
+
+  JUTIL_ALLOC_FREE(futures);
+  JUTIL_ALLOC_FREE(batches);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_sha256_batch(const void *const inputs[], const size_t sizes[], unsigned char *const outputs[], size_t count, jutil_threadpool_t *pool)
+{
+  return jutil_crypto_hashBatch(JUTIL_CRYPTO_HASH_SHA256, inputs, sizes, outputs, count, pool);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_crypto_toHex(const void *data, size_t size, char *output)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+
+  /* One lookup and one 2 byte copy per input byte. */
+  for(size_t i = 0; i < size; i++)
+  {
+    memcpy(output + i * 2, jutil_crypto_hex_table + bytes[i] * 2, 2);
+  }
+  output[size * 2] = 0;
+
+  return size * 2;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_crypto_base64_encode(const void *data, size_t size, char *output)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  size_t length = 0;
+  size_t i = 0;
+
+  for(; i + 3 <= size; i += 3)
+  {
+    uint32_t block = ((uint32_t)bytes[i] << 16) | ((uint32_t)bytes[i + 1] << 8) | (uint32_t)bytes[i + 2];
+
+    output[length++] = jutil_crypto_base64_table[(block >> 18) & 0x3f];
+    output[length++] = jutil_crypto_base64_table[(block >> 12) & 0x3f];
+    output[length++] = jutil_crypto_base64_table[(block >> 6) & 0x3f];
+    output[length++] = jutil_crypto_base64_table[block & 0x3f];
+  }
+
+  if(i < size)
+  {
+    uint32_t block = (uint32_t)bytes[i] << 16;
+    if(i + 1 < size)
     {
-      MD5_Update(&ctx, input, size_input);
-      break;
+      block |= (uint32_t)bytes[i + 1] << 8;
     }
 
-    size_input -= 512;
-    input += 512;
+    output[length++] = jutil_crypto_base64_table[(block >> 18) & 0x3f];
+    output[length++] = jutil_crypto_base64_table[(block >> 12) & 0x3f];
+    output[length++] = (i + 1 < size ? jutil_crypto_base64_table[(block >> 6) & 0x3f] : '=');
+    output[length++] = '=';
   }
 
-  MD5_Final(output, &ctx);
-
-  return true;
+  output[length] = 0;
+  return length;
 }
 
 //------------------------------------------------------------------------------
 //
-int jutil_crypto_md5_str(const char *input, size_t size_input, char *output)
+int jutil_crypto_base64_decode(const char *input, size_t length, unsigned char *output, size_t *size_output)
 {
-  unsigned char hash_buf[16];
-  if(jutil_crypto_md5_raw(input, size_input, hash_buf) == false)
+  if(input == NULL || output == NULL || (length % 4) != 0)
   {
     return false;
   }
 
-  int ctr;
-  for(ctr = 0; ctr < 16; ctr++)
+  size_t size = 0;
+  for(size_t i = 0; i < length; i += 4)
   {
-    snprintf(&(output[ctr*2]), 32, "%02x", (unsigned int)hash_buf[ctr]);
+    const unsigned char *chars = (const unsigned char *)input + i;
+    size_t padding = 0;
+
+    /* Padding is only allowed at the end of the last block. */
+    if(i + 4 == length)
+    {
+      if(chars[3] == '=')
+      {
+        padding = (chars[2] == '=' ? 2 : 1);
+      }
+    }
+
+    unsigned char v0 = jutil_crypto_base64_values[chars[0]];
+    unsigned char v1 = jutil_crypto_base64_values[chars[1]];
+    unsigned char v2 = (padding >= 2 ? 0 : jutil_crypto_base64_values[chars[2]]);
+    unsigned char v3 = (padding >= 1 ? 0 : jutil_crypto_base64_values[chars[3]]);
+
+    /* Invalid characters have the highest bit set. */
+    if(((v0 | v1 | v2 | v3) & 0x80) != 0)
+    {
+      return false;
+    }
+
+    uint32_t block = ((uint32_t)v0 << 18) | ((uint32_t)v1 << 12) | ((uint32_t)v2 << 6) | (uint32_t)v3;
+
+    output[size++] = (unsigned char)(block >> 16);
+    if(padding < 2)
+    {
+      output[size++] = (unsigned char)(block >> 8);
+    }
+    if(padding < 1)
+    {
+      output[size++] = (unsigned char)block;
+    }
   }
-  output[32] = 0;
 
+  if(size_output)
+  {
+    *size_output = size;
+  }
   return true;
 }
 
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
 //------------------------------------------------------------------------------
 //
-int jutil_crypto_sha256_raw(const char *input, size_t size_input, unsigned char *output)
+void jutil_crypto_fetch(void)
 {
-  SHA256((unsigned char *)input, size_input, output);
-  return true;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+  jutil_crypto_md[JUTIL_CRYPTO_HASH_MD5] = EVP_MD_fetch(NULL, "MD5", NULL);
+  jutil_crypto_md[JUTIL_CRYPTO_HASH_SHA256] = EVP_MD_fetch(NULL, "SHA256", NULL);
+  jutil_crypto_md[JUTIL_CRYPTO_HASH_SHA512] = EVP_MD_fetch(NULL, "SHA512", NULL);
+#endif
+
+  /* Implicit digests, if fetching is not available or failed. */
+  if(jutil_crypto_md[JUTIL_CRYPTO_HASH_MD5] == NULL)
+  {
+    jutil_crypto_md[JUTIL_CRYPTO_HASH_MD5] = EVP_md5();
+  }
+  if(jutil_crypto_md[JUTIL_CRYPTO_HASH_SHA256] == NULL)
+  {
+    jutil_crypto_md[JUTIL_CRYPTO_HASH_SHA256] = EVP_sha256();
+  }
+  if(jutil_crypto_md[JUTIL_CRYPTO_HASH_SHA512] == NULL)
+  {
+    jutil_crypto_md[JUTIL_CRYPTO_HASH_SHA512] = EVP_sha512();
+  }
+
+  jutil_crypto_ctx_key_valid = (pthread_key_create(&jutil_crypto_ctx_key, &jutil_crypto_freeContext) == 0);
 }
 
 //------------------------------------------------------------------------------
 //
-int jutil_crypto_sha256_str(const char *input, size_t size_input, char *output)
+void jutil_crypto_freeContext(void *ctx)
 {
-  unsigned char hash_buf[32];
-  if(jutil_crypto_sha256_raw(input, size_input, hash_buf) == false)
+  EVP_MD_CTX_free((EVP_MD_CTX *)ctx);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_digest(int type, const void *input, size_t size, unsigned char *output)
+{
+  if((input == NULL && size > 0) || output == NULL)
+  {
+    return false;
+  }
+
+  const EVP_MD *md = jutil_crypto_getMD(type);
+  if(md == NULL)
   {
     return false;
   }
 
-  int ctr;
-  for(ctr = 0; ctr < 32; ctr++)
+  if(jutil_crypto_ctx == NULL)
   {
-    snprintf(&(output[ctr*2]), 64, "%02x", (unsigned int)hash_buf[ctr]);
+    jutil_crypto_ctx = EVP_MD_CTX_new();
+    if(jutil_crypto_ctx == NULL)
+    {
+      return false;
+    }
+
+    /* Key only frees context at thread exit. */
+    if(jutil_crypto_ctx_key_valid)
+    {
+      pthread_setspecific(jutil_crypto_ctx_key, jutil_crypto_ctx);
+    }
+  }
+
+  /* Whole buffer in one update, so OpenSSL can process many blocks at once. */
+  if(EVP_DigestInit_ex(jutil_crypto_ctx, md, NULL) != 1
+    || EVP_DigestUpdate(jutil_crypto_ctx, input, size) != 1
+    || EVP_DigestFinal_ex(jutil_crypto_ctx, output, NULL) != 1)
+  {
+    return false;
   }
-  output[64] = 0;
 
   return true;
 }
 
 //------------------------------------------------------------------------------
 //
-int jutil_crypto_sha512_raw(const char *input, size_t size_input, unsigned char *output)
+const EVP_MD *jutil_crypto_getMD(int type)
 {
-  SHA512((unsigned char *)input, size_input, output);
+  if(type < 0 || type >= JUTIL_CRYPTO_HASH_COUNT)
+  {
+    return NULL;
+  }
+
+  pthread_once(&jutil_crypto_once, &jutil_crypto_fetch);
+  return jutil_crypto_md[type];
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_crypto_hash_updateMapped(jutil_crypto_hash_t *session, int file_descriptor, off_t size)
+{
+  off_t offset = 0;
+
+  /* Mapped in windows, so huge files do not need as much address space. */
+  while(offset < size)
+  {
+    size_t length = (size - offset > (off_t)JUTIL_CRYPTO_SIZE_MAP ? JUTIL_CRYPTO_SIZE_MAP : (size_t)(size - offset));
+
+    void *map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file_descriptor, offset);
+    if(map == MAP_FAILED)
+    {
+      return false;
+    }
+    posix_madvise(map, length, POSIX_MADV_SEQUENTIAL);
+
+    int ret = jutil_crypto_hash_update(session, map, length);
+    munmap(map, length);
+    if(ret == false)
+    {
+      return false;
+    }
+
+    offset += (off_t)length;
+  }
+
   return true;
 }
 
 //------------------------------------------------------------------------------
 //
-int jutil_crypto_sha512_str(const char *input, size_t size_input, char *output)
+int jutil_crypto_hash_updateRead(jutil_crypto_hash_t *session, int file_descriptor)
 {
-  unsigned char hash_buf[64];
-  if(jutil_crypto_sha512_raw(input, size_input, hash_buf) == false)
+  void *buffer = JUTIL_ALLOC_MALLOC_ALIGNED(JUTIL_CRYPTO_ALIGN_READ, JUTIL_CRYPTO_SIZE_READ);
+  if(buffer == NULL)
   {
     return false;
   }
 
-  int ctr;
-  for(ctr = 0; ctr < 64; ctr++)
+  int ret = true;
+  while(ret)
   {
-    snprintf(&(output[ctr*2]), 128, "%02x", (unsigned int)hash_buf[ctr]);
+    ssize_t ret_read = read(file_descriptor, buffer, JUTIL_CRYPTO_SIZE_READ);
+    if(ret_read < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      ret = false;
+      break;
+    }
+
+    if(ret_read == 0)
+    {
+      break;
+    }
+
+    ret = jutil_crypto_hash_update(session, buffer, (size_t)ret_read);
   }
-  output[128] = 0;
 
-  return true;
-}
\ No newline at end of file
+  JUTIL_ALLOC_FREE_ALIGNED(buffer);
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_crypto_batch_run(void *ctx)
+{
+  jutil_crypto_batch_t *batch = (jutil_crypto_batch_t *)ctx;
+  void *ret = ctx;
+
+  /* Every message reuses context and digest of this thread. */
+  for(size_t i = batch->begin; i < batch->end; i++)
+  {
+    if(jutil_crypto_digest(batch->type, batch->inputs[i], batch->sizes[i], batch->outputs[i]) == false)
+    {
+      ret = NULL;
+    }
+  }
+
+  return ret;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file jutil_hash.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_hash.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for getrandom() */
+
+#include <jayc/jutil_hash.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/random.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Odd constants with balanced bits, that are mixed into input.
+ */
+static const uint64_t jutil_hash_secret[4] =
+{
+  0x2d358dccaa6c78a5ULL,
+  0x8bb84b93962eacc9ULL,
+  0x4b33a62ed433d4a3ULL,
+  0x4d5a2da51de1aa47ULL
+};
+
+static pthread_once_t jutil_hash_seed_once = PTHREAD_ONCE_INIT; /**< Reads random seed once. */
+static uint64_t jutil_hash_seed = 0;                            /**< Random seed of process. */
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Multiplies to 128bit, stores low half in @c a and high half in @c b .
+ * 
+ * @param a First factor, low half of product.
+ * @param b Second factor, high half of product.
+ */
+static inline void jutil_hash_multiply(uint64_t *a, uint64_t *b);
+
+/**
+ * @brief Multiplies to 128bit and folds halves.
+ * 
+ * @param a First factor.
+ * @param b Second factor.
+ * 
+ * @return  Low half xor high half of product.
+ */
+static inline uint64_t jutil_hash_mix(uint64_t a, uint64_t b);
+
+/**
+ * @brief Reads unaligned little endian 64bit word.
+ * 
+ * @param data  Data to read from.
+ * 
+ * @return      Word.
+ */
+static inline uint64_t jutil_hash_read64(const unsigned char *data);
+
+/**
+ * @brief Reads unaligned little endian 32bit word.
+ * 
+ * @param data  Data to read from.
+ * 
+ * @return      Word.
+ */
+static inline uint64_t jutil_hash_read32(const unsigned char *data);
+
+/**
+ * @brief Reads seed from kernel.
+ */
+static void jutil_hash_initSeed(void);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+uint64_t jutil_hash64(const void *data, size_t length, uint64_t seed)
+{
+  const unsigned char *p = (const unsigned char *)data;
+  uint64_t a;
+  uint64_t b;
+
+  seed ^= jutil_hash_mix(seed ^ jutil_hash_secret[0], jutil_hash_secret[1]);
+
+  if(length <= 16)
+  {
+    if(length >= 4)
+    {
+      /* Overlapping reads cover 4 to 16 bytes without branches. */
+      size_t shift = (length >> 3) << 2;
+      a = (jutil_hash_read32(p) << 32) | jutil_hash_read32(p + shift);
+      b = (jutil_hash_read32(p + length - 4) << 32) | jutil_hash_read32(p + length - 4 - shift);
+    }
+    else if(length > 0)
+    {
+      a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | (uint64_t)p[length - 1];
+      b = 0;
+    }
+    else
+    {
+      a = 0;
+      b = 0;
+    }
+  }
+  else
+  {
+    size_t rest = length;
+
+    if(rest > 48)
+    {
+      /* Three independent lanes keep multipliers busy. */
+      uint64_t lane1 = seed;
+      uint64_t lane2 = seed;
+
+      do
+      {
+        seed = jutil_hash_mix(jutil_hash_read64(p) ^ jutil_hash_secret[1], jutil_hash_read64(p + 8) ^ seed);
+        lane1 = jutil_hash_mix(jutil_hash_read64(p + 16) ^ jutil_hash_secret[2], jutil_hash_read64(p + 24) ^ lane1);
+        lane2 = jutil_hash_mix(jutil_hash_read64(p + 32) ^ jutil_hash_secret[3], jutil_hash_read64(p + 40) ^ lane2);
+        p += 48;
+        rest -= 48;
+      } while(rest > 48);
+
+      seed ^= lane1 ^ lane2;
+    }
+
+    while(rest > 16)
+    {
+      seed = jutil_hash_mix(jutil_hash_read64(p) ^ jutil_hash_secret[1], jutil_hash_read64(p + 8) ^ seed);
+      p += 16;
+      rest -= 16;
+    }
+
+    /* Last 16 bytes, may overlap with bytes already mixed. */
+    a = jutil_hash_read64(p + rest - 16);
+    b = jutil_hash_read64(p + rest - 8);
+  }
+
+  a ^= jutil_hash_secret[1];
+  b ^= seed;
+  jutil_hash_multiply(&a, &b);
+
+  return jutil_hash_mix(a ^ jutil_hash_secret[0] ^ (uint64_t)length, b ^ jutil_hash_secret[1]);
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jutil_hash64_str(const char *str, uint64_t seed)
+{
+  return jutil_hash64(str, (str ? strlen(str) : 0), seed);
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jutil_hash_getRandomSeed(void)
+{
+  pthread_once(&jutil_hash_seed_once, &jutil_hash_initSeed);
+  return jutil_hash_seed;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void jutil_hash_multiply(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 product = (unsigned __int128)*a * *b;
+  *a = (uint64_t)product;
+  *b = (uint64_t)(product >> 64);
+#else
+  uint64_t a_high = *a >> 32;
+  uint64_t a_low = (uint32_t)*a;
+  uint64_t b_high = *b >> 32;
+  uint64_t b_low = (uint32_t)*b;
+
+  uint64_t high = a_high * b_high;
+  uint64_t middle1 = a_high * b_low;
+  uint64_t middle2 = a_low * b_high;
+  uint64_t low = a_low * b_low;
+
+  uint64_t carry = ((low >> 32) + (uint32_t)middle1 + (uint32_t)middle2) >> 32;
+  *a = low + (middle1 << 32) + (middle2 << 32);
+  *b = high + (middle1 >> 32) + (middle2 >> 32) + carry;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jutil_hash_mix(uint64_t a, uint64_t b)
+{
+  jutil_hash_multiply(&a, &b);
+  return a ^ b;
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jutil_hash_read64(const unsigned char *data)
+{
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+//------------------------------------------------------------------------------
+//
+uint64_t jutil_hash_read32(const unsigned char *data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+  value = __builtin_bswap32(value);
+#endif
+  return value;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_hash_initSeed(void)
+{
+  uint64_t seed;
+  if(getrandom(&seed, sizeof(seed), GRND_NONBLOCK) != (ssize_t)sizeof(seed))
+  {
+    /* Entropy pool not ready, seed is still unknown to other hosts. */
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    seed = ((uint64_t)now.tv_nsec << 32) ^ (uint64_t)now.tv_sec ^ ((uint64_t)getpid() << 16) ^ (uint64_t)(uintptr_t)&seed;
+  }
+
+  jutil_hash_seed = seed;
+}
@@ -4,15 +4,34 @@
  * 
  * @brief Implementation of jutil_linkedlist.
  * 
+ * The first node points back to the last node,
+ * so the end of a list is found without iterating.
+ * 
+ * Freed nodes are kept in a small cache of
+ * each thread and reused for new nodes, unless
+ * an allocator was set by the user.
+ * 
  * @date 2020-09-23
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
  */
 
 #include <jayc/jutil_linkedlist.h>
+#include <jayc/jutil_alloc.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdbool.h>
 
+/**
+ * @brief Allocation statistics of module.
+ */
+JUTIL_ALLOC_MODULE("jutil_linkedlist");
+
+/**
+ * @brief Maximum number of cached nodes per thread.
+ */
+#define JUTIL_LINKEDLIST_CACHE_SIZE 64
+
 /**
  * @brief Create a node.
  * 
@@ -24,17 +43,122 @@
  */
 static jutil_linkedlist_t *jutil_linkedlist_allocNode();
 
+/**
+ * @brief Frees node or puts it into cache.
+ * 
+ * @param node Node to free.
+ */
+static void jutil_linkedlist_freeNode(jutil_linkedlist_t *node);
+
+/**
+ * @brief Links node at start or end of list.
+ * 
+ * @param list  List to edit.
+ * @param node  Node to link.
+ * @param front @c true , if node becomes first node.
+ */
+static void jutil_linkedlist_link(jutil_linkedlist_t **list, jutil_linkedlist_t *node, int front);
+
+/**
+ * @brief Unlinks node from list. Does not free it.
+ * 
+ * @param list List to edit.
+ * @param node Node of list to unlink.
+ */
+static void jutil_linkedlist_unlink(jutil_linkedlist_t **list, jutil_linkedlist_t *node);
+
+/**
+ * @brief Creates key to free cache at thread exit.
+ */
+static void jutil_linkedlist_keyInit();
+
+/**
+ * @brief Frees cached nodes of exiting thread.
+ * 
+ * @param ptr Unused.
+ */
+static void jutil_linkedlist_keyDestructor(void *ptr);
+
 struct __jutil_linkedlist
 {
   void *data;
   struct __jutil_linkedlist *next;
+  struct __jutil_linkedlist *prev;  /**< Previous node. First node points to last node. */
 };
 
+struct __jutil_linkedlist_head
+{
+  jutil_linkedlist_t *first;        /**< First node of list. */
+  size_t size;                      /**< Number of nodes. */
+};
+
+/**
+ * @brief Allocator set by user. Uses cache, if @c alloc is @c NULL .
+ */
+static jutil_linkedlist_allocator_t jutil_linkedlist_allocator = { NULL, NULL, NULL };
+
+/**
+ * @brief Freed nodes of thread, linked by @c next .
+ */
+static _Thread_local jutil_linkedlist_t *jutil_linkedlist_cache = NULL;
+
+/**
+ * @brief Number of nodes in @c #jutil_linkedlist_cache .
+ */
+static _Thread_local size_t jutil_linkedlist_cacheSize = 0;
+
+/**
+ * @brief Creates key for thread exit.
+ */
+static pthread_once_t jutil_linkedlist_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Key to free cache at thread exit.
+ */
+static pthread_key_t jutil_linkedlist_key;
+
+/**
+ * @brief @c true , if @c #jutil_linkedlist_key was created.
+ */
+static int jutil_linkedlist_keyCreated = false;
+
+//------------------------------------------------------------------------------
+//
+int jutil_linkedlist_setAllocator(const jutil_linkedlist_allocator_t *allocator)
+{
+  if(allocator == NULL)
+  {
+    jutil_linkedlist_allocator.alloc = NULL;
+    jutil_linkedlist_allocator.free = NULL;
+    jutil_linkedlist_allocator.ctx = NULL;
+    return true;
+  }
+
+  if(allocator->alloc == NULL || allocator->free == NULL)
+  {
+    return false;
+  }
+
+  jutil_linkedlist_allocator = *allocator;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_linkedlist_nodeSize()
+{
+  return sizeof(jutil_linkedlist_t);
+}
+
 //------------------------------------------------------------------------------
 //
 jutil_linkedlist_t *jutil_linkedlist_init()
 {
   jutil_linkedlist_t *list = jutil_linkedlist_allocNode();
+  if(list)
+  {
+    list->prev = list;
+  }
   
   return list;
 }
@@ -58,7 +182,23 @@ void jutil_linkedlist_free(jutil_linkedlist_t **list)
 //
 jutil_linkedlist_t *jutil_linkedlist_allocNode()
 {
-  jutil_linkedlist_t *node = (jutil_linkedlist_t *)malloc(sizeof(jutil_linkedlist_t));
+  jutil_linkedlist_t *node;
+
+  if(jutil_linkedlist_allocator.alloc)
+  {
+    node = (jutil_linkedlist_t *)jutil_linkedlist_allocator.alloc(jutil_linkedlist_allocator.ctx, sizeof(jutil_linkedlist_t));
+  }
+  else if(jutil_linkedlist_cache)
+  {
+    node = jutil_linkedlist_cache;
+    jutil_linkedlist_cache = node->next;
+    jutil_linkedlist_cacheSize--;
+  }
+  else
+  {
+    node = (jutil_linkedlist_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_linkedlist_t));
+  }
+
   if(node == NULL)
   {
     return NULL;
@@ -66,6 +206,7 @@ jutil_linkedlist_t *jutil_linkedlist_allocNode()
 
   node->data = NULL;
   node->next = NULL;
+  node->prev = NULL;
   return node;
 }
 
@@ -129,12 +270,7 @@ int jutil_linkedlist_push(jutil_linkedlist_t **list, void *data)
   }
   node->data = data;
 
-  if(*list)
-  {
-    node->next = *list;
-  }
-
-  *list = node;
+  jutil_linkedlist_link(list, node, true);
   return true;
 }
 
@@ -147,11 +283,11 @@ void *jutil_linkedlist_pop(jutil_linkedlist_t **list)
     return NULL;
   }
 
-  void *ret = (*list)->data;
-  jutil_linkedlist_t *new_head = (*list)->next;
+  jutil_linkedlist_t *node = *list;
+  void *ret = node->data;
 
-  free(*list);
-  *list = new_head;
+  jutil_linkedlist_unlink(list, node);
+  jutil_linkedlist_freeNode(node);
 
   return ret;
 }
@@ -170,89 +306,311 @@ void *jutil_linkedlist_removeNode(jutil_linkedlist_t **list, jutil_linkedlist_t
     return NULL;
   }
 
+  jutil_linkedlist_t *itr = *list;
+  while(itr != NULL && itr != node)
+  {
+    itr = jutil_linkedlist_iterate(itr);
+  }
+
+  if(itr == NULL)
+  {
+    return NULL;
+  }
+
   void *ret = node->data;
 
-  if(*list == node)
+  jutil_linkedlist_unlink(list, node);
+  jutil_linkedlist_freeNode(node);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_linkedlist_append(jutil_linkedlist_t **list, void *data)
+{
+  if(list == NULL)
   {
-    jutil_linkedlist_t *tmp = (*list)->next;
-    free(*list);
-    *list = tmp;
-    
-    return ret;
+    return false;
   }
 
-  jutil_linkedlist_t *prev = NULL;
-  jutil_linkedlist_t *itr = *list;
-  while(itr != NULL)
+  jutil_linkedlist_t *node = jutil_linkedlist_allocNode();
+  if(node == NULL)
   {
-    if(itr == node)
-    {
-      prev->next = itr->next;
-      free(itr);
+    return false;
+  }
+  node->data = data;
 
-      return ret;
-    }
+  jutil_linkedlist_link(list, node, false);
+  return true;
+}
 
-    prev = itr;
-    itr = jutil_linkedlist_iterate(itr);
+//------------------------------------------------------------------------------
+//
+void *jutil_linkedlist_remove(jutil_linkedlist_t **list)
+{
+  if(list == NULL || *list == NULL)
+  {
+    return NULL;
+  }
+
+  jutil_linkedlist_t *node = (*list)->prev;
+  void *ret = node->data;
+
+  jutil_linkedlist_unlink(list, node);
+  jutil_linkedlist_freeNode(node);
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_linkedlist_head_t *jutil_linkedlist_head_init()
+{
+  jutil_linkedlist_head_t *head = (jutil_linkedlist_head_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_linkedlist_head_t));
+  if(head == NULL)
+  {
+    return NULL;
   }
 
-  return NULL;
+  head->first = NULL;
+  head->size = 0;
+
+  return head;
 }
 
 //------------------------------------------------------------------------------
 //
-int jutil_linkedlist_append(jutil_linkedlist_t **list, void *data)
+void jutil_linkedlist_head_free(jutil_linkedlist_head_t *head)
 {
-  if(list == NULL)
+  if(head == NULL)
+  {
+    return;
+  }
+
+  jutil_linkedlist_free(&head->first);
+  JUTIL_ALLOC_FREE(head);
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_linkedlist_t *jutil_linkedlist_head_first(jutil_linkedlist_head_t *head)
+{
+  if(head == NULL)
+  {
+    return NULL;
+  }
+
+  return head->first;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_linkedlist_head_size(jutil_linkedlist_head_t *head)
+{
+  if(head == NULL)
+  {
+    return 0;
+  }
+
+  return head->size;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_linkedlist_head_push(jutil_linkedlist_head_t *head, void *data)
+{
+  if(head == NULL)
   {
     return false;
   }
 
-  if(*list == NULL)
+  if(jutil_linkedlist_push(&head->first, data) == false)
   {
-    jutil_linkedlist_t *node = jutil_linkedlist_allocNode();
-    if(node == NULL)
-    {
-      return false;
-    }
+    return false;
+  }
 
-    node->data = data;
-    *list = node;
-    return true;
+  head->size++;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_linkedlist_head_pop(jutil_linkedlist_head_t *head)
+{
+  if(head == NULL || head->first == NULL)
+  {
+    return NULL;
+  }
+
+  head->size--;
+  return jutil_linkedlist_pop(&head->first);
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_linkedlist_head_removeNode(jutil_linkedlist_head_t *head, jutil_linkedlist_t *node)
+{
+  if(head == NULL || head->first == NULL)
+  {
+    return NULL;
   }
 
-  jutil_linkedlist_t *node = jutil_linkedlist_allocNode();
   if(node == NULL)
+  {
+    return NULL;
+  }
+
+  void *ret = node->data;
+
+  jutil_linkedlist_unlink(&head->first, node);
+  jutil_linkedlist_freeNode(node);
+  head->size--;
+
+  return ret;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_linkedlist_head_append(jutil_linkedlist_head_t *head, void *data)
+{
+  if(head == NULL)
   {
     return false;
   }
-  node->data = data;
 
-  jutil_linkedlist_t *itr = *list;
-  while(itr->next != NULL)
+  if(jutil_linkedlist_append(&head->first, data) == false)
   {
-    itr = jutil_linkedlist_iterate(itr);
+    return false;
   }
 
-  itr->next = node;
+  head->size++;
   return true;
 }
 
 //------------------------------------------------------------------------------
 //
-void *jutil_linkedlist_remove(jutil_linkedlist_t **list)
+void *jutil_linkedlist_head_remove(jutil_linkedlist_head_t *head)
 {
-  if(list == NULL || *list == NULL)
+  if(head == NULL || head->first == NULL)
   {
     return NULL;
   }
 
-  jutil_linkedlist_t *itr = *list;
-  while(itr->next != NULL)
+  head->size--;
+  return jutil_linkedlist_remove(&head->first);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_linkedlist_link(jutil_linkedlist_t **list, jutil_linkedlist_t *node, int front)
+{
+  jutil_linkedlist_t *first = *list;
+
+  if(first == NULL)
   {
-    itr = jutil_linkedlist_iterate(itr);
+    node->next = NULL;
+    node->prev = node;
+    *list = node;
+    return;
+  }
+
+  jutil_linkedlist_t *last = first->prev;
+
+  if(front)
+  {
+    node->next = first;
+    node->prev = last;
+    first->prev = node;
+    *list = node;
+  }
+  else
+  {
+    node->next = NULL;
+    node->prev = last;
+    last->next = node;
+    first->prev = node;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_linkedlist_unlink(jutil_linkedlist_t **list, jutil_linkedlist_t *node)
+{
+  jutil_linkedlist_t *first = *list;
+
+  if(node == first)
+  {
+    *list = node->next;
+    if(node->next)
+    {
+      node->next->prev = node->prev;
+    }
+    return;
+  }
+
+  node->prev->next = node->next;
+  if(node->next)
+  {
+    node->next->prev = node->prev;
   }
+  else
+  {
+    first->prev = node->prev;
+  }
+}
+//------------------------------------------------------------------------------
+//
+void jutil_linkedlist_freeNode(jutil_linkedlist_t *node)
+{
+  if(jutil_linkedlist_allocator.free)
+  {
+    jutil_linkedlist_allocator.free(jutil_linkedlist_allocator.ctx, node);
+    return;
+  }
+
+  if(jutil_linkedlist_cacheSize >= JUTIL_LINKEDLIST_CACHE_SIZE)
+  {
+    JUTIL_ALLOC_FREE(node);
+    return;
+  }
+
+  /* Cache is freed with key destructor at thread exit. */
+  if(jutil_linkedlist_cacheSize == 0)
+  {
+    pthread_once(&jutil_linkedlist_once, jutil_linkedlist_keyInit);
+    if(jutil_linkedlist_keyCreated == false || pthread_setspecific(jutil_linkedlist_key, (void *)1) != 0)
+    {
+      JUTIL_ALLOC_FREE(node);
+      return;
+    }
+  }
+
+  node->next = jutil_linkedlist_cache;
+  jutil_linkedlist_cache = node;
+  jutil_linkedlist_cacheSize++;
+}
 
-  return jutil_linkedlist_removeNode(list, itr);
-}
\ No newline at end of file
+//------------------------------------------------------------------------------
+//
+void jutil_linkedlist_keyInit()
+{
+  if(pthread_key_create(&jutil_linkedlist_key, jutil_linkedlist_keyDestructor) == 0)
+  {
+    jutil_linkedlist_keyCreated = true;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_linkedlist_keyDestructor(void *ptr)
+{
+  while(jutil_linkedlist_cache)
+  {
+    jutil_linkedlist_t *node = jutil_linkedlist_cache;
+    jutil_linkedlist_cache = node->next;
+    JUTIL_ALLOC_FREE(node);
+  }
+
+  jutil_linkedlist_cacheSize = 0;
+}
@@ -0,0 +1,481 @@
+/**
+ * @file jutil_lz4.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_lz4.
+ * 
+ * A block is a list of sequences. Each sequence has a token
+ * (4 bits literal length, 4 bits match length), extra length
+ * bytes, the literals, a 2 byte offset and extra match length
+ * bytes. The last sequence only has literals. The last 5 bytes
+ * are always literals and the last match starts at least
+ * 12 bytes before the end, like the format requires.
+ * 
+ * Positions in the hash table are offsets from the start of
+ * the source. Entries of a previous block are not cleared by
+ * position, the table is reset instead, so stale entries can
+ * not point outside of the current source.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jutil_lz4.h>
+#include <jayc/jutil_alloc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_lz4");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Number of bits of hash table index.
+ */
+#define JUTIL_LZ4_HASH_LOG 12
+
+/**
+ * @brief Number of entries of hash table.
+ */
+#define JUTIL_LZ4_HASH_SIZE (1 << JUTIL_LZ4_HASH_LOG)
+
+/**
+ * @brief Minimum length of match.
+ */
+#define JUTIL_LZ4_MINMATCH 4
+
+/**
+ * @brief Bytes at end of block, that are always literals.
+ */
+#define JUTIL_LZ4_LASTLITERALS 5
+
+/**
+ * @brief Matches have to start this many bytes before end of block.
+ */
+#define JUTIL_LZ4_MFLIMIT 12
+
+/**
+ * @brief Maximum distance of match.
+ */
+#define JUTIL_LZ4_OFFSET_MAX 65535
+
+/**
+ * @brief Length, at which extra length bytes follow.
+ */
+#define JUTIL_LZ4_LENGTH_MASK 15
+
+/**
+ * @brief Failed searches, after which the step grows by one.
+ * 
+ * Skips faster through incompressible data.
+ */
+#define JUTIL_LZ4_SKIP_TRIGGER 6
+
+/**
+ * @brief Maximum size of source.
+ */
+#define JUTIL_LZ4_INPUT_MAX 0x7E000000
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Compression context.
+ */
+struct __jutil_lz4_session
+{
+  uint32_t table[JUTIL_LZ4_HASH_SIZE]; /**< Last position of each hashed 4 byte sequence. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Reads unaligned 32bit word in native byte order.
+ * 
+ * @param data  Data to read from.
+ * 
+ * @return      Word.
+ */
+static inline uint32_t jutil_lz4_read32(const uint8_t *data);
+
+/**
+ * @brief Hashes 4 byte sequence to table index.
+ * 
+ * @param sequence  Sequence read with @c #jutil_lz4_read32() .
+ * 
+ * @return          Index in hash table.
+ */
+static inline uint32_t jutil_lz4_hash(uint32_t sequence);
+
+/**
+ * @brief Counts equal bytes of two positions.
+ * 
+ * @param data  Position to compare.
+ * @param ref   Earlier position to compare with.
+ * @param limit End of data, that may be compared.
+ * 
+ * @return      Number of equal bytes.
+ */
+static size_t jutil_lz4_countMatch(const uint8_t *data, const uint8_t *ref, const uint8_t *limit);
+
+/**
+ * @brief Writes extra length bytes.
+ * 
+ * @param dest    Destination.
+ * @param length  Length minus @c JUTIL_LZ4_LENGTH_MASK .
+ * 
+ * @return        End of written bytes.
+ */
+static uint8_t *jutil_lz4_writeLength(uint8_t *dest, size_t length);
+
+/**
+ * @brief Reads extra length bytes.
+ * 
+ * @param src     Position of first extra byte. Moved behind last one.
+ * @param end     End of block.
+ * @param length  Length to add to.
+ * 
+ * @return        @c true , if length was read.
+ * @return        @c false , if block ended.
+ */
+static int jutil_lz4_readLength(const uint8_t **src, const uint8_t *end, size_t *length);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_lz4_t *jutil_lz4_init(void)
+{
+  jutil_lz4_t *session = (jutil_lz4_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_lz4_t));
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_lz4_free(jutil_lz4_t *session)
+{
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_lz4_getBound(size_t size)
+{
+  return size + size / 255 + 16;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_lz4_compress(jutil_lz4_t *session, const void *src, size_t src_size, void *dest, size_t dest_size)
+{
+  if(session == NULL || (src == NULL && src_size > 0) || dest == NULL || src_size > JUTIL_LZ4_INPUT_MAX)
+  {
+    return 0;
+  }
+
+  const uint8_t *base = (const uint8_t *)src;
+  const uint8_t *ip = base;
+  const uint8_t *anchor = base;
+  const uint8_t *iend = base + src_size;
+  uint8_t *op = (uint8_t *)dest;
+  uint8_t *oend = op + dest_size;
+
+  if(src_size > JUTIL_LZ4_MFLIMIT)
+  {
+    const uint8_t *mflimit = iend - JUTIL_LZ4_MFLIMIT;
+    const uint8_t *matchlimit = iend - JUTIL_LZ4_LASTLITERALS;
+
+    /* Zeroed entries point to the start, which is a valid candidate. */
+    memset(session->table, 0, sizeof(session->table));
+    ip++;
+
+    while(ip < mflimit)
+    {
+      const uint8_t *ref = NULL;
+      size_t attempts = (1 << JUTIL_LZ4_SKIP_TRIGGER);
+      size_t step = 1;
+
+      while(ip < mflimit)
+      {
+        uint32_t sequence = jutil_lz4_read32(ip);
+        uint32_t hash = jutil_lz4_hash(sequence);
+        const uint8_t *candidate = base + session->table[hash];
+        session->table[hash] = (uint32_t)(ip - base);
+
+        if(ip - candidate <= JUTIL_LZ4_OFFSET_MAX && jutil_lz4_read32(candidate) == sequence)
+        {
+          ref = candidate;
+          break;
+        }
+
+        ip += step;
+        step = (attempts++ >> JUTIL_LZ4_SKIP_TRIGGER);
+      }
+
+      if(ref == NULL)
+      {
+        break;
+      }
+
+      while(ip > anchor && ref > base && ip[-1] == ref[-1])
+      {
+        ip--;
+        ref--;
+      }
+
+      size_t literal_length = ip - anchor;
+      size_t match_length = jutil_lz4_countMatch(ip + JUTIL_LZ4_MINMATCH, ref + JUTIL_LZ4_MINMATCH, matchlimit);
+
+      /* Token, length bytes, literals and offset. */
+      if((size_t)(oend - op) < 1 + (literal_length / 255 + 1) + literal_length + 2 + (match_length / 255 + 1))
+      {
+        return 0;
+      }
+
+      uint8_t *token = op++;
+      if(literal_length >= JUTIL_LZ4_LENGTH_MASK)
+      {
+        *token = (JUTIL_LZ4_LENGTH_MASK << 4);
+        op = jutil_lz4_writeLength(op, literal_length - JUTIL_LZ4_LENGTH_MASK);
+      }
+      else
+      {
+        *token = (uint8_t)(literal_length << 4);
+      }
+      memcpy(op, anchor, literal_length);
+      op += literal_length;
+
+      size_t offset = ip - ref;
+      *op++ = (uint8_t)(offset & 0xFF);
+      *op++ = (uint8_t)(offset >> 8);
+
+      if(match_length >= JUTIL_LZ4_LENGTH_MASK)
+      {
+        *token |= JUTIL_LZ4_LENGTH_MASK;
+        op = jutil_lz4_writeLength(op, match_length - JUTIL_LZ4_LENGTH_MASK);
+      }
+      else
+      {
+        *token |= (uint8_t)match_length;
+      }
+
+      ip += match_length + JUTIL_LZ4_MINMATCH;
+      anchor = ip;
+
+      /* Position inside the match improves the next search. */
+      if(ip < mflimit)
+      {
+        session->table[jutil_lz4_hash(jutil_lz4_read32(ip - 2))] = (uint32_t)(ip - 2 - base);
+      }
+    }
+  }
+
+  size_t literal_length = iend - anchor;
+  if((size_t)(oend - op) < 1 + (literal_length / 255 + 1) + literal_length)
+  {
+    return 0;
+  }
+
+  if(literal_length >= JUTIL_LZ4_LENGTH_MASK)
+  {
+    *op++ = (JUTIL_LZ4_LENGTH_MASK << 4);
+    op = jutil_lz4_writeLength(op, literal_length - JUTIL_LZ4_LENGTH_MASK);
+  }
+  else
+  {
+    *op++ = (uint8_t)(literal_length << 4);
+  }
+  memcpy(op, anchor, literal_length);
+  op += literal_length;
+
+  return op - (uint8_t *)dest;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_lz4_decompress(const void *src, size_t src_size, void *dest, size_t dest_size)
+{
+  if(src == NULL || src_size == 0 || (dest == NULL && dest_size > 0))
+  {
+    return 0;
+  }
+
+  const uint8_t *ip = (const uint8_t *)src;
+  const uint8_t *iend = ip + src_size;
+  uint8_t *op = (uint8_t *)dest;
+  uint8_t *oend = op + dest_size;
+
+  for(;;)
+  {
+    if(ip >= iend)
+    {
+      return 0;
+    }
+
+    uint8_t token = *ip++;
+
+    size_t literal_length = (token >> 4);
+    if(literal_length == JUTIL_LZ4_LENGTH_MASK && jutil_lz4_readLength(&ip, iend, &literal_length) == false)
+    {
+      return 0;
+    }
+    if(literal_length > (size_t)(iend - ip) || literal_length > (size_t)(oend - op))
+    {
+      return 0;
+    }
+
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    /* Last sequence has no match. */
+    if(ip == iend)
+    {
+      break;
+    }
+
+    if(iend - ip < 2)
+    {
+      return 0;
+    }
+    size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if(offset == 0 || offset > (size_t)(op - (uint8_t *)dest))
+    {
+      return 0;
+    }
+
+    size_t match_length = (token & JUTIL_LZ4_LENGTH_MASK);
+    if(match_length == JUTIL_LZ4_LENGTH_MASK && jutil_lz4_readLength(&ip, iend, &match_length) == false)
+    {
+      return 0;
+    }
+    match_length += JUTIL_LZ4_MINMATCH;
+    if(match_length > (size_t)(oend - op))
+    {
+      return 0;
+    }
+
+    const uint8_t *ref = op - offset;
+    if(offset >= match_length)
+    {
+      memcpy(op, ref, match_length);
+      op += match_length;
+    }
+    else
+    {
+      /* Overlapping matches repeat the last bytes. */
+      size_t i;
+      for(i = 0; i < match_length; i++)
+      {
+        *op++ = *ref++;
+      }
+    }
+  }
+
+  return op - (uint8_t *)dest;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+uint32_t jutil_lz4_read32(const uint8_t *data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+//------------------------------------------------------------------------------
+//
+uint32_t jutil_lz4_hash(uint32_t sequence)
+{
+  return (sequence * 2654435761U) >> (32 - JUTIL_LZ4_HASH_LOG);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_lz4_countMatch(const uint8_t *data, const uint8_t *ref, const uint8_t *limit)
+{
+  const uint8_t *start = data;
+
+  while(limit - data >= 8)
+  {
+    uint64_t a;
+    uint64_t b;
+    memcpy(&a, data, sizeof(a));
+    memcpy(&b, ref, sizeof(b));
+    if(a != b)
+    {
+      break;
+    }
+    data += 8;
+    ref += 8;
+  }
+
+  while(data < limit && *data == *ref)
+  {
+    data++;
+    ref++;
+  }
+
+  return data - start;
+}
+
+//------------------------------------------------------------------------------
+//
+uint8_t *jutil_lz4_writeLength(uint8_t *dest, size_t length)
+{
+  while(length >= 255)
+  {
+    *dest++ = 255;
+    length -= 255;
+  }
+  *dest++ = (uint8_t)length;
+
+  return dest;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_lz4_readLength(const uint8_t **src, const uint8_t *end, size_t *length)
+{
+  uint8_t value;
+  do
+  {
+    if(*src >= end)
+    {
+      return false;
+    }
+    value = *(*src)++;
+    *length += value;
+  } while(value == 255);
+
+  return true;
+}
@@ -4,28 +4,157 @@
  * 
  * @brief Implements jutil_map.
  * 
+ * Entries are stored in an open addressing hash table
+ * with robin hood probing (entries with longer probe
+ * distance take the slot of entries closer to their home,
+ * deletion shifts following entries back).
+ * 
+ * When the table gets full, a table with double capacity
+ * is created and entries are moved over a few slots per
+ * modification. Until then, lookups check both tables.
+ * 
+ * Entries are allocated separately and linked in a list,
+ * so pointers returned by @c #jutil_map_iterate() stay
+ * valid, when the table grows.
+ * 
+ * Index strings are copied into their entry, together with
+ * length and hash. Entries with short indices fill one cache
+ * line and are taken from chunks, that are allocated aligned
+ * to cache lines. Entries with longer indices are allocated
+ * with the size needed.
+ * 
  * @date 2020-10-02
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
  */
 
 #include <jayc/jutil_map.h>
-#include <jayc/jutil_linkedlist.h>
+#include <jayc/jutil_hash.h>
+#include <jayc/jutil_alloc.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_map");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Number of slots of first table. Has to be a power of 2.
+ */
+#define JUTIL_MAP_CAPACITY_MIN 16
+
+/**
+ * @brief Table grows, when its entries exceed
+ *        numerator / denominator of its capacity.
+ */
+#define JUTIL_MAP_LOAD_NUMERATOR 3
+#define JUTIL_MAP_LOAD_DENOMINATOR 4
+
+/**
+ * @brief Slots of old table, that are moved per modification.
+ * 
+ * Old table has to be empty, before new table is full.
+ * It has at most 3/4 capacity entries, new table has room for
+ * 3/4 capacity more, so 4 steps per insert finish in time.
+ */
+#define JUTIL_MAP_MIGRATE_STEPS 4
+
+/**
+ * @brief Size of entries with short indices. Size of a cache line.
+ */
+#define JUTIL_MAP_SIZE_ENTRY 64
+
+/**
+ * @brief Number of entries allocated at once.
+ */
+#define JUTIL_MAP_CHUNK_ENTRIES 64
+
+
+
 //==============================================================================
 // Define structures.
 //
 
+/**
+ * @brief Entry of map.
+ * 
+ * Public pair is first member, so pointers to the
+ * pair can be cast to the entry.
+ */
+typedef struct __jutil_map_entry
+{
+  jutil_map_data_t pair;            /**< Index and data returned to user. Index points to @c key . */
+  uint32_t hash;                    /**< Hash of index. */
+  uint32_t length;                  /**< Length of index. */
+  struct __jutil_map_entry *next;   /**< Next entry for iteration. Next free entry in chunks. */
+  struct __jutil_map_entry *prev;   /**< Previous entry for iteration. */
+  char key[];                       /**< Index string. */
+} jutil_map_entry_t;
+
+/**
+ * @brief Maximum length of index stored in chunk entries.
+ */
+#define JUTIL_MAP_SIZE_INLINE (JUTIL_MAP_SIZE_ENTRY - offsetof(jutil_map_entry_t, key) - 1)
+
+/**
+ * @brief Header of entry chunk.
+ * 
+ * Takes the place of first entry, so entries
+ * stay aligned.
+ */
+typedef struct __jutil_map_chunk
+{
+  struct __jutil_map_chunk *next;   /**< Next allocated chunk. */
+} jutil_map_chunk_t;
+
+/**
+ * @brief Slot of hash table.
+ * 
+ * Hash is copied into slot, so probing does not
+ * need to read entries.
+ */
+typedef struct __jutil_map_slot
+{
+  uint32_t hash;                    /**< Hash of entry. */
+  jutil_map_entry_t *entry;         /**< Entry in slot. @c NULL , if slot is empty. */
+} jutil_map_slot_t;
+
+/**
+ * @brief Hash table with robin hood probing.
+ */
+typedef struct __jutil_map_table
+{
+  jutil_map_slot_t *slots;          /**< Array of slots. @c NULL , if table is not allocated. */
+  size_t capacity;                  /**< Number of slots. Power of 2. */
+  size_t count;                     /**< Number of entries in table. */
+} jutil_map_table_t;
+
 /**
  * @brief Object pointer.
  */
 struct __jutil_map
 {
-  jutil_linkedlist_t *list; /**< Map based on linkedlist. */
+  jutil_map_table_t table;          /**< Table for new entries. */
+  jutil_map_table_t old_table;      /**< Table, that is moved into @c table . Empty, if not growing. */
+  size_t migrate_position;          /**< Next slot of @c old_table to move. */
+  jutil_map_entry_t *head;          /**< Newest entry, first in iteration. */
+  size_t size;                      /**< Number of entries in both tables. */
+  jutil_map_entry_t *free_entries;  /**< Unused entries of chunks. */
+  jutil_map_chunk_t *chunks;        /**< Allocated chunks. */
+  uint64_t seed;                    /**< Seed of hashes, random per process. */
+  jutil_alloc_allocator_t allocator; /**< Allocator of map, empty for global allocator. */
 };
 
 
@@ -35,15 +164,133 @@ struct __jutil_map
 //
 
 /**
- * @brief Finds linkedlist node by index.
+ * @brief Checks index and returns its length.
+ * 
+ * @param index Index to check.
+ * 
+ * @return      Length of index.
+ * @return      @c 0 , if index is @c NULL , empty or too long.
+ */
+static size_t jutil_map_checkIndex(const char *index);
+
+/**
+ * @brief Calculates seeded hash of index.
+ * 
+ * @param map   Map with seed.
+ * @param index Index to hash.
+ * @param size  Length of index.
+ * 
+ * @return      Hash value.
+ */
+static uint32_t jutil_map_hash(jutil_map_t *map, const char *index, size_t size);
+
+/**
+ * @brief Finds entry by index in both tables.
  * 
  * @param map   Map object.
  * @param index Index string to search by.
+ * @param size  Length of index.
+ * @param hash  Hash of index.
+ * @param table Returns table of entry. Can be @c NULL .
+ * @param pos   Returns slot of entry. Can be @c NULL .
+ * 
+ * @return      Entry with index.
+ * @return      @c NULL , if not found.
+ */
+static jutil_map_entry_t *jutil_map_find(jutil_map_t *map, const char *index, size_t size, uint32_t hash, jutil_map_table_t **table, size_t *pos);
+
+/**
+ * @brief Finds slot of index in one table.
+ * 
+ * @param table Table to search.
+ * @param index Index string to search by.
+ * @param size  Length of index.
+ * @param hash  Hash of index.
+ * @param pos   Returns slot of entry.
+ * 
+ * @return      @c true , if found.
+ * @return      @c false , if not found.
+ */
+static int jutil_map_table_find(jutil_map_table_t *table, const char *index, size_t size, uint32_t hash, size_t *pos);
+
+/**
+ * @brief Inserts entry into table, that has free slots.
  * 
- * @return      Node with index.
- * @return      @c NULL , if not found or error occured.
+ * Index must not be in table.
+ * 
+ * @param table Table to insert into.
+ * @param hash  Hash of entry.
+ * @param entry Entry to insert.
  */
-static jutil_linkedlist_t *jutil_map_getNode(jutil_map_t *map, const char *index);
+static void jutil_map_table_insert(jutil_map_table_t *table, uint32_t hash, jutil_map_entry_t *entry);
+
+/**
+ * @brief Removes slot from table and shifts following entries back.
+ * 
+ * @param table Table to remove from.
+ * @param pos   Slot to remove.
+ */
+static void jutil_map_table_erase(jutil_map_table_t *table, size_t pos);
+
+/**
+ * @brief Makes room for another entry.
+ * 
+ * Starts growing, if table is full. If growing already,
+ * moves some slots of old table.
+ * 
+ * @param map Map object.
+ * 
+ * @return    @c true , if entry can be inserted.
+ * @return    @c false , if error occured.
+ */
+static int jutil_map_reserve(jutil_map_t *map);
+
+/**
+ * @brief Creates entry and inserts it into table.
+ * 
+ * Index must not be in map.
+ * 
+ * @param map   Map object.
+ * @param index Index for data.
+ * @param size  Length of index.
+ * @param hash  Hash of index.
+ * @param data  Data to store.
+ * 
+ * @return      New entry.
+ * @return      @c NULL , if error occured.
+ */
+static jutil_map_entry_t *jutil_map_insert(jutil_map_t *map, const char *index, size_t size, uint32_t hash, void *data);
+
+/**
+ * @brief Moves slots of old table into new table.
+ * 
+ * Frees old table, when it is empty.
+ * 
+ * @param map   Map object.
+ * @param steps Number of slots to process. @c 0 moves all.
+ */
+static void jutil_map_migrate(jutil_map_t *map, size_t steps);
+
+/**
+ * @brief Allocates entry for index of length @c size .
+ * 
+ * Takes entry from chunks, if index is short enough.
+ * 
+ * @param map  Map object.
+ * @param size Length of index.
+ * 
+ * @return     Entry with room for index.
+ * @return     @c NULL , if error occured.
+ */
+static jutil_map_entry_t *jutil_map_entry_alloc(jutil_map_t *map, size_t size);
+
+/**
+ * @brief Frees entry or puts it back into chunks.
+ * 
+ * @param map   Map object.
+ * @param entry Entry to free.
+ */
+static void jutil_map_entry_free(jutil_map_t *map, jutil_map_entry_t *entry);
 
 
 
@@ -55,13 +302,25 @@ static jutil_linkedlist_t *jutil_map_getNode(jutil_map_t *map, const char *index
 //
 jutil_map_t *jutil_map_init()
 {
-  jutil_map_t *map = (jutil_map_t *)malloc(sizeof(jutil_map_t));
+  return jutil_map_allocator_init(NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_map_t *jutil_map_allocator_init(const jutil_alloc_allocator_t *allocator)
+{
+  jutil_map_t *map = (jutil_map_t *)jutil_alloc_malloc(allocator, &jutil_alloc_module, sizeof(jutil_map_t));
   if(map == NULL)
   {
     return NULL;
   }
 
-  map->list = NULL;
+  memset(map, 0, sizeof(jutil_map_t));
+  map->seed = jutil_hash_getRandomSeed();
+  if(allocator)
+  {
+    map->allocator = *allocator;
+  }
 
   return map;
 }
@@ -76,7 +335,9 @@ void jutil_map_free(jutil_map_t *map)
   }
 
   jutil_map_clear(map);
-  free(map);
+
+  jutil_alloc_allocator_t allocator = map->allocator;
+  jutil_alloc_free(&allocator, &jutil_alloc_module, map);
 }
 
 //------------------------------------------------------------------------------
@@ -87,39 +348,113 @@ int jutil_map_add(jutil_map_t *map, const char *index, void *data)
   {
     return false;
   }
-  if(index == NULL)
+
+  size_t size = jutil_map_checkIndex(index);
+  if(size == 0)
   {
     return false;
   }
-  if(strlen(index) == 0)
+
+  uint32_t hash = jutil_map_hash(map, index, size);
+  if(jutil_map_find(map, index, size, hash, NULL, NULL))
   {
     return false;
   }
-  if(strlen(index) >= JUTIL_MAP_SIZE_INDEX)
+
+  return (jutil_map_insert(map, index, size, hash, data) ? true : false);
+}
+
+//------------------------------------------------------------------------------
+//
+void **jutil_map_emplace(jutil_map_t *map, const char *index, int *added)
+{
+  if(map == NULL)
   {
-    return false;
+    return NULL;
   }
-  if(jutil_map_contains(map, index))
+
+  size_t size = jutil_map_checkIndex(index);
+  if(size == 0)
   {
-    return false;
+    return NULL;
+  }
+
+  uint32_t hash = jutil_map_hash(map, index, size);
+  jutil_map_entry_t *entry = jutil_map_find(map, index, size, hash, NULL, NULL);
+  if(entry)
+  {
+    if(added)
+    {
+      *added = false;
+    }
+    return &entry->pair.data;
+  }
+
+  entry = jutil_map_insert(map, index, size, hash, NULL);
+  if(entry == NULL)
+  {
+    return NULL;
+  }
+
+  if(added)
+  {
+    *added = true;
   }
+  return &entry->pair.data;
+}
 
-  jutil_map_data_t *map_data = (jutil_map_data_t *)malloc(sizeof(jutil_map_data_t));
-  if(map_data == NULL)
+//------------------------------------------------------------------------------
+//
+int jutil_map_resize(jutil_map_t *map, size_t size)
+{
+  if(map == NULL)
   {
     return false;
   }
 
-  memset(map_data->index, 0, sizeof(map_data->index));
-  memcpy(map_data->index, index, strlen(index));
-  map_data->data = data;
+  if(size < map->size)
+  {
+    size = map->size;
+  }
 
-  if(jutil_linkedlist_push(&map->list, (void *)map_data) == false)
+  size_t capacity = JUTIL_MAP_CAPACITY_MIN;
+  while(capacity * JUTIL_MAP_LOAD_NUMERATOR < size * JUTIL_MAP_LOAD_DENOMINATOR)
+  {
+    capacity *= 2;
+  }
+
+  if(map->table.slots && capacity <= map->table.capacity)
+  {
+    return true;
+  }
+
+  jutil_map_slot_t *slots = (jutil_map_slot_t *)jutil_alloc_calloc(&map->allocator, &jutil_alloc_module, capacity, sizeof(jutil_map_slot_t));
+  if(slots == NULL)
   {
-    free(map_data);
     return false;
   }
 
+  /* All entries are moved at once, so the map is not growing afterwards. */
+  jutil_map_migrate(map, 0);
+
+  jutil_map_table_t old_table = map->table;
+  map->table.slots = slots;
+  map->table.capacity = capacity;
+  map->table.count = 0;
+
+  if(old_table.slots)
+  {
+    for(size_t i = 0; i < old_table.capacity; i++)
+    {
+      if(old_table.slots[i].entry)
+      {
+        jutil_map_table_insert(&map->table, old_table.slots[i].hash, old_table.slots[i].entry);
+      }
+    }
+
+    jutil_alloc_free(&map->allocator, &jutil_alloc_module, old_table.slots);
+  }
+
   return true;
 }
 
@@ -131,33 +466,41 @@ void *jutil_map_remove(jutil_map_t *map, const char *index)
   {
     return NULL;
   }
-  if(index == NULL)
+
+  size_t size = jutil_map_checkIndex(index);
+  if(size == 0)
   {
     return NULL;
   }
-  if(strlen(index) == 0)
+
+  jutil_map_table_t *table;
+  size_t pos;
+  jutil_map_entry_t *entry = jutil_map_find(map, index, size, jutil_map_hash(map, index, size), &table, &pos);
+  if(entry == NULL)
   {
     return NULL;
   }
-  if(strlen(index) >= JUTIL_MAP_SIZE_INDEX)
+
+  jutil_map_table_erase(table, pos);
+  map->size--;
+
+  if(entry->prev)
   {
-    return NULL;
+    entry->prev->next = entry->next;
   }
-
-  jutil_linkedlist_t *node = jutil_map_getNode(map, index);
-  if(node == NULL)
+  else
   {
-    return NULL;
+    map->head = entry->next;
   }
-
-  jutil_map_data_t *map_data = jutil_linkedlist_removeNode(&map->list, node);
-  if(map_data == NULL)
+  if(entry->next)
   {
-    return NULL;
+    entry->next->prev = entry->prev;
   }
 
-  void *data = map_data->data;
-  free(map_data);
+  void *data = entry->pair.data;
+  jutil_map_entry_free(map, entry);
+
+  jutil_map_migrate(map, JUTIL_MAP_MIGRATE_STEPS);
 
   return data;
 }
@@ -170,20 +513,14 @@ int jutil_map_contains(jutil_map_t *map, const char *index)
   {
     return false;
   }
-  if(index == NULL)
-  {
-    return false;
-  }
-  if(strlen(index) == 0)
-  {
-    return false;
-  }
-  if(strlen(index) >= JUTIL_MAP_SIZE_INDEX)
+
+  size_t size = jutil_map_checkIndex(index);
+  if(size == 0)
   {
     return false;
   }
 
-  if(jutil_map_getNode(map, index))
+  if(jutil_map_find(map, index, size, jutil_map_hash(map, index, size), NULL, NULL))
   {
     return true;
   }
@@ -199,175 +536,419 @@ void *jutil_map_get(jutil_map_t *map, const char *index)
   {
     return NULL;
   }
-  if(index == NULL)
+
+  size_t size = jutil_map_checkIndex(index);
+  if(size == 0)
   {
     return NULL;
   }
-  if(strlen(index) == 0)
+
+  jutil_map_entry_t *entry = jutil_map_find(map, index, size, jutil_map_hash(map, index, size), NULL, NULL);
+  if(entry == NULL)
   {
     return NULL;
   }
-  if(strlen(index) >= JUTIL_MAP_SIZE_INDEX)
+
+  return entry->pair.data;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_map_set(jutil_map_t *map, const char *index, void *data)
+{
+  if(map == NULL)
   {
-    return NULL;
+    return false;
   }
 
-  jutil_linkedlist_t *node = jutil_map_getNode(map, index);
-  if(node == NULL)
+  size_t size = jutil_map_checkIndex(index);
+  if(size == 0)
   {
-    return NULL;
+    return false;
   }
 
-  jutil_map_data_t *map_data = jutil_linkedlist_getData(node);
-  if(map_data == NULL)
+  uint32_t hash = jutil_map_hash(map, index, size);
+  jutil_map_entry_t *entry = jutil_map_find(map, index, size, hash, NULL, NULL);
+  if(entry == NULL)
   {
-    return NULL;
+    return (jutil_map_insert(map, index, size, hash, data) ? true : false);
   }
 
-  return map_data->data;
+  entry->pair.data = data;
+  return true;
 }
 
 //------------------------------------------------------------------------------
 //
-int jutil_map_set(jutil_map_t *map, const char *index, void *data)
+size_t jutil_map_size(jutil_map_t *map)
 {
   if(map == NULL)
   {
-    return false;
+    return 0;
   }
-  if(index == NULL)
+
+  return map->size;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_map_clear(jutil_map_t *map)
+{
+  if(map == NULL)
   {
-    return false;
+    return;
   }
-  if(strlen(index) == 0)
+
+  while(map->head != NULL)
   {
-    return false;
+    jutil_map_entry_t *entry = map->head;
+    map->head = entry->next;
+
+    /* Chunk entries are freed with their chunk. */
+    if(entry->length > JUTIL_MAP_SIZE_INLINE)
+    {
+      jutil_alloc_free(&map->allocator, &jutil_alloc_module, entry);
+    }
   }
-  if(strlen(index) >= JUTIL_MAP_SIZE_INDEX)
+
+  while(map->chunks != NULL)
   {
-    return false;
+    jutil_map_chunk_t *chunk = map->chunks;
+    map->chunks = chunk->next;
+    jutil_alloc_freeAligned(&map->allocator, &jutil_alloc_module, chunk);
   }
 
-  jutil_linkedlist_t *node = jutil_map_getNode(map, index);
-  if(node == NULL)
+  jutil_alloc_free(&map->allocator, &jutil_alloc_module, map->table.slots);
+  jutil_alloc_free(&map->allocator, &jutil_alloc_module, map->old_table.slots);
+
+  uint64_t seed = map->seed;
+  jutil_alloc_allocator_t allocator = map->allocator;
+  memset(map, 0, sizeof(jutil_map_t));
+  map->seed = seed;
+  map->allocator = allocator;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_map_data_t *jutil_map_iterate(jutil_map_t *map, jutil_map_data_t *itr)
+{
+  if(map == NULL)
   {
-    return jutil_map_add(map, index, data);
+    return NULL;
   }
 
-  jutil_map_data_t *map_data = jutil_linkedlist_getData(node);
-  if(map_data == NULL)
+  if(itr == NULL)
   {
-    return false;
+    return (jutil_map_data_t *)map->head;
   }
 
-  map_data->data = data;
-  return true;
+  return (jutil_map_data_t *)((jutil_map_entry_t *)itr)->next;
 }
 
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
 //------------------------------------------------------------------------------
 //
-size_t jutil_map_size(jutil_map_t *map)
+size_t jutil_map_checkIndex(const char *index)
 {
-  if(map == NULL)
+  if(index == NULL)
   {
     return 0;
   }
 
-  if(map->list == NULL)
+  size_t size = strlen(index);
+  if(size >= UINT32_MAX)
   {
     return 0;
   }
 
-  return jutil_linkedlist_size(&map->list);
+  return size;
 }
 
 //------------------------------------------------------------------------------
 //
-void jutil_map_clear(jutil_map_t *map)
+uint32_t jutil_map_hash(jutil_map_t *map, const char *index, size_t size)
 {
-  if(map == NULL)
+  uint64_t hash = jutil_hash64(index, size, map->seed);
+  return (uint32_t)(hash ^ (hash >> 32));
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_map_entry_t *jutil_map_find(jutil_map_t *map, const char *index, size_t size, uint32_t hash, jutil_map_table_t **table, size_t *pos)
+{
+  jutil_map_table_t *search[2] = { &map->table, &map->old_table };
+
+  for(int i = 0; i < 2; i++)
   {
-    return;
+    size_t slot;
+    if(jutil_map_table_find(search[i], index, size, hash, &slot))
+    {
+      if(table)
+      {
+        *table = search[i];
+      }
+      if(pos)
+      {
+        *pos = slot;
+      }
+      return search[i]->slots[slot].entry;
+    }
+  }
+
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_map_table_find(jutil_map_table_t *table, const char *index, size_t size, uint32_t hash, size_t *pos)
+{
+  if(table->count == 0)
+  {
+    return false;
+  }
+
+  size_t mask = table->capacity - 1;
+  size_t slot = hash & mask;
+
+  for(size_t distance = 0; ; distance++)
+  {
+    jutil_map_slot_t *current = &table->slots[slot];
+    if(current->entry == NULL)
+    {
+      return false;
+    }
+
+    /* Entry would be placed before current one, if it was stored. */
+    if(((slot - (current->hash & mask)) & mask) < distance)
+    {
+      return false;
+    }
+
+    if(current->hash == hash && current->entry->length == size && memcmp(current->entry->key, index, size) == 0)
+    {
+      *pos = slot;
+      return true;
+    }
+
+    slot = (slot + 1) & mask;
   }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_map_table_insert(jutil_map_table_t *table, uint32_t hash, jutil_map_entry_t *entry)
+{
+  size_t mask = table->capacity - 1;
+  size_t slot = hash & mask;
+  jutil_map_slot_t insert = { hash, entry };
 
-  while(map->list != NULL)
+  for(size_t distance = 0; ; distance++)
   {
-    jutil_map_data_t *map_data = jutil_linkedlist_pop(&map->list);
-    free(map_data);
+    jutil_map_slot_t *current = &table->slots[slot];
+    if(current->entry == NULL)
+    {
+      *current = insert;
+      table->count++;
+      return;
+    }
+
+    /* Entry closer to its home gives up its slot. */
+    size_t current_distance = (slot - (current->hash & mask)) & mask;
+    if(current_distance < distance)
+    {
+      jutil_map_slot_t swap = *current;
+      *current = insert;
+      insert = swap;
+      distance = current_distance;
+    }
+
+    slot = (slot + 1) & mask;
   }
 }
 
 //------------------------------------------------------------------------------
 //
-jutil_map_data_t *jutil_map_iterate(jutil_map_t *map, jutil_map_data_t *itr)
+void jutil_map_table_erase(jutil_map_table_t *table, size_t pos)
 {
-  if(map == NULL)
+  size_t mask = table->capacity - 1;
+  size_t next = (pos + 1) & mask;
+
+  while(table->slots[next].entry != NULL && ((next - (table->slots[next].hash & mask)) & mask) != 0)
   {
-    return NULL;
+    table->slots[pos] = table->slots[next];
+    pos = next;
+    next = (next + 1) & mask;
   }
 
-  if(itr == NULL)
+  table->slots[pos].entry = NULL;
+  table->count--;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_map_reserve(jutil_map_t *map)
+{
+  jutil_map_table_t *table = &map->table;
+
+  if(map->old_table.slots)
   {
-    return (jutil_map_data_t *)jutil_linkedlist_getData(map->list);
+    jutil_map_migrate(map, JUTIL_MAP_MIGRATE_STEPS);
   }
 
-  jutil_linkedlist_t *node = jutil_map_getNode(map, itr->index);
-  if(node == NULL)
+  if(table->slots && (table->count + 1) * JUTIL_MAP_LOAD_DENOMINATOR <= table->capacity * JUTIL_MAP_LOAD_NUMERATOR)
   {
-    return NULL;
+    return true;
   }
 
-  node = jutil_linkedlist_iterate(node);
-  if(node == NULL)
+  /* Should not happen with enough steps, but last move can not be incremental. */
+  if(map->old_table.slots)
   {
-    return NULL;
+    jutil_map_migrate(map, 0);
   }
 
-  return (jutil_map_data_t *)jutil_linkedlist_getData(node);
-}
+  size_t capacity = (table->slots ? table->capacity * 2 : JUTIL_MAP_CAPACITY_MIN);
+  jutil_map_slot_t *slots = (jutil_map_slot_t *)jutil_alloc_calloc(&map->allocator, &jutil_alloc_module, capacity, sizeof(jutil_map_slot_t));
+  if(slots == NULL)
+  {
+    return false;
+  }
 
+  map->old_table = *table;
+  map->migrate_position = 0;
 
+  table->slots = slots;
+  table->capacity = capacity;
+  table->count = 0;
 
-//==============================================================================
-// Implement internal functions.
-//
+  if(map->old_table.slots && map->old_table.count == 0)
+  {
+    jutil_alloc_free(&map->allocator, &jutil_alloc_module, map->old_table.slots);
+    memset(&map->old_table, 0, sizeof(jutil_map_table_t));
+  }
+
+  return true;
+}
 
 //------------------------------------------------------------------------------
 //
-jutil_linkedlist_t *jutil_map_getNode(jutil_map_t *map, const char *index)
+jutil_map_entry_t *jutil_map_insert(jutil_map_t *map, const char *index, size_t size, uint32_t hash, void *data)
 {
-  if(map == NULL)
+  if(jutil_map_reserve(map) == false)
   {
     return NULL;
   }
-  if(index == NULL)
+
+  jutil_map_entry_t *entry = jutil_map_entry_alloc(map, size);
+  if(entry == NULL)
   {
     return NULL;
   }
-  if(strlen(index) == 0)
+
+  memcpy(entry->key, index, size + 1);
+  entry->pair.index = entry->key;
+  entry->pair.data = data;
+  entry->hash = hash;
+  entry->length = (uint32_t)size;
+
+  /* Newest entry is iterated first. */
+  entry->prev = NULL;
+  entry->next = map->head;
+  if(map->head)
   {
-    return NULL;
+    map->head->prev = entry;
   }
-  if(strlen(index) >= JUTIL_MAP_SIZE_INDEX)
+  map->head = entry;
+
+  jutil_map_table_insert(&map->table, hash, entry);
+  map->size++;
+
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_map_migrate(jutil_map_t *map, size_t steps)
+{
+  jutil_map_table_t *old_table = &map->old_table;
+
+  if(old_table->slots == NULL)
   {
-    return NULL;
+    return;
+  }
+
+  for(size_t i = 0; (steps == 0 || i < steps) && old_table->count > 0; i++)
+  {
+    jutil_map_slot_t *current = &old_table->slots[map->migrate_position];
+    if(current->entry == NULL)
+    {
+      map->migrate_position++;
+      continue;
+    }
+
+    /* Erasing can shift next entry into this slot, so position stays. */
+    jutil_map_table_insert(&map->table, current->hash, current->entry);
+    jutil_map_table_erase(old_table, map->migrate_position);
+  }
+
+  if(old_table->count == 0)
+  {
+    jutil_alloc_free(&map->allocator, &jutil_alloc_module, old_table->slots);
+    memset(old_table, 0, sizeof(jutil_map_table_t));
+    map->migrate_position = 0;
   }
+}
 
-  jutil_linkedlist_t *itr = map->list;
+//------------------------------------------------------------------------------
+//
+jutil_map_entry_t *jutil_map_entry_alloc(jutil_map_t *map, size_t size)
+{
+  if(size > JUTIL_MAP_SIZE_INLINE)
+  {
+    return (jutil_map_entry_t *)jutil_alloc_malloc(&map->allocator, &jutil_alloc_module, offsetof(jutil_map_entry_t, key) + size + 1);
+  }
 
-  while(itr != NULL)
+  if(map->free_entries == NULL)
   {
-    jutil_map_data_t *map_data = jutil_linkedlist_getData(itr);
-    if(map_data)
+    /* First entry of chunk is used for header. */
+    char *memory = (char *)jutil_alloc_mallocAligned(&map->allocator, &jutil_alloc_module, JUTIL_MAP_SIZE_ENTRY, JUTIL_MAP_SIZE_ENTRY * JUTIL_MAP_CHUNK_ENTRIES);
+    if(memory == NULL)
     {
-      if(strcmp(map_data->index, index) == 0)
-      {
-        return itr;
-      }
+      return NULL;
     }
 
-    itr = jutil_linkedlist_iterate(itr);
+    jutil_map_chunk_t *chunk = (jutil_map_chunk_t *)memory;
+    chunk->next = map->chunks;
+    map->chunks = chunk;
+
+    for(size_t i = 1; i < JUTIL_MAP_CHUNK_ENTRIES; i++)
+    {
+      jutil_map_entry_t *entry = (jutil_map_entry_t *)(memory + i * JUTIL_MAP_SIZE_ENTRY);
+      entry->next = map->free_entries;
+      map->free_entries = entry;
+    }
   }
 
-  return NULL;
-}
\ No newline at end of file
+  jutil_map_entry_t *entry = map->free_entries;
+  map->free_entries = entry->next;
+
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_map_entry_free(jutil_map_t *map, jutil_map_entry_t *entry)
+{
+  if(entry->length > JUTIL_MAP_SIZE_INLINE)
+  {
+    jutil_alloc_free(&map->allocator, &jutil_alloc_module, entry);
+    return;
+  }
+
+  entry->next = map->free_entries;
+  map->free_entries = entry;
+}
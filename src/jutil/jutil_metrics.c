@@ -0,0 +1,620 @@
+/**
+ * @file jutil_metrics.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jutil_metrics.
+ * 
+ * Every thread gets a shard index at its first update. Shards
+ * of counters are padded to a cache line each, histogram shards
+ * are allocated at first use. Threads share a shard, if there
+ * are more threads than shards, so shards are always updated
+ * with atomic operations.
+ * 
+ * Registry does not log, because loggers are instrumented too
+ * and would call it recursively.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _POSIX_C_SOURCE 200809L /* needed for strdup() */
+
+#include <jayc/jutil_metrics.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Size of cache line, that shards are padded to.
+ */
+#define JUTIL_METRICS_SIZE_CACHELINE 64
+
+/**
+ * @brief Initial size of format buffer.
+ */
+#define JUTIL_METRICS_SIZE_BUFFER 4096
+
+/**
+ * @brief Metric is a counter.
+ */
+#define JUTIL_METRICS_TYPE_COUNTER 1
+
+/**
+ * @brief Metric is a gauge.
+ */
+#define JUTIL_METRICS_TYPE_GAUGE 2
+
+/**
+ * @brief Metric is a histogram.
+ */
+#define JUTIL_METRICS_TYPE_HISTOGRAM 3
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Registry entry, first member of every metric.
+ */
+typedef struct __jutil_metrics_entry
+{
+  int type;                               /**< Type of metric. */
+  char name[JUTIL_METRICS_SIZE_NAME];     /**< Name with label set. */
+  size_t base_length;                     /**< Length of name without label set. */
+  char *help;                             /**< Description of metric. */
+  struct __jutil_metrics_entry *next;     /**< Next registered metric. */
+} jutil_metrics_entry_t;
+
+/**
+ * @brief Counter shard, padded to one cache line.
+ */
+typedef struct __jutil_metrics_shard
+{
+  atomic_ullong value;                                            /**< Value of shard. */
+  char padding[JUTIL_METRICS_SIZE_CACHELINE - sizeof(atomic_ullong)]; /**< Keeps other shards out of cache line. */
+} jutil_metrics_shard_t;
+
+/**
+ * @brief Counter object.
+ */
+struct __jutil_metrics_counter
+{
+  jutil_metrics_entry_t entry;                        /**< Registry entry. */
+  jutil_metrics_shard_t shards[JUTIL_METRICS_SHARDS]; /**< Values per shard. */
+};
+
+/**
+ * @brief Gauge object.
+ */
+struct __jutil_metrics_gauge
+{
+  jutil_metrics_entry_t entry;  /**< Registry entry. */
+  atomic_llong value;           /**< Value of gauge. */
+};
+
+/**
+ * @brief Histogram object.
+ */
+struct __jutil_metrics_histogram
+{
+  jutil_metrics_entry_t entry;                                  /**< Registry entry. */
+  _Atomic(jutil_time_histogram_t *) shards[JUTIL_METRICS_SHARDS]; /**< Histograms per shard, @c NULL until used. */
+};
+
+/**
+ * @brief Growing text buffer for format.
+ */
+typedef struct __jutil_metrics_buffer
+{
+  char *data;     /**< Text. */
+  size_t length;  /**< Length of text. */
+  size_t size;    /**< Allocated size. */
+  int failed;     /**< @c true , if memory could not be allocated. */
+} jutil_metrics_buffer_t;
+
+static pthread_mutex_t jutil_metrics_mutex = PTHREAD_MUTEX_INITIALIZER; /**< Protects registry. */
+static jutil_metrics_entry_t *jutil_metrics_head = NULL;                /**< First registered metric. */
+static jutil_metrics_entry_t *jutil_metrics_tail = NULL;                /**< Last registered metric. */
+static atomic_uint jutil_metrics_shard_next = 0;                        /**< Shard for next new thread. */
+static _Thread_local int jutil_metrics_shard = -1;                      /**< Shard of calling thread. */
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Returns metric with name, creates it if needed.
+ * 
+ * @param name  Metric name with optional label set.
+ * @param help  Description of metric.
+ * @param type  Type of metric.
+ * @param size  Size of metric object.
+ * 
+ * @return      Registry entry of metric.
+ * @return      @c NULL , if name is invalid, used by other
+ *              type, or memory could not be allocated.
+ */
+static jutil_metrics_entry_t *jutil_metrics_register(const char *name, const char *help, int type, size_t size);
+
+/**
+ * @brief Checks metric name.
+ * 
+ * @param name  Name to check.
+ * 
+ * @return      Length of name without label set.
+ * @return      @c 0 , if name is invalid.
+ */
+static size_t jutil_metrics_checkName(const char *name);
+
+/**
+ * @brief Returns shard of calling thread.
+ * 
+ * @return  Shard index.
+ */
+static int jutil_metrics_getShard(void);
+
+/**
+ * @brief Appends formatted text to buffer.
+ * 
+ * @param buffer  Buffer to append to.
+ * @param fmt     Format string.
+ * @param ...     Format arguments.
+ */
+static void jutil_metrics_append(jutil_metrics_buffer_t *buffer, const char *fmt, ...) __attribute__ ((format (printf, 2, 3)));
+
+/**
+ * @brief Appends samples of metric to buffer.
+ * 
+ * @param buffer  Buffer to append to.
+ * @param entry   Metric to format.
+ */
+static void jutil_metrics_formatEntry(jutil_metrics_buffer_t *buffer, jutil_metrics_entry_t *entry);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_metrics_counter_t *jutil_metrics_counter(const char *name, const char *help)
+{
+  return (jutil_metrics_counter_t *)jutil_metrics_register(name, help, JUTIL_METRICS_TYPE_COUNTER, sizeof(jutil_metrics_counter_t));
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_metrics_gauge_t *jutil_metrics_gauge(const char *name, const char *help)
+{
+  return (jutil_metrics_gauge_t *)jutil_metrics_register(name, help, JUTIL_METRICS_TYPE_GAUGE, sizeof(jutil_metrics_gauge_t));
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_metrics_histogram_t *jutil_metrics_histogram(const char *name, const char *help)
+{
+  return (jutil_metrics_histogram_t *)jutil_metrics_register(name, help, JUTIL_METRICS_TYPE_HISTOGRAM, sizeof(jutil_metrics_histogram_t));
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_metrics_counter_add(jutil_metrics_counter_t *counter, unsigned long long value)
+{
+  if(counter == NULL)
+  {
+    return;
+  }
+
+  atomic_fetch_add_explicit(&counter->shards[jutil_metrics_getShard()].value, value, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_metrics_counter_get(jutil_metrics_counter_t *counter)
+{
+  if(counter == NULL)
+  {
+    return 0;
+  }
+
+  unsigned long long value = 0;
+  for(int i = 0; i < JUTIL_METRICS_SHARDS; i++)
+  {
+    value += atomic_load_explicit(&counter->shards[i].value, memory_order_relaxed);
+  }
+
+  return value;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_metrics_gauge_set(jutil_metrics_gauge_t *gauge, long long value)
+{
+  if(gauge == NULL)
+  {
+    return;
+  }
+
+  atomic_store_explicit(&gauge->value, value, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_metrics_gauge_add(jutil_metrics_gauge_t *gauge, long long value)
+{
+  if(gauge == NULL)
+  {
+    return;
+  }
+
+  atomic_fetch_add_explicit(&gauge->value, value, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+long long jutil_metrics_gauge_get(jutil_metrics_gauge_t *gauge)
+{
+  if(gauge == NULL)
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&gauge->value, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_metrics_histogram_record(jutil_metrics_histogram_t *histogram, unsigned long long value)
+{
+  if(histogram == NULL)
+  {
+    return;
+  }
+
+  int shard = jutil_metrics_getShard();
+  jutil_time_histogram_t *target = atomic_load_explicit(&histogram->shards[shard], memory_order_acquire);
+
+  if(target == NULL)
+  {
+    jutil_time_histogram_t *expected = NULL;
+
+    target = jutil_time_histogram_init();
+    if(target == NULL)
+    {
+      return;
+    }
+
+    /* Other thread of same shard may have been faster. */
+    if(atomic_compare_exchange_strong_explicit(&histogram->shards[shard], &expected, target, memory_order_acq_rel, memory_order_acquire) == false)
+    {
+      jutil_time_histogram_free(target);
+      target = expected;
+    }
+  }
+
+  jutil_time_histogram_recordAtomic(target, value);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_metrics_histogram_merge(jutil_metrics_histogram_t *histogram, jutil_time_histogram_t *dest)
+{
+  if(histogram == NULL || dest == NULL)
+  {
+    return false;
+  }
+
+  for(int i = 0; i < JUTIL_METRICS_SHARDS; i++)
+  {
+    jutil_time_histogram_t *shard = atomic_load_explicit(&histogram->shards[i], memory_order_acquire);
+    if(shard)
+    {
+      jutil_time_histogram_merge(dest, shard);
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+char *jutil_metrics_format(size_t *length)
+{
+  jutil_metrics_buffer_t buffer = { NULL, 0, 0, false };
+
+  buffer.data = (char *)malloc(JUTIL_METRICS_SIZE_BUFFER);
+  if(buffer.data == NULL)
+  {
+    return NULL;
+  }
+  buffer.size = JUTIL_METRICS_SIZE_BUFFER;
+  buffer.data[0] = 0;
+
+  pthread_mutex_lock(&jutil_metrics_mutex);
+
+  for(jutil_metrics_entry_t *entry = jutil_metrics_head; entry; entry = entry->next)
+  {
+    /* Samples of one family are written together with its first entry. */
+    int first = true;
+    for(jutil_metrics_entry_t *previous = jutil_metrics_head; previous != entry; previous = previous->next)
+    {
+      if(previous->base_length == entry->base_length && strncmp(previous->name, entry->name, entry->base_length) == 0)
+      {
+        first = false;
+        break;
+      }
+    }
+    if(first == false)
+    {
+      continue;
+    }
+
+    const char *type = "counter";
+    if(entry->type == JUTIL_METRICS_TYPE_GAUGE)
+    {
+      type = "gauge";
+    }
+    else if(entry->type == JUTIL_METRICS_TYPE_HISTOGRAM)
+    {
+      type = "summary";
+    }
+
+    jutil_metrics_append(&buffer, "# HELP %.*s %s\n", (int)entry->base_length, entry->name, entry->help);
+    jutil_metrics_append(&buffer, "# TYPE %.*s %s\n", (int)entry->base_length, entry->name, type);
+
+    for(jutil_metrics_entry_t *member = entry; member; member = member->next)
+    {
+      if(member->base_length == entry->base_length && strncmp(member->name, entry->name, entry->base_length) == 0)
+      {
+        jutil_metrics_formatEntry(&buffer, member);
+      }
+    }
+  }
+
+  pthread_mutex_unlock(&jutil_metrics_mutex);
+
+  if(buffer.failed)
+  {
+    free(buffer.data);
+    return NULL;
+  }
+
+  if(length)
+  {
+    *length = buffer.length;
+  }
+
+  return buffer.data;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_metrics_entry_t *jutil_metrics_register(const char *name, const char *help, int type, size_t size)
+{
+  size_t base_length = jutil_metrics_checkName(name);
+  if(base_length == 0)
+  {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&jutil_metrics_mutex);
+
+  for(jutil_metrics_entry_t *entry = jutil_metrics_head; entry; entry = entry->next)
+  {
+    if(strcmp(entry->name, name) == 0)
+    {
+      pthread_mutex_unlock(&jutil_metrics_mutex);
+      return (entry->type == type ? entry : NULL);
+    }
+
+    /* Family has one type, so Prometheus can parse it. */
+    if(entry->base_length == base_length && strncmp(entry->name, name, base_length) == 0 && entry->type != type)
+    {
+      pthread_mutex_unlock(&jutil_metrics_mutex);
+      return NULL;
+    }
+  }
+
+  /* Size is rounded up to cache line for aligned_alloc(). */
+  size_t alloc_size = (size + JUTIL_METRICS_SIZE_CACHELINE - 1) / JUTIL_METRICS_SIZE_CACHELINE * JUTIL_METRICS_SIZE_CACHELINE;
+  jutil_metrics_entry_t *entry = (jutil_metrics_entry_t *)aligned_alloc(JUTIL_METRICS_SIZE_CACHELINE, alloc_size);
+  if(entry == NULL)
+  {
+    pthread_mutex_unlock(&jutil_metrics_mutex);
+    return NULL;
+  }
+  memset(entry, 0, alloc_size);
+
+  entry->help = strdup(help ? help : "");
+  if(entry->help == NULL)
+  {
+    free(entry);
+    pthread_mutex_unlock(&jutil_metrics_mutex);
+    return NULL;
+  }
+
+  entry->type = type;
+  strcpy(entry->name, name);
+  entry->base_length = base_length;
+  entry->next = NULL;
+
+  if(jutil_metrics_tail)
+  {
+    jutil_metrics_tail->next = entry;
+  }
+  else
+  {
+    jutil_metrics_head = entry;
+  }
+  jutil_metrics_tail = entry;
+
+  pthread_mutex_unlock(&jutil_metrics_mutex);
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_metrics_checkName(const char *name)
+{
+  if(name == NULL || strlen(name) >= JUTIL_METRICS_SIZE_NAME)
+  {
+    return 0;
+  }
+
+  size_t length = 0;
+  while(name[length] == '_' || name[length] == ':'
+    || (name[length] >= 'a' && name[length] <= 'z')
+    || (name[length] >= 'A' && name[length] <= 'Z')
+    || (length > 0 && name[length] >= '0' && name[length] <= '9'))
+  {
+    length++;
+  }
+
+  if(length == 0)
+  {
+    return 0;
+  }
+
+  /* Label set has to close at end of name. */
+  if(name[length] == '{')
+  {
+    size_t end = strlen(name);
+    if(end < length + 2 || name[end - 1] != '}')
+    {
+      return 0;
+    }
+  }
+  else if(name[length] != 0)
+  {
+    return 0;
+  }
+
+  return length;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_metrics_getShard(void)
+{
+  if(jutil_metrics_shard < 0)
+  {
+    jutil_metrics_shard = (int)(atomic_fetch_add_explicit(&jutil_metrics_shard_next, 1, memory_order_relaxed) % JUTIL_METRICS_SHARDS);
+  }
+
+  return jutil_metrics_shard;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_metrics_append(jutil_metrics_buffer_t *buffer, const char *fmt, ...)
+{
+  if(buffer->failed)
+  {
+    return;
+  }
+
+  va_list args;
+  va_start(args, fmt);
+  int written = vsnprintf(buffer->data + buffer->length, buffer->size - buffer->length, fmt, args);
+  va_end(args);
+
+  if(written < 0)
+  {
+    buffer->failed = true;
+    return;
+  }
+
+  if((size_t)written >= buffer->size - buffer->length)
+  {
+    size_t size = buffer->size * 2;
+    while(size - buffer->length <= (size_t)written)
+    {
+      size *= 2;
+    }
+
+    char *data = (char *)realloc(buffer->data, size);
+    if(data == NULL)
+    {
+      buffer->failed = true;
+      return;
+    }
+    buffer->data = data;
+    buffer->size = size;
+
+    va_start(args, fmt);
+    vsnprintf(buffer->data + buffer->length, buffer->size - buffer->length, fmt, args);
+    va_end(args);
+  }
+
+  buffer->length += (size_t)written;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_metrics_formatEntry(jutil_metrics_buffer_t *buffer, jutil_metrics_entry_t *entry)
+{
+  if(entry->type == JUTIL_METRICS_TYPE_COUNTER)
+  {
+    jutil_metrics_append(buffer, "%s %llu\n", entry->name, jutil_metrics_counter_get((jutil_metrics_counter_t *)entry));
+    return;
+  }
+
+  if(entry->type == JUTIL_METRICS_TYPE_GAUGE)
+  {
+    jutil_metrics_append(buffer, "%s %lld\n", entry->name, jutil_metrics_gauge_get((jutil_metrics_gauge_t *)entry));
+    return;
+  }
+
+  jutil_time_histogram_t *merged = jutil_time_histogram_init();
+  if(merged == NULL)
+  {
+    buffer->failed = true;
+    return;
+  }
+  jutil_metrics_histogram_merge((jutil_metrics_histogram_t *)entry, merged);
+
+  /* Labels without braces, to add quantile label. */
+  const char *labels = entry->name + entry->base_length;
+  int labels_length = 0;
+  if(labels[0] == '{')
+  {
+    labels++;
+    labels_length = (int)strlen(labels) - 1;
+  }
+
+  static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+  for(size_t i = 0; i < sizeof(quantiles) / sizeof(quantiles[0]); i++)
+  {
+    jutil_metrics_append(buffer, "%.*s{%.*s%squantile=\"%g\"} %.9g\n",
+      (int)entry->base_length, entry->name,
+      labels_length, labels, (labels_length ? "," : ""),
+      quantiles[i], (double)jutil_time_histogram_getPercentile(merged, quantiles[i] * 100.0) / 1e9);
+  }
+
+  jutil_metrics_append(buffer, "%.*s_sum%s %.9g\n", (int)entry->base_length, entry->name, entry->name + entry->base_length,
+    jutil_time_histogram_getMean(merged) * (double)jutil_time_histogram_getCount(merged) / 1e9);
+  jutil_metrics_append(buffer, "%.*s_count%s %llu\n", (int)entry->base_length, entry->name, entry->name + entry->base_length,
+    jutil_time_histogram_getCount(merged));
+
+  jutil_time_histogram_free(merged);
+}
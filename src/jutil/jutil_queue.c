@@ -0,0 +1,468 @@
+/**
+ * @file jutil_queue.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implements jutil_queue.
+ * 
+ * Head (consumer) and tail (producers) indices grow
+ * without limit and are masked to get cells. Both are
+ * on separate cache lines.
+ * 
+ * SPSC producer and consumer each keep a copy of the
+ * other index and only read the shared one, when the
+ * copy says the queue is full or empty.
+ * 
+ * MPSC producers reserve cells by moving the tail and
+ * mark each cell as filled with a sequence number,
+ * so the consumer does not read cells, that are reserved,
+ * but not written yet.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#include <jayc/jutil_queue.h>
+#include <jayc/jutil_alloc.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_queue");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Size of a cache line. Indices are aligned to it.
+ */
+#define JUTIL_QUEUE_SIZE_CACHELINE 64
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Cell of ring buffer.
+ */
+typedef struct __jutil_queue_cell
+{
+  atomic_size_t sequence;   /**< MPSC: index + 1 , when cell was filled. Unused for SPSC. */
+  void *item;               /**< Queued item. */
+} jutil_queue_cell_t;
+
+/**
+ * @brief Object pointer.
+ */
+struct __jutil_queue
+{
+  _Alignas(JUTIL_QUEUE_SIZE_CACHELINE)
+  atomic_size_t tail;         /**< Next index to fill. */
+  size_t head_cache;          /**< SPSC: Copy of @c head , used by producer. */
+
+  _Alignas(JUTIL_QUEUE_SIZE_CACHELINE)
+  atomic_size_t head;         /**< Next index to take. */
+  size_t tail_cache;          /**< SPSC: Copy of @c tail , used by consumer. */
+
+  _Alignas(JUTIL_QUEUE_SIZE_CACHELINE)
+  atomic_int waiting;         /**< Consumer waits for notification. */
+  jutil_thread_t *consumer;   /**< Thread to notify. */
+  jutil_queue_cell_t *cells;  /**< Ring buffer. */
+  size_t capacity;            /**< Number of cells. Power of 2. */
+  int type;                   /**< SPSC or MPSC. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Reserves cells for SPSC producer.
+ * 
+ * @param queue  Queue object.
+ * @param number Number of cells wanted.
+ * @param index  Returns first reserved index.
+ * 
+ * @return       Number of reserved cells.
+ */
+static size_t jutil_queue_reserveSPSC(jutil_queue_t *queue, size_t number, size_t *index);
+
+/**
+ * @brief Reserves cells for MPSC producer.
+ * 
+ * @param queue  Queue object.
+ * @param number Number of cells wanted.
+ * @param index  Returns first reserved index.
+ * 
+ * @return       Number of reserved cells.
+ */
+static size_t jutil_queue_reserveMPSC(jutil_queue_t *queue, size_t number, size_t *index);
+
+/**
+ * @brief Checks, if consumer can take an item.
+ * 
+ * Only called by consumer.
+ * 
+ * @param queue Queue object.
+ * 
+ * @return      @c true , if item is ready.
+ * @return      @c false , if queue is empty.
+ */
+static int jutil_queue_hasItem(jutil_queue_t *queue);
+
+/**
+ * @brief Notifies consumer, if it is waiting.
+ * 
+ * Called after items were added.
+ * 
+ * @param queue Queue object.
+ */
+static void jutil_queue_notify(jutil_queue_t *queue);
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_queue_t *jutil_queue_init(int type, size_t capacity)
+{
+  if(type != JUTIL_QUEUE_TYPE_SPSC && type != JUTIL_QUEUE_TYPE_MPSC)
+  {
+    return NULL;
+  }
+
+  if(capacity == 0 || capacity > (SIZE_MAX / 2) / sizeof(jutil_queue_cell_t))
+  {
+    return NULL;
+  }
+
+  size_t size = 1;
+  while(size < capacity)
+  {
+    size *= 2;
+  }
+
+  jutil_queue_t *queue = (jutil_queue_t *)JUTIL_ALLOC_MALLOC_ALIGNED(JUTIL_QUEUE_SIZE_CACHELINE, sizeof(jutil_queue_t));
+  if(queue == NULL)
+  {
+    return NULL;
+  }
+
+  queue->cells = (jutil_queue_cell_t *)JUTIL_ALLOC_MALLOC(size * sizeof(jutil_queue_cell_t));
+  if(queue->cells == NULL)
+  {
+    JUTIL_ALLOC_FREE_ALIGNED(queue);
+    return NULL;
+  }
+
+  for(size_t i = 0; i < size; i++)
+  {
+    atomic_init(&queue->cells[i].sequence, i);
+    queue->cells[i].item = NULL;
+  }
+
+  atomic_init(&queue->tail, 0);
+  atomic_init(&queue->head, 0);
+  atomic_init(&queue->waiting, false);
+  queue->head_cache = 0;
+  queue->tail_cache = 0;
+  queue->consumer = NULL;
+  queue->capacity = size;
+  queue->type = type;
+
+  return queue;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_queue_free(jutil_queue_t *queue)
+{
+  if(queue == NULL)
+  {
+    return;
+  }
+
+  JUTIL_ALLOC_FREE(queue->cells);
+  JUTIL_ALLOC_FREE_ALIGNED(queue);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_queue_setConsumer(jutil_queue_t *queue, jutil_thread_t *thread)
+{
+  if(queue == NULL)
+  {
+    return;
+  }
+
+  queue->consumer = thread;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_queue_push(jutil_queue_t *queue, void *item)
+{
+  if(item == NULL)
+  {
+    return false;
+  }
+
+  return (jutil_queue_pushBatch(queue, &item, 1) == 1);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_queue_pushBatch(jutil_queue_t *queue, void **items, size_t number)
+{
+  if(queue == NULL || items == NULL || number == 0)
+  {
+    return 0;
+  }
+
+  size_t index;
+  size_t reserved;
+  if(queue->type == JUTIL_QUEUE_TYPE_SPSC)
+  {
+    reserved = jutil_queue_reserveSPSC(queue, number, &index);
+  }
+  else
+  {
+    reserved = jutil_queue_reserveMPSC(queue, number, &index);
+  }
+
+  if(reserved == 0)
+  {
+    return 0;
+  }
+
+  size_t mask = queue->capacity - 1;
+  for(size_t i = 0; i < reserved; i++)
+  {
+    jutil_queue_cell_t *cell = &queue->cells[(index + i) & mask];
+    cell->item = items[i];
+
+    if(queue->type == JUTIL_QUEUE_TYPE_MPSC)
+    {
+      atomic_store_explicit(&cell->sequence, index + i + 1, memory_order_release);
+    }
+  }
+
+  if(queue->type == JUTIL_QUEUE_TYPE_SPSC)
+  {
+    atomic_store_explicit(&queue->tail, index + reserved, memory_order_release);
+  }
+
+  jutil_queue_notify(queue);
+  return reserved;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_queue_pop(jutil_queue_t *queue)
+{
+  void *item;
+  if(jutil_queue_popBatch(queue, &item, 1) == 0)
+  {
+    return NULL;
+  }
+
+  return item;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_queue_popBatch(jutil_queue_t *queue, void **items, size_t number)
+{
+  if(queue == NULL || items == NULL)
+  {
+    return 0;
+  }
+
+  size_t mask = queue->capacity - 1;
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+  size_t taken = 0;
+
+  if(queue->type == JUTIL_QUEUE_TYPE_SPSC)
+  {
+    if(queue->tail_cache - head < number)
+    {
+      queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    }
+
+    size_t available = queue->tail_cache - head;
+    taken = (available < number ? available : number);
+
+    for(size_t i = 0; i < taken; i++)
+    {
+      items[i] = queue->cells[(head + i) & mask].item;
+    }
+  }
+  else
+  {
+    for(; taken < number; taken++)
+    {
+      jutil_queue_cell_t *cell = &queue->cells[(head + taken) & mask];
+      if(atomic_load_explicit(&cell->sequence, memory_order_acquire) != head + taken + 1)
+      {
+        break;
+      }
+
+      items[taken] = cell->item;
+
+      /* Value is never expected by consumer, until cell is filled again. */
+      atomic_store_explicit(&cell->sequence, head + taken, memory_order_relaxed);
+    }
+  }
+
+  if(taken > 0)
+  {
+    /* Producers may reuse cells, after items were read. */
+    atomic_store_explicit(&queue->head, head + taken, memory_order_release);
+  }
+
+  return taken;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_queue_prepareWait(jutil_queue_t *queue)
+{
+  if(queue == NULL)
+  {
+    return false;
+  }
+
+  atomic_store_explicit(&queue->waiting, true, memory_order_relaxed);
+
+  /* Producers either see the flag or their items are seen here. */
+  atomic_thread_fence(memory_order_seq_cst);
+
+  if(jutil_queue_hasItem(queue) == false)
+  {
+    return true;
+  }
+
+  if(atomic_exchange(&queue->waiting, false) && queue->consumer)
+  {
+    jutil_thread_notify(queue->consumer);
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_queue_size(jutil_queue_t *queue)
+{
+  if(queue == NULL)
+  {
+    return 0;
+  }
+
+  size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+  /* Head can be newer than tail, if read in between. */
+  if(tail < head)
+  {
+    return 0;
+  }
+
+  return tail - head;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_queue_reserveSPSC(jutil_queue_t *queue, size_t number, size_t *index)
+{
+  size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+  if(queue->capacity - (tail - queue->head_cache) < number)
+  {
+    queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+  }
+
+  size_t available = queue->capacity - (tail - queue->head_cache);
+
+  *index = tail;
+  return (available < number ? available : number);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_queue_reserveMPSC(jutil_queue_t *queue, size_t number, size_t *index)
+{
+  for(;;)
+  {
+    /* Head is read first, so it is never newer than tail. */
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    size_t available = queue->capacity - (tail - head);
+    if(available == 0)
+    {
+      return 0;
+    }
+
+    size_t reserved = (available < number ? available : number);
+    if(atomic_compare_exchange_weak_explicit(&queue->tail, &tail, tail + reserved, memory_order_relaxed, memory_order_relaxed))
+    {
+      *index = tail;
+      return reserved;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_queue_hasItem(jutil_queue_t *queue)
+{
+  size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+  if(queue->type == JUTIL_QUEUE_TYPE_SPSC)
+  {
+    return (atomic_load_explicit(&queue->tail, memory_order_acquire) != head);
+  }
+
+  jutil_queue_cell_t *cell = &queue->cells[head & (queue->capacity - 1)];
+  return (atomic_load_explicit(&cell->sequence, memory_order_acquire) == head + 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_queue_notify(jutil_queue_t *queue)
+{
+  if(queue->consumer == NULL)
+  {
+    return;
+  }
+
+  /* Pairs with fence in jutil_queue_prepareWait(). */
+  atomic_thread_fence(memory_order_seq_cst);
+
+  if(atomic_load_explicit(&queue->waiting, memory_order_relaxed) && atomic_exchange(&queue->waiting, false))
+  {
+    jutil_thread_notify(queue->consumer);
+  }
+}
@@ -9,14 +9,34 @@
  * 
  */
 
+#define _GNU_SOURCE /* needed for pthread_condattr_setclock(), pthread_attr_setaffinity_np() and pthread_setname_np() */
+
 #include <jayc/jutil_thread.h>
 #include <jayc/jutil_time.h>
+#include <jayc/jutil_metrics.h>
+#include <jayc/jutil_alloc.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <errno.h>
+#include <signal.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
+#include <limits.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_thread");
+
+
 
 //==============================================================================
 // Define constants.
@@ -42,6 +62,11 @@
  */
 #define JUTIL_THREAD_STATE_FINISHED 3
 
+/**
+ * @brief Max. length of thread name, including terminating zero.
+ */
+#define JUTIL_THREAD_SIZE_NAME 16
+
 
 
 //==============================================================================
@@ -59,6 +84,15 @@
  */
 static void *jutil_thread_pthread_handler(void *ctx);
 
+/**
+ * @brief Waits between loop executions.
+ * 
+ * Applies wait policy of session.
+ * 
+ * @param session Session of calling thread.
+ */
+static void jutil_thread_wait(jutil_thread_t *session);
+
 /**
  * @brief Sends log messages to logger with session data.
  * 
@@ -100,44 +134,93 @@ static int jutil_thread_pthread_create(jutil_thread_t *session);
  */
 static void jutil_thread_pthread_join(jutil_thread_t *session);
 
+/**
+ * @brief Initializes pthread attributes from thread options.
+ * 
+ * Manages error handling.
+ * 
+ * @param session Session with thread options.
+ * @param attr    Attributes to initialize.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jutil_thread_pattr_init(jutil_thread_t *session, pthread_attr_t *attr);
+
+/**
+ * @brief Applies options, that can only be set by thread itself.
+ * 
+ * Sets name and nice value. Errors are logged,
+ * thread keeps running.
+ * 
+ * @param session Session of calling thread.
+ */
+static void jutil_thread_applyOptions(jutil_thread_t *session);
+
 /**
  * @brief Initializes pthread_mutex instance.
  * 
  * Manages error handling.
  * 
- * @param session Session with pthread_mutex to create.
+ * @param session Session for log messages.
+ * @param mutex   pthread_mutex to create.
  * 
  * @return        @c true , if successful.
  * @return        @c false , if error occured.
  */
-static int jutil_thread_pmutex_init(jutil_thread_t *session);
+static int jutil_thread_pmutex_init(jutil_thread_t *session, pthread_mutex_t *mutex);
 
 /**
  * @brief Destroys pthread_mutex.
  * 
  * Manages error handling.
  * 
- * @param session Session with pthread_mutex to destroy.
+ * @param session Session for log messages.
+ * @param mutex   pthread_mutex to destroy.
  */
-static void jutil_thread_pmutex_destroy(jutil_thread_t *session);
+static void jutil_thread_pmutex_destroy(jutil_thread_t *session, pthread_mutex_t *mutex);
 
 /**
  * @brief Locks pthread_mutex.
  * 
  * Manages error handling.
  * 
- * @param session Session with pthread_mutex.
+ * @param mutex pthread_mutex to lock.
  */
-static void jutil_thread_pmutex_lock(jutil_thread_t *session);
+static void jutil_thread_pmutex_lock(pthread_mutex_t *mutex);
 
 /**
  * @brief Unlocks pthread_mutex.
  * 
  * Manages error handling.
  * 
- * @param session Session with pthread_mutex.
+ * @param mutex pthread_mutex to unlock.
+ */
+static void jutil_thread_pmutex_unlock(pthread_mutex_t *mutex);
+
+/**
+ * @brief Initializes pthread_rwlock instance for user data.
+ * 
+ * Manages error handling.
+ * 
+ * @param session Session with pthread_rwlock to create.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jutil_thread_prwlock_init(jutil_thread_t *session);
+
+/**
+ * @brief Initializes pthread_cond instance for notifications.
+ * 
+ * Uses monotonic clock for timed waits.
+ * 
+ * @param session Session with pthread_cond to create.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
  */
-static void jutil_thread_pmutex_unlock(jutil_thread_t *session);
+static int jutil_thread_pcond_init(jutil_thread_t *session);
 
 
 
@@ -145,15 +228,20 @@ static void jutil_thread_pmutex_unlock(jutil_thread_t *session);
 // Define log macros.
 //
 
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(ctx, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((ctx ? ctx->logger : NULL), log_type))
+
 #ifdef JUTIL_NO_DEBUG /* Allow to disable debug messages at compile time. */
   #define DEBUG(ctx, fmt, ...)
 #else
-  #define DEBUG(ctx, fmt, ...) jutil_thread_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+  #define DEBUG(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_DEBUG) ? jutil_thread_log(ctx, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #endif
-#define INFO(ctx, fmt, ...) jutil_thread_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define WARN(ctx, fmt, ...) jutil_thread_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define ERROR(ctx, fmt, ...) jutil_thread_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
-#define CRITICAL(ctx, fmt, ...)jutil_thread_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+#define INFO(ctx, fmt, ...) (LOG_ENABLED(ctx, JLOG_LOGTYPE_INFO) ? jutil_thread_log(ctx, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jutil_thread_log(ctx, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jutil_thread_log(ctx, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(ctx, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jutil_thread_log(ctx, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
 #define FATAL(ctx, fmt, ...) jutil_thread_log(ctx, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
 
 //==============================================================================
@@ -167,20 +255,34 @@ static void jutil_thread_pmutex_unlock(jutil_thread_t *session);
 struct __jutil_thread_session
 {
   pthread_t thread;                           /**< pthread instance. */
-  pthread_mutex_t mutex;                      /**< pthread_mutex instance. */
+  pthread_mutex_t mutex;                      /**< User mutex, see @c #jutil_thread_lockMutex() . Not used internally. */
+  pthread_rwlock_t rwlock;                    /**< User reader-writer lock, see @c #jutil_thread_lockRead() . */
+  pthread_mutex_t wait_mutex;                 /**< Protects waiting on @c cond_notify . */
+  pthread_cond_t cond_notify;                 /**< Signaled by @c #jutil_thread_notify() and @c #jutil_thread_stop() . */
   jutil_thread_loop_function_t loop_function; /**< User provided function to run in loop. */
   
   long sleep_secs;                            /**< How long the loop will wait (in seconds), before continuing. */
   long sleep_nsecs;                           /**< Additional nanoseconds to wait before continuing. */
+  atomic_int wait_policy;                     /**< How thread waits between loop executions. */
+  atomic_int notify_pending;                  /**< Set by @c #jutil_thread_notify() , reset after wait. */
+  atomic_int waiting;                         /**< @c true , while thread waits on @c cond_notify . */
   
   jlog_t *logger;                             /**< Logger used for debug and error messages. */
 
-  int thread_state;                           /**< State of thread. Enumeration with following values:
+  size_t stack_size;                          /**< Stack size of thread. @c 0 for default. */
+  cpu_set_t cpus;                             /**< CPUs thread may run on. */
+  int has_cpus;                               /**< @c true , if thread is pinned to @c cpus . */
+  int policy;                                 /**< Scheduling policy (f.ex. @c #JUTIL_THREAD_SCHED_FIFO ). */
+  int priority;                               /**< Real time priority. */
+  int nice;                                   /**< Nice value of thread. */
+  char name[JUTIL_THREAD_SIZE_NAME];          /**< Thread name. Empty for no name. */
+
+  atomic_int thread_state;                    /**< State of thread. Enumeration with following values:
                                                    * @c #JUTIL_THREAD_STATE_STOPPED
                                                    * @c #JUTIL_THREAD_STATE_INIT
                                                    * @c #JUTIL_THREAD_STATE_RUNNING
                                                    * @c #JUTIL_THREAD_STATE_FINISHED */
-  int run_signal;                             /**< If set to 0, the thread will stop. */
+  atomic_int run_signal;                      /**< If set to 0, the thread will stop. */
   
   void *ctx;                                  /**< Context provided to @c #loop_function() . */
 };
@@ -194,6 +296,13 @@ struct __jutil_thread_session
 //------------------------------------------------------------------------------
 //
 jutil_thread_t *jutil_thread_init(jutil_thread_loop_function_t function, jlog_t *logger, long sleep_s, long sleep_ns, void *ctx)
+{
+  return jutil_thread_options_init(function, logger, sleep_s, sleep_ns, ctx, NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_thread_t *jutil_thread_options_init(jutil_thread_loop_function_t function, jlog_t *logger, long sleep_s, long sleep_ns, void *ctx, const jutil_thread_options_t *options)
 {
   if(function == NULL)
   {
@@ -201,7 +310,7 @@ jutil_thread_t *jutil_thread_init(jutil_thread_loop_function_t function, jlog_t
     return NULL;
   }
 
-  jutil_thread_t *session = (jutil_thread_t *)malloc(sizeof(jutil_thread_t));
+  jutil_thread_t *session = (jutil_thread_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_thread_t));
   if(session == NULL)
   {
     ERROR(NULL, "malloc() failed.");
@@ -212,14 +321,100 @@ jutil_thread_t *jutil_thread_init(jutil_thread_loop_function_t function, jlog_t
   session->loop_function = function;
   session->sleep_secs = sleep_s;
   session->sleep_nsecs = sleep_ns;
+  atomic_init(&session->notify_pending, false);
+  atomic_init(&session->waiting, false);
+  atomic_init(&session->run_signal, false);
   session->logger = logger;
-  session->thread_state = JUTIL_THREAD_STATE_STOPPED;
+  atomic_init(&session->thread_state, JUTIL_THREAD_STATE_STOPPED);
   session->ctx = ctx;
+  session->stack_size = 0;
+  CPU_ZERO(&session->cpus);
+  session->has_cpus = false;
+  session->policy = JUTIL_THREAD_SCHED_OTHER;
+  session->priority = 0;
+  session->nice = 0;
+  session->name[0] = 0;
+
+  if(options)
+  {
+    if(options->policy != JUTIL_THREAD_SCHED_OTHER && options->policy != JUTIL_THREAD_SCHED_FIFO && options->policy != JUTIL_THREAD_SCHED_RR)
+    {
+      ERROR(NULL, "Invalid scheduling policy [%d].", options->policy);
+      JUTIL_ALLOC_FREE(session);
+      return NULL;
+    }
+
+    if(options->cpu_count > 0 && options->cpus == NULL)
+    {
+      ERROR(NULL, "No CPUs given.");
+      JUTIL_ALLOC_FREE(session);
+      return NULL;
+    }
+
+    for(size_t i = 0; i < options->cpu_count; i++)
+    {
+      if(options->cpus[i] < 0 || options->cpus[i] >= CPU_SETSIZE)
+      {
+        ERROR(NULL, "Invalid CPU [%d].", options->cpus[i]);
+        JUTIL_ALLOC_FREE(session);
+        return NULL;
+      }
+
+      CPU_SET(options->cpus[i], &session->cpus);
+      session->has_cpus = true;
+    }
+
+    session->stack_size = options->stack_size;
+    session->policy = options->policy;
+    session->priority = options->priority;
+    session->nice = options->nice;
+
+    if(options->name)
+    {
+      snprintf(session->name, sizeof(session->name), "%s", options->name);
+    }
+  }
+
+  if(sleep_s == 0 && sleep_ns == 0)
+  {
+    atomic_init(&session->wait_policy, JUTIL_THREAD_WAIT_BUSYPOLL);
+  }
+  else
+  {
+    atomic_init(&session->wait_policy, JUTIL_THREAD_WAIT_NOTIFY);
+  }
 
-  if(jutil_thread_pmutex_init(session) == false)
+  if(jutil_thread_pmutex_init(session, &session->mutex) == false)
   {
     ERROR(session, "Mutex could not be initialized. Destroying session.");
-    free(session);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jutil_thread_pmutex_init(session, &session->wait_mutex) == false)
+  {
+    ERROR(session, "Wait mutex could not be initialized. Destroying session.");
+    jutil_thread_pmutex_destroy(session, &session->mutex);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jutil_thread_pcond_init(session) == false)
+  {
+    ERROR(session, "Condition could not be initialized. Destroying session.");
+    jutil_thread_pmutex_destroy(session, &session->wait_mutex);
+    jutil_thread_pmutex_destroy(session, &session->mutex);
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  if(jutil_thread_prwlock_init(session) == false)
+  {
+    ERROR(session, "Reader-writer lock could not be initialized. Destroying session.");
+    pthread_cond_destroy(&session->cond_notify);
+    jutil_thread_pmutex_destroy(session, &session->wait_mutex);
+    jutil_thread_pmutex_destroy(session, &session->mutex);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -241,24 +436,21 @@ void jutil_thread_free(jutil_thread_t *session)
     jutil_thread_stop(session);
   }
 
-  jutil_thread_pmutex_destroy(session);
-  free(session);
+  pthread_rwlock_destroy(&session->rwlock);
+  pthread_cond_destroy(&session->cond_notify);
+  jutil_thread_pmutex_destroy(session, &session->wait_mutex);
+  jutil_thread_pmutex_destroy(session, &session->mutex);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
 //
 void jutil_thread_manage(jutil_thread_t *session)
 {
-  int state;
-
-  jutil_thread_pmutex_lock(session);
-  state = session->thread_state;
-  jutil_thread_pmutex_unlock(session);
-
-  if(state == JUTIL_THREAD_STATE_FINISHED)
+  if(atomic_load(&session->thread_state) == JUTIL_THREAD_STATE_FINISHED)
   {
     jutil_thread_pthread_join(session);
-    session->thread_state = JUTIL_THREAD_STATE_STOPPED;
+    atomic_store(&session->thread_state, JUTIL_THREAD_STATE_STOPPED);
   }
 }
 
@@ -278,9 +470,14 @@ int jutil_thread_start(jutil_thread_t *session)
     return true;
   }
 
-  session->run_signal = true;
+  /* State is set before thread runs, so stop right after start still joins. */
+  atomic_store(&session->run_signal, true);
+  atomic_store(&session->thread_state, JUTIL_THREAD_STATE_INIT);
+
   if(jutil_thread_pthread_create(session) == false)
   {
+    atomic_store(&session->thread_state, JUTIL_THREAD_STATE_STOPPED);
+
     ERROR(session, "Thread could not be started.");
     return false;
   }
@@ -298,10 +495,7 @@ void jutil_thread_stop(jutil_thread_t * session)
     return;
   }
 
-  int state;
-  jutil_thread_pmutex_lock(session);
-  state = session->thread_state;
-  jutil_thread_pmutex_unlock(session);
+  int state = atomic_load(&session->thread_state);
 
   if(state == JUTIL_THREAD_STATE_STOPPED)
   {
@@ -311,13 +505,66 @@ void jutil_thread_stop(jutil_thread_t * session)
 
   if(state == JUTIL_THREAD_STATE_INIT || state == JUTIL_THREAD_STATE_RUNNING)
   {
-    jutil_thread_pmutex_lock(session);
-    session->run_signal = false;
-    jutil_thread_pmutex_unlock(session);
+    atomic_store(&session->run_signal, false);
+
+    /* Lock, so signal can not get lost between check and wait of thread. */
+    jutil_thread_pmutex_lock(&session->wait_mutex);
+    pthread_cond_broadcast(&session->cond_notify);
+    jutil_thread_pmutex_unlock(&session->wait_mutex);
   }
 
   jutil_thread_pthread_join(session);
-  session->thread_state = JUTIL_THREAD_STATE_STOPPED;
+  atomic_store(&session->thread_state, JUTIL_THREAD_STATE_STOPPED);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_thread_setWaitPolicy(jutil_thread_t *session, int policy)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(policy != JUTIL_THREAD_WAIT_SLEEP && policy != JUTIL_THREAD_WAIT_BUSYPOLL && policy != JUTIL_THREAD_WAIT_NOTIFY)
+  {
+    ERROR(session, "Invalid wait policy [%d].", policy);
+    return false;
+  }
+
+  atomic_store(&session->wait_policy, policy);
+
+  jutil_thread_pmutex_lock(&session->wait_mutex);
+  pthread_cond_broadcast(&session->cond_notify);
+  jutil_thread_pmutex_unlock(&session->wait_mutex);
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_thread_notify(jutil_thread_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  atomic_store(&session->notify_pending, true);
+
+  /*
+   * Thread sets waiting before it checks notify_pending, so either
+   * it sees the notification or it is seen waiting here. Mutex is
+   * only needed, if thread is blocked on the condition.
+   */
+  if(atomic_load(&session->waiting))
+  {
+    jutil_thread_pmutex_lock(&session->wait_mutex);
+    pthread_cond_signal(&session->cond_notify);
+    jutil_thread_pmutex_unlock(&session->wait_mutex);
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -330,7 +577,7 @@ void jutil_thread_lockMutex(jutil_thread_t *session)
     return;
   }
 
-  jutil_thread_pmutex_lock(session);
+  jutil_thread_pmutex_lock(&session->mutex);
 }
 
 //------------------------------------------------------------------------------
@@ -343,7 +590,58 @@ void jutil_thread_unlockMutex(jutil_thread_t *session)
     return;
   }
 
-  jutil_thread_pmutex_unlock(session);
+  jutil_thread_pmutex_unlock(&session->mutex);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_thread_lockRead(jutil_thread_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  int error = pthread_rwlock_rdlock(&session->rwlock);
+  if(error)
+  {
+    ERROR(session, "pthread_rwlock_rdlock() failed [%d : %s].", error, strerror(error));
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_thread_lockWrite(jutil_thread_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  int error = pthread_rwlock_wrlock(&session->rwlock);
+  if(error)
+  {
+    ERROR(session, "pthread_rwlock_wrlock() failed [%d : %s].", error, strerror(error));
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_thread_unlockRW(jutil_thread_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  int error = pthread_rwlock_unlock(&session->rwlock);
+  if(error)
+  {
+    ERROR(session, "pthread_rwlock_unlock() failed [%d : %s].", error, strerror(error));
+  }
 }
 
 //------------------------------------------------------------------------------
@@ -356,12 +654,7 @@ int jutil_thread_isRunning(jutil_thread_t *session)
     return false;
   }
 
-  int state;
-  jutil_thread_pmutex_lock(session);
-  state = session->thread_state;
-  jutil_thread_pmutex_unlock(session);
-
-  if(state == JUTIL_THREAD_STATE_STOPPED)
+  if(atomic_load(&session->thread_state) == JUTIL_THREAD_STATE_STOPPED)
   {
     return false;
   }
@@ -371,6 +664,37 @@ int jutil_thread_isRunning(jutil_thread_t *session)
   }
 }
 
+//------------------------------------------------------------------------------
+//
+int jutil_thread_createPthread(pthread_t *thread, const pthread_attr_t *attr, void *(*function)(void *), void *arg)
+{
+  sigset_t block_set;
+  sigset_t old_set;
+  sigfillset(&block_set);
+
+  /* Blocked fault signals would kill the process without handler. */
+  sigdelset(&block_set, SIGSEGV);
+  sigdelset(&block_set, SIGBUS);
+  sigdelset(&block_set, SIGFPE);
+  sigdelset(&block_set, SIGILL);
+
+  /* New thread inherits mask of creating thread, so it never takes a signal. */
+  int error_mask = pthread_sigmask(SIG_BLOCK, &block_set, &old_set);
+  if(error_mask)
+  {
+    WARN(NULL, "pthread_sigmask() failed [%d : %s]. Thread takes signals.", error_mask, strerror(error_mask));
+  }
+
+  int error = pthread_create(thread, attr, function, arg);
+
+  if(error_mask == 0)
+  {
+    pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+  }
+
+  return error;
+}
+
 
 
 //==============================================================================
@@ -395,41 +719,102 @@ void *jutil_thread_pthread_handler(void *ctx)
     return NULL;
   }
 
-  int run;
-  jutil_thread_pmutex_lock(session);
-  run = session->run_signal;
-  session->thread_state = JUTIL_THREAD_STATE_RUNNING;
-  jutil_thread_pmutex_unlock(session);
+  int run = atomic_load(&session->run_signal);
+  atomic_store(&session->thread_state, JUTIL_THREAD_STATE_RUNNING);
+
+  jutil_thread_applyOptions(session);
 
   DEBUG(session, "Thread start ...");
+  JUTIL_METRICS_GAUGE_ADD("jutil_thread_running", "Running jutil_thread handlers.", 1);
 
   while(run)
   {
     /* Run loop function. */
     int ret_loop = session->loop_function(session->ctx, session);
 
-    /* Sleep. */
-    jutil_time_sleep(session->sleep_secs, session->sleep_nsecs, false);
+    /* Wait for next execution. */
+    jutil_thread_wait(session);
 
     /* Check, if thread should exit. */
-    jutil_thread_pmutex_lock(session);
-    run = (session->run_signal && ret_loop);
-    jutil_thread_pmutex_unlock(session);
+    run = (atomic_load(&session->run_signal) && ret_loop);
   }
 
-  jutil_thread_pmutex_lock(session);
-  session->thread_state = JUTIL_THREAD_STATE_FINISHED;
-  jutil_thread_pmutex_unlock(session);
+  JUTIL_METRICS_GAUGE_ADD("jutil_thread_running", "Running jutil_thread handlers.", -1);
+  atomic_store(&session->thread_state, JUTIL_THREAD_STATE_FINISHED);
 
   DEBUG(session, "Thread exit.");
 
   return NULL;
 }
 
+//------------------------------------------------------------------------------
+//
+void jutil_thread_wait(jutil_thread_t *session)
+{
+  int policy = atomic_load(&session->wait_policy);
+
+  if(policy == JUTIL_THREAD_WAIT_BUSYPOLL)
+  {
+    return;
+  }
+
+  if(policy == JUTIL_THREAD_WAIT_SLEEP)
+  {
+    jutil_time_sleep(session->sleep_secs, session->sleep_nsecs, false);
+    return;
+  }
+
+  jutil_thread_pmutex_lock(&session->wait_mutex);
+  atomic_store(&session->waiting, true);
+
+  if(session->sleep_secs == 0 && session->sleep_nsecs == 0)
+  {
+    while(atomic_load(&session->notify_pending) == false && atomic_load(&session->run_signal) && atomic_load(&session->wait_policy) == JUTIL_THREAD_WAIT_NOTIFY)
+    {
+      pthread_cond_wait(&session->cond_notify, &session->wait_mutex);
+    }
+  }
+  else
+  {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += session->sleep_secs + (session->sleep_nsecs / 1000000000L);
+    deadline.tv_nsec += session->sleep_nsecs % 1000000000L;
+    if(deadline.tv_nsec >= 1000000000L)
+    {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
+
+    while(atomic_load(&session->notify_pending) == false && atomic_load(&session->run_signal) && atomic_load(&session->wait_policy) == JUTIL_THREAD_WAIT_NOTIFY)
+    {
+      int error = pthread_cond_timedwait(&session->cond_notify, &session->wait_mutex, &deadline);
+      if(error == ETIMEDOUT)
+      {
+        break;
+      }
+      else if(error)
+      {
+        ERROR(session, "pthread_cond_timedwait() failed [%d : %s].", error, strerror(error));
+        break;
+      }
+    }
+  }
+
+  atomic_store(&session->waiting, false);
+  atomic_store(&session->notify_pending, false);
+  jutil_thread_pmutex_unlock(&session->wait_mutex);
+}
+
 //------------------------------------------------------------------------------
 //
 void jutil_thread_log(jutil_thread_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
 {
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
   va_list args;
   char buf[2048];
 
@@ -440,7 +825,7 @@ void jutil_thread_log(jutil_thread_t *session, int log_type, const char *file, c
   if(session)
   {
     unsigned long id;
-    if(session->thread_state == JUTIL_THREAD_STATE_STOPPED)
+    if(atomic_load(&session->thread_state) == JUTIL_THREAD_STATE_STOPPED)
     {
       id = 0;
     }
@@ -474,7 +859,14 @@ void jutil_thread_log(jutil_thread_t *session, int log_type, const char *file, c
 //
 int jutil_thread_pthread_create(jutil_thread_t *session)
 {
-  int error = pthread_create(&session->thread, NULL, &jutil_thread_pthread_handler, session);
+  pthread_attr_t attr;
+  if(jutil_thread_pattr_init(session, &attr) == false)
+  {
+    return false;
+  }
+
+  int error = jutil_thread_createPthread(&session->thread, &attr, &jutil_thread_pthread_handler, session);
+  pthread_attr_destroy(&attr);
   if(error)
   {
     switch(error)
@@ -548,9 +940,101 @@ void jutil_thread_pthread_join(jutil_thread_t *session)
 
 //------------------------------------------------------------------------------
 //
-int jutil_thread_pmutex_init(jutil_thread_t *session)
+int jutil_thread_pattr_init(jutil_thread_t *session, pthread_attr_t *attr)
 {
-  int error = pthread_mutex_init(&session->mutex, NULL);
+  int error = pthread_attr_init(attr);
+  if(error)
+  {
+    ERROR(session, "pthread_attr_init() failed [%d : %s].", error, strerror(error));
+    return false;
+  }
+
+  if(session->stack_size > 0)
+  {
+    size_t stack_size = session->stack_size;
+    if(stack_size < (size_t)PTHREAD_STACK_MIN)
+    {
+      stack_size = PTHREAD_STACK_MIN;
+    }
+
+    error = pthread_attr_setstacksize(attr, stack_size);
+    if(error)
+    {
+      ERROR(session, "pthread_attr_setstacksize() failed [%d : %s].", error, strerror(error));
+      pthread_attr_destroy(attr);
+      return false;
+    }
+  }
+
+  if(session->has_cpus)
+  {
+    error = pthread_attr_setaffinity_np(attr, sizeof(session->cpus), &session->cpus);
+    if(error)
+    {
+      ERROR(session, "pthread_attr_setaffinity_np() failed [%d : %s].", error, strerror(error));
+      pthread_attr_destroy(attr);
+      return false;
+    }
+  }
+
+  if(session->policy != JUTIL_THREAD_SCHED_OTHER)
+  {
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = session->priority;
+
+    int policy = (session->policy == JUTIL_THREAD_SCHED_FIFO ? SCHED_FIFO : SCHED_RR);
+
+    /* Without explicit scheduling, policy of creating thread is inherited. */
+    error = pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED);
+    if(error == 0)
+    {
+      error = pthread_attr_setschedpolicy(attr, policy);
+    }
+    if(error == 0)
+    {
+      error = pthread_attr_setschedparam(attr, &param);
+    }
+
+    if(error)
+    {
+      ERROR(session, "Scheduling policy could not be set [%d : %s].", error, strerror(error));
+      pthread_attr_destroy(attr);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_thread_applyOptions(jutil_thread_t *session)
+{
+  if(session->name[0])
+  {
+    int error = pthread_setname_np(pthread_self(), session->name);
+    if(error)
+    {
+      WARN(session, "pthread_setname_np() failed [%d : %s].", error, strerror(error));
+    }
+  }
+
+  if(session->nice != 0 && session->policy == JUTIL_THREAD_SCHED_OTHER)
+  {
+    /* On Linux nice value is set per thread id. */
+    if(setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), session->nice) != 0)
+    {
+      WARN(session, "setpriority() failed [%d : %s].", errno, strerror(errno));
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_thread_pmutex_init(jutil_thread_t *session, pthread_mutex_t *mutex)
+{
+  int error = pthread_mutex_init(mutex, NULL);
   if(error)
   {
     switch(error)
@@ -600,9 +1084,54 @@ int jutil_thread_pmutex_init(jutil_thread_t *session)
 
 //------------------------------------------------------------------------------
 //
-void jutil_thread_pmutex_destroy(jutil_thread_t *session)
+int jutil_thread_pcond_init(jutil_thread_t *session)
+{
+  pthread_condattr_t attr;
+  int error = pthread_condattr_init(&attr);
+  if(error)
+  {
+    ERROR(session, "pthread_condattr_init() failed [%d : %s].", error, strerror(error));
+    return false;
+  }
+
+  error = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  if(error)
+  {
+    ERROR(session, "pthread_condattr_setclock() failed [%d : %s].", error, strerror(error));
+    pthread_condattr_destroy(&attr);
+    return false;
+  }
+
+  error = pthread_cond_init(&session->cond_notify, &attr);
+  pthread_condattr_destroy(&attr);
+  if(error)
+  {
+    ERROR(session, "pthread_cond_init() failed [%d : %s].", error, strerror(error));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_thread_prwlock_init(jutil_thread_t *session)
+{
+  int error = pthread_rwlock_init(&session->rwlock, NULL);
+  if(error)
+  {
+    ERROR(session, "pthread_rwlock_init() failed [%d : %s].", error, strerror(error));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_thread_pmutex_destroy(jutil_thread_t *session, pthread_mutex_t *mutex)
 {
-  int error = pthread_mutex_destroy(&session->mutex);
+  int error = pthread_mutex_destroy(mutex);
   if(error)
   {
     switch(error)
@@ -630,9 +1159,9 @@ void jutil_thread_pmutex_destroy(jutil_thread_t *session)
 
 //------------------------------------------------------------------------------
 //
-void jutil_thread_pmutex_lock(jutil_thread_t *session)
+void jutil_thread_pmutex_lock(pthread_mutex_t *mutex)
 {
-  int error = pthread_mutex_lock(&session->mutex);
+  int error = pthread_mutex_lock(mutex);
   if(error)
   {
     switch(error)
@@ -666,9 +1195,9 @@ void jutil_thread_pmutex_lock(jutil_thread_t *session)
 
 //------------------------------------------------------------------------------
 //
-void jutil_thread_pmutex_unlock(jutil_thread_t *session)
+void jutil_thread_pmutex_unlock(pthread_mutex_t *mutex)
 {
-  int error = pthread_mutex_unlock(&session->mutex);
+  int error = pthread_mutex_unlock(mutex);
   if(error)
   {
     switch(error)
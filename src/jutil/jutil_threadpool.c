@@ -0,0 +1,958 @@
+/**
+ * @file jutil_threadpool.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jutil_threadpool.
+ * 
+ * Deques of workers are fixed size Chase-Lev deques. The
+ * owner pushes and pops at the bottom, other workers steal
+ * at the top with a compare and swap. If a deque is full,
+ * tasks go to the shared queue.
+ * 
+ * Workers, that find no task, sleep on a condition. Submitters
+ * only lock the mutex to wake them, if a worker is sleeping.
+ * The number of queued tasks is checked under the mutex
+ * before sleeping, so no wakeup is lost.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _GNU_SOURCE /* needed for pthread_setaffinity_np() and pthread_setname_np() */
+
+#include <jayc/jutil_threadpool.h>
+#include <jayc/jutil_thread.h>
+#include <jayc/jutil_alloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_threadpool");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Number of tasks per worker deque. Power of 2.
+ */
+#define JUTIL_THREADPOOL_SIZE_DEQUE 1024
+
+/**
+ * @brief Size of a cache line. Deque indices are aligned to it.
+ */
+#define JUTIL_THREADPOOL_SIZE_CACHELINE 64
+
+/**
+ * @brief Max. length of worker name prefix.
+ */
+#define JUTIL_THREADPOOL_SIZE_NAME 10
+
+/**
+ * @brief Searches for tasks, before worker goes to sleep.
+ */
+#define JUTIL_THREADPOOL_SPIN_ROUNDS 16
+
+/**
+ * @brief Nanoseconds a helping worker waits for future, if there are no tasks.
+ */
+#define JUTIL_THREADPOOL_SLEEP_HELP 1000000
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Submitted task.
+ */
+typedef struct __jutil_threadpool_task
+{
+  jutil_threadpool_task_function_t function;  /**< Task function. */
+  void *ctx;                                  /**< Context for task function. */
+  jutil_threadpool_callback_t callback;       /**< Called with result. Can be @c NULL . */
+  void *callback_ctx;                         /**< Context for callback. */
+  jutil_threadpool_future_t *future;          /**< Gets result. Can be @c NULL . */
+  struct __jutil_threadpool_task *next;       /**< Next task in shared queue. */
+} jutil_threadpool_task_t;
+
+/**
+ * @brief Worker thread with its deque.
+ */
+typedef struct __jutil_threadpool_worker
+{
+  _Alignas(JUTIL_THREADPOOL_SIZE_CACHELINE)
+  atomic_int_fast64_t top;                                            /**< Next task to steal. */
+
+  _Alignas(JUTIL_THREADPOOL_SIZE_CACHELINE)
+  atomic_int_fast64_t bottom;                                         /**< Next free slot of owner. */
+  _Atomic(jutil_threadpool_task_t *) tasks[JUTIL_THREADPOOL_SIZE_DEQUE]; /**< Deque ring. */
+
+  pthread_t thread;                                                   /**< Worker thread. */
+  size_t index;                                                       /**< Index in pool. */
+  uint32_t random;                                                    /**< State to pick victims for stealing. */
+  struct __jutil_threadpool *pool;                                    /**< Pool of worker. */
+} jutil_threadpool_worker_t;
+
+/**
+ * @brief Pool object.
+ */
+struct __jutil_threadpool
+{
+  jutil_threadpool_worker_t *workers;   /**< Array of workers. */
+  size_t worker_count;                  /**< Number of workers. */
+  size_t started;                       /**< Number of started worker threads. */
+  char name[JUTIL_THREADPOOL_SIZE_NAME + 1]; /**< Prefix of worker names. */
+  jlog_t *logger;                       /**< Logger for error messages. */
+
+  pthread_mutex_t mutex;                /**< Protects shared queue and sleeping. */
+  pthread_cond_t cond_work;             /**< Signaled, when tasks are submitted. */
+  pthread_cond_t cond_idle;             /**< Signaled, when all tasks are finished. */
+  jutil_threadpool_task_t *queue_head;  /**< Oldest task of shared queue. */
+  jutil_threadpool_task_t *queue_tail;  /**< Newest task of shared queue. */
+
+  atomic_size_t queued;                 /**< Tasks in deques and shared queue. */
+  atomic_size_t shared;                 /**< Tasks in shared queue. */
+  atomic_size_t unfinished;             /**< Submitted tasks, that are not finished. */
+  atomic_size_t sleeping;               /**< Workers waiting for tasks. */
+  atomic_int running;                   /**< Workers stop, when @c false . */
+};
+
+/**
+ * @brief Future object.
+ */
+struct __jutil_threadpool_future
+{
+  pthread_mutex_t mutex;  /**< Protects result for waiters. */
+  pthread_cond_t cond;    /**< Signaled, when task is finished. */
+  atomic_int done;        /**< @c true , if result is set. */
+  atomic_int references;  /**< Task and user hold a reference. */
+  void *result;           /**< Return value of task. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Loop of worker threads.
+ * 
+ * @param ctx Worker object.
+ * 
+ * @return    Not used.
+ */
+static void *jutil_threadpool_worker_handler(void *ctx);
+
+/**
+ * @brief Adds task to pool.
+ * 
+ * Workers of pool push to own deque, other threads to
+ * shared queue.
+ * 
+ * @param pool  Pool object.
+ * @param task  Task to add.
+ */
+static void jutil_threadpool_addTask(jutil_threadpool_t *pool, jutil_threadpool_task_t *task);
+
+/**
+ * @brief Finds task for worker.
+ * 
+ * Checks own deque, shared queue and deques of other
+ * workers in that order.
+ * 
+ * @param worker  Worker looking for task.
+ * 
+ * @return        Task.
+ * @return        @c NULL , if no task was found.
+ */
+static jutil_threadpool_task_t *jutil_threadpool_findTask(jutil_threadpool_worker_t *worker);
+
+/**
+ * @brief Runs task, passes result and frees task.
+ * 
+ * @param pool  Pool of task.
+ * @param task  Task to run.
+ */
+static void jutil_threadpool_runTask(jutil_threadpool_t *pool, jutil_threadpool_task_t *task);
+
+/**
+ * @brief Pushes task to bottom of own deque.
+ * 
+ * Only called by owner.
+ * 
+ * @param worker  Owner of deque.
+ * @param task    Task to push.
+ * 
+ * @return        @c true , if task was pushed.
+ * @return        @c false , if deque is full.
+ */
+static int jutil_threadpool_deque_push(jutil_threadpool_worker_t *worker, jutil_threadpool_task_t *task);
+
+/**
+ * @brief Takes newest task from own deque.
+ * 
+ * Only called by owner.
+ * 
+ * @param worker  Owner of deque.
+ * 
+ * @return        Task.
+ * @return        @c NULL , if deque is empty.
+ */
+static jutil_threadpool_task_t *jutil_threadpool_deque_pop(jutil_threadpool_worker_t *worker);
+
+/**
+ * @brief Takes oldest task from deque of other worker.
+ * 
+ * @param victim  Worker to steal from.
+ * 
+ * @return        Task.
+ * @return        @c NULL , if deque is empty or another thread was faster.
+ */
+static jutil_threadpool_task_t *jutil_threadpool_deque_steal(jutil_threadpool_worker_t *victim);
+
+/**
+ * @brief Takes oldest task from shared queue.
+ * 
+ * @param pool  Pool object.
+ * 
+ * @return      Task.
+ * @return      @c NULL , if queue is empty.
+ */
+static jutil_threadpool_task_t *jutil_threadpool_queue_pop(jutil_threadpool_t *pool);
+
+/**
+ * @brief Sets result and wakes waiters.
+ * 
+ * @param future  Future of task.
+ * @param result  Return value of task.
+ */
+static void jutil_threadpool_future_complete(jutil_threadpool_future_t *future, void *result);
+
+/**
+ * @brief Drops one reference and frees future, if it was the last.
+ * 
+ * @param future  Future object.
+ */
+static void jutil_threadpool_future_release(jutil_threadpool_future_t *future);
+
+/**
+ * @brief Sends log messages to logger with pool data.
+ * 
+ * @param pool      Pool object.
+ * @param log_type  (debug, info, warning, error, critical, fatal).
+ * @param file      Source code file.
+ * @param function  Function name.
+ * @param line      Line number of source file.
+ * @param fmt       String format for stdarg.h .
+ */
+static void jutil_threadpool_log(jutil_threadpool_t *pool, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(pool, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((pool ? pool->logger : NULL), log_type))
+
+#ifdef JUTIL_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(pool, fmt, ...)
+#else
+  #define DEBUG(pool, fmt, ...) (LOG_ENABLED(pool, JLOG_LOGTYPE_DEBUG) ? jutil_threadpool_log(pool, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(pool, fmt, ...) (LOG_ENABLED(pool, JLOG_LOGTYPE_INFO) ? jutil_threadpool_log(pool, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(pool, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jutil_threadpool_log(pool, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(pool, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jutil_threadpool_log(pool, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(pool, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jutil_threadpool_log(pool, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(pool, fmt, ...) jutil_threadpool_log(pool, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Worker running on calling thread, @c NULL for other threads.
+ */
+static _Thread_local jutil_threadpool_worker_t *jutil_threadpool_current = NULL;
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_threadpool_t *jutil_threadpool_init(size_t workers, const char *name, jlog_t *logger)
+{
+  if(workers == 0)
+  {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    workers = (cpus > 0 ? (size_t)cpus : 1);
+  }
+
+  jutil_threadpool_t *pool = (jutil_threadpool_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_threadpool_t));
+  if(pool == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  pool->logger = logger;
+  pool->worker_count = workers;
+  pool->started = 0;
+  pool->queue_head = NULL;
+  pool->queue_tail = NULL;
+  snprintf(pool->name, sizeof(pool->name), "%s", (name ? name : "pool"));
+  atomic_init(&(pool->queued), 0);
+  atomic_init(&(pool->shared), 0);
+  atomic_init(&(pool->unfinished), 0);
+  atomic_init(&(pool->sleeping), 0);
+  atomic_init(&(pool->running), true);
+
+  pool->workers = (jutil_threadpool_worker_t *)JUTIL_ALLOC_MALLOC_ALIGNED(JUTIL_THREADPOOL_SIZE_CACHELINE, workers * sizeof(jutil_threadpool_worker_t));
+  if(pool->workers == NULL)
+  {
+    ERROR(pool, "aligned_alloc() failed.");
+    JUTIL_ALLOC_FREE(pool);
+    return NULL;
+  }
+
+  if(pthread_mutex_init(&(pool->mutex), NULL) != 0
+    || pthread_cond_init(&(pool->cond_work), NULL) != 0
+    || pthread_cond_init(&(pool->cond_idle), NULL) != 0)
+  {
+    ERROR(pool, "Could not initialize mutex and conditions.");
+    JUTIL_ALLOC_FREE_ALIGNED(pool->workers);
+    JUTIL_ALLOC_FREE(pool);
+    return NULL;
+  }
+
+  for(size_t i = 0; i < workers; i++)
+  {
+    jutil_threadpool_worker_t *worker = &(pool->workers[i]);
+    atomic_init(&(worker->top), 0);
+    atomic_init(&(worker->bottom), 0);
+    for(size_t slot = 0; slot < JUTIL_THREADPOOL_SIZE_DEQUE; slot++)
+    {
+      atomic_init(&(worker->tasks[slot]), NULL);
+    }
+    worker->index = i;
+    worker->random = (uint32_t)(i * 2654435761u) | 1;
+    worker->pool = pool;
+  }
+
+  for(size_t i = 0; i < workers; i++)
+  {
+    /* Workers block signals, so tasks are not interrupted. */
+    int error = jutil_thread_createPthread(&(pool->workers[i].thread), NULL, &jutil_threadpool_worker_handler, &(pool->workers[i]));
+    if(error != 0)
+    {
+      ERROR(pool, "pthread_create() failed [%d : %s].", error, strerror(error));
+      jutil_threadpool_free(pool);
+      return NULL;
+    }
+
+    pool->started++;
+  }
+
+  DEBUG(pool, "Pool started with [%zu] workers.", workers);
+  return pool;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_free(jutil_threadpool_t *pool)
+{
+  if(pool == NULL)
+  {
+    return;
+  }
+
+  jutil_threadpool_wait(pool);
+
+  pthread_mutex_lock(&(pool->mutex));
+  atomic_store(&(pool->running), false);
+  pthread_cond_broadcast(&(pool->cond_work));
+  pthread_mutex_unlock(&(pool->mutex));
+
+  for(size_t i = 0; i < pool->started; i++)
+  {
+    pthread_join(pool->workers[i].thread, NULL);
+  }
+
+  pthread_cond_destroy(&(pool->cond_idle));
+  pthread_cond_destroy(&(pool->cond_work));
+  pthread_mutex_destroy(&(pool->mutex));
+  JUTIL_ALLOC_FREE_ALIGNED(pool->workers);
+  JUTIL_ALLOC_FREE(pool);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_threadpool_submit(jutil_threadpool_t *pool, jutil_threadpool_task_function_t function, void *ctx, jutil_threadpool_callback_t callback, void *callback_ctx)
+{
+  if(pool == NULL || function == NULL)
+  {
+    ERROR(pool, "Invalid parameters.");
+    return false;
+  }
+
+  jutil_threadpool_task_t *task = (jutil_threadpool_task_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_threadpool_task_t));
+  if(task == NULL)
+  {
+    ERROR(pool, "malloc() failed.");
+    return false;
+  }
+
+  task->function = function;
+  task->ctx = ctx;
+  task->callback = callback;
+  task->callback_ctx = callback_ctx;
+  task->future = NULL;
+  task->next = NULL;
+
+  jutil_threadpool_addTask(pool, task);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_threadpool_future_t *jutil_threadpool_submitFuture(jutil_threadpool_t *pool, jutil_threadpool_task_function_t function, void *ctx)
+{
+  if(pool == NULL || function == NULL)
+  {
+    ERROR(pool, "Invalid parameters.");
+    return NULL;
+  }
+
+  jutil_threadpool_future_t *future = (jutil_threadpool_future_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_threadpool_future_t));
+  if(future == NULL)
+  {
+    ERROR(pool, "malloc() failed.");
+    return NULL;
+  }
+
+  jutil_threadpool_task_t *task = (jutil_threadpool_task_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_threadpool_task_t));
+  if(task == NULL)
+  {
+    ERROR(pool, "malloc() failed.");
+    JUTIL_ALLOC_FREE(future);
+    return NULL;
+  }
+
+  if(pthread_mutex_init(&(future->mutex), NULL) != 0)
+  {
+    ERROR(pool, "pthread_mutex_init() failed.");
+    JUTIL_ALLOC_FREE(task);
+    JUTIL_ALLOC_FREE(future);
+    return NULL;
+  }
+
+  if(pthread_cond_init(&(future->cond), NULL) != 0)
+  {
+    ERROR(pool, "pthread_cond_init() failed.");
+    pthread_mutex_destroy(&(future->mutex));
+    JUTIL_ALLOC_FREE(task);
+    JUTIL_ALLOC_FREE(future);
+    return NULL;
+  }
+
+  atomic_init(&(future->done), false);
+  atomic_init(&(future->references), 2);
+  future->result = NULL;
+
+  task->function = function;
+  task->ctx = ctx;
+  task->callback = NULL;
+  task->callback_ctx = NULL;
+  task->future = future;
+  task->next = NULL;
+
+  jutil_threadpool_addTask(pool, task);
+  return future;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_wait(jutil_threadpool_t *pool)
+{
+  if(pool == NULL)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&(pool->mutex));
+  while(atomic_load(&(pool->unfinished)) > 0)
+  {
+    pthread_cond_wait(&(pool->cond_idle), &(pool->mutex));
+  }
+  pthread_mutex_unlock(&(pool->mutex));
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_threadpool_getWorkers(jutil_threadpool_t *pool)
+{
+  if(pool == NULL)
+  {
+    return 0;
+  }
+
+  return pool->worker_count;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_threadpool_setAffinity(jutil_threadpool_t *pool, size_t worker, int cpu)
+{
+  if(pool == NULL || worker >= pool->started || cpu < 0 || cpu >= CPU_SETSIZE)
+  {
+    ERROR(pool, "Invalid parameters.");
+    return false;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  int error = pthread_setaffinity_np(pool->workers[worker].thread, sizeof(set), &set);
+  if(error != 0)
+  {
+    ERROR(pool, "pthread_setaffinity_np() failed [%d : %s].", error, strerror(error));
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_threadpool_pinWorkers(jutil_threadpool_t *pool)
+{
+  if(pool == NULL)
+  {
+    ERROR(NULL, "pool is NULL.");
+    return false;
+  }
+
+  cpu_set_t allowed;
+  if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    ERROR(pool, "sched_getaffinity() failed.");
+    return false;
+  }
+
+  int cpus[CPU_SETSIZE];
+  int cpu_count = 0;
+  for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+  {
+    if(CPU_ISSET(cpu, &allowed))
+    {
+      cpus[cpu_count++] = cpu;
+    }
+  }
+
+  if(cpu_count == 0)
+  {
+    ERROR(pool, "No CPUs available.");
+    return false;
+  }
+
+  int success = true;
+  for(size_t i = 0; i < pool->started; i++)
+  {
+    if(jutil_threadpool_setAffinity(pool, i, cpus[i % cpu_count]) == false)
+    {
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+//------------------------------------------------------------------------------
+//
+void *jutil_threadpool_future_wait(jutil_threadpool_future_t *future)
+{
+  if(future == NULL)
+  {
+    return NULL;
+  }
+
+  jutil_threadpool_worker_t *worker = jutil_threadpool_current;
+
+  /* Workers help with tasks, so the task they wait for can run. */
+  while(worker && atomic_load_explicit(&(future->done), memory_order_acquire) == false)
+  {
+    jutil_threadpool_task_t *task = jutil_threadpool_findTask(worker);
+    if(task)
+    {
+      jutil_threadpool_runTask(worker->pool, task);
+      continue;
+    }
+
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_nsec += JUTIL_THREADPOOL_SLEEP_HELP;
+    if(until.tv_nsec >= 1000000000L)
+    {
+      until.tv_sec++;
+      until.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&(future->mutex));
+    if(atomic_load(&(future->done)) == false)
+    {
+      pthread_cond_timedwait(&(future->cond), &(future->mutex), &until);
+    }
+    pthread_mutex_unlock(&(future->mutex));
+  }
+
+  pthread_mutex_lock(&(future->mutex));
+  while(atomic_load(&(future->done)) == false)
+  {
+    pthread_cond_wait(&(future->cond), &(future->mutex));
+  }
+  void *result = future->result;
+  pthread_mutex_unlock(&(future->mutex));
+
+  return result;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_threadpool_future_isDone(jutil_threadpool_future_t *future)
+{
+  if(future == NULL)
+  {
+    return false;
+  }
+
+  return atomic_load_explicit(&(future->done), memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_future_free(jutil_threadpool_future_t *future)
+{
+  jutil_threadpool_future_release(future);
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+void *jutil_threadpool_worker_handler(void *ctx)
+{
+  jutil_threadpool_worker_t *worker = (jutil_threadpool_worker_t *)ctx;
+  jutil_threadpool_t *pool = worker->pool;
+  jutil_threadpool_current = worker;
+
+  char name[16];
+  snprintf(name, sizeof(name), "%s-%zu", pool->name, worker->index);
+  pthread_setname_np(pthread_self(), name);
+
+  while(true)
+  {
+    jutil_threadpool_task_t *task = NULL;
+    for(int round = 0; round < JUTIL_THREADPOOL_SPIN_ROUNDS && task == NULL; round++)
+    {
+      task = jutil_threadpool_findTask(worker);
+      if(task == NULL && atomic_load(&(pool->queued)) == 0)
+      {
+        break;
+      }
+    }
+
+    if(task)
+    {
+      jutil_threadpool_runTask(pool, task);
+      continue;
+    }
+
+    pthread_mutex_lock(&(pool->mutex));
+    atomic_fetch_add(&(pool->sleeping), 1);
+    while(atomic_load(&(pool->queued)) == 0 && atomic_load(&(pool->running)))
+    {
+      pthread_cond_wait(&(pool->cond_work), &(pool->mutex));
+    }
+    atomic_fetch_sub(&(pool->sleeping), 1);
+    int running = atomic_load(&(pool->running));
+    pthread_mutex_unlock(&(pool->mutex));
+
+    if(running == false && atomic_load(&(pool->queued)) == 0)
+    {
+      break;
+    }
+  }
+
+  jutil_threadpool_current = NULL;
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_addTask(jutil_threadpool_t *pool, jutil_threadpool_task_t *task)
+{
+  atomic_fetch_add(&(pool->unfinished), 1);
+
+  jutil_threadpool_worker_t *worker = jutil_threadpool_current;
+  if(worker == NULL || worker->pool != pool || jutil_threadpool_deque_push(worker, task) == false)
+  {
+    pthread_mutex_lock(&(pool->mutex));
+    if(pool->queue_tail)
+    {
+      pool->queue_tail->next = task;
+    }
+    else
+    {
+      pool->queue_head = task;
+    }
+    pool->queue_tail = task;
+    atomic_fetch_add(&(pool->shared), 1);
+    atomic_fetch_add(&(pool->queued), 1);
+    pthread_cond_signal(&(pool->cond_work));
+    pthread_mutex_unlock(&(pool->mutex));
+    return;
+  }
+
+  atomic_fetch_add(&(pool->queued), 1);
+
+  /* Sleeping counter is changed under mutex, lock only to wake a worker. */
+  if(atomic_load(&(pool->sleeping)) > 0)
+  {
+    pthread_mutex_lock(&(pool->mutex));
+    pthread_cond_signal(&(pool->cond_work));
+    pthread_mutex_unlock(&(pool->mutex));
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_threadpool_task_t *jutil_threadpool_findTask(jutil_threadpool_worker_t *worker)
+{
+  jutil_threadpool_t *pool = worker->pool;
+
+  jutil_threadpool_task_t *task = jutil_threadpool_deque_pop(worker);
+  if(task == NULL && atomic_load_explicit(&(pool->shared), memory_order_relaxed) > 0)
+  {
+    task = jutil_threadpool_queue_pop(pool);
+  }
+
+  if(task == NULL && pool->worker_count > 1)
+  {
+    /* xorshift, so workers do not all try the same victim. */
+    worker->random ^= worker->random << 13;
+    worker->random ^= worker->random >> 17;
+    worker->random ^= worker->random << 5;
+
+    size_t start = worker->random % pool->worker_count;
+    for(size_t i = 0; i < pool->worker_count && task == NULL; i++)
+    {
+      jutil_threadpool_worker_t *victim = &(pool->workers[(start + i) % pool->worker_count]);
+      if(victim != worker)
+      {
+        task = jutil_threadpool_deque_steal(victim);
+      }
+    }
+  }
+
+  if(task)
+  {
+    atomic_fetch_sub(&(pool->queued), 1);
+  }
+
+  return task;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_runTask(jutil_threadpool_t *pool, jutil_threadpool_task_t *task)
+{
+  void *result = task->function(task->ctx);
+
+  if(task->callback)
+  {
+    task->callback(task->callback_ctx, result);
+  }
+
+  if(task->future)
+  {
+    jutil_threadpool_future_complete(task->future, result);
+    jutil_threadpool_future_release(task->future);
+  }
+
+  JUTIL_ALLOC_FREE(task);
+
+  if(atomic_fetch_sub(&(pool->unfinished), 1) == 1)
+  {
+    pthread_mutex_lock(&(pool->mutex));
+    pthread_cond_broadcast(&(pool->cond_idle));
+    pthread_mutex_unlock(&(pool->mutex));
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_threadpool_deque_push(jutil_threadpool_worker_t *worker, jutil_threadpool_task_t *task)
+{
+  int_fast64_t bottom = atomic_load_explicit(&(worker->bottom), memory_order_relaxed);
+  int_fast64_t top = atomic_load_explicit(&(worker->top), memory_order_acquire);
+  if(bottom - top >= JUTIL_THREADPOOL_SIZE_DEQUE)
+  {
+    return false;
+  }
+
+  atomic_store_explicit(&(worker->tasks[bottom & (JUTIL_THREADPOOL_SIZE_DEQUE - 1)]), task, memory_order_relaxed);
+  atomic_store_explicit(&(worker->bottom), bottom + 1, memory_order_release);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_threadpool_task_t *jutil_threadpool_deque_pop(jutil_threadpool_worker_t *worker)
+{
+  int_fast64_t bottom = atomic_load_explicit(&(worker->bottom), memory_order_relaxed) - 1;
+  atomic_store_explicit(&(worker->bottom), bottom, memory_order_seq_cst);
+  int_fast64_t top = atomic_load_explicit(&(worker->top), memory_order_seq_cst);
+
+  if(top > bottom)
+  {
+    /* Deque was empty. */
+    atomic_store_explicit(&(worker->bottom), bottom + 1, memory_order_relaxed);
+    return NULL;
+  }
+
+  jutil_threadpool_task_t *task = atomic_load_explicit(&(worker->tasks[bottom & (JUTIL_THREADPOOL_SIZE_DEQUE - 1)]), memory_order_relaxed);
+  if(top == bottom)
+  {
+    /* Last task, race against thieves. */
+    if(atomic_compare_exchange_strong_explicit(&(worker->top), &top, top + 1, memory_order_seq_cst, memory_order_relaxed) == false)
+    {
+      task = NULL;
+    }
+    atomic_store_explicit(&(worker->bottom), bottom + 1, memory_order_relaxed);
+  }
+
+  return task;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_threadpool_task_t *jutil_threadpool_deque_steal(jutil_threadpool_worker_t *victim)
+{
+  int_fast64_t top = atomic_load_explicit(&(victim->top), memory_order_seq_cst);
+  int_fast64_t bottom = atomic_load_explicit(&(victim->bottom), memory_order_seq_cst);
+  if(top >= bottom)
+  {
+    return NULL;
+  }
+
+  jutil_threadpool_task_t *task = atomic_load_explicit(&(victim->tasks[top & (JUTIL_THREADPOOL_SIZE_DEQUE - 1)]), memory_order_relaxed);
+  if(atomic_compare_exchange_strong_explicit(&(victim->top), &top, top + 1, memory_order_seq_cst, memory_order_relaxed) == false)
+  {
+    return NULL;
+  }
+
+  return task;
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_threadpool_task_t *jutil_threadpool_queue_pop(jutil_threadpool_t *pool)
+{
+  pthread_mutex_lock(&(pool->mutex));
+  jutil_threadpool_task_t *task = pool->queue_head;
+  if(task)
+  {
+    pool->queue_head = task->next;
+    if(pool->queue_head == NULL)
+    {
+      pool->queue_tail = NULL;
+    }
+    atomic_fetch_sub(&(pool->shared), 1);
+  }
+  pthread_mutex_unlock(&(pool->mutex));
+
+  return task;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_future_complete(jutil_threadpool_future_t *future, void *result)
+{
+  pthread_mutex_lock(&(future->mutex));
+  future->result = result;
+  atomic_store_explicit(&(future->done), true, memory_order_release);
+  pthread_cond_broadcast(&(future->cond));
+  pthread_mutex_unlock(&(future->mutex));
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_future_release(jutil_threadpool_future_t *future)
+{
+  if(future == NULL)
+  {
+    return;
+  }
+
+  if(atomic_fetch_sub_explicit(&(future->references), 1, memory_order_acq_rel) == 1)
+  {
+    pthread_cond_destroy(&(future->cond));
+    pthread_mutex_destroy(&(future->mutex));
+    JUTIL_ALLOC_FREE(future);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_threadpool_log(jutil_threadpool_t *pool, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(pool, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(pool && pool->logger)
+  {
+    jlog_log_message_m(pool->logger, log_type, file, function, line, "<threadpool:%s> %s", pool->name, buf);
+  }
+  else if(pool)
+  {
+    jlog_global_log_message_m(log_type, file, function, line, "<threadpool:%s> %s", pool->name, buf);
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, "%s", buf);
+  }
+}
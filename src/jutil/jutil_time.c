@@ -11,7 +11,7 @@
  * 
  */
 
-#define _POSIX_C_SOURCE 199309L /* needed for nanosleep() */
+#define _POSIX_C_SOURCE 200809L /* needed for nanosleep(), clock_gettime() and localtime_r() */
 
 #include <jayc/jutil_time.h>
 #include <jayc/jlog.h>
@@ -19,6 +19,47 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#include <limits.h>
+
+//==============================================================================
+// Define constants and structures.
+//
+
+/**
+ * @brief Clock for deadlines, coarse if available.
+ */
+#ifdef CLOCK_MONOTONIC_COARSE
+  #define JUTIL_TIME_CLOCK_COARSE CLOCK_MONOTONIC_COARSE
+#else
+  #define JUTIL_TIME_CLOCK_COARSE CLOCK_MONOTONIC
+#endif
+
+/**
+ * @brief Format of standardized time strings.
+ */
+#define JUTIL_TIME_FORMAT_DEFAULT "%Y-%m-%d %H:%M:%S"
+
+/**
+ * @brief Size of cached time string.
+ */
+#define JUTIL_TIME_SIZE_CACHE 32
+
+/**
+ * @brief Time string of last formatted second.
+ */
+typedef struct __jutil_time_cache
+{
+  long second;                      /**< Formatted second, @c -1 if empty. */
+  size_t length;                    /**< Length of text. */
+  char text[JUTIL_TIME_SIZE_CACHE]; /**< Text formatted with @c #JUTIL_TIME_FORMAT_DEFAULT . */
+} jutil_time_cache_t;
+
+/**
+ * @brief Cache of calling thread, so no locks are needed.
+ */
+static _Thread_local jutil_time_cache_t jutil_time_cache = { -1, 0, "" };
+
+
 
 //==============================================================================
 // Define log macros.
@@ -50,9 +91,13 @@ int jutil_time_formatTime(char *str_buf, size_t str_size, const char *format, ti
     return false;
   }
 
-  struct tm *time_info = localtime(&timestamp);
+  struct tm time_info;
+  if(localtime_r(&timestamp, &time_info) == NULL)
+  {
+    return false;
+  }
 
-  if(strftime(str_buf, str_size, format, time_info) == 0)
+  if(strftime(str_buf, str_size, format, &time_info) == 0)
   {
     return false;
   }
@@ -69,8 +114,7 @@ int jutil_time_getTimeString(char *str_buf, size_t str_size, time_t timestamp)
     return false;
   }
 
-
-  return jutil_time_formatTime(str_buf, str_size, "%Y-%m-%d %H:%M:%S", timestamp);
+  return (jutil_time_getTimeStringPrecise(str_buf, str_size, timestamp, 0, 0) > 0);
 }
 
 //------------------------------------------------------------------------------
@@ -82,13 +126,156 @@ int jutil_time_getCurrentTimeString(char *str_buf, size_t str_size)
     return false;
   }
 
-  time_t timestamp = time(NULL);
-  if(timestamp == -1)
+  return (jutil_time_getCurrentTimeStringPrecise(str_buf, str_size, 0) > 0);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_time_getTimeStringPrecise(char *str_buf, size_t str_size, long seconds, long nanoseconds, int precision)
+{
+  if(str_buf == NULL || nanoseconds < 0 || nanoseconds > 999999999L)
+  {
+    return 0;
+  }
+
+  if(precision < 0)
+  {
+    precision = 0;
+  }
+  else if(precision > 9)
+  {
+    precision = 9;
+  }
+
+  /* Date and time only change once per second. */
+  if(seconds != jutil_time_cache.second)
+  {
+    time_t timestamp = (time_t)seconds;
+    struct tm time_info;
+
+    jutil_time_cache.second = -1;
+    if(localtime_r(&timestamp, &time_info) == NULL)
+    {
+      return 0;
+    }
+
+    jutil_time_cache.length = strftime(jutil_time_cache.text, sizeof(jutil_time_cache.text), JUTIL_TIME_FORMAT_DEFAULT, &time_info);
+    if(jutil_time_cache.length == 0)
+    {
+      return 0;
+    }
+    jutil_time_cache.second = seconds;
+  }
+
+  size_t length = jutil_time_cache.length + (precision > 0 ? (size_t)precision + 1 : 0);
+  if(length >= str_size)
+  {
+    return 0;
+  }
+
+  memcpy(str_buf, jutil_time_cache.text, jutil_time_cache.length);
+
+  if(precision > 0)
+  {
+    long fraction = nanoseconds;
+    for(int i = precision; i < 9; i++)
+    {
+      fraction /= 10;
+    }
+
+    str_buf[jutil_time_cache.length] = '.';
+    for(int i = precision; i > 0; i--)
+    {
+      str_buf[jutil_time_cache.length + (size_t)i] = (char)('0' + fraction % 10);
+      fraction /= 10;
+    }
+  }
+
+  str_buf[length] = 0;
+  return length;
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_time_getCurrentTimeStringPrecise(char *str_buf, size_t str_size, int precision)
+{
+  if(str_buf == NULL)
+  {
+    return 0;
+  }
+
+  struct timespec now;
+  if(clock_gettime(CLOCK_REALTIME, &now) < 0)
+  {
+    ERROR("clock_gettime() failed [%d : %s].", errno, strerror(errno));
+    return 0;
+  }
+
+  return jutil_time_getTimeStringPrecise(str_buf, str_size, (long)now.tv_sec, now.tv_nsec, precision);
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_getCoarseMillis(void)
+{
+  struct timespec now;
+
+  if(clock_gettime(JUTIL_TIME_CLOCK_COARSE, &now) < 0)
+  {
+    ERROR("clock_gettime() failed [%d : %s].", errno, strerror(errno));
+    return 0;
+  }
+
+  return (unsigned long long)now.tv_sec * 1000ULL + (unsigned long long)now.tv_nsec / 1000000ULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_deadline_set(jutil_time_deadline_t *deadline, long timeout_ms)
+{
+  if(deadline == NULL)
+  {
+    return;
+  }
+
+  if(timeout_ms < 0)
+  {
+    deadline->expires = JUTIL_TIME_DEADLINE_NEVER;
+    return;
+  }
+
+  deadline->expires = jutil_time_getCoarseMillis() + (unsigned long long)timeout_ms;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_time_deadline_isExpired(const jutil_time_deadline_t *deadline)
+{
+  if(deadline == NULL || deadline->expires == JUTIL_TIME_DEADLINE_NEVER)
   {
     return false;
   }
 
-  return jutil_time_formatTime(str_buf, str_size, "%Y-%m-%d %H:%M:%S", timestamp);
+  return (jutil_time_getCoarseMillis() >= deadline->expires);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_time_deadline_getRemaining(const jutil_time_deadline_t *deadline)
+{
+  if(deadline == NULL || deadline->expires == JUTIL_TIME_DEADLINE_NEVER)
+  {
+    return -1;
+  }
+
+  unsigned long long now = jutil_time_getCoarseMillis();
+  if(now >= deadline->expires)
+  {
+    return 0;
+  }
+
+  unsigned long long remaining = deadline->expires - now;
+  return (remaining > INT_MAX ? INT_MAX : (int)remaining);
 }
 
 //------------------------------------------------------------------------------
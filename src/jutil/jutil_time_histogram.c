@@ -0,0 +1,523 @@
+/**
+ * @file jutil_time_histogram.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementations for jutil_time histogram.
+ * 
+ * Values below @c 2^BITS get one bucket each. Above that every
+ * power of two is split into @c 2^(BITS-1) buckets of equal width,
+ * so bucket index is computed from the highest set bit and the
+ * following bits of the value.
+ * 
+ * Buckets are only written by the recording thread, so they are
+ * incremented with relaxed load and store instead of atomic
+ * read-modify-write operations. Readers still see consistent
+ * values of every single bucket.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _POSIX_C_SOURCE 199309L /* needed for clock_gettime() */
+
+#include <jayc/jutil_time.h>
+#include <jayc/jlog.h>
+#include <jayc/jutil_alloc.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#if defined(JUTIL_TIME_TSC) && defined(__x86_64__)
+  #define JUTIL_TIME_HISTOGRAM_USE_TSC
+  #include <pthread.h>
+  #include <cpuid.h>
+  #include <x86intrin.h>
+#endif
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_time_histogram");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Number of exact buckets for small values.
+ */
+#define JUTIL_TIME_HISTOGRAM_SUB (1ULL << JUTIL_TIME_HISTOGRAM_BITS)
+
+/**
+ * @brief Number of buckets per power of two above exact buckets.
+ */
+#define JUTIL_TIME_HISTOGRAM_HALF (1ULL << (JUTIL_TIME_HISTOGRAM_BITS - 1))
+
+/**
+ * @brief Total number of buckets for 64 bit values.
+ */
+#define JUTIL_TIME_HISTOGRAM_BUCKETS (JUTIL_TIME_HISTOGRAM_SUB + (64 - JUTIL_TIME_HISTOGRAM_BITS) * JUTIL_TIME_HISTOGRAM_HALF)
+
+
+
+//==============================================================================
+// Define structure and log macros.
+//
+
+/**
+ * @brief Histogram session object.
+ */
+struct __jutil_time_histogram_session
+{
+  atomic_ullong count;                                  /**< Number of recorded values. */
+  atomic_ullong sum;                                    /**< Sum of recorded values. */
+  atomic_ullong min;                                    /**< Lowest recorded value. */
+  atomic_ullong max;                                    /**< Highest recorded value. */
+  atomic_ullong buckets[JUTIL_TIME_HISTOGRAM_BUCKETS];  /**< Number of values per bucket. */
+};
+
+#ifdef JUTIL_TIME_HISTOGRAM_USE_TSC
+static pthread_once_t jutil_time_histogram_tsc_once = PTHREAD_ONCE_INIT; /**< Calibrates TSC once. */
+static int jutil_time_histogram_tsc_usable = false;                      /**< @c true , if TSC is invariant and calibrated. */
+static unsigned long long jutil_time_histogram_tsc_base = 0;             /**< TSC at calibration. */
+static unsigned long long jutil_time_histogram_tsc_base_ns = 0;          /**< Nanoseconds at calibration. */
+static unsigned long long jutil_time_histogram_tsc_mult = 0;             /**< Nanoseconds per TSC tick as 32.32 fixed point. */
+#endif
+
+#ifdef JUTIL_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(fmt, ...)
+#else
+  #define DEBUG(fmt, ...) JLOG_DEBUG(fmt, ##__VA_ARGS__)
+#endif
+#define INFO(fmt, ...) JLOG_INFO(fmt, ##__VA_ARGS__)
+#define WARN(fmt, ...) JLOG_WARN(fmt, ##__VA_ARGS__)
+#define ERROR(fmt, ...) JLOG_ERROR(fmt, ##__VA_ARGS__)
+#define CRITICAL(fmt, ...)JLOG_CRITICAL(fmt, ##__VA_ARGS__)
+#define FATAL(fmt, ...) JLOG_FATAL(fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Returns bucket of value.
+ * 
+ * @param value Recorded value.
+ * 
+ * @return      Index of bucket.
+ */
+static size_t jutil_time_histogram_getIndex(unsigned long long value);
+
+/**
+ * @brief Returns highest value of bucket.
+ * 
+ * @param index Index of bucket.
+ * 
+ * @return      Upper bound of bucket.
+ */
+static unsigned long long jutil_time_histogram_getUpper(size_t index);
+
+/**
+ * @brief Adds to counter, that is only written by calling thread.
+ * 
+ * @param counter Counter to increase.
+ * @param value   Value to add.
+ */
+static void jutil_time_histogram_add(atomic_ullong *counter, unsigned long long value);
+
+/**
+ * @brief Reads @c CLOCK_MONOTONIC_RAW .
+ * 
+ * @return  Nanoseconds since unspecified point.
+ */
+static unsigned long long jutil_time_histogram_clockNanos(void);
+
+#ifdef JUTIL_TIME_HISTOGRAM_USE_TSC
+/**
+ * @brief Measures TSC frequency against @c CLOCK_MONOTONIC_RAW .
+ * 
+ * TSC is only used, if CPU reports an invariant TSC.
+ */
+static void jutil_time_histogram_calibrateTSC(void);
+#endif
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_getNanos(void)
+{
+#ifdef JUTIL_TIME_HISTOGRAM_USE_TSC
+  pthread_once(&jutil_time_histogram_tsc_once, &jutil_time_histogram_calibrateTSC);
+
+  if(jutil_time_histogram_tsc_usable)
+  {
+    unsigned long long tsc = __rdtsc();
+
+    if(tsc >= jutil_time_histogram_tsc_base)
+    {
+      return jutil_time_histogram_tsc_base_ns + (unsigned long long)(((unsigned __int128)(tsc - jutil_time_histogram_tsc_base) * jutil_time_histogram_tsc_mult) >> 32);
+    }
+
+    return jutil_time_histogram_tsc_base_ns - (unsigned long long)(((unsigned __int128)(jutil_time_histogram_tsc_base - tsc) * jutil_time_histogram_tsc_mult) >> 32);
+  }
+#endif
+
+  return jutil_time_histogram_clockNanos();
+}
+
+//------------------------------------------------------------------------------
+//
+jutil_time_histogram_t *jutil_time_histogram_init(void)
+{
+  jutil_time_histogram_t *session = (jutil_time_histogram_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_time_histogram_t));
+  if(session == NULL)
+  {
+    ERROR("malloc() failed.");
+    return NULL;
+  }
+
+  atomic_init(&session->count, 0);
+  atomic_init(&session->sum, 0);
+  atomic_init(&session->min, ULLONG_MAX);
+  atomic_init(&session->max, 0);
+
+  for(size_t i = 0; i < JUTIL_TIME_HISTOGRAM_BUCKETS; i++)
+  {
+    atomic_init(&session->buckets[i], 0);
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_free(jutil_time_histogram_t *session)
+{
+  if(session)
+  {
+    JUTIL_ALLOC_FREE(session);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_record(jutil_time_histogram_t *session, unsigned long long value)
+{
+  if(session == NULL)
+  {
+    return;
+  }
+
+  jutil_time_histogram_add(&session->buckets[jutil_time_histogram_getIndex(value)], 1);
+  jutil_time_histogram_add(&session->sum, value);
+
+  if(value < atomic_load_explicit(&session->min, memory_order_relaxed))
+  {
+    atomic_store_explicit(&session->min, value, memory_order_relaxed);
+  }
+  if(value > atomic_load_explicit(&session->max, memory_order_relaxed))
+  {
+    atomic_store_explicit(&session->max, value, memory_order_relaxed);
+  }
+
+  /* Count last, so readers rarely see more values than in buckets. */
+  jutil_time_histogram_add(&session->count, 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_recordSince(jutil_time_histogram_t *session, unsigned long long start)
+{
+  unsigned long long now = jutil_time_getNanos();
+
+  jutil_time_histogram_record(session, (now > start ? now - start : 0));
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_recordAtomic(jutil_time_histogram_t *session, unsigned long long value)
+{
+  if(session == NULL)
+  {
+    return;
+  }
+
+  atomic_fetch_add_explicit(&session->buckets[jutil_time_histogram_getIndex(value)], 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&session->sum, value, memory_order_relaxed);
+
+  unsigned long long current = atomic_load_explicit(&session->min, memory_order_relaxed);
+  while(value < current && !atomic_compare_exchange_weak_explicit(&session->min, &current, value, memory_order_relaxed, memory_order_relaxed));
+
+  current = atomic_load_explicit(&session->max, memory_order_relaxed);
+  while(value > current && !atomic_compare_exchange_weak_explicit(&session->max, &current, value, memory_order_relaxed, memory_order_relaxed));
+
+  atomic_fetch_add_explicit(&session->count, 1, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_time_histogram_merge(jutil_time_histogram_t *dest, const jutil_time_histogram_t *src)
+{
+  if(dest == NULL || src == NULL)
+  {
+    return false;
+  }
+
+  unsigned long long count = 0;
+  for(size_t i = 0; i < JUTIL_TIME_HISTOGRAM_BUCKETS; i++)
+  {
+    unsigned long long bucket = atomic_load_explicit(&src->buckets[i], memory_order_relaxed);
+    if(bucket)
+    {
+      jutil_time_histogram_add(&dest->buckets[i], bucket);
+      count += bucket;
+    }
+  }
+
+  /* Count from buckets, so it matches, even if src is recorded meanwhile. */
+  jutil_time_histogram_add(&dest->sum, atomic_load_explicit(&src->sum, memory_order_relaxed));
+  jutil_time_histogram_add(&dest->count, count);
+
+  unsigned long long min = atomic_load_explicit(&src->min, memory_order_relaxed);
+  unsigned long long max = atomic_load_explicit(&src->max, memory_order_relaxed);
+  if(min < atomic_load_explicit(&dest->min, memory_order_relaxed))
+  {
+    atomic_store_explicit(&dest->min, min, memory_order_relaxed);
+  }
+  if(max > atomic_load_explicit(&dest->max, memory_order_relaxed))
+  {
+    atomic_store_explicit(&dest->max, max, memory_order_relaxed);
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_reset(jutil_time_histogram_t *session)
+{
+  if(session == NULL)
+  {
+    return;
+  }
+
+  atomic_store_explicit(&session->count, 0, memory_order_relaxed);
+  atomic_store_explicit(&session->sum, 0, memory_order_relaxed);
+  atomic_store_explicit(&session->min, ULLONG_MAX, memory_order_relaxed);
+  atomic_store_explicit(&session->max, 0, memory_order_relaxed);
+
+  for(size_t i = 0; i < JUTIL_TIME_HISTOGRAM_BUCKETS; i++)
+  {
+    atomic_store_explicit(&session->buckets[i], 0, memory_order_relaxed);
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_histogram_getPercentile(const jutil_time_histogram_t *session, double percentile)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  unsigned long long count = atomic_load_explicit(&session->count, memory_order_relaxed);
+  if(count == 0)
+  {
+    return 0;
+  }
+
+  unsigned long long max = atomic_load_explicit(&session->max, memory_order_relaxed);
+
+  if(percentile <= 0.0)
+  {
+    return jutil_time_histogram_getMin(session);
+  }
+  if(percentile >= 100.0)
+  {
+    return max;
+  }
+
+  /* Rank of value, that is at least as high as percentile of values. */
+  unsigned long long rank = (unsigned long long)(percentile / 100.0 * (double)count);
+  if((double)rank < percentile / 100.0 * (double)count || rank == 0)
+  {
+    rank++;
+  }
+
+  unsigned long long seen = 0;
+  for(size_t i = 0; i < JUTIL_TIME_HISTOGRAM_BUCKETS; i++)
+  {
+    seen += atomic_load_explicit(&session->buckets[i], memory_order_relaxed);
+    if(seen >= rank)
+    {
+      unsigned long long upper = jutil_time_histogram_getUpper(i);
+      return (upper < max ? upper : max);
+    }
+  }
+
+  return max;
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_histogram_getCount(const jutil_time_histogram_t *session)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&session->count, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_histogram_getMin(const jutil_time_histogram_t *session)
+{
+  if(session == NULL || atomic_load_explicit(&session->count, memory_order_relaxed) == 0)
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&session->min, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_histogram_getMax(const jutil_time_histogram_t *session)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  return atomic_load_explicit(&session->max, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+double jutil_time_histogram_getMean(const jutil_time_histogram_t *session)
+{
+  if(session == NULL)
+  {
+    return 0;
+  }
+
+  unsigned long long count = atomic_load_explicit(&session->count, memory_order_relaxed);
+  if(count == 0)
+  {
+    return 0;
+  }
+
+  return (double)atomic_load_explicit(&session->sum, memory_order_relaxed) / (double)count;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_time_histogram_getIndex(unsigned long long value)
+{
+  if(value < JUTIL_TIME_HISTOGRAM_SUB)
+  {
+    return (size_t)value;
+  }
+
+  /* Value is in [2^(BITS+group-1), 2^(BITS+group)), shifted by group it is in [HALF, SUB). */
+  int group = (63 - __builtin_clzll(value)) - JUTIL_TIME_HISTOGRAM_BITS + 1;
+
+  return (size_t)(JUTIL_TIME_HISTOGRAM_SUB + (group - 1) * JUTIL_TIME_HISTOGRAM_HALF + ((value >> group) - JUTIL_TIME_HISTOGRAM_HALF));
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_histogram_getUpper(size_t index)
+{
+  if(index < JUTIL_TIME_HISTOGRAM_SUB)
+  {
+    return (unsigned long long)index;
+  }
+
+  int group = (int)((index - JUTIL_TIME_HISTOGRAM_SUB) / JUTIL_TIME_HISTOGRAM_HALF) + 1;
+  unsigned long long offset = (index - JUTIL_TIME_HISTOGRAM_SUB) % JUTIL_TIME_HISTOGRAM_HALF;
+
+  return ((JUTIL_TIME_HISTOGRAM_HALF + offset) << group) + ((1ULL << group) - 1);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_add(atomic_ullong *counter, unsigned long long value)
+{
+  atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_time_histogram_clockNanos(void)
+{
+  struct timespec now;
+
+  if(clock_gettime(CLOCK_MONOTONIC_RAW, &now) < 0)
+  {
+    ERROR("clock_gettime() failed [%d : %s].", errno, strerror(errno));
+    return 0;
+  }
+
+  return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+#ifdef JUTIL_TIME_HISTOGRAM_USE_TSC
+//------------------------------------------------------------------------------
+//
+void jutil_time_histogram_calibrateTSC(void)
+{
+  unsigned int eax, ebx, ecx, edx;
+
+  /* Invariant TSC runs at constant rate in all power states. */
+  if(__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0 || (edx & (1U << 8)) == 0)
+  {
+    DEBUG("No invariant TSC, using clock_gettime().");
+    return;
+  }
+
+  unsigned long long start_ns = jutil_time_histogram_clockNanos();
+  unsigned long long start_tsc = __rdtsc();
+
+  struct timespec wait = { 0, 10000000L };
+  nanosleep(&wait, NULL);
+
+  unsigned long long end_ns = jutil_time_histogram_clockNanos();
+  unsigned long long end_tsc = __rdtsc();
+
+  if(end_tsc <= start_tsc || end_ns <= start_ns)
+  {
+    WARN("TSC calibration failed, using clock_gettime().");
+    return;
+  }
+
+  jutil_time_histogram_tsc_mult = (unsigned long long)(((unsigned __int128)(end_ns - start_ns) << 32) / (end_tsc - start_tsc));
+  jutil_time_histogram_tsc_base = end_tsc;
+  jutil_time_histogram_tsc_base_ns = end_ns;
+  jutil_time_histogram_tsc_usable = true;
+}
+#endif
@@ -13,12 +13,21 @@
 
 #include <jayc/jutil_time.h>
 #include <jayc/jlog.h>
+#include <jayc/jutil_alloc.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <errno.h>
 #include <time.h>
 
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_time_stopWatch");
+
+
+
 //==============================================================================
 // Define structure and log macros.
 //
@@ -52,7 +61,7 @@ struct __jutil_time_stopWatch_session
 //
 jutil_time_stopWatch_t *jutil_time_stopWatch_init()
 {
-  jutil_time_stopWatch_t *session = (jutil_time_stopWatch_t *)malloc(sizeof(jutil_time_stopWatch_t));
+  jutil_time_stopWatch_t *session = (jutil_time_stopWatch_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_time_stopWatch_t));
   if(session == NULL)
   {
     return NULL;
@@ -61,7 +70,7 @@ jutil_time_stopWatch_t *jutil_time_stopWatch_init()
   if(clock_gettime(CLOCK_MONOTONIC, &session->time_buffer) < 0)
   {
     ERROR("clock_gettime() failed [%d : %s].", errno, strerror(errno));
-    free(session);
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
   
@@ -127,6 +136,6 @@ void jutil_time_stopWatch_free(jutil_time_stopWatch_t *session)
 {
   if(session)
   {
-    free(session);
+    JUTIL_ALLOC_FREE(session);
   }
 }
\ No newline at end of file
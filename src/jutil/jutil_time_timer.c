@@ -4,21 +4,37 @@
  * 
  * @brief Implementations for jutil_time timer.
  * 
+ * Timer is a timerfd, so expirations are handled by the thread,
+ * that waits for the descriptor, instead of a thread started
+ * for every expiry.
+ * 
  * @date 2020-10-06
  * @copyright Copyright (c) 2020 by Manuel Nadji
  * 
  */
 
-#define _POSIX_C_SOURCE 199309L /* needed for timer functions */
+#define _POSIX_C_SOURCE 199309L /* needed for clock constants */
 
 #include <jayc/jutil_time.h>
 #include <jayc/jlog.h>
+#include <jayc/jutil_alloc.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <errno.h>
+#include <stdint.h>
+#include <limits.h>
 #include <time.h>
-#include <signal.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_time_timer");
+
+
 
 //==============================================================================
 // Define structures and constants.
@@ -30,8 +46,7 @@
 struct __jutil_time_timer_session
 {
   struct timespec interval;           /**< Interval struct. */
-  struct sigevent timer_event;        /**< Timer event. */
-  timer_t timer_id;                   /**< Timer object reference. */
+  int timer_fd;                       /**< Descriptor of timerfd. */
 
   jutil_time_timer_handler_t handler; /**< Handler function to get executed. */
   void *session_ctx;                  /**< Session context pointer passed to handler. */
@@ -61,21 +76,6 @@ static const struct timespec JUTIL_TIME_TIMER_INT_EMPTY = { 0, 0 };
 
 
 
-//==============================================================================
-// Declare internal functions.
-//
-
-/**
- * @brief Internal handler for timer.
- * 
- * Handles user provided handler and passing data.
- * 
- * @param ctx Timer value union.
- */
-static void sigevent_function(union sigval ctx);
-
-
-
 //==============================================================================
 // Implement interface functions.
 //
@@ -94,7 +94,7 @@ jutil_time_timer_t *jutil_time_timer_init(void *ctx, jutil_time_timer_handler_t
     return NULL;
   }
 
-  jutil_time_timer_t *session = (jutil_time_timer_t *)malloc(sizeof(jutil_time_timer_t));
+  jutil_time_timer_t *session = (jutil_time_timer_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_time_timer_t));
   if(session == NULL)
   {
     return NULL;
@@ -106,17 +106,11 @@ jutil_time_timer_t *jutil_time_timer_init(void *ctx, jutil_time_timer_handler_t
   session->session_ctx = ctx;
   session->handler = handler;
 
-  session->timer_event.sigev_notify = SIGEV_THREAD;
-  session->timer_event.sigev_signo = 0;
-  session->timer_event.sigev_value.sival_int = 0;
-  session->timer_event.sigev_value.sival_ptr = (void *)session;
-  session->timer_event.sigev_notify_function = &sigevent_function;
-  session->timer_event.sigev_notify_attributes = NULL;
-
-  if(timer_create(CLOCK_REALTIME, &session->timer_event, &session->timer_id) < 0)
+  session->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if(session->timer_fd < 0)
   {
-    ERROR("timer_create() failed [%d : %s].", errno, strerror(errno));
-    free(session);
+    ERROR("timerfd_create() failed [%d : %s].", errno, strerror(errno));
+    JUTIL_ALLOC_FREE(session);
     return NULL;
   }
 
@@ -132,21 +126,19 @@ void jutil_time_timer_free(jutil_time_timer_t *session)
     return;
   }
 
-  jutil_time_timer_stop(session);
-
-  if(timer_delete(session->timer_id) < 0)
+  if(close(session->timer_fd) < 0)
   {
-    ERROR("timer_delete() failed [%d : %s].", errno, strerror(errno));
+    ERROR("close() failed [%d : %s].", errno, strerror(errno));
   }
 
-  free(session);
+  JUTIL_ALLOC_FREE(session);
 }
 
 //------------------------------------------------------------------------------
 //
 int jutil_time_timer_start(jutil_time_timer_t *session)
 {
-  // https://www.man7.org/linux/man-pages/man2/timer_settime.2.html
+  // https://www.man7.org/linux/man-pages/man2/timerfd_create.2.html
 
   if(session == NULL)
   {
@@ -157,9 +149,9 @@ int jutil_time_timer_start(jutil_time_timer_t *session)
   timer_interval.it_interval = session->interval;
   timer_interval.it_value = session->interval;
 
-  if(timer_settime(session->timer_id, 0, &timer_interval, NULL) < 0)
+  if(timerfd_settime(session->timer_fd, 0, &timer_interval, NULL) < 0)
   {
-    ERROR("timer_settime() failed [%d : %s].", errno, strerror(errno));
+    ERROR("timerfd_settime() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
@@ -170,7 +162,7 @@ int jutil_time_timer_start(jutil_time_timer_t *session)
 //
 int jutil_time_timer_stop(jutil_time_timer_t *session)
 {
-  // https://www.man7.org/linux/man-pages/man2/timer_settime.2.html
+  // https://www.man7.org/linux/man-pages/man2/timerfd_create.2.html
 
   if(session == NULL)
   {
@@ -181,34 +173,53 @@ int jutil_time_timer_stop(jutil_time_timer_t *session)
   timer_interval.it_interval = session->interval;
   timer_interval.it_value = JUTIL_TIME_TIMER_INT_EMPTY;
 
-  if(timer_settime(session->timer_id, 0, &timer_interval, NULL) < 0)
+  if(timerfd_settime(session->timer_fd, 0, &timer_interval, NULL) < 0)
   {
-    ERROR("timer_settime() failed [%d : %s].", errno, strerror(errno));
+    ERROR("timerfd_settime() failed [%d : %s].", errno, strerror(errno));
     return false;
   }
 
   return true;
 }
 
-
-
-//==============================================================================
-// Implement internal functions.
+//------------------------------------------------------------------------------
 //
+int jutil_time_timer_getFD(jutil_time_timer_t *session)
+{
+  if(session == NULL)
+  {
+    return -1;
+  }
+
+  return session->timer_fd;
+}
 
 //------------------------------------------------------------------------------
 //
-void sigevent_function(union sigval ctx)
+int jutil_time_timer_process(jutil_time_timer_t *session)
 {
-  if(ctx.sival_ptr == NULL)
+  if(session == NULL)
   {
-    return;
+    return -1;
   }
 
-  jutil_time_timer_t *session = (jutil_time_timer_t *)ctx.sival_ptr;
+  uint64_t expirations = 0;
+  if(read(session->timer_fd, &expirations, sizeof(expirations)) < 0)
+  {
+    if(errno == EAGAIN)
+    {
+      return 0;
+    }
+
+    ERROR("read() failed [%d : %s].", errno, strerror(errno));
+    return -1;
+  }
 
+  /* Expirations missed by a slow caller are handled by one call. */
   if(session->handler(session->session_ctx) == false)
   {
     jutil_time_timer_stop(session);
   }
+
+  return (expirations > INT_MAX ? INT_MAX : (int)expirations);
 }
\ No newline at end of file
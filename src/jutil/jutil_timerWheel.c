@@ -0,0 +1,667 @@
+/**
+ * @file jutil_timerWheel.c
+ * @author Manuel Nadji (https://github.com/gnarrf95)
+ * 
+ * @brief Implementation of jutil_timerWheel.
+ * 
+ * Timers expiring within the next 256 ticks are kept in the
+ * root wheel, one slot per tick. Later timers are kept in three
+ * levels of 64 slots, each slot covering a range of ticks.
+ * Whenever the root wheel wraps around, the next slot of the
+ * first level is moved down (cascaded), same for higher levels.
+ * 
+ * @date 2026-10-14
+ * @copyright Copyright (c) 2026 by Manuel Nadji
+ * 
+ */
+
+#define _POSIX_C_SOURCE 199309L /* needed for clock_gettime() */
+
+#include <jayc/jutil_timerWheel.h>
+#include <jayc/jutil_alloc.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+//==============================================================================
+// Define allocation statistics.
+//
+
+JUTIL_ALLOC_MODULE("jutil_timerWheel");
+
+
+
+//==============================================================================
+// Define constants.
+//
+
+/**
+ * @brief Bits of tick used as index of root wheel.
+ */
+#define JUTIL_TIMERWHEEL_ROOT_BITS 8
+
+/**
+ * @brief Bits of tick used as index of each higher level.
+ */
+#define JUTIL_TIMERWHEEL_LEVEL_BITS 6
+
+/**
+ * @brief Number of levels above root wheel.
+ */
+#define JUTIL_TIMERWHEEL_LEVELS 3
+
+/**
+ * @brief Number of slots in root wheel.
+ */
+#define JUTIL_TIMERWHEEL_ROOT_SIZE (1 << JUTIL_TIMERWHEEL_ROOT_BITS)
+
+/**
+ * @brief Number of slots in each higher level.
+ */
+#define JUTIL_TIMERWHEEL_LEVEL_SIZE (1 << JUTIL_TIMERWHEEL_LEVEL_BITS)
+
+/**
+ * @brief Maximum number of ticks, the wheel covers.
+ */
+#define JUTIL_TIMERWHEEL_MAX_TICKS ((1ULL << (JUTIL_TIMERWHEEL_ROOT_BITS + JUTIL_TIMERWHEEL_LEVELS * JUTIL_TIMERWHEEL_LEVEL_BITS)) - 1)
+
+/**
+ * @brief Nanoseconds per millisecond.
+ */
+#define JUTIL_TIMERWHEEL_NS_PER_MS 1000000ULL
+
+/**
+ * @brief Nanoseconds per second.
+ */
+#define JUTIL_TIMERWHEEL_NS_PER_S 1000000000ULL
+
+
+
+//==============================================================================
+// Define structures.
+//
+
+/**
+ * @brief Session object. Holds data for operation.
+ */
+struct __jutil_timerWheel_session
+{
+  int timer_fd;                                                                         /**< Descriptor of timerfd, that ticks while timers are armed. */
+  int fd_armed;                                                                         /**< @c true , if timerfd is ticking. */
+
+  unsigned long long tick_ns;                                                           /**< Resolution in nanoseconds. */
+  unsigned long long start_ns;                                                          /**< Monotonic time of tick 0. */
+  unsigned long long current;                                                           /**< Next tick to be processed. */
+  size_t count;                                                                         /**< Number of armed timers. */
+
+  jutil_timerWheel_timer_t *root[JUTIL_TIMERWHEEL_ROOT_SIZE];                           /**< Slots for the next ticks. */
+  jutil_timerWheel_timer_t *levels[JUTIL_TIMERWHEEL_LEVELS][JUTIL_TIMERWHEEL_LEVEL_SIZE]; /**< Slots for later ticks. */
+
+  jutil_timerWheel_timer_t *expired;                                                    /**< Expired timers, whose handlers are not called yet. */
+  jutil_timerWheel_timer_t **expired_tail;                                              /**< Link at end of expired timers. */
+
+  jlog_t *logger;                                                                       /**< Logger for debug and error messages. */
+};
+
+
+
+//==============================================================================
+// Declare internal functions.
+//
+
+/**
+ * @brief Returns current monotonic time in nanoseconds.
+ * 
+ * @return  Monotonic time.
+ */
+static unsigned long long jutil_timerWheel_now(void);
+
+/**
+ * @brief Puts timer in slot matching its expiry tick.
+ * 
+ * @param session Timer wheel.
+ * @param timer   Disarmed timer with set expiry tick.
+ */
+static void jutil_timerWheel_insert(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer);
+
+/**
+ * @brief Adds timer to front of slot list.
+ * 
+ * @param slot  Head of slot list.
+ * @param timer Disarmed timer.
+ */
+static void jutil_timerWheel_link(jutil_timerWheel_timer_t **slot, jutil_timerWheel_timer_t *timer);
+
+/**
+ * @brief Removes timer from its list.
+ * 
+ * @param session Timer wheel.
+ * @param timer   Armed timer.
+ */
+static void jutil_timerWheel_unlink(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer);
+
+/**
+ * @brief Moves timers of higher level slot to lower levels.
+ * 
+ * @param session Timer wheel.
+ * @param level   Level of slot.
+ * @param index   Index of slot.
+ */
+static void jutil_timerWheel_cascade(jutil_timerWheel_t *session, int level, size_t index);
+
+/**
+ * @brief Moves timers of current tick to expired timers and
+ *        advances wheel by one tick.
+ * 
+ * @param session Timer wheel.
+ */
+static void jutil_timerWheel_tick(jutil_timerWheel_t *session);
+
+/**
+ * @brief Starts or stops ticking of timerfd.
+ * 
+ * @param session Timer wheel.
+ * @param enable  @c true to start, @c false to stop.
+ * 
+ * @return        @c true , if successful.
+ * @return        @c false , if error occured.
+ */
+static int jutil_timerWheel_setFD(jutil_timerWheel_t *session, int enable);
+
+/**
+ * @brief Logs debug and error messages.
+ * 
+ * Uses logger from @c session , or if logger is @c NULL , uses global logger.
+ * 
+ * @param session   Timer wheel session.
+ * @param log_type  Type of log message.
+ * @param file      Source code file, where message was logged.
+ * @param function  Function in which message was logged.
+ * @param line      Line, where message was logged.
+ * @param fmt       Format string for stdarg.h .
+ */
+static void jutil_timerWheel_log(jutil_timerWheel_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...);
+
+
+
+//==============================================================================
+// Define log macros.
+//
+
+/**
+ * @brief Checks log level, before message is formatted.
+ */
+#define LOG_ENABLED(session, log_type) (JLOG_COMPILE_ENABLED(log_type) && jlog_isEnabled((session ? session->logger : NULL), log_type))
+
+#ifdef JUTIL_NO_DEBUG /* Allow to disable debug messages at compile time. */
+  #define DEBUG(session, fmt, ...)
+#else
+  #define DEBUG(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_DEBUG) ? jutil_timerWheel_log(session, JLOG_LOGTYPE_DEBUG, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#endif
+#define INFO(session, fmt, ...) (LOG_ENABLED(session, JLOG_LOGTYPE_INFO) ? jutil_timerWheel_log(session, JLOG_LOGTYPE_INFO, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define WARN(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_WARN) ? jutil_timerWheel_log(session, JLOG_LOGTYPE_WARN, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define ERROR(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_ERROR) ? jutil_timerWheel_log(session, JLOG_LOGTYPE_ERROR, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define CRITICAL(session, fmt, ...) (JLOG_COMPILE_ENABLED(JLOG_LOGTYPE_CRITICAL) ? jutil_timerWheel_log(session, JLOG_LOGTYPE_CRITICAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__) : (void)0)
+#define FATAL(session, fmt, ...) jutil_timerWheel_log(session, JLOG_LOGTYPE_FATAL, __FILE__, __func__, __LINE__, fmt, ##__VA_ARGS__)
+
+
+
+//==============================================================================
+// Implement interface functions.
+//
+
+//------------------------------------------------------------------------------
+//
+jutil_timerWheel_t *jutil_timerWheel_init(long tick_ms, jlog_t *logger)
+{
+  if(tick_ms < 0)
+  {
+    ERROR(NULL, "Invalid tick [%ld].", tick_ms);
+    return NULL;
+  }
+
+  jutil_timerWheel_t *session = (jutil_timerWheel_t *)JUTIL_ALLOC_MALLOC(sizeof(jutil_timerWheel_t));
+  if(session == NULL)
+  {
+    ERROR(NULL, "malloc() failed.");
+    return NULL;
+  }
+
+  memset(session, 0, sizeof(jutil_timerWheel_t));
+  session->logger = logger;
+  session->tick_ns = (unsigned long long)(tick_ms > 0 ? tick_ms : JUTIL_TIMERWHEEL_TICK_DEFAULT) * JUTIL_TIMERWHEEL_NS_PER_MS;
+  session->start_ns = jutil_timerWheel_now();
+  session->current = 0;
+  session->count = 0;
+  session->fd_armed = false;
+  session->expired = NULL;
+  session->expired_tail = &session->expired;
+
+  session->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if(session->timer_fd < 0)
+  {
+    ERROR(NULL, "timerfd_create() failed [%d : %s]. Destroying session.", errno, strerror(errno));
+    JUTIL_ALLOC_FREE(session);
+    return NULL;
+  }
+
+  return session;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_free(jutil_timerWheel_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(session->count > 0)
+  {
+    DEBUG(session, "Freeing wheel with [%zu] armed timers.", session->count);
+  }
+
+  if(close(session->timer_fd) < 0)
+  {
+    ERROR(NULL, "close() failed [%d : %s].", errno, strerror(errno));
+  }
+
+  JUTIL_ALLOC_FREE(session);
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_timer_init(jutil_timerWheel_timer_t *timer, jutil_timerWheel_handler_t handler, void *ctx)
+{
+  if(timer == NULL)
+  {
+    ERROR(NULL, "Timer is NULL.");
+    return;
+  }
+
+  timer->handler = handler;
+  timer->ctx = ctx;
+  timer->next = NULL;
+  timer->pprev = NULL;
+  timer->expires = 0;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_timerWheel_arm(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer, long timeout_ms)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return false;
+  }
+
+  if(timer == NULL || timer->handler == NULL)
+  {
+    ERROR(session, "Timer is not initialized.");
+    return false;
+  }
+
+  if(timeout_ms < 0)
+  {
+    ERROR(session, "Invalid timeout [%ld].", timeout_ms);
+    return false;
+  }
+
+  if(timer->pprev)
+  {
+    jutil_timerWheel_unlink(session, timer);
+  }
+  else
+  {
+    session->count++;
+  }
+
+  unsigned long long elapsed = jutil_timerWheel_now() - session->start_ns;
+  unsigned long long now_tick = elapsed / session->tick_ns;
+
+  /* Nothing else armed, so ticks since last processing can be skipped. */
+  if(session->count == 1 && now_tick > session->current)
+  {
+    session->current = now_tick;
+  }
+
+  timer->expires = (elapsed + (unsigned long long)timeout_ms * JUTIL_TIMERWHEEL_NS_PER_MS + session->tick_ns - 1) / session->tick_ns;
+  jutil_timerWheel_insert(session, timer);
+
+  if(session->fd_armed == false && jutil_timerWheel_setFD(session, true) == false)
+  {
+    jutil_timerWheel_unlink(session, timer);
+    session->count--;
+    return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_cancel(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return;
+  }
+
+  if(timer == NULL || timer->pprev == NULL)
+  {
+    return;
+  }
+
+  /* timerfd is stopped on next processing, saves a system call per cancel. */
+  jutil_timerWheel_unlink(session, timer);
+  session->count--;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_timerWheel_isArmed(const jutil_timerWheel_timer_t *timer)
+{
+  if(timer == NULL)
+  {
+    return false;
+  }
+
+  return (timer->pprev != NULL);
+}
+
+//------------------------------------------------------------------------------
+//
+size_t jutil_timerWheel_getCount(jutil_timerWheel_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return 0;
+  }
+
+  return session->count;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_timerWheel_getFD(jutil_timerWheel_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  return session->timer_fd;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_timerWheel_process(jutil_timerWheel_t *session)
+{
+  if(session == NULL)
+  {
+    ERROR(NULL, "Session is NULL.");
+    return -1;
+  }
+
+  uint64_t expirations;
+  if(read(session->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN)
+  {
+    ERROR(session, "read() failed [%d : %s].", errno, strerror(errno));
+    return -1;
+  }
+
+  unsigned long long now_tick = (jutil_timerWheel_now() - session->start_ns) / session->tick_ns;
+
+  if(session->count == 0)
+  {
+    if(now_tick >= session->current)
+    {
+      session->current = now_tick + 1;
+    }
+  }
+  else
+  {
+    while(session->current <= now_tick)
+    {
+      jutil_timerWheel_tick(session);
+    }
+  }
+
+  /* Handlers run after wheel is advanced, so timers they arm land in later ticks. */
+  int handled = 0;
+  while(session->expired)
+  {
+    jutil_timerWheel_timer_t *timer = session->expired;
+    jutil_timerWheel_unlink(session, timer);
+    session->count--;
+
+    timer->handler(session, timer);
+    handled++;
+  }
+
+  if(session->count == 0 && session->fd_armed)
+  {
+    jutil_timerWheel_setFD(session, false);
+  }
+
+  return handled;
+}
+
+
+
+//==============================================================================
+// Implement internal functions.
+//
+
+//------------------------------------------------------------------------------
+//
+unsigned long long jutil_timerWheel_now(void)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (unsigned long long)now.tv_sec * JUTIL_TIMERWHEEL_NS_PER_S + (unsigned long long)now.tv_nsec;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_insert(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer)
+{
+  unsigned long long expires = timer->expires;
+
+  /* Already expired, runs on next tick. */
+  if(expires < session->current)
+  {
+    expires = session->current;
+  }
+
+  unsigned long long delta = expires - session->current;
+
+  if(delta < JUTIL_TIMERWHEEL_ROOT_SIZE)
+  {
+    jutil_timerWheel_link(&session->root[expires & (JUTIL_TIMERWHEEL_ROOT_SIZE - 1)], timer);
+    return;
+  }
+
+  /* Timers beyond wheel wait in last level and are placed again on cascade. */
+  if(delta > JUTIL_TIMERWHEEL_MAX_TICKS)
+  {
+    expires = session->current + JUTIL_TIMERWHEEL_MAX_TICKS;
+    delta = JUTIL_TIMERWHEEL_MAX_TICKS;
+  }
+
+  for(int level = 0; level < JUTIL_TIMERWHEEL_LEVELS; level++)
+  {
+    int shift = JUTIL_TIMERWHEEL_ROOT_BITS + level * JUTIL_TIMERWHEEL_LEVEL_BITS;
+    if(level == JUTIL_TIMERWHEEL_LEVELS - 1 || delta < (1ULL << (shift + JUTIL_TIMERWHEEL_LEVEL_BITS)))
+    {
+      jutil_timerWheel_link(&session->levels[level][(expires >> shift) & (JUTIL_TIMERWHEEL_LEVEL_SIZE - 1)], timer);
+      return;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_link(jutil_timerWheel_timer_t **slot, jutil_timerWheel_timer_t *timer)
+{
+  timer->next = *slot;
+  if(*slot)
+  {
+    (*slot)->pprev = &timer->next;
+  }
+
+  *slot = timer;
+  timer->pprev = slot;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_unlink(jutil_timerWheel_t *session, jutil_timerWheel_timer_t *timer)
+{
+  if(session->expired_tail == &timer->next)
+  {
+    session->expired_tail = timer->pprev;
+  }
+
+  *timer->pprev = timer->next;
+  if(timer->next)
+  {
+    timer->next->pprev = timer->pprev;
+  }
+
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_cascade(jutil_timerWheel_t *session, int level, size_t index)
+{
+  jutil_timerWheel_timer_t *timer = session->levels[level][index];
+  session->levels[level][index] = NULL;
+
+  while(timer)
+  {
+    jutil_timerWheel_timer_t *next = timer->next;
+    timer->next = NULL;
+    timer->pprev = NULL;
+
+    jutil_timerWheel_insert(session, timer);
+    timer = next;
+  }
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_tick(jutil_timerWheel_t *session)
+{
+  size_t index = session->current & (JUTIL_TIMERWHEEL_ROOT_SIZE - 1);
+
+  if(index == 0)
+  {
+    for(int level = 0; level < JUTIL_TIMERWHEEL_LEVELS; level++)
+    {
+      int shift = JUTIL_TIMERWHEEL_ROOT_BITS + level * JUTIL_TIMERWHEEL_LEVEL_BITS;
+      size_t level_index = (session->current >> shift) & (JUTIL_TIMERWHEEL_LEVEL_SIZE - 1);
+
+      jutil_timerWheel_cascade(session, level, level_index);
+
+      /* Higher level only cascades, if this level wrapped around. */
+      if(level_index != 0)
+      {
+        break;
+      }
+    }
+  }
+
+  jutil_timerWheel_timer_t *timer = session->root[index];
+  session->root[index] = NULL;
+
+  while(timer)
+  {
+    jutil_timerWheel_timer_t *next = timer->next;
+
+    timer->next = NULL;
+    timer->pprev = session->expired_tail;
+    *session->expired_tail = timer;
+    session->expired_tail = &timer->next;
+
+    timer = next;
+  }
+
+  session->current++;
+}
+
+//------------------------------------------------------------------------------
+//
+int jutil_timerWheel_setFD(jutil_timerWheel_t *session, int enable)
+{
+  struct itimerspec spec;
+  memset(&spec, 0, sizeof(spec));
+
+  if(enable)
+  {
+    /* First expiry at next tick boundary, so ticks of wheel and timerfd line up. */
+    unsigned long long next = session->start_ns + (session->current + 1) * session->tick_ns;
+    spec.it_value.tv_sec = (time_t)(next / JUTIL_TIMERWHEEL_NS_PER_S);
+    spec.it_value.tv_nsec = (long)(next % JUTIL_TIMERWHEEL_NS_PER_S);
+    spec.it_interval.tv_sec = (time_t)(session->tick_ns / JUTIL_TIMERWHEEL_NS_PER_S);
+    spec.it_interval.tv_nsec = (long)(session->tick_ns % JUTIL_TIMERWHEEL_NS_PER_S);
+  }
+
+  if(timerfd_settime(session->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) < 0)
+  {
+    ERROR(session, "timerfd_settime() failed [%d : %s].", errno, strerror(errno));
+    return false;
+  }
+
+  session->fd_armed = enable;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+//
+void jutil_timerWheel_log(jutil_timerWheel_t *session, int log_type, const char *file, const char *function, int line, const char *fmt, ...)
+{
+  if(LOG_ENABLED(session, log_type) == false)
+  {
+    return;
+  }
+
+  va_list args;
+  char buf[2048];
+
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+
+  if(session)
+  {
+    if(session->logger)
+    {
+      jlog_log_message_m(session->logger, log_type, file, function, line, "<timerfd:%d> %s", session->timer_fd, buf);
+    }
+    else
+    {
+      jlog_global_log_message_m(log_type, file, function, line, "<timerfd:%d> %s", session->timer_fd, buf);
+    }
+  }
+  else
+  {
+    jlog_global_log_message_m(log_type, file, function, line, buf);
+  }
+}